@@ -34,14 +34,15 @@
 #include "ccontrol/msgCode.h"
 #include "global/debugUtil.h"
 #include "global/MsgReceiver.h"
+#include "proto/ColumnarResult.h"
 #include "proto/ProtoHeaderWrap.h"
 #include "proto/ProtoImporter.h"
 #include "proto/WorkerResponse.h"
+#include "qdisp/CzarStats.h"
 #include "qdisp/JobQuery.h"
 #include "rproc/InfileMerger.h"
 #include "util/Bug.h"
 #include "util/common.h"
-#include "util/StringHash.h"
 
 using lsst::qserv::proto::ProtoHeader;
 using lsst::qserv::proto::ProtoImporter;
@@ -109,6 +110,10 @@ bool MergingHandler::flush(int bLen, BufPtr const& bufPtr, bool& last, bool& lar
             if (_wName == "~") {
                 _wName = _response->protoHeader.wname();
             }
+            if (_response->protoHeader.has_wid()) {
+                std::lock_guard<std::mutex> lock(_wIdMtx);
+                _wId = _response->protoHeader.wid();
+            }
 
             {
                 nextBufSize = _response->protoHeader.size();
@@ -147,11 +152,22 @@ bool MergingHandler::flush(int bLen, BufPtr const& bufPtr, bool& last, bool& lar
             if (!_verifyResult(bufPtr, bLen)) {
                 return false;
             }
-            if (!_setResult(bufPtr, bLen)) {  // This sets _response->result
+            // The checksum covers the bytes as sent, compressed or not.
+            char const* resultBuf = &((*bufPtr)[0]);
+            int resultLen = bLen;
+            std::string rawResult;
+            if (_response->protoHeader.codec() != proto::ProtoHeader::NONE) {
+                if (!_decompressResult(bufPtr, bLen, rawResult)) {
+                    return false;
+                }
+                resultBuf = rawResult.data();
+                resultLen = rawResult.size();
+            }
+            if (!_setResult(resultBuf, resultLen)) {  // This sets _response->result
                 LOGS(_log, LOG_LVL_WARN, "setResult failure " << _wName);
                 return false;
             }
-            resultRows = _response->result.row_size();
+            resultRows = proto::getResultRowCount(_response->result);
             LOGS(_log, LOG_LVL_DEBUG, "From:" << _wName << " _mBuf " << util::prettyCharList(*bufPtr, 5));
             _state = MsgState::HEADER_WAIT;
 
@@ -249,11 +265,10 @@ void MergingHandler::_setError(int code, std::string const& msg) {
     _error = Error(code, msg);
 }
 
-bool MergingHandler::_setResult(BufPtr const& bufPtr, int blen) {
+bool MergingHandler::_setResult(char const* buf, int blen) {
     auto start = std::chrono::system_clock::now();
     std::lock_guard<std::mutex> lg(_setResultMtx);
-    auto& buf = *bufPtr;
-    if (!ProtoImporter<proto::Result>::setMsgFrom(_response->result, &(buf[0]), blen)) {
+    if (!ProtoImporter<proto::Result>::setMsgFrom(_response->result, buf, blen)) {
         LOGS(_log, LOG_LVL_ERROR, "_setResult decoding error");
         _setError(ccontrol::MSG_RESULT_DECODE, "Error decoding result msg");
         _state = MsgState::RESULT_ERR;
@@ -265,11 +280,35 @@ bool MergingHandler::_setResult(BufPtr const& bufPtr, int blen) {
     return true;
 }
 
+bool MergingHandler::_decompressResult(BufPtr const& bufPtr, int blen, std::string& rawResult) {
+    auto const codec = _response->protoHeader.codec();
+    size_t const rawSize = _response->protoHeader.rawsize();
+    std::string const codecName = proto::ProtoHeader::Codec_Name(codec);
+    // A damaged header shouldn't make the czar allocate more than any result can hold.
+    bool ok = rawSize <= proto::ProtoHeaderWrap::PROTOBUFFER_HARD_LIMIT;
+    auto start = CLOCK::now();
+    if (ok) {
+        ok = proto::ProtoHeaderWrap::decompress(codec, &((*bufPtr)[0]), blen, rawSize, rawResult);
+    }
+    if (!ok) {
+        LOGS(_log, LOG_LVL_ERROR,
+             "_decompressResult From:" << _wName << " " << codecName << " failed rawSize=" << rawSize);
+        _setError(ccontrol::MSG_RESULT_DECODE, "Error decompressing " + codecName + " result msg");
+        _state = MsgState::RESULT_ERR;
+        return false;
+    }
+    qdisp::CzarStats::get()->addResultDecompress(blen, rawSize, start, CLOCK::now());
+    LOGS(_log, LOG_LVL_DEBUG, "From:" << _wName << " " << codecName << " " << blen << " -> " << rawSize);
+    return true;
+}
+
 bool MergingHandler::_verifyResult(BufPtr const& bufPtr, int blen) {
     auto& buf = *bufPtr;
-    if (_response->protoHeader.md5() != util::StringHash::getMd5(&(buf[0]), blen)) {
-        LOGS(_log, LOG_LVL_ERROR, "_verifyResult MD5 mismatch");
-        _setError(ccontrol::MSG_RESULT_MD5, "Result message MD5 mismatch");
+    auto const checksumType = _response->protoHeader.checksumtype();
+    if (_response->protoHeader.md5() != proto::ProtoHeaderWrap::getChecksum(checksumType, &(buf[0]), blen)) {
+        std::string const typeName = proto::ProtoHeader::ChecksumType_Name(checksumType);
+        LOGS(_log, LOG_LVL_ERROR, "_verifyResult " << typeName << " mismatch");
+        _setError(ccontrol::MSG_RESULT_MD5, "Result message " + typeName + " mismatch");
         _state = MsgState::RESULT_ERR;
         return false;
     }
@@ -95,12 +95,20 @@ public:
     /// Prepare to scrub the results from jobId-attempt from the result table.
     void prepScrubResults(int jobId, int attempt) override;
 
+    /// @return the id of the worker that sent the last header, if it told.
+    std::string getWorkerId() const override {
+        std::lock_guard<std::mutex> lock(_wIdMtx);
+        return _wId;
+    }
+
 private:
     void _initState();  ///< Prepare for first call to flush()
     bool _merge();      ///< Call Infile::merge to add the results to the result table.
     void _setError(int code, std::string const& msg);    ///< Set error code and string
-    bool _setResult(BufPtr const& bufPtr, int blen);     ///< Extract the result from the protobuffer.
+    bool _setResult(char const* buf, int blen);          ///< Extract the result from the protobuffer.
     bool _verifyResult(BufPtr const& bufPtr, int blen);  ///< Check the result against hash in the header.
+    /// Decompress the result with the codec in the header into 'rawResult'.
+    bool _decompressResult(BufPtr const& bufPtr, int blen, std::string& rawResult);
 
     std::shared_ptr<MsgReceiver> _msgReceiver;           ///< Message code receiver
     std::shared_ptr<rproc::InfileMerger> _infileMerger;  ///< Merging delegate
@@ -111,6 +119,8 @@ private:
     std::shared_ptr<proto::WorkerResponse> _response;    ///< protobufs msg buf
     bool _flushed{false};                                ///< flushed to InfileMerger?
     std::string _wName{"~"};                             ///< worker name
+    std::string _wId;                                    ///< worker id, @see getWorkerId()
+    mutable std::mutex _wIdMtx;                          ///< protects _wId
     std::mutex _setResultMtx;  //< Allow only one call to ParseFromArray at a time from _seResult.
     /// Set of jobIds added in this request. Using std::set to prevent duplicates when the same
     /// jobId has multiple merge calls.
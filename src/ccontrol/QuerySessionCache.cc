@@ -0,0 +1,148 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "ccontrol/QuerySessionCache.h"
+
+// System headers
+#include <cctype>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "qdisp/CzarStats.h"
+#include "query/SelectStmt.h"
+
+using namespace std;
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.ccontrol.QuerySessionCache");
+
+}  // namespace
+
+namespace lsst::qserv::ccontrol {
+
+QuerySessionCache::QuerySessionCache(size_t maxEntries, chrono::seconds maxAge)
+        : _maxEntries(maxEntries), _maxAge(maxAge) {}
+
+string QuerySessionCache::normalize(string const& sql) {
+    string normalized;
+    normalized.reserve(sql.size());
+    char quote = 0;
+    bool space = false;
+    for (size_t i = 0; i < sql.size(); ++i) {
+        char const c = sql[i];
+        if (quote != 0) {
+            normalized += c;
+            if (c == '\\' && i + 1 < sql.size()) {
+                normalized += sql[++i];
+            } else if (c == quote) {
+                quote = 0;
+            }
+            continue;
+        }
+        if (isspace(static_cast<unsigned char>(c))) {
+            space = true;
+            continue;
+        }
+        // The newline that ends a comment can't be folded.
+        if (c == '#' || sql.compare(i, 2, "--") == 0 || sql.compare(i, 2, "/*") == 0) return string();
+        if (space && !normalized.empty()) normalized += ' ';
+        space = false;
+        if (c == '\'' || c == '"' || c == '`') quote = c;
+        normalized += c;
+    }
+    return normalized;
+}
+
+shared_ptr<query::SelectStmt> QuerySessionCache::get(string const& sql, string const& defaultDb) {
+    if (_maxEntries == 0) return nullptr;
+    Key const key(normalize(sql), defaultDb);
+    if (key.first.empty()) return nullptr;
+    shared_ptr<query::SelectStmt const> stmt;
+    double parseSecs = 0.0;
+    bool expired = false;
+    {
+        lock_guard<mutex> lock(_mtx);
+        auto iter = _entries.find(key);
+        if (iter != _entries.end() && chrono::steady_clock::now() - iter->second.parsed >= _maxAge) {
+            _lru.erase(iter->second.lruIter);
+            _entries.erase(iter);
+            iter = _entries.end();
+            expired = true;
+        }
+        if (iter != _entries.end()) {
+            _lru.splice(_lru.begin(), _lru, iter->second.lruIter);
+            stmt = iter->second.stmt;
+            parseSecs = iter->second.parseSecs;
+        }
+    }
+    auto const czarStats = qdisp::CzarStats::get();
+    if (expired) czarStats->addQuerySessionCacheExpiration();
+    if (stmt == nullptr) {
+        czarStats->addQuerySessionCacheMiss();
+        return nullptr;
+    }
+    czarStats->addQuerySessionCacheHit(parseSecs);
+    LOGS(_log, LOG_LVL_DEBUG, "QuerySessionCache hit for " << key.first);
+    // The kept statement is never changed, copies are made outside of the lock.
+    return stmt->clone();
+}
+
+void QuerySessionCache::put(string const& sql, string const& defaultDb,
+                            shared_ptr<query::SelectStmt const> const& stmt,
+                            chrono::duration<double> parseTime) {
+    if (_maxEntries == 0) return;
+    Key key(normalize(sql), defaultDb);
+    if (key.first.empty()) return;
+    uint64_t evictions = 0;
+    {
+        lock_guard<mutex> lock(_mtx);
+        auto iter = _entries.find(key);
+        if (iter != _entries.end()) {
+            _lru.erase(iter->second.lruIter);
+            _entries.erase(iter);
+        }
+        _lru.push_front(key);
+        _entries[key] = Entry{stmt, chrono::steady_clock::now(), parseTime.count(), _lru.begin()};
+        while (_entries.size() > _maxEntries) {
+            _entries.erase(_lru.back());
+            _lru.pop_back();
+            ++evictions;
+        }
+    }
+    if (evictions != 0) qdisp::CzarStats::get()->addQuerySessionCacheEvictions(evictions);
+}
+
+void QuerySessionCache::clear() {
+    lock_guard<mutex> lock(_mtx);
+    _entries.clear();
+    _lru.clear();
+}
+
+size_t QuerySessionCache::size() const {
+    lock_guard<mutex> lock(_mtx);
+    return _entries.size();
+}
+
+}  // namespace lsst::qserv::ccontrol
@@ -0,0 +1,108 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_CCONTROL_QUERYSESSIONCACHE_H
+#define LSST_QSERV_CCONTROL_QUERYSESSIONCACHE_H
+
+// System headers
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace lsst::qserv::query {
+class SelectStmt;
+}  // namespace lsst::qserv::query
+
+namespace lsst::qserv::ccontrol {
+
+/// QuerySessionCache keeps the parsed statements of the last SELECT queries
+/// whose analysis succeeded, so that a query that is submitted again, as
+/// dashboards do every few seconds, skips the parser. Each run analyzes its
+/// own copy of the statement in a new QuerySession, as the analysis plugins
+/// change the statement and the QueryContext refers to its nodes. Queries
+/// without comments are the same when their text only differs by whitespace
+/// outside of quoted strings and they have the same default database. The
+/// least recently used statements are dropped first, and statements older
+/// than 'maxAge' are never used, as the catalogs they were parsed against may
+/// have changed since. The hits, the misses and the parsing time saved are
+/// counted in qdisp::CzarStats.
+class QuerySessionCache {
+public:
+    using Ptr = std::shared_ptr<QuerySessionCache>;
+
+    /// @param maxEntries - the most statements kept, 0 to keep none.
+    /// @param maxAge - how long a statement may be used after it was parsed.
+    QuerySessionCache(size_t maxEntries, std::chrono::seconds maxAge);
+
+    QuerySessionCache() = delete;
+    QuerySessionCache(QuerySessionCache const&) = delete;
+    QuerySessionCache& operator=(QuerySessionCache const&) = delete;
+
+    /// @return 'sql' with the whitespace outside of quotes collapsed to single
+    ///         spaces and removed from both ends, or an empty string if 'sql'
+    ///         has comments, as folding the newline that ends a '--' or '#'
+    ///         comment would change the query. Such queries aren't kept.
+    static std::string normalize(std::string const& sql);
+
+    /// @return true if statements are kept.
+    bool isEnabled() const { return _maxEntries > 0; }
+
+    /// @return a copy of the statement parsed from 'sql', or nullptr if there isn't any.
+    std::shared_ptr<query::SelectStmt> get(std::string const& sql, std::string const& defaultDb);
+
+    /// Keep 'stmt', parsed from 'sql' and not changed by any analysis since.
+    /// @param parseTime - how long parsing the query took.
+    void put(std::string const& sql, std::string const& defaultDb,
+             std::shared_ptr<query::SelectStmt const> const& stmt, std::chrono::duration<double> parseTime);
+
+    /// Drop all statements, when catalogs are changed.
+    void clear();
+
+    /// @return the number of statements kept.
+    size_t size() const;
+
+private:
+    /// Normalized query text and default database.
+    using Key = std::pair<std::string, std::string>;
+    using Lru = std::list<Key>;
+
+    struct Entry {
+        std::shared_ptr<query::SelectStmt const> stmt;
+        std::chrono::steady_clock::time_point parsed;
+        double parseSecs;
+        Lru::iterator lruIter;
+    };
+
+    size_t const _maxEntries;
+    std::chrono::seconds const _maxAge;
+
+    mutable std::mutex _mtx;        ///< Protects all members below.
+    std::map<Key, Entry> _entries;  ///< Statements by key.
+    Lru _lru;                       ///< Keys, most recently used first.
+};
+
+}  // namespace lsst::qserv::ccontrol
+
+#endif  // LSST_QSERV_CCONTROL_QUERYSESSIONCACHE_H
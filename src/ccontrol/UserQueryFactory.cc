@@ -25,7 +25,9 @@
 #include "ccontrol/UserQueryFactory.h"
 
 // System headers
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cstdlib>
 #include <memory>
 #include <string>
@@ -39,6 +41,7 @@
 #include "ccontrol/ConfigError.h"
 #include "ccontrol/ConfigMap.h"
 #include "ccontrol/ParseRunner.h"
+#include "ccontrol/QuerySessionCache.h"
 #include "ccontrol/UserQueryAsyncResult.h"
 #include "ccontrol/UserQueryDrop.h"
 #include "ccontrol/UserQueryFlushChunksCache.h"
@@ -59,9 +62,11 @@
 #include "qmeta/QMetaMysql.h"
 #include "qmeta/QMetaSelect.h"
 #include "qmeta/QStatusMysql.h"
+#include "qmeta/QStatusWriter.h"
 #include "qproc/DatabaseModels.h"
 #include "qproc/QuerySession.h"
 #include "qproc/SecondaryIndex.h"
+#include "qproc/ZoneMapIndex.h"
 #include "query/FromList.h"
 #include "query/SelectStmt.h"
 #include "rproc/InfileMerger.h"
@@ -160,6 +165,16 @@ bool qmetaHasDataForSelectCountStarQuery(query::SelectStmt::Ptr const& stmt,
     return tableExists;
 }
 
+/// @return the QStatus the czar reports the progress of queries to, which
+///         writes chunk completion updates in the background unless disabled.
+std::shared_ptr<qmeta::QStatus> makeQStatus(czar::CzarConfig const& czarConfig) {
+    auto qStatus = std::make_shared<qmeta::QStatusMysql>(czarConfig.getMySqlQStatusDataConfig());
+    if (czarConfig.getQStatusMaxDelayMs() <= 0) return qStatus;
+    std::chrono::milliseconds const maxDelay(czarConfig.getQStatusMaxDelayMs());
+    return std::make_shared<qmeta::QStatusWriter>(qStatus, std::max(czarConfig.getQStatusMaxUpdates(), 1),
+                                                  maxDelay);
+}
+
 std::shared_ptr<UserQuerySharedResources> makeUserQuerySharedResources(
         czar::CzarConfig const& czarConfig, std::shared_ptr<qproc::DatabaseModels> const& dbModels,
         std::string const& czarName) {
@@ -167,10 +182,13 @@ std::shared_ptr<UserQuerySharedResources> makeUserQuerySharedResources(
             czarConfig,
             css::CssAccess::createFromConfig(czarConfig.getCssConfigMap(), czarConfig.getEmptyChunkPath()),
             czarConfig.getMySqlResultConfig(),
-            std::make_shared<qproc::SecondaryIndex>(czarConfig.getMySqlQmetaConfig()),
+            std::make_shared<qproc::SecondaryIndex>(czarConfig.getMySqlQmetaConfig(),
+                                                    std::max(czarConfig.getDirectorIndexCacheMaxRows(), 0),
+                                                    czarConfig.getDirectorIndexCacheCheckIvalSecs()),
+            std::make_shared<qproc::ZoneMapIndex>(czarConfig.getMySqlQmetaConfig()),
             std::make_shared<qmeta::QMetaMysql>(czarConfig.getMySqlQmetaConfig(),
                                                 czarConfig.getMaxMsgSourceStore()),
-            std::make_shared<qmeta::QStatusMysql>(czarConfig.getMySqlQStatusDataConfig()),
+            makeQStatus(czarConfig),
             std::make_shared<qmeta::QMetaSelect>(czarConfig.getMySqlQmetaConfig()),
             sql::SqlConnectionFactory::make(czarConfig.getMySqlResultConfig()), dbModels, czarName,
             czarConfig.getInteractiveChunkLimit());
@@ -180,6 +198,9 @@ std::shared_ptr<UserQuerySharedResources> makeUserQuerySharedResources(
 UserQueryFactory::UserQueryFactory(czar::CzarConfig const& czarConfig,
                                    qproc::DatabaseModels::Ptr const& dbModels, std::string const& czarName)
         : _userQuerySharedResources(makeUserQuerySharedResources(czarConfig, dbModels, czarName)),
+          _querySessionCache(std::make_shared<QuerySessionCache>(
+                  std::max(czarConfig.getQuerySessionCacheSize(), 0),
+                  std::chrono::seconds(czarConfig.getQuerySessionCacheMaxAgeSecs()))),
           _useQservRowCounterOptimization(true) {
     _executiveConfig = std::make_shared<qdisp::ExecutiveConfig>(
             czarConfig.getXrootdFrontendUrl(), czarConfig.getQMetaSecondsBetweenChunkUpdates());
@@ -226,15 +247,25 @@ UserQuery::Ptr UserQueryFactory::newUserQuery(std::string const& aQuery, std::st
         bool sessionValid = true;
         std::string errorExtra;
 
-        // Parse SELECT
+        // A query run again recently skips parsing.
+        auto stmt = _querySessionCache->get(query, defaultDb);
+        std::shared_ptr<query::SelectStmt> parsedStmt;
+        std::chrono::duration<double> parseTime;
+        if (stmt == nullptr) {
+            // Parse SELECT
 
-        ParseRunner::Ptr parser;
-        try {
-            parser = std::make_shared<ParseRunner>(query);
-        } catch (parser::ParseException& e) {
-            return std::make_shared<UserQueryInvalid>(std::string("ParseException:") + e.what());
+            auto const parseStart = std::chrono::steady_clock::now();
+            ParseRunner::Ptr parser;
+            try {
+                parser = std::make_shared<ParseRunner>(query);
+            } catch (parser::ParseException& e) {
+                return std::make_shared<UserQueryInvalid>(std::string("ParseException:") + e.what());
+            }
+            stmt = parser->getSelectStmt();
+            parseTime = std::chrono::steady_clock::now() - parseStart;
+            // The analysis changes 'stmt', the kept copy must be taken before it.
+            if (_querySessionCache->isEnabled()) parsedStmt = stmt->clone();
         }
-        auto stmt = parser->getSelectStmt();
 
         // handle special database/table names
         if (_stmtRefersToProcessListTable(stmt, defaultDb)) {
@@ -283,6 +314,9 @@ UserQuery::Ptr UserQueryFactory::newUserQuery(std::string const& aQuery, std::st
             LOGS(_log, LOG_LVL_ERROR, "Invalid query: " << qs->getError());
             sessionValid = false;
         }
+        if (sessionValid && parsedStmt != nullptr) {
+            _querySessionCache->put(query, defaultDb, parsedStmt, parseTime);
+        }
 
         auto messageStore = std::make_shared<qdisp::MessageStore>();
         std::shared_ptr<qdisp::Executive> executive;
@@ -299,9 +333,10 @@ UserQuery::Ptr UserQueryFactory::newUserQuery(std::string const& aQuery, std::st
         // and errors that the QuerySession `qs` has stored internally.
         auto uq = std::make_shared<UserQuerySelect>(
                 qs, messageStore, executive, _userQuerySharedResources->databaseModels, infileMergerConfig,
-                _userQuerySharedResources->secondaryIndex, _userQuerySharedResources->queryMetadata,
-                _userQuerySharedResources->queryStatsData, _userQuerySharedResources->semaMgrConnections,
-                _userQuerySharedResources->qMetaCzarId, errorExtra, async, resultDb);
+                _userQuerySharedResources->secondaryIndex, _userQuerySharedResources->zoneMapIndex,
+                _userQuerySharedResources->queryMetadata, _userQuerySharedResources->queryStatsData,
+                _userQuerySharedResources->mergeConnPool, _userQuerySharedResources->qMetaCzarId, errorExtra,
+                async, resultDb);
         if (sessionValid) {
             uq->qMetaRegister(resultLocation, msgTableName);
             uq->setupMerger();
@@ -319,6 +354,7 @@ UserQuery::Ptr UserQueryFactory::newUserQuery(std::string const& aQuery, std::st
         if (dbName.empty()) {
             dbName = defaultDb;
         }
+        _querySessionCache->clear();
         auto uq = std::make_shared<UserQueryDrop>(_userQuerySharedResources->css, dbName, tableName,
                                                   _userQuerySharedResources->resultDbConn.get(),
                                                   _userQuerySharedResources->queryMetadata,
@@ -327,6 +363,7 @@ UserQuery::Ptr UserQueryFactory::newUserQuery(std::string const& aQuery, std::st
         return uq;
     } else if (UserQueryType::isDropDb(query, dbName)) {
         // processing DROP DATABASE
+        _querySessionCache->clear();
         auto uq = std::make_shared<UserQueryDrop>(_userQuerySharedResources->css, dbName, std::string(),
                                                   _userQuerySharedResources->resultDbConn.get(),
                                                   _userQuerySharedResources->queryMetadata,
@@ -334,6 +371,7 @@ UserQuery::Ptr UserQueryFactory::newUserQuery(std::string const& aQuery, std::st
         LOGS(_log, LOG_LVL_DEBUG, "make UserQueryDrop: db=" << dbName);
         return uq;
     } else if (UserQueryType::isFlushChunksCache(query, dbName)) {
+        _querySessionCache->clear();
         auto uq = std::make_shared<UserQueryFlushChunksCache>(_userQuerySharedResources->css, dbName,
                                                               _userQuerySharedResources->resultDbConn.get());
         LOGS(_log, LOG_LVL_DEBUG, "make UserQueryFlushChunksCache: " << dbName);
@@ -377,4 +415,8 @@ UserQuery::Ptr UserQueryFactory::newUserQuery(std::string const& aQuery, std::st
     }
 }
 
+std::shared_ptr<qmeta::QStatusWriter> UserQueryFactory::getQStatusWriter() const {
+    return std::dynamic_pointer_cast<qmeta::QStatusWriter>(_userQuerySharedResources->queryStatsData);
+}
+
 }  // namespace lsst::qserv::ccontrol
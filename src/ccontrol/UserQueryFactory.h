@@ -43,6 +43,7 @@
 #include "qdisp/SharedResources.h"
 
 namespace lsst::qserv::ccontrol {
+class QuerySessionCache;
 class UserQuery;
 class UserQuerySharedResources;
 }  // namespace lsst::qserv::ccontrol
@@ -55,6 +56,10 @@ namespace lsst::qserv::qdisp {
 class ExecutiveConfig;
 }
 
+namespace lsst::qserv::qmeta {
+class QStatusWriter;
+}
+
 namespace lsst::qserv::qproc {
 class DatabaseModels;
 }
@@ -85,9 +90,14 @@ public:
                                             std::string const& userQueryId, std::string const& msgTableName,
                                             std::string const& resultDb);
 
+    /// @return the writer of the chunk completion updates of queries, or nullptr
+    ///         if the updates aren't written in the background.
+    std::shared_ptr<qmeta::QStatusWriter> getQStatusWriter() const;
+
 private:
     std::shared_ptr<UserQuerySharedResources> _userQuerySharedResources;
     std::shared_ptr<qdisp::ExecutiveConfig> _executiveConfig;
+    std::shared_ptr<QuerySessionCache> _querySessionCache;  ///< Analyzed SELECT queries.
     bool _useQservRowCounterOptimization;
     bool _debugNoMerge = false;
 };
@@ -28,6 +28,7 @@
 
 // qserv headers
 #include "czar/CzarConfig.h"
+#include "rproc/MergeConnectionPool.h"
 #include "util/SemaMgr.h"
 
 namespace lsst::qserv::ccontrol {
@@ -36,6 +37,7 @@ UserQuerySharedResources::UserQuerySharedResources(
         czar::CzarConfig const& czarConfig_, std::shared_ptr<css::CssAccess> const& css_,
         mysql::MySqlConfig const& mysqlResultConfig_,
         std::shared_ptr<qproc::SecondaryIndex> const& secondaryIndex_,
+        std::shared_ptr<qproc::ZoneMapIndex> const& zoneMapIndex_,
         std::shared_ptr<qmeta::QMeta> const& queryMetadata_,
         std::shared_ptr<qmeta::QStatus> const& queryStatsData_,
         std::shared_ptr<qmeta::QMetaSelect> const& qMetaSelect_,
@@ -46,13 +48,16 @@ UserQuerySharedResources::UserQuerySharedResources(
           css(css_),
           mysqlResultConfig(mysqlResultConfig_),
           secondaryIndex(secondaryIndex_),
+          zoneMapIndex(zoneMapIndex_),
           queryMetadata(queryMetadata_),
           queryStatsData(queryStatsData_),
           qMetaSelect(qMetaSelect_),
           resultDbConn(resultDbConn_),
           databaseModels(dbModels_),
           interactiveChunkLimit(interactiveChunkLimit_),
-          semaMgrConnections(new util::SemaMgr(czarConfig.getResultMaxConnections())) {
+          mergeConnPool(std::make_shared<rproc::MergeConnectionPool>(
+                  mysqlResultConfig_, std::make_shared<util::SemaMgr>(czarConfig.getResultMaxConnections()),
+                  czarConfig.getMaxSqlConnectionAttempts())) {
     // register czar in QMeta
     // TODO: check that czar with the same name is not active already?
     qMetaCzarId = queryMetadata->registerCzar(czarName);
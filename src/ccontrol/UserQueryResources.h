@@ -55,14 +55,15 @@ class QMetaSelect;
 namespace lsst::qserv::qproc {
 class DatabaseModels;
 class SecondaryIndex;
+class ZoneMapIndex;
 }  // namespace lsst::qserv::qproc
 
-namespace lsst::qserv::sql {
-class SqlConnection;
+namespace lsst::qserv::rproc {
+class MergeConnectionPool;
 }
 
-namespace lsst::qserv::util {
-class SemaMgr;
+namespace lsst::qserv::sql {
+class SqlConnection;
 }
 
 namespace lsst::qserv::ccontrol {
@@ -75,6 +76,7 @@ public:
     UserQuerySharedResources(czar::CzarConfig const& czarConfig_, std::shared_ptr<css::CssAccess> const& css_,
                              mysql::MySqlConfig const& mysqlResultConfig_,
                              std::shared_ptr<qproc::SecondaryIndex> const& secondaryIndex_,
+                             std::shared_ptr<qproc::ZoneMapIndex> const& zoneMapIndex_,
                              std::shared_ptr<qmeta::QMeta> const& queryMetadata_,
                              std::shared_ptr<qmeta::QStatus> const& queryStatsData_,
                              std::shared_ptr<qmeta::QMetaSelect> const& qMetaSelect_,
@@ -88,6 +90,7 @@ public:
     std::shared_ptr<css::CssAccess> css;
     mysql::MySqlConfig const mysqlResultConfig;
     std::shared_ptr<qproc::SecondaryIndex> secondaryIndex;
+    std::shared_ptr<qproc::ZoneMapIndex> zoneMapIndex;
     std::shared_ptr<qmeta::QMeta> queryMetadata;
     std::shared_ptr<qmeta::QStatus> queryStatsData;
     std::shared_ptr<qmeta::QMetaSelect> qMetaSelect;
@@ -95,7 +98,7 @@ public:
     std::shared_ptr<qproc::DatabaseModels> databaseModels;
     qmeta::CzarId qMetaCzarId;  ///< Czar ID in QMeta database
     int const interactiveChunkLimit;
-    std::shared_ptr<util::SemaMgr> semaMgrConnections;
+    std::shared_ptr<rproc::MergeConnectionPool> mergeConnPool;  ///< Connections for parallel merges.
 
     /**
      * @brief Make a query resources with parameters that are specific to the UserQuery (the id and the
@@ -63,11 +63,15 @@
 #include "ccontrol/UserQuerySelect.h"
 
 // System headers
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <map>
 #include <memory>
 
 // Third-party headers
+#include <boost/algorithm/string/case_conv.hpp>
 #include <boost/algorithm/string/replace.hpp>
 
 #include "qdisp/QdispPool.h"
@@ -78,6 +82,7 @@
 #include "ccontrol/MergingHandler.h"
 #include "ccontrol/TmpTableName.h"
 #include "ccontrol/UserQueryError.h"
+#include "czar/CzarConfig.h"
 #include "global/constants.h"
 #include "global/LogContext.h"
 #include "global/MsgReceiver.h"
@@ -91,6 +96,7 @@
 #include "qproc/IndexMap.h"
 #include "qproc/QuerySession.h"
 #include "qproc/TaskMsgFactory.h"
+#include "qproc/ZoneMapIndex.h"
 #include "query/ColumnRef.h"
 #include "query/FromList.h"
 #include "query/JoinRef.h"
@@ -149,9 +155,11 @@ UserQuerySelect::UserQuerySelect(std::shared_ptr<qproc::QuerySession> const& qs,
                                  std::shared_ptr<qproc::DatabaseModels> const& dbModels,
                                  std::shared_ptr<rproc::InfileMergerConfig> const& infileMergerConfig,
                                  std::shared_ptr<qproc::SecondaryIndex> const& secondaryIndex,
+                                 std::shared_ptr<qproc::ZoneMapIndex> const& zoneMapIndex,
                                  std::shared_ptr<qmeta::QMeta> const& queryMetadata,
                                  std::shared_ptr<qmeta::QStatus> const& queryStatsData,
-                                 std::shared_ptr<util::SemaMgr> const& semaMgrConn, qmeta::CzarId czarId,
+                                 std::shared_ptr<rproc::MergeConnectionPool> const& mergeConnPool,
+                                 qmeta::CzarId czarId,
                                  std::string const& errorExtra, bool async, std::string const& resultDb)
         : _qSession(qs),
           _messageStore(messageStore),
@@ -159,9 +167,10 @@ UserQuerySelect::UserQuerySelect(std::shared_ptr<qproc::QuerySession> const& qs,
           _databaseModels(dbModels),
           _infileMergerConfig(infileMergerConfig),
           _secondaryIndex(secondaryIndex),
+          _zoneMapIndex(zoneMapIndex),
           _queryMetadata(queryMetadata),
           _queryStatsData(queryStatsData),
-          _semaMgrConn(semaMgrConn),
+          _mergeConnPool(mergeConnPool),
           _qMetaCzarId(czarId),
           _errorExtra(errorExtra),
           _resultDb(resultDb),
@@ -258,13 +267,25 @@ void UserQuerySelect::submit() {
     LOGS(_log, LOG_LVL_DEBUG, "UserQuerySelect beginning submission");
     assert(_infileMerger);
 
-    auto taskMsgFactory = std::make_shared<qproc::TaskMsgFactory>(_qMetaQueryId);
+    auto const& czarConfig = _infileMergerConfig->czarConfig;
+    proto::ProtoHeader::Codec resultCodec = proto::ProtoHeader::NONE;
+    if (!proto::ProtoHeader::Codec_Parse(boost::algorithm::to_upper_copy(czarConfig.getResultCodec()),
+                                         &resultCodec)) {
+        LOGS(_log, LOG_LVL_WARN,
+             "unknown resultCodec=" << czarConfig.getResultCodec() << ", results won't be compressed");
+    }
+    auto taskMsgFactory = std::make_shared<qproc::TaskMsgFactory>(
+            _qMetaQueryId, resultCodec, std::max(0, czarConfig.getResultCompressMinBytes()));
     TmpTableName ttn(_qMetaQueryId, _qSession->getOriginal());
     std::vector<int> chunks;
     std::mutex chunksMtx;
     int sequence = 0;
 
     auto queryTemplates = _qSession->makeQueryTemplates();
+    // For ORDER BY ... LIMIT queries, the templates restricted by the latest
+    // bound from the results of the completed jobs.
+    std::string orderByBound;
+    std::vector<query::QueryTemplate> boundedTemplates;
 
     LOGS(_log, LOG_LVL_DEBUG,
          "first query template:" << (queryTemplates.size() > 0 ? queryTemplates[0].sqlFragment()
@@ -279,40 +300,106 @@ void UserQuerySelect::submit() {
         threadPriority.setPriorityPolicy(10);
     }
 
+    // Chunks that were last seen on the same worker are sent to it in batches of up to
+    // maxBatchChunks, the others are sent one by one for XrdSsi to find them.
+    // Each element is the id of the worker, or an empty string, and the chunks of one job.
+    using JobChunks = std::pair<std::string, std::vector<qproc::ChunkSpec const*>>;
+    std::vector<JobChunks> jobChunksVect;
+    size_t const maxBatchChunks = std::max(0, czarConfig.getMaxBatchChunks());
+    auto const chunkPlacement = _executive->getChunkPlacement();
+    if (czarConfig.getTaskMsgTemplates()) {
+        taskMsgFactory->setWorkerLookup([chunkPlacement](std::string const& db, int chunkId) {
+            return chunkPlacement->get(db, chunkId);
+        });
+    }
+    std::map<std::string, size_t> openBatches;  // Index of the batch being filled for each worker.
+    for (auto i = _qSession->cQueryBegin(), e = _qSession->cQueryEnd(); i != e; ++i) {
+        std::string workerId;
+        if (maxBatchChunks > 1) workerId = chunkPlacement->get(_qSession->getDominantDb(), i->chunkId);
+        if (workerId.empty()) {
+            jobChunksVect.emplace_back(workerId, std::vector<qproc::ChunkSpec const*>{&*i});
+            continue;
+        }
+        auto iter = openBatches.find(workerId);
+        if (iter == openBatches.end() || jobChunksVect[iter->second].second.size() >= maxBatchChunks) {
+            iter = openBatches.insert_or_assign(workerId, jobChunksVect.size()).first;
+            jobChunksVect.emplace_back(workerId, std::vector<qproc::ChunkSpec const*>());
+        }
+        jobChunksVect[iter->second].second.push_back(&*i);
+    }
+    for (auto& jobChunks : jobChunksVect) {
+        if (jobChunks.second.size() == 1) jobChunks.first.clear();
+    }
+
     // Add QStatsTmp table entry
     try {
-        _queryStatsData->queryStatsTmpRegister(_qMetaQueryId, _qSession->getChunksSize());
+        _queryStatsData->queryStatsTmpRegister(_qMetaQueryId, jobChunksVect.size());
     } catch (qmeta::SqlError const& e) {
         LOGS(_log, LOG_LVL_WARN, "Failed queryStatsTmpRegister " << e.what());
     }
 
     _executive->setScanInteractive(_qSession->getScanInteractive());
 
-    for (auto i = _qSession->cQueryBegin(), e = _qSession->cQueryEnd(); i != e && !_executive->getCancelled();
-         ++i) {
-        auto& chunkSpec = *i;
+    // Makes the job for one chunk, sent to /chk/db/chunk. This is also used after submit()
+    // returns, for the chunks of batches that had to be split.
+    auto makeChunkJob = [this, ttn, taskMsgFactory](int jobId, qproc::ChunkQuerySpec::Ptr const& cs) {
+        std::string chunkResultName = ttn.make(cs->chunkId);
+        std::shared_ptr<ChunkMsgReceiver> cmr = ChunkMsgReceiver::newInstance(cs->chunkId, _messageStore);
+        ResourceUnit ru;
+        ru.setAsDbChunk(cs->db, cs->chunkId);
+        auto mergingHandler = std::make_shared<MergingHandler>(cmr, _infileMerger, chunkResultName);
+        return qdisp::JobDescription::create(_qMetaCzarId, _executive->getId(), jobId, ru, mergingHandler,
+                                             taskMsgFactory, cs, chunkResultName);
+    };
+    // Jobs made for the chunks of split batches are numbered after the others.
+    auto splitJobId = std::make_shared<std::atomic<int>>(jobChunksVect.size());
+    qdisp::JobDescription::MakeJobFunc makeSplitJob = [makeChunkJob,
+                                                       splitJobId](qproc::ChunkQuerySpec::Ptr const& cs) {
+        return makeChunkJob((*splitJobId)++, cs);
+    };
+
+    for (auto const& jobChunks : jobChunksVect) {
+        if (_executive->getCancelled()) break;
 
         std::function<void(util::CmdData*)> funcBuildJob = [this, sequence,  // sequence must be a copy
-                                                            &chunkSpec, &queryTemplates, &chunks, &chunksMtx,
-                                                            &ttn, &taskMsgFactory](util::CmdData*) {
+                                                            jobChunks,       // jobChunks must be a copy
+                                                            &queryTemplates, &orderByBound, &boundedTemplates,
+                                                            &chunks, &chunksMtx, &ttn, &taskMsgFactory,
+                                                            &makeChunkJob, &makeSplitJob](util::CmdData*) {
             QSERV_LOGCONTEXT_QUERY(_qMetaQueryId);
 
-            qproc::ChunkQuerySpec::Ptr cs;
+            std::vector<qproc::ChunkQuerySpec::Ptr> chunkQuerySpecs;
             {
                 std::lock_guard<std::mutex> lock(chunksMtx);
+                std::string bound;
+                if (_infileMerger->getTopKBound(bound) && bound != orderByBound) {
+                    orderByBound = bound;
+                    boundedTemplates = _qSession->makeQueryTemplates(orderByBound);
+                    LOGS(_log, LOG_LVL_DEBUG,
+                         "ORDER BY bound " << orderByBound << " query template:"
+                                           << (boundedTemplates.empty() ? "none produced."
+                                                                        : boundedTemplates[0].sqlFragment()));
+                }
                 bool const fillInChunkIdTag = false;
-                cs = _qSession->buildChunkQuerySpec(queryTemplates, chunkSpec, fillInChunkIdTag);
-                chunks.push_back(cs->chunkId);
+                auto const& templates = boundedTemplates.empty() ? queryTemplates : boundedTemplates;
+                for (auto chunkSpec : jobChunks.second) {
+                    chunkQuerySpecs.push_back(
+                            _qSession->buildChunkQuerySpec(templates, *chunkSpec, fillInChunkIdTag));
+                    chunks.push_back(chunkQuerySpecs.back()->chunkId);
+                }
+            }
+            auto const& cs = chunkQuerySpecs.front();
+            qdisp::JobDescription::Ptr jobDesc;
+            if (jobChunks.first.empty()) {
+                jobDesc = makeChunkJob(sequence, cs);
+            } else {
+                std::string chunkResultName = ttn.make(cs->chunkId);
+                auto cmr = ChunkMsgReceiver::newInstance(cs->chunkId, _messageStore);
+                jobDesc = qdisp::JobDescription::createBatch(
+                        _qMetaCzarId, _executive->getId(), sequence, jobChunks.first,
+                        std::make_shared<MergingHandler>(cmr, _infileMerger, chunkResultName),
+                        taskMsgFactory, chunkQuerySpecs, chunkResultName, makeSplitJob);
             }
-            std::string chunkResultName = ttn.make(cs->chunkId);
-
-            std::shared_ptr<ChunkMsgReceiver> cmr = ChunkMsgReceiver::newInstance(cs->chunkId, _messageStore);
-            ResourceUnit ru;
-            ru.setAsDbChunk(cs->db, cs->chunkId);
-            qdisp::JobDescription::Ptr jobDesc = qdisp::JobDescription::create(
-                    _qMetaCzarId, _executive->getId(), sequence, ru,
-                    std::make_shared<MergingHandler>(cmr, _infileMerger, chunkResultName), taskMsgFactory, cs,
-                    chunkResultName);
             _executive->add(jobDesc);
         };
 
@@ -425,7 +512,7 @@ void UserQuerySelect::setupMerger() {
                                           ? _infileMergerConfig->mergeStmt->getQueryTemplate().sqlFragment()
                                           : "nullptr"));
     _infileMerger =
-            std::make_shared<rproc::InfileMerger>(*_infileMergerConfig, _databaseModels, _semaMgrConn);
+            std::make_shared<rproc::InfileMerger>(*_infileMergerConfig, _databaseModels, _mergeConnPool);
 
     auto&& preFlightStmt = _qSession->getPreFlightStmt();
     if (preFlightStmt == nullptr) {
@@ -510,9 +597,20 @@ void UserQuerySelect::_setupChunking() {
         }
 
         LOGS(_log, LOG_LVL_TRACE, "Chunk specs: " << util::printable(csv));
+        // Chunks whose zone maps can't satisfy the WHERE clause are skipped as if they were empty.
+        IntSet zoneMapExcluded;
+        auto zoneMapRestrictors = _qSession->getZoneMapRestrictors();
+        if (zoneMapRestrictors != nullptr && _zoneMapIndex != nullptr) {
+            try {
+                zoneMapExcluded = _zoneMapIndex->excludedChunks(*zoneMapRestrictors);
+            } catch (std::exception const& e) {
+                LOGS(_log, LOG_LVL_WARN, "Zone map lookup failed, no chunks skipped: " << e.what());
+            }
+            LOGS(_log, LOG_LVL_DEBUG, "Chunks skipped by zone maps: " << zoneMapExcluded.size());
+        }
         // Filter out empty chunks
         for (qproc::ChunkSpecVector::const_iterator i = csv.begin(), e = csv.end(); i != e; ++i) {
-            if (eSet->count(i->chunkId) == 0) {  // chunk not in empty?
+            if (eSet->count(i->chunkId) == 0 && zoneMapExcluded.count(i->chunkId) == 0) {
                 _qSession->addChunk(*i);
             }
         }
@@ -62,6 +62,7 @@ namespace lsst::qserv::qproc {
 class DatabaseModels;
 class QuerySession;
 class SecondaryIndex;
+class ZoneMapIndex;
 }  // namespace lsst::qserv::qproc
 
 namespace lsst::qserv::query {
@@ -72,12 +73,9 @@ class SelectStmt;
 namespace lsst::qserv::rproc {
 class InfileMerger;
 class InfileMergerConfig;
+class MergeConnectionPool;
 }  // namespace lsst::qserv::rproc
 
-namespace lsst::qserv::util {
-class SemaMgr;
-}
-
 namespace lsst::qserv::ccontrol {
 
 /// UserQuerySelect : implementation of the UserQuery for regular SELECT statements.
@@ -89,9 +87,10 @@ public:
                     std::shared_ptr<qproc::DatabaseModels> const& dbModels,
                     std::shared_ptr<rproc::InfileMergerConfig> const& infileMergerConfig,
                     std::shared_ptr<qproc::SecondaryIndex> const& secondaryIndex,
+                    std::shared_ptr<qproc::ZoneMapIndex> const& zoneMapIndex,
                     std::shared_ptr<qmeta::QMeta> const& queryMetadata,
                     std::shared_ptr<qmeta::QStatus> const& queryStatsData,
-                    std::shared_ptr<util::SemaMgr> const& semaMgrConn, qmeta::CzarId czarId,
+                    std::shared_ptr<rproc::MergeConnectionPool> const& mergeConnPool, qmeta::CzarId czarId,
                     std::string const& errorExtra, bool async, std::string const& resultDb);
 
     UserQuerySelect(UserQuerySelect const&) = delete;
@@ -175,9 +174,10 @@ private:
     std::shared_ptr<rproc::InfileMergerConfig> _infileMergerConfig;
     std::shared_ptr<rproc::InfileMerger> _infileMerger;
     std::shared_ptr<qproc::SecondaryIndex> _secondaryIndex;
+    std::shared_ptr<qproc::ZoneMapIndex> _zoneMapIndex;
     std::shared_ptr<qmeta::QMeta> _queryMetadata;
     std::shared_ptr<qmeta::QStatus> _queryStatsData;
-    std::shared_ptr<util::SemaMgr> const& _semaMgrConn;
+    std::shared_ptr<rproc::MergeConnectionPool> const _mergeConnPool;
 
     qmeta::CzarId _qMetaCzarId;  ///< Czar ID in QMeta database
     QueryId _qMetaQueryId{0};    ///< Query ID in QMeta database
@@ -0,0 +1,134 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// System headers
+#include <chrono>
+#include <memory>
+#include <string>
+
+// Qserv headers
+#include "ccontrol/ParseRunner.h"
+#include "ccontrol/QuerySessionCache.h"
+#include "qdisp/CzarStats.h"
+#include "qdisp/QdispPool.h"
+#include "query/QueryTemplate.h"
+#include "query/SelectStmt.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE QuerySessionCache
+#include <boost/test/unit_test.hpp>
+
+using namespace lsst::qserv;
+using namespace std::chrono_literals;
+using ccontrol::QuerySessionCache;
+
+namespace {
+
+/// The cache counts its hits and misses in the global CzarStats.
+struct CzarStatsFixture {
+    CzarStatsFixture() { qdisp::CzarStats::setup(std::make_shared<qdisp::QdispPool>(true)); }
+};
+
+/// @return how much the counter 'name' of the cache changed since 'before'.
+double counted(nlohmann::json const& before, std::string const& name) {
+    auto const now = qdisp::CzarStats::get()->getQuerySessionCacheStatsJson();
+    return now[name].get<double>() - before[name].get<double>();
+}
+
+}  // namespace
+
+BOOST_GLOBAL_FIXTURE(CzarStatsFixture);
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(Normalize) {
+    BOOST_CHECK_EQUAL(QuerySessionCache::normalize("  SELECT *\n\tFROM  Object ; "),
+                      "SELECT * FROM Object ;");
+    BOOST_CHECK_EQUAL(QuerySessionCache::normalize("SELECT 'a  b', \"c\\\"  d\"  FROM `my  table`"),
+                      "SELECT 'a  b', \"c\\\"  d\" FROM `my  table`");
+
+    // Queries with comments are never the same as another one.
+    BOOST_CHECK_EQUAL(QuerySessionCache::normalize("SELECT * FROM t -- c\nWHERE x=1"), "");
+    BOOST_CHECK_EQUAL(QuerySessionCache::normalize("SELECT * FROM t # c\nWHERE x=1"), "");
+    BOOST_CHECK_EQUAL(QuerySessionCache::normalize("SELECT * /* c */ FROM t"), "");
+    BOOST_CHECK_EQUAL(QuerySessionCache::normalize("SELECT '--#/*' FROM t"), "SELECT '--#/*' FROM t");
+}
+
+BOOST_AUTO_TEST_CASE(Comments) {
+    QuerySessionCache cache(10, 1h);
+    auto const stmt = std::make_shared<query::SelectStmt>();
+    cache.put("SELECT * FROM t -- c\nWHERE x=1", "LSST", stmt, 1s);
+    BOOST_CHECK_EQUAL(cache.size(), 0u);
+    BOOST_CHECK(cache.get("SELECT * FROM t -- c WHERE x=1", "LSST") == nullptr);
+    BOOST_CHECK(cache.get("SELECT * FROM t -- c\nWHERE x=1", "LSST") == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(Lookup) {
+    auto const before = qdisp::CzarStats::get()->getQuerySessionCacheStatsJson();
+    QuerySessionCache cache(2, 1h);
+    auto const stmt = ccontrol::ParseRunner::makeSelectStmt("SELECT a FROM t WHERE b=1");
+    std::string const sql = stmt->getQueryTemplate().sqlFragment();
+    BOOST_CHECK(cache.get("SELECT 1", "LSST") == nullptr);
+    cache.put("SELECT 1", "LSST", stmt, 2s);
+
+    // Each run gets its own copy to analyze.
+    auto const copy = cache.get("SELECT\n  1 ", "LSST");
+    BOOST_REQUIRE(copy != nullptr);
+    BOOST_CHECK(copy != stmt);
+    BOOST_CHECK_EQUAL(copy->getQueryTemplate().sqlFragment(), sql);
+    copy->setWhereClause(nullptr);
+    BOOST_CHECK_EQUAL(cache.get("SELECT 1", "LSST")->getQueryTemplate().sqlFragment(), sql);
+    BOOST_CHECK(cache.get("SELECT 1", "Other") == nullptr);
+    BOOST_CHECK(cache.get("SELECT 2", "LSST") == nullptr);
+
+    // The least recently used one goes first.
+    cache.put("SELECT 2", "LSST", stmt, 1s);
+    BOOST_CHECK(cache.get("SELECT 1", "LSST") != nullptr);
+    cache.put("SELECT 3", "LSST", stmt, 1s);
+    BOOST_CHECK_EQUAL(cache.size(), 2u);
+    BOOST_CHECK(cache.get("SELECT 2", "LSST") == nullptr);
+
+    BOOST_CHECK_EQUAL(counted(before, "hits"), 3);
+    BOOST_CHECK_EQUAL(counted(before, "misses"), 4);
+    BOOST_CHECK_EQUAL(counted(before, "evictions"), 1);
+    BOOST_CHECK_CLOSE(counted(before, "savedSecs"), 6.0, 0.001);
+
+    cache.clear();
+    BOOST_CHECK_EQUAL(cache.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(Expiry) {
+    auto const before = qdisp::CzarStats::get()->getQuerySessionCacheStatsJson();
+    auto const stmt = std::make_shared<query::SelectStmt>();
+    QuerySessionCache cache(10, 0s);
+    cache.put("SELECT 1", "LSST", stmt, 1s);
+    BOOST_CHECK(cache.get("SELECT 1", "LSST") == nullptr);
+    BOOST_CHECK_EQUAL(cache.size(), 0u);
+    BOOST_CHECK_EQUAL(counted(before, "expirations"), 1);
+
+    QuerySessionCache disabled(0, 1h);
+    BOOST_CHECK(!disabled.isEnabled());
+    disabled.put("SELECT 1", "LSST", stmt, 1s);
+    BOOST_CHECK(disabled.get("SELECT 1", "LSST") == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -116,6 +116,7 @@ Czar::Czar(string const& configPath, string const& czarName)
     qdisp::QdispPool::Ptr qdispPool =
             make_shared<qdisp::QdispPool>(qPoolSize, maxPriority, vectRunSizes, vectMinRunningSizes);
     qdisp::CzarStats::setup(qdispPool);
+    qdisp::CzarStats::get()->setQStatusWriter(_uqFactory->getQStatusWriter());
 
     int qReqPseudoMaxRunning = _czarConfig.getQReqPseudoFifoMaxRunning();
     qdisp::PseudoFifo::Ptr queryRequestPseudoFifo = make_shared<qdisp::PseudoFifo>(qReqPseudoMaxRunning);
@@ -67,6 +67,9 @@ CzarConfig::CzarConfig(util::ConfigStore const& configStore)
           _maxTableSizeMB(configStore.getInt("resultdb.maxtablesize_mb", 5001)),
           _maxSqlConnectionAttempts(configStore.getInt("resultdb.maxsqlconnectionattempts", 10)),
           _resultEngine(configStore.get("resultdb.engine", "myisam")),
+          _resultMergeMethod(configStore.get("resultdb.mergemethod", "infile")),
+          _maxAggregateGroups(configStore.getInt("resultdb.maxaggregategroups", 100000)),
+          _maxTopKRows(configStore.getInt("resultdb.maxtopkrows", 100000)),
           _resultMaxConnections(configStore.getInt("resultdb.maxconnections", 40)),
           _oldestResultKeptDays(configStore.getInt("resultdb.oldestResultKeptDays", 30)),
           _cssConfigMap(configStore.getSectionConfigMap("css")),
@@ -85,6 +88,16 @@ CzarConfig::CzarConfig(util::ConfigStore const& configStore)
           _xrootdSpread(configStore.getInt("tuning.xrootdSpread", 4)),
           _qMetaSecsBetweenChunkCompletionUpdates(
                   configStore.getInt("tuning.qMetaSecsBetweenChunkCompletionUpdates", 60)),
+          _qStatusMaxUpdates(configStore.getInt("tuning.qStatusMaxUpdates", 100)),
+          _qStatusMaxDelayMs(configStore.getInt("tuning.qStatusMaxDelayMs", 1000)),
+          _resultCodec(configStore.get("tuning.resultCodec", "none")),
+          _resultCompressMinBytes(configStore.getInt("tuning.resultCompressMinBytes", 65536)),
+          _maxBatchChunks(configStore.getInt("tuning.maxBatchChunks", 0)),
+          _taskMsgTemplates(configStore.getInt("tuning.taskMsgTemplates", 1) != 0),
+          _querySessionCacheSize(configStore.getInt("tuning.querySessionCacheSize", 100)),
+          _querySessionCacheMaxAgeSecs(configStore.getInt("tuning.querySessionCacheMaxAgeSecs", 60)),
+          _directorIndexCacheMaxRows(configStore.getInt("tuning.directorIndexCacheMaxRows", 20000000)),
+          _directorIndexCacheCheckIvalSecs(configStore.getInt("tuning.directorIndexCacheCheckIvalSecs", 10)),
           _maxMsgSourceStore(configStore.getInt("qmeta.maxMsgSourceStore", 3)),
           _queryDistributionTestVer(configStore.getInt("tuning.queryDistributionTestVer", 0)),
           _qdispPoolSize(configStore.getInt("qdisppool.poolSize", 1000)),
@@ -133,12 +133,53 @@ public:
      */
     int getQMetaSecondsBetweenChunkUpdates() const { return _qMetaSecsBetweenChunkCompletionUpdates; }
 
+    /// @return the number of queries with a chunk completion update waiting
+    ///         that makes the czar write them all to QStatsTmp.
+    int getQStatusMaxUpdates() const { return _qStatusMaxUpdates; }
+
+    /// @return the longest a chunk completion update waits before being
+    ///         written to QStatsTmp, 0 to write each update when it comes.
+    int getQStatusMaxDelayMs() const { return _qStatusMaxDelayMs; }
+
+    /// @return the codec workers are asked to compress result messages with,
+    ///         "none" or "zlib".
+    std::string getResultCodec() const { return _resultCodec; }
+
+    /// @return the size in bytes below which workers don't compress result messages.
+    int getResultCompressMinBytes() const { return _resultCompressMinBytes; }
+
+    /// @return the largest number of chunks sent to a worker in one request,
+    ///         0 or 1 to send all chunks one by one.
+    int getMaxBatchChunks() const { return _maxBatchChunks; }
+
+    /// @return true if workers that already have the template of a query's
+    ///         messages are only sent what differs between chunks.
+    bool getTaskMsgTemplates() const { return _taskMsgTemplates; }
+
+    /// @return the number of parsed SELECT queries kept for when they are
+    ///         run again, 0 to parse every query.
+    int getQuerySessionCacheSize() const { return _querySessionCacheSize; }
+
+    /// @return how long in seconds a parsed SELECT query may be reused.
+    int getQuerySessionCacheMaxAgeSecs() const { return _querySessionCacheMaxAgeSecs; }
+
+    /// @return the total number of director index entries kept in memory for
+    ///         lookups of integer keys, 0 to look up all keys in MySQL.
+    int getDirectorIndexCacheMaxRows() const { return _directorIndexCacheMaxRows; }
+
+    /// @return how often in seconds the director index tables kept in memory
+    ///         are checked for changes.
+    int getDirectorIndexCacheCheckIvalSecs() const { return _directorIndexCacheCheckIvalSecs; }
+
     int getMaxMsgSourceStore() const { return _maxMsgSourceStore; }
 
     /// Getters for result aggregation options.
     int getMaxTableSizeMB() const { return _maxTableSizeMB; }
     int getMaxSqlConnectionAttempts() const { return _maxSqlConnectionAttempts; }
     std::string getResultEngine() const { return _resultEngine; }
+    std::string getResultMergeMethod() const { return _resultMergeMethod; }
+    int getMaxAggregateGroups() const { return _maxAggregateGroups; }
+    int getMaxTopKRows() const { return _maxTopKRows; }
     int getResultMaxConnections() const { return _resultMaxConnections; }
 
     /// Getters for QdispPool configuration
@@ -170,6 +211,9 @@ private:
     int const _maxTableSizeMB;
     int const _maxSqlConnectionAttempts;
     std::string const _resultEngine;
+    std::string const _resultMergeMethod;  ///< "infile" or "prepared"
+    int const _maxAggregateGroups;         ///< Groups reduced in memory per query, 0 disables.
+    int const _maxTopKRows;                ///< Largest LIMIT filtered in memory, 0 disables.
     int const _resultMaxConnections;
     /// Any table in the result table not updated in this many days will be deleted.
     int const _oldestResultKeptDays;
@@ -185,6 +229,16 @@ private:
     int const _xrootdCBThreadsInit;
     int const _xrootdSpread;
     int const _qMetaSecsBetweenChunkCompletionUpdates;
+    int const _qStatusMaxUpdates;
+    int const _qStatusMaxDelayMs;
+    std::string const _resultCodec;
+    int const _resultCompressMinBytes;
+    int const _maxBatchChunks;
+    bool const _taskMsgTemplates;
+    int const _querySessionCacheSize;
+    int const _querySessionCacheMaxAgeSecs;
+    int const _directorIndexCacheMaxRows;
+    int const _directorIndexCacheCheckIvalSecs;
     int const _maxMsgSourceStore;  ///< Maximum number of messages to store per msgSource.
     int const _queryDistributionTestVer;
 
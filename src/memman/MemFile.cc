@@ -85,6 +85,7 @@ MemFile::MLResult MemFile::memLock() {
             std::lock_guard<std::mutex> guardSet(_fileMutex);
             _mlocking = false;
             MLResult aokResult(_memInfo.size(), _memInfo.mlockTime(), 0);
+            aokResult.newlyLocked = true;
             _isLocked = true;
             return aokResult;
         }
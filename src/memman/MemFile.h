@@ -51,12 +51,15 @@ public:
     //!                   When bLocked = 0 no bytes were locked and retc holds
     //!                   the reason. When retc = 0 there was not enough memory
     //!                   and the table was marked flexible.
+    //!                   newlyLocked is true if this call locked the file,
+    //!                   rather than finding it already locked.
     //-----------------------------------------------------------------------------
 
     struct MLResult {
         uint64_t bLocked{0};
         double mlockTime{0.0};
         int retc{0};
+        bool newlyLocked{false};
 
         MLResult() {}
         MLResult(uint64_t lksz, double mlockT, int rc) : bLocked(lksz), mlockTime(mlockT), retc(rc) {}
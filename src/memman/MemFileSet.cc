@@ -93,6 +93,7 @@ int MemFileSet::lockAll(bool strict) {
         mlResult = mfP->memLock();
         totLocked += mlResult.bLocked;
         totMlockSeconds += mlResult.mlockTime;
+        if (mlResult.newlyLocked) _numNewlyLocked++;
         if (mlResult.retc != 0 && strict) {
             _lockBytes += totLocked;
             _lockSeconds += totMlockSeconds;
@@ -108,6 +109,7 @@ int MemFileSet::lockAll(bool strict) {
         mlResult = mfP->memLock();
         totLocked += mlResult.bLocked;
         totMlockSeconds += mlResult.mlockTime;
+        if (mlResult.newlyLocked) _numNewlyLocked++;
     }
 
     // We ignore optional files at this point. FUTURE!!!
@@ -127,6 +127,21 @@ public:
 
     MemMan::Status status();
 
+    //-----------------------------------------------------------------------------
+    //! @brief Return the number of files that lockAll() locked, as opposed to
+    //!        finding them locked by another file set.
+    //!
+    //! @return The number of files.
+    //-----------------------------------------------------------------------------
+
+    uint32_t numNewlyLocked() const { return _numNewlyLocked; }
+
+    //-----------------------------------------------------------------------------
+    //! @brief Return the associated chunk number.
+    //-----------------------------------------------------------------------------
+
+    int chunk() const { return _chunk; }
+
     //-----------------------------------------------------------------------------
     //! @brief Constructor
     //!
@@ -156,6 +171,7 @@ private:
     std::vector<MemFile*> _flexFiles;
     uint64_t _lockBytes;  // Total bytes locked
     uint32_t _numFiles;
+    uint32_t _numNewlyLocked = 0;  // Files locked by lockAll() rather than found locked
     int _chunk;
     double _lockSeconds;           // Number of seconds spent locking all files.
     std::atomic<bool> _mtxLocked;  // true -> _setMutex is locked
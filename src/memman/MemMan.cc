@@ -79,10 +79,28 @@ namespace lsst::qserv::memman {
 /*                                C r e a t e                                 */
 /******************************************************************************/
 
-MemMan *MemMan::create(uint64_t maxBytes, std::string const &dbPath) {
+MemMan *MemMan::create(uint64_t maxBytes, std::string const &dbPath, int prefetchDepth, bool hugePages) {
     // Return a memory manager implementation
     //
-    return new MemManReal(dbPath, maxBytes);
+    return new MemManReal(dbPath, maxBytes, prefetchDepth, hugePages);
+}
+
+nlohmann::json MemMan::statusToJson() {
+    Statistics stats = getStatistics();
+    nlohmann::json status;
+    status["bytesLockMax"] = stats.bytesLockMax;
+    status["bytesLocked"] = stats.bytesLocked;
+    status["bytesReserved"] = stats.bytesReserved;
+    status["numMapErrors"] = stats.numMapErrors;
+    status["numLokErrors"] = stats.numLokErrors;
+    status["numFSets"] = stats.numFSets;
+    status["numFiles"] = stats.numFiles;
+    status["numReqdFiles"] = stats.numReqdFiles;
+    status["numFlexFiles"] = stats.numFlexFiles;
+    status["numFlexLock"] = stats.numFlexLock;
+    status["numLocks"] = stats.numLocks;
+    status["numErrors"] = stats.numErrors;
+    return status;
 }
 
 std::string MemMan::Statistics::logString() {
@@ -30,6 +30,9 @@
 #include <string>
 #include <vector>
 
+// Third party headers
+#include "nlohmann/json.hpp"
+
 namespace lsst::qserv::memman {
 
 //-----------------------------------------------------------------------------
@@ -82,14 +85,19 @@ public:
     //-----------------------------------------------------------------------------
     //! @brief Create a memory manager and initialize for processing.
     //!
-    //! @param  maxBytes   - Maximum amount of memory that can be used
-    //! @param  dbPath     - Path to directory where the database resides
+    //! @param  maxBytes      - Maximum amount of memory that can be used
+    //! @param  dbPath        - Path to directory where the database resides
+    //! @param  prefetchDepth - Number of chunks to read ahead of the chunk
+    //!                         being locked, 0 disables reading ahead.
+    //! @param  hugePages     - When true, ask for transparent huge pages on
+    //!                         mapped files.
     //!
     //! @return !0: The pointer to the memory manager.
     //! @return  0: A manager could not be created.
     //-----------------------------------------------------------------------------
 
-    static MemMan* create(uint64_t maxBytes, std::string const& dbPath);
+    static MemMan* create(uint64_t maxBytes, std::string const& dbPath, int prefetchDepth = 0,
+                          bool hugePages = false);
 
     //-----------------------------------------------------------------------------
     //! @brief Lock a set of tables in memory passed to the prepare() method.
@@ -139,6 +147,26 @@ public:
 
     virtual Handle prepare(std::vector<TableInfo> const& tables, int chunk) = 0;
 
+    //-----------------------------------------------------------------------------
+    //! @brief Start reading a set of tables into memory, without waiting, as
+    //!        they are expected to be prepared and locked soon. Nothing is
+    //!        reserved and it is not an error if a table does not exist.
+    //!
+    //! @param  tables - Reference to the tables to read.
+    //! @param  chunk  - The chunk number associated with the tables.
+    //-----------------------------------------------------------------------------
+
+    virtual void prefetch(std::vector<TableInfo> const& tables, int chunk) = 0;
+
+    //-----------------------------------------------------------------------------
+    //! @brief Get the number of chunks to prefetch() ahead of the chunk being
+    //!        locked.
+    //!
+    //! @return The number of chunks, 0 if prefetch() does nothing.
+    //-----------------------------------------------------------------------------
+
+    virtual int getPrefetchDepth() const { return 0; }
+
     //-----------------------------------------------------------------------------
     //! @brief Unlock a set of tables previously locked by the lock() or were
     //!        prepared for locking by prepare().
@@ -207,6 +235,34 @@ public:
 
     virtual Status getStatus(Handle handle) = 0;
 
+    //-----------------------------------------------------------------------------
+    //! @brief Reserve memory used by the worker for something other than the
+    //!        locked tables, such as in-memory tables or buffers. Less memory
+    //!        is then left for locking tables.
+    //!
+    //! @param  bytes  - Number of bytes to reserve.
+    //!
+    //! @return true if the memory was reserved, false if there is not enough.
+    //-----------------------------------------------------------------------------
+
+    virtual bool reserveBytes(uint64_t bytes) { return true; }
+
+    //-----------------------------------------------------------------------------
+    //! @brief Release memory reserved by reserveBytes().
+    //!
+    //! @param  bytes  - Number of bytes to release.
+    //-----------------------------------------------------------------------------
+
+    virtual void releaseBytes(uint64_t bytes) {}
+
+    //-----------------------------------------------------------------------------
+    //! @brief Obtain statistics for the worker status report.
+    //!
+    //! @return a JSON object with the statistics.
+    //-----------------------------------------------------------------------------
+
+    virtual nlohmann::json statusToJson();
+
     //-----------------------------------------------------------------------------
 
     MemMan& operator=(const MemMan&) = delete;
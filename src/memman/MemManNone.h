@@ -55,6 +55,8 @@ public:
         return HandleType::ISEMPTY;
     }
 
+    void prefetch(std::vector<TableInfo> const& tables, int chunk) override {}
+
     bool unlock(Handle handle) override {
         (void)handle;
         return true;
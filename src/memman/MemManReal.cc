@@ -25,20 +25,35 @@
 #include "memman/MemManReal.h"
 
 // System Headers
+#include <algorithm>
+#include <chrono>
 #include <errno.h>
 #include <string.h>
 #include <unordered_map>
 
+// LSST headers
+#include "lsst/log/Log.h"
+
 // Qserv Headers
 #include "memman/MemFile.h"
 #include "memman/MemFileSet.h"
 
+using namespace std::chrono_literals;
+
 /******************************************************************************/
 /*                  L o c a l   S t a t i c   O b j e c t s                   */
 /******************************************************************************/
 
 namespace {
 
+LOG_LOGGER _log = LOG_GET("lsst.qserv.memman.MemManReal");
+
+/// Maximum number of files waiting to be prefetched.
+size_t const prefetchMaxQueued = 1000;
+
+/// Histogram buckets for the time to lock a chunk, in seconds.
+std::vector<double> const lockedBuckets = {0.1, 1.0, 10.0, 100.0};
+
 std::mutex hanMutex;
 
 std::unordered_map<lsst::qserv::memman::MemMan::Handle, lsst::qserv::memman::MemFileSet*> hanCache;
@@ -48,6 +63,33 @@ lsst::qserv::memman::MemMan::Handle handleNum = lsst::qserv::memman::MemMan::Han
 
 namespace lsst::qserv::memman {
 
+/******************************************************************************/
+/*                 C o n s t r u c t o r   &   D e s t r u c t o r            */
+/******************************************************************************/
+
+MemManReal::MemManReal(std::string const& dbPath, uint64_t maxBytes, int prefetchDepth, bool hugePages)
+        : _memory(dbPath, maxBytes),
+          _numErrors(0),
+          _numLkerrs(0),
+          _numLocks(0),
+          _numReqdFiles(0),
+          _numFlexFiles(0),
+          _prefetchDepth(std::max(prefetchDepth, 0)),
+          _histLockedPrefetched("TimeToLockedPrefetched", lockedBuckets, 1h, 10000),
+          _histLockedNotPrefetched("TimeToLockedNotPrefetched", lockedBuckets, 1h, 10000) {
+    _memory.setHugePages(hugePages);
+    if (_prefetchDepth > 0) {
+        _prefetcher.reset(new Prefetcher(_memory, prefetchMaxQueued));
+    }
+}
+
+MemManReal::~MemManReal() {
+    // Stop reading ahead before the memory object goes away.
+    //
+    _prefetcher.reset();
+    unlockAll();
+}
+
 /******************************************************************************/
 /*                         g e t S t a t i s t i c s                          */
 /******************************************************************************/
@@ -132,9 +174,19 @@ int MemManReal::lock(MemMan::Handle handle, bool strict) {
         _numLocks++;
     }
 
-    // Perform the lock and then drop the file set lock.
+    // Perform the lock and then drop the file set lock. The time taken is only
+    // of interest when files had to be locked, rather than found locked.
     //
+    auto start = std::chrono::steady_clock::now();
     rc = fsP->lockAll(strict);
+    std::chrono::duration<double> secs = std::chrono::steady_clock::now() - start;
+    if (rc == 0 && fsP->numNewlyLocked() > 0) {
+        bool prefetched = _prefetcher != nullptr && _prefetcher->wasPrefetched(fsP->chunk());
+        auto& hist = prefetched ? _histLockedPrefetched : _histLockedNotPrefetched;
+        hist.addEntry(secs.count());
+        LOGS(_log, LOG_LVL_DEBUG,
+             "chunk=" << fsP->chunk() << " locked in " << secs.count() << "s prefetched=" << prefetched);
+    }
     fsP->serialize(false);
 
     // If there was an error, check if we should delete this handle
@@ -223,6 +275,63 @@ MemMan::Handle MemManReal::prepare(std::vector<TableInfo> const& tables, int chu
     return HandleType::INVALID;
 }
 
+/******************************************************************************/
+/*                              p r e f e t c h                               */
+/******************************************************************************/
+
+void MemManReal::prefetch(std::vector<TableInfo> const& tables, int chunk) {
+    if (_prefetcher == nullptr) return;
+
+    // Only the files that prepare() would lock are worth reading.
+    //
+    std::vector<std::string> fPaths;
+    for (auto&& tab : tables) {
+        if (tab.theData == TableInfo::LockType::REQUIRED || tab.theData == TableInfo::LockType::FLEXIBLE) {
+            fPaths.push_back(_memory.filePath(tab.tableName, chunk, false));
+        }
+        if (tab.theIndex == TableInfo::LockType::REQUIRED || tab.theIndex == TableInfo::LockType::FLEXIBLE) {
+            fPaths.push_back(_memory.filePath(tab.tableName, chunk, true));
+        }
+    }
+    if (!fPaths.empty()) _prefetcher->add(fPaths, chunk);
+}
+
+/******************************************************************************/
+/*                          r e l e a s e B y t e s                           */
+/******************************************************************************/
+
+void MemManReal::releaseBytes(uint64_t bytes) {
+    _memory.memRestore(bytes);
+    _bytesReservedNotLocked -= bytes;
+}
+
+/******************************************************************************/
+/*                          r e s e r v e B y t e s                           */
+/******************************************************************************/
+
+bool MemManReal::reserveBytes(uint64_t bytes) {
+    if (!_memory.memReserveIfFree(bytes)) return false;
+    _bytesReservedNotLocked += bytes;
+    return true;
+}
+
+/******************************************************************************/
+/*                          s t a t u s T o J s o n                           */
+/******************************************************************************/
+
+nlohmann::json MemManReal::statusToJson() {
+    nlohmann::json status = MemMan::statusToJson();
+    status["bytesReservedNotLocked"] = _bytesReservedNotLocked.load();
+    status["prefetchDepth"] = _prefetchDepth;
+    status["hugePages"] = _memory.getHugePages();
+    if (_prefetcher != nullptr) {
+        status["prefetch"] = _prefetcher->statusToJson();
+    }
+    status["histTimeToLockedPrefetched"] = _histLockedPrefetched.getJson();
+    status["histTimeToLockedNotPrefetched"] = _histLockedNotPrefetched.getJson();
+    return status;
+}
+
 /******************************************************************************/
 /*                                u n l o c k                                 */
 /******************************************************************************/
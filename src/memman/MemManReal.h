@@ -26,12 +26,15 @@
 
 // System headers
 #include <atomic>
+#include <memory>
 #include <mutex>
 #include <unordered_map>
 
 // Qserv Headers
 #include "memman/MemMan.h"
 #include "memman/Memory.h"
+#include "memman/Prefetcher.h"
+#include "util/Histogram.h"
 
 namespace lsst::qserv::memman {
 
@@ -45,6 +48,10 @@ public:
 
     Handle prepare(std::vector<TableInfo> const& tables, int chunk) override;
 
+    void prefetch(std::vector<TableInfo> const& tables, int chunk) override;
+
+    int getPrefetchDepth() const override { return _prefetchDepth; }
+
     bool unlock(Handle handle) override;
 
     void unlockAll() override;
@@ -53,18 +60,18 @@ public:
 
     Status getStatus(Handle handle) override;
 
+    bool reserveBytes(uint64_t bytes) override;
+
+    void releaseBytes(uint64_t bytes) override;
+
+    nlohmann::json statusToJson() override;
+
     MemManReal& operator=(const MemManReal&) = delete;
     MemManReal(const MemManReal&) = delete;
 
-    MemManReal(std::string const& dbPath, uint64_t maxBytes)
-            : _memory(dbPath, maxBytes),
-              _numErrors(0),
-              _numLkerrs(0),
-              _numLocks(0),
-              _numReqdFiles(0),
-              _numFlexFiles(0) {}
+    MemManReal(std::string const& dbPath, uint64_t maxBytes, int prefetchDepth = 0, bool hugePages = false);
 
-    ~MemManReal() override { unlockAll(); }
+    ~MemManReal() override;
 
 private:
     Memory _memory;
@@ -73,6 +80,16 @@ private:
     uint32_t _numLocks;      // Under control of hanMutex
     uint32_t _numReqdFiles;  // Ditto
     uint32_t _numFlexFiles;  // Ditto
+
+    std::atomic<uint64_t> _bytesReservedNotLocked{0};  // Reserved by reserveBytes()
+
+    int const _prefetchDepth;
+    std::unique_ptr<Prefetcher> _prefetcher;  // nullptr if _prefetchDepth is 0
+
+    // Seconds taken by lock() calls that had to lock files, by whether
+    // the chunk was prefetched or not.
+    util::HistogramRolling _histLockedPrefetched;
+    util::HistogramRolling _histLockedNotPrefetched;
 };
 
 }  // namespace lsst::qserv::memman
@@ -167,6 +167,13 @@ MemInfo Memory::mapFile(std::string const& fPath) {
     if (mInfo._memAddr == MAP_FAILED) {
         mInfo.setErrCode(errno);
         _numMapErrs++;
+    } else if (_hugePages) {
+#ifdef MADV_HUGEPAGE
+        // This is only a hint, the kernel may not support huge pages for files.
+        if (madvise(mInfo._memAddr, mInfo._memSize, MADV_HUGEPAGE)) {
+            LOGS(_log, LOG_LVL_DEBUG, "madvise MADV_HUGEPAGE failed errno=" << errno << " " << fPath);
+        }
+#endif
     }
 
     // Close the file and return result
@@ -175,6 +182,31 @@ MemInfo Memory::mapFile(std::string const& fPath) {
     return mInfo;
 }
 
+/******************************************************************************/
+/*                               p r e f e t c h                              */
+/******************************************************************************/
+
+int Memory::prefetch(std::string const& fPath, uint64_t& fSize) {
+    struct stat sBuff;
+    fSize = 0;
+
+    int fdNum = open(fPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fdNum < 0) return errno;
+    if (fstat(fdNum, &sBuff)) {
+        int rc = errno;
+        close(fdNum);
+        return rc;
+    }
+    fSize = static_cast<uint64_t>(sBuff.st_size);
+
+    // The kernel starts reading the whole file and returns, the pages stay in
+    // the page cache after the file is closed until memory is needed.
+    //
+    int rc = posix_fadvise(fdNum, 0, 0, POSIX_FADV_WILLNEED);
+    close(fdNum);
+    return rc;
+}
+
 /******************************************************************************/
 /*                                m e m R e l                                 */
 /******************************************************************************/
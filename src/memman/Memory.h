@@ -168,6 +168,35 @@ public:
 
     MemInfo mapFile(std::string const& fPath);
 
+    //-----------------------------------------------------------------------------
+    //! @brief Start reading a database file into the page cache without
+    //!        waiting for the read to complete.
+    //!
+    //! @param  fPath  - Path of the database file to be read.
+    //! @param  fSize  - Set to the size of the file.
+    //!
+    //! @return =0     - The read was started.
+    //! @return !0     - The read was not started, returned value is the errno.
+    //-----------------------------------------------------------------------------
+
+    int prefetch(std::string const& fPath, uint64_t& fSize);
+
+    //-----------------------------------------------------------------------------
+    //! @brief Ask for transparent huge pages on files mapped from now on.
+    //!
+    //! @param  hugePages - When true, mappings are advised to use huge pages.
+    //-----------------------------------------------------------------------------
+
+    void setHugePages(bool hugePages) { _hugePages = hugePages; }
+
+    //-----------------------------------------------------------------------------
+    //! @brief Check if mappings are advised to use huge pages.
+    //!
+    //! @return true if setHugePages(true) was called.
+    //-----------------------------------------------------------------------------
+
+    bool getHugePages() const { return _hugePages; }
+
     //-----------------------------------------------------------------------------
     //! @brief Unlock a memory object.
     //!
@@ -189,6 +218,21 @@ public:
         _rsvBytes += memSZ;
     }
 
+    //-----------------------------------------------------------------------------
+    //! @brief Reserve memory if enough of it is free.
+    //!
+    //! @param  memSZ   - Bytes of memory to reserve.
+    //!
+    //! @return true if the memory was reserved.
+    //-----------------------------------------------------------------------------
+
+    bool memReserveIfFree(uint64_t memSZ) {
+        std::lock_guard<std::mutex> guard(_memMutex);
+        if (_rsvBytes + memSZ > _maxBytes) return false;
+        _rsvBytes += memSZ;
+        return true;
+    }
+
     //-----------------------------------------------------------------------------
     //! @brief Restore memory previously reserved.
     //! This method must be externally serialized, it is not MT-safe.
@@ -259,6 +303,7 @@ private:
     std::atomic_uint _numMapErrs;
     std::atomic_uint _numLokErrs;
     std::atomic_uint _flexNum;
+    std::atomic<bool> _hugePages{false};
 
     static std::mutex _mlockMtx;  // Prevent multiple concurrent mlock calls.
 };
@@ -0,0 +1,146 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "memman/Prefetcher.h"
+
+// System Headers
+#include <algorithm>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv Headers
+#include "memman/Memory.h"
+
+namespace {
+LOG_LOGGER _log = LOG_GET("lsst.qserv.memman.Prefetcher");
+}
+
+namespace lsst::qserv::memman {
+
+/******************************************************************************/
+/*                 C o n s t r u c t o r   &   D e s t r u c t o r            */
+/******************************************************************************/
+
+Prefetcher::Prefetcher(Memory& memory, size_t maxQueued)
+        : _memory(memory), _maxQueued(maxQueued), _thread(&Prefetcher::_run, this) {}
+
+Prefetcher::~Prefetcher() {
+    {
+        std::lock_guard<std::mutex> lg(_mtx);
+        _stop = true;
+    }
+    _cv.notify_all();
+    _thread.join();
+}
+
+/******************************************************************************/
+/*                                   a d d                                    */
+/******************************************************************************/
+
+void Prefetcher::add(std::vector<std::string> const& fPaths, int chunk) {
+    {
+        std::lock_guard<std::mutex> lg(_mtx);
+        for (auto const& fPath : fPaths) {
+            if (_queued.count(fPath) != 0) continue;
+            if (_queue.size() >= _maxQueued) {
+                _numDropped++;
+                continue;
+            }
+            _queue.push_back(fPath);
+            _queued.insert(fPath);
+            _numQueued++;
+        }
+
+        // Chunks that are never locked must not pile up.
+        //
+        if (std::find(_chunks.begin(), _chunks.end(), chunk) == _chunks.end()) {
+            _chunks.push_back(chunk);
+            if (_chunks.size() > _maxQueued) _chunks.pop_front();
+        }
+    }
+    _cv.notify_one();
+}
+
+/******************************************************************************/
+/*                         w a s P r e f e t c h e d                          */
+/******************************************************************************/
+
+bool Prefetcher::wasPrefetched(int chunk) {
+    std::lock_guard<std::mutex> lg(_mtx);
+    auto it = std::find(_chunks.begin(), _chunks.end(), chunk);
+    if (it == _chunks.end()) return false;
+    _chunks.erase(it);
+    return true;
+}
+
+/******************************************************************************/
+/*                                  _ r u n                                   */
+/******************************************************************************/
+
+void Prefetcher::_run() {
+    std::unique_lock<std::mutex> uLock(_mtx);
+    while (true) {
+        _cv.wait(uLock, [this]() { return _stop || !_queue.empty(); });
+        if (_stop) return;
+        std::string fPath = _queue.front();
+        _queue.pop_front();
+
+        // The file stays in _queued while it is read so it isn't queued again.
+        //
+        uLock.unlock();
+        uint64_t fSize = 0;
+        int rc = _memory.prefetch(fPath, fSize);
+        if (rc == 0) {
+            _numRead++;
+            _bytesRead += fSize;
+            LOGS(_log, LOG_LVL_TRACE, "prefetch " << fPath << " size=" << fSize);
+        } else {
+            _numErrors++;
+            LOGS(_log, LOG_LVL_WARN, "prefetch failed errno=" << rc << " " << fPath);
+        }
+        uLock.lock();
+        _queued.erase(fPath);
+    }
+}
+
+/******************************************************************************/
+/*                           s t a t u s T o J s o n                          */
+/******************************************************************************/
+
+nlohmann::json Prefetcher::statusToJson() {
+    nlohmann::json status;
+    {
+        std::lock_guard<std::mutex> lg(_mtx);
+        status["filesWaiting"] = _queue.size();
+    }
+    status["maxQueued"] = _maxQueued;
+    status["filesQueued"] = _numQueued.load();
+    status["filesDropped"] = _numDropped.load();
+    status["filesRead"] = _numRead.load();
+    status["fileErrors"] = _numErrors.load();
+    status["bytesRead"] = _bytesRead.load();
+    return status;
+}
+
+}  // namespace lsst::qserv::memman
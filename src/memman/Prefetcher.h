@@ -0,0 +1,120 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_QSERV_MEMMAN_PREFETCHER_H
+#define LSST_QSERV_MEMMAN_PREFETCHER_H
+
+// System headers
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Third party headers
+#include "nlohmann/json.hpp"
+
+namespace lsst::qserv::memman {
+
+class Memory;
+
+//-----------------------------------------------------------------------------
+//! @brief Read database files into the page cache ahead of locking them.
+//!
+//! Files are read by a thread of this object, so that the scheduler that
+//! asks for them is never held up. Locking a file that was read this way
+//! only needs to pin pages that are already in memory.
+//-----------------------------------------------------------------------------
+
+class Prefetcher {
+public:
+    //-----------------------------------------------------------------------------
+    //! @brief Queue the files of a chunk to be read. Files already queued are
+    //!        skipped, and files are dropped when the queue is full.
+    //!
+    //! @param  fPaths  - Paths of the files to read.
+    //! @param  chunk   - The chunk number associated with the files.
+    //-----------------------------------------------------------------------------
+
+    void add(std::vector<std::string> const& fPaths, int chunk);
+
+    //-----------------------------------------------------------------------------
+    //! @brief Check if the files of a chunk were queued to be read, and forget
+    //!        about the chunk.
+    //!
+    //! @param  chunk   - The chunk number.
+    //!
+    //! @return true if add() was called for the chunk.
+    //-----------------------------------------------------------------------------
+
+    bool wasPrefetched(int chunk);
+
+    //-----------------------------------------------------------------------------
+    //! @brief Obtain statistics about files read ahead.
+    //!
+    //! @return a JSON object with the statistics.
+    //-----------------------------------------------------------------------------
+
+    nlohmann::json statusToJson();
+
+    Prefetcher& operator=(const Prefetcher&) = delete;
+    Prefetcher(const Prefetcher&) = delete;
+
+    //-----------------------------------------------------------------------------
+    //! Constructor
+    //!
+    //! @param  memory    - Memory object used to read the files.
+    //! @param  maxQueued - Maximum number of files waiting to be read.
+    //-----------------------------------------------------------------------------
+
+    Prefetcher(Memory& memory, size_t maxQueued);
+
+    ~Prefetcher();
+
+private:
+    void _run();
+
+    Memory& _memory;
+    size_t const _maxQueued;
+
+    std::mutex _mtx;
+    std::condition_variable _cv;
+    std::deque<std::string> _queue;  // Protected by _mtx
+    std::set<std::string> _queued;   // Ditto, paths queued or being read
+    std::deque<int> _chunks;         // Ditto, chunks added and not checked yet
+    bool _stop = false;              // Ditto
+
+    std::atomic<uint64_t> _numQueued{0};   // Files queued
+    std::atomic<uint64_t> _numDropped{0};  // Files dropped as the queue was full
+    std::atomic<uint64_t> _numRead{0};     // Files read
+    std::atomic<uint64_t> _numErrors{0};   // Files that could not be read
+    std::atomic<uint64_t> _bytesRead{0};   // Bytes in files read
+
+    std::thread _thread;  // Last, so everything it uses is constructed first
+};
+
+}  // namespace lsst::qserv::memman
+#endif  // LSST_QSERV_MEMMAN_PREFETCHER_H
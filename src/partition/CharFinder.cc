@@ -0,0 +1,180 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#include "partition/CharFinder.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace lsst::partition::csv {
+
+namespace {
+
+CharFinder::Impl bestImpl() {
+    if (CharFinder::isSupported(CharFinder::AVX2)) {
+        return CharFinder::AVX2;
+    } else if (CharFinder::isSupported(CharFinder::SSE42)) {
+        return CharFinder::SSE42;
+    }
+    return CharFinder::SCALAR;
+}
+
+CharFinder::Impl &defaultImpl() {
+    static CharFinder::Impl impl = bestImpl();
+    return impl;
+}
+
+}  // unnamed namespace
+
+CharFinder::CharFinder(std::string const &chars, Impl impl) : _impl(impl), _numChars(0) {
+    if (!isSupported(impl)) {
+        throw std::runtime_error("The requested character search implementation is not supported.");
+    }
+    std::memset(_chars, 0, sizeof(_chars));
+    std::memset(_table, 0, sizeof(_table));
+    for (std::string::const_iterator i = chars.begin(), e = chars.end(); i != e; ++i) {
+        unsigned char const c = static_cast<unsigned char>(*i);
+        if (_table[c]) {
+            continue;
+        }
+        if (_numChars == static_cast<int>(MAX_CHARS)) {
+            throw std::runtime_error("Too many characters to search for.");
+        }
+        _table[c] = true;
+        _chars[_numChars++] = *i;
+    }
+    if (_numChars == 0) {
+        _impl = SCALAR;
+    }
+    // Pad with a character of the set, so that the AVX2 implementation
+    // can always compare against MAX_CHARS characters.
+    for (int i = _numChars; i < static_cast<int>(MAX_CHARS); ++i) {
+        _chars[i] = _chars[0];
+    }
+}
+
+CharFinder::CharFinder(std::string const &chars) : CharFinder(chars, getDefaultImpl()) {}
+
+bool CharFinder::isSupported(Impl impl) {
+    switch (impl) {
+        case SCALAR:
+            return true;
+#if defined(__x86_64__)
+        case SSE42:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse4.2");
+        case AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("sse4.2");
+#endif
+        default:
+            return false;
+    }
+}
+
+CharFinder::Impl CharFinder::getDefaultImpl() { return defaultImpl(); }
+
+void CharFinder::setDefaultImpl(Impl impl) {
+    if (!isSupported(impl)) {
+        throw std::runtime_error("The requested character search implementation is not supported.");
+    }
+    defaultImpl() = impl;
+}
+
+char const *CharFinder::_findScalar(char const *begin, char const *end) const {
+    for (; begin < end; ++begin) {
+        if (_table[static_cast<unsigned char>(*begin)]) {
+            break;
+        }
+    }
+    return begin;
+}
+
+#if defined(__x86_64__)
+
+__attribute__((target("sse4.2"))) char const *CharFinder::_findSse42(char const *begin,
+                                                                    char const *end) const {
+    int const mode = _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_LEAST_SIGNIFICANT;
+    __m128i const chars = _mm_loadu_si128(reinterpret_cast<__m128i const *>(_chars));
+    for (; end - begin >= 16; begin += 16) {
+        __m128i const text = _mm_loadu_si128(reinterpret_cast<__m128i const *>(begin));
+        int const i = _mm_cmpestri(chars, _numChars, text, 16, mode);
+        if (i < 16) {
+            return begin + i;
+        }
+    }
+    return _findScalar(begin, end);
+}
+
+__attribute__((target("avx2,sse4.2"))) char const *CharFinder::_findAvx2(char const *begin,
+                                                                  char const *end) const {
+    // Most CSV field values are short, look at the first 16 characters
+    // before setting up the wider comparisons.
+    if (end - begin >= 16) {
+        int const mode = _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_LEAST_SIGNIFICANT;
+        __m128i const chars = _mm_loadu_si128(reinterpret_cast<__m128i const *>(_chars));
+        __m128i const text = _mm_loadu_si128(reinterpret_cast<__m128i const *>(begin));
+        int const i = _mm_cmpestri(chars, _numChars, text, 16, mode);
+        if (i < 16) {
+            return begin + i;
+        }
+        begin += 16;
+    }
+    __m256i const c0 = _mm256_set1_epi8(_chars[0]);
+    __m256i const c1 = _mm256_set1_epi8(_chars[1]);
+    __m256i const c2 = _mm256_set1_epi8(_chars[2]);
+    __m256i const c3 = _mm256_set1_epi8(_chars[3]);
+    __m256i const c4 = _mm256_set1_epi8(_chars[4]);
+    __m256i const c5 = _mm256_set1_epi8(_chars[5]);
+    __m256i const c6 = _mm256_set1_epi8(_chars[6]);
+    __m256i const c7 = _mm256_set1_epi8(_chars[7]);
+    for (; end - begin >= 32; begin += 32) {
+        __m256i const text = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(begin));
+        __m256i const m = _mm256_or_si256(
+                _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(text, c0), _mm256_cmpeq_epi8(text, c1)),
+                                _mm256_or_si256(_mm256_cmpeq_epi8(text, c2), _mm256_cmpeq_epi8(text, c3))),
+                _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(text, c4), _mm256_cmpeq_epi8(text, c5)),
+                                _mm256_or_si256(_mm256_cmpeq_epi8(text, c6), _mm256_cmpeq_epi8(text, c7))));
+        uint32_t const mask = static_cast<uint32_t>(_mm256_movemask_epi8(m));
+        if (mask != 0) {
+            return begin + __builtin_ctz(mask);
+        }
+    }
+    return _findSse42(begin, end);
+}
+
+#else
+
+char const *CharFinder::_findSse42(char const *begin, char const *end) const {
+    return _findScalar(begin, end);
+}
+
+char const *CharFinder::_findAvx2(char const *begin, char const *end) const {
+    return _findScalar(begin, end);
+}
+
+#endif  // __x86_64__
+
+}  // namespace lsst::partition::csv
@@ -0,0 +1,92 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief Vectorized search for any of a small set of characters.
+
+#ifndef LSST_PARTITION_CHARFINDER_H
+#define LSST_PARTITION_CHARFINDER_H
+
+#include <stdint.h>
+#include <string>
+
+namespace lsst::partition::csv {
+
+/// A CharFinder locates the first occurrence of any character from a small
+/// set in a range of text. It lets the CSV parser skip over the characters
+/// of a field value that have no special meaning 16 or 32 at a time.
+///
+/// The search is implemented with SSE4.2 string instructions or AVX2
+/// comparisons when the CPU supports them, and with a lookup table
+/// otherwise. All implementations return identical results.
+class CharFinder {
+public:
+    enum Impl { SCALAR = 0, SSE42, AVX2 };
+
+    /// The maximum number of distinct characters in a set.
+    static size_t const MAX_CHARS = 8;
+
+    /// Create a finder for the distinct characters of `chars`, which may
+    /// include NUL. An exception is thrown if there are more than MAX_CHARS
+    /// of them, or if `impl` is not supported by the CPU.
+    CharFinder(std::string const &chars, Impl impl);
+
+    /// Create a finder using the default implementation.
+    explicit CharFinder(std::string const &chars);
+
+    /// Return a pointer to the first character in `[begin, end)` that
+    /// belongs to the set, or `end` if there is none.
+    char const *find(char const *begin, char const *end) const {
+        switch (_impl) {
+            case SSE42:
+                return _findSse42(begin, end);
+            case AVX2:
+                return _findAvx2(begin, end);
+            default:
+                return _findScalar(begin, end);
+        }
+    }
+
+    Impl getImpl() const { return _impl; }
+
+    /// Is `impl` supported by the CPU?
+    static bool isSupported(Impl impl);
+
+    /// Return the implementation used by finders created without an
+    /// explicit one. This is the fastest supported implementation,
+    /// unless changed with setDefaultImpl() for testing or benchmarking.
+    static Impl getDefaultImpl();
+    static void setDefaultImpl(Impl impl);
+
+private:
+    char const *_findScalar(char const *begin, char const *end) const;
+    char const *_findSse42(char const *begin, char const *end) const;
+    char const *_findAvx2(char const *begin, char const *end) const;
+
+    Impl _impl;
+    int _numChars;
+    char _chars[16];   // The distinct characters of the set, padded with the first one.
+    bool _table[256];  // Membership of each character value in the set.
+};
+
+}  // namespace lsst::partition::csv
+
+#endif  // LSST_PARTITION_CHARFINDER_H
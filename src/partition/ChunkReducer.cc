@@ -40,6 +40,7 @@ ChunkReducer::ChunkReducer(ConfigStore const& config)
         : _index(boost::make_shared<ChunkIndex>()),
           _chunkId(-1),
           _numNodes(config.get<uint32_t>("out.num-nodes")),
+          _rows(false),
           _prefix(config.get<std::string>("part.prefix").c_str()),  // defend against GCC PR21334
           _outputDir(config.get<std::string>("out.dir").c_str()),   // defend against GCC PR21334
           _chunkAppender(config.get<size_t>("mr.block-size") * MiB),
@@ -49,6 +50,12 @@ ChunkReducer::ChunkReducer(ConfigStore const& config)
                 "The --out.num-nodes option value must be "
                 "between 1 and 99999.");
     }
+    std::string const format = config.get<std::string>("out.format");
+    if (format == "rows") {
+        _rows = true;
+    } else if (format != "csv") {
+        throw std::runtime_error("The --out.format option value must be csv or rows.");
+    }
 }
 
 void ChunkReducer::reduce(ChunkReducer::RecordIter const begin, ChunkReducer::RecordIter const end) {
@@ -69,12 +76,12 @@ void ChunkReducer::reduce(ChunkReducer::RecordIter const begin, ChunkReducer::Re
             if (!_overlapChunkAppender.isOpen()) {
                 _overlapChunkAppender.open(_overlapChunkPath, false);
             }
-            _overlapChunkAppender.append(cur->data, cur->size);
+            _append(_overlapChunkAppender, *cur);
         } else {
             if (!_chunkAppender.isOpen()) {
                 _chunkAppender.open(_chunkPath, false);
             }
-            _chunkAppender.append(cur->data, cur->size);
+            _append(_chunkAppender, *cur);
         }
     }
 }
@@ -86,6 +93,32 @@ void ChunkReducer::finish() {
     _overlapChunkAppender.close();
 }
 
+void ChunkReducer::defineOptions(po::options_description& opts) {
+    opts.add_options()("out.format", po::value<std::string>()->default_value("csv"),
+                       "The format of chunk files. The default, csv, writes one line of "
+                       "text per record to files with a .txt extension. The rows format "
+                       "writes each record as a 4 byte little-endian length followed by "
+                       "the record text without a line terminator, to files with a .rows "
+                       "extension. The ingest services recognize .rows files, and load "
+                       "them without having to scan them for line boundaries.");
+}
+
+void ChunkReducer::_append(BufferedAppender& appender, Record<ChunkLocation> const& record) {
+    if (!_rows) {
+        appender.append(record.data, record.size);
+        return;
+    }
+    // Strip the line terminator written by csv::Editor::writeRecord().
+    uint32_t size = record.size;
+    if (size > 0 && record.data[size - 1] == '\n') {
+        --size;
+    }
+    uint8_t length[4];
+    encode(length, size);
+    appender.append(length, sizeof(length));
+    appender.append(record.data, size);
+}
+
 void ChunkReducer::_makeFilePaths(int32_t chunkId) {
     fs::path p = _outputDir;
     if (_numNodes > 1) {
@@ -97,9 +130,10 @@ void ChunkReducer::_makeFilePaths(int32_t chunkId) {
         fs::create_directory(p);
     }
     char suffix[32];
-    std::snprintf(suffix, sizeof(suffix), "_%ld.txt", static_cast<long>(chunkId));
+    char const* const ext = _rows ? "rows" : "txt";
+    std::snprintf(suffix, sizeof(suffix), "_%ld.%s", static_cast<long>(chunkId), ext);
     _chunkPath = p / (_prefix + suffix);
-    std::snprintf(suffix, sizeof(suffix), "_%ld_overlap.txt", static_cast<long>(chunkId));
+    std::snprintf(suffix, sizeof(suffix), "_%ld_overlap.%s", static_cast<long>(chunkId), ext);
     _overlapChunkPath = p / (_prefix + suffix);
 }
 
@@ -26,6 +26,7 @@
 #include <stdint.h>
 
 #include "boost/filesystem/path.hpp"
+#include "boost/program_options.hpp"
 #include "boost/shared_ptr.hpp"
 
 #include "Chunker.h"
@@ -48,6 +49,14 @@ namespace lsst::partition {
 /// files are created in node-specific sub-directories `node_XXXXX`, where
 /// `XXXXX` is just `hash(C) mod N` with leading zeros inserted as necessary.
 ///
+/// Chunk files are CSV files named `<prefix>_C.txt` and `<prefix>_C_overlap.txt`
+/// by default. With `--out.format=rows`, they are instead named
+/// `<prefix>_C.rows` and `<prefix>_C_overlap.rows`, and each record is
+/// stored as its text in the output CSV dialect, without a line terminator,
+/// preceded by the length of the text as a 4 byte little-endian integer.
+/// Such files can be ingested without scanning them for line terminators
+/// and escapes.
+///
 /// The worker result is a ChunkIndex that tracks per chunk/sub-chunk record
 /// counts.
 class ChunkReducer : public WorkerBase<ChunkLocation, ChunkIndex> {
@@ -59,12 +68,16 @@ public:
 
     boost::shared_ptr<ChunkIndex> const result() { return _index; }
 
+    static void defineOptions(boost::program_options::options_description& opts);
+
 private:
     void _makeFilePaths(int32_t chunkId);
+    void _append(BufferedAppender& appender, Record<ChunkLocation> const& record);
 
     boost::shared_ptr<ChunkIndex> _index;
     int32_t _chunkId;
     uint32_t _numNodes;
+    bool _rows;
     std::string _prefix;
     boost::filesystem::path _outputDir;
     boost::filesystem::path _chunkPath;
@@ -122,8 +122,11 @@ void defineInputOptions(po::options_description& opts) {
     input.add_options()("in.path,i", po::value<std::vector<std::string>>(),
                         "An input file or directory name. If the name identifies a "
                         "directory, then all the files and symbolic links to files in "
-                        "the directory are treated as inputs. This option must be "
-                        "specified at least once.");
+                        "the directory are treated as inputs. Files with a .parquet or "
+                        ".parq extension are read as Parquet files, where the columns "
+                        "named by --in.csv.field are read as the input CSV fields (if "
+                        "the tools were built with the Arrow and Parquet libraries). This "
+                        "option must be specified at least once.");
     opts.add(input);
 }
 
@@ -158,6 +161,10 @@ InputLines const makeInputLines(ConfigStore const& config) {
                 "No non-empty input files found among the "
                 "files and directories specified via --in.path.");
     }
+    if (config.has("in.csv.field")) {
+        return InputLines(paths, blockSize * MiB, false, csv::Dialect(config, "in.csv."),
+                          config.get<std::vector<std::string>>("in.csv.field"));
+    }
     return InputLines(paths, blockSize * MiB, false);
 }
 
@@ -353,6 +353,18 @@ void Dialect::_validate() {
 
 // -- Editor implementation ----
 
+namespace {
+
+std::string const specialChars(Dialect const &dialect, char c) {
+    std::string chars("\n\r", 2);
+    chars.push_back('\0');
+    chars.push_back(dialect.getEscape());
+    chars.push_back(c);
+    return chars;
+}
+
+}  // unnamed namespace
+
 Editor::Field::Field() : inputValue(0), outputValue(0), inputSize(0), outputSize(0), flags(0) {}
 
 Editor::Field::~Field() {
@@ -369,6 +381,8 @@ Editor::Editor(Dialect const &inputDialect, Dialect const &outputDialect,
         : _inputDialect(inputDialect),
           _outputDialect(outputDialect),
           _dialectsMatch(_inputDialect == _outputDialect),
+          _unquotedFinder(specialChars(_inputDialect, _inputDialect.getDelimiter())),
+          _quotedFinder(specialChars(_inputDialect, _inputDialect.getQuote())),
           _numInputFields(static_cast<int>(inputFieldNames.size())),
           _numOutputFields(static_cast<int>(outputFieldNames.size())),
           _fields(new Field[inputFieldNames.size() + outputFieldNames.size()]),
@@ -381,6 +395,8 @@ Editor::Editor(ConfigStore const &config)
         : _inputDialect(config, "in.csv."),
           _outputDialect(config, "out.csv."),
           _dialectsMatch(_inputDialect == _outputDialect),
+          _unquotedFinder(specialChars(_inputDialect, _inputDialect.getDelimiter())),
+          _quotedFinder(specialChars(_inputDialect, _inputDialect.getQuote())),
           _fields(),
           _outputs(),
           _fieldMap() {
@@ -419,6 +435,13 @@ char const *Editor::readRecord(char const *const begin, char const *const end) {
     f->inputValue = begin;
     char const *cur = begin;
     for (; cur < end; ++cur) {
+        if (!escaped) {
+            // Skip over characters that need no further processing.
+            cur = (quoted ? _quotedFinder : _unquotedFinder).find(cur, end);
+            if (cur == end) {
+                break;
+            }
+        }
         char const c = *cur;
         if (c == '\n' || c == '\r') {
             break;
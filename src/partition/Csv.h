@@ -40,6 +40,7 @@
 #include "boost/type_traits/is_same.hpp"
 #include "boost/unordered_map.hpp"
 
+#include "CharFinder.h"
 #include "Constants.h"
 
 namespace lsst::partition {
@@ -350,6 +351,10 @@ private:
     Dialect const _inputDialect;
     Dialect const _outputDialect;
     bool const _dialectsMatch;
+    // Finders for the characters readRecord() must look at outside
+    // of and inside of quoted input field values.
+    CharFinder const _unquotedFinder;
+    CharFinder const _quotedFinder;
     int _numInputFields;
     int _numOutputFields;
     int _numFields;
@@ -0,0 +1,139 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#include "partition/InputBlockQueue.h"
+
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+
+namespace lsst::partition {
+
+InputBlockQueue::InputBlockQueue(InputLines input, uint32_t numReaders, uint32_t numBuffers)
+        : _input(input), _numReading(numReaders), _stopped(false) {
+    if (numReaders < 1 || numBuffers < numReaders) {
+        throw std::runtime_error(
+                "An input block queue needs at least one reader, "
+                "and at least one buffer per reader");
+    }
+    _buffers.reserve(numBuffers);
+    for (uint32_t i = 0; i < numBuffers; ++i) {
+        boost::shared_ptr<char> buffer(static_cast<char *>(std::malloc(_input.getMinimumBufferCapacity())),
+                                       std::free);
+        if (!buffer) {
+            throw std::bad_alloc();
+        }
+        _buffers.push_back(buffer);
+    }
+    uint32_t i = 0;
+    try {
+        for (; i < numReaders; ++i) {
+            _readers.create_thread([this] { _read(); });
+        }
+    } catch (...) {
+        {
+            boost::lock_guard<boost::mutex> lock(_mutex);
+            _numReading -= numReaders - i;
+            _stopped = true;
+        }
+        _bufferCond.notify_all();
+        _readers.join_all();
+        throw;
+    }
+}
+
+InputBlockQueue::~InputBlockQueue() {
+    {
+        boost::lock_guard<boost::mutex> lock(_mutex);
+        _stopped = true;
+    }
+    _bufferCond.notify_all();
+    _readers.join_all();
+}
+
+bool InputBlockQueue::pop(Block &block) {
+    boost::unique_lock<boost::mutex> lock(_mutex);
+    while (_blocks.empty() && _numReading > 0 && _errorMessage.empty()) {
+        _blockCond.wait(lock);
+    }
+    if (!_errorMessage.empty()) {
+        throw std::runtime_error(_errorMessage);
+    }
+    if (_blocks.empty()) {
+        return false;
+    }
+    block = _blocks.front();
+    _blocks.pop_front();
+    return true;
+}
+
+void InputBlockQueue::release(Block &block) {
+    if (!block.buffer) {
+        return;
+    }
+    {
+        boost::lock_guard<boost::mutex> lock(_mutex);
+        _buffers.push_back(block.buffer);
+    }
+    block = Block();
+    _bufferCond.notify_one();
+}
+
+// Reader thread entry-point.
+void InputBlockQueue::_read() {
+    boost::unique_lock<boost::mutex> lock(_mutex);
+    try {
+        while (true) {
+            while (_buffers.empty() && !_stopped) {
+                _bufferCond.wait(lock);
+            }
+            if (_stopped) {
+                break;
+            }
+            Block block;
+            block.buffer = _buffers.back();
+            _buffers.pop_back();
+            lock.unlock();
+            std::pair<char *, char *> data = _input.read(block.buffer.get());
+            lock.lock();
+            if (data.first == 0 && data.second == 0) {
+                // No input left.
+                _buffers.push_back(block.buffer);
+                break;
+            }
+            block.begin = data.first;
+            block.end = data.second;
+            _blocks.push_back(block);
+            _blockCond.notify_one();
+        }
+    } catch (std::exception const &ex) {
+        if (!lock.owns_lock()) {
+            lock.lock();
+        }
+        if (_errorMessage.empty()) {
+            _errorMessage = ex.what();
+        }
+    }
+    --_numReading;
+    _blockCond.notify_all();
+}
+
+}  // namespace lsst::partition
@@ -0,0 +1,93 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_PARTITION_INPUTBLOCKQUEUE_H
+#define LSST_PARTITION_INPUTBLOCKQUEUE_H
+
+/// \file
+/// \brief A bounded queue of input blocks read ahead by dedicated threads.
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "boost/shared_ptr.hpp"
+#include "boost/thread.hpp"
+
+#include "partition/InputLines.h"
+
+namespace lsst::partition {
+
+/// The InputBlockQueue class decouples reading input from processing it. A
+/// set of reader threads calls InputLines::read() into buffers taken from a
+/// fixed size pool, and queues the blocks of lines for the consumers. A reader
+/// waits for a consumer to return a buffer when the pool is empty, so that at
+/// most the pool size blocks are held in memory, and reading stays ahead of the
+/// consumers by that many blocks - including while they do no reading at all,
+/// e.g. while map-reduce jobs sort and reduce their data.
+class InputBlockQueue {
+public:
+    /// A block of lines `[begin, end)` stored in `buffer`.
+    struct Block {
+        boost::shared_ptr<char> buffer;
+        char *begin;
+        char *end;
+
+        Block() : buffer(), begin(0), end(0) {}
+    };
+
+    /// Start `numReaders` threads reading `input` into `numBuffers` buffers.
+    InputBlockQueue(InputLines input, uint32_t numReaders, uint32_t numBuffers);
+
+    /// Stop and join the reader threads.
+    ~InputBlockQueue();
+
+    /// Wait for the next block. Returns false if and only if there is no more
+    /// input left. Throws if a reader has failed. The block buffer must be
+    /// given back with release() once the lines are no longer needed.
+    bool pop(Block &block);
+
+    /// Return the buffer of a block to the pool.
+    void release(Block &block);
+
+private:
+    InputBlockQueue(InputBlockQueue const &);
+    InputBlockQueue &operator=(InputBlockQueue const &);
+
+    void _read();
+
+    InputLines _input;
+    boost::thread_group _readers;
+
+    boost::mutex _mutex;
+    boost::condition_variable _blockCond;   // Signalled when a block is queued or reading ends.
+    boost::condition_variable _bufferCond;  // Signalled when a buffer is released or on stop.
+    std::vector<boost::shared_ptr<char> > _buffers;  // Free buffers.
+    std::deque<Block> _blocks;
+    uint32_t _numReading;
+    bool _stopped;
+    std::string _errorMessage;
+};
+
+}  // namespace lsst::partition
+
+#endif  // LSST_PARTITION_INPUTBLOCKQUEUE_H
@@ -30,7 +30,9 @@
 #include "boost/thread.hpp"
 
 #include "partition/Constants.h"
+#include "partition/Csv.h"
 #include "partition/FileUtils.h"
+#include "partition/ParquetFile.h"
 
 namespace fs = boost::filesystem;
 namespace this_thread = boost::this_thread;
@@ -82,7 +84,7 @@ struct LineFragment {
     }
 };
 
-// An input file block.
+// An input file block, or the rows of a Parquet row group not read yet.
 struct Block {
     boost::shared_ptr<InputFile> file;
     off_t offset;
@@ -90,7 +92,12 @@ struct Block {
     boost::shared_ptr<LineFragment> head;
     boost::shared_ptr<LineFragment> tail;
 
-    Block() : file(), offset(0), size(0), head(), tail() {}
+    boost::shared_ptr<ParquetFile const> parquet;
+    int rowGroup;
+    boost::shared_ptr<ParquetFile::RowGroup const> rows;  // Once decoded.
+    int64_t row;
+
+    Block() : file(), offset(0), size(0), head(), tail(), parquet(), rowGroup(0), rows(), row(0) {}
 
     CharPtrPair const read(char *buf, bool skipFirstLine);
 };
@@ -186,11 +193,23 @@ std::vector<Block> const split(fs::path const &path, off_t blockSize) {
     return blocks;
 }
 
+// Create a block per row group of a Parquet file.
+std::vector<Block> const split(boost::shared_ptr<ParquetFile const> const &file) {
+    std::vector<Block> blocks(file->getNumRowGroups());
+    for (int i = 0; i < file->getNumRowGroups(); ++i) {
+        blocks[i].parquet = file;
+        blocks[i].rowGroup = i;
+    }
+    return blocks;
+}
+
 }  // unnamed namespace
 
 class InputLines::Impl {
 public:
     Impl(std::vector<fs::path> const &paths, size_t blockSize, bool skipFirstLine);
+    Impl(std::vector<fs::path> const &paths, size_t blockSize, bool skipFirstLine,
+         csv::Dialect const &dialect, std::vector<std::string> const &fieldNames);
     ~Impl() {}
 
     size_t getBlockSize() const { return _blockSize; }
@@ -208,8 +227,15 @@ private:
     Impl(Impl const &);
     Impl &operator=(Impl const &);
 
+    std::vector<Block> const _split(fs::path const &path) const;
+    CharPtrPair const _read(Block &b, char *buf);
+
     size_t const _blockSize;
     bool const _skipFirstLine;
+    // The dialect and fields of the lines read from Parquet files,
+    // NULL if Parquet files are not supported.
+    boost::shared_ptr<csv::Dialect const> const _dialect;
+    std::vector<std::string> const _fieldNames;
 
     char _pad0[CACHE_LINE_SIZE];
 
@@ -224,11 +250,60 @@ private:
 InputLines::Impl::Impl(std::vector<fs::path> const &paths, size_t blockSize, bool skipFirstLine)
         : _blockSize(std::min(std::max(blockSize, 1 * MiB), 1 * GiB)),
           _skipFirstLine(skipFirstLine),
+          _dialect(),
+          _fieldNames(),
+          _mutex(),
+          _blockCount(paths.size()),
+          _queue(),
+          _paths(paths) {}
+
+InputLines::Impl::Impl(std::vector<fs::path> const &paths, size_t blockSize, bool skipFirstLine,
+                       csv::Dialect const &dialect, std::vector<std::string> const &fieldNames)
+        : _blockSize(std::min(std::max(blockSize, 1 * MiB), 1 * GiB)),
+          _skipFirstLine(skipFirstLine),
+          _dialect(boost::make_shared<csv::Dialect const>(dialect)),
+          _fieldNames(fieldNames),
           _mutex(),
           _blockCount(paths.size()),
           _queue(),
           _paths(paths) {}
 
+std::vector<Block> const InputLines::Impl::_split(fs::path const &path) const {
+    if (!ParquetFile::isParquet(path)) {
+        return split(path, static_cast<off_t>(_blockSize));
+    } else if (!_dialect) {
+        throw std::runtime_error("Parquet input file " + path.string() + " is not supported here.");
+    }
+    return split(boost::make_shared<ParquetFile const>(path, _fieldNames, *_dialect));
+}
+
+CharPtrPair const InputLines::Impl::_read(Block &b, char *buf) {
+    if (!b.parquet) {
+        return b.read(buf, _skipFirstLine);
+    }
+    char *end = 0;
+    try {
+        if (!b.rows) {
+            b.rows = b.parquet->readRowGroup(b.rowGroup);
+        }
+        end = b.rows->format(buf, buf + _blockSize + MAX_LINE_SIZE, b.row);
+    } catch (...) {
+        // Drop the block, so that other readers don't wait for it forever.
+        boost::lock_guard<boost::mutex> lock(_mutex);
+        --_blockCount;
+        throw;
+    }
+    // Parquet blocks are only accounted for once all their rows have been
+    // read. Give the remaining rows, if any, to the next reader.
+    boost::lock_guard<boost::mutex> lock(_mutex);
+    if (b.row < b.rows->getNumRows()) {
+        _queue.push_back(b);
+    } else {
+        --_blockCount;
+    }
+    return CharPtrPair(buf, end);
+}
+
 CharPtrPair const InputLines::Impl::read(char *buf) {
     boost::unique_lock<boost::mutex> lock(_mutex);
     while (_blockCount > 0) {
@@ -236,15 +311,24 @@ CharPtrPair const InputLines::Impl::read(char *buf) {
             // Pop the next block off the queue and read it.
             Block b = _queue.back();
             _queue.pop_back();
-            --_blockCount;
+            if (!b.parquet) {
+                --_blockCount;
+            }
             lock.unlock();  // allow block reads to proceed in parallel
-            return b.read(buf, _skipFirstLine);
+            return _read(b, buf);
         } else if (!_paths.empty()) {
             // The queue is empty - grab the next file and split it into blocks.
             fs::path path = _paths.back();
             _paths.pop_back();
             lock.unlock();  // allow parallel file opens and splits
-            std::vector<Block> v = split(path, static_cast<off_t>(_blockSize));
+            std::vector<Block> v;
+            try {
+                v = _split(path);
+            } catch (...) {
+                lock.lock();
+                --_blockCount;
+                throw;
+            }
             // The Impl constructor initially treats files as having a
             // single block. Consume one block, and account for any
             // additional blocks generated by the split operation.
@@ -259,9 +343,12 @@ CharPtrPair const InputLines::Impl::read(char *buf) {
             // the back of the queue will yield blocks with increasing file
             // offsets.
             _queue.insert(_queue.end(), v.rbegin(), v.rend() - 1);
-            _blockCount += v.size() - 1;
+            _blockCount += v.size();
+            if (!b.parquet) {
+                --_blockCount;
+            }
             lock.unlock();  // allow block reads to proceed in parallel
-            return b.read(buf, _skipFirstLine);
+            return _read(b, buf);
         } else {
             // The queue is empty and all input paths have been processed, but
             // the block count is non-zero. This means one or more threads are
@@ -282,6 +369,10 @@ CharPtrPair const InputLines::Impl::read(char *buf) {
 InputLines::InputLines(std::vector<fs::path> const &paths, size_t blockSize, bool skipFirstLine)
         : _impl(boost::make_shared<Impl>(paths, blockSize, skipFirstLine)) {}
 
+InputLines::InputLines(std::vector<fs::path> const &paths, size_t blockSize, bool skipFirstLine,
+                       csv::Dialect const &dialect, std::vector<std::string> const &fieldNames)
+        : _impl(boost::make_shared<Impl>(paths, blockSize, skipFirstLine, dialect, fieldNames)) {}
+
 size_t InputLines::getBlockSize() const { return _impl ? _impl->getBlockSize() : 0; }
 
 size_t InputLines::getMinimumBufferCapacity() const { return _impl ? _impl->getMinimumBufferCapacity() : 0; }
@@ -27,12 +27,17 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "boost/filesystem.hpp"
 #include "boost/shared_ptr.hpp"
 
+namespace lsst::partition::csv {
+class Dialect;
+}  // namespace lsst::partition::csv
+
 namespace lsst::partition {
 
 /// The InputLines class reads lines from a list of input text files in an IO
@@ -59,6 +64,10 @@ namespace lsst::partition {
 ///
 /// Finally, as far as this class is concerned, a line is a sequence of no more
 /// than MAX_LINE_SIZE bytes ending with LF, CR or CRLF.
+///
+/// Parquet files (see ParquetFile) can be read as lines of CSV text as well.
+/// Each of their row groups is decoded by a single thread, and then returned
+/// in as many pieces as needed to fit into read() buffers.
 class InputLines {
 public:
     /// Corresponds to no input. Useless unless assigned to.
@@ -70,6 +79,13 @@ public:
     /// Note that `blockSize` is clamped to lie between 1MiB and 1GiB.
     InputLines(std::vector<boost::filesystem::path> const &paths, size_t blockSize, bool skipFirstLine);
 
+    /// Read lines from a list of files as above, except for Parquet files,
+    /// which are read as lines of CSV text in the given dialect made of the
+    /// columns named by `fieldNames`. The first line of a Parquet file is
+    /// never skipped.
+    InputLines(std::vector<boost::filesystem::path> const &paths, size_t blockSize, bool skipFirstLine,
+               csv::Dialect const &dialect, std::vector<std::string> const &fieldNames);
+
     ~InputLines() {}
 
     /// Return the IO read block size in bytes.
@@ -39,12 +39,14 @@
 #include "boost/program_options.hpp"
 #include "boost/ref.hpp"
 #include "boost/scoped_array.hpp"
+#include "boost/scoped_ptr.hpp"
 #include "boost/shared_ptr.hpp"
 #include "boost/thread.hpp"
 
 #include "partition/ConfigStore.h"
 #include "partition/Constants.h"
 #include "partition/Csv.h"
+#include "partition/InputBlockQueue.h"
 #include "partition/InputLines.h"
 
 namespace lsst::partition {
@@ -364,8 +366,11 @@ private:
     ConfigStore const *_config;
 
     InputLines _input;
+    boost::scoped_ptr<InputBlockQueue> _queue;
     size_t _threshold;
     uint32_t _numWorkers;
+    uint32_t _numReaders;
+    uint32_t _readAhead;
 
     char _pad0[CACHE_LINE_SIZE];
 
@@ -392,6 +397,8 @@ JobBase<DerivedT, WorkerT>::JobBase(ConfigStore const &config)
         : _config(&config),
           _threshold(0),
           _numWorkers(config.get<uint32_t>("mr.num-workers")),
+          _numReaders(config.get<uint32_t>("mr.num-readers")),
+          _readAhead(config.get<uint32_t>("mr.read-ahead")),
           _inputExhausted(false),
           _numMappers(0),
           _numReducers(0),
@@ -401,6 +408,11 @@ JobBase<DerivedT, WorkerT>::JobBase(ConfigStore const &config)
                 "The number of worker threads given by "
                 "--mr.num-workers must be at least 1");
     }
+    if (_numReaders > 0 && _readAhead < _numReaders) {
+        throw std::runtime_error(
+                "The number of blocks read ahead given by --mr.read-ahead "
+                "must be at least the number of reader threads");
+    }
     size_t poolSize = config.get<size_t>("mr.pool-size");
     _threshold = (poolSize * MiB) / _numWorkers;
 }
@@ -410,6 +422,7 @@ JobBase<DerivedT, WorkerT>::~JobBase() {}
 
 template <typename DerivedT, typename WorkerT>
 void JobBase<DerivedT, WorkerT>::_cleanup() {
+    _queue.reset();
     _input = InputLines();
     _inputExhausted = false;
     _numMappers = 0;
@@ -436,6 +449,11 @@ void JobBase<DerivedT, WorkerT>::_fail(std::exception const &ex) {
 
 template <typename DerivedT, typename WorkerT>
 void JobBase<DerivedT, WorkerT>::run(InputLines input) {
+    if (_numReaders > 0) {
+        // Each mapping thread holds on to at most one block while the
+        // readers fill the remaining buffers.
+        _queue.reset(new InputBlockQueue(input, _numReaders, _readAhead + _numWorkers));
+    }
     boost::scoped_array<boost::thread> threads(new boost::thread[_numWorkers - 1]);
     std::vector<SiloPtr> silos;
     silos.reserve(_numWorkers);
@@ -487,6 +505,13 @@ void JobBase<DerivedT, WorkerT>::defineOptions(boost::program_options::options_d
                      "The IO block size in MiB. Must be between 1 and 1024.");
     mr.add_options()("mr.num-workers", po::value<uint32_t>()->default_value(1),
                      "The number of worker threads to use - must be at least 1.");
+    mr.add_options()("mr.num-readers", po::value<uint32_t>()->default_value(1),
+                     "The number of threads reading input ahead of the worker threads. "
+                     "Reading then overlaps with mapping, sorting and reducing. If 0, "
+                     "worker threads read the input themselves as they map it.");
+    mr.add_options()("mr.read-ahead", po::value<uint32_t>()->default_value(8),
+                     "The number of IO blocks the reader threads may read ahead of "
+                     "the worker threads - must be at least --mr.num-readers.");
     mr.add_options()("mr.pool-size", po::value<size_t>()->default_value(1024),
                      "Map-reduce memory pool size in MiB. This determines how much "
                      "data will be accumulated in memory prior to data reduction / "
@@ -496,19 +521,23 @@ void JobBase<DerivedT, WorkerT>::defineOptions(boost::program_options::options_d
     WorkerT::defineOptions(opts);
 }
 
-// This implementation could be improved by decoupling disk reads from
-// mapping with a water-marked input block queue. This would allow the
-// number of reading threads to be kept at whatever number maximizes read
-// bandwidth, while allowing the number of processing threads to be scaled
-// such that blocks are processed at the same rate as they are read.
+// Unless --mr.num-readers is 0, disk reads are decoupled from mapping by
+// an input block queue. This allows the number of reading threads to be
+// kept at whatever number maximizes read bandwidth, while the number of
+// processing threads is scaled such that blocks are processed at the same
+// rate as they are read. Reading also continues while the workers sort
+// and reduce, until --mr.read-ahead blocks are waiting to be mapped.
 template <typename DerivedT, typename WorkerT>
 void JobBase<DerivedT, WorkerT>::_work() {
-    // Pre-allocate disk read buffer.
-    boost::shared_ptr<char> buffer(static_cast<char *>(std::malloc(_input.getMinimumBufferCapacity())),
-                                   std::free);
-    if (!buffer) {
-        throw std::bad_alloc();
+    // Pre-allocate disk read buffer, unless blocks come from the queue.
+    boost::shared_ptr<char> buffer;
+    if (!_queue) {
+        buffer.reset(static_cast<char *>(std::malloc(_input.getMinimumBufferCapacity())), std::free);
+        if (!buffer) {
+            throw std::bad_alloc();
+        }
     }
+    InputBlockQueue::Block block;
     // Pre-allocate space for sorted record ranges.
     std::vector<SortedRecordRange> ranges;
     ranges.reserve(_numWorkers);
@@ -542,7 +571,12 @@ void JobBase<DerivedT, WorkerT>::_work() {
             SiloPtr silo = _silos.back();
             _silos.pop_back();
             lock.unlock();
-            std::pair<char *, char *> data = _input.read(buffer.get());
+            std::pair<char *, char *> data(0, 0);
+            if (!_queue) {
+                data = _input.read(buffer.get());
+            } else if (_queue->pop(block)) {
+                data = std::make_pair(block.begin, block.end);
+            }
             if (data.first == 0 && data.second == 0) {
                 // No input left.
                 silo->sort();
@@ -552,6 +586,9 @@ void JobBase<DerivedT, WorkerT>::_work() {
                 continue;
             }
             worker.map(data.first, data.second, *silo);
+            if (_queue) {
+                _queue->release(block);
+            }
             if (silo->getBytesUsed() > _threshold) {
                 // silo memory usage has exceeded the threshold.
                 silo->sort();
@@ -0,0 +1,229 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#include "partition/ParquetFile.h"
+
+#include <charconv>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+#include "arrow/api.h"
+#include "boost/make_shared.hpp"
+#include "parquet/arrow/reader.h"
+#include "parquet/arrow/schema.h"
+
+#include "partition/Constants.h"
+
+namespace fs = boost::filesystem;
+
+namespace lsst::partition {
+
+namespace {
+
+// The longest text of a non-string field value, and of a field value
+// followed by a delimiter or line terminator.
+size_t const MAX_NUMBER_SIZE = 32;
+size_t const MAX_VALUE_SIZE = (MAX_FIELD_SIZE > MAX_NUMBER_SIZE ? MAX_FIELD_SIZE : MAX_NUMBER_SIZE) + 1;
+
+void check(arrow::Status const &status, fs::path const &path) {
+    if (!status.ok()) {
+        throw std::runtime_error("Failed to read Parquet file " + path.string() + ": " + status.ToString());
+    }
+}
+
+template <typename T>
+T check(arrow::Result<T> result, fs::path const &path) {
+    check(result.status(), path);
+    return result.MoveValueUnsafe();
+}
+
+std::unique_ptr<parquet::arrow::FileReader> openFile(fs::path const &path) {
+    parquet::arrow::FileReaderBuilder builder;
+    check(builder.OpenFile(path.string()), path);
+    std::unique_ptr<parquet::arrow::FileReader> reader;
+    check(builder.Build(&reader), path);
+    return reader;
+}
+
+bool isSupported(arrow::Type::type id) {
+    switch (id) {
+        case arrow::Type::BOOL:
+        case arrow::Type::INT8:
+        case arrow::Type::INT16:
+        case arrow::Type::INT32:
+        case arrow::Type::INT64:
+        case arrow::Type::UINT8:
+        case arrow::Type::UINT16:
+        case arrow::Type::UINT32:
+        case arrow::Type::UINT64:
+        case arrow::Type::FLOAT:
+        case arrow::Type::DOUBLE:
+        case arrow::Type::STRING:
+        case arrow::Type::LARGE_STRING:
+            return true;
+        default:
+            return false;
+    }
+}
+
+template <typename ArrayT>
+char *formatInteger(arrow::Array const &array, int64_t row, char *cur, char *end) {
+    return std::to_chars(cur, end, static_cast<ArrayT const &>(array).Value(row)).ptr;
+}
+
+template <typename ArrayT>
+char *formatString(arrow::Array const &array, int64_t row, char *cur, csv::Dialect const &dialect) {
+    std::string_view const value = static_cast<ArrayT const &>(array).GetView(row);
+    return cur + dialect.encode(cur, value.data(), value.size());
+}
+
+// Write the text of a non-NULL value to `cur`, which has room
+// for at least MAX_VALUE_SIZE characters before `end`.
+char *formatValue(arrow::Array const &array, int64_t row, char *cur, char *end,
+                  csv::Dialect const &dialect) {
+    switch (array.type_id()) {
+        case arrow::Type::BOOL:
+            *cur = static_cast<arrow::BooleanArray const &>(array).Value(row) ? '1' : '0';
+            return cur + 1;
+        case arrow::Type::INT8:
+            return formatInteger<arrow::Int8Array>(array, row, cur, end);
+        case arrow::Type::INT16:
+            return formatInteger<arrow::Int16Array>(array, row, cur, end);
+        case arrow::Type::INT32:
+            return formatInteger<arrow::Int32Array>(array, row, cur, end);
+        case arrow::Type::INT64:
+            return formatInteger<arrow::Int64Array>(array, row, cur, end);
+        case arrow::Type::UINT8:
+            return formatInteger<arrow::UInt8Array>(array, row, cur, end);
+        case arrow::Type::UINT16:
+            return formatInteger<arrow::UInt16Array>(array, row, cur, end);
+        case arrow::Type::UINT32:
+            return formatInteger<arrow::UInt32Array>(array, row, cur, end);
+        case arrow::Type::UINT64:
+            return formatInteger<arrow::UInt64Array>(array, row, cur, end);
+        case arrow::Type::FLOAT:
+            // The shortest text which converts back to the same value.
+            return std::to_chars(cur, end, static_cast<arrow::FloatArray const &>(array).Value(row)).ptr;
+        case arrow::Type::DOUBLE:
+            return std::to_chars(cur, end, static_cast<arrow::DoubleArray const &>(array).Value(row)).ptr;
+        case arrow::Type::STRING:
+            return formatString<arrow::StringArray>(array, row, cur, dialect);
+        case arrow::Type::LARGE_STRING:
+            return formatString<arrow::LargeStringArray>(array, row, cur, dialect);
+        default:
+            throw std::logic_error("Unsupported Parquet column type.");
+    }
+}
+
+}  // unnamed namespace
+
+// -- RowGroup implementation ----
+
+class ParquetFile::RowGroup::Impl {
+public:
+    Impl(csv::Dialect const &dialect, int64_t numRows) : dialect(dialect), numRows(numRows) {}
+
+    csv::Dialect const dialect;
+    int64_t const numRows;
+    std::shared_ptr<arrow::Table> table;
+    std::vector<std::shared_ptr<arrow::Array>> columns;
+};
+
+int64_t ParquetFile::RowGroup::getNumRows() const { return _impl->numRows; }
+
+char *ParquetFile::RowGroup::format(char *buf, char *end, int64_t &row) const {
+    csv::Dialect const &dialect = _impl->dialect;
+    std::string const &null = dialect.getNull();
+    char const delimiter = dialect.getDelimiter();
+    size_t const numColumns = _impl->columns.size();
+    char *cur = buf;
+    for (; row < _impl->numRows && end - cur >= MAX_LINE_SIZE; ++row) {
+        char *const lineEnd = cur + MAX_LINE_SIZE;
+        for (size_t c = 0; c < numColumns; ++c) {
+            if (lineEnd - cur < static_cast<ptrdiff_t>(MAX_VALUE_SIZE)) {
+                throw std::runtime_error("Line too long.");
+            }
+            if (c > 0) {
+                *cur++ = delimiter;
+            }
+            arrow::Array const &array = *_impl->columns[c];
+            if (array.IsNull(row)) {
+                std::memcpy(cur, null.data(), null.size());
+                cur += null.size();
+            } else {
+                cur = formatValue(array, row, cur, lineEnd, dialect);
+            }
+        }
+        *cur++ = '\n';
+    }
+    return cur;
+}
+
+// -- ParquetFile implementation ----
+
+ParquetFile::ParquetFile(fs::path const &path, std::vector<std::string> const &fieldNames,
+                         csv::Dialect const &dialect)
+        : _path(path), _fieldNames(fieldNames), _columns(), _dialect(dialect), _numRowGroups(0) {
+    std::unique_ptr<parquet::arrow::FileReader> reader = openFile(path);
+    std::shared_ptr<arrow::Schema> schema;
+    check(reader->GetSchema(&schema), path);
+    for (std::vector<std::string>::const_iterator i = fieldNames.begin(), e = fieldNames.end(); i != e; ++i) {
+        int const f = schema->GetFieldIndex(*i);
+        if (f < 0) {
+            throw std::runtime_error("Parquet file " + path.string() + " has no column (or more than one) named " +
+                                     *i + ".");
+        }
+        std::shared_ptr<arrow::DataType> const type = schema->field(f)->type();
+        if (!isSupported(type->id())) {
+            throw std::runtime_error("Parquet file " + path.string() + " column " + *i +
+                                     " has unsupported type " + type->ToString() + ".");
+        }
+        _columns.push_back(reader->manifest().schema_fields[f].column_index);
+    }
+    _numRowGroups = reader->num_row_groups();
+}
+
+ParquetFile::~ParquetFile() {}
+
+boost::shared_ptr<ParquetFile::RowGroup const> const ParquetFile::readRowGroup(int i) const {
+    // Each call uses its own reader, so that row groups can be decoded in parallel.
+    std::unique_ptr<parquet::arrow::FileReader> reader = openFile(_path);
+    std::shared_ptr<arrow::Table> table;
+    check(reader->ReadRowGroup(i, _columns, &table), _path);
+    table = check(table->CombineChunks(), _path);
+    boost::shared_ptr<RowGroup::Impl> impl = boost::make_shared<RowGroup::Impl>(_dialect, table->num_rows());
+    impl->table = table;
+    if (table->num_rows() > 0) {
+        for (std::vector<std::string>::const_iterator n = _fieldNames.begin(), e = _fieldNames.end(); n != e;
+             ++n) {
+            impl->columns.push_back(table->GetColumnByName(*n)->chunk(0));
+        }
+    }
+    return boost::make_shared<RowGroup const>(impl);
+}
+
+bool ParquetFile::isParquet(fs::path const &path) {
+    std::string const ext = path.extension().string();
+    return ext == ".parquet" || ext == ".parq";
+}
+
+}  // namespace lsst::partition
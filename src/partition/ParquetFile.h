@@ -0,0 +1,106 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_PARTITION_PARQUETFILE_H
+#define LSST_PARTITION_PARQUETFILE_H
+
+/// \file
+/// \brief A class for reading the columns of a Parquet file as lines of CSV text.
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "boost/filesystem.hpp"
+#include "boost/shared_ptr.hpp"
+
+#include "partition/Csv.h"
+
+namespace lsst::partition {
+
+/// The ParquetFile class decodes the columns of a Parquet file that have
+/// the names of the CSV input fields, and formats them as lines of text in
+/// the input CSV dialect. This allows Parquet catalogs to be fed to the same
+/// map-reduce workers as CSV files, and to produce the same output. Columns
+/// not named as input fields are never decoded.
+///
+/// Floating point values are written with the fewest digits that convert
+/// back to the same value, so that workers see exactly the values stored in
+/// the Parquet file. Boolean values are written as 0 or 1, and Parquet NULLs
+/// as the NULL string of the dialect.
+///
+/// Row groups are the unit of parallelism: readRowGroup() may be called
+/// from several threads at once, and the lines of a decoded row group can
+/// be formatted in as many pieces as needed to fit into IO buffers.
+class ParquetFile {
+public:
+    class RowGroup;
+
+    /// Open a Parquet file, and check that it has a column of a supported
+    /// type for each of the given field names.
+    ParquetFile(boost::filesystem::path const &path, std::vector<std::string> const &fieldNames,
+                csv::Dialect const &dialect);
+
+    ~ParquetFile();
+
+    boost::filesystem::path const &getPath() const { return _path; }
+    int getNumRowGroups() const { return _numRowGroups; }
+
+    /// Decode the input field columns of row group `i`.
+    boost::shared_ptr<RowGroup const> const readRowGroup(int i) const;
+
+    /// Does the path name a Parquet file, i.e. does it end with ".parquet"
+    /// or ".parq"?
+    static bool isParquet(boost::filesystem::path const &path);
+
+private:
+    ParquetFile(ParquetFile const &);
+    ParquetFile &operator=(ParquetFile const &);
+
+    boost::filesystem::path _path;
+    std::vector<std::string> _fieldNames;
+    std::vector<int> _columns;  // Parquet column index of each field.
+    csv::Dialect _dialect;
+    int _numRowGroups;
+};
+
+/// The decoded input field columns of a Parquet row group.
+class ParquetFile::RowGroup {
+public:
+    class Impl;
+
+    RowGroup(boost::shared_ptr<Impl> const &impl) : _impl(impl) {}
+
+    int64_t getNumRows() const;
+
+    /// Write lines for the rows starting at `row` to the buffer starting at
+    /// `buf`, for as long as at least MAX_LINE_SIZE bytes remain before `end`.
+    /// Return a pointer to the character following the last one written, and
+    /// set `row` to the first row not written.
+    char *format(char *buf, char *end, int64_t &row) const;
+
+private:
+    boost::shared_ptr<Impl> _impl;
+};
+
+}  // namespace lsst::partition
+
+#endif  // LSST_PARTITION_PARQUETFILE_H
@@ -0,0 +1,60 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief The ParquetFile class of a build without the Arrow and Parquet
+///        libraries, which rejects Parquet input files.
+
+#include "partition/ParquetFile.h"
+
+#include <stdexcept>
+
+namespace fs = boost::filesystem;
+
+namespace lsst::partition {
+
+int64_t ParquetFile::RowGroup::getNumRows() const {
+    throw std::logic_error("Parquet files are not supported.");
+}
+
+char *ParquetFile::RowGroup::format(char *, char *, int64_t &) const {
+    throw std::logic_error("Parquet files are not supported.");
+}
+
+ParquetFile::ParquetFile(fs::path const &path, std::vector<std::string> const &fieldNames,
+                         csv::Dialect const &dialect)
+        : _path(path), _fieldNames(fieldNames), _columns(), _dialect(dialect), _numRowGroups(0) {
+    throw std::runtime_error("Parquet input file " + path.string() +
+                             " can't be read, the Arrow and Parquet libraries were not found at build time.");
+}
+
+ParquetFile::~ParquetFile() {}
+
+boost::shared_ptr<ParquetFile::RowGroup const> const ParquetFile::readRowGroup(int) const {
+    throw std::logic_error("Parquet files are not supported.");
+}
+
+bool ParquetFile::isParquet(fs::path const &path) {
+    std::string const ext = path.extension().string();
+    return ext == ".parquet" || ext == ".parq";
+}
+
+}  // namespace lsst::partition
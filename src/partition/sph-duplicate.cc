@@ -518,6 +518,7 @@ void Worker::defineOptions(po::options_description& opts) {
                        "The partitioning longitude and latitude angle field names, "
                        "separated by a comma.");
     Chunker::defineOptions(part);
+    ChunkReducer::defineOptions(part);
     opts.add(dup).add(part);
     defineOutputOptions(opts);
     csv::Editor::defineOptions(opts);
@@ -186,6 +186,7 @@ void Worker::defineOptions(po::options_description& opts) {
                        "It's meant to run the tool in the 'dry run' mode, validating input files, "
                        "generating the objectId-to-chunk/sub-chunk index map.");
     Chunker::defineOptions(part);
+    ChunkReducer::defineOptions(part);
     opts.add(part);
     defineOutputOptions(opts);
     csv::Editor::defineOptions(opts);
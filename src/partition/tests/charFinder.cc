@@ -0,0 +1,103 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#include <stdlib.h>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#define BOOST_TEST_MODULE CharFinder
+#include "boost/test/unit_test.hpp"
+
+#include "partition/CharFinder.h"
+
+using std::string;
+
+using lsst::partition::csv::CharFinder;
+
+namespace {
+
+CharFinder::Impl const IMPLS[3] = {CharFinder::SCALAR, CharFinder::SSE42, CharFinder::AVX2};
+
+}  // unnamed namespace
+
+BOOST_AUTO_TEST_CASE(CharFinderSetTest) {
+    BOOST_CHECK_THROW(CharFinder("abcdefghi", CharFinder::SCALAR), std::runtime_error);
+    BOOST_CHECK_NO_THROW(CharFinder("abcdefgha", CharFinder::SCALAR));
+    BOOST_CHECK(CharFinder::isSupported(CharFinder::SCALAR));
+    BOOST_CHECK(CharFinder::isSupported(CharFinder::getDefaultImpl()));
+    for (int i = 0; i < 3; ++i) {
+        if (!CharFinder::isSupported(IMPLS[i])) {
+            BOOST_CHECK_THROW(CharFinder("a", IMPLS[i]), std::runtime_error);
+            continue;
+        }
+        string const s("0123456789abcdefghijklmnopqrstuvwxyz0123456789", 46);
+        char const *b = s.data();
+        char const *e = b + s.size();
+        BOOST_CHECK(CharFinder("", IMPLS[i]).find(b, e) == e);
+        BOOST_CHECK(CharFinder("!", IMPLS[i]).find(b, e) == e);
+        BOOST_CHECK(CharFinder("9", IMPLS[i]).find(b, e) == b + 9);
+        BOOST_CHECK(CharFinder("z", IMPLS[i]).find(b, e) == b + 35);
+        BOOST_CHECK(CharFinder("9z", IMPLS[i]).find(b + 10, e) == b + 35);
+        BOOST_CHECK(CharFinder("9z", IMPLS[i]).find(b + 36, e) == b + 45);
+        string n("ab", 2);
+        n.push_back('\0');
+        string t(40, 'x');
+        t[37] = '\0';
+        BOOST_CHECK(CharFinder(n, IMPLS[i]).find(t.data(), t.data() + t.size()) == t.data() + 37);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(CharFinderRandomTest) {
+    // Compare every implementation to std::find_first_of for random sets
+    // of characters, text, alignments and lengths.
+    unsigned int seed = 7;
+    std::vector<char> text(256);
+    for (int trial = 0; trial < 200; ++trial) {
+        string chars;
+        int const numChars = rand_r(&seed) % (CharFinder::MAX_CHARS + 1);
+        for (int i = 0; i < numChars; ++i) {
+            chars.push_back(static_cast<char>(rand_r(&seed) % 256));
+        }
+        // Make matches rare enough for the vectorized loops to run.
+        for (size_t i = 0; i < text.size(); ++i) {
+            text[i] = rand_r(&seed) % 64 == 0 && numChars > 0 ? chars[rand_r(&seed) % numChars]
+                                                               : static_cast<char>(rand_r(&seed) % 256);
+        }
+        for (int i = 0; i < 3; ++i) {
+            if (!CharFinder::isSupported(IMPLS[i])) {
+                continue;
+            }
+            CharFinder const finder(chars, IMPLS[i]);
+            bool ok = true;
+            for (size_t b = 0; b < 40; ++b) {
+                for (size_t e = b; e <= text.size(); e += 1 + e % 7) {
+                    char const *begin = &text[0] + b;
+                    char const *end = &text[0] + e;
+                    char const *expected = std::find_first_of(begin, end, chars.begin(), chars.end());
+                    ok = ok && finder.find(begin, end) == expected;
+                }
+            }
+            BOOST_CHECK(ok);
+        }
+    }
+}
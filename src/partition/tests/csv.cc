@@ -20,6 +20,8 @@
  * see <http://www.lsstcorp.org/LegalNotices/>.
  */
 
+#include <ctype.h>
+#include <stdlib.h>
 #include <stdexcept>
 #include <string>
 
@@ -32,6 +34,7 @@ using std::runtime_error;
 using std::string;
 using std::vector;
 
+using lsst::partition::csv::CharFinder;
 using lsst::partition::csv::Dialect;
 using lsst::partition::csv::Editor;
 
@@ -200,3 +203,83 @@ BOOST_AUTO_TEST_CASE(EditorTranscodeTest) {
     *be = '\0';
     BOOST_CHECK_EQUAL(string("nil,a,nil,5\n"), buf);
 }
+
+namespace {
+
+// Parse a line and describe the outcome: the fields read or the error.
+string parse(Editor& ed, string const& line) {
+    string r;
+    try {
+        char const* e = ed.readRecord(line.data(), line.data() + line.size());
+        r = std::to_string(e - line.data());
+        for (int i = 0; i < ed.getNumInputFields(); ++i) {
+            r += "|" + ed.get(i, false);
+        }
+    } catch (runtime_error const& ex) {
+        r = ex.what();
+    }
+    return r;
+}
+
+}  // unnamed namespace
+
+BOOST_AUTO_TEST_CASE(EditorCharFinderTest) {
+    // Records must be parsed the same way by every character
+    // search implementation, including malformed ones.
+    Dialect const dialects[3] = {Dialect('|', '\\', '"'), Dialect(',', '\0', '\''),
+                                 Dialect('\t', '\\', '\0')};
+    CharFinder::Impl const impls[3] = {CharFinder::SCALAR, CharFinder::SSE42, CharFinder::AVX2};
+    CharFinder::Impl const defaultImpl = CharFinder::getDefaultImpl();
+    vector<string> names;
+    names.push_back("a");
+    names.push_back("b");
+    names.push_back("c");
+    unsigned int seed = 13;
+    for (int d = 0; d < 3; ++d) {
+        string alphabet("yN\n\r\"\'\\,|\t", 10);
+        alphabet.push_back('\0');
+        vector<string> lines;
+        for (int i = 0; i < 2000; ++i) {
+            string line;
+            for (int f = 0; f < 3; ++f) {
+                if (f > 0) {
+                    line.push_back(dialects[d].getDelimiter());
+                }
+                if (rand_r(&seed) % 4 == 0) {
+                    line.push_back(dialects[d].getQuote());
+                }
+                // Mostly plain characters, so that field values are long.
+                int const n = rand_r(&seed) % 50;
+                for (int j = 0; j < n; ++j) {
+                    line.push_back(rand_r(&seed) % 16 != 0 ? 'x' : alphabet[rand_r(&seed) % alphabet.size()]);
+                }
+            }
+            if (rand_r(&seed) % 2 == 0) {
+                line += "\n" + string(rand_r(&seed) % 64, 'x');
+            }
+            lines.push_back(line);
+        }
+        vector<string> expected;
+        CharFinder::setDefaultImpl(CharFinder::SCALAR);
+        Editor scalar(dialects[d], dialects[d], names, names);
+        size_t numParsed = 0;
+        for (size_t i = 0; i < lines.size(); ++i) {
+            expected.push_back(parse(scalar, lines[i]));
+            numParsed += isdigit(expected.back()[0]) ? 1 : 0;
+        }
+        BOOST_CHECK(numParsed > lines.size() / 10);
+        for (int k = 1; k < 3; ++k) {
+            if (!CharFinder::isSupported(impls[k])) {
+                continue;
+            }
+            CharFinder::setDefaultImpl(impls[k]);
+            Editor ed(dialects[d], dialects[d], names, names);
+            size_t numMismatches = 0;
+            for (size_t i = 0; i < lines.size(); ++i) {
+                numMismatches += parse(ed, lines[i]) != expected[i];
+            }
+            BOOST_CHECK_EQUAL(numMismatches, 0u);
+        }
+    }
+    CharFinder::setDefaultImpl(defaultImpl);
+}
@@ -0,0 +1,101 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief Measures how fast csv::Editor::readRecord() parses synthetic
+///        records with each supported character search implementation.
+///        This is not a unit test, run it as:
+///
+///     csvBench [<input size in MiB> [<number of fields>]]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "partition/CharFinder.h"
+#include "partition/Constants.h"
+#include "partition/Csv.h"
+
+using std::string;
+using std::vector;
+
+using lsst::partition::MiB;
+using lsst::partition::csv::CharFinder;
+using lsst::partition::csv::Dialect;
+using lsst::partition::csv::Editor;
+
+int main(int argc, char const *const *argv) {
+    size_t const sizeMiB = argc > 1 ? strtoul(argv[1], 0, 10) : 256;
+    int const numFields = argc > 2 ? atoi(argv[2]) : 20;
+    char const *const implNames[3] = {"scalar", "sse4.2", "avx2"};
+    CharFinder::Impl const impls[3] = {CharFinder::SCALAR, CharFinder::SSE42, CharFinder::AVX2};
+    // Build tab separated records of numbers and short strings, some of them
+    // quoted, resembling a typical catalog table.
+    Dialect const dialect('\t', '\\', '"');
+    vector<string> names;
+    for (int i = 0; i < numFields; ++i) {
+        names.push_back("f" + std::to_string(i));
+    }
+    string text;
+    text.reserve(sizeMiB * MiB + MAX_LINE_SIZE);
+    unsigned int seed = 1;
+    char buf[64];
+    while (text.size() < sizeMiB * MiB) {
+        for (int i = 0; i < numFields; ++i) {
+            if (i > 0) {
+                text.push_back('\t');
+            }
+            switch (i % 4) {
+                case 0:
+                    snprintf(buf, sizeof(buf), "%d", rand_r(&seed));
+                    break;
+                case 1:
+                    snprintf(buf, sizeof(buf), "\"name %d\"", rand_r(&seed) % 1000);
+                    break;
+                default:
+                    snprintf(buf, sizeof(buf), "%.12g", rand_r(&seed) / 3.0);
+                    break;
+            }
+            text += buf;
+        }
+        text.push_back('\n');
+    }
+    std::cout << "impl          MiB/s" << std::endl;
+    for (int k = 0; k < 3; ++k) {
+        if (!CharFinder::isSupported(impls[k])) {
+            continue;
+        }
+        CharFinder::setDefaultImpl(impls[k]);
+        Editor ed(dialect, dialect, names, names);
+        char const *cur = text.data();
+        char const *const end = cur + text.size();
+        auto const start = std::chrono::steady_clock::now();
+        while (cur < end) {
+            cur = ed.readRecord(cur, end);
+        }
+        std::chrono::duration<double> const secs = std::chrono::steady_clock::now() - start;
+        printf("%-8s %10.1f\n", implNames[k], text.size() / (secs.count() * MiB));
+    }
+    return EXIT_SUCCESS;
+}
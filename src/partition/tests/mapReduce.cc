@@ -167,11 +167,12 @@ typedef Job<Worker> TestJob;
 }  // unnamed namespace
 
 BOOST_AUTO_TEST_CASE(MapReduceTest) {
-    char const *argv[4] = {
+    char const *argv[5] = {
             "dummy",
             "--in.csv.field=line",
             "--mr.pool-size=8",
             0,
+            0,
     };
     TempFile t1, t2;
     buildInput(t1, t2);
@@ -181,18 +182,24 @@ BOOST_AUTO_TEST_CASE(MapReduceTest) {
     po::options_description options;
     TestJob::defineOptions(options);
     for (char n = '1'; n < '8'; ++n) {
-        string s("--mr.num-workers=");
-        s += n;
-        argv[3] = s.c_str();
-        po::variables_map vm;
-        // Older boost versions (1.41) require the const_cast.
-        po::store(po::parse_command_line(4, const_cast<char **>(argv), options), vm);
-        po::notify(vm);
-        ConfigStore config;
-        config.add(vm);
-        TestJob job(config);
-        InputLines input(paths, 1 * MiB, false);
-        shared_ptr<Lines> lines = job.run(input);
-        lines->verify();
+        // Read input in the worker threads, and with 1 and 3 reader threads.
+        for (char r = '0'; r < '4'; r += 1 + (r == '1')) {
+            string s("--mr.num-workers=");
+            s += n;
+            argv[3] = s.c_str();
+            string t("--mr.num-readers=");
+            t += r;
+            argv[4] = t.c_str();
+            po::variables_map vm;
+            // Older boost versions (1.41) require the const_cast.
+            po::store(po::parse_command_line(5, const_cast<char **>(argv), options), vm);
+            po::notify(vm);
+            ConfigStore config;
+            config.add(vm);
+            TestJob job(config);
+            InputLines input(paths, 1 * MiB, false);
+            shared_ptr<Lines> lines = job.run(input);
+            lines->verify();
+        }
     }
 }
@@ -0,0 +1,167 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief Measures the throughput of the map-reduce framework when
+///        partitioning synthetic input, for various numbers of worker
+///        and reader threads. This is not a unit test, run it as:
+///
+///     mapReduceBench [<input size in MiB> [<max worker threads>]]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "boost/program_options.hpp"
+#include "boost/shared_ptr.hpp"
+
+#include "partition/Chunker.h"
+#include "partition/ConfigStore.h"
+#include "partition/Csv.h"
+#include "partition/FileUtils.h"
+#include "partition/MapReduce.h"
+#include "TempFile.h"
+
+namespace fs = boost::filesystem;
+namespace po = boost::program_options;
+namespace csv = lsst::partition::csv;
+
+using boost::shared_ptr;
+using std::string;
+
+using lsst::partition::BufferedAppender;
+using lsst::partition::ChunkLocation;
+using lsst::partition::Chunker;
+using lsst::partition::ConfigStore;
+using lsst::partition::InputLines;
+using lsst::partition::Job;
+using lsst::partition::MiB;
+using lsst::partition::WorkerBase;
+
+namespace {
+
+/// Generate a CSV file of about `size` bytes with lines of the
+/// form "id<TAB>ra<TAB>dec", where positions are pseudo-random.
+void buildInput(TempFile const &t, size_t size) {
+    char buf[64];
+    size_t written = 0;
+    unsigned int seed = 1;
+    BufferedAppender a(4 * MiB);
+    a.open(t.path(), true);
+    for (unsigned long id = 0; written < size; ++id) {
+        double ra = 360.0 * rand_r(&seed) / RAND_MAX;
+        double dec = 180.0 * rand_r(&seed) / RAND_MAX - 90.0;
+        int n = snprintf(buf, sizeof(buf), "%lu\t%.10f\t%.10f\n", id, ra, dec);
+        a.append(buf, n);
+        written += n;
+    }
+    a.close();
+}
+
+struct Count {
+    unsigned long records;
+
+    Count() : records(0) {}
+    void merge(Count const &c) { records += c.records; }
+};
+
+/// Locates input records like sph-partition, but counts them per
+/// chunk instead of writing them out.
+class Worker : public WorkerBase<ChunkLocation, Count> {
+public:
+    Worker(ConfigStore const &config) : _editor(config), _chunker(config), _count(new Count()) {}
+
+    void map(char const *beg, char const *end, Silo &silo) {
+        while (beg < end) {
+            beg = _editor.readRecord(beg, end);
+            std::pair<double, double> sc(_editor.get<double>(1), _editor.get<double>(2));
+            _locations.clear();
+            _chunker.locate(sc, -1, _locations);
+            for (std::vector<ChunkLocation>::const_iterator i = _locations.begin(), e = _locations.end();
+                 i != e; ++i) {
+                silo.add(*i, _editor);
+            }
+        }
+    }
+
+    void reduce(RecordIter beg, RecordIter end) { _count->records += end - beg; }
+
+    void finish() {}
+
+    shared_ptr<Count> const result() { return _count; }
+
+    static void defineOptions(po::options_description &opts) {
+        Chunker::defineOptions(opts);
+        csv::Editor::defineOptions(opts);
+    }
+
+private:
+    csv::Editor _editor;
+    Chunker _chunker;
+    std::vector<ChunkLocation> _locations;
+    shared_ptr<Count> _count;
+};
+
+typedef Job<Worker> BenchJob;
+
+}  // unnamed namespace
+
+int main(int argc, char const *const *argv) {
+    size_t const sizeMiB = argc > 1 ? strtoul(argv[1], 0, 10) : 256;
+    unsigned int const maxWorkers = argc > 2 ? strtoul(argv[2], 0, 10) : 8;
+    try {
+        TempFile t;
+        buildInput(t, sizeMiB * MiB);
+        std::vector<fs::path> paths(1, t.path());
+        po::options_description options;
+        BenchJob::defineOptions(options);
+        std::cout << "workers readers       MiB/s    records" << std::endl;
+        for (unsigned int w = 1; w <= maxWorkers; w *= 2) {
+            for (unsigned int r = 0; r <= 2; ++r) {
+                std::vector<string> args;
+                args.push_back("--in.csv.field=id");
+                args.push_back("--in.csv.field=ra");
+                args.push_back("--in.csv.field=dec");
+                args.push_back("--mr.num-workers=" + std::to_string(w));
+                args.push_back("--mr.num-readers=" + std::to_string(r));
+                po::variables_map vm;
+                po::store(po::command_line_parser(args).options(options).run(), vm);
+                po::notify(vm);
+                ConfigStore config;
+                config.add(vm);
+                BenchJob job(config);
+                InputLines input(paths, config.get<size_t>("mr.block-size") * MiB, false);
+                auto const start = std::chrono::steady_clock::now();
+                shared_ptr<Count> count = job.run(input);
+                std::chrono::duration<double> const secs = std::chrono::steady_clock::now() - start;
+                printf("%7u %7u %11.1f %10lu\n", w, r, sizeMiB / secs.count(), count->records);
+            }
+        }
+    } catch (std::exception const &ex) {
+        std::cerr << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
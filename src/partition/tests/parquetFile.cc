@@ -0,0 +1,202 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#include <stdlib.h>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "arrow/api.h"
+#include "arrow/io/file.h"
+#include "boost/filesystem.hpp"
+#include "parquet/arrow/writer.h"
+
+#define BOOST_TEST_MODULE ParquetFile
+#include "boost/test/unit_test.hpp"
+
+#include "partition/Constants.h"
+#include "partition/Csv.h"
+#include "partition/InputLines.h"
+#include "partition/ParquetFile.h"
+
+namespace fs = boost::filesystem;
+
+using std::string;
+using std::vector;
+
+using lsst::partition::InputLines;
+using lsst::partition::MiB;
+using lsst::partition::ParquetFile;
+using lsst::partition::csv::Dialect;
+using lsst::partition::csv::Editor;
+
+namespace {
+
+int64_t const NUM_ROWS = 20000;
+
+// The contents of a generated Parquet file.
+struct Fixture {
+    vector<double> ra;
+    vector<double> decl;  // NaN stands for NULL.
+    vector<string> name;
+    fs::path path;
+
+    Fixture(int64_t rowGroupSize);
+    ~Fixture() { fs::remove(path); }
+};
+
+void check(arrow::Status const& s) {
+    if (!s.ok()) {
+        throw std::runtime_error(s.ToString());
+    }
+}
+
+Fixture::Fixture(int64_t rowGroupSize) : path(fs::temp_directory_path() / fs::unique_path("%%%%-%%%%.parquet")) {
+    unsigned int seed = 1;
+    arrow::Int64Builder id;
+    arrow::DoubleBuilder raBuilder;
+    arrow::DoubleBuilder declBuilder;
+    arrow::StringBuilder nameBuilder;
+    arrow::BooleanBuilder flag;
+    arrow::Date32Builder date;
+    for (int64_t i = 0; i < NUM_ROWS; ++i) {
+        ra.push_back(360.0 * rand_r(&seed) / RAND_MAX);
+        decl.push_back(i % 7 == 0 ? NAN : 180.0 * rand_r(&seed) / RAND_MAX - 90.0);
+        // Long enough for a row group to take more than one read, and
+        // with characters that must be escaped.
+        name.push_back("name|" + std::to_string(i) + "\\" + string(80, 'n'));
+        check(id.Append(i));
+        check(raBuilder.Append(ra.back()));
+        check(i % 7 == 0 ? declBuilder.AppendNull() : declBuilder.Append(decl.back()));
+        check(nameBuilder.Append(name.back()));
+        check(flag.Append(i % 2 == 0));
+        check(date.Append(static_cast<int32_t>(i)));
+    }
+    std::vector<std::shared_ptr<arrow::Array>> arrays(6);
+    check(id.Finish(&arrays[0]));
+    check(raBuilder.Finish(&arrays[1]));
+    check(declBuilder.Finish(&arrays[2]));
+    check(nameBuilder.Finish(&arrays[3]));
+    check(flag.Finish(&arrays[4]));
+    check(date.Finish(&arrays[5]));
+    std::shared_ptr<arrow::Schema> schema = arrow::schema(
+            {arrow::field("id", arrow::int64()), arrow::field("ra", arrow::float64()),
+             arrow::field("decl", arrow::float64()), arrow::field("name", arrow::utf8()),
+             arrow::field("flag", arrow::boolean()), arrow::field("date", arrow::date32())});
+    std::shared_ptr<arrow::Table> table = arrow::Table::Make(schema, arrays);
+    std::shared_ptr<arrow::io::FileOutputStream> out = arrow::io::FileOutputStream::Open(path.string()).ValueOrDie();
+    check(parquet::arrow::WriteTable(*table, arrow::default_memory_pool(), out, rowGroupSize));
+    check(out->Close());
+}
+
+vector<string> const fieldNames() {
+    vector<string> names;
+    names.push_back("flag");
+    names.push_back("name");
+    names.push_back("ra");
+    names.push_back("decl");
+    names.push_back("id");
+    return names;
+}
+
+// Read all lines of a fixture and check them.
+void verify(Fixture const& f, InputLines input) {
+    Dialect const dialect('|', '\\', '"');
+    Editor editor(dialect, dialect, fieldNames(), fieldNames());
+    vector<char> buf(input.getMinimumBufferCapacity());
+    vector<int> seen(NUM_ROWS, 0);
+    int numReads = 0;
+    bool ok = true;
+    for (std::pair<char*, char*> r = input.read(&buf[0]); r.first != 0; r = input.read(&buf[0])) {
+        ++numReads;
+        for (char const* cur = r.first; cur < r.second;) {
+            cur = editor.readRecord(cur, r.second);
+            int64_t const i = editor.get<int64_t>("id");
+            ok = ok && i >= 0 && i < NUM_ROWS;
+            if (!ok) {
+                break;
+            }
+            ++seen[i];
+            ok = ok && editor.get<int>("flag") == (i % 2 == 0 ? 1 : 0);
+            ok = ok && editor.get("name", true) == f.name[i];
+            ok = ok && editor.get<double>("ra") == f.ra[i];
+            if (i % 7 == 0) {
+                ok = ok && editor.isNull("decl");
+            } else {
+                ok = ok && editor.get<double>("decl") == f.decl[i];
+            }
+        }
+    }
+    BOOST_CHECK(ok);
+    BOOST_CHECK(std::count(seen.begin(), seen.end(), 1) == NUM_ROWS);
+    BOOST_CHECK(numReads > 1);
+    BOOST_CHECK(input.empty());
+}
+
+}  // unnamed namespace
+
+BOOST_AUTO_TEST_CASE(ParquetFileTest) {
+    Dialect const dialect('|', '\\', '"');
+    Fixture f(1000);
+    BOOST_CHECK(ParquetFile::isParquet(f.path));
+    BOOST_CHECK(ParquetFile::isParquet("a/b.parq"));
+    BOOST_CHECK(!ParquetFile::isParquet("a/b.csv"));
+    ParquetFile file(f.path, fieldNames(), dialect);
+    BOOST_CHECK_EQUAL(file.getNumRowGroups(), NUM_ROWS / 1000);
+    vector<string> names = fieldNames();
+    names.push_back("date");
+    BOOST_CHECK_THROW(ParquetFile(f.path, names, dialect), std::runtime_error);
+    names.back() = "missing";
+    BOOST_CHECK_THROW(ParquetFile(f.path, names, dialect), std::runtime_error);
+    // Formatting stops while there is room for another line.
+    boost::shared_ptr<ParquetFile::RowGroup const> rows = file.readRowGroup(1);
+    BOOST_CHECK_EQUAL(rows->getNumRows(), 1000);
+    vector<char> buf(2 * MAX_LINE_SIZE);
+    int64_t row = 0;
+    char* end = rows->format(&buf[0], &buf[0] + MAX_LINE_SIZE - 1, row);
+    BOOST_CHECK(end == &buf[0] && row == 0);
+    end = rows->format(&buf[0], &buf[0] + MAX_LINE_SIZE, row);
+    BOOST_CHECK_EQUAL(row, 1);
+    char num[32];
+    string expected = "1|" + dialect.encode(f.name[1000].data(), f.name[1000].size()) + "|";
+    expected += string(num, std::to_chars(num, num + sizeof(num), f.ra[1000]).ptr) + "|";
+    expected += string(num, std::to_chars(num, num + sizeof(num), f.decl[1000]).ptr) + "|";
+    expected += "1000\n";
+    BOOST_CHECK_EQUAL(string(&buf[0], end), expected);
+}
+
+BOOST_AUTO_TEST_CASE(InputLinesTest) {
+    Dialect const dialect('|', '\\', '"');
+    vector<fs::path> paths;
+    // Small row groups, and row groups which don't fit into a read buffer.
+    for (int64_t rowGroupSize = 1000; rowGroupSize < 2 * NUM_ROWS; rowGroupSize *= 20) {
+        Fixture f(rowGroupSize);
+        paths.assign(1, f.path);
+        verify(f, InputLines(paths, 1 * MiB, false, dialect, fieldNames()));
+        // Parquet files are only read when there are field names.
+        InputLines input(paths, 1 * MiB, false);
+        vector<char> buf(input.getMinimumBufferCapacity());
+        BOOST_CHECK_THROW(input.read(&buf[0]), std::runtime_error);
+    }
+}
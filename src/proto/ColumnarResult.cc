@@ -0,0 +1,244 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "proto/ColumnarResult.h"
+
+// System headers
+#include <charconv>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+using namespace std;
+
+// The fixed width values are copied to and from the blocks with memcpy,
+// which matches the little-endian layout documented in worker.proto.
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "ColumnBlock requires a little-endian host");
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.proto.ColumnarResult");
+
+using lsst::qserv::proto::ColumnBlock;
+
+/// @return the width of one value in bytes, 0 for variable width encodings.
+size_t fixedWidth(ColumnBlock::Encoding encoding) {
+    switch (encoding) {
+        case ColumnBlock::INT64:
+            return sizeof(int64_t);
+        case ColumnBlock::UINT64:
+            return sizeof(uint64_t);
+        case ColumnBlock::DOUBLE:
+            return sizeof(double);
+        case ColumnBlock::FLOAT:
+            return sizeof(float);
+        default:
+            return 0;
+    }
+}
+
+template <typename T>
+bool parseAppend(string& data, char const* val, unsigned long len) {
+    T v;
+    auto const end = val + len;
+    auto [ptr, ec] = from_chars(val, end, v);
+    if (ec != errc() || ptr != end) return false;
+    data.append(reinterpret_cast<char const*>(&v), sizeof(T));
+    return true;
+}
+
+void appendOffset(string& offsets, size_t offset) {
+    uint32_t const off = offset;
+    offsets.append(reinterpret_cast<char const*>(&off), sizeof(off));
+}
+
+}  // namespace
+
+namespace lsst::qserv::proto {
+
+int getResultRowCount(Result const& result) {
+    return isColumnar(result) ? static_cast<int>(result.rowcount()) : result.row_size();
+}
+
+ColumnBlockBuilder::ColumnBlockBuilder(Result& result, vector<ColumnBlock::Encoding> const& encodings) {
+    for (auto encoding : encodings) {
+        ColumnBlock* block = result.add_columnblock();
+        block->set_encoding(encoding);
+        block->mutable_data();
+        _blocks.push_back(block);
+    }
+}
+
+size_t ColumnBlockBuilder::addRow(char const* const* row, unsigned long const* lengths) {
+    size_t added = 0;
+    for (size_t i = 0, n = _blocks.size(); i < n; ++i) {
+        ColumnBlock& block = *_blocks[i];
+        if (row[i] == nullptr) {
+            _appendNull(block);
+            _setValid(block, false);
+            added += fixedWidth(block.encoding());
+            continue;
+        }
+        if (block.encoding() != ColumnBlock::BYTES) {
+            if (_appendFixed(block, row[i], lengths[i])) {
+                _setValid(block, true);
+                added += fixedWidth(block.encoding());
+                continue;
+            }
+            LOGS(_log, LOG_LVL_DEBUG,
+                 "column " << i << " value '" << string(row[i], lengths[i])
+                           << "' not numeric, switching to BYTES");
+            _convertToBytes(block);
+        }
+        string& data = *block.mutable_data();
+        data.append(row[i], lengths[i]);
+        appendOffset(*block.mutable_offsets(), data.size());
+        _setValid(block, true);
+        added += lengths[i] + sizeof(uint32_t);
+    }
+    ++_rowCount;
+    return added;
+}
+
+bool ColumnBlockBuilder::_appendFixed(ColumnBlock& block, char const* val, unsigned long len) {
+    string& data = *block.mutable_data();
+    switch (block.encoding()) {
+        case ColumnBlock::INT64:
+            return parseAppend<int64_t>(data, val, len);
+        case ColumnBlock::UINT64:
+            return parseAppend<uint64_t>(data, val, len);
+        case ColumnBlock::DOUBLE:
+            return parseAppend<double>(data, val, len);
+        case ColumnBlock::FLOAT:
+            return parseAppend<float>(data, val, len);
+        default:
+            return false;
+    }
+}
+
+void ColumnBlockBuilder::_appendNull(ColumnBlock& block) {
+    string& data = *block.mutable_data();
+    if (block.encoding() == ColumnBlock::BYTES) {
+        appendOffset(*block.mutable_offsets(), data.size());
+    } else {
+        data.append(fixedWidth(block.encoding()), '\0');
+    }
+}
+
+void ColumnBlockBuilder::_setValid(ColumnBlock& block, bool valid) {
+    string& validity = *block.mutable_validity();
+    size_t const byteIdx = _rowCount >> 3;
+    unsigned char const bit = 1u << (_rowCount & 7);
+    if (validity.empty()) {
+        if (valid) return;  // No NULLs in this column so far.
+        // First NULL in this column, mark all previous rows as valid.
+        validity.assign(byteIdx + 1, '\xff');
+    } else if (validity.size() <= byteIdx) {
+        validity.push_back('\0');
+    }
+    if (valid) {
+        validity[byteIdx] = static_cast<char>(static_cast<unsigned char>(validity[byteIdx]) | bit);
+    } else {
+        validity[byteIdx] = static_cast<char>(static_cast<unsigned char>(validity[byteIdx]) & ~bit);
+    }
+}
+
+void ColumnBlockBuilder::_convertToBytes(ColumnBlock& block) {
+    string data;
+    string offsets;
+    {
+        ColumnBlockReader reader(block, _rowCount);
+        char buf[ColumnBlockReader::MAX_NUMERIC_CHARS];
+        for (unsigned int row = 0; row < _rowCount; ++row) {
+            if (!reader.isNull(row)) {
+                data.append(buf, reader.toChars(row, buf));
+            }
+            appendOffset(offsets, data.size());
+        }
+    }
+    block.set_encoding(ColumnBlock::BYTES);
+    block.mutable_data()->swap(data);
+    block.mutable_offsets()->swap(offsets);
+}
+
+ColumnBlockReader::ColumnBlockReader(ColumnBlock const& block, unsigned int rowCount)
+        : _encoding(block.encoding()),
+          _width(fixedWidth(_encoding)),
+          _data(block.data()),
+          _offsets(block.offsets()),
+          _validity(block.validity()) {
+    if (!_validity.empty() && _validity.size() != (rowCount + 7) / 8) {
+        throw ColumnarResultError("ColumnBlock validity size " + to_string(_validity.size()) +
+                                  " does not match rowCount=" + to_string(rowCount));
+    }
+    if (_width != 0) {
+        if (_data.size() != _width * rowCount) {
+            throw ColumnarResultError("ColumnBlock data size " + to_string(_data.size()) +
+                                      " does not match rowCount=" + to_string(rowCount));
+        }
+        return;
+    }
+    if (_encoding != ColumnBlock::BYTES) {
+        throw ColumnarResultError("ColumnBlock unknown encoding " + to_string(_encoding));
+    }
+    if (_offsets.size() != sizeof(uint32_t) * rowCount) {
+        throw ColumnarResultError("ColumnBlock offsets size " + to_string(_offsets.size()) +
+                                  " does not match rowCount=" + to_string(rowCount));
+    }
+    // Offsets must never decrease and must end at the end of the data, so that
+    // getBytes() can't read outside of the block.
+    uint32_t prev = 0;
+    for (unsigned int row = 0; row < rowCount; ++row) {
+        uint32_t const off = _getOffset(row);
+        if (off < prev) {
+            throw ColumnarResultError("ColumnBlock offsets decrease at row " + to_string(row));
+        }
+        prev = off;
+    }
+    if (prev != _data.size()) {
+        throw ColumnarResultError("ColumnBlock offsets end at " + to_string(prev) +
+                                  " but data size is " + to_string(_data.size()));
+    }
+}
+
+size_t ColumnBlockReader::toChars(unsigned int row, char* dest) const {
+    char* const end = dest + MAX_NUMERIC_CHARS;
+    switch (_encoding) {
+        case ColumnBlock::INT64:
+            return to_chars(dest, end, getInt64(row)).ptr - dest;
+        case ColumnBlock::UINT64:
+            return to_chars(dest, end, getUInt64(row)).ptr - dest;
+        case ColumnBlock::DOUBLE:
+            // The shortest representation that parses back to the same value.
+            return to_chars(dest, end, getDouble(row)).ptr - dest;
+        case ColumnBlock::FLOAT:
+            return to_chars(dest, end, getFloat(row)).ptr - dest;
+        default: {
+            string_view const val = getBytes(row);
+            memcpy(dest, val.data(), val.size());
+            return val.size();
+        }
+    }
+}
+
+}  // namespace lsst::qserv::proto
@@ -0,0 +1,160 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_PROTO_COLUMNARRESULT_H
+#define LSST_QSERV_PROTO_COLUMNARRESULT_H
+
+// System headers
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Qserv headers
+#include "proto/worker.pb.h"
+
+namespace lsst::qserv::proto {
+
+/// The result protocol for row-based results (Result.row).
+constexpr int RESULT_PROTOCOL_ROWS = 2;
+
+/// The result protocol for column-based results (Result.columnblock).
+constexpr int RESULT_PROTOCOL_COLUMNS = 3;
+
+/// ColumnarResultError is thrown when a column block is inconsistent
+/// with the number of rows in its Result message.
+struct ColumnarResultError : std::runtime_error {
+    ColumnarResultError(std::string const& msg) : std::runtime_error(msg) {}
+};
+
+/// @return true if the rows of 'result' are stored in column blocks.
+inline bool isColumnar(Result const& result) { return result.columnblock_size() > 0; }
+
+/// @return the number of rows in 'result' for either result protocol.
+int getResultRowCount(Result const& result);
+
+/// ColumnBlockBuilder appends rows, in the text form returned by
+/// mysql_fetch_row(), to the column blocks of a Result message.
+/// Values of numeric columns are stored in their native binary form, all
+/// other values are copied as-is. The blocks are owned by the Result
+/// message, so the message can be serialized at any point and more rows
+/// appended afterwards.
+///
+/// If a value of a numeric column can't be parsed, the column is
+/// converted to the BYTES encoding, which is able to hold anything.
+class ColumnBlockBuilder {
+public:
+    ColumnBlockBuilder(Result& result, std::vector<ColumnBlock::Encoding> const& encodings);
+    ColumnBlockBuilder() = delete;
+    ColumnBlockBuilder(ColumnBlockBuilder const&) = delete;
+    ColumnBlockBuilder& operator=(ColumnBlockBuilder const&) = delete;
+
+    /// Append one row. A nullptr in 'row' indicates a NULL value.
+    /// @return the number of bytes added to the blocks.
+    size_t addRow(char const* const* row, unsigned long const* lengths);
+
+    /// @return the number of rows added so far.
+    unsigned int getRowCount() const { return _rowCount; }
+
+    /// @return the number of columns.
+    int getColumnCount() const { return _blocks.size(); }
+
+private:
+    /// Parse 'val' into the fixed width slot for the current row.
+    /// @return false if 'val' couldn't be parsed.
+    bool _appendFixed(ColumnBlock& block, char const* val, unsigned long len);
+
+    /// Append an empty slot for a NULL value of the current row.
+    void _appendNull(ColumnBlock& block);
+
+    /// Record whether the value in the current row is valid (not NULL).
+    void _setValid(ColumnBlock& block, bool valid);
+
+    /// Convert the rows already in 'block' to the BYTES encoding.
+    void _convertToBytes(ColumnBlock& block);
+
+    std::vector<ColumnBlock*> _blocks;  ///< Owned by the Result message.
+    unsigned int _rowCount = 0;
+};
+
+/// ColumnBlockReader provides access to the values in one column block.
+class ColumnBlockReader {
+public:
+    /// @throws ColumnarResultError if the sizes of the block's buffers
+    ///         do not match 'rowCount'.
+    ColumnBlockReader(ColumnBlock const& block, unsigned int rowCount);
+
+    ColumnBlock::Encoding getEncoding() const { return _encoding; }
+
+    bool isNull(unsigned int row) const {
+        if (_validity.empty()) return false;
+        return (static_cast<unsigned char>(_validity[row >> 3]) & (1u << (row & 7))) == 0;
+    }
+
+    int64_t getInt64(unsigned int row) const { return _get<int64_t>(row); }
+    uint64_t getUInt64(unsigned int row) const { return _get<uint64_t>(row); }
+    double getDouble(unsigned int row) const { return _get<double>(row); }
+    float getFloat(unsigned int row) const { return _get<float>(row); }
+
+    /// @return a pointer to the value of a cell with a fixed width encoding.
+    char const* getFixedData(unsigned int row) const { return _data.data() + row * _width; }
+
+    /// @return the value of a BYTES encoded cell.
+    std::string_view getBytes(unsigned int row) const {
+        uint32_t const begin = (row == 0) ? 0 : _getOffset(row - 1);
+        return std::string_view(_data.data() + begin, _getOffset(row) - begin);
+    }
+
+    /// Write the text form of a non-NULL cell to 'dest', which must have room
+    /// for at least MAX_NUMERIC_CHARS characters for the numeric encodings.
+    /// BYTES cells are copied as-is.
+    /// @return the number of characters written.
+    size_t toChars(unsigned int row, char* dest) const;
+
+    /// Maximum length of the text form of a numeric value.
+    static constexpr size_t MAX_NUMERIC_CHARS = 32;
+
+private:
+    template <typename T>
+    T _get(unsigned int row) const {
+        T val;
+        std::memcpy(&val, _data.data() + row * sizeof(T), sizeof(T));
+        return val;
+    }
+
+    uint32_t _getOffset(unsigned int row) const {
+        uint32_t off;
+        std::memcpy(&off, _offsets.data() + row * sizeof(uint32_t), sizeof(uint32_t));
+        return off;
+    }
+
+    ColumnBlock::Encoding const _encoding;
+    size_t const _width;  ///< Width of a value in bytes, 0 for BYTES.
+    std::string_view const _data;
+    std::string_view const _offsets;
+    std::string_view const _validity;
+};
+
+}  // namespace lsst::qserv::proto
+
+#endif  // LSST_QSERV_PROTO_COLUMNARRESULT_H
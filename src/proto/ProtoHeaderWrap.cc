@@ -23,12 +23,16 @@
 
 // System headers
 
+// Third-party headers
+#include <zlib.h>
+
 // LSST headers
 #include "lsst/log/Log.h"
 
 // Qserv headers
 #include "proto/ProtoHeaderWrap.h"
 #include "util/common.h"
+#include "util/StringHash.h"
 
 namespace {
 LOG_LOGGER _log = LOG_GET("lsst.qserv.parser.ProtoHeaderWrap");
@@ -66,4 +70,51 @@ bool ProtoHeaderWrap::unwrap(std::shared_ptr<WorkerResponse>& response, std::vec
     return true;
 }
 
+std::string ProtoHeaderWrap::getChecksum(ProtoHeader::ChecksumType type, char const* buffer,
+                                         size_t bufferSize) {
+    if (type == ProtoHeader::CRC32C) {
+        uint32_t const crc = util::StringHash::getCrc32c(buffer, bufferSize);
+        char const bytes[] = {static_cast<char>(crc >> 24), static_cast<char>(crc >> 16),
+                              static_cast<char>(crc >> 8), static_cast<char>(crc)};
+        return std::string(bytes, sizeof(bytes));
+    }
+    return util::StringHash::getMd5(buffer, bufferSize);
+}
+
+bool ProtoHeaderWrap::compress(ProtoHeader::Codec codec, std::string const& in, std::string& out) {
+    if (codec != ProtoHeader::ZLIB) return false;
+    uLongf outSize = compressBound(in.size());
+    out.resize(outSize);
+    // Level 1, results are compressed on the path to the czar and speed matters more than size.
+    int const rc = compress2(reinterpret_cast<Bytef*>(out.data()), &outSize,
+                             reinterpret_cast<Bytef const*>(in.data()), in.size(), 1);
+    if (rc != Z_OK) {
+        LOGS(_log, LOG_LVL_ERROR, "compress failed rc=" << rc << " size=" << in.size());
+        out.clear();
+        return false;
+    }
+    out.resize(outSize);
+    return true;
+}
+
+bool ProtoHeaderWrap::decompress(ProtoHeader::Codec codec, char const* buffer, size_t size, size_t rawSize,
+                                 std::string& out) {
+    if (codec != ProtoHeader::ZLIB) {
+        LOGS(_log, LOG_LVL_ERROR, "decompress unknown codec=" << codec);
+        return false;
+    }
+    out.resize(rawSize);
+    uLongf outSize = rawSize;
+    int const rc = uncompress(reinterpret_cast<Bytef*>(out.data()), &outSize,
+                              reinterpret_cast<Bytef const*>(buffer), size);
+    if (rc != Z_OK || outSize != rawSize) {
+        LOGS(_log, LOG_LVL_ERROR,
+             "decompress failed rc=" << rc << " size=" << size << " rawSize=" << rawSize
+                                     << " got=" << outSize);
+        out.clear();
+        return false;
+    }
+    return true;
+}
+
 }  // namespace lsst::qserv::proto
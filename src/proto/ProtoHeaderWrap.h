@@ -33,6 +33,7 @@
 
 // System headers
 #include <memory>
+#include <string>
 
 // Qserv headers
 #include "proto/ProtoImporter.h"
@@ -51,6 +52,20 @@ public:
     static std::string wrap(std::string const& protoHeaderString);
     static bool unwrap(std::shared_ptr<WorkerResponse>& response, std::vector<char>& buffer);
     static size_t getProtoHeaderSize();
+
+    /// @return the checksum of 'buffer' computed with 'type', in the form
+    ///         stored in ProtoHeader.md5.
+    static std::string getChecksum(ProtoHeader::ChecksumType type, char const* buffer, size_t bufferSize);
+
+    /// Compress 'in' with 'codec' into 'out'.
+    /// @return false if 'codec' is NONE or unknown, or compression failed.
+    static bool compress(ProtoHeader::Codec codec, std::string const& in, std::string& out);
+
+    /// Decompress 'size' bytes of 'buffer' with 'codec' into 'out', which
+    /// must come out 'rawSize' bytes long.
+    /// @return false if 'codec' is unknown or the bytes could not be decompressed.
+    static bool decompress(ProtoHeader::Codec codec, char const* buffer, size_t size, size_t rawSize,
+                           std::string& out);
 };
 
 }  // namespace lsst::qserv::proto
@@ -0,0 +1,57 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "proto/TaskMsgTemplate.h"
+
+namespace lsst::qserv::proto {
+
+void makeTaskMsgTemplate(TaskMsg const& taskMsg, TaskMsg& tmpl) {
+    tmpl.CopyFrom(taskMsg);
+    tmpl.clear_jobid();
+    tmpl.clear_attemptcount();
+    tmpl.clear_chunkid();
+    tmpl.clear_templateid();
+    for (auto& fragment : *tmpl.mutable_fragment()) {
+        if (fragment.has_subchunks()) fragment.mutable_subchunks()->clear_id();
+    }
+}
+
+void expandTaskMsg(TaskMsg const& tmpl, TaskMsg& taskMsg) {
+    if (taskMsg.fragment_size() > 0 && taskMsg.fragment_size() != tmpl.fragment_size()) {
+        throw TaskMsgTemplateError("TaskMsg has " + std::to_string(taskMsg.fragment_size()) +
+                                   " fragments, its template has " + std::to_string(tmpl.fragment_size()));
+    }
+    TaskMsg compact;
+    compact.Swap(&taskMsg);
+    taskMsg.CopyFrom(tmpl);
+    taskMsg.set_jobid(compact.jobid());
+    taskMsg.set_attemptcount(compact.attemptcount());
+    taskMsg.set_chunkid(compact.chunkid());
+    taskMsg.set_templateid(compact.templateid());
+    for (int i = 0; i < compact.fragment_size(); ++i) {
+        auto& ids = *compact.mutable_fragment(i)->mutable_subchunks()->mutable_id();
+        taskMsg.mutable_fragment(i)->mutable_subchunks()->mutable_id()->Swap(&ids);
+    }
+}
+
+}  // namespace lsst::qserv::proto
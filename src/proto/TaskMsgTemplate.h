@@ -0,0 +1,61 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_PROTO_TASKMSGTEMPLATE_H
+#define LSST_QSERV_PROTO_TASKMSGTEMPLATE_H
+
+// System headers
+#include <stdexcept>
+#include <string>
+
+// Qserv headers
+#include "proto/worker.pb.h"
+
+/// The jobs of a query only differ by their chunk and subchunk numbers, the
+/// queries keep CHUNK_TAG and SUBCHUNK_TAG for the worker to fill in. Once a
+/// worker has the template of a query (TaskMsg.templateid), the czar only
+/// needs to send it the fields that differ between jobs.
+namespace lsst::qserv::proto {
+
+/// TaskMsgTemplateError is thrown when a TaskMsg doesn't fit its template.
+struct TaskMsgTemplateError : std::runtime_error {
+    TaskMsgTemplateError(std::string const& msg) : std::runtime_error(msg) {}
+};
+
+/// @return true if 'taskMsg' only has the fields that differ between jobs,
+///         and must be completed with expandTaskMsg().
+inline bool isCompactTaskMsg(TaskMsg const& taskMsg) {
+    return taskMsg.has_templateid() && !taskMsg.has_db();
+}
+
+/// Store in 'tmpl' the template of 'taskMsg', a copy without its jobid,
+/// attemptcount, chunkid, templateid and subchunk ids.
+void makeTaskMsgTemplate(TaskMsg const& taskMsg, TaskMsg& tmpl);
+
+/// Fill in the compact message 'taskMsg' (see isCompactTaskMsg()) from its
+/// template 'tmpl'. If 'taskMsg' has fragments, there must be one for each
+/// fragment of 'tmpl', and their subchunk ids are used.
+/// @throws TaskMsgTemplateError if the fragments don't match.
+void expandTaskMsg(TaskMsg const& tmpl, TaskMsg& taskMsg);
+
+}  // namespace lsst::qserv::proto
+
+#endif  // LSST_QSERV_PROTO_TASKMSGTEMPLATE_H
@@ -198,6 +198,42 @@ BOOST_AUTO_TEST_CASE(ProtoHeaderWrap) {
     BOOST_CHECK(compareProtoHeaders(response->protoHeader, *ph));
 }
 
+BOOST_AUTO_TEST_CASE(ProtoHeaderChecksum) {
+    std::string const data = "123456789";
+    std::string const crc =
+            proto::ProtoHeaderWrap::getChecksum(proto::ProtoHeader::CRC32C, data.data(), data.size());
+    BOOST_CHECK_EQUAL(crc, std::string("\xe3\x06\x92\x83"));
+    std::string const md5 =
+            proto::ProtoHeaderWrap::getChecksum(proto::ProtoHeader::MD5, data.data(), data.size());
+    BOOST_CHECK_EQUAL(md5.size(), 16U);
+    // A header without checksumtype, as sent by older workers, means MD5.
+    proto::ProtoHeader ph;
+    BOOST_CHECK_EQUAL(ph.checksumtype(), proto::ProtoHeader::MD5);
+}
+
+BOOST_AUTO_TEST_CASE(ProtoHeaderCodec) {
+    std::string raw;
+    for (int i = 0; i < 1000; ++i) {
+        raw += "row " + std::to_string(i % 7) + '\0';
+    }
+    std::string compressed;
+    BOOST_CHECK(!proto::ProtoHeaderWrap::compress(proto::ProtoHeader::NONE, raw, compressed));
+    BOOST_REQUIRE(proto::ProtoHeaderWrap::compress(proto::ProtoHeader::ZLIB, raw, compressed));
+    BOOST_CHECK_LT(compressed.size(), raw.size());
+    std::string out;
+    BOOST_REQUIRE(proto::ProtoHeaderWrap::decompress(proto::ProtoHeader::ZLIB, compressed.data(),
+                                                     compressed.size(), raw.size(), out));
+    BOOST_CHECK(out == raw);
+    // A wrong size or damaged bytes are errors.
+    BOOST_CHECK(!proto::ProtoHeaderWrap::decompress(proto::ProtoHeader::ZLIB, compressed.data(),
+                                                    compressed.size(), raw.size() + 1, out));
+    BOOST_CHECK(!proto::ProtoHeaderWrap::decompress(proto::ProtoHeader::ZLIB, compressed.data(),
+                                                    compressed.size() / 2, raw.size(), out));
+    // A header without codec, as sent by older workers, means uncompressed.
+    proto::ProtoHeader ph;
+    BOOST_CHECK_EQUAL(ph.codec(), proto::ProtoHeader::NONE);
+}
+
 BOOST_AUTO_TEST_CASE(ScanTableInfo) {
     lsst::qserv::proto::ScanTableInfo stiA{"dba", "fruit", false, 1};
     lsst::qserv::proto::ScanTableInfo stiB{"dba", "fruit", true, 1};
@@ -0,0 +1,120 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "qana/ZoneMapPlugin.h"
+
+// System headers
+#include <string>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "css/CssAccess.h"
+#include "global/DbTable.h"
+#include "qana/AnalysisError.h"
+#include "query/AndTerm.h"
+#include "query/BetweenPredicate.h"
+#include "query/BoolFactor.h"
+#include "query/ColumnRef.h"
+#include "query/CompPredicate.h"
+#include "query/FromList.h"
+#include "query/InPredicate.h"
+#include "query/JoinRef.h"
+#include "query/QueryContext.h"
+#include "query/SelectStmt.h"
+#include "query/TableRef.h"
+#include "query/WhereClause.h"
+#include "query/ZoneMapRestrictor.h"
+
+namespace {
+
+using namespace lsst::qserv;
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.qana.ZoneMapPlugin");
+
+/// Collect the partitioned tables of the FROM list, including the joined ones.
+/// @return false if a partitioned table is referenced more than once.
+bool getChunkedTables(css::CssAccess& css, query::TableRef const& tableRef, DbTableSet& chunkedTables) {
+    std::string const& db = tableRef.getDb();
+    std::string const& table = tableRef.getTable();
+    bool const known = !db.empty() && !table.empty() && css.containsDb(db) && css.containsTable(db, table);
+    if (known && css.getPartTableParams(db, table).isChunked()) {
+        if (!chunkedTables.emplace(db, table).second) return false;
+    }
+    for (auto const& joinRef : tableRef.getJoins()) {
+        if (!getChunkedTables(css, *joinRef->getRight(), chunkedTables)) return false;
+    }
+    return true;
+}
+
+}  // anonymous namespace
+
+namespace lsst::qserv::qana {
+
+void ZoneMapPlugin::applyLogical(query::SelectStmt& stmt, query::QueryContext& context) {
+    if (!context.css) {
+        throw AnalysisBug("Missing metadata in context.");
+    }
+    if (!stmt.hasWhereClause()) return;
+    auto const andTerm = stmt.getWhereClause().getRootAndTerm();
+    if (andTerm == nullptr) return;
+
+    // A table joined with itself is read from the overlap tables as well,
+    // which have rows of the neighboring chunks not covered by the zone map
+    // of the chunk.
+    DbTableSet chunkedTables;
+    for (auto const& tableRef : stmt.getFromList().getTableRefList()) {
+        if (!::getChunkedTables(*context.css, *tableRef, chunkedTables)) {
+            LOGS(_log, LOG_LVL_TRACE, "Zone maps not used for a query joining a table with itself");
+            return;
+        }
+    }
+    if (chunkedTables.empty()) return;
+
+    query::ZoneMapRestrictorVec restrictors;
+    for (auto const& term : andTerm->_terms) {
+        auto const factor = std::dynamic_pointer_cast<query::BoolFactor>(term);
+        if (factor == nullptr || factor->_hasNot) continue;
+        for (auto const& factorTerm : factor->_terms) {
+            query::ZoneMapRestrictor::Ptr restrictor;
+            if (auto const inPredicate = std::dynamic_pointer_cast<query::InPredicate>(factorTerm)) {
+                restrictor = query::ZoneMapRestrictor::make(*inPredicate);
+            } else if (auto const compPredicate =
+                               std::dynamic_pointer_cast<query::CompPredicate>(factorTerm)) {
+                restrictor = query::ZoneMapRestrictor::make(*compPredicate);
+            } else if (auto const betweenPredicate =
+                               std::dynamic_pointer_cast<query::BetweenPredicate>(factorTerm)) {
+                restrictor = query::ZoneMapRestrictor::make(*betweenPredicate);
+            }
+            if (restrictor == nullptr) continue;
+            auto const& columnRef = restrictor->getColumnRef();
+            if (chunkedTables.count(DbTable(columnRef->getDb(), columnRef->getTable())) == 0) continue;
+            LOGS(_log, LOG_LVL_TRACE, "Add restrictor: " << *restrictor << " for " << factorTerm);
+            restrictors.push_back(restrictor);
+        }
+    }
+    context.addZoneMapRestrictors(restrictors);
+}
+
+}  // namespace lsst::qserv::qana
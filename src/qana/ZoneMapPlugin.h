@@ -0,0 +1,60 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_QANA_ZONEMAPPLUGIN_H
+#define LSST_QSERV_QANA_ZONEMAPPLUGIN_H
+
+// Qserv headers
+#include "qana/QueryPlugin.h"
+
+// forward declarations
+namespace lsst::qserv::query {
+class QueryContext;
+class SelectStmt;
+}  // namespace lsst::qserv::query
+
+namespace lsst::qserv::qana {
+
+/// ZoneMapPlugin finds the comparison, BETWEEN and IN predicates of the top level
+/// AND of the WHERE clause which restrict columns of partitioned tables to ranges
+/// of numeric values, and adds them to the context as zone map restrictors. The czar
+/// uses the restrictors for skipping chunks whose column ranges (zone maps) collected
+/// by the Replication system can't satisfy the predicates. The WHERE clause is not
+/// modified. This plugin should be executed after the column references have been
+/// resolved to their tables.
+class ZoneMapPlugin : public QueryPlugin {
+public:
+    // Types
+    typedef std::shared_ptr<ZoneMapPlugin> Ptr;
+
+    virtual ~ZoneMapPlugin() {}
+
+    void prepare() override {}
+
+    void applyLogical(query::SelectStmt& stmt, query::QueryContext&) override;
+
+    /// Return the name of the plugin class for logging.
+    std::string name() const override { return "ZoneMapPlugin"; }
+};
+
+}  // namespace lsst::qserv::qana
+
+#endif  // LSST_QSERV_QANA_ZONEMAPPLUGIN_H
@@ -0,0 +1,55 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "qdisp/ChunkPlacement.h"
+
+using namespace std;
+
+namespace lsst::qserv::qdisp {
+
+void ChunkPlacement::add(string const& db, vector<int> const& chunkIds, string const& workerId) {
+    lock_guard<mutex> lock(_mtx);
+    for (int chunkId : chunkIds) {
+        _workers[make_pair(db, chunkId)] = workerId;
+    }
+}
+
+void ChunkPlacement::remove(string const& db, vector<int> const& chunkIds) {
+    lock_guard<mutex> lock(_mtx);
+    for (int chunkId : chunkIds) {
+        _workers.erase(make_pair(db, chunkId));
+    }
+}
+
+string ChunkPlacement::get(string const& db, int chunkId) const {
+    lock_guard<mutex> lock(_mtx);
+    auto iter = _workers.find(make_pair(db, chunkId));
+    if (iter == _workers.end()) return string();
+    return iter->second;
+}
+
+size_t ChunkPlacement::size() const {
+    lock_guard<mutex> lock(_mtx);
+    return _workers.size();
+}
+
+}  // namespace lsst::qserv::qdisp
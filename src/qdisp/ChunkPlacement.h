@@ -0,0 +1,68 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_QSERV_QDISP_CHUNKPLACEMENT_H
+#define LSST_QSERV_QDISP_CHUNKPLACEMENT_H
+
+// System headers
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace lsst::qserv::qdisp {
+
+/// The czar doesn't know where chunks are, XrdSsi finds a worker for each
+/// chunk resource. This class remembers which worker sent the results for
+/// each chunk, so that chunks that are likely to be on the same worker can
+/// be sent to it together (see JobDescription::createBatch).
+/// Entries are only hints, workers refuse batches with chunks they don't have.
+class ChunkPlacement {
+public:
+    using Ptr = std::shared_ptr<ChunkPlacement>;
+
+    ChunkPlacement() = default;
+    ChunkPlacement(ChunkPlacement const&) = delete;
+    ChunkPlacement& operator=(ChunkPlacement const&) = delete;
+
+    /// Remember that worker 'workerId' sent the results for 'chunkIds' of database 'db'.
+    void add(std::string const& db, std::vector<int> const& chunkIds, std::string const& workerId);
+
+    /// Forget where 'chunkIds' of database 'db' are.
+    void remove(std::string const& db, std::vector<int> const& chunkIds);
+
+    /// @return the id of the worker that last sent results for 'chunkId' of
+    ///         database 'db', or an empty string if it isn't known.
+    std::string get(std::string const& db, int chunkId) const;
+
+    /// @return the number of chunks with a known worker.
+    size_t size() const;
+
+private:
+    mutable std::mutex _mtx;  ///< protects _workers
+    std::map<std::pair<std::string, int>, std::string> _workers;
+};
+
+}  // namespace lsst::qserv::qdisp
+
+#endif  // LSST_QSERV_QDISP_CHUNKPLACEMENT_H
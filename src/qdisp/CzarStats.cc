@@ -30,6 +30,7 @@
 
 // qserv headers
 #include "qdisp/QdispPool.h"
+#include "qmeta/QStatusWriter.h"
 #include "util/Bug.h"
 
 // LSST headers
@@ -69,6 +70,11 @@ CzarStats::CzarStats(qdisp::QdispPool::Ptr const& qdispPool) : _qdispPool(qdispP
             new util::HistogramRolling("RespWaitTime", bucketValsTimes, 1h, 10000));
     _histRespProcessing = util::HistogramRolling::Ptr(
             new util::HistogramRolling("RespProcessingTime", bucketValsTimes, 1h, 10000));
+    auto bucketValsWait = {0.001, 0.01, 0.1, 1.0, 10.0};
+    _histMergeConnWait = util::HistogramRolling::Ptr(
+            new util::HistogramRolling("MergeConnWaitTime", bucketValsWait, 1h, 10000));
+    _histResultDecompress = util::HistogramRolling::Ptr(
+            new util::HistogramRolling("ResultDecompressTime", bucketValsWait, 1h, 10000));
 }
 
 CzarStats::Ptr CzarStats::get() {
@@ -97,6 +103,25 @@ void CzarStats::endQueryRespConcurrentProcessing(TIMEPOINT start, TIMEPOINT end)
     _histRespProcessing->addEntry(end, secs.count());
 }
 
+void CzarStats::addMergeConnWait(TIMEPOINT start, TIMEPOINT end) {
+    std::chrono::duration<double> secs = end - start;
+    _histMergeConnWait->addEntry(end, secs.count());
+}
+
+void CzarStats::addResultDecompress(uint64_t compressedBytes, uint64_t rawBytes, TIMEPOINT start,
+                                    TIMEPOINT end) {
+    ++_resultMsgsCompressed;
+    _resultBytesCompressed += compressedBytes;
+    _resultBytesRaw += rawBytes;
+    std::chrono::duration<double> secs = end - start;
+    _histResultDecompress->addEntry(end, secs.count());
+}
+
+void CzarStats::addQuerySessionCacheHit(double savedSecs) {
+    ++_querySessionCacheHits;
+    _querySessionCacheSavedUs += static_cast<uint64_t>(savedSecs * 1'000'000);
+}
+
 void CzarStats::addTrmitRecvRate(double bytesPerSec) {
     _histTrmitRecvRate->addEntry(bytesPerSec);
     LOGS(_log, LOG_LVL_TRACE,
@@ -107,7 +132,9 @@ void CzarStats::addMergeRate(double bytesPerSec) {
     _histMergeRate->addEntry(bytesPerSec);
     LOGS(_log, LOG_LVL_TRACE,
          "czarstats::addTrmitRecvRate " << bytesPerSec << " " << _histMergeRate->getString("") << " jsonA="
-                                        << getTransmitStatsJson() << " jsonB=" << getQdispStatsJson());
+                                        << getTransmitStatsJson() << " jsonB=" << getQdispStatsJson()
+                                        << " jsonC=" << getQStatusStatsJson()
+                                        << " jsonD=" << getQuerySessionCacheStatsJson());
 }
 
 nlohmann::json CzarStats::getQdispStatsJson() const {
@@ -126,7 +153,38 @@ nlohmann::json CzarStats::getTransmitStatsJson() const {
     nlohmann::json js;
     js["TransmitRecvRate"] = _histTrmitRecvRate->getJson();
     js["histMergeRate"] = _histMergeRate->getJson();
+    js["mergeConnPoolHits"] = _mergeConnPoolHits.load();
+    js["mergeConnPoolMisses"] = _mergeConnPoolMisses.load();
+    js["histMergeConnWait"] = _histMergeConnWait->getJson();
+    js["resultMsgsCompressed"] = _resultMsgsCompressed.load();
+    js["resultBytesCompressed"] = _resultBytesCompressed.load();
+    js["resultBytesRaw"] = _resultBytesRaw.load();
+    js["histResultDecompress"] = _histResultDecompress->getJson();
     return js;
 }
 
+nlohmann::json CzarStats::getQuerySessionCacheStatsJson() const {
+    nlohmann::json js;
+    uint64_t const hits = _querySessionCacheHits;
+    uint64_t const misses = _querySessionCacheMisses;
+    js["hits"] = hits;
+    js["misses"] = misses;
+    js["hitRate"] = hits + misses == 0 ? 0.0 : static_cast<double>(hits) / (hits + misses);
+    js["evictions"] = _querySessionCacheEvictions.load();
+    js["expirations"] = _querySessionCacheExpirations.load();
+    js["savedSecs"] = _querySessionCacheSavedUs / 1'000'000.0;
+    return js;
+}
+
+void CzarStats::setQStatusWriter(std::shared_ptr<qmeta::QStatusWriter> const& qStatusWriter) {
+    std::lock_guard<util::Mutex> lg(_qStatusWriterMtx);
+    _qStatusWriter = qStatusWriter;
+}
+
+nlohmann::json CzarStats::getQStatusStatsJson() const {
+    std::lock_guard<util::Mutex> lg(_qStatusWriterMtx);
+    if (_qStatusWriter == nullptr) return nlohmann::json::object();
+    return _qStatusWriter->statusToJson();
+}
+
 }  // namespace lsst::qserv::qdisp
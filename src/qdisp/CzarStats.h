@@ -42,6 +42,10 @@
 // Third party headers
 #include <nlohmann/json.hpp>
 
+namespace lsst::qserv::qmeta {
+class QStatusWriter;
+}  // namespace lsst::qserv::qmeta
+
 namespace lsst::qserv::qdisp {
 
 class QdispPool;
@@ -78,6 +82,27 @@ public:
     /// Add a bytes per second entry for merges
     void addMergeRate(double bytesPerSec);
 
+    /// Count a merge that reused a pooled connection.
+    void addMergeConnPoolHit() { ++_mergeConnPoolHits; }
+    /// Count a merge that needed a new connection.
+    void addMergeConnPoolMiss() { ++_mergeConnPoolMisses; }
+    /// Add the time a merge waited for its turn to use a connection to the histogram.
+    void addMergeConnWait(TIMEPOINT start, TIMEPOINT end);
+
+    /// Count a compressed result message of 'compressedBytes' that came out
+    /// 'rawBytes' long, and add the time taken to decompress it to the histogram.
+    void addResultDecompress(uint64_t compressedBytes, uint64_t rawBytes, TIMEPOINT start, TIMEPOINT end);
+
+    /// Count a SELECT query whose parsed statement was kept by ccontrol::QuerySessionCache,
+    /// and add the time it took to parse the statement to the time saved.
+    void addQuerySessionCacheHit(double savedSecs);
+    /// Count a SELECT query whose statement wasn't kept.
+    void addQuerySessionCacheMiss() { ++_querySessionCacheMisses; }
+    /// Count kept statements dropped to make room for others.
+    void addQuerySessionCacheEvictions(uint64_t count) { _querySessionCacheEvictions += count; }
+    /// Count a kept statement dropped for being too old to be used.
+    void addQuerySessionCacheExpiration() { ++_querySessionCacheExpirations; }
+
     /// Increase the count of requests being setup.
     void startQueryRespConcurrentSetup() { ++_queryRespConcurrentSetup; }
     /// Decrease the count and add the time taken to the histogram.
@@ -99,6 +124,16 @@ public:
     /// Get a json object describing the current transmit/merge stats for this czar.
     nlohmann::json getTransmitStatsJson() const;
 
+    /// Get a json object describing the reuse of parsed SELECT statements.
+    nlohmann::json getQuerySessionCacheStatsJson() const;
+
+    /// Report the state of the writer of the chunk completion updates of queries.
+    void setQStatusWriter(std::shared_ptr<qmeta::QStatusWriter> const& qStatusWriter);
+
+    /// Get a json object describing the queue and the writes of the chunk completion
+    /// updates (@see qmeta::QStatusWriter), empty if they aren't written in the background.
+    nlohmann::json getQStatusStatsJson() const;
+
 private:
     CzarStats(std::shared_ptr<qdisp::QdispPool> const& qdispPool);
     static Ptr _globalCzarStats;    ///< Pointer to the global instance.
@@ -113,12 +148,30 @@ private:
     /// Histogram for tracking merge rate in bytes per second.
     util::HistogramRolling::Ptr _histMergeRate;
 
+    std::atomic<uint64_t> _mergeConnPoolHits{0};    ///< Merges that reused a pooled connection
+    std::atomic<uint64_t> _mergeConnPoolMisses{0};  ///< Merges that had to connect
+    util::HistogramRolling::Ptr _histMergeConnWait;  ///< Histogram for merge connection wait time
+
+    std::atomic<uint64_t> _resultMsgsCompressed{0};   ///< Compressed result messages received
+    std::atomic<uint64_t> _resultBytesCompressed{0};  ///< Bytes of compressed result messages received
+    std::atomic<uint64_t> _resultBytesRaw{0};         ///< Bytes of those messages after decompression
+    util::HistogramRolling::Ptr _histResultDecompress;  ///< Histogram for decompression time
+
+    std::atomic<uint64_t> _querySessionCacheHits{0};         ///< Queries that weren't parsed
+    std::atomic<uint64_t> _querySessionCacheMisses{0};       ///< Queries that were parsed
+    std::atomic<uint64_t> _querySessionCacheEvictions{0};    ///< Kept statements dropped for others
+    std::atomic<uint64_t> _querySessionCacheExpirations{0};  ///< Kept statements dropped for their age
+    std::atomic<uint64_t> _querySessionCacheSavedUs{0};      ///< Parsing time saved by the hits
+
     std::atomic<int64_t> _queryRespConcurrentSetup{0};       ///< Number of request currently being setup
     util::HistogramRolling::Ptr _histRespSetup;              ///< Histogram for setup time
     std::atomic<int64_t> _queryRespConcurrentWait{0};        ///< Number of requests currently waiting
     util::HistogramRolling::Ptr _histRespWait;               ///< Histogram for wait time
     std::atomic<int64_t> _queryRespConcurrentProcessing{0};  ///< Number of requests currently processing
     util::HistogramRolling::Ptr _histRespProcessing;         ///< Histogram for processing time
+
+    std::shared_ptr<qmeta::QStatusWriter> _qStatusWriter;  ///< Protected by _qStatusWriterMtx
+    mutable util::Mutex _qStatusWriterMtx;
 };
 
 }  // namespace lsst::qserv::qdisp
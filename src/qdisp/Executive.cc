@@ -103,6 +103,7 @@ Executive::Executive(ExecutiveConfig const& c, shared_ptr<MessageStore> const& m
           _messageStore(ms),
           _qdispPool(sharedResources->getQdispPool()),
           _queryRequestPseudoFifo(sharedResources->getQueryRequestPseudoFifo()),
+          _chunkPlacement(sharedResources->getChunkPlacement()),
           _qMeta(qStatus),
           _querySession(querySession) {
     _secondsBetweenQMetaUpdates = chrono::seconds(_config.secondsBetweenChunkUpdates);
@@ -229,6 +230,22 @@ bool Executive::startQuery(shared_ptr<JobQuery> const& jobQuery) {
     return true;
 }
 
+void Executive::splitBatch(JobDescription::Ptr const& jobDesc) {
+    // The worker may not have these chunks anymore, send them one by one for XrdSsi to find them.
+    _chunkPlacement->remove(jobDesc->getDb(), jobDesc->getChunkIds());
+    for (auto const& chunkJobDesc : jobDesc->unbatch()) {
+        add(chunkJobDesc);
+    }
+    if (_qMeta != nullptr) {
+        // This is not vital (logging), if it fails keep going.
+        try {
+            _qMeta->queryStatsTmpTotalUpdate(_id, _totalJobs);
+        } catch (qmeta::SqlError const& e) {
+            LOGS(_log, LOG_LVL_WARN, "Failed to update StatsTmp total " << e.what());
+        }
+    }
+}
+
 /// Add a JobQuery to this Executive.
 /// Return true if it was successfully added to the map.
 ///
@@ -244,6 +261,13 @@ bool Executive::join() {
     // To join, we make sure that all of the chunks added so far are complete.
     // Check to see if _requesters is empty, if not, then sleep on a condition.
     _waitAllUntilEmpty();
+    {
+        // Attempts that failed or were cancelled will never be marked delivered.
+        lock_guard<recursive_mutex> lockJobMap(_jobMapMtx);
+        for (auto const& entry : _jobMap) {
+            entry.second->getDescription()->forgetAttempt();
+        }
+    }
     // Okay to merge. probably not the Executive's responsibility
     struct successF {
         static bool func(Executive::JobMap::value_type const& entry) {
@@ -322,6 +346,7 @@ void Executive::markCompleted(int jobId, bool success) {
                  "Currently " << _multiError.size() << " registered errors: " << _multiError);
         }
     }
+    _recordWorker(jobId, success);
     _unTrack(jobId);
     if (!success && !isLimitRowComplete()) {
         LOGS(_log, LOG_LVL_ERROR,
@@ -451,6 +476,21 @@ bool Executive::_track(int jobId, shared_ptr<JobQuery> const& r) {
     return true;
 }
 
+void Executive::_recordWorker(int jobId, bool success) {
+    JobDescription::Ptr jobDesc;
+    {
+        lock_guard<recursive_mutex> lockJobMap(_jobMapMtx);
+        auto iter = _jobMap.find(jobId);
+        if (iter == _jobMap.end()) return;
+        jobDesc = iter->second->getDescription();
+    }
+    if (!success) return;
+    string const workerId = jobDesc->respHandler()->getWorkerId();
+    if (workerId.empty()) return;
+    _chunkPlacement->add(jobDesc->getDb(), jobDesc->getChunkIds(), workerId);
+    jobDesc->markDelivered(workerId);
+}
+
 void Executive::_unTrack(int jobId) {
     bool untracked = false;
     int incompleteJobs = _totalJobs;
@@ -137,8 +137,16 @@ public:
 
     std::shared_ptr<QdispPool> getQdispPool() { return _qdispPool; }
 
+    /// @return where the chunks were found by earlier jobs.
+    std::shared_ptr<ChunkPlacement> getChunkPlacement() { return _chunkPlacement; }
+
     bool startQuery(std::shared_ptr<JobQuery> const& jobQuery);
 
+    /// Split the batch of 'jobDesc' before it is tried again, its chunks
+    /// are added as jobs of their own, @see JobDescription::unbatch()
+    /// The total of the query's QStatsTmp row is updated to the new number of jobs.
+    void splitBatch(JobDescription::Ptr const& jobDesc);
+
     /// Add 'rowCount' to the total number of rows in the result table.
     void addResultRows(int rowCount);
 
@@ -169,6 +177,10 @@ private:
 
     bool _track(int refNum, std::shared_ptr<JobQuery> const& r);
     void _unTrack(int refNum);
+
+    /// Remember which worker sent the results of job 'jobId' if it succeeded,
+    /// both where its chunks are and that it has the message template of the job.
+    void _recordWorker(int jobId, bool success);
     bool _addJobToMap(std::shared_ptr<JobQuery> const& job);
     std::string _getIncompleteJobsString(int maxToList);
 
@@ -201,6 +213,8 @@ private:
     /// Used to prevent czar from calling the most recent (and possibly critcal) QueryRequests first.
     std::shared_ptr<PseudoFifo> _queryRequestPseudoFifo;
 
+    std::shared_ptr<ChunkPlacement> _chunkPlacement;  ///< Shared by all Executives.
+
     std::deque<PriorityCommand::Ptr> _jobStartCmdList;  ///< list of jobs to start.
 
     /** Execution errors */
@@ -33,6 +33,7 @@
 #include "lsst/log/Log.h"
 
 // Qserv headers
+#include "proto/FrameBuffer.h"
 #include "proto/ProtoImporter.h"
 #include "proto/worker.pb.h"
 #include "qdisp/ResponseHandler.h"
@@ -63,9 +64,46 @@ JobDescription::JobDescription(qmeta::CzarId czarId, QueryId qId, int jobId, Res
           _chunkResultName(chunkResultName),
           _mock(mock) {}
 
+JobDescription::Ptr JobDescription::createBatch(
+        qmeta::CzarId czarId, QueryId qId, int jobId, string const& workerId,
+        shared_ptr<ResponseHandler> const& respHandler,
+        shared_ptr<qproc::TaskMsgFactory> const& taskMsgFactory,
+        vector<shared_ptr<qproc::ChunkQuerySpec>> const& chunkQuerySpecs, string const& chunkResultName,
+        MakeJobFunc const& makeJob) {
+    ResourceUnit const ru(ResourceUnit::makeWorkerPath(workerId));
+    JobDescription::Ptr jd(new JobDescription(czarId, qId, jobId, ru, respHandler, taskMsgFactory,
+                                              chunkQuerySpecs.at(0), chunkResultName));
+    jd->_batchSpecs.assign(chunkQuerySpecs.begin() + 1, chunkQuerySpecs.end());
+    jd->_makeJob = makeJob;
+    return jd;
+}
+
+void JobDescription::markDelivered(string const& workerId) {
+    if (_taskMsgFactory != nullptr) _taskMsgFactory->markDelivered(_jobId, _attemptCount, workerId);
+}
+
+void JobDescription::forgetAttempt() {
+    if (_taskMsgFactory != nullptr) _taskMsgFactory->forgetAttempt(_jobId, _attemptCount);
+}
+
+vector<JobDescription::Ptr> JobDescription::unbatch() {
+    vector<JobDescription::Ptr> jobs;
+    if (!isBatch()) return jobs;
+    LOGS(_log, LOG_LVL_INFO,
+         _qIdStr << " splitting the batch sent to " << _resource.path() << " into " << _batchSpecs.size() + 1
+                 << " jobs");
+    _resource = ResourceUnit();
+    _resource.setAsDbChunk(_chunkQuerySpec->db, _chunkQuerySpec->chunkId);
+    for (auto const& spec : _batchSpecs) jobs.push_back(_makeJob(spec));
+    _batchSpecs.clear();
+    _makeJob = nullptr;
+    return jobs;
+}
+
 bool JobDescription::incrAttemptCountScrubResults() {
     if (_attemptCount >= 0) {
         _respHandler->prepScrubResults(_jobId, _attemptCount);  // Registers the job-attempt as invalid
+        forgetAttempt();
     }
     ++_attemptCount;
     if (_attemptCount > MAX_JOB_ATTEMPTS) {
@@ -77,6 +115,11 @@ bool JobDescription::incrAttemptCountScrubResults() {
 }
 
 void JobDescription::buildPayload() {
+    if (isBatch()) {
+        _taskMsgFactory->serializeBatchMsg(*_chunkQuerySpec, _batchSpecs, _chunkResultName, _queryId, _jobId,
+                                           _attemptCount, _czarId, _payloads[_attemptCount]);
+        return;
+    }
     ostringstream os;
     _taskMsgFactory->serializeMsg(*_chunkQuerySpec, _chunkResultName, _queryId, _jobId, _attemptCount,
                                   _czarId, os);
@@ -84,6 +127,21 @@ void JobDescription::buildPayload() {
 }
 
 bool JobDescription::verifyPayload() const {
+    if (isBatch()) {
+        // The payload is a worker command, the header followed by the message.
+        try {
+            string const& payload = _payloads.at(_attemptCount);
+            proto::FrameBufferView view(payload.data(), payload.size());
+            proto::WorkerCommandH header;
+            view.parse(header);
+            proto::TaskMsg taskMsg;
+            view.parse(taskMsg);
+        } catch (proto::FrameBufferError const& ex) {
+            LOGS(_log, LOG_LVL_DEBUG, _qIdStr << " Error serializing batch TaskMsg " << ex.what());
+            return false;
+        }
+        return true;
+    }
     proto::ProtoImporter<proto::TaskMsg> pi;
     if (!_mock && !pi.messageAcceptable(_payloads.at(_attemptCount))) {
         LOGS(_log, LOG_LVL_DEBUG, _qIdStr << " Error serializing TaskMsg.");
@@ -96,6 +154,14 @@ bool JobDescription::getScanInteractive() const { return _chunkQuerySpec->scanIn
 
 int JobDescription::getScanRating() const { return _chunkQuerySpec->scanInfo.scanRating; }
 
+string const& JobDescription::getDb() const { return _chunkQuerySpec->db; }
+
+vector<int> JobDescription::getChunkIds() const {
+    vector<int> chunkIds{_chunkQuerySpec->chunkId};
+    for (auto const& spec : _batchSpecs) chunkIds.push_back(spec->chunkId);
+    return chunkIds;
+}
+
 ostream& operator<<(ostream& os, JobDescription const& jd) {
     os << "job(id=" << jd._jobId << " payloads.size=" << jd._payloads.size() << " ru=" << jd._resource.path()
        << " attemptCount=" << jd._attemptCount << ")";
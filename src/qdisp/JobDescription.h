@@ -28,8 +28,12 @@
 #define LSST_QSERV_QDISP_JOBDESCRIPTION_H_
 
 // System headers
+#include <functional>
+#include <map>
 #include <memory>
 #include <sstream>
+#include <string>
+#include <vector>
 
 // Qserv headers
 #include "global/constants.h"
@@ -68,6 +72,19 @@ public:
         return jd;
     }
 
+    /// Function making a job, with a new id, that sends the query for one chunk to /chk/db/chunk.
+    using MakeJobFunc = std::function<Ptr(std::shared_ptr<qproc::ChunkQuerySpec> const&)>;
+
+    /// Create a job that runs the query on the chunks of all of 'chunkQuerySpecs'
+    /// in one request to the worker 'workerId', which is expected to have them.
+    /// @param makeJob - makes the jobs for the chunks if the batch has to be split, @see unbatch()
+    static JobDescription::Ptr createBatch(
+            qmeta::CzarId czarId, QueryId qId, int jobId, std::string const& workerId,
+            std::shared_ptr<ResponseHandler> const& respHandler,
+            std::shared_ptr<qproc::TaskMsgFactory> const& taskMsgFactory,
+            std::vector<std::shared_ptr<qproc::ChunkQuerySpec>> const& chunkQuerySpecs,
+            std::string const& chunkResultName, MakeJobFunc const& makeJob);
+
     JobDescription(JobDescription const&) = delete;
     JobDescription& operator=(JobDescription const&) = delete;
 
@@ -81,6 +98,29 @@ public:
     bool getScanInteractive() const;
     int getScanRating() const;
 
+    /// @return the database of the chunks.
+    std::string const& getDb() const;
+
+    /// @return the ids of the chunks of this job, there are several for batches.
+    std::vector<int> getChunkIds() const;
+
+    /// @return true if this job was made by createBatch() and hasn't been split.
+    bool isBatch() const { return !_batchSpecs.empty(); }
+
+    /// Tell the factory of the messages that worker 'workerId' ran the current
+    /// attempt of this job, @see qproc::TaskMsgFactory::markDelivered()
+    void markDelivered(std::string const& workerId);
+
+    /// Tell the factory of the messages that the current attempt of this job
+    /// won't be delivered, @see qproc::TaskMsgFactory::forgetAttempt()
+    void forgetAttempt();
+
+    /// Split a batch whose worker refused or failed it. This job is left with
+    /// the first chunk, sent to /chk/db/chunk like any other chunk from its
+    /// next attempt on, and jobs are made for the other chunks.
+    /// @return the jobs for the other chunks, they need to be added to the Executive.
+    std::vector<JobDescription::Ptr> unbatch();
+
     /// @returns true when _attemptCount is incremented correctly and the payload is built.
     /// If the starting value of _attemptCount was greater than or equal to zero, that
     /// attempt is scrubbed from the result table.
@@ -111,6 +151,9 @@ private:
     std::shared_ptr<ResponseHandler> _respHandler;  // probably MergingHandler
     std::shared_ptr<qproc::TaskMsgFactory> _taskMsgFactory;
     std::shared_ptr<qproc::ChunkQuerySpec> _chunkQuerySpec;
+    /// The other chunks of a batch, _chunkQuerySpec is the first one.
+    std::vector<std::shared_ptr<qproc::ChunkQuerySpec>> _batchSpecs;
+    MakeJobFunc _makeJob;  ///< Makes the jobs for _batchSpecs if the batch is split.
     std::string _chunkResultName;
 
     bool _mock{false};  ///< True if this is a mock in a unit test.
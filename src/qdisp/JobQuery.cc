@@ -79,6 +79,10 @@ bool JobQuery::runJob() {
 
         LOGS(_log, LOG_LVL_DEBUG, "runJob checking attempt=" << _jobDescription->getAttemptCount());
         std::lock_guard<std::recursive_mutex> lock(_rmutex);
+        if (_jobDescription->isBatch() && _jobDescription->getAttemptCount() >= 0) {
+            // Rather than retrying the batch on the same worker, each chunk is tried on its own.
+            executive->splitBatch(_jobDescription);
+        }
         if (_jobDescription->getAttemptCount() < _getMaxAttempts()) {
             bool okCount = _jobDescription->incrAttemptCountScrubResults();
             if (!okCount) {
@@ -82,6 +82,10 @@ public:
     /// Scrub the results from jobId-attempt from the result table.
     virtual void prepScrubResults(int jobId, int attempt) = 0;
 
+    /// @return the id of the worker that sent the results, or an empty string
+    ///         if it isn't known.
+    virtual std::string getWorkerId() const { return std::string(); }
+
     std::weak_ptr<JobQuery> getJobQuery() { return _jobQuery; }
 
 private:
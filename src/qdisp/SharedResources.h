@@ -25,6 +25,9 @@
 // System headers
 #include <memory>
 
+// Qserv headers
+#include "qdisp/ChunkPlacement.h"
+
 namespace lsst::qserv::qdisp {
 
 class QdispPool;
@@ -53,10 +56,14 @@ public:
 
     std::shared_ptr<qdisp::PseudoFifo> getQueryRequestPseudoFifo() { return _queryRequestPseudoFifo; }
 
+    ChunkPlacement::Ptr getChunkPlacement() { return _chunkPlacement; }
+
 private:
     SharedResources(std::shared_ptr<qdisp::QdispPool> const& qdispPool,
                     std::shared_ptr<qdisp::PseudoFifo> const& queryRequestPseudoFifo)
-            : _qdispPool(qdispPool), _queryRequestPseudoFifo(queryRequestPseudoFifo) {}
+            : _qdispPool(qdispPool),
+              _queryRequestPseudoFifo(queryRequestPseudoFifo),
+              _chunkPlacement(std::make_shared<ChunkPlacement>()) {}
 
     /// Thread pool for handling Responses from XrdSsi.
     std::shared_ptr<qdisp::QdispPool> _qdispPool;
@@ -64,6 +71,9 @@ private:
     /// PseudoFifo to prevent czar from calling most recent request first and try
     /// to handle and cleanup older resources first.
     std::shared_ptr<qdisp::PseudoFifo> _queryRequestPseudoFifo;
+
+    /// Workers that sent the results of chunks, used to send them batches of chunks.
+    ChunkPlacement::Ptr _chunkPlacement;
 };
 
 }  // namespace lsst::qserv::qdisp
@@ -52,11 +52,24 @@ public:
     /// @throw SqlError
     virtual void queryStatsTmpRegister(QueryId queryId, int totalChunks) = 0;
 
+    /// Update the total number of chunks, when the jobs of a query are split.
+    /// @throw SqlError
+    virtual void queryStatsTmpTotalUpdate(QueryId queryId, int totalChunks) = 0;
+
     /// Update the number of completed chunks
     /// @return true if successful.
     /// @throw SqlError
     virtual void queryStatsTmpChunkUpdate(QueryId queryId, int completedChunks) = 0;
 
+    /// Update the number of completed chunks of several queries at once.
+    /// @param completedChunks - the number of completed chunks by queryId.
+    /// @throw SqlError
+    virtual void queryStatsTmpChunkUpdates(std::map<QueryId, int> const& completedChunks) {
+        for (auto const& [queryId, chunks] : completedChunks) {
+            queryStatsTmpChunkUpdate(queryId, chunks);
+        }
+    }
+
     /// Get statistics for queryId
     /// @return QStats object containing query completion information.
     /// @throw QueryIdError, SqlError
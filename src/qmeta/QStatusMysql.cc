@@ -72,6 +72,22 @@ void QStatusMysql::queryStatsTmpRegister(QueryId queryId, int totalChunks) {
     trans->commit();
 }
 
+void QStatusMysql::queryStatsTmpTotalUpdate(QueryId queryId, int totalChunks) {
+    lock_guard<mutex> sync(_dbMutex);
+    auto trans = QMetaTransaction::create(*_conn);
+    sql::SqlErrorObject errObj;
+    string query = "UPDATE QStatsTmp SET totalChunks = " + to_string(totalChunks) +
+                   ", lastUpdate = NOW() WHERE queryId =" + to_string(queryId);
+
+    LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
+    if (not _conn->runQuery(query, errObj)) {
+        LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
+        throw SqlError(ERR_LOC, errObj);
+    }
+
+    trans->commit();
+}
+
 void QStatusMysql::queryStatsTmpChunkUpdate(QueryId queryId, int completedChunks) {
     lock_guard<mutex> sync(_dbMutex);
     auto trans = QMetaTransaction::create(*_conn);
@@ -89,6 +105,30 @@ void QStatusMysql::queryStatsTmpChunkUpdate(QueryId queryId, int completedChunks
     trans->commit();
 }
 
+void QStatusMysql::queryStatsTmpChunkUpdates(map<QueryId, int> const& completedChunks) {
+    if (completedChunks.empty()) return;
+    string cases;
+    string ids;
+    for (auto const& [queryId, chunks] : completedChunks) {
+        cases += " WHEN " + to_string(queryId) + " THEN " + to_string(chunks);
+        if (!ids.empty()) ids += ",";
+        ids += to_string(queryId);
+    }
+    string query = "UPDATE QStatsTmp SET completedChunks = CASE queryId" + cases +
+                   " ELSE completedChunks END, lastUpdate = NOW() WHERE queryId IN (" + ids + ")";
+
+    lock_guard<mutex> sync(_dbMutex);
+    auto trans = QMetaTransaction::create(*_conn);
+    sql::SqlErrorObject errObj;
+    LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
+    if (not _conn->runQuery(query, errObj)) {
+        LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
+        throw SqlError(ERR_LOC, errObj);
+    }
+
+    trans->commit();
+}
+
 QStats QStatusMysql::queryStatsTmpGet(QueryId queryId) {
     lock_guard<mutex> sync(_dbMutex);
     auto trans = QMetaTransaction::create(*_conn);
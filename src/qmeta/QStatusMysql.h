@@ -23,6 +23,7 @@
 #define LSST_QSERV_QMETA_QSTATUSMYSQL_H
 
 // System headers
+#include <map>
 #include <mutex>
 
 // Third-party headers
@@ -53,9 +54,16 @@ public:
     /// @see QStatus::queryStatsTmpRegister(QueryId queryId, int totalChunks)
     void queryStatsTmpRegister(QueryId queryId, int totalChunks) override;
 
+    /// @see QStatus::queryStatsTmpTotalUpdate(QueryId queryId, int totalChunks)
+    void queryStatsTmpTotalUpdate(QueryId queryId, int totalChunks) override;
+
     /// @see QStatus::queryStatsTmpChunkUpdate(QueryId queryId, int completedChunks)
     void queryStatsTmpChunkUpdate(QueryId queryId, int completedChunks) override;
 
+    /// Update all the queries with a single statement.
+    /// @see QStatus::queryStatsTmpChunkUpdates(std::map<QueryId, int> const&)
+    void queryStatsTmpChunkUpdates(std::map<QueryId, int> const& completedChunks) override;
+
     /// @see QStatus::queryStatsTmpGet(QueryId queryId)
     QStats queryStatsTmpGet(QueryId queryId) override;
 
@@ -0,0 +1,187 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "qmeta/QStatusWriter.h"
+
+// System headers
+#include <algorithm>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "qmeta/Exceptions.h"
+
+using namespace std;
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.qmeta.QStatusWriter");
+
+/// The counters are logged every this many statements.
+uint64_t const statusLogWrites = 100;
+
+}
+
+namespace lsst::qserv::qmeta {
+
+QStatusWriter::QStatusWriter(QStatus::Ptr const& qStatus, size_t maxUpdates, chrono::milliseconds maxDelay)
+        : QStatus(),
+          _qStatus(qStatus),
+          _maxUpdates(max<size_t>(maxUpdates, 1)),
+          _maxDelay(maxDelay),
+          _thread(&QStatusWriter::_run, this) {}
+
+QStatusWriter::~QStatusWriter() {
+    {
+        lock_guard<mutex> lock(_mtx);
+        _stop = true;
+    }
+    _cv.notify_one();
+    _thread.join();
+}
+
+void QStatusWriter::queryStatsTmpRegister(QueryId queryId, int totalChunks) {
+    _qStatus->queryStatsTmpRegister(queryId, totalChunks);
+}
+
+void QStatusWriter::queryStatsTmpTotalUpdate(QueryId queryId, int totalChunks) {
+    _qStatus->queryStatsTmpTotalUpdate(queryId, totalChunks);
+}
+
+void QStatusWriter::queryStatsTmpChunkUpdate(QueryId queryId, int completedChunks) {
+    bool full = false;
+    {
+        lock_guard<mutex> lock(_mtx);
+        if (_queue.empty()) _oldest = chrono::steady_clock::now();
+        // Jobs complete on many threads, the updates may come out of order.
+        auto [iter, inserted] = _queue.emplace(queryId, completedChunks);
+        if (!inserted) iter->second = max(iter->second, completedChunks);
+        ++_updates;
+        _maxQueueDepth = max(_maxQueueDepth, _queue.size());
+        full = _queue.size() >= _maxUpdates;
+    }
+    if (full) _cv.notify_one();
+}
+
+void QStatusWriter::queryStatsTmpChunkUpdates(map<QueryId, int> const& completedChunks) {
+    for (auto const& [queryId, chunks] : completedChunks) {
+        queryStatsTmpChunkUpdate(queryId, chunks);
+    }
+}
+
+QStats QStatusWriter::queryStatsTmpGet(QueryId queryId) { return _qStatus->queryStatsTmpGet(queryId); }
+
+void QStatusWriter::queryStatsTmpRemove(QueryId queryId) {
+    {
+        lock_guard<mutex> lock(_mtx);
+        _queue.erase(queryId);
+    }
+    _qStatus->queryStatsTmpRemove(queryId);
+}
+
+void QStatusWriter::flush() { _writeQueue(); }
+
+size_t QStatusWriter::queueDepth() const {
+    lock_guard<mutex> lock(_mtx);
+    return _queue.size();
+}
+
+nlohmann::json QStatusWriter::statusToJson() const {
+    nlohmann::json status = nlohmann::json::object();
+    lock_guard<mutex> lock(_mtx);
+    status["maxUpdates"] = _maxUpdates;
+    status["maxDelayMs"] = _maxDelay.count();
+    status["queueDepth"] = _queue.size();
+    status["maxQueueDepth"] = _maxQueueDepth;
+    status["updates"] = _updates;
+    status["writes"] = _writes;
+    status["rows"] = _rows;
+    status["failures"] = _failures;
+    status["lastWriteSecs"] = _lastWriteSecs;
+    status["maxWriteSecs"] = _maxWriteSecs;
+    status["lastFlushSecs"] = _lastFlushSecs;
+    status["maxFlushSecs"] = _maxFlushSecs;
+    return status;
+}
+
+void QStatusWriter::_run() {
+    unique_lock<mutex> lock(_mtx);
+    while (true) {
+        if (_queue.empty()) {
+            if (_stop) break;
+            _cv.wait(lock, [this]() { return _stop || !_queue.empty(); });
+            continue;
+        }
+        _cv.wait_until(lock, _oldest + _maxDelay, [this]() { return _stop || _queue.size() >= _maxUpdates; });
+        lock.unlock();
+        _writeQueue();
+        lock.lock();
+    }
+}
+
+void QStatusWriter::_writeQueue() {
+    lock_guard<mutex> writeLock(_writeMtx);
+    map<QueryId, int> batch;
+    chrono::steady_clock::time_point oldest;
+    {
+        lock_guard<mutex> lock(_mtx);
+        batch.swap(_queue);
+        oldest = _oldest;
+    }
+    if (batch.empty()) return;
+
+    auto const start = chrono::steady_clock::now();
+    bool failed = false;
+    try {
+        _qStatus->queryStatsTmpChunkUpdates(batch);
+    } catch (SqlError const& ex) {
+        // Only progress is lost, the next updates of the queries replace it.
+        LOGS(_log, LOG_LVL_WARN,
+             "Failed to update QStatsTmp for " << batch.size() << " queries " << ex.what());
+        failed = true;
+    }
+    auto const end = chrono::steady_clock::now();
+    chrono::duration<double> const secs = end - start;
+    chrono::duration<double> const flushSecs = end - oldest;
+    LOGS(_log, LOG_LVL_DEBUG,
+         "Wrote QStatsTmp updates of " << batch.size() << " queries in " << secs.count() << " s");
+
+    bool logStatus = false;
+    {
+        lock_guard<mutex> lock(_mtx);
+        ++_writes;
+        if (failed) {
+            ++_failures;
+        } else {
+            _rows += batch.size();
+        }
+        _lastWriteSecs = secs.count();
+        _maxWriteSecs = max(_maxWriteSecs, _lastWriteSecs);
+        _lastFlushSecs = flushSecs.count();
+        _maxFlushSecs = max(_maxFlushSecs, _lastFlushSecs);
+        logStatus = _writes % statusLogWrites == 0;
+    }
+    if (logStatus) LOGS(_log, LOG_LVL_INFO, "QStatusWriter status " << statusToJson().dump());
+}
+
+}  // namespace lsst::qserv::qmeta
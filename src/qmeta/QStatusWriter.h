@@ -0,0 +1,132 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_QMETA_QSTATUSWRITER_H
+#define LSST_QSERV_QMETA_QSTATUSWRITER_H
+
+// System headers
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Third party headers
+#include "nlohmann/json.hpp"
+
+// Qserv headers
+#include "qmeta/QStatus.h"
+
+namespace lsst::qserv::qmeta {
+
+/// QStatusWriter is a QStatus that writes chunk completion updates behind
+/// the threads reporting them. The updates are kept per query, only the
+/// latest one of each query is written, and a background thread writes
+/// all the queries in one statement when 'maxUpdates' queries are waiting
+/// or the oldest waiting update is 'maxDelay' old, whichever comes first.
+/// The other calls are passed on to the wrapped QStatus right away.
+///
+/// The table is only a progress report (an in memory table), so the updates
+/// waiting when the czar dies are lost, as is a batch that fails to be
+/// written. The next update of a query replaces them, and the row of a query
+/// is removed when the query finishes anyway. queryStatsTmpGet() may
+/// return a count that is up to 'maxDelay' old.
+class QStatusWriter : public QStatus {
+public:
+    typedef std::shared_ptr<QStatusWriter> Ptr;
+
+    /// @param qStatus - where the updates are written.
+    /// @param maxUpdates - the number of waiting queries that triggers a write.
+    /// @param maxDelay - the longest an update waits before being written.
+    QStatusWriter(QStatus::Ptr const& qStatus, size_t maxUpdates, std::chrono::milliseconds maxDelay);
+
+    QStatusWriter() = delete;
+    QStatusWriter(QStatusWriter const&) = delete;
+    QStatusWriter& operator=(QStatusWriter const&) = delete;
+
+    /// Write the waiting updates and stop the background thread.
+    ~QStatusWriter() override;
+
+    /// @see QStatus::queryStatsTmpRegister(QueryId queryId, int totalChunks)
+    void queryStatsTmpRegister(QueryId queryId, int totalChunks) override;
+
+    /// @see QStatus::queryStatsTmpTotalUpdate(QueryId queryId, int totalChunks)
+    void queryStatsTmpTotalUpdate(QueryId queryId, int totalChunks) override;
+
+    /// Queue the update, it never waits for the database.
+    /// @see QStatus::queryStatsTmpChunkUpdate(QueryId queryId, int completedChunks)
+    void queryStatsTmpChunkUpdate(QueryId queryId, int completedChunks) override;
+
+    /// @see QStatus::queryStatsTmpChunkUpdates(std::map<QueryId, int> const&)
+    void queryStatsTmpChunkUpdates(std::map<QueryId, int> const& completedChunks) override;
+
+    /// @see QStatus::queryStatsTmpGet(QueryId queryId)
+    QStats queryStatsTmpGet(QueryId queryId) override;
+
+    /// Drop the waiting update of the query, then remove its row.
+    /// @see QStatus::queryStatsTmpRemove(QueryId queryId)
+    void queryStatsTmpRemove(QueryId queryId) override;
+
+    /// Write the waiting updates now.
+    void flush();
+
+    /// @return the number of queries with an update waiting.
+    size_t queueDepth() const;
+
+    /// @return a JSON object with the counters of the writer.
+    nlohmann::json statusToJson() const;
+
+private:
+    void _run();
+
+    /// Take the waiting updates and write them in one statement.
+    void _writeQueue();
+
+    QStatus::Ptr const _qStatus;
+    size_t const _maxUpdates;
+    std::chrono::milliseconds const _maxDelay;
+
+    /// Held while taking and writing a batch, so that batches are written
+    /// in the order they were taken and counts never go back.
+    std::mutex _writeMtx;
+
+    mutable std::mutex _mtx;      ///< Protects all members below.
+    std::condition_variable _cv;  ///< Wakes up the background thread.
+    std::map<QueryId, int> _queue;  ///< Waiting updates by queryId.
+    std::chrono::steady_clock::time_point _oldest;  ///< When the oldest waiting update was queued.
+    bool _stop = false;           ///< Set to stop the background thread.
+    uint64_t _updates = 0;        ///< Updates queued.
+    uint64_t _writes = 0;         ///< Statements written.
+    uint64_t _rows = 0;           ///< Query rows written.
+    uint64_t _failures = 0;       ///< Statements that failed.
+    double _lastWriteSecs = 0.0;  ///< Time it took to write the last statement.
+    double _maxWriteSecs = 0.0;   ///< Longest time it took to write a statement.
+    double _lastFlushSecs = 0.0;  ///< Time from the oldest update of the last statement until written.
+    double _maxFlushSecs = 0.0;   ///< Longest time from an update being queued until written.
+    size_t _maxQueueDepth = 0;    ///< Most queries waiting at once.
+
+    std::thread _thread;  ///< Writes the updates, must be last.
+};
+
+}  // namespace lsst::qserv::qmeta
+
+#endif  // LSST_QSERV_QMETA_QSTATUSWRITER_H
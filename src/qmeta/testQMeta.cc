@@ -400,6 +400,14 @@ BOOST_AUTO_TEST_CASE(messWithQueryStats) {
     BOOST_CHECK(qStats.totalChunks == totalChunks);
     BOOST_CHECK(qStats.completedChunks == completedChunks);
 
+    totalChunks = 104;
+    LOGS(_log, LOG_LVL_WARN, "messWithQueryStats total update");
+    qStatus->queryStatsTmpTotalUpdate(qid1, totalChunks);
+
+    qStats = qStatus->queryStatsTmpGet(qid1);
+    BOOST_CHECK(qStats.totalChunks == totalChunks);
+    BOOST_CHECK(qStats.completedChunks == completedChunks);
+
     LOGS(_log, LOG_LVL_WARN, "messWithQueryStats remove");
     qStatus->queryStatsTmpRemove(qid1);
 
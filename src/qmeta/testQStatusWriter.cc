@@ -0,0 +1,160 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// System headers
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Qserv headers
+#include "qmeta/Exceptions.h"
+#include "qmeta/QStatusWriter.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE QStatusWriter
+#include <boost/test/unit_test.hpp>
+
+namespace test = boost::test_tools;
+
+using namespace lsst::qserv;
+using namespace std::chrono_literals;
+
+namespace {
+
+/// A QStatus that remembers what it's asked to write.
+class FakeQStatus : public qmeta::QStatus {
+public:
+    void queryStatsTmpRegister(QueryId queryId, int totalChunks) override {
+        std::lock_guard<std::mutex> lock(mtx);
+        completed[queryId] = 0;
+    }
+
+    void queryStatsTmpTotalUpdate(QueryId queryId, int totalChunks) override {}
+
+    void queryStatsTmpChunkUpdate(QueryId queryId, int completedChunks) override {
+        queryStatsTmpChunkUpdates({{queryId, completedChunks}});
+    }
+
+    void queryStatsTmpChunkUpdates(std::map<QueryId, int> const& completedChunks) override {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (fail) throw qmeta::SqlError(ERR_LOC, sql::SqlErrorObject());
+        batches.push_back(completedChunks);
+        for (auto const& [queryId, chunks] : completedChunks) {
+            if (completed.count(queryId) != 0) completed[queryId] = chunks;
+        }
+    }
+
+    qmeta::QStats queryStatsTmpGet(QueryId queryId) override {
+        std::lock_guard<std::mutex> lock(mtx);
+        return qmeta::QStats(queryId, 100, completed.at(queryId), 0, 0);
+    }
+
+    void queryStatsTmpRemove(QueryId queryId) override {
+        std::lock_guard<std::mutex> lock(mtx);
+        completed.erase(queryId);
+    }
+
+    size_t batchCount() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return batches.size();
+    }
+
+    std::mutex mtx;
+    bool fail = false;
+    std::map<QueryId, int> completed;
+    std::vector<std::map<QueryId, int>> batches;
+};
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(Coalesce) {
+    auto fake = std::make_shared<FakeQStatus>();
+    qmeta::QStatusWriter writer(fake, 100, 1h);
+    for (QueryId queryId : {1, 2, 3}) writer.queryStatsTmpRegister(queryId, 100);
+    writer.queryStatsTmpChunkUpdate(1, 10);
+    writer.queryStatsTmpChunkUpdate(1, 30);
+    writer.queryStatsTmpChunkUpdate(1, 20);  // late, the count doesn't go back
+    writer.queryStatsTmpChunkUpdate(2, 5);
+    writer.queryStatsTmpChunkUpdate(3, 7);
+    BOOST_CHECK_EQUAL(writer.queueDepth(), 3u);
+    BOOST_CHECK_EQUAL(fake->batchCount(), 0u);
+
+    // Nothing is written for a query that is gone.
+    writer.queryStatsTmpRemove(3);
+    writer.flush();
+    BOOST_REQUIRE_EQUAL(fake->batchCount(), 1u);
+    BOOST_CHECK_EQUAL(fake->batches[0].size(), 2u);
+    BOOST_CHECK_EQUAL(writer.queryStatsTmpGet(1).completedChunks, 30);
+    BOOST_CHECK_EQUAL(writer.queryStatsTmpGet(2).completedChunks, 5);
+    BOOST_CHECK_EQUAL(writer.queueDepth(), 0u);
+
+    auto const status = writer.statusToJson();
+    BOOST_CHECK_EQUAL(status["updates"].get<uint64_t>(), 5u);
+    BOOST_CHECK_EQUAL(status["writes"].get<uint64_t>(), 1u);
+    BOOST_CHECK_EQUAL(status["rows"].get<uint64_t>(), 2u);
+    BOOST_CHECK_EQUAL(status["maxQueueDepth"].get<size_t>(), 3u);
+    // The updates waited in the queue before being written.
+    BOOST_CHECK_GE(status["lastFlushSecs"].get<double>(), status["lastWriteSecs"].get<double>());
+    BOOST_CHECK_EQUAL(status["maxFlushSecs"].get<double>(), status["lastFlushSecs"].get<double>());
+}
+
+BOOST_AUTO_TEST_CASE(Thresholds) {
+    auto fake = std::make_shared<FakeQStatus>();
+    {
+        // Written once enough queries are waiting.
+        qmeta::QStatusWriter writer(fake, 2, 1h);
+        writer.queryStatsTmpChunkUpdate(1, 1);
+        writer.queryStatsTmpChunkUpdate(2, 1);
+        for (int i = 0; i < 500 && fake->batchCount() == 0; ++i) std::this_thread::sleep_for(10ms);
+        BOOST_CHECK_EQUAL(fake->batchCount(), 1u);
+    }
+    {
+        // Written once the oldest update is old enough.
+        qmeta::QStatusWriter writer(fake, 100, 20ms);
+        writer.queryStatsTmpChunkUpdate(1, 2);
+        for (int i = 0; i < 500 && fake->batchCount() == 1; ++i) std::this_thread::sleep_for(10ms);
+        BOOST_CHECK_EQUAL(fake->batchCount(), 2u);
+    }
+    {
+        // Written when the writer goes away.
+        qmeta::QStatusWriter writer(fake, 100, 1h);
+        writer.queryStatsTmpChunkUpdate(1, 3);
+    }
+    BOOST_CHECK_EQUAL(fake->batchCount(), 3u);
+}
+
+BOOST_AUTO_TEST_CASE(Failure) {
+    auto fake = std::make_shared<FakeQStatus>();
+    fake->fail = true;
+    qmeta::QStatusWriter writer(fake, 100, 1h);
+    writer.queryStatsTmpChunkUpdate(1, 1);
+    BOOST_CHECK_NO_THROW(writer.flush());
+    BOOST_CHECK_EQUAL(writer.queueDepth(), 0u);
+    BOOST_CHECK_EQUAL(writer.statusToJson()["failures"].get<uint64_t>(), 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
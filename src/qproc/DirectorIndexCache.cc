@@ -0,0 +1,85 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "qproc/DirectorIndexCache.h"
+
+// System headers
+#include <algorithm>
+#include <numeric>
+
+namespace lsst::qserv::qproc {
+
+void DirectorIndexCache::add(std::int64_t key, std::int32_t chunkId, std::int32_t subChunkId) {
+    _keys.push_back(key);
+    _chunkIds.push_back(chunkId);
+    _subChunkIds.push_back(subChunkId);
+}
+
+void DirectorIndexCache::sort() {
+    if (std::is_sorted(_keys.begin(), _keys.end())) return;
+    std::vector<std::size_t> order(_keys.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [this](std::size_t a, std::size_t b) { return _keys[a] < _keys[b]; });
+    std::vector<std::int64_t> keys;
+    std::vector<std::int32_t> chunkIds, subChunkIds;
+    keys.reserve(order.size());
+    chunkIds.reserve(order.size());
+    subChunkIds.reserve(order.size());
+    for (auto i : order) {
+        keys.push_back(_keys[i]);
+        chunkIds.push_back(_chunkIds[i]);
+        subChunkIds.push_back(_subChunkIds[i]);
+    }
+    _keys.swap(keys);
+    _chunkIds.swap(chunkIds);
+    _subChunkIds.swap(subChunkIds);
+}
+
+std::size_t DirectorIndexCache::sizeBytes() const {
+    return _keys.capacity() * sizeof(std::int64_t) +
+           (_chunkIds.capacity() + _subChunkIds.capacity()) * sizeof(std::int32_t);
+}
+
+void DirectorIndexCache::lookup(std::vector<std::int64_t> keys, ChunkMap& chunks) const {
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    auto itr = _keys.begin();
+    for (auto key : keys) {
+        itr = std::lower_bound(itr, _keys.end(), key);
+        for (; itr != _keys.end() && *itr == key; ++itr) {
+            _add(itr - _keys.begin(), chunks);
+        }
+        if (itr == _keys.end()) break;
+    }
+}
+
+void DirectorIndexCache::lookupRange(std::int64_t minKey, std::int64_t maxKey, ChunkMap& chunks) const {
+    if (minKey > maxKey) return;
+    auto const end = std::upper_bound(_keys.begin(), _keys.end(), maxKey);
+    for (auto itr = std::lower_bound(_keys.begin(), end, minKey); itr != end; ++itr) {
+        _add(itr - _keys.begin(), chunks);
+    }
+}
+
+}  // namespace lsst::qserv::qproc
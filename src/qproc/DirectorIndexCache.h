@@ -0,0 +1,80 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_QPROC_DIRECTORINDEXCACHE_H
+#define LSST_QSERV_QPROC_DIRECTORINDEXCACHE_H
+
+// System headers
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace lsst::qserv::qproc {
+
+/**
+ *  DirectorIndexCache is an in-memory copy of the director index of a table,
+ *  which maps the integer keys of the director table to chunks and subchunks.
+ *
+ *  The keys, chunks and subchunks are kept in separate contiguous arrays sorted
+ *  by key, so a lookup only touches the array of keys until it finds a match.
+ *  Entries are added in any order, and sort() must be called before lookups.
+ */
+class DirectorIndexCache {
+public:
+    typedef std::shared_ptr<DirectorIndexCache> Ptr;
+
+    /// Chunks and their subchunks: [chunkId] -> subChunkIds
+    typedef std::map<int, std::vector<std::int32_t>> ChunkMap;
+
+    DirectorIndexCache() = default;
+    DirectorIndexCache(DirectorIndexCache const&) = delete;
+    DirectorIndexCache& operator=(DirectorIndexCache const&) = delete;
+
+    void add(std::int64_t key, std::int32_t chunkId, std::int32_t subChunkId);
+
+    /// Sort the entries by key.
+    void sort();
+
+    std::size_t size() const { return _keys.size(); }
+
+    /// @return the memory taken by the entries in bytes.
+    std::size_t sizeBytes() const;
+
+    /// Add the chunks and subchunks of the keys to 'chunks'. The keys are
+    /// looked up in the ascending order, each search starting where the
+    /// previous one has ended.
+    void lookup(std::vector<std::int64_t> keys, ChunkMap& chunks) const;
+
+    /// Add the chunks and subchunks of the keys within [minKey, maxKey] to 'chunks'.
+    void lookupRange(std::int64_t minKey, std::int64_t maxKey, ChunkMap& chunks) const;
+
+private:
+    void _add(std::size_t i, ChunkMap& chunks) const { chunks[_chunkIds[i]].push_back(_subChunkIds[i]); }
+
+    std::vector<std::int64_t> _keys;
+    std::vector<std::int32_t> _chunkIds;
+    std::vector<std::int32_t> _subChunkIds;
+};
+
+}  // namespace lsst::qserv::qproc
+
+#endif  // LSST_QSERV_QPROC_DIRECTORINDEXCACHE_H
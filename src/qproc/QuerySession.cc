@@ -42,6 +42,9 @@
 #include <sstream>
 #include <stdexcept>
 
+// Third-party headers
+#include "boost/algorithm/string/predicate.hpp"
+
 // LSST headers
 #include "lsst/log/Log.h"
 
@@ -64,15 +67,25 @@
 #include "qana/ScanTablePlugin.h"
 #include "qana/TablePlugin.h"
 #include "qana/WherePlugin.h"
+#include "qana/ZoneMapPlugin.h"
 #include "qproc/DatabaseModels.h"
 #include "qproc/QueryProcessingBug.h"
 #include "query/AreaRestrictor.h"
+#include "query/BoolFactor.h"
+#include "query/ColumnRef.h"
+#include "query/CompPredicate.h"
+#include "query/NullPredicate.h"
+#include "query/OrderByClause.h"
+#include "query/OrTerm.h"
 #include "query/QueryContext.h"
 #include "query/SecIdxRestrictor.h"
 #include "query/SelectList.h"
 #include "query/SelectStmt.h"
 #include "query/SelectList.h"
 #include "query/typedefs.h"
+#include "query/ValueExpr.h"
+#include "query/ValueFactor.h"
+#include "query/WhereClause.h"
 #include "sql/SqlException.h"
 #include "util/IterableFormatter.h"
 
@@ -91,6 +104,44 @@ std::string printParallel(lsst::qserv::query::SelectStmtPtrVector const& p) {
     return ret;
 }
 
+/// @return the condition that the first ORDER BY column of 'stmt' doesn't sort after 'bound', or
+///         nullptr if 'stmt' isn't an ORDER BY ... LIMIT of rows whose first ORDER BY term is a column.
+std::shared_ptr<lsst::qserv::query::BoolTerm> makeOrderByBoundTerm(lsst::qserv::query::SelectStmt const& stmt,
+                                                                    std::string const& bound) {
+    namespace query = lsst::qserv::query;
+    if (!stmt.hasOrderBy() || !stmt.hasLimit() || stmt.hasGroupBy() || stmt.hasHaving() ||
+        stmt.getDistinct()) {
+        return nullptr;
+    }
+    auto const& terms = *stmt.getOrderBy().getTerms();
+    if (terms.empty() || terms.front().getExpr() == nullptr) return nullptr;
+    auto column = terms.front().getExpr();
+    auto const columnRef = column->getColumnRef();
+    if (columnRef == nullptr) return nullptr;
+    for (auto const& expr : *stmt.getSelectList().getValueExprList()) {
+        if (expr == nullptr || expr->hasAggregation()) return nullptr;
+        // ORDER BY names are resolved to select list aliases first, which can't be used in WHERE.
+        if (columnRef->getTableAlias().empty() && columnRef->getTable().empty() &&
+            boost::algorithm::iequals(expr->getAlias(), columnRef->getColumn())) {
+            if (expr->getColumnRef() == nullptr) return nullptr;
+            column = expr;
+        }
+    }
+    auto const left = column->clone();
+    left->setAlias("");
+    bool const descending = terms.front().getOrder() == query::OrderByTerm::DESC;
+    auto const compPred = std::make_shared<query::CompPredicate>(
+            left,
+            descending ? query::CompPredicate::GREATER_THAN_OR_EQUALS_OP
+                       : query::CompPredicate::LESS_THAN_OR_EQUALS_OP,
+            query::ValueExpr::newSimple(query::ValueFactor::newConstFactor(bound)));
+    if (descending) return std::make_shared<query::BoolFactor>(compPred);
+    // NULL sorts before all values in ascending order.
+    auto const nullPred = std::make_shared<query::NullPredicate>(left->clone(), false);
+    return std::make_shared<query::OrTerm>(std::vector<std::shared_ptr<query::BoolTerm>>{
+            std::make_shared<query::BoolFactor>(compPred), std::make_shared<query::BoolFactor>(nullPred)});
+}
+
 #define LOG_STATEMENTS(LEVEL, PRETEXT)                                                                      \
     LOGS(_log, LEVEL,                                                                                       \
          '\n' << "  " << PRETEXT << '\n'                                                                    \
@@ -178,6 +229,10 @@ query::SecIdxRestrictorVecPtr QuerySession::getSecIdxRestrictors() const {
     return _context->secIdxRestrictors;
 }
 
+query::ZoneMapRestrictorVecPtr QuerySession::getZoneMapRestrictors() const {
+    return _context->zoneMapRestrictors;
+}
+
 std::string QuerySession::getResultOrderBy() const {
     std::string orderBy;
     if (_stmt->hasOrderBy()) {
@@ -285,6 +340,7 @@ void QuerySession::_preparePlugins() {
     _plugins->push_back(std::make_shared<qana::AggregatePlugin>());
     _plugins->push_back(std::make_shared<qana::TablePlugin>());
     _plugins->push_back(std::make_shared<qana::MatchTablePlugin>());
+    _plugins->push_back(std::make_shared<qana::ZoneMapPlugin>());
     _plugins->push_back(std::make_shared<qana::QservRestrictorPlugin>());
     _plugins->push_back(std::make_shared<qana::PostPlugin>());
     _plugins->push_back(std::make_shared<qana::ScanTablePlugin>(_interactiveChunkLimit));
@@ -378,6 +434,31 @@ std::vector<query::QueryTemplate> QuerySession::makeQueryTemplates() {
     return queryTemplates;
 }
 
+std::vector<query::QueryTemplate> QuerySession::makeQueryTemplates(std::string const& orderByBound) {
+    std::vector<query::QueryTemplate> queryTemplates;
+    for (auto const& parallelStmt : _stmtParallel) {
+        auto const term = makeOrderByBoundTerm(*parallelStmt, orderByBound);
+        if (term == nullptr) return std::vector<query::QueryTemplate>();
+        auto stmt = parallelStmt->clone();
+        try {
+            if (stmt->hasWhereClause()) {
+                stmt->getWhereClause().prependAndTerm(term);
+            } else {
+                auto where = std::make_shared<query::WhereClause>();
+                where->prependAndTerm(term);
+                stmt->setWhereClause(where);
+            }
+        } catch (std::logic_error const& e) {
+            LOGS(_log, LOG_LVL_DEBUG,
+                 "can't add ORDER BY bound to " << parallelStmt->getQueryTemplate().sqlFragment() << ": "
+                                                << e.what());
+            return std::vector<query::QueryTemplate>();
+        }
+        queryTemplates.push_back(stmt->getQueryTemplate());
+    }
+    return queryTemplates;
+}
+
 std::vector<std::string> QuerySession::_buildChunkQueries(query::QueryTemplate::Vect const& queryTemplates,
                                                           ChunkSpec const& chunkSpec) const {
     std::vector<std::string> chunkQueries;
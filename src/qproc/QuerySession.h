@@ -105,6 +105,11 @@ public:
      */
     query::SecIdxRestrictorVecPtr getSecIdxRestrictors() const;
 
+    /**
+     * @brief Get the restrictors used for skipping chunks by their zone maps.
+     */
+    query::ZoneMapRestrictorVecPtr getZoneMapRestrictors() const;
+
     void addChunk(ChunkSpec const& cs);
     void setDummy();
 
@@ -172,6 +177,13 @@ public:
 
     query::QueryTemplate::Vect makeQueryTemplates();
 
+    /// Build the templates for the worker queries of an ORDER BY ... LIMIT query
+    /// with the first ORDER BY column restricted to values that don't sort after
+    /// 'orderByBound', as rows that sort after it can't be in the result.
+    /// @see rproc::InfileMerger::getTopKBound()
+    /// @return the templates, or an empty vector if the worker queries can't be restricted.
+    query::QueryTemplate::Vect makeQueryTemplates(std::string const& orderByBound);
+
     void setScanInteractive();
     bool getScanInteractive() const { return _scanInteractive; }
 
@@ -33,6 +33,11 @@
 
 // System headers
 #include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <limits>
+#include <map>
+#include <mutex>
 
 // LSST headers
 #include "lsst/log/Log.h"
@@ -44,10 +49,14 @@
 #include "global/intTypes.h"
 #include "global/constants.h"
 #include "global/stringUtil.h"
+#include "query/BetweenPredicate.h"
 #include "query/ColumnRef.h"
 #include "query/CompPredicate.h"
+#include "query/InPredicate.h"
 #include "query/SecIdxRestrictor.h"
+#include "query/ValueExpr.h"
 #include "qproc/ChunkSpec.h"
+#include "qproc/DirectorIndexCache.h"
 #include "sql/SqlConnection.h"
 #include "sql/SqlConnectionFactory.h"
 #include "util/Bug.h"
@@ -57,6 +66,97 @@ namespace {
 
 LOG_LOGGER _log = LOG_GET("lsst.qserv.qproc.SecondaryIndex");
 
+using namespace lsst::qserv;
+
+/// The integer keys and the inclusive ranges of keys selected by a restrictor.
+struct Keys {
+    std::vector<std::int64_t> values;
+    std::vector<std::pair<std::int64_t, std::int64_t>> ranges;
+};
+
+/// @return true if 'valueExpr' is an integer literal, which is stored in 'value'.
+bool constKey(std::shared_ptr<query::ValueExpr const> const& valueExpr, std::int64_t& value) {
+    if (valueExpr == nullptr || !valueExpr->isConstVal()) return false;
+    std::string const str = valueExpr->getConstVal();
+    char const* const end = str.data() + str.size();
+    auto const result = std::from_chars(str.data(), end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+/// @return false if the restrictor selects keys which can't be found in memory,
+///         such as the ones compared with non-integer literals, or with NOT.
+bool toKeys(query::SecIdxRestrictor const& restrictor, Keys& keys) {
+    std::int64_t const minKey = std::numeric_limits<std::int64_t>::min();
+    std::int64_t const maxKey = std::numeric_limits<std::int64_t>::max();
+    if (auto const inRestrictor = dynamic_cast<query::SecIdxInRestrictor const*>(&restrictor)) {
+        auto const& inPredicate = inRestrictor->getInPredicate();
+        if (inPredicate->hasNot) return false;
+        for (auto const& cand : inPredicate->cands) {
+            std::int64_t value;
+            if (!constKey(cand, value)) return false;
+            keys.values.push_back(value);
+        }
+        return true;
+    }
+    if (auto const betweenRestrictor = dynamic_cast<query::SecIdxBetweenRestrictor const*>(&restrictor)) {
+        auto const& betweenPredicate = betweenRestrictor->getBetweenPredicate();
+        std::int64_t lower, upper;
+        if (betweenPredicate->hasNot || !constKey(betweenPredicate->minValue, lower) ||
+            !constKey(betweenPredicate->maxValue, upper)) {
+            return false;
+        }
+        keys.ranges.emplace_back(lower, upper);
+        return true;
+    }
+    if (auto const compRestrictor = dynamic_cast<query::SecIdxCompRestrictor const*>(&restrictor)) {
+        auto const& compPredicate = compRestrictor->getCompPredicate();
+        bool const columnOnLeft = compPredicate->left->isColumnRef();
+        std::int64_t value;
+        if (!constKey(columnOnLeft ? compPredicate->right : compPredicate->left, value)) return false;
+        // "5 < objectId" is "objectId > 5"
+        auto op = compPredicate->op;
+        if (!columnOnLeft) {
+            switch (op) {
+                case query::CompPredicate::LESS_THAN_OP:
+                    op = query::CompPredicate::GREATER_THAN_OP;
+                    break;
+                case query::CompPredicate::GREATER_THAN_OP:
+                    op = query::CompPredicate::LESS_THAN_OP;
+                    break;
+                case query::CompPredicate::LESS_THAN_OR_EQUALS_OP:
+                    op = query::CompPredicate::GREATER_THAN_OR_EQUALS_OP;
+                    break;
+                case query::CompPredicate::GREATER_THAN_OR_EQUALS_OP:
+                    op = query::CompPredicate::LESS_THAN_OR_EQUALS_OP;
+                    break;
+                default:
+                    break;
+            }
+        }
+        switch (op) {
+            case query::CompPredicate::EQUALS_OP:
+            case query::CompPredicate::NULL_SAFE_EQUALS_OP:
+                keys.values.push_back(value);
+                return true;
+            case query::CompPredicate::LESS_THAN_OP:
+                if (value != minKey) keys.ranges.emplace_back(minKey, value - 1);
+                return true;
+            case query::CompPredicate::LESS_THAN_OR_EQUALS_OP:
+                keys.ranges.emplace_back(minKey, value);
+                return true;
+            case query::CompPredicate::GREATER_THAN_OP:
+                if (value != maxKey) keys.ranges.emplace_back(value + 1, maxKey);
+                return true;
+            case query::CompPredicate::GREATER_THAN_OR_EQUALS_OP:
+                keys.ranges.emplace_back(value, maxKey);
+                return true;
+            default:
+                return false;
+        }
+    }
+    return false;
+}
+
 }  // anonymous namespace
 
 namespace lsst::qserv::qproc {
@@ -126,6 +226,193 @@ private:
     std::shared_ptr<sql::SqlConnection> _sqlConnection;
 };
 
+/**
+ *  CachingBackend looks up integer keys in memory copies of the director index
+ *  tables, and everything else in MySQL. A table is loaded on its first lookup
+ *  if it fits into what is left of the limit on the entries kept in memory.
+ *  Every checkIvalSecs a lookup checks if the table has been created or modified
+ *  since it was loaded, and loads it again if it has. Tables modified in the last
+ *  seconds, which may still be being loaded, are looked up in MySQL. A table which
+ *  couldn't be loaded isn't read again until it's modified, or until more entries
+ *  are left for it.
+ */
+class CachingBackend : public SecondaryIndex::Backend {
+public:
+    CachingBackend(mysql::MySqlConfig const& c, std::size_t maxRows, int checkIvalSecs)
+            : _mySqlBackend(c),
+              _sqlConnection(sql::SqlConnectionFactory::make(c)),
+              _maxRows(maxRows),
+              _checkIval(std::chrono::seconds(checkIvalSecs)) {}
+
+    ChunkSpecVector lookup(query::SecIdxRestrictorVec const& restrictors) override {
+        ChunkSpecVector output;
+        query::SecIdxRestrictorVec mySqlRestrictors;
+        for (auto const& secIdxRestrictor : restrictors) {
+            ::Keys keys;
+            DirectorIndexCache::Ptr cache;
+            if (::toKeys(*secIdxRestrictor, keys)) {
+                auto const& secondaryIndexCol = secIdxRestrictor->getSecIdxColumnRef();
+                cache = _getCache(secondaryIndexCol->getDb(), secondaryIndexCol->getTable(),
+                                  secondaryIndexCol->getColumn());
+            }
+            if (cache == nullptr) {
+                mySqlRestrictors.push_back(secIdxRestrictor);
+                continue;
+            }
+            DirectorIndexCache::ChunkMap chunks;
+            cache->lookup(keys.values, chunks);
+            for (auto const& range : keys.ranges) {
+                cache->lookupRange(range.first, range.second, chunks);
+            }
+            for (auto const& chunk : chunks) {
+                output.push_back(ChunkSpec(chunk.first, chunk.second));
+            }
+        }
+        if (!mySqlRestrictors.empty()) {
+            ChunkSpecVector const mySqlOutput = _mySqlBackend.lookup(mySqlRestrictors);
+            output.insert(output.end(), mySqlOutput.begin(), mySqlOutput.end());
+        }
+        normalize(output);
+        return output;
+    }
+
+private:
+    struct Table {
+        DirectorIndexCache::Ptr cache;  ///< nullptr if the table is looked up in MySQL.
+        std::string version;            ///< The creation and modification times of the table.
+        std::chrono::steady_clock::time_point checked;
+        bool loading = false;  ///< The table is being checked or loaded by some lookup.
+        std::string rejectedVersion;      ///< The version which couldn't be loaded.
+        std::size_t rejectedMaxRows = 0;  ///< The entries which were left for the rejected version.
+    };
+
+    /// @return the memory copy of the table, or nullptr if it's looked up in MySQL.
+    ///   The table is checked and loaded without blocking other lookups, which
+    ///   meanwhile use the copy loaded before, if it hasn't changed, or MySQL.
+    DirectorIndexCache::Ptr _getCache(std::string const& db, std::string const& table,
+                                      std::string const& column) {
+        std::string const indexTable = sanitizeName(db) + "__" + sanitizeName(table);
+        std::unique_lock<std::mutex> lock(_mtx);
+        auto& entry = _tables[indexTable];
+        auto const now = std::chrono::steady_clock::now();
+        if (entry.loading ||
+            (entry.checked != std::chrono::steady_clock::time_point() && now - entry.checked < _checkIval)) {
+            return entry.cache;
+        }
+        entry.checked = now;
+        entry.loading = true;
+        try {
+            lock.unlock();
+            std::string version;
+            bool const stable = _getVersion(indexTable, version);
+            lock.lock();
+            if (!stable || entry.version != version) _release(entry);
+            std::size_t const maxRows = _maxRows > _rows ? _maxRows - _rows : 0;
+            // A rejected table is loaded again once it changes, or if more entries
+            // are left for it than when it was rejected.
+            bool const rejected = entry.rejectedVersion == version && maxRows <= entry.rejectedMaxRows;
+            if (!stable || entry.cache != nullptr || rejected) {
+                entry.loading = false;
+                return entry.cache;
+            }
+            lock.unlock();
+            bool integerKeys = true;
+            auto const cache = _load(indexTable, column, maxRows, integerKeys);
+            lock.lock();
+            if (cache == nullptr) {
+                entry.rejectedVersion = version;
+                entry.rejectedMaxRows = integerKeys ? maxRows : std::numeric_limits<std::size_t>::max();
+            } else if (_rows + cache->size() <= _maxRows) {
+                // Other tables may have been loaded meanwhile.
+                entry.cache = cache;
+                entry.version = version;
+                _rows += cache->size();
+            }
+        } catch (std::exception const& ex) {
+            if (!lock.owns_lock()) lock.lock();
+            LOGS(_log, LOG_LVL_WARN, "failed to load director index " << indexTable << ": " << ex.what());
+            _release(entry);
+        }
+        entry.loading = false;
+        return entry.cache;
+    }
+
+    void _release(Table& entry) {
+        if (entry.cache != nullptr) _rows -= entry.cache->size();
+        entry.cache = nullptr;
+        entry.version.clear();
+    }
+
+    /// @return false if the table doesn't exist or was modified in the last seconds.
+    bool _getVersion(std::string const& indexTable, std::string& version) {
+        std::lock_guard<std::mutex> lock(_connMtx);
+        std::string const sql =
+                "SELECT IFNULL(`CREATE_TIME`, ''), IFNULL(`UPDATE_TIME`, ''), "
+                "IFNULL(TIMESTAMPDIFF(SECOND, IFNULL(`UPDATE_TIME`, `CREATE_TIME`), NOW()), 0) "
+                "FROM `information_schema`.`TABLES` WHERE `TABLE_SCHEMA`='" +
+                std::string(SEC_INDEX_DB) + "' AND `TABLE_NAME`='" +
+                _sqlConnection->escapeString(indexTable) + "'";
+        bool found = false;
+        int ageSecs = 0;
+        for (std::shared_ptr<sql::SqlResultIter> results = _sqlConnection->getQueryIter(sql);
+             not results->done(); ++(*results)) {
+            StringVector const& row = **results;
+            version = row[0] + "/" + row[1];
+            ageSecs = std::stoi(row[2]);
+            found = true;
+        }
+        return found && ageSecs >= 2;
+    }
+
+    /// @return the memory copy of the table, or nullptr if the table has keys
+    ///         which are not integers (then 'integerKeys' is set to false),
+    ///         or if it has more entries than are left.
+    DirectorIndexCache::Ptr _load(std::string const& indexTable, std::string const& column,
+                                  std::size_t maxRows, bool& integerKeys) {
+        std::lock_guard<std::mutex> lock(_connMtx);
+        auto const start = std::chrono::steady_clock::now();
+        std::string const sql = "SELECT `" + column + "`, `" + CHUNK_COLUMN + "`, `" + SUB_CHUNK_COLUMN +
+                                "` FROM `" + SEC_INDEX_DB + "`.`" + indexTable + "`";
+        auto cache = std::make_shared<DirectorIndexCache>();
+        for (std::shared_ptr<sql::SqlResultIter> results = _sqlConnection->getQueryIter(sql);
+             not results->done(); ++(*results)) {
+            StringVector const& row = **results;
+            if (cache->size() >= maxRows) {
+                LOGS(_log, LOG_LVL_INFO,
+                     "director index " << indexTable << " has more than " << maxRows
+                                       << " entries left for it in memory, using MySQL");
+                return nullptr;
+            }
+            std::int64_t key;
+            char const* const end = row[0].data() + row[0].size();
+            auto const result = std::from_chars(row[0].data(), end, key);
+            if (result.ec != std::errc() || result.ptr != end) {
+                LOGS(_log, LOG_LVL_INFO,
+                     "director index " << indexTable << " has non-integer keys, using MySQL");
+                integerKeys = false;
+                return nullptr;
+            }
+            cache->add(key, std::stoi(row[1]), std::stoi(row[2]));
+        }
+        cache->sort();
+        std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+        LOGS(_log, LOG_LVL_INFO,
+             "director index " << indexTable << " loaded into memory, entries: " << cache->size()
+                               << " bytes: " << cache->sizeBytes() << " seconds: " << elapsed.count());
+        return cache;
+    }
+
+    MySqlBackend _mySqlBackend;  ///< For the lookups which can't be done in memory.
+    std::mutex _connMtx;         ///< Protects the connection.
+    std::shared_ptr<sql::SqlConnection> _sqlConnection;
+    std::size_t const _maxRows;
+    std::chrono::steady_clock::duration const _checkIval;
+
+    std::mutex _mtx;  ///< Protects the members below.
+    std::map<std::string, Table> _tables;
+    std::size_t _rows = 0;  ///< The entries in memory.
+};
+
 class FakeBackend : public SecondaryIndex::Backend {
 public:
     FakeBackend() {}
@@ -150,7 +437,14 @@ private:
     }
 };
 
-SecondaryIndex::SecondaryIndex(mysql::MySqlConfig const& c) : _backend(std::make_shared<MySqlBackend>(c)) {}
+SecondaryIndex::SecondaryIndex(mysql::MySqlConfig const& c, std::size_t cacheMaxRows,
+                               int cacheCheckIvalSecs) {
+    if (cacheMaxRows > 0) {
+        _backend = std::make_shared<CachingBackend>(c, cacheMaxRows, cacheCheckIvalSecs);
+    } else {
+        _backend = std::make_shared<MySqlBackend>(c);
+    }
+}
 
 SecondaryIndex::SecondaryIndex() : _backend(std::make_shared<FakeBackend>()) {}
 
@@ -31,6 +31,7 @@
  */
 
 // System headers
+#include <cstddef>
 #include <memory>
 #include <stdexcept>
 
@@ -49,7 +50,15 @@ namespace lsst::qserv::qproc {
  */
 class SecondaryIndex {
 public:
-    explicit SecondaryIndex(mysql::MySqlConfig const& c);
+    /** Construct an instance looking up the index in MySQL
+     *
+     *  @param cacheMaxRows  The total number of entries of the director index
+     *                       tables with integer keys kept in memory, 0 for none.
+     *  @param cacheCheckIvalSecs  How often the tables kept in memory are checked
+     *                       for changes in MySQL.
+     */
+    explicit SecondaryIndex(mysql::MySqlConfig const& c, std::size_t cacheMaxRows = 0,
+                            int cacheCheckIvalSecs = 10);
 
     /** Construct a fake instance
      *
@@ -33,6 +33,8 @@
 #include "qproc/TaskMsgFactory.h"
 
 // System headers
+#include <algorithm>
+#include <cstring>
 #include <stdexcept>
 
 // Third-party headers
@@ -42,12 +44,19 @@
 
 // Qserv headers
 #include "global/intTypes.h"
+#include "proto/ColumnarResult.h"
+#include "proto/FrameBuffer.h"
+#include "proto/TaskMsgTemplate.h"
 #include "qmeta/types.h"
 #include "qproc/ChunkQuerySpec.h"
+#include "util/StringHash.h"
 #include "util/common.h"
 
 namespace {
 LOG_LOGGER _log = LOG_GET("lsst.qserv.qproc.TaskMsgFactory");
+
+/// Most templates kept for a query, see TaskMsgFactory::setWorkerLookup().
+size_t const maxTemplates = 100;
 }
 
 namespace lsst::qserv::qproc {
@@ -64,6 +73,14 @@ std::shared_ptr<proto::TaskMsg> TaskMsgFactory::_makeMsg(ChunkQuerySpec const& c
     taskMsg->set_session(_session);
     taskMsg->set_db(chunkQuerySpec.db);
     taskMsg->set_protocol(2);
+    // Workers that know about column-based results may use them, older ones keep sending rows.
+    taskMsg->set_maxprotocol(proto::RESULT_PROTOCOL_COLUMNS);
+    // CRC32C costs far less CPU than MD5 on both sides for large results.
+    taskMsg->set_resultchecksum(proto::ProtoHeader::CRC32C);
+    if (_resultCodec != proto::ProtoHeader::NONE) {
+        taskMsg->set_resultcodec(_resultCodec);
+        taskMsg->set_resultcompressmin(_resultCompressMin);
+    }
     taskMsg->set_queryid(queryId);
     taskMsg->set_jobid(jobId);
     taskMsg->set_attemptcount(attemptCount);
@@ -88,29 +105,37 @@ std::shared_ptr<proto::TaskMsg> TaskMsgFactory::_makeMsg(ChunkQuerySpec const& c
     // per-chunk
     taskMsg->set_chunkid(chunkQuerySpec.chunkId);
     // per-fragment
+    _addFragments(*taskMsg, resultTable, chunkQuerySpec);
+    return taskMsg;
+}
+
+void TaskMsgFactory::_addFragments(proto::TaskMsg& taskMsg, std::string const& resultTable,
+                                   ChunkQuerySpec const& chunkQuerySpec) {
+    _forEachFragment(chunkQuerySpec, [this, &taskMsg, &resultTable](DbTableSet const& subChunkTables,
+                                                                    std::vector<int> const& subChunkIds,
+                                                                    std::vector<std::string> const& queries) {
+        for (auto const& query : queries) {
+            LOGS(_log, LOG_LVL_TRACE, query);
+        }
+        _addFragment(taskMsg, resultTable, subChunkTables, subChunkIds, queries);
+    });
+}
+
+void TaskMsgFactory::_forEachFragment(ChunkQuerySpec const& chunkQuerySpec, FragmentFunc const& func) {
     // TODO refactor to simplify
     if (chunkQuerySpec.nextFragment.get()) {
         ChunkQuerySpec const* sPtr = &chunkQuerySpec;
         while (sPtr) {
             LOGS(_log, LOG_LVL_TRACE, "nextFragment");
-            for (unsigned int t = 0; t < (sPtr->queries).size(); t++) {
-                LOGS(_log, LOG_LVL_TRACE, (sPtr->queries).at(t));
-            }
             // Linked fragments will not have valid subChunkTables vectors,
             // So, we reuse the root fragment's vector.
-            _addFragment(*taskMsg, resultTable, chunkQuerySpec.subChunkTables, sPtr->subChunkIds,
-                         sPtr->queries);
+            func(chunkQuerySpec.subChunkTables, sPtr->subChunkIds, sPtr->queries);
             sPtr = sPtr->nextFragment.get();
         }
     } else {
         LOGS(_log, LOG_LVL_TRACE, "no nextFragment");
-        for (unsigned int t = 0; t < (chunkQuerySpec.queries).size(); t++) {
-            LOGS(_log, LOG_LVL_TRACE, (chunkQuerySpec.queries).at(t));
-        }
-        _addFragment(*taskMsg, resultTable, chunkQuerySpec.subChunkTables, chunkQuerySpec.subChunkIds,
-                     chunkQuerySpec.queries);
+        func(chunkQuerySpec.subChunkTables, chunkQuerySpec.subChunkIds, chunkQuerySpec.queries);
     }
-    return taskMsg;
 }
 
 void TaskMsgFactory::_addFragment(proto::TaskMsg& taskMsg, std::string const& resultName,
@@ -143,8 +168,184 @@ void TaskMsgFactory::_addFragment(proto::TaskMsg& taskMsg, std::string const& re
 void TaskMsgFactory::serializeMsg(ChunkQuerySpec const& s, std::string const& chunkResultName,
                                   QueryId queryId, int jobId, int attemptCount, qmeta::CzarId czarId,
                                   std::ostream& os) {
+    if (_workerLookup != nullptr) {
+        std::string const workerId = _workerLookup(s.db, s.chunkId);
+        if (!workerId.empty()) {
+            _serializeWithTemplate(s, chunkResultName, queryId, jobId, attemptCount, czarId, workerId, os);
+            return;
+        }
+    }
     std::shared_ptr<proto::TaskMsg> m = _makeMsg(s, chunkResultName, queryId, jobId, attemptCount, czarId);
     m->SerializeToOstream(&os);
 }
 
+bool TaskMsgFactory::_matchesTemplate(proto::TaskMsg const& tmpl, ChunkQuerySpec const& chunkQuerySpec,
+                                      std::string const& resultTable) {
+    auto const& scanInfo = chunkQuerySpec.scanInfo;
+    if (tmpl.db() != chunkQuerySpec.db || tmpl.scanpriority() != scanInfo.scanRating ||
+        tmpl.scaninteractive() != chunkQuerySpec.scanInteractive ||
+        tmpl.scantable_size() != static_cast<int>(scanInfo.infoTables.size())) {
+        return false;
+    }
+    for (int i = 0; i < tmpl.scantable_size(); ++i) {
+        auto const& scanTable = tmpl.scantable(i);
+        auto const& sTbl = scanInfo.infoTables[i];
+        if (scanTable.db() != sTbl.db || scanTable.table() != sTbl.table ||
+            scanTable.lockinmemory() != sTbl.lockInMemory || scanTable.scanrating() != sTbl.scanRating) {
+            return false;
+        }
+    }
+    int fragmentCount = 0;
+    bool matches = true;
+    _forEachFragment(chunkQuerySpec, [&](DbTableSet const& subChunkTables, std::vector<int> const&,
+                                         std::vector<std::string> const& queries) {
+        if (!matches || fragmentCount >= tmpl.fragment_size()) {
+            matches = false;
+            return;
+        }
+        auto const& fragment = tmpl.fragment(fragmentCount++);
+        auto const& tmplQueries = fragment.query();
+        auto const& dbTbls = fragment.subchunks().dbtbl();
+        matches = fragment.resulttable() == resultTable &&
+                  std::equal(queries.begin(), queries.end(), tmplQueries.begin(), tmplQueries.end()) &&
+                  std::equal(subChunkTables.begin(), subChunkTables.end(), dbTbls.begin(), dbTbls.end(),
+                             [](DbTable const& tbl, proto::TaskMsg_Subchunk_DbTbl const& dbTbl) {
+                                 return tbl.db == dbTbl.db() && tbl.table == dbTbl.tbl();
+                             });
+    });
+    return matches && fragmentCount == tmpl.fragment_size();
+}
+
+void TaskMsgFactory::_serializeWithTemplate(ChunkQuerySpec const& s, std::string const& chunkResultName,
+                                            QueryId queryId, int jobId, int attemptCount,
+                                            qmeta::CzarId czarId, std::string const& workerId,
+                                            std::ostream& os) {
+    std::string const resultTable = chunkResultName.empty() ? "Asdfasfd" : chunkResultName;
+    uint64_t templateId = 0;
+    bool workerHasTemplate = false;
+    {
+        std::lock_guard<std::mutex> lock(_templatesMtx);
+        for (auto const& tmpl : _templates) {
+            if (_matchesTemplate(tmpl->msg, s, resultTable)) {
+                templateId = tmpl->id;
+                workerHasTemplate = tmpl->workers.count(workerId) != 0;
+                break;
+            }
+        }
+    }
+
+    // Retries are always complete, the worker may have refused the message
+    // because it didn't have the template.
+    if (workerHasTemplate && attemptCount == 0) {
+        proto::TaskMsg compact;
+        compact.set_queryid(queryId);
+        compact.set_jobid(jobId);
+        compact.set_attemptcount(attemptCount);
+        compact.set_czarid(czarId);
+        compact.set_chunkid(s.chunkId);
+        compact.set_templateid(templateId);
+        bool hasSubChunks = false;
+        _forEachFragment(s, [&hasSubChunks](DbTableSet const&, std::vector<int> const& subChunkIds,
+                                            std::vector<std::string> const&) {
+            hasSubChunks = hasSubChunks || !subChunkIds.empty();
+        });
+        if (hasSubChunks) {
+            _forEachFragment(s, [&compact](DbTableSet const&, std::vector<int> const& subChunkIds,
+                                           std::vector<std::string> const&) {
+                auto ids = compact.add_fragment()->mutable_subchunks()->mutable_id();
+                for (int subChunkId : subChunkIds) ids->Add(subChunkId);
+            });
+        }
+        compact.SerializeToOstream(&os);
+        return;
+    }
+
+    std::shared_ptr<proto::TaskMsg> m = _makeMsg(s, chunkResultName, queryId, jobId, attemptCount, czarId);
+    if (templateId == 0) {
+        auto tmpl = std::make_unique<Template>();
+        proto::makeTaskMsgTemplate(*m, tmpl->msg);
+        std::string tmplStr;
+        tmpl->msg.SerializeToString(&tmplStr);
+        std::string const digest = util::StringHash::getMd5(tmplStr.data(), tmplStr.size());
+        std::memcpy(&tmpl->id, digest.data(), sizeof(tmpl->id));
+        std::lock_guard<std::mutex> lock(_templatesMtx);
+        // Queries that differ for every chunk don't use templates.
+        if (_templates.size() < maxTemplates) {
+            templateId = tmpl->id;
+            _templates.push_back(std::move(tmpl));
+        }
+    }
+    if (templateId != 0) {
+        // The worker is only known to have the template once it ran the message.
+        m->set_templateid(templateId);
+        std::lock_guard<std::mutex> lock(_templatesMtx);
+        _sentTemplates[std::make_pair(jobId, attemptCount)] = templateId;
+    }
+    m->SerializeToOstream(&os);
+}
+
+void TaskMsgFactory::markDelivered(int jobId, int attemptCount, std::string const& workerId) {
+    std::lock_guard<std::mutex> lock(_templatesMtx);
+    auto iter = _sentTemplates.find(std::make_pair(jobId, attemptCount));
+    if (iter == _sentTemplates.end()) return;
+    uint64_t const templateId = iter->second;
+    _sentTemplates.erase(iter);
+    for (auto const& tmpl : _templates) {
+        if (tmpl->id == templateId) {
+            tmpl->workers.insert(workerId);
+            break;
+        }
+    }
+}
+
+void TaskMsgFactory::forgetAttempt(int jobId, int attemptCount) {
+    std::lock_guard<std::mutex> lock(_templatesMtx);
+    _sentTemplates.erase(std::make_pair(jobId, attemptCount));
+}
+
+void TaskMsgFactory::serializeBatchMsg(ChunkQuerySpec const& s,
+                                       std::vector<std::shared_ptr<ChunkQuerySpec>> const& batchSpecs,
+                                       std::string const& chunkResultName, QueryId queryId, int jobId,
+                                       int attemptCount, qmeta::CzarId czarId, std::string& payload) {
+    std::shared_ptr<proto::TaskMsg> m = _makeMsg(s, chunkResultName, queryId, jobId, attemptCount, czarId);
+    for (auto const& spec : batchSpecs) {
+        proto::TaskMsg::BatchChunk* batchChunk = m->add_batchchunk();
+        batchChunk->set_chunkid(spec->chunkId);
+        proto::TaskMsg chunkMsg;
+        _addFragments(chunkMsg, chunkResultName, *spec);
+
+        // The queries only differ by the chunk and subchunk numbers, which the
+        // worker fills in, unless the chunk has a different number of fragments.
+        if (chunkMsg.fragment_size() != m->fragment_size()) {
+            *batchChunk->mutable_fragment() = chunkMsg.fragment();
+            continue;
+        }
+        bool sameQueries = true;
+        bool hasSubchunks = false;
+        for (int i = 0; i < chunkMsg.fragment_size(); ++i) {
+            auto const& queries = chunkMsg.fragment(i).query();
+            auto const& tmplQueries = m->fragment(i).query();
+            sameQueries = sameQueries && std::equal(queries.begin(), queries.end(), tmplQueries.begin(),
+                                                    tmplQueries.end());
+            hasSubchunks = hasSubchunks || chunkMsg.fragment(i).subchunks().id_size() > 0 ||
+                           m->fragment(i).subchunks().id_size() > 0;
+        }
+        if (!sameQueries) {
+            *batchChunk->mutable_fragment() = chunkMsg.fragment();
+        } else if (hasSubchunks) {
+            for (auto const& fragment : chunkMsg.fragment()) {
+                auto const& ids = fragment.subchunks().id();
+                *batchChunk->add_fragment()->mutable_subchunks()->mutable_id() = ids;
+            }
+        }
+    }
+
+    proto::WorkerCommandH header;
+    header.set_command(proto::WorkerCommandH::RUN_TASK_BATCH);
+    proto::FrameBuffer frameBuf;
+    frameBuf.serialize(header);
+    frameBuf.serialize(*m);
+    payload.assign(frameBuf.data(), frameBuf.size());
+}
+
 }  // namespace lsst::qserv::qproc
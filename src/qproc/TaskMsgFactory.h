@@ -32,8 +32,14 @@
  */
 
 // System headers
+#include <functional>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
 
 // Qserv headers
 #include "global/DbTable.h"
@@ -51,24 +57,92 @@ class TaskMsgFactory {
 public:
     using Ptr = std::shared_ptr<TaskMsgFactory>;
 
-    TaskMsgFactory(uint64_t session) : _session(session) {}
+    /// @return the id of the worker expected to have chunk 'chunkId' of database 'db',
+    ///         or an empty string if it isn't known.
+    using WorkerLookup = std::function<std::string(std::string const& db, int chunkId)>;
+
+    /// @param resultCodec - codec workers should compress result messages with.
+    /// @param resultCompressMin - result messages smaller than this are not compressed.
+    TaskMsgFactory(uint64_t session, proto::ProtoHeader::Codec resultCodec = proto::ProtoHeader::NONE,
+                   uint32_t resultCompressMin = 0)
+            : _session(session), _resultCodec(resultCodec), _resultCompressMin(resultCompressMin) {}
     virtual ~TaskMsgFactory() {}
 
+    /// Send each worker the template of the messages (see TaskMsg.templateid)
+    /// only once, 'workerLookup' tells which worker a message goes to. This must
+    /// be called before any message is serialized.
+    void setWorkerLookup(WorkerLookup const& workerLookup) { _workerLookup = workerLookup; }
+
     /// Construct a TaskMsg and serialize it to a stream
     virtual void serializeMsg(ChunkQuerySpec const& s, std::string const& chunkResultName, QueryId queryId,
                               int jobId, int attemptCount, qmeta::CzarId czarId, std::ostream& os);
 
+    /// Construct a TaskMsg that runs the query on the chunk of 's' and on the chunks
+    /// of 'batchSpecs' (see TaskMsg.batchchunk), and store it in 'payload' as a
+    /// RUN_TASK_BATCH worker command.
+    virtual void serializeBatchMsg(ChunkQuerySpec const& s,
+                                   std::vector<std::shared_ptr<ChunkQuerySpec>> const& batchSpecs,
+                                   std::string const& chunkResultName, QueryId queryId, int jobId,
+                                   int attemptCount, qmeta::CzarId czarId, std::string& payload);
+
+    /// Record that worker 'workerId' ran attempt 'attemptCount' of job 'jobId'
+    /// successfully. If the message of that attempt carried a template in full,
+    /// the worker keeps it, and is sent compact messages from then on.
+    void markDelivered(int jobId, int attemptCount, std::string const& workerId);
+
+    /// Forget attempt 'attemptCount' of job 'jobId', which won't be marked
+    /// delivered, as it is retried or the query is over.
+    void forgetAttempt(int jobId, int attemptCount);
+
 private:
+    /// The template of messages (see TaskMsg.templateid) and the workers known to have it.
+    struct Template {
+        proto::TaskMsg msg;
+        uint64_t id = 0;
+        std::set<std::string> workers;  ///< Only the workers that ran a message carrying it.
+    };
+
+    using FragmentFunc = std::function<void(DbTableSet const& subChunkTables,
+                                            std::vector<int> const& subChunkIds,
+                                            std::vector<std::string> const& queries)>;
+
     std::shared_ptr<proto::TaskMsg> _makeMsg(ChunkQuerySpec const& s, std::string const& chunkResultName,
                                              QueryId queryId, int jobId, int attemptCount,
                                              qmeta::CzarId czarId);
 
+    /// Add the fragments of 'chunkQuerySpec' and the specs linked to it to 'taskMsg'.
+    void _addFragments(proto::TaskMsg& taskMsg, std::string const& resultTable,
+                       ChunkQuerySpec const& chunkQuerySpec);
+
     void _addFragment(proto::TaskMsg& taskMsg, std::string const& resultName,
                       DbTableSet const& subChunkTables, std::vector<int> const& subChunkIds,
                       std::vector<std::string> const& queries);
 
+    /// Call 'func' for each fragment of 'chunkQuerySpec', in the order of TaskMsg.fragment.
+    static void _forEachFragment(ChunkQuerySpec const& chunkQuerySpec, FragmentFunc const& func);
+
+    /// @return true if 'tmpl' is the template of the message for 'chunkQuerySpec'.
+    static bool _matchesTemplate(proto::TaskMsg const& tmpl, ChunkQuerySpec const& chunkQuerySpec,
+                                 std::string const& resultTable);
+
+    /// Serialize the message for 'chunkQuerySpec', which goes to worker 'workerId',
+    /// to 'os'. Only the fields that differ between jobs are sent if the worker
+    /// was already sent the template.
+    void _serializeWithTemplate(ChunkQuerySpec const& s, std::string const& chunkResultName,
+                                QueryId queryId, int jobId, int attemptCount, qmeta::CzarId czarId,
+                                std::string const& workerId, std::ostream& os);
+
     /// All member variable need to be thread safe.
     uint64_t const _session;
+    proto::ProtoHeader::Codec const _resultCodec;
+    uint32_t const _resultCompressMin;
+    WorkerLookup _workerLookup;  ///< Set before any message is made, see setWorkerLookup().
+
+    std::mutex _templatesMtx;
+    std::vector<std::unique_ptr<Template>> _templates;  ///< Protected by _templatesMtx.
+    /// Ids of the templates carried by complete messages, by job id and attempt count,
+    /// until markDelivered() or forgetAttempt() is called for them. Protected by _templatesMtx.
+    std::map<std::pair<int, int>, uint64_t> _sentTemplates;
 };
 
 }  // namespace lsst::qserv::qproc
@@ -0,0 +1,85 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "qproc/ZoneMapIndex.h"
+
+// System headers
+#include <string>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "global/stringTypes.h"
+#include "global/stringUtil.h"
+#include "query/ColumnRef.h"
+#include "query/ZoneMapRestrictor.h"
+#include "sql/SqlConnection.h"
+#include "sql/SqlConnectionFactory.h"
+#include "sql/SqlErrorObject.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.qproc.ZoneMapIndex");
+
+std::string buildZoneMapTableName(std::string const& db, std::string const& table) {
+    return lsst::qserv::sanitizeName(db) + "__" + lsst::qserv::sanitizeName(table) + "__zonemap";
+}
+
+}  // anonymous namespace
+
+namespace lsst::qserv::qproc {
+
+ZoneMapIndex::ZoneMapIndex(mysql::MySqlConfig const& c)
+        : _sqlConnection(sql::SqlConnectionFactory::make(c)) {}
+
+IntSet ZoneMapIndex::excludedChunks(query::ZoneMapRestrictorVec const& restrictors) {
+    IntSet excluded;
+    std::lock_guard<std::mutex> lock(_mtx);
+    for (auto const& restrictor : restrictors) {
+        auto const& columnRef = restrictor->getColumnRef();
+        std::string const zoneMapTable = ::buildZoneMapTableName(columnRef->getDb(), columnRef->getTable());
+        sql::SqlErrorObject err;
+        if (!_sqlConnection->tableExists(zoneMapTable, err)) {
+            LOGS(_log, LOG_LVL_TRACE, "no zone map table " << zoneMapTable);
+            continue;
+        }
+        // The range is NULL in chunks where the column has only NULLs, which
+        // satisfy none of the comparisons.
+        std::string const sql = "SELECT `chunk`, `min_value` IS NULL, IFNULL(`min_value`, 0), "
+                                "IFNULL(`max_value`, 0) FROM `" +
+                                zoneMapTable + "` WHERE `column_name`='" +
+                                _sqlConnection->escapeString(columnRef->getColumn()) + "'";
+        LOGS(_log, LOG_LVL_TRACE, "zone map lookup sql:" << sql);
+        for (std::shared_ptr<sql::SqlResultIter> results = _sqlConnection->getQueryIter(sql);
+             not results->done(); ++(*results)) {
+            StringVector const& row = **results;
+            if (row[1] != "0" || !restrictor->mayMatch(std::stod(row[2]), std::stod(row[3]))) {
+                excluded.insert(std::stoi(row[0]));
+            }
+        }
+    }
+    return excluded;
+}
+
+}  // namespace lsst::qserv::qproc
@@ -0,0 +1,69 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_QPROC_ZONEMAPINDEX_H
+#define LSST_QSERV_QPROC_ZONEMAPINDEX_H
+
+// System headers
+#include <memory>
+#include <mutex>
+
+// Qserv headers
+#include "global/intTypes.h"
+#include "mysql/MySqlConfig.h"
+#include "query/typedefs.h"
+
+// Forward declarations
+namespace lsst::qserv::sql {
+class SqlConnection;
+}  // namespace lsst::qserv::sql
+
+namespace lsst::qserv::qproc {
+
+/**
+ *  ZoneMapIndex handles lookups into the zone maps of the partitioned tables,
+ *  which store the ranges (MIN, MAX) of the numeric columns in each chunk. The zone
+ *  maps are collected by the Replication system into the tables "<db>__<table>__zonemap"
+ *  of the QMeta database.
+ *
+ *  Only one instance of this is necessary: all user queries
+ *  can share a single instance.
+ */
+class ZoneMapIndex {
+public:
+    explicit ZoneMapIndex(mysql::MySqlConfig const& c);
+
+    /** Find chunks that can't have rows satisfying the restrictors.
+     *
+     *  Restrictors are combined with AND, so a chunk is excluded if the range
+     *  of any restricted column doesn't overlap the restriction. Chunks, columns
+     *  and tables missing in the zone maps are never excluded.
+     */
+    IntSet excludedChunks(query::ZoneMapRestrictorVec const& restrictors);
+
+private:
+    std::mutex _mtx;  ///< Protects the connection shared by the queries.
+    std::shared_ptr<sql::SqlConnection> _sqlConnection;
+};
+
+}  // namespace lsst::qserv::qproc
+
+#endif  // LSST_QSERV_QPROC_ZONEMAPINDEX_H
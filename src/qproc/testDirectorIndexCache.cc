@@ -0,0 +1,103 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// System headers
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Qserv headers
+#include "qproc/DirectorIndexCache.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE DirectorIndexCache
+#include <boost/test/unit_test.hpp>
+
+using lsst::qserv::qproc::DirectorIndexCache;
+
+namespace {
+
+/// Keys 1000..1009 in the reverse order, each in chunk "key / 5" and subchunk "key % 5".
+void fill(DirectorIndexCache& cache) {
+    for (std::int64_t key = 1009; key >= 1000; --key) {
+        cache.add(key, key / 5, key % 5);
+    }
+    cache.sort();
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(Lookup) {
+    DirectorIndexCache cache;
+    fill(cache);
+    BOOST_CHECK_EQUAL(cache.size(), 10U);
+
+    DirectorIndexCache::ChunkMap chunks;
+    cache.lookup({1007, 999, 1001, 1007, 2000, 1000}, chunks);
+    BOOST_REQUIRE_EQUAL(chunks.size(), 2U);
+    BOOST_CHECK(chunks[200] == std::vector<std::int32_t>({0, 1}));
+    BOOST_CHECK(chunks[201] == std::vector<std::int32_t>({2}));
+
+    chunks.clear();
+    cache.lookup({}, chunks);
+    cache.lookup({-1, std::numeric_limits<std::int64_t>::max()}, chunks);
+    BOOST_CHECK(chunks.empty());
+}
+
+BOOST_AUTO_TEST_CASE(LookupRange) {
+    DirectorIndexCache cache;
+    fill(cache);
+
+    DirectorIndexCache::ChunkMap chunks;
+    cache.lookupRange(1003, 1005, chunks);
+    BOOST_REQUIRE_EQUAL(chunks.size(), 2U);
+    BOOST_CHECK(chunks[200] == std::vector<std::int32_t>({3, 4}));
+    BOOST_CHECK(chunks[201] == std::vector<std::int32_t>({0}));
+
+    chunks.clear();
+    cache.lookupRange(std::numeric_limits<std::int64_t>::min(), 1000, chunks);
+    BOOST_REQUIRE_EQUAL(chunks.size(), 1U);
+    BOOST_CHECK(chunks[200] == std::vector<std::int32_t>({0}));
+
+    chunks.clear();
+    cache.lookupRange(1005, 1003, chunks);
+    cache.lookupRange(1010, std::numeric_limits<std::int64_t>::max(), chunks);
+    BOOST_CHECK(chunks.empty());
+}
+
+BOOST_AUTO_TEST_CASE(DuplicateKeys) {
+    DirectorIndexCache cache;
+    cache.add(5, 1, 2);
+    cache.add(3, 1, 1);
+    cache.add(5, 2, 7);
+    cache.sort();
+
+    DirectorIndexCache::ChunkMap chunks;
+    cache.lookup({5}, chunks);
+    BOOST_REQUIRE_EQUAL(chunks.size(), 2U);
+    BOOST_CHECK(chunks[1] == std::vector<std::int32_t>({2}));
+    BOOST_CHECK(chunks[2] == std::vector<std::int32_t>({7}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
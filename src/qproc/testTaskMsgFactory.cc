@@ -0,0 +1,233 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// System headers
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Qserv headers
+#include "global/constants.h"
+#include "proto/TaskMsgTemplate.h"
+#include "proto/worker.pb.h"
+#include "qproc/ChunkQuerySpec.h"
+#include "qproc/TaskMsgFactory.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE TaskMsgFactory
+#include <boost/test/unit_test.hpp>
+
+namespace test = boost::test_tools;
+
+using namespace lsst::qserv;
+using std::string;
+
+namespace {
+
+/// @return the spec of a full scan of chunk 'chunkId' of Object.
+qproc::ChunkQuerySpec makeSpec(int chunkId) {
+    proto::ScanInfo scanInfo;
+    scanInfo.infoTables.emplace_back("LSST", "Object", false, proto::ScanInfo::Rating::MEDIUM);
+    scanInfo.scanRating = proto::ScanInfo::Rating::MEDIUM;
+    qproc::ChunkQuerySpec spec("LSST", chunkId, scanInfo, false);
+    spec.queries.push_back(string("SELECT objectId,ra_PS,decl_PS,uFlux_PS,gFlux_PS,rFlux_PS ") +
+                           "FROM LSST.Object_" + CHUNK_TAG +
+                           " AS `o` WHERE `o`.gFlux_PS>1e-25 AND `o`.rFlux_PS<1e-22");
+    return spec;
+}
+
+/// @return the spec of a near neighbor query on 2 subchunks of chunk 'chunkId'.
+qproc::ChunkQuerySpec makeSubChunkSpec(int chunkId) {
+    qproc::ChunkQuerySpec spec = makeSpec(chunkId);
+    spec.queries[0] = string("SELECT o1.objectId,o2.objectId FROM LSST.Object_") + CHUNK_TAG + "_" +
+                      SUBCHUNK_TAG + " AS `o1`,LSST.ObjectFullOverlap_" + CHUNK_TAG + "_" + SUBCHUNK_TAG +
+                      " AS `o2` WHERE scisql_angSep(o1.ra_PS,o1.decl_PS,o2.ra_PS,o2.decl_PS)<0.001";
+    spec.subChunkTables.insert(DbTable("LSST", "Object"));
+    spec.subChunkIds = {chunkId * 10};
+    spec.nextFragment = std::make_shared<qproc::ChunkQuerySpec>(spec);
+    spec.nextFragment->subChunkIds = {chunkId * 10 + 1};
+    return spec;
+}
+
+struct Fixture {
+    /// @return the message for 'spec', as the czar sends it.
+    proto::TaskMsg serialize(qproc::TaskMsgFactory& factory, qproc::ChunkQuerySpec const& spec, int jobId,
+                             int attemptCount = 0) {
+        std::ostringstream os;
+        factory.serializeMsg(spec, "r_1_a0d45001254932466b784acf90323565_", queryId, jobId, attemptCount,
+                             czarId, os);
+        lastSize = os.str().size();
+        proto::TaskMsg taskMsg;
+        BOOST_REQUIRE(taskMsg.ParseFromString(os.str()));
+        return taskMsg;
+    }
+
+    /// @return the message for 'spec' as it was sent before templates.
+    proto::TaskMsg serializeComplete(qproc::ChunkQuerySpec const& spec, int jobId) {
+        qproc::TaskMsgFactory factory(queryId);
+        return serialize(factory, spec, jobId);
+    }
+
+    QueryId const queryId = 1234;
+    qmeta::CzarId const czarId = 7;
+    size_t lastSize = 0;
+};
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE(Suite, Fixture)
+
+BOOST_AUTO_TEST_CASE(UnknownWorker) {
+    qproc::TaskMsgFactory factory(queryId);
+    factory.setWorkerLookup([](string const&, int) { return string(); });
+    for (int chunkId : {100, 101}) {
+        auto const taskMsg = serialize(factory, makeSpec(chunkId), chunkId);
+        BOOST_CHECK(!taskMsg.has_templateid());
+        BOOST_CHECK_EQUAL(taskMsg.SerializeAsString(),
+                          serializeComplete(makeSpec(chunkId), chunkId).SerializeAsString());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ForgottenAttempt) {
+    qproc::TaskMsgFactory factory(queryId);
+    factory.setWorkerLookup([](string const&, int) { return "w1"; });
+    BOOST_CHECK(!proto::isCompactTaskMsg(serialize(factory, makeSpec(100), 1)));
+    // A forgotten attempt no longer tells that the worker has the template.
+    factory.forgetAttempt(1, 0);
+    factory.markDelivered(1, 0, "w1");
+    BOOST_CHECK(!proto::isCompactTaskMsg(serialize(factory, makeSpec(101), 2)));
+    factory.markDelivered(2, 0, "w1");
+    BOOST_CHECK(proto::isCompactTaskMsg(serialize(factory, makeSpec(102), 3)));
+}
+
+BOOST_AUTO_TEST_CASE(Templates) {
+    qproc::TaskMsgFactory factory(queryId);
+    factory.setWorkerLookup([](string const&, int chunkId) { return chunkId < 200 ? "w1" : "w2"; });
+
+    // The first message to a worker is complete.
+    auto const first = serialize(factory, makeSpec(100), 1);
+    BOOST_REQUIRE(first.has_templateid());
+    BOOST_CHECK(!proto::isCompactTaskMsg(first));
+    size_t const completeSize = lastSize;
+    proto::TaskMsg tmpl;
+    proto::makeTaskMsgTemplate(first, tmpl);
+    BOOST_CHECK(!tmpl.has_chunkid());
+    BOOST_CHECK_EQUAL(tmpl.fragment(0).query(0), first.fragment(0).query(0));
+
+    // Until the worker ran a message carrying the template, it isn't known to have it.
+    auto const unacknowledged = serialize(factory, makeSpec(105), 8);
+    BOOST_CHECK(!proto::isCompactTaskMsg(unacknowledged));
+    BOOST_CHECK_EQUAL(unacknowledged.templateid(), first.templateid());
+    factory.markDelivered(1, 1, "w1");  // Not the attempt that was sent.
+    BOOST_CHECK(!proto::isCompactTaskMsg(serialize(factory, makeSpec(105), 8)));
+    factory.markDelivered(1, 0, "w1");
+
+    // The next ones only carry what differs.
+    auto compact = serialize(factory, makeSpec(101), 2);
+    BOOST_REQUIRE(proto::isCompactTaskMsg(compact));
+    BOOST_CHECK_EQUAL(compact.templateid(), first.templateid());
+    BOOST_CHECK_EQUAL(compact.fragment_size(), 0);
+    BOOST_CHECK_LT(lastSize * 4, completeSize);
+    proto::expandTaskMsg(tmpl, compact);
+    compact.clear_templateid();
+    BOOST_CHECK_EQUAL(compact.SerializeAsString(), serializeComplete(makeSpec(101), 2).SerializeAsString());
+
+    // Retries and other workers get the complete message.
+    auto const retry = serialize(factory, makeSpec(102), 3, 1);
+    BOOST_CHECK(!proto::isCompactTaskMsg(retry));
+    BOOST_CHECK_EQUAL(retry.templateid(), first.templateid());
+    auto const otherWorker = serialize(factory, makeSpec(200), 4);
+    BOOST_CHECK(!proto::isCompactTaskMsg(otherWorker));
+    factory.markDelivered(4, 0, "w2");
+    BOOST_CHECK(proto::isCompactTaskMsg(serialize(factory, makeSpec(201), 5)));
+
+    // Different queries have different templates.
+    auto spec = makeSpec(103);
+    spec.queries[0] += " LIMIT 10";
+    auto const other = serialize(factory, spec, 6);
+    BOOST_CHECK(!proto::isCompactTaskMsg(other));
+    BOOST_CHECK_NE(other.templateid(), first.templateid());
+    BOOST_CHECK(proto::isCompactTaskMsg(serialize(factory, makeSpec(104), 7)));
+}
+
+BOOST_AUTO_TEST_CASE(SubChunkTemplates) {
+    qproc::TaskMsgFactory factory(queryId);
+    factory.setWorkerLookup([](string const&, int) { return "w1"; });
+    auto const first = serialize(factory, makeSubChunkSpec(100), 1);
+    BOOST_REQUIRE_EQUAL(first.fragment_size(), 2);
+    factory.markDelivered(1, 0, "w1");
+    proto::TaskMsg tmpl;
+    proto::makeTaskMsgTemplate(first, tmpl);
+    BOOST_CHECK_EQUAL(tmpl.fragment(1).subchunks().id_size(), 0);
+    BOOST_CHECK_EQUAL(tmpl.fragment(1).subchunks().dbtbl_size(), 1);
+
+    auto compact = serialize(factory, makeSubChunkSpec(101), 2);
+    BOOST_REQUIRE(proto::isCompactTaskMsg(compact));
+    BOOST_REQUIRE_EQUAL(compact.fragment_size(), 2);
+    BOOST_CHECK_EQUAL(compact.fragment(1).query_size(), 0);
+    BOOST_CHECK_EQUAL(compact.fragment(1).subchunks().id(0), 1011);
+    proto::expandTaskMsg(tmpl, compact);
+    compact.clear_templateid();
+    BOOST_CHECK_EQUAL(compact.SerializeAsString(),
+                      serializeComplete(makeSubChunkSpec(101), 2).SerializeAsString());
+
+    // The fragments must match the template.
+    proto::TaskMsg wrong;
+    wrong.set_templateid(first.templateid());
+    wrong.add_fragment();
+    BOOST_CHECK_THROW(proto::expandTaskMsg(tmpl, wrong), proto::TaskMsgTemplateError);
+}
+
+/// Compare the time spent serializing the messages of a 100k chunk query and
+/// their size, without and with templates. Disabled by default, run it with:
+///   testTaskMsgFactory --run_test=Suite/TemplateBenchmark
+BOOST_AUTO_TEST_CASE(TemplateBenchmark, *boost::unit_test::disabled()) {
+    int const chunks = 100'000;
+    int const workers = 30;
+    for (bool templates : {false, true}) {
+        qproc::TaskMsgFactory factory(queryId);
+        if (templates) {
+            factory.setWorkerLookup(
+                    [](string const&, int chunkId) { return std::to_string(chunkId % workers); });
+        }
+        std::vector<qproc::ChunkQuerySpec> specs;
+        for (int chunkId = 0; chunkId < chunks; ++chunkId) specs.push_back(makeSpec(chunkId));
+        size_t bytes = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int chunkId = 0; chunkId < chunks; ++chunkId) {
+            std::ostringstream os;
+            factory.serializeMsg(specs[chunkId], "r_1_a0d45001254932466b784acf90323565_", queryId, chunkId, 0,
+                                 czarId, os);
+            bytes += os.str().size();
+            // As if the results of the first messages came back before the others were sent.
+            if (templates) factory.markDelivered(chunkId, 0, std::to_string(chunkId % workers));
+        }
+        std::chrono::duration<double> secs = std::chrono::steady_clock::now() - start;
+        std::cout << (templates ? "templates   " : "no templates") << ": " << secs.count() << " s, "
+                  << bytes << " bytes" << std::endl;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
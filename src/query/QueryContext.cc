@@ -157,6 +157,17 @@ void QueryContext::addSecIdxRestrictors(SecIdxRestrictorVec const& newRestrictor
     }
 }
 
+void QueryContext::addZoneMapRestrictors(ZoneMapRestrictorVec const& newRestrictors) {
+    if (newRestrictors.empty()) {
+        return;
+    }
+    if (nullptr == zoneMapRestrictors) {
+        zoneMapRestrictors = std::make_shared<ZoneMapRestrictorVec>(newRestrictors);
+    } else {
+        zoneMapRestrictors->insert(zoneMapRestrictors->end(), newRestrictors.begin(), newRestrictors.end());
+    }
+}
+
 /// Get the table schema for the tables mentioned in the SQL 'FROM' statement.
 /// This should be adequate and possibly desirable as this information is being used
 /// to restrict queries to particular nodes via the secondary index. Sub-queries are not
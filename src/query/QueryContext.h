@@ -52,6 +52,7 @@ class AreaRestrictor;
 class ColumnRef;
 class SecIdxRestrictor;
 class TableRef;
+class ZoneMapRestrictor;
 }  // namespace query
 namespace qproc {
 class DatabaseModels;
@@ -154,9 +155,11 @@ public:
      */
     void addAreaRestrictors(AreaRestrictorVec const& newRestrictors);
     void addSecIdxRestrictors(SecIdxRestrictorVec const& newRestrictors);
+    void addZoneMapRestrictors(ZoneMapRestrictorVec const& newRestrictors);
 
     AreaRestrictorVecPtr areaRestrictors;
     SecIdxRestrictorVecPtr secIdxRestrictors;
+    ZoneMapRestrictorVecPtr zoneMapRestrictors;  ///< Used for skipping chunks, not rendered.
 
     /**
      * @brief Get and cache database schema information for all the tables in the passed-in FROM list.
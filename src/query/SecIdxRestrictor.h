@@ -139,6 +139,8 @@ public:
                                      std::string const& secondaryIndexTable, std::string const& chunkColumn,
                                      std::string const& subChunkColumn) const override;
 
+    std::shared_ptr<const query::BetweenPredicate> getBetweenPredicate() const { return _betweenPredicate; }
+
 protected:
     /**
      * @brief Test if this is equal with rhs.
@@ -171,6 +173,8 @@ public:
                                      std::string const& secondaryIndexTable, std::string const& chunkColumn,
                                      std::string const& subChunkColumn) const override;
 
+    std::shared_ptr<const query::InPredicate> getInPredicate() const { return _inPredicate; }
+
 protected:
     /**
      * @brief Test if this and rhs are equal.
@@ -0,0 +1,187 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "query/ZoneMapRestrictor.h"
+
+// System headers
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+
+// Qserv headers
+#include "query/BetweenPredicate.h"
+#include "query/ColumnRef.h"
+#include "query/CompPredicate.h"
+#include "query/InPredicate.h"
+#include "query/ValueExpr.h"
+
+namespace {
+
+using lsst::qserv::query::CompPredicate;
+using lsst::qserv::query::ValueExpr;
+using Interval = lsst::qserv::query::ZoneMapRestrictor::Interval;
+
+double const infinity = std::numeric_limits<double>::infinity();
+
+/// Integers below this magnitude (2^53) are exactly represented by a double,
+/// 2^53 itself may be the result of rounding 2^53 + 1.
+double const exactIntegerLimit = 9007199254740992.0;
+
+/// @return true if 'valueExpr' is a decimal literal, which is stored in 'value'.
+/// Quoted strings, hexadecimal literals and anything else are rejected since
+/// MySQL would not compare them with a number the same way. 'exact' is set if
+/// the literal is an integer which 'value' represents exactly, other literals
+/// may have been rounded.
+bool numericConst(std::shared_ptr<ValueExpr> const& valueExpr, double& value, bool& exact) {
+    if (valueExpr == nullptr || !valueExpr->isConstVal()) return false;
+    std::string const str = valueExpr->getConstVal();
+    if (str.empty() || str.find_first_not_of("0123456789+-.eE") != std::string::npos) return false;
+    char* end = nullptr;
+    value = std::strtod(str.c_str(), &end);
+    exact = str.find_first_of(".eE") == std::string::npos && std::abs(value) < exactIntegerLimit;
+    return end == str.c_str() + str.size() && std::isfinite(value);
+}
+
+bool numericConst(std::shared_ptr<ValueExpr> const& valueExpr, double& value) {
+    bool exact;
+    return numericConst(valueExpr, value, exact);
+}
+
+bool isColumn(std::shared_ptr<ValueExpr> const& valueExpr) {
+    return valueExpr != nullptr && valueExpr->isColumnRef();
+}
+
+/// @return the operator for swapped operands, "5 < col" is "col > 5".
+CompPredicate::OpType swapped(CompPredicate::OpType op) {
+    switch (op) {
+        case CompPredicate::LESS_THAN_OP:
+            return CompPredicate::GREATER_THAN_OP;
+        case CompPredicate::GREATER_THAN_OP:
+            return CompPredicate::LESS_THAN_OP;
+        case CompPredicate::LESS_THAN_OR_EQUALS_OP:
+            return CompPredicate::GREATER_THAN_OR_EQUALS_OP;
+        case CompPredicate::GREATER_THAN_OR_EQUALS_OP:
+            return CompPredicate::LESS_THAN_OR_EQUALS_OP;
+        default:
+            return op;
+    }
+}
+
+}  // namespace
+
+namespace lsst::qserv::query {
+
+ZoneMapRestrictor::ZoneMapRestrictor(std::shared_ptr<ColumnRef const> const& columnRef,
+                                     std::vector<Interval> intervals)
+        : _columnRef(columnRef), _intervals(std::move(intervals)) {}
+
+ZoneMapRestrictor::Ptr ZoneMapRestrictor::make(CompPredicate const& compPredicate) {
+    double value;
+    bool exact;
+    std::shared_ptr<ValueExpr> column;
+    CompPredicate::OpType op = compPredicate.op;
+    if (isColumn(compPredicate.left) && numericConst(compPredicate.right, value, exact)) {
+        column = compPredicate.left;
+    } else if (numericConst(compPredicate.left, value, exact) && isColumn(compPredicate.right)) {
+        column = compPredicate.right;
+        op = ::swapped(op);
+    } else {
+        return nullptr;
+    }
+    Interval interval{-::infinity, false, ::infinity, false};
+    switch (op) {
+        case CompPredicate::EQUALS_OP:
+        case CompPredicate::NULL_SAFE_EQUALS_OP:
+            interval = Interval{value, true, value, true};
+            break;
+        // A rounded literal may have become equal to a value of the column which
+        // satisfies the predicate, only the bound of an exact literal is excluded.
+        case CompPredicate::LESS_THAN_OP:
+            interval.upper = value;
+            interval.upperIncluded = !exact;
+            break;
+        case CompPredicate::LESS_THAN_OR_EQUALS_OP:
+            interval.upper = value;
+            interval.upperIncluded = true;
+            break;
+        case CompPredicate::GREATER_THAN_OP:
+            interval.lower = value;
+            interval.lowerIncluded = !exact;
+            break;
+        case CompPredicate::GREATER_THAN_OR_EQUALS_OP:
+            interval.lower = value;
+            interval.lowerIncluded = true;
+            break;
+        default:
+            // "col <> 5" holds in nearly every chunk.
+            return nullptr;
+    }
+    return std::make_shared<ZoneMapRestrictor>(column->getColumnRef(), std::vector<Interval>{interval});
+}
+
+ZoneMapRestrictor::Ptr ZoneMapRestrictor::make(BetweenPredicate const& betweenPredicate) {
+    double minValue, maxValue;
+    if (betweenPredicate.hasNot || !isColumn(betweenPredicate.value) ||
+        !numericConst(betweenPredicate.minValue, minValue) ||
+        !numericConst(betweenPredicate.maxValue, maxValue)) {
+        return nullptr;
+    }
+    return std::make_shared<ZoneMapRestrictor>(betweenPredicate.value->getColumnRef(),
+                                               std::vector<Interval>{{minValue, true, maxValue, true}});
+}
+
+ZoneMapRestrictor::Ptr ZoneMapRestrictor::make(InPredicate const& inPredicate) {
+    if (inPredicate.hasNot || !isColumn(inPredicate.value) || inPredicate.cands.empty()) return nullptr;
+    std::vector<Interval> intervals;
+    for (auto const& cand : inPredicate.cands) {
+        double value;
+        if (!numericConst(cand, value)) return nullptr;
+        intervals.push_back(Interval{value, true, value, true});
+    }
+    return std::make_shared<ZoneMapRestrictor>(inPredicate.value->getColumnRef(), std::move(intervals));
+}
+
+bool ZoneMapRestrictor::mayMatch(double minValue, double maxValue) const {
+    for (auto const& interval : _intervals) {
+        bool const aboveMin =
+                interval.upper > minValue || (interval.upper == minValue && interval.upperIncluded);
+        bool const belowMax =
+                interval.lower < maxValue || (interval.lower == maxValue && interval.lowerIncluded);
+        if (aboveMin && belowMax) return true;
+    }
+    return false;
+}
+
+std::ostream& operator<<(std::ostream& os, ZoneMapRestrictor const& restrictor) {
+    os << "ZoneMapRestrictor(" << *restrictor._columnRef;
+    for (auto const& interval : restrictor._intervals) {
+        os << " " << (interval.lowerIncluded ? "[" : "(") << interval.lower << "," << interval.upper
+           << (interval.upperIncluded ? "]" : ")");
+    }
+    os << ")";
+    return os;
+}
+
+}  // namespace lsst::qserv::query
@@ -0,0 +1,85 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_QUERY_ZONEMAPRESTRICTOR_H
+#define LSST_QSERV_QUERY_ZONEMAPRESTRICTOR_H
+
+// System headers
+#include <iosfwd>
+#include <memory>
+#include <vector>
+
+// Forward declarations
+namespace lsst::qserv::query {
+class BetweenPredicate;
+class ColumnRef;
+class CompPredicate;
+class InPredicate;
+}  // namespace lsst::qserv::query
+
+namespace lsst::qserv::query {
+
+/// ZoneMapRestrictor is a predicate of the WHERE clause which compares a column
+/// with numeric literals, such as "col > 5", "col BETWEEN 1 AND 2" or "col IN (1, 2)",
+/// reduced to the intervals of values the column may have in a selected row.
+/// Chunks in which the range [MIN(col), MAX(col)] doesn't overlap any of the intervals
+/// can't have any rows satisfying the predicate.
+class ZoneMapRestrictor {
+public:
+    typedef std::shared_ptr<ZoneMapRestrictor> Ptr;
+
+    /// An interval of values, the bounds are infinite if the interval is unbounded.
+    /// The bounds are the literals rounded to the nearest double, and are only
+    /// excluded if the literals are integers represented exactly.
+    struct Interval {
+        double lower;
+        bool lowerIncluded;
+        double upper;
+        bool upperIncluded;
+    };
+
+    ZoneMapRestrictor(std::shared_ptr<ColumnRef const> const& columnRef, std::vector<Interval> intervals);
+
+    /// @return the restrictor for the predicate, or nullptr if the predicate
+    ///         doesn't compare a column with numeric literals.
+    static Ptr make(CompPredicate const& compPredicate);
+    static Ptr make(BetweenPredicate const& betweenPredicate);
+    static Ptr make(InPredicate const& inPredicate);
+
+    std::shared_ptr<ColumnRef const> const& getColumnRef() const { return _columnRef; }
+    std::vector<Interval> const& getIntervals() const { return _intervals; }
+
+    /// @return true if a column whose values are within [minValue, maxValue]
+    ///         may satisfy the predicate.
+    /// @note A bound which isn't exact must have been moved outwards, so that
+    ///   rounding never narrows the range (see replica::SqlZoneMapJob).
+    bool mayMatch(double minValue, double maxValue) const;
+
+    friend std::ostream& operator<<(std::ostream& os, ZoneMapRestrictor const& restrictor);
+
+private:
+    std::shared_ptr<ColumnRef const> _columnRef;
+    std::vector<Interval> _intervals;  ///< The predicate holds within any of these.
+};
+
+}  // namespace lsst::qserv::query
+
+#endif  // LSST_QSERV_QUERY_ZONEMAPRESTRICTOR_H
@@ -0,0 +1,142 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2019 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// System headers
+#include <memory>
+#include <string>
+#include <vector>
+
+// Qserv headers
+#include "query/BetweenPredicate.h"
+#include "query/ColumnRef.h"
+#include "query/CompPredicate.h"
+#include "query/InPredicate.h"
+#include "query/ValueExpr.h"
+#include "query/ValueFactor.h"
+#include "query/ZoneMapRestrictor.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE ZoneMapRestrictor
+#include "boost/test/unit_test.hpp"
+
+using namespace lsst::qserv;
+using namespace lsst::qserv::query;
+using namespace std;
+
+namespace {
+
+shared_ptr<ValueExpr> column() { return ValueExpr::newColumnExpr("db", "tbl", "", "mjd"); }
+
+shared_ptr<ValueExpr> constant(string const& value) {
+    return ValueExpr::newSimple(ValueFactor::newConstFactor(value));
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(ZoneMapCompRestrictor) {
+    auto restrictor =
+            ZoneMapRestrictor::make(CompPredicate(column(), CompPredicate::GREATER_THAN_OP, constant("5")));
+    BOOST_REQUIRE(restrictor != nullptr);
+    BOOST_CHECK_EQUAL(*restrictor->getColumnRef(), ColumnRef("db", "tbl", "", "mjd"));
+    BOOST_CHECK(restrictor->mayMatch(1, 6));
+    BOOST_CHECK(!restrictor->mayMatch(1, 5));
+    BOOST_CHECK(!restrictor->mayMatch(1, 4));
+
+    // "5 <= col" is "col >= 5"
+    restrictor = ZoneMapRestrictor::make(
+            CompPredicate(constant("5"), CompPredicate::LESS_THAN_OR_EQUALS_OP, column()));
+    BOOST_REQUIRE(restrictor != nullptr);
+    BOOST_CHECK(restrictor->mayMatch(1, 5));
+    BOOST_CHECK(!restrictor->mayMatch(1, 4.5));
+
+    restrictor =
+            ZoneMapRestrictor::make(CompPredicate(column(), CompPredicate::EQUALS_OP, constant("-2.5e1")));
+    BOOST_REQUIRE(restrictor != nullptr);
+    BOOST_CHECK(restrictor->mayMatch(-25, -25));
+    BOOST_CHECK(!restrictor->mayMatch(-24, 10));
+}
+
+BOOST_AUTO_TEST_CASE(ZoneMapCompRestrictorRounding) {
+    // 2^53 + 1 is rounded to 2^53, which may be the rounded maximum of a chunk
+    // having the value 2^53 + 2.
+    auto restrictor = ZoneMapRestrictor::make(
+            CompPredicate(column(), CompPredicate::GREATER_THAN_OP, constant("9007199254740993")));
+    BOOST_REQUIRE(restrictor != nullptr);
+    BOOST_CHECK(restrictor->mayMatch(1, 9007199254740992.0));
+    BOOST_CHECK(!restrictor->mayMatch(1, 9007199254740990.0));
+
+    // 0.1 isn't represented exactly either.
+    restrictor =
+            ZoneMapRestrictor::make(CompPredicate(column(), CompPredicate::LESS_THAN_OP, constant("0.1")));
+    BOOST_REQUIRE(restrictor != nullptr);
+    BOOST_CHECK(restrictor->mayMatch(0.1, 1));
+    BOOST_CHECK(!restrictor->mayMatch(0.2, 1));
+
+    // 2^53 - 1 is exact.
+    restrictor = ZoneMapRestrictor::make(
+            CompPredicate(column(), CompPredicate::GREATER_THAN_OP, constant("9007199254740991")));
+    BOOST_REQUIRE(restrictor != nullptr);
+    BOOST_CHECK(!restrictor->mayMatch(1, 9007199254740991.0));
+    BOOST_CHECK(restrictor->mayMatch(1, 9007199254740992.0));
+}
+
+BOOST_AUTO_TEST_CASE(ZoneMapCompRestrictorUnsupported) {
+    BOOST_CHECK(ZoneMapRestrictor::make(
+                        CompPredicate(column(), CompPredicate::NOT_EQUALS_OP, constant("5"))) == nullptr);
+    BOOST_CHECK(ZoneMapRestrictor::make(
+                        CompPredicate(column(), CompPredicate::LESS_THAN_OP, constant("'5'"))) == nullptr);
+    BOOST_CHECK(ZoneMapRestrictor::make(CompPredicate(column(), CompPredicate::LESS_THAN_OP, column())) ==
+                nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(ZoneMapBetweenRestrictor) {
+    auto restrictor =
+            ZoneMapRestrictor::make(BetweenPredicate(column(), constant("10"), constant("20"), false));
+    BOOST_REQUIRE(restrictor != nullptr);
+    BOOST_CHECK(restrictor->mayMatch(20, 30));
+    BOOST_CHECK(restrictor->mayMatch(0, 10));
+    BOOST_CHECK(restrictor->mayMatch(12, 13));
+    BOOST_CHECK(!restrictor->mayMatch(21, 30));
+    BOOST_CHECK(!restrictor->mayMatch(0, 9.5));
+
+    BOOST_CHECK(ZoneMapRestrictor::make(BetweenPredicate(column(), constant("10"), constant("20"), true)) ==
+                nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(ZoneMapInRestrictor) {
+    auto restrictor = ZoneMapRestrictor::make(
+            InPredicate(column(), vector<shared_ptr<ValueExpr>>{constant("1"), constant("7")}, false));
+    BOOST_REQUIRE(restrictor != nullptr);
+    BOOST_CHECK_EQUAL(restrictor->getIntervals().size(), 2U);
+    BOOST_CHECK(restrictor->mayMatch(0, 1));
+    BOOST_CHECK(restrictor->mayMatch(5, 10));
+    BOOST_CHECK(!restrictor->mayMatch(2, 6));
+
+    BOOST_CHECK(ZoneMapRestrictor::make(InPredicate(
+                        column(), vector<shared_ptr<ValueExpr>>{constant("1"), constant("'a'")}, false)) ==
+                nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -56,6 +56,10 @@ class SecIdxRestrictor;
 typedef std::vector<std::shared_ptr<SecIdxRestrictor>> SecIdxRestrictorVec;
 typedef std::shared_ptr<SecIdxRestrictorVec> SecIdxRestrictorVecPtr;
 
+class ZoneMapRestrictor;
+typedef std::vector<std::shared_ptr<ZoneMapRestrictor>> ZoneMapRestrictorVec;
+typedef std::shared_ptr<ZoneMapRestrictorVec> ZoneMapRestrictorVecPtr;
+
 }  // namespace lsst::qserv::query
 
 #endif /* LSST_QSERV_QUERY_TYPES_H_ */
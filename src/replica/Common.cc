@@ -156,6 +156,9 @@ SqlRequestParams::SqlRequestParams(ProtocolRequestSql const& request) : maxRows(
         case ProtocolRequestSql::TABLE_ROW_STATS:
             type = TABLE_ROW_STATS;
             break;
+        case ProtocolRequestSql::TABLE_ZONE_MAP:
+            type = TABLE_ZONE_MAP;
+            break;
         default:
             throw runtime_error("SqlRequestParams::" + string(__func__) +
                                 "  unsupported request type: " + ProtocolRequestSql_Type_Name(requestType));
@@ -185,6 +188,9 @@ SqlRequestParams::SqlRequestParams(ProtocolRequestSql const& request) : maxRows(
         auto const& column = request.index_columns(i);
         indexColumns.emplace_back(column.name(), column.length(), column.ascending());
     }
+    for (int i = 0; i < request.zone_map_columns_size(); ++i) {
+        zoneMapColumns.push_back(request.zone_map_columns(i));
+    }
 }
 
 string SqlRequestParams::type2str() const {
@@ -219,6 +225,8 @@ string SqlRequestParams::type2str() const {
             return "ALTER_TABLE";
         case TABLE_ROW_STATS:
             return "TABLE_ROW_STATS";
+        case TABLE_ZONE_MAP:
+            return "TABLE_ZONE_MAP";
     }
     throw runtime_error("SqlRequestParams::" + string(__func__) + "  unsupported request type");
 }
@@ -337,6 +345,7 @@ ostream& operator<<(ostream& os, SqlRequestParams const& params) {
         objParamsIndexColumns.push_back(objColumn);
     }
     objParams["index_columns"] = objParamsIndexColumns;
+    objParams["zone_map_columns"] = params.zoneMapColumns;
 
     json obj;
     obj["SqlRequestParams"] = objParams;
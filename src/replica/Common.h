@@ -230,7 +230,8 @@ public:
         CREATE_TABLE_INDEX,
         DROP_TABLE_INDEX,
         ALTER_TABLE,
-        TABLE_ROW_STATS
+        TABLE_ROW_STATS,
+        TABLE_ZONE_MAP
     };
     Type type = QUERY;
 
@@ -297,6 +298,8 @@ public:
 
     std::vector<SqlIndexColumn> indexColumns;
 
+    std::vector<std::string> zoneMapColumns;
+
     // The constructors
 
     SqlRequestParams() = default;
@@ -389,6 +392,11 @@ inline std::string rowCountersTable(std::string const& databaseName, std::string
     return tableNameBuilder(databaseName, tableName, "__rows");
 }
 
+/// @return The name of a table at czar that stores the ranges of columns in chunks of the data table.
+inline std::string zoneMapTable(std::string const& databaseName, std::string const& tableName) {
+    return tableNameBuilder(databaseName, tableName, "__zonemap");
+}
+
 }  // namespace lsst::qserv::replica
 
 #endif  // LSST_QSERV_REPLICA_COMMON_H
@@ -29,7 +29,7 @@ namespace lsst::qserv::replica {
 
 map<string, set<string>> ConfigTestData::parameters() {
     return map<string, set<string>>(
-            {{"common", {"request-buf-size-bytes", "request-retry-interval-sec"}},
+            {{"common", {"request-buf-size-bytes", "request-retry-interval-sec", "request-pipeline-window"}},
              {"registry", {"host", "port", "max-listen-conn", "threads", "heartbeat-ival-sec"}},
              {"controller",
               {"num-threads", "http-server-port", "http-max-listen-conn", "http-server-threads",
@@ -68,14 +68,16 @@ map<string, set<string>> ConfigTestData::parameters() {
                "ingest-charset-name",
                "ingest-num-retries",
                "ingest-max-retries",
-               "director-index-record-size"}}});
+               "director-index-record-size",
+               "replica-inventory-ttl-sec"}}});
 }
 
 json ConfigTestData::data() {
     json obj;
     json& generalObj = obj["general"];
-    generalObj["common"] =
-            json::object({{"request-buf-size-bytes", 8192}, {"request-retry-interval-sec", 1}});
+    generalObj["common"] = json::object({{"request-buf-size-bytes", 8192},
+                                         {"request-retry-interval-sec", 1},
+                                         {"request-pipeline-window", 4}});
     generalObj["registry"] = json::object({{"host", "127.0.0.1"},
                                            {"port", 8081},
                                            {"max-listen-conn", 512},
@@ -74,7 +74,13 @@ json const ConfigurationSchema::_schemaJson = json::object(
              {"default", 131072}}},
            {"request-retry-interval-sec",
             {{"description", "The default retry timeout for network communications. Must be greater than 0."},
-             {"default", 1}}}}},
+             {"default", 1}}},
+           {"request-pipeline-window",
+            {{"description",
+              "The maximum number of requests sent to a worker over the same connection before"
+              " receiving their responses. The value of 1 would make each request wait for"
+              " the response to the previous one. Must be greater than 0."},
+             {"default", 16}}}}},
          {"registry",
           {{"host",
             {{"description", "The IP address or the DNS host name for the registry's HTTP server."},
@@ -410,7 +416,16 @@ json const ConfigurationSchema::_schemaJson = json::object(
                       to_string(ProtocolBuffer::HARD_LIMIT) +
                       " bytes. Any number set higher than this limit will"
                       " get truncated down to match the limit at run time."},
-             {"default", 16 * 1024 * 1024}}}}}});
+             {"default", 16 * 1024 * 1024}}},
+           {"replica-inventory-ttl-sec",
+            {{"description",
+              "The maximum age (seconds) of the worker's in-memory inventory of chunk files before"
+              " the replica lookup requests rescan the data directory of a database. Chunks modified"
+              " by the replication, deletion and ingest operations of the worker are re-examined"
+              " on the next lookup regardless of the age of the inventory. Setting a value of"
+              " the parameter to 0 will disable the inventory and force the full scan on each lookup."},
+             {"empty-allowed", 1},
+             {"default", 3600}}}}}});
 
 string ConfigurationSchema::description(string const& category, string const& param) {
     return _attributeValue<string>(category, param, "description", "");
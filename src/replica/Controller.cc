@@ -64,6 +64,7 @@
 #include "replica/SqlGrantAccessRequest.h"
 #include "replica/SqlRemoveTablePartitionsRequest.h"
 #include "replica/SqlRowStatsRequest.h"
+#include "replica/SqlZoneMapRequest.h"
 #include "replica/StatusRequest.h"
 #include "replica/StopRequest.h"
 
@@ -404,6 +405,17 @@ SqlRowStatsRequest::Ptr Controller::sqlRowStats(
             workerName, database, tables, onFinish, priority, keepTracking, jobId, requestExpirationIvalSec);
 }
 
+SqlZoneMapRequest::Ptr Controller::sqlZoneMap(string const& workerName, string const& database,
+                                              vector<string> const& tables, vector<string> const& columns,
+                                              function<void(SqlZoneMapRequest::Ptr)> const& onFinish,
+                                              int priority, bool keepTracking, string const& jobId,
+                                              unsigned int requestExpirationIvalSec) {
+    LOGS(_log, LOG_LVL_TRACE, _context(__func__));
+    return _submit<SqlZoneMapRequest, decltype(database), decltype(tables), decltype(columns)>(
+            workerName, database, tables, columns, onFinish, priority, keepTracking, jobId,
+            requestExpirationIvalSec);
+}
+
 DisposeRequest::Ptr Controller::dispose(string const& workerName, vector<string> const& targetIds,
                                         function<void(DisposeRequest::Ptr)> const& onFinish, int priority,
                                         bool keepTracking, string const& jobId,
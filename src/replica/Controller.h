@@ -65,6 +65,7 @@ class SqlGetIndexesRequest;
 class SqlRemoveTablePartitionsRequest;
 class SqlDeleteTablePartitionRequest;
 class SqlRowStatsRequest;
+class SqlZoneMapRequest;
 class DisposeRequest;
 
 class StopReplicationRequestPolicy;
@@ -100,6 +101,7 @@ using StopSqlGetIndexesRequest = StopRequest<StopSqlRequestPolicy>;
 using StopSqlRemoveTablePartitionsRequest = StopRequest<StopSqlRequestPolicy>;
 using StopSqlDeleteTablePartitionRequest = StopRequest<StopSqlRequestPolicy>;
 using StopSqlRowStatsRequest = StopRequest<StopSqlRequestPolicy>;
+using StopSqlZoneMapRequest = StopRequest<StopSqlRequestPolicy>;
 
 class StatusReplicationRequestPolicy;
 class StatusDeleteRequestPolicy;
@@ -134,6 +136,7 @@ using StatusSqlGetIndexesRequest = StatusRequest<StatusSqlRequestPolicy>;
 using StatusSqlRemoveTablePartitionsRequest = StatusRequest<StatusSqlRequestPolicy>;
 using StatusSqlDeleteTablePartitionRequest = StatusRequest<StatusSqlRequestPolicy>;
 using StatusSqlRowStatsRequest = StatusRequest<StatusSqlRequestPolicy>;
+using StatusSqlZoneMapRequest = StatusRequest<StatusSqlRequestPolicy>;
 
 class ServiceSuspendRequestPolicy;
 class ServiceResumeRequestPolicy;
@@ -364,6 +367,13 @@ public:
             int priority = PRIORITY_NORMAL, bool keepTracking = true, std::string const& jobId = "",
             unsigned int requestExpirationIvalSec = 0);
 
+    std::shared_ptr<SqlZoneMapRequest> sqlZoneMap(
+            std::string const& workerName, std::string const& database,
+            std::vector<std::string> const& tables, std::vector<std::string> const& columns,
+            std::function<void(std::shared_ptr<SqlZoneMapRequest>)> const& onFinish = nullptr,
+            int priority = PRIORITY_NORMAL, bool keepTracking = true, std::string const& jobId = "",
+            unsigned int requestExpirationIvalSec = 0);
+
     std::shared_ptr<DisposeRequest> dispose(
             std::string const& workerName, std::vector<std::string> const& targetIds,
             std::function<void(std::shared_ptr<DisposeRequest>)> const& onFinish = nullptr,
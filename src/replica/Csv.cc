@@ -109,7 +109,17 @@ string Dialect::sqlOptions(string const& quote) const {
     return opt;
 }
 
-Parser::Parser(Dialect const& dialect) : _dialect(dialect), _lineBuf(new char[MAX_ROW_LENGTH]) {}
+Format urlToFormat(string const& url) {
+    string const ext = ".rows";
+    string::size_type const end = url.find_first_of("?#");
+    string const path = end == string::npos ? url : url.substr(0, end);
+    return path.size() > ext.size() && path.compare(path.size() - ext.size(), ext.size(), ext) == 0
+                   ? Format::ROWS
+                   : Format::CSV;
+}
+
+Parser::Parser(Dialect const& dialect, Format format)
+        : _dialect(dialect), _format(format), _lineBuf(new char[MAX_ROW_LENGTH]) {}
 
 DialectInput::DialectInput(ProtocolDialectInput const& obj)
         : fieldsTerminatedBy(obj.fields_terminated_by()),
@@ -136,6 +146,10 @@ json DialectInput::toJson() const {
 void Parser::parse(char const* inBuf, size_t inBufSize, bool flush,
                    ParsedStringCallbackType const& onStringParsed) {
     if (inBuf == nullptr) throw invalid_argument(context + "input buffer is the null pointer.");
+    if (_format == Format::ROWS) {
+        _parseRows(inBuf, inBufSize, flush, onStringParsed);
+        return;
+    }
 
     char const* endBufPtr = inBuf + inBufSize;
     for (char const* ptr = inBuf; ptr != endBufPtr; ++ptr) {
@@ -165,4 +179,39 @@ void Parser::parse(char const* inBuf, size_t inBufSize, bool flush,
     }
 }
 
+void Parser::_parseRows(char const* inBuf, size_t inBufSize, bool flush,
+                        ParsedStringCallbackType const& onStringParsed) {
+    char const* ptr = inBuf;
+    char const* const endBufPtr = inBuf + inBufSize;
+    while (true) {
+        if (_rowLengthBufNext < sizeof(_rowLengthBuf)) {
+            if (ptr == endBufPtr) break;
+            _rowLengthBuf[_rowLengthBufNext++] = static_cast<uint8_t>(*ptr++);
+            if (_rowLengthBufNext < sizeof(_rowLengthBuf)) continue;
+            _rowLength = static_cast<size_t>(_rowLengthBuf[0]) |
+                         (static_cast<size_t>(_rowLengthBuf[1]) << 8) |
+                         (static_cast<size_t>(_rowLengthBuf[2]) << 16) |
+                         (static_cast<size_t>(_rowLengthBuf[3]) << 24);
+            // One more byte is needed for the line terminator.
+            if (_rowLength >= MAX_ROW_LENGTH) {
+                throw runtime_error(context + "input row " + to_string(_lineNum) + " exceeds the limit of " +
+                                    to_string(MAX_ROW_LENGTH) + " bytes.");
+            }
+        }
+        size_t const num = min(_rowLength - _lineBufNext, static_cast<size_t>(endBufPtr - ptr));
+        memcpy(_lineBuf.get() + _lineBufNext, ptr, num);
+        _lineBufNext += num;
+        ptr += num;
+        if (_lineBufNext < _rowLength) break;
+        _lineBuf[_lineBufNext++] = _dialect.linesTerminatedBy();
+        onStringParsed(_lineBuf.get(), _lineBufNext);
+        _lineBufNext = 0;
+        _rowLengthBufNext = 0;
+        _lineNum++;
+    }
+    if (flush && (_rowLengthBufNext != 0)) {
+        throw runtime_error(context + "input row " + to_string(_lineNum) + " is truncated.");
+    }
+}
+
 }  // namespace lsst::qserv::replica::csv
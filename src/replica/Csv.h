@@ -147,12 +147,33 @@ public:
     std::string linesTerminatedBy = Dialect::defaultLinesTerminatedBy;
 };
 
+/// The formats of the input streams recognized by the Parser.
+enum class Format : int {
+    /// Rows terminated according to the dialect.
+    CSV,
+    /// Rows written by the partitioner with option --out.format=rows. Each row is
+    /// preceded by its length as a 4-byte little-endian integer, and it's not terminated.
+    ROWS
+};
+
+/**
+ * @param url The URL (or the path name) of an input file.
+ * @return Format::ROWS if the path of the URL has the extension ".rows",
+ *   Format::CSV otherwise.
+ */
+Format urlToFormat(std::string const& url);
+
 /**
  * The class Parser parses the CSV/TSV formatted input stream of bytes into rows
  * terminated according to the specified 'dialect'. The main purpose of the parser
  * is to prepare the rows for further post-processing (such as adding extra columns)
  * by the Ingest system before loading the processed rows into the destination table.
  *
+ * Streams in Format::ROWS are split into rows using the row lengths rather than
+ * by inspecting each character of the input. The dialect's line terminator is
+ * appended to each row reported to a client, so that the rows are
+ * indistinguishable from the ones parsed from the CSV input.
+ *
  * @see class Dialect
  */
 class Parser {
@@ -169,8 +190,9 @@ public:
      * Construct an object of the class configured with the specified Dialect.
      * The dialect will be used when parsing the input stream.
      * @param dialect The dialect object.
+     * @param format The format of the input stream.
      */
-    explicit Parser(Dialect const& dialect);
+    explicit Parser(Dialect const& dialect, Format format = Format::CSV);
 
     Parser() = delete;
     Parser(Parser const&) = delete;
@@ -187,21 +209,33 @@ public:
      * @param flush If 'true' then invoke the callback (parameter \p onStringParsed) to report
      *   the last non-terminated line stored in the parser's buffer if the buffer is not empty.
      * @param onStringParsed The callback function to be called for each line parsed.
+     * @throw runtime_error For rows exceeding MAX_ROW_LENGTH, or for the truncated
+     *   last row of a stream in Format::ROWS.
      */
     void parse(char const* inBuf, size_t inBufSize, bool flush,
                ParsedStringCallbackType const& onStringParsed);
 
     Dialect const& dialect() const { return _dialect; }
+    Format format() const { return _format; }
 
     /// @return The total number of lines parsed and reported to a client.
     size_t numLines() const { return _lineNum - 1; }
 
 private:
+    void _parseRows(char const* inBuf, size_t inBufSize, bool flush,
+                    ParsedStringCallbackType const& onStringParsed);
+
     Dialect const _dialect;
+    Format const _format;
     std::unique_ptr<char[]> _lineBuf;
     size_t _lineBufNext = 0;
     size_t _lineNum = 1;         ///< the number of the current line (for diagnostic messages)
     bool _inEscapeMode = false;  ///< for counting escapes while processing the input stream
+
+    // The length prefix of the current row of Format::ROWS.
+    uint8_t _rowLengthBuf[4];
+    size_t _rowLengthBufNext = 0;
+    size_t _rowLength = 0;
 };
 
 }  // namespace lsst::qserv::replica::csv
@@ -58,6 +58,12 @@ Sql Sql::TIMESTAMPDIFF(string const& resolution, SqlId const& lhs, SqlId const&
     return Sql("TIMESTAMPDIFF(" + resolution + "," + lhs.str + "," + rhs.str + ")");
 }
 
+Sql Sql::MIN(SqlId const& sqlId) { return Sql("MIN(" + sqlId.str + ")"); }
+
+Sql Sql::MAX(SqlId const& sqlId) { return Sql("MAX(" + sqlId.str + ")"); }
+
+Sql Sql::NUM_NULLS(SqlId const& sqlId) { return Sql("COUNT(*)-COUNT(" + sqlId.str + ")"); }
+
 QueryGenerator::QueryGenerator(shared_ptr<Connection> conn) : _conn(conn) {}
 
 string QueryGenerator::escape(string const& str) const { return _conn == nullptr ? str : _conn->escape(str); }
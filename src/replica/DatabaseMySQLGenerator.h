@@ -100,6 +100,19 @@ public:
     /// @param lhs Preprocessed identifier of the left column to be selected.
     /// @param rhs Preprocessed identifier of the left column to be selected.
     static Sql TIMESTAMPDIFF(std::string const& resolution, SqlId const& lhs, SqlId const& rhs);
+
+    /// @param sqlId Preprocessed identifier of a column to be selected.
+    /// @return an object representing the aggregate function "MIN(<column>)"
+    static Sql MIN(SqlId const& sqlId);
+
+    /// @param sqlId Preprocessed identifier of a column to be selected.
+    /// @return an object representing the aggregate function "MAX(<column>)"
+    static Sql MAX(SqlId const& sqlId);
+
+    /// @param sqlId Preprocessed identifier of a column to be selected.
+    /// @return an object representing the number of NULLs "COUNT(*)-COUNT(<column>)"
+    static Sql NUM_NULLS(SqlId const& sqlId);
+
     /// @param str_ the input string
     explicit Sql(std::string const& str_) : DoNotProcess(str_) {}
 
@@ -263,6 +276,21 @@ public:
         return Sql::TIMESTAMPDIFF(resolution, id(lhs), id(rhs));
     }
 
+    template <typename IDTYPE>
+    Sql MIN(IDTYPE const& column) const {
+        return Sql::MIN(id(column));
+    }
+
+    template <typename IDTYPE>
+    Sql MAX(IDTYPE const& column) const {
+        return Sql::MAX(id(column));
+    }
+
+    template <typename IDTYPE>
+    Sql NUM_NULLS(IDTYPE const& column) const {
+        return Sql::NUM_NULLS(id(column));
+    }
+
     // Generator: [cond1 [AND cond2 [...]]]
 
     /// The end of variadic recursion
@@ -292,7 +292,7 @@ void FileIngestApp::_parseFile() const {
         throw invalid_argument(context + "Failed to create file: '" + _outFileName + "'.");
     }
     csv::Dialect dialect(_dialectInput);
-    csv::Parser parser(dialect);
+    csv::Parser parser(dialect, csv::urlToFormat(_inFileName));
     size_t inNumBytes = 0;
     size_t outNumBytes = 0;
     size_t numLines = 0;
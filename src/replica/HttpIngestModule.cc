@@ -24,10 +24,13 @@
 
 // System headers
 #include <algorithm>
+#include <cctype>
 #include <limits>
 #include <fstream>
+#include <iomanip>
 #include <map>
 #include <set>
+#include <sstream>
 #include <stdexcept>
 #include <vector>
 
@@ -97,6 +100,29 @@ string jobCompletionErrorIfAny(SqlJob::Ptr const& job, string const& prefix) {
     return error;
 }
 
+/// @return The value with all digits needed to get the same double back, which
+///   the default conversion of the query generator doesn't preserve.
+database::mysql::DoNotProcess sqlDouble(double value) {
+    ostringstream os;
+    os << setprecision(numeric_limits<double>::max_digits10) << value;
+    return database::mysql::DoNotProcess(os.str());
+}
+
+/// @return 'true' if values of the MySQL type are numbers which MySQL compares
+///   with the numeric literals. The type may have the display width and modifiers,
+///   as in "INT(11) UNSIGNED NOT NULL".
+bool isNumericType(string const& type) {
+    static set<string> const numericTypes = {"TINYINT", "SMALLINT", "MEDIUMINT", "INT",     "INTEGER",
+                                             "BIGINT",  "BOOL",     "BOOLEAN",   "REAL",    "DOUBLE",
+                                             "FLOAT",   "DECIMAL",  "DEC",       "NUMERIC", "FIXED"};
+    string name;
+    for (char c : type) {
+        if (!isalpha(static_cast<unsigned char>(c))) break;
+        name += static_cast<char>(toupper(static_cast<unsigned char>(c)));
+    }
+    return numericTypes.count(name) != 0;
+}
+
 }  // namespace
 
 namespace lsst::qserv::replica {
@@ -422,9 +448,11 @@ json HttpIngestModule::_deleteDatabase() {
         }
         for (auto const tableName : database.tables()) {
             try {
-                string const query =
+                string query =
                         g.dropTable(g.id("qservMeta", rowCountersTable(database.name, tableName)), ifExists);
                 conn->execute(query);
+                query = g.dropTable(g.id("qservMeta", zoneMapTable(database.name, tableName)), ifExists);
+                conn->execute(query);
             } catch (invalid_argument const& ex) {
                 // This exception may be thrown by the table name generator if
                 // it couldn't build a correct name due to MySQL limitations.
@@ -674,11 +702,13 @@ json HttpIngestModule::_deleteTable() {
                     g.id("qservMeta", directorIndexTableName(database.name, table.name)), ifExists);
             conn->execute(query);
         }
-        // Remove the row counters table (if any)
+        // Remove the row counters and the zone map tables (if any)
         try {
-            string const query =
+            string query =
                     g.dropTable(g.id("qservMeta", rowCountersTable(database.name, table.name)), ifExists);
             conn->execute(query);
+            query = g.dropTable(g.id("qservMeta", zoneMapTable(database.name, table.name)), ifExists);
+            conn->execute(query);
         } catch (invalid_argument const& ex) {
             // This exception may be thrown by the table name generator if
             // it couldn't build a correct name due to MySQL limitations.
@@ -724,6 +754,7 @@ json HttpIngestModule::_scanTableStats() {
             body().optional<string>("row_counters_state_update_policy", "DISABLED"));
     bool const rowCountersDeployAtQserv = body().optional<int>("row_counters_deploy_at_qserv", 0) != 0;
     bool const forceRescan = body().optional<int>("force_rescan", 0) != 0;
+    auto const zoneMapColumns = body().optionalColl<string>("zone_map_columns", vector<string>());
 
     debug(__func__, "database=" + databaseName);
     debug(__func__, "table=" + tableName);
@@ -732,6 +763,7 @@ json HttpIngestModule::_scanTableStats() {
           "row_counters_state_update_policy=" + SqlRowStatsJob::policy2str(rowCountersStateUpdatePolicy));
     debug(__func__, "row_counters_deploy_at_qserv=" + bool2str(rowCountersDeployAtQserv));
     debug(__func__, "force_rescan=" + bool2str(forceRescan));
+    debug(__func__, "zone_map_columns.size()=" + to_string(zoneMapColumns.size()));
 
     if (rowCountersDeployAtQserv &&
         rowCountersStateUpdatePolicy != SqlRowStatsJob::StateUpdatePolicy::ENABLED) {
@@ -751,6 +783,116 @@ json HttpIngestModule::_scanTableStats() {
     if (!errorExt.empty()) {
         throw HttpError(__func__, "Table rows scanning/deployment failed.", errorExt);
     }
+    if (!zoneMapColumns.empty()) {
+        json const errorExt =
+                _scanTableZoneMapImpl(databaseName, tableName, zoneMapColumns, allWorkers,
+                                      config->get<int>("controller", "catalog-management-priority-level"));
+        if (!errorExt.empty()) {
+            throw HttpError(__func__, "Table zone map scanning/deployment failed.", errorExt);
+        }
+    }
+    return json::object();
+}
+
+json HttpIngestModule::_scanTableZoneMapImpl(string const& databaseName, string const& tableName,
+                                             vector<string> const& columns, bool allWorkers, int priority) {
+    auto const config = controller()->serviceProvider()->config();
+    auto const database = config->databaseInfo(databaseName);
+    auto const table = database.findTable(tableName);
+    if (!table.isPartitioned) {
+        throw invalid_argument(context() + "::" + string(__func__) + " table '" + table.name +
+                               "' is not partitioned");
+    }
+    // The workers would convert the values of other types into numbers
+    // (e.g. '12abc' into 12), which isn't how MySQL compares them with the literals.
+    for (auto&& column : columns) {
+        auto const itr = find_if(table.columns.cbegin(), table.columns.cend(),
+                                 [&column](SqlColDef const& coldef) { return coldef.name == column; });
+        if (itr == table.columns.cend()) {
+            throw invalid_argument(context() + "::" + string(__func__) + " no such column '" + column +
+                                   "' in table '" + table.name + "'");
+        }
+        if (!::isNumericType(itr->type)) {
+            throw invalid_argument(context() + "::" + string(__func__) + " column '" + column +
+                                   "' of table '" + table.name + "' has the non-numeric type '" +
+                                   itr->type + "'");
+        }
+    }
+
+    // The ranges would miss rows of the transactions which are still open.
+    auto const databaseServices = controller()->serviceProvider()->databaseServices();
+    for (auto&& t : databaseServices->transactions(database.name)) {
+        if (!(t.state == TransactionInfo::State::FINISHED || t.state == TransactionInfo::State::ABORTED)) {
+            throw HttpError(__func__, "database has uncommitted transactions");
+        }
+    }
+
+    string const noParentJobId;
+    auto const job = SqlZoneMapJob::create(database.name, table.name, columns, allWorkers, controller(),
+                                           noParentJobId, nullptr, priority);
+    job->start();
+    logJobStartedEvent(SqlZoneMapJob::typeName(), job, database.family);
+    job->wait();
+    logJobFinishedEvent(SqlZoneMapJob::typeName(), job, database.family);
+
+    if (job->extendedState() != Job::ExtendedState::SUCCESS) {
+        json errorExt = json::object(
+                {{"operation", "Scan table zone map."}, {"job_id", job->id()}, {"workers", json::object()}});
+        job->getResultData().iterate([&](SqlJobResult::Worker const& worker,
+                                         SqlJobResult::Scope const& internalTable,
+                                         SqlResultSet::ResultSet const& resultSet) {
+            if (resultSet.extendedStatus != ProtocolStatusExt::NONE) {
+                errorExt["workers"][worker][internalTable] =
+                        json::object({{"status", ProtocolStatusExt_Name(resultSet.extendedStatus)},
+                                      {"error", resultSet.error}});
+            }
+        });
+        return errorExt;
+    }
+
+    // Load the zone map into Qserv after removing all previous entries
+    // for the table to ensure the clean state. The columns which only have NULLs
+    // in a chunk have NULL ranges.
+    try {
+        ConnectionHandler const h(qservMasterDbConnection("qservMeta"));
+        QueryGenerator const g(h.conn);
+        string const zoneMap = zoneMapTable(database.name, table.name);
+        bool ifNotExists = true;
+        list<SqlColDef> const columnDefs = {SqlColDef{"chunk", "INT UNSIGNED NOT NULL"},
+                                            SqlColDef{"column_name", "VARCHAR(255) NOT NULL"},
+                                            SqlColDef{"min_value", "DOUBLE DEFAULT NULL"},
+                                            SqlColDef{"max_value", "DOUBLE DEFAULT NULL"},
+                                            SqlColDef{"num_nulls", "BIGINT UNSIGNED DEFAULT 0"}};
+        list<string> const keys = {g.packTableKey("UNIQUE KEY", "", "chunk", "column_name")};
+        string const engine = "InnoDB";
+        string const comment =
+                "The ranges of values of the numeric columns in the chunk tables."
+                " The table is supposed to be populated by the table scanner.";
+        vector<string> queries;
+        queries.emplace_back(g.createTable(zoneMap, ifNotExists, columnDefs, keys, engine, comment));
+        queries.emplace_back(g.delete_(zoneMap));
+        for (auto&& [chunk, ranges] : job->zoneMap()) {
+            for (auto&& [column, range] : ranges) {
+                if (range.hasValues) {
+                    queries.emplace_back(g.insert(zoneMap, chunk, column, ::sqlDouble(range.minValue),
+                                                  ::sqlDouble(range.maxValue), range.numNulls));
+                } else {
+                    queries.emplace_back(g.insert(zoneMap, chunk, column, Sql::NULL_, Sql::NULL_,
+                                                  range.numNulls));
+                }
+            }
+        }
+        h.conn->executeInOwnTransaction([&queries](decltype(h.conn) conn) {
+            for (auto&& query : queries) {
+                conn->execute(query);
+            }
+        });
+    } catch (exception const& ex) {
+        string const msg = "Failed to load/update the zone map for table '" + table.name +
+                           "' of database '" + database.name + "' into Qserv, ex: " + string(ex.what());
+        error(__func__, msg);
+        return json::object({{"operation", "Deploy table zone map in Qserv."}, {"error", msg}});
+    }
     return json::object();
 }
 
@@ -920,10 +1062,15 @@ json HttpIngestModule::_deleteTableStats() {
         ConnectionHandler const h(qservMasterDbConnection("qservMeta"));
         QueryGenerator const g(h.conn);
         bool const ifExists = true;
-        string const query = g.dropTable(rowCountersTable(table.database, table.name), ifExists);
-        h.conn->executeInOwnTransaction([&query](decltype(h.conn) conn) { conn->execute(query); });
+        vector<string> const queries = {g.dropTable(rowCountersTable(table.database, table.name), ifExists),
+                                        g.dropTable(zoneMapTable(table.database, table.name), ifExists)};
+        h.conn->executeInOwnTransaction([&queries](decltype(h.conn) conn) {
+            for (auto&& query : queries) {
+                conn->execute(query);
+            }
+        });
     } catch (exception const& ex) {
-        string const msg = "Failed to delete metadata table with counters for table '" + table.name +
+        string const msg = "Failed to delete metadata tables with counters for table '" + table.name +
                            "' of database '" + table.database + "' from Qserv, ex: " + string(ex.what());
         error(__func__, msg);
         throw HttpError(__func__, msg,
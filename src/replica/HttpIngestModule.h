@@ -32,6 +32,7 @@
 #include "replica/Common.h"
 #include "replica/HttpModule.h"
 #include "replica/SqlRowStatsJob.h"
+#include "replica/SqlZoneMapJob.h"
 
 // Forward declarations
 namespace lsst::qserv::replica {
@@ -156,6 +157,23 @@ private:
                                        SqlRowStatsJob::StateUpdatePolicy stateUpdatePolicy,
                                        bool deployAtQserv, bool forceRescan, bool allWorkers, int priority);
 
+    /**
+     * Scan the ranges of the numeric columns in the chunk tables of a partitioned table
+     * and deploy the zone map at czar's metadata.
+     * @param databaseName The name of an existing database.
+     * @param tableName The name of an existing partitioned table.
+     * @param columns The names of the columns.
+     * @param allWorkers The flag should be set to 'true' if no worker filtering is required.
+     *   Otherwise only the "enabled" workers will be involved into the operation.
+     * @param priority The priority level of the Replication Framework's jobs and requests
+     *   submitted by the method.
+     * @return nlohmann::json The extended error object that will be empty of no errors ocurred.
+     * @throws std::invalid_argument If the table isn't partitioned, or if a column isn't known.
+     */
+    nlohmann::json _scanTableZoneMapImpl(std::string const& databaseName, std::string const& tableName,
+                                         std::vector<std::string> const& columns, bool allWorkers,
+                                         int priority);
+
     /// Delete existing stats on the row counters
     nlohmann::json _deleteTableStats();
 
@@ -253,6 +253,7 @@ json HttpIngestTransModule::_beginTransaction() {
                 }
             }
         }
+        _dropZoneMaps(database);
         transaction = databaseServices->updateTransaction(transaction.id, TransactionInfo::State::STARTED);
 
         _logTransactionMgtEvent("BEGIN TRANSACTION", "SUCCESS", transaction.id, database.name);
@@ -528,6 +529,27 @@ void HttpIngestTransModule::_removePartitionFromDirectorIndex(DatabaseInfo const
     }
 }
 
+void HttpIngestTransModule::_dropZoneMaps(DatabaseInfo const& database) const {
+    database::mysql::ConnectionHandler const h(qservMasterDbConnection("qservMeta"));
+    database::mysql::QueryGenerator const g(h.conn);
+    bool const ifExists = true;
+    vector<string> queries;
+    for (auto&& tableName : database.partitionedTables()) {
+        try {
+            queries.emplace_back(g.dropTable(zoneMapTable(database.name, tableName), ifExists));
+        } catch (invalid_argument const&) {
+            // The table name generator couldn't build a correct name due to MySQL
+            // limitations. Hence the zone map couldn't have been created.
+            ;
+        }
+    }
+    h.conn->executeInOwnTransaction([&queries](decltype(h.conn) conn) {
+        for (auto&& query : queries) {
+            conn->execute(query);
+        }
+    });
+}
+
 json HttpIngestTransModule::_getTransactionContributions(TransactionInfo const& transaction,
                                                          bool longContribFormat, bool includeWarnings,
                                                          bool includeRetries) const {
@@ -127,6 +127,13 @@ private:
     void _removePartitionFromDirectorIndex(DatabaseInfo const& database, TransactionId transactionId,
                                            std::string const& directorTableName) const;
 
+    /**
+     * Remove the zone maps of the partitioned tables of a database, since
+     * the ranges of values won't cover rows ingested by a new transaction.
+     * @param database the database descriptor defines a scope of the operation
+     */
+    void _dropZoneMaps(DatabaseInfo const& database) const;
+
     /**
      * Extract contributions into a transaction.
      * @param transaction A transaction defining a scope of the request.
@@ -348,8 +348,11 @@ void IngestFileSvc::loadDataIntoTable(unsigned int maxNumWarnings) {
                               " got aborted while the file was being ingested into the table.");
         }
 
+        _invalidateReplicaInventory();
+
     } catch (exception const& ex) {
         LOGS(_log, LOG_LVL_ERROR, context_ << "exception: " << ex.what());
+        _invalidateReplicaInventory();
         throw;
     }
 }
@@ -369,4 +372,12 @@ void IngestFileSvc::closeFile() {
     }
 }
 
+void IngestFileSvc::_invalidateReplicaInventory() {
+    // Tables of the DUMMY chunk are also created by the ingest.
+    if (_table.isPartitioned) {
+        _serviceProvider->replicaInventory().invalidate(_database.name, _chunk);
+        _serviceProvider->replicaInventory().invalidate(_database.name, lsst::qserv::DUMMY_CHUNK);
+    }
+}
+
 }  // namespace lsst::qserv::replica
@@ -108,6 +108,9 @@ protected:
     bool isOpen() const { return _file.is_open(); }
 
 private:
+    /// Report changes made to files of the chunk tables to the worker's replica inventory
+    void _invalidateReplicaInventory();
+
     // Input parameters
 
     ServiceProvider::Ptr const _serviceProvider;
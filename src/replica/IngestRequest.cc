@@ -542,7 +542,7 @@ void IngestRequest::_readLocalFile(replica::Lock const& lock) {
         raiseRetryAllowedError(context, "failed to open the file '" + _resource->filePath() + "', error: '" +
                                                 strerror(errno) + "', errno: " + to_string(errno));
     }
-    auto parser = make_unique<csv::Parser>(_dialect);
+    auto parser = make_unique<csv::Parser>(_dialect, csv::urlToFormat(_contrib.url));
     bool eof = false;
     do {
         eof = !infile.read(record.get(), defaultRecordSizeBytes);
@@ -597,7 +597,7 @@ void IngestRequest::_readRemoteFile(replica::Lock const& lock) {
     }
 
     // Read and parse data from the data source
-    auto parser = make_unique<csv::Parser>(_dialect);
+    auto parser = make_unique<csv::Parser>(_dialect, csv::urlToFormat(_contrib.url));
     bool const flush = true;
     HttpClient reader(_contrib.httpMethod, _contrib.url, _contrib.httpData, _contrib.httpHeaders,
                       clientConfig);
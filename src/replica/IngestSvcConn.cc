@@ -196,7 +196,7 @@ void IngestSvcConn::_handshakeReceived(boost::system::error_code const& ec, size
             throw invalid_argument(context + string(__func__) + " unsupported url '" + _contrib.url + "'");
         }
         dialect = csv::Dialect(_contrib.dialectInput);
-        _parser.reset(new csv::Parser(dialect));
+        _parser.reset(new csv::Parser(dialect, csv::urlToFormat(_contrib.url)));
     } catch (exception const& ex) {
         _contrib.error = ex.what();
         _contrib = databaseServices->createdTransactionContrib(_contrib, failed);
@@ -71,6 +71,7 @@ MessengerConnector::MessengerConnector(shared_ptr<Configuration> const& config,
           _worker(worker),
           _bufferCapacityBytes(config->get<size_t>("common", "request-buf-size-bytes")),
           _timerIvalSec(config->get<unsigned int>("common", "request-retry-interval-sec")),
+          _pipelineWindow(max<size_t>(1, config->get<size_t>("common", "request-pipeline-window"))),
           _state(State::STATE_INITIAL),
           _resolver(io_service),
           _socket(io_service),
@@ -104,11 +105,15 @@ void MessengerConnector::stop() {
                 _timer.cancel(ec);
                 _state = STATE_INITIAL;
 
-                // Make sure the current request's owner gets notified
-                if (_currentRequest != nullptr) {
-                    requests2notify.push_back(_currentRequest);
-                    _currentRequest = nullptr;
+                // Make sure the owners of the requests in flight get notified
+                for (auto&& id : _sentIds) {
+                    auto const itr = _inFlight.find(id);
+                    if (itr != _inFlight.end()) requests2notify.push_back(itr->second);
                 }
+                _inFlight.clear();
+                _sentIds.clear();
+                _sending = false;
+                _receiving = false;
 
                 // Also cancel the queued requests and notify their owners
                 while (true) {
@@ -133,41 +138,35 @@ void MessengerConnector::cancel(string const& id) {
     replica::Lock lock(_mtx, _context() + __func__);
 
     LOGS(_log, LOG_LVL_DEBUG,
-         _context() << __func__ << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : "")
+         _context() << __func__ << "  _inFlight.size=" << _inFlight.size()
                     << "  _requests.size=" << _requests.size() << "  id=" << id);
 
     // Remove request from the queue (if it's still there)
     _requests.remove(id);
 
-    // Also, if the request is already being processed then terminate all
-    // communications with a worker.
-    if (_state == STATE_COMMUNICATING) {
-        if ((_currentRequest != nullptr) and (_currentRequest->id() == id)) {
-            // Make sure the request gets eliminated before restarting the connection.
-            // Otherwise it will be picked up again.
-            _currentRequest = nullptr;
-            _restart(lock);
-        }
-    }
+    // Also forget the request if it's already in flight. The connection is kept
+    // since its response will still arrive. The response will be read and dropped
+    // by _responseReceived() to keep the stream in sync with the worker.
+    _inFlight.erase(id);
 }
 
 bool MessengerConnector::exists(string const& id) const {
     replica::Lock lock(_mtx, _context() + __func__);
 
     LOGS(_log, LOG_LVL_DEBUG,
-         _context() << __func__ << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : "")
+         _context() << __func__ << "  _inFlight.size=" << _inFlight.size()
                     << "  _requests.size=" << _requests.size() << "  id=" << id);
-    return _requests.find(id) != nullptr;
+    return (_inFlight.count(id) != 0) || (_requests.find(id) != nullptr);
 }
 
 void MessengerConnector::_sendImpl(MessageWrapperBase::Ptr const& ptr) {
     replica::Lock lock(_mtx, _context() + __func__);
 
     LOGS(_log, LOG_LVL_DEBUG,
-         _context() << __func__ << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : "")
+         _context() << __func__ << "  _inFlight.size=" << _inFlight.size()
                     << "  _requests.size=" << _requests.size() << "  id=" << ptr->id());
 
-    if (_requests.find(ptr->id()) != nullptr) {
+    if ((_inFlight.count(ptr->id()) != 0) || (_requests.find(ptr->id()) != nullptr)) {
         throw logic_error("MessengerConnector::" + string(__func__) +
                           "  the request is already registered for id:" + ptr->id());
     }
@@ -196,7 +195,7 @@ void MessengerConnector::_sendImpl(MessageWrapperBase::Ptr const& ptr) {
 
 void MessengerConnector::_restart(replica::Lock const& lock) {
     LOGS(_log, LOG_LVL_DEBUG,
-         _context() << __func__ << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : "")
+         _context() << __func__ << "  _inFlight.size=" << _inFlight.size()
                     << "  _requests.size=" << _requests.size());
 
     // The error code is used to call non-throwing methods and to prevent exceptions.
@@ -212,12 +211,17 @@ void MessengerConnector::_restart(replica::Lock const& lock) {
         case STATE_COMMUNICATING:
             _resolver.cancel();
             if (_state == STATE_COMMUNICATING) {
-                // Save curent request into the front of the queue, so that it would be the first
-                // one to be processed upon successful completion of the restart.
-                if (_currentRequest != nullptr) {
-                    _requests.push_front(_currentRequest);
-                    _currentRequest = nullptr;
+                // Save the requests in flight into the front of the queue in the order
+                // they were sent, so that they would be the first ones to be processed
+                // upon successful completion of the restart.
+                for (auto itr = _sentIds.rbegin(); itr != _sentIds.rend(); ++itr) {
+                    auto const inFlightItr = _inFlight.find(*itr);
+                    if (inFlightItr != _inFlight.end()) _requests.push_front(inFlightItr->second);
                 }
+                _inFlight.clear();
+                _sentIds.clear();
+                _sending = false;
+                _receiving = false;
                 _socket.cancel(ec);
                 _socket.close(ec);
             }
@@ -233,7 +237,7 @@ void MessengerConnector::_restart(replica::Lock const& lock) {
 
 void MessengerConnector::_resolve(replica::Lock const& lock) {
     LOGS(_log, LOG_LVL_DEBUG,
-         _context() << __func__ << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : "")
+         _context() << __func__ << "  _inFlight.size=" << _inFlight.size()
                     << "  _requests.size=" << _requests.size());
 
     if (_state != STATE_INITIAL) return;
@@ -257,7 +261,7 @@ void MessengerConnector::_resolved(boost::system::error_code const& ec,
     replica::Lock lock(_mtx, _context() + __func__);
 
     LOGS(_log, LOG_LVL_DEBUG,
-         _context() << __func__ << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : "")
+         _context() << __func__ << "  _inFlight.size=" << _inFlight.size()
                     << "  _requests.size=" << _requests.size() << "  ec=" << ec2str(ec));
 
     if (_state != STATE_CONNECTING) return;
@@ -271,7 +275,7 @@ void MessengerConnector::_resolved(boost::system::error_code const& ec,
 
 void MessengerConnector::_connect(replica::Lock const& lock, boost::asio::ip::tcp::resolver::iterator iter) {
     LOGS(_log, LOG_LVL_DEBUG,
-         _context() << __func__ << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : "")
+         _context() << __func__ << "  _inFlight.size=" << _inFlight.size()
                     << "  _requests.size=" << _requests.size());
 
     boost::asio::async_connect(_socket, iter,
@@ -283,7 +287,7 @@ void MessengerConnector::_connected(boost::system::error_code const& ec,
     replica::Lock lock(_mtx, _context() + __func__);
 
     LOGS(_log, LOG_LVL_DEBUG,
-         _context() << __func__ << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : "")
+         _context() << __func__ << "  _inFlight.size=" << _inFlight.size()
                     << "  _requests.size=" << _requests.size() << "  ec=" << ec2str(ec));
 
     if (_state != STATE_CONNECTING) return;
@@ -298,7 +302,7 @@ void MessengerConnector::_connected(boost::system::error_code const& ec,
 
 void MessengerConnector::_waitBeforeRestart(replica::Lock const& lock) {
     LOGS(_log, LOG_LVL_DEBUG,
-         _context() << __func__ << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : "")
+         _context() << __func__ << "  _inFlight.size=" << _inFlight.size()
                     << "  _requests.size=" << _requests.size());
 
     // Always need to set the interval before launching the timer.
@@ -310,7 +314,7 @@ void MessengerConnector::_awakenForRestart(boost::system::error_code const& ec)
     replica::Lock lock(_mtx, _context() + __func__);
 
     LOGS(_log, LOG_LVL_DEBUG,
-         _context() << __func__ << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : "")
+         _context() << __func__ << "  _inFlight.size=" << _inFlight.size()
                     << "  _requests.size=" << _requests.size() << "  ec=" << ec2str(ec));
 
     if (_state != STATE_CONNECTING) return;
@@ -333,61 +337,76 @@ void MessengerConnector::_awakenForRestart(boost::system::error_code const& ec)
 void MessengerConnector::_sendRequest(replica::Lock const& lock) {
     LOGS(_log, LOG_LVL_DEBUG,
          _context() << __func__ << ":1"
-                    << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : "")
-                    << "  _requests.size=" << _requests.size());
+                    << "  _inFlight.size=" << _inFlight.size() << "  _requests.size=" << _requests.size());
 
     if (_state != STATE_COMMUNICATING) return;
 
-    // Check if there is another request in flight.
-    if (_currentRequest) return;
+    // Only one request is written into the socket at a time. The next one
+    // will be sent by _requestSent() after finishing this write.
+    if (_sending) return;
+
+    // Check if the window is full. Requests cancelled while in flight still count
+    // since their responses have yet to arrive.
+    if (_sentIds.size() >= _pipelineWindow) return;
 
     // Pull the next available request (if any) from the queue.
     if (_requests.empty()) return;
-    _currentRequest = _requests.front();
+    auto const ptr = _requests.front();
+    _inFlight[ptr->id()] = ptr;
+    _sentIds.push_back(ptr->id());
+    _sending = true;
 
     LOGS(_log, LOG_LVL_DEBUG,
-         _context() << __func__ << ":1"
-                    << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : "")
+         _context() << __func__ << ":2"
+                    << "  id=" << ptr->id() << "  _inFlight.size=" << _inFlight.size()
                     << "  _requests.size=" << _requests.size());
 
-    boost::asio::async_write(_socket,
-                             boost::asio::buffer(_currentRequest->requestBufferPtr()->data(),
-                                                 _currentRequest->requestBufferPtr()->size()),
-                             bind(&MessengerConnector::_requestSent, shared_from_this(), _1, _2));
+    // The request is bound to the handler to keep its buffer alive until the write
+    // is over, even if the request gets cancelled in the meantime.
+    boost::asio::async_write(
+            _socket, boost::asio::buffer(ptr->requestBufferPtr()->data(), ptr->requestBufferPtr()->size()),
+            bind(&MessengerConnector::_requestSent, shared_from_this(), ptr, _1, _2));
+
+    // Responses are received while more requests are being sent.
+    _receiveResponse(lock);
 }
 
-void MessengerConnector::_requestSent(boost::system::error_code const& ec, size_t bytes_transferred) {
+void MessengerConnector::_requestSent(MessageWrapperBase::Ptr const& ptr, boost::system::error_code const& ec,
+                                      size_t bytes_transferred) {
     replica::Lock lock(_mtx, _context() + __func__);
 
     LOGS(_log, LOG_LVL_DEBUG,
-         _context() << __func__ << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : "")
+         _context() << __func__ << "  id=" << ptr->id() << "  _inFlight.size=" << _inFlight.size()
                     << "  _requests.size=" << _requests.size() << "  ec=" << ec2str(ec));
 
     if (_state != STATE_COMMUNICATING) return;
 
-    // Check if the request was cancelled. If so then pull another one (if any) from
-    // the queue.
-    if (_currentRequest == nullptr) {
-        _sendRequest(lock);
-        return;
-    }
+    // The write was aborted when restarting the connection. The request is
+    // already back in the queue.
+    if (ec == boost::asio::error::operation_aborted) return;
 
-    // The request will be retried later after restarting the connection.
+    _sending = false;
+
+    // The requests in flight will be retried later after restarting the connection.
     if (_failed(ec)) {
         LOGS(_log, LOG_LVL_DEBUG, _context() << __func__ << "  ** FAILED **");
         _restart(lock);
         return;
     }
 
-    // Go wait for a server response
-    _receiveResponse(lock);
+    // Send the next request (if any) while the window isn't full.
+    _sendRequest(lock);
 }
 
 void MessengerConnector::_receiveResponse(replica::Lock const& lock) {
     LOGS(_log, LOG_LVL_DEBUG,
-         _context() << __func__ << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : "")
+         _context() << __func__ << "  _inFlight.size=" << _inFlight.size()
                     << "  _requests.size=" << _requests.size());
 
+    // Only one response is received at a time, and only if any are expected.
+    if (_receiving || _sentIds.empty()) return;
+    _receiving = true;
+
     // Start with receiving the fixed length frame carrying
     // the size (in bytes) the length of the subsequent message.
     //
@@ -419,59 +438,77 @@ void MessengerConnector::_responseReceived(boost::system::error_code const& ec,
         replica::Lock lock(_mtx, _context() + __func__);
 
         LOGS(_log, LOG_LVL_DEBUG,
-             _context() << __func__ << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : "")
+             _context() << __func__ << "  _inFlight.size=" << _inFlight.size()
                         << "  _requests.size=" << _requests.size() << "  ec=" << ec2str(ec));
 
         if (_state != STATE_COMMUNICATING) return;
 
-        // Check if the request was cancelled while still in flight.
-        if (_currentRequest == nullptr) {
+        // The read was aborted when restarting the connection. The requests
+        // in flight are already back in the queue.
+        if (ec == boost::asio::error::operation_aborted) return;
+
+        _receiving = false;
+
+        if (_failed(ec)) {
+            // Failed to get any response from a worker. The connection is in an unusable state,
+            // and it needs to be reset.
+            _restart(lock);
+            return;
+        }
+
+        // Receive response header into the temporary buffer. The header tells
+        // which of the requests in flight the response is for. The worker
+        // answers in the order the requests were sent, though this isn't required.
+        string id;
+        if (0 != _syncReadHeader(lock, _inBuffer, _inBuffer.parseLength(), id).value()) {
+            // Failed to receive the header
             _restart(lock);
             return;
         }
+        auto const sentItr = find(_sentIds.begin(), _sentIds.end(), id);
+        if (sentItr == _sentIds.end()) {
+            throw logic_error("MessengerConnector::" + string(__func__) + "  got unexpected id: " + id);
+        }
+        _sentIds.erase(sentItr);
 
-        // At this point we're done with the current request, regardless of its completion
+        // At this point we're done with the request, regardless of its completion
         // status, or any failures to pull or digest the response data. Hence, removing
-        // completely it and getting ready to notify a caller.
+        // completely it and getting ready to notify a caller. The request won't be
+        // found if it was cancelled while in flight. Its response still has to be read
+        // from the socket, and it will go into the temporary buffer.
         //
         // NOTE: by default a request would be marked as failed, unless the following method
         // is called: request2notify->setSuccess(true).
 
-        swap(request2notify, _currentRequest);
+        auto const inFlightItr = _inFlight.find(id);
+        if (inFlightItr != _inFlight.end()) {
+            request2notify = inFlightItr->second;
+            _inFlight.erase(inFlightItr);
+        }
 
-        if (_failed(ec)) {
-            // Failed to get any response from a worker. The connection is in an unusable state,
-            // and it needs to be reset.
+        // Read the response frame
+        size_t bytes;
+        if (0 != _syncReadFrame(lock, _inBuffer, bytes).value()) {
+            // Failed to read the frame
             _restart(lock);
         } else {
-            // Receive response header into the temporary buffer.
-            if (0 != _syncReadVerifyHeader(lock, _inBuffer, _inBuffer.parseLength(), request2notify->id())
-                             .value()) {
-                // Failed to receive the header
+            LOGS(_log, LOG_LVL_DEBUG,
+                 _context() << __func__ << "  id=" << id << "  cancelled=" << (request2notify == nullptr)
+                            << "  bytes=" << bytes);
+
+            // Receive response body into a buffer inside the wrapper
+            ProtocolBuffer& buf = request2notify == nullptr ? _inBuffer : request2notify->responseBuffer();
+            if (0 != _syncReadMessageImpl(lock, buf, bytes).value()) {
+                // Failed to read the message body
                 _restart(lock);
             } else {
-                // Read the response frame
-                size_t bytes;
-                if (0 != _syncReadFrame(lock, _inBuffer, bytes).value()) {
-                    // Failed to read the frame
-                    _restart(lock);
-                } else {
-                    LOGS(_log, LOG_LVL_DEBUG,
-                         _context() << __func__ << "  _currentRequest=" << request2notify->id()
-                                    << " bytes=" << bytes);
-
-                    // Receive response body into a buffer inside the wrapper
-                    if (0 != _syncReadMessageImpl(lock, request2notify->responseBuffer(), bytes).value()) {
-                        // Failed to read the message body
-                        _restart(lock);
-                    } else {
-                        // Finally, success!
-                        request2notify->setSuccess(true);
-
-                        // Initiate the next request (if any) processing
-                        _sendRequest(lock);
-                    }
-                }
+                // Finally, success!
+                if (request2notify != nullptr) request2notify->setSuccess(true);
+
+                // Wait for the next response (if any), and send the next request
+                // (if any) since the window has a free slot now.
+                _receiveResponse(lock);
+                _sendRequest(lock);
             }
         }
     }
@@ -490,24 +527,20 @@ boost::system::error_code MessengerConnector::_syncReadFrame(replica::Lock const
     boost::asio::read(_socket, boost::asio::buffer(buf.data(), frameLength),
                       boost::asio::transfer_at_least(frameLength), ec);
     LOGS(_log, LOG_LVL_DEBUG,
-         _context() << __func__ << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : "")
+         _context() << __func__ << "  _inFlight.size=" << _inFlight.size()
                     << "  _requests.size=" << _requests.size() << " ec=" << ec);
 
     if (ec.value() == 0) bytes = buf.parseLength();
     return ec;
 }
 
-boost::system::error_code MessengerConnector::_syncReadVerifyHeader(replica::Lock const& lock,
-                                                                    ProtocolBuffer& buf, size_t bytes,
-                                                                    string const& id) {
+boost::system::error_code MessengerConnector::_syncReadHeader(replica::Lock const& lock, ProtocolBuffer& buf,
+                                                              size_t bytes, string& id) {
     boost::system::error_code const ec = _syncReadMessageImpl(lock, buf, bytes);
     if (ec.value() == 0) {
         ProtocolResponseHeader hdr;
         buf.parse(hdr, bytes);
-        if (id != hdr.id()) {
-            throw logic_error("MessengerConnector::" + string(__func__) + "  got unexpected id: " + hdr.id() +
-                              " instead of: " + id);
-        }
+        id = hdr.id();
     }
     return ec;
 }
@@ -520,7 +553,7 @@ boost::system::error_code MessengerConnector::_syncReadMessageImpl(replica::Lock
                       ec);
 
     LOGS(_log, LOG_LVL_DEBUG,
-         _context() << __func__ << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : "")
+         _context() << __func__ << "  _inFlight.size=" << _inFlight.size()
                     << "  _requests.size=" << _requests.size() << " ec=" << ec);
 
     return ec;
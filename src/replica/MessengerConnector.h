@@ -185,6 +185,12 @@ private:
  * messages to and from worker services. It provides connection multiplexing and
  * automatic reconnects.
  *
+ * Requests are pipelined over the connection. Up to "request-pipeline-window"
+ * requests (a parameter of the "common" configuration section) may be sent before
+ * their responses arrive. Responses are matched with the requests in flight by
+ * the request identifiers carried in the response headers. A window of 1 makes
+ * each request wait for the response to the previous one.
+ *
  * NOTES ON THREAD SAFETY:
  *
  * - in the implementation of this class a mutex is used to prevent race conditions
@@ -255,7 +261,8 @@ public:
      * Cancel an outstanding request.
      *
      * If this call succeeds there won't be any 'onFinish' callback made
-     * as provided to the 'onFinish' method in method 'send'.
+     * as provided to the 'onFinish' method in method 'send'. A response to
+     * the request that is already in flight will be discarded upon its arrival.
      *
      * The method may throw std::logic_error if the Messenger doesn't have
      * a request registered with the specified request 'id'.
@@ -349,7 +356,7 @@ private:
 
     /**
      * Lookup for the next available request and begin sending it
-     * unless there is another ongoing request at a time of the call.
+     * unless another request is being sent, or the window is full.
      * @param lock  A lock on MessengerConnector::_mtx must be acquired before
      *   calling this method.
      */
@@ -357,13 +364,16 @@ private:
 
     /**
      * Callback handler fired upon a completion of the request sending.
+     * @param ptr  The request that was sent.
      * @param ec  An error code to be checked.
      * @param bytes_transferred  The number of bytes sent.
      */
-    void _requestSent(boost::system::error_code const& ec, size_t bytes_transferred);
+    void _requestSent(MessageWrapperBase::Ptr const& ptr, boost::system::error_code const& ec,
+                      size_t bytes_transferred);
 
     /**
-     * Begin receiving a response.
+     * Begin receiving a response unless another one is being received,
+     * or no responses are expected.
      * @param lock  A lock on MessengerConnector::_mtx must be acquired before
      *   calling this method.
      */
@@ -390,22 +400,19 @@ private:
 
     /**
      * Synchronously read a response header of a known size. Then parse it
-     * and analyze it to ensure its content matches expectations. Return
+     * and extract the identifier of a request the response is for. Return
      * the completion status of the operation.
      *
-     * The method will throw exception std::logic_error if the header's
-     * content won't match expectations.
-     *
      * @param lock  A lock on MessengerConnector::_mtx must be acquired before
      *   calling this method.
      * @param buf The buffer to use.
      * @param bytes  The expected length of the message (obtained from a preceding
      *   frame) to be received into the network buffer from the network.
-     * @param id  A unique identifier of a request to match the 'id' in a response header
+     * @param id  A unique identifier of a request found in the response header.
      * @return  The completion code of the operation.
      */
-    boost::system::error_code _syncReadVerifyHeader(replica::Lock const& lock, ProtocolBuffer& buf,
-                                                    size_t bytes, std::string const& id);
+    boost::system::error_code _syncReadHeader(replica::Lock const& lock, ProtocolBuffer& buf, size_t bytes,
+                                              std::string& id);
 
     /**
      * Synchronously read a message of a known size into the specified buffer.
@@ -455,6 +462,11 @@ private:
     /// the object).
     unsigned int const _timerIvalSec;
 
+    /// The cached parameter for the maximum number of requests sent
+    /// before receiving their responses (pulled from the Configuration
+    /// upon the construction of the object).
+    size_t const _pipelineWindow;
+
     /// The internal state
     State _state;
 
@@ -470,9 +482,20 @@ private:
     /// The priority-based queue of requests.
     MessageQueue<MessageWrapperBase> _requests;
 
-    /// The currently processed (being sent) request (if any, otherwise
-    /// the pointer is set to nullptr).
-    MessageWrapperBase::Ptr _currentRequest;
+    /// The requests sent (or being sent) to the worker and waiting for
+    /// responses. Requests cancelled while in flight are removed from here.
+    std::map<std::string, MessageWrapperBase::Ptr> _inFlight;
+
+    /// The identifiers of requests in the order they were sent, including
+    /// the ones cancelled while in flight, for as long as their responses
+    /// are expected. The size of the list is limited by the window.
+    std::list<std::string> _sentIds;
+
+    /// Is set while a request is being written into the socket.
+    bool _sending = false;
+
+    /// Is set while waiting for the frame of the next response.
+    bool _receiving = false;
 
     /// The intermediate buffer for messages received from a worker.
     ProtocolBuffer _inBuffer;
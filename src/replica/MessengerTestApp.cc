@@ -23,22 +23,36 @@
 #include "replica/MessengerTestApp.h"
 
 // System headers
+#include <algorithm>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <thread>
+
+// Third party headers
+#include "boost/asio.hpp"
 
 // Qserv headers
 #include "replica/Configuration.h"
 #include "replica/Controller.h"
 #include "replica/EchoRequest.h"
 #include "replica/Performance.h"
+#include "replica/protocol.pb.h"
+#include "replica/ProtocolBuffer.h"
 #include "replica/ServiceProvider.h"
-#include "util/BlockPost.h"
+
+// LSST headers
+#include "lsst/log/Log.h"
 
 using namespace std;
+using namespace std::placeholders;
+using namespace lsst::qserv::replica;
 
 namespace {
 
+LOG_LOGGER _log = LOG_GET("lsst.qserv.replica.MessengerTestApp");
+
 string const description =
         "Class MessengerTestApp implements a tool which tests the Messenger Network"
         " w/o leaving side effects on the workers. The tool will be sending and tracking"
@@ -48,6 +62,157 @@ bool const injectDatabaseOptions = false;
 bool const boostProtobufVersionCheck = true;
 bool const enableServiceProvider = true;
 
+/**
+ * Class EchoServerConnection answers requests of class EchoRequest sent over
+ * a connection to EchoServer. Like WorkerServerConnection, it reads the next
+ * request only after sending a response to the previous one. Requests are
+ * answered right away regardless of their 'processing' time.
+ */
+class EchoServerConnection : public enable_shared_from_this<EchoServerConnection> {
+public:
+    typedef shared_ptr<EchoServerConnection> Ptr;
+
+    EchoServerConnection(boost::asio::io_service& io_service, size_t bufferCapacityBytes)
+            : _socket(io_service), _buffer(bufferCapacityBytes) {}
+
+    boost::asio::ip::tcp::socket& socket() { return _socket; }
+
+    /// Begin receiving the next request.
+    void receive() {
+        size_t const bytes = sizeof(uint32_t);
+        _buffer.resize(bytes);
+        boost::asio::async_read(_socket, boost::asio::buffer(_buffer.data(), bytes),
+                                boost::asio::transfer_at_least(bytes),
+                                bind(&EchoServerConnection::_received, shared_from_this(), _1, _2));
+    }
+
+private:
+    void _received(boost::system::error_code const& ec, size_t bytes_transferred) {
+        if (ec.value() != 0) return;
+
+        uint64_t const receiveTimeMs = PerformanceUtils::now();
+        ProtocolRequestHeader hdr;
+        uint32_t bytes;
+        ProtocolRequestEcho request;
+        if (!_read(_buffer.parseLength(), hdr) || !_readLength(bytes) || !_read(bytes, request)) return;
+        if ((hdr.type() != ProtocolRequestHeader::QUEUED) ||
+            (hdr.queued_type() != ProtocolQueuedRequestType::TEST_ECHO)) {
+            // Closing the connection is the only option since the request can't be answered.
+            LOGS(_log, LOG_LVL_ERROR,
+                 "EchoServerConnection::" << __func__ << "  unsupported request id=" << hdr.id());
+            return;
+        }
+
+        ProtocolResponseEcho response;
+        response.set_status(ProtocolStatus::SUCCESS);
+        auto const performance = response.mutable_performance();
+        performance->set_receive_time(receiveTimeMs);
+        performance->set_start_time(receiveTimeMs);
+        performance->set_finish_time(PerformanceUtils::now());
+        response.set_data(request.data());
+        *(response.mutable_request()) = request;
+
+        ProtocolResponseHeader responseHdr;
+        responseHdr.set_id(hdr.id());
+        _buffer.resize();
+        _buffer.serialize(responseHdr);
+        _buffer.serialize(response);
+        boost::asio::async_write(_socket, boost::asio::buffer(_buffer.data(), _buffer.size()),
+                                 bind(&EchoServerConnection::_sent, shared_from_this(), _1, _2));
+    }
+
+    void _sent(boost::system::error_code const& ec, size_t bytes_transferred) {
+        if (ec.value() == 0) receive();
+    }
+
+    bool _readIntoBuffer(size_t bytes) {
+        _buffer.resize(bytes);
+        boost::system::error_code ec;
+        boost::asio::read(_socket, boost::asio::buffer(_buffer.data(), bytes),
+                          boost::asio::transfer_at_least(bytes), ec);
+        return ec.value() == 0;
+    }
+
+    bool _readLength(uint32_t& bytes) {
+        if (!_readIntoBuffer(sizeof(uint32_t))) return false;
+        bytes = _buffer.parseLength();
+        return true;
+    }
+
+    template <class T>
+    bool _read(size_t bytes, T& message) {
+        try {
+            if (_readIntoBuffer(bytes)) {
+                _buffer.parse(message, bytes);
+                return true;
+            }
+        } catch (exception const& ex) {
+            LOGS(_log, LOG_LVL_ERROR, "EchoServerConnection::" << __func__ << "  " << ex.what());
+        }
+        return false;
+    }
+
+    boost::asio::ip::tcp::socket _socket;
+    ProtocolBuffer _buffer;
+};
+
+/**
+ * Class EchoServer is a stand-in for the worker's WorkerServer. It accepts
+ * connections on the loopback interface and answers requests of class EchoRequest
+ * in a thread of its own.
+ */
+class EchoServer : public enable_shared_from_this<EchoServer> {
+public:
+    typedef shared_ptr<EchoServer> Ptr;
+
+    /**
+     * @param port  The port to listen on. The value of 0 will let the operating
+     *   system pick a free port.
+     * @param bufferCapacityBytes  The initial capacity of the connection buffers.
+     */
+    static Ptr create(uint16_t port, size_t bufferCapacityBytes) {
+        return Ptr(new EchoServer(port, bufferCapacityBytes));
+    }
+
+    /// @return The port the server listens on.
+    uint16_t port() const { return _acceptor.local_endpoint().port(); }
+
+    /// Begin accepting connections.
+    void start() {
+        _beginAccept();
+        _thread = thread([self = shared_from_this()]() { self->_io_service.run(); });
+    }
+
+    /// Stop the server and wait for its thread to finish.
+    void stop() {
+        _io_service.stop();
+        if (_thread.joinable()) _thread.join();
+    }
+
+private:
+    EchoServer(uint16_t port, size_t bufferCapacityBytes)
+            : _bufferCapacityBytes(bufferCapacityBytes),
+              _acceptor(_io_service,
+                        boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), port)) {}
+
+    void _beginAccept() {
+        auto const connection = make_shared<EchoServerConnection>(_io_service, _bufferCapacityBytes);
+        _acceptor.async_accept(connection->socket(),
+                               bind(&EchoServer::_accepted, shared_from_this(), connection, _1));
+    }
+
+    void _accepted(EchoServerConnection::Ptr const& connection, boost::system::error_code const& ec) {
+        if (ec == boost::asio::error::operation_aborted) return;
+        if (ec.value() == 0) connection->receive();
+        _beginAccept();
+    }
+
+    size_t const _bufferCapacityBytes;
+    boost::asio::io_service _io_service;
+    boost::asio::ip::tcp::acceptor _acceptor;
+    thread _thread;
+};
+
 }  // namespace
 
 namespace lsst::qserv::replica {
@@ -92,7 +257,23 @@ MessengerTestApp::MessengerTestApp(int argc, char* argv[])
                     _eventsReportIvalSec)
             .flag("report-request-events",
                   "Enable extended reporting on sending requests and analysing responses.",
-                  _reportRequestEvents);
+                  _reportRequestEvents)
+            .option("pipeline-window",
+                    "The maximum number of requests sent over a connection to the worker before"
+                    " receiving their responses. The default value of 0 will result in fetching"
+                    " a value of the parameter from the Replication System's configuration.",
+                    _pipelineWindow)
+            .flag("local-server",
+                  "Run a stand-in for the worker's server in this process and send requests to it."
+                  " The stand-in answers the requests right away regardless of their 'processing'"
+                  " time. The connection parameters of the worker are only changed in memory."
+                  " They may be overridden by the worker's record in the Registry if the worker"
+                  " is running.",
+                  _localServer)
+            .option("local-server-port",
+                    "The port of the stand-in server. The default value of 0 will let the operating"
+                    " system pick a free port.",
+                    _localServerPort);
 }
 
 int MessengerTestApp::runImpl() {
@@ -106,10 +287,27 @@ int MessengerTestApp::runImpl() {
                                to_string(_totalRequests) + " of requests.");
     }
 
+    auto const config = serviceProvider()->config();
+    if (_pipelineWindow != 0) config->set<size_t>("common", "request-pipeline-window", _pipelineWindow);
+
+    EchoServer::Ptr localServer;
+    if (_localServer) {
+        localServer = EchoServer::create(_localServerPort,
+                                         config->get<size_t>("common", "request-buf-size-bytes"));
+        localServer->start();
+        WorkerInfo workerInfo = config->workerInfo(_workerName);
+        workerInfo.svcHost.addr = "127.0.0.1";
+        workerInfo.svcHost.name = "localhost";
+        workerInfo.svcPort = localServer->port();
+        config->updateWorker(workerInfo);
+        cout << "local server: " << workerInfo.svcHost.addr << ":" << workerInfo.svcPort << endl;
+    }
+
     auto const controller = Controller::create(serviceProvider());
     bool const keepTracking = true;
     string const noParentJobId;
 
+    uint64_t const startTimeMs = PerformanceUtils::now();
     for (int i = 0; i < _totalRequests; ++i) {
         // Wait here if (while) the number of active requests is at
         // the allowed maximum.
@@ -149,14 +347,21 @@ int MessengerTestApp::runImpl() {
     }
 
     // Wait before all requests will finish.
-    util::BlockPost blockPost(1000, 1001);
-    while (_numFinished < _totalRequests) {
-        blockPost.wait();
+    {
+        unique_lock<mutex> lock(_mtx);
+        _onNumActiveCv.wait(lock, [&] { return _numFinished >= _totalRequests; });
     }
+    uint64_t const elapsedMs = max<uint64_t>(1, PerformanceUtils::now() - startTimeMs);
+    if (localServer != nullptr) localServer->stop();
 
     // Always make the final report to clear up remaining entries (if any)
     // in the event log.
     _reportEvents(unique_lock<mutex>(_mtx));
+
+    cout << "requests: " << _totalRequests << " success: " << _numSuccess
+         << " window: " << config->get<size_t>("common", "request-pipeline-window")
+         << " elapsed: " << fixed << setprecision(3) << elapsedMs / 1000. << " sec"
+         << " rate: " << setprecision(1) << 1000. * _totalRequests / elapsedMs << " req/s" << endl;
     return 0;
 }
 
@@ -37,7 +37,11 @@ namespace lsst::qserv::replica {
 /**
  * Class MessengerTestApp implements a tool which tests the Messenger Network
  * w/o leaving side effects on the workers. The tool will be sending and tracking
- * requests of class EchoRequest.
+ * requests of class EchoRequest. The rate of requests is reported upon completion.
+ *
+ * The tool may also run a stand-in for the worker's server in its own process,
+ * which would instantly answer the requests. This allows measuring the performance
+ * of the Messenger and its protocol w/o involving the worker.
  *
  * @see class EchoRequest
  */
@@ -122,6 +126,18 @@ private:
     /// Enable extended reporting on sending requests and analysing responses.
     bool _reportRequestEvents = false;
 
+    /// The maximum number of requests sent over a connection to the worker before
+    /// receiving their responses. The default value of 0 will result in fetching
+    /// a value of the parameter from the Replication System's configuration.
+    size_t _pipelineWindow = 0;
+
+    /// Run a stand-in for the worker's server in this process, and send requests to it.
+    bool _localServer = false;
+
+    /// The port of the stand-in server. The default value of 0 will let
+    /// the operating system pick a free port.
+    uint16_t _localServerPort = 0;
+
     // Synchronization primitives for tracking active requests
     // and updating statistics.
 
@@ -34,6 +34,7 @@
 #include "replica/ChunkLocker.h"
 #include "replica/NamedMutexRegistry.h"
 #include "replica/Mutex.h"
+#include "replica/WorkerReplicaInventory.h"
 
 // Forward declarations
 namespace lsst::qserv::replica {
@@ -116,6 +117,9 @@ public:
     /// @return a reference to the local (process) chunk locking services
     ChunkLocker& chunkLocker() { return _chunkLocker; }
 
+    /// @return a reference to the worker's inventory of chunk files
+    WorkerReplicaInventory& replicaInventory() { return _replicaInventory; }
+
     /// @return a reference to the database services
     std::shared_ptr<DatabaseServices> const& databaseServices();
 
@@ -196,6 +200,9 @@ private:
     /// operations to ensure consistency of the operations.
     ChunkLocker _chunkLocker;
 
+    /// For answering replica lookups at workers w/o scanning data directories
+    WorkerReplicaInventory _replicaInventory;
+
     /// Database services (lazy instantiation on a first request)
     std::shared_ptr<DatabaseServices> _databaseServices;
 
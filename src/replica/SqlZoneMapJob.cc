@@ -0,0 +1,228 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "replica/SqlZoneMapJob.h"
+
+// System headers
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+// Qserv headers
+#include "global/constants.h"
+#include "replica/ChunkedTable.h"
+#include "replica/SqlJobResult.h"
+#include "replica/SqlZoneMapRequest.h"
+#include "replica/StopRequest.h"
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+using namespace std;
+
+namespace {
+LOG_LOGGER _log = LOG_GET("lsst.qserv.replica.SqlZoneMapJob");
+uint64_t const unlimitedMaxRows = 0;
+
+/// @return The value of the bound of a range, moved one step towards the 'outside'
+///   unless it's an integer which a double represents exactly. This guarantees that
+///   the rounding of the value never narrows the range.
+double rangeBound(string const& str, double outside) {
+    double const value = stod(str);
+    bool const exact =
+            str.find_first_not_of("+-0123456789") == string::npos && abs(value) < 9007199254740992.0;
+    return exact ? value : nextafter(value, outside);
+}
+}  // namespace
+
+namespace lsst::qserv::replica {
+
+string SqlZoneMapJob::typeName() { return "SqlZoneMapJob"; }
+
+SqlZoneMapJob::Ptr SqlZoneMapJob::create(string const& database, string const& table,
+                                         vector<string> const& columns, bool allWorkers,
+                                         Controller::Ptr const& controller, string const& parentJobId,
+                                         CallbackType const& onFinish, int priority) {
+    return Ptr(new SqlZoneMapJob(database, table, columns, allWorkers, controller, parentJobId, onFinish,
+                                 priority));
+}
+
+SqlZoneMapJob::SqlZoneMapJob(string const& database, string const& table, vector<string> const& columns,
+                             bool allWorkers, Controller::Ptr const& controller, string const& parentJobId,
+                             CallbackType const& onFinish, int priority)
+        : SqlJob(::unlimitedMaxRows, allWorkers, controller, parentJobId, "SQL_TABLE_ZONE_MAP", priority),
+          _database(database),
+          _table(table),
+          _columns(columns),
+          _onFinish(onFinish) {}
+
+SqlZoneMapJob::ZoneMap const& SqlZoneMapJob::zoneMap() const {
+    if (state() == State::FINISHED) return _zoneMap;
+    throw logic_error("SqlZoneMapJob::" + string(__func__) +
+                      "  the method can't be called while the job hasn't finished");
+}
+
+list<pair<string, string>> SqlZoneMapJob::extendedPersistentState() const {
+    list<pair<string, string>> result;
+    result.emplace_back("database", database());
+    result.emplace_back("table", table());
+    string columns;
+    for (auto&& column : _columns) columns += (columns.empty() ? "" : ",") + column;
+    result.emplace_back("columns", columns);
+    result.emplace_back("all_workers", bool2str(allWorkers()));
+    return result;
+}
+
+list<SqlRequest::Ptr> SqlZoneMapJob::launchRequests(replica::Lock const& lock, string const& worker,
+                                                    size_t maxRequestsPerWorker) {
+    list<SqlRequest::Ptr> requests;
+    if (maxRequestsPerWorker == 0) return requests;
+
+    // Make sure this worker has already been served
+    if (_workers.count(worker) != 0) return requests;
+    _workers.insert(worker);
+
+    // Only the chunk tables are going to be processed at the worker.
+    bool const allTables = false;
+    bool const overlapTablesOnly = false;
+    vector<string> const tables2process =
+            workerTables(worker, database(), table(), allTables, overlapTablesOnly);
+
+    // Divide tables into subsets allocated to the "batch" requests. Then launch
+    // the requests for the current worker.
+    bool const keepTracking = true;
+    auto const self = shared_from_base<SqlZoneMapJob>();
+    for (auto&& tables : distributeTables(tables2process, maxRequestsPerWorker)) {
+        requests.push_back(controller()->sqlZoneMap(
+                worker, database(), tables, columns(),
+                [self](SqlZoneMapRequest::Ptr const& request) { self->onRequestFinish(request); },
+                priority(), keepTracking, id()));
+    }
+    return requests;
+}
+
+void SqlZoneMapJob::stopRequest(replica::Lock const& lock, SqlRequest::Ptr const& request) {
+    stopRequestDefaultImpl<StopSqlZoneMapRequest>(lock, request);
+}
+
+void SqlZoneMapJob::notify(replica::Lock const& lock) {
+    LOGS(_log, LOG_LVL_DEBUG, context() << __func__ << "[" << typeName() << "]");
+    notifyDefaultImpl<SqlZoneMapJob>(lock, _onFinish);
+}
+
+void SqlZoneMapJob::processResultAndFinish(replica::Lock const& lock, ExtendedState extendedState) {
+    string const context_ = context() + string(__func__) + " ";
+
+    // A partial zone map can't be used since a chunk missing in the map
+    // would be indistinguishable from the one which has no rows.
+    if (extendedState == ExtendedState::SUCCESS) {
+        bool dataError = false;
+        getResultData(lock).iterate([&](SqlJobResult::Worker const& worker,
+                                        SqlJobResult::Scope const& internalTable,
+                                        SqlResultSet::ResultSet const& resultSet) {
+            bool const succeeded = _process(context_, worker, internalTable, resultSet);
+            dataError = dataError || !succeeded;
+        });
+        if (dataError) {
+            _zoneMap.clear();
+            finish(lock, ExtendedState::BAD_RESULT);
+            return;
+        }
+    }
+    finish(lock, extendedState);
+}
+
+bool SqlZoneMapJob::_process(string const& context_, SqlJobResult::Worker const& worker,
+                             SqlJobResult::Scope const& internalTable,
+                             SqlResultSet::ResultSet const& resultSet) {
+    bool const succeeded = true;
+    auto const reportResultThatHas = [&](string const& problem) {
+        LOGS(_log, LOG_LVL_ERROR,
+             context_ << "result set received from worker '" << worker << "' for table '" << internalTable
+                      << "' has " << problem);
+    };
+
+    // Skip special tables.
+    if (internalTable == table()) return succeeded;
+    unsigned int chunk = 0;
+    try {
+        ChunkedTable const chunkedTable(internalTable);
+        if (chunkedTable.chunk() == lsst::qserv::DUMMY_CHUNK) return succeeded;
+        if (chunkedTable.baseName() != table() || chunkedTable.overlap()) {
+            reportResultThatHas("incorrect name of the chunk table");
+            return !succeeded;
+        }
+        chunk = chunkedTable.chunk();
+    } catch (...) {
+        reportResultThatHas("incorrect name of the partitioned table");
+        return !succeeded;
+    }
+
+    // Expecting a result set that has exactly one row per column:
+    //
+    //   'column_name' | 'min_value' | 'max_value' | 'num_nulls'
+    //  ---------------+-------------+-------------+-------------
+    //
+    if (resultSet.fields.size() != 4 || resultSet.fields[0].name != "column_name" ||
+        resultSet.fields[1].name != "min_value" || resultSet.fields[2].name != "max_value" ||
+        resultSet.fields[3].name != "num_nulls" || resultSet.rows.size() != _columns.size()) {
+        reportResultThatHas("unexpected format");
+        return !succeeded;
+    }
+    auto& columns = _zoneMap[chunk];
+    for (auto&& row : resultSet.rows) {
+        if (row.nulls[0] || row.nulls[3] || row.nulls[1] != row.nulls[2]) {
+            reportResultThatHas("unexpected NULL values");
+            return !succeeded;
+        }
+        Range range;
+        try {
+            range.numNulls = stoull(row.cells[3]);
+            if (!row.nulls[1]) {
+                range.hasValues = true;
+                range.minValue = rangeBound(row.cells[1], -numeric_limits<double>::infinity());
+                range.maxValue = rangeBound(row.cells[2], numeric_limits<double>::infinity());
+            }
+        } catch (exception const&) {
+            reportResultThatHas("values that can't be interpreted as numbers in column '" + row.cells[0] +
+                                "'");
+            return !succeeded;
+        }
+        // Replicas of the same chunk are merged into the range which covers all of them.
+        auto const itr = columns.find(row.cells[0]);
+        if (itr == columns.end()) {
+            columns[row.cells[0]] = range;
+            continue;
+        }
+        Range& merged = itr->second;
+        if (range.hasValues) {
+            merged.minValue = merged.hasValues ? min(merged.minValue, range.minValue) : range.minValue;
+            merged.maxValue = merged.hasValues ? max(merged.maxValue, range.maxValue) : range.maxValue;
+            merged.hasValues = true;
+        }
+        merged.numNulls = max(merged.numNulls, range.numNulls);
+    }
+    return succeeded;
+}
+
+}  // namespace lsst::qserv::replica
@@ -0,0 +1,161 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_REPLICA_SQLZONEMAPJOB_H
+#define LSST_QSERV_REPLICA_SQLZONEMAPJOB_H
+
+// System headers
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// Qserv headers
+#include "replica/Common.h"
+#include "replica/SqlJob.h"
+
+// This header declarations
+namespace lsst::qserv::replica {
+
+/**
+ * Class SqlZoneMapJob represents a tool which will broadcast batches of requests
+ * for the ranges (MIN, MAX) and the number of NULLs of the specified numeric columns
+ * of the chunk tables of a partitioned table to workers. The ranges reported for
+ * the replicas of the same chunk are merged, so that each range covers all rows
+ * found in any replica of the chunk.
+ *
+ * The zone maps are used by Qserv czar for skipping chunks which can't have
+ * any rows that would satisfy the range restrictions of a query. Overlap tables,
+ * prototype tables and the "dummy chunk" tables are not scanned.
+ */
+class SqlZoneMapJob : public SqlJob {
+public:
+    typedef std::shared_ptr<SqlZoneMapJob> Ptr;
+
+    /// The function type for notifications on the completion of the request
+    typedef std::function<void(Ptr)> CallbackType;
+
+    /// The range of values of a column within a chunk. Bounds which a double
+    /// can't represent exactly are moved outwards by the smallest step.
+    struct Range {
+        bool hasValues = false;  ///< 'false' if the column has only NULLs, or no rows at all
+        double minValue = 0;
+        double maxValue = 0;
+        uint64_t numNulls = 0;
+    };
+
+    /// Ranges of the columns of chunks: [chunk][column]
+    typedef std::map<unsigned int, std::map<std::string, Range>> ZoneMap;
+
+    /// @return the unique name distinguishing this class from other types of jobs
+    static std::string typeName();
+
+    /**
+     * Static factory method is needed to prevent issue with the lifespan
+     * and memory management of instances created otherwise (as values or via
+     * low-level pointers).
+     *
+     * @param database The name of a database where the tables are residing.
+     * @param table The name of the base (partitioned) table to be affected by the operation.
+     * @param columns The names of the numeric columns of the table.
+     * @param allWorkers The flag which if set to 'true' will engage all known
+     *   workers regardless of their status. If the flag is set to 'false' then
+     *   only 'ENABLED' workers which are not in the 'READ-ONLY' state will be
+     *   involved into the operation.
+     * @param controller This is needed launching requests and accessing the Configuration.
+     * @param parentJobId An identifier of a parent job.
+     * @param onFinish A callback function to be called upon a completion of the job.
+     * @param priority The priority level of the job.
+     * @return A pointer to the created object.
+     */
+    static Ptr create(std::string const& database, std::string const& table,
+                      std::vector<std::string> const& columns, bool allWorkers,
+                      Controller::Ptr const& controller, std::string const& parentJobId,
+                      CallbackType const& onFinish, int priority);
+
+    SqlZoneMapJob() = delete;
+    SqlZoneMapJob(SqlZoneMapJob const&) = delete;
+    SqlZoneMapJob& operator=(SqlZoneMapJob const&) = delete;
+
+    ~SqlZoneMapJob() final = default;
+
+    std::string const& database() const { return _database; }
+    std::string const& table() const { return _table; }
+    std::vector<std::string> const& columns() const { return _columns; }
+
+    /**
+     * @note The method should be invoked only after the job has successfully finished.
+     * @return The merged ranges of the columns.
+     * @throw std::logic_error If the job didn't finished at a time when the method was called.
+     */
+    ZoneMap const& zoneMap() const;
+
+    std::list<std::pair<std::string, std::string>> extendedPersistentState() const final;
+
+protected:
+    void notify(replica::Lock const& lock) final;
+
+    std::list<SqlRequest::Ptr> launchRequests(replica::Lock const& lock, std::string const& worker,
+                                              size_t maxRequestsPerWorker) final;
+
+    void stopRequest(replica::Lock const& lock, SqlRequest::Ptr const& request) final;
+    void processResultAndFinish(replica::Lock const& lock, ExtendedState extendedState) final;
+
+private:
+    SqlZoneMapJob(std::string const& database, std::string const& table,
+                  std::vector<std::string> const& columns, bool allWorkers, Controller::Ptr const& controller,
+                  std::string const& parentJobId, CallbackType const& onFinish, int priority);
+
+    /**
+     * @brief Process a result set and (in case of success) merge the ranges into the zone map.
+     *
+     * @param context_ The prefix for reporting errors.
+     * @param worker The name of a worker.
+     * @param internalTable The name of the internal (at the worker) table.
+     * @param resultSet A result set to be analyzed.
+     * @return true If succeeded.
+     * @return false If failed.
+     */
+    bool _process(std::string const& context_, SqlJobResult::Worker const& worker,
+                  SqlJobResult::Scope const& internalTable, SqlResultSet::ResultSet const& resultSet);
+
+    // Input parameters
+
+    std::string const _database;
+    std::string const _table;
+    std::vector<std::string> const _columns;
+
+    CallbackType _onFinish;  /// @note is reset when the job finishes
+
+    /// A registry of workers to mark those for which request has been sent.
+    /// The registry prevents duplicate requests because exactly one
+    /// such request is permitted to be sent to each worker.
+    std::set<std::string> _workers;
+
+    /// The merged ranges (filled upon the successful completion of the job).
+    ZoneMap _zoneMap;
+};
+
+}  // namespace lsst::qserv::replica
+
+#endif  // LSST_QSERV_REPLICA_SQLZONEMAPJOB_H
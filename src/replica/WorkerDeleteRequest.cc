@@ -143,6 +143,7 @@ bool WorkerDeleteRequestPOSIX::execute() {
             errorContext = errorContext or reportErrorIf(ec.value() != 0, ProtocolStatusExt::FILE_DELETE,
                                                          "failed to delete file: " + file.string());
         }
+        _serviceProvider->replicaInventory().invalidate(database(), chunk());
     }
     if (errorContext.failed) {
         setStatus(lock, ProtocolStatus::FAILED, errorContext.extendedStatus);
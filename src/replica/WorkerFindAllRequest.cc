@@ -33,6 +33,7 @@
 #include "replica/FileUtils.h"
 #include "replica/Performance.h"
 #include "replica/ServiceProvider.h"
+#include "replica/WorkerReplicaInventory.h"
 
 // LSST headers
 #include "lsst/log/Log.h"
@@ -131,57 +132,97 @@ bool WorkerFindAllRequestPOSIX::execute() {
     auto const config = _serviceProvider->config();
     DatabaseInfo const databaseInfo = config->databaseInfo(database());
 
-    // Scan the data directory to find all files which match the expected pattern(s)
-    // and group them by their chunk number
+    // Files of chunks are looked up in the worker's inventory. The data directory
+    // is scanned to find all files which match the expected pattern(s) and group them
+    // by their chunk number only if the inventory of the database is missing or too old.
+    // Otherwise only files of chunks changed since the previous lookup are examined.
+
+    WorkerReplicaInventory& inventory = _serviceProvider->replicaInventory();
+    unsigned int const maxAgeSec = config->get<unsigned int>("worker", "replica-inventory-ttl-sec");
 
     WorkerRequest::ErrorContext errorContext;
     boost::system::error_code ec;
 
-    map<unsigned int, ReplicaInfo::FileInfoCollection> chunk2fileInfoCollection;
+    auto const fileInfo = [&](fs::path const& file) -> ReplicaInfo::FileInfo {
+        uint64_t const size = fs::file_size(file, ec);
+        errorContext = errorContext or reportErrorIf(ec.value() != 0, ProtocolStatusExt::FILE_SIZE,
+                                                     "failed to read file size: " + file.string());
+
+        time_t const mtime = fs::last_write_time(file, ec);
+        errorContext = errorContext or reportErrorIf(ec.value() != 0, ProtocolStatusExt::FILE_MTIME,
+                                                     "failed to read file mtime: " + file.string());
+        return ReplicaInfo::FileInfo({
+                file.filename().string(), size, mtime,
+                "",  /* cs is never computed for this type of requests */
+                0,   /* beginTransferTime */
+                0,   /* endTransferTime */
+                size /* inSize */
+        });
+    };
+
+    WorkerReplicaInventory::ChunkFiles chunk2fileInfoCollection;
     {
         replica::Lock dataFolderLock(_mtxDataFolderOperations, context(__func__));
 
         fs::path const dataDir = fs::path(config->get<string>("worker", "data-dir")) / database();
-        fs::file_status const stat = fs::status(dataDir, ec);
-        errorContext = errorContext or
-                       reportErrorIf(stat.type() == fs::status_error, ProtocolStatusExt::FOLDER_STAT,
-                                     "failed to check the status of directory: " + dataDir.string()) or
-                       reportErrorIf(not fs::exists(stat), ProtocolStatusExt::NO_FOLDER,
-                                     "the directory does not exists: " + dataDir.string());
-        try {
-            for (fs::directory_entry& entry : fs::directory_iterator(dataDir)) {
-                tuple<string, unsigned int, string> parsed;
-                if (FileUtils::parsePartitionedFile(parsed, entry.path().filename().string(), databaseInfo)) {
-                    LOGS(_log, LOG_LVL_DEBUG,
-                         context(__func__) << "  database: " << database() << "  file: "
-                                           << entry.path().filename() << "  table: " << get<0>(parsed)
-                                           << "  chunk: " << get<1>(parsed) << "  ext: " << get<2>(parsed));
-
-                    uint64_t const size = fs::file_size(entry.path(), ec);
-                    errorContext = errorContext or
-                                   reportErrorIf(ec.value() != 0, ProtocolStatusExt::FILE_SIZE,
-                                                 "failed to read file size: " + entry.path().string());
-
-                    time_t const mtime = fs::last_write_time(entry.path(), ec);
-                    errorContext = errorContext or
-                                   reportErrorIf(ec.value() != 0, ProtocolStatusExt::FILE_MTIME,
-                                                 "failed to read file mtime: " + entry.path().string());
-
-                    unsigned const chunk = get<1>(parsed);
-
-                    chunk2fileInfoCollection[chunk].emplace_back(ReplicaInfo::FileInfo({
-                            entry.path().filename().string(), size, mtime,
-                            "",  /* cs is never computed for this type of requests */
-                            0,   /* beginTransferTime */
-                            0,   /* endTransferTime */
-                            size /* inSize */
-                    }));
+        uint64_t const sequence = inventory.sequence();
+        WorkerReplicaInventory::StaleChunks staleChunks;
+
+        if (inventory.find(database(), maxAgeSec, chunk2fileInfoCollection, staleChunks)) {
+            LOGS(_log, LOG_LVL_DEBUG,
+                 context(__func__) << "  database: " << database()
+                                   << "  chunks: " << chunk2fileInfoCollection.size()
+                                   << "  stale chunks: " << staleChunks.size());
+
+            for (auto&& entry : staleChunks) {
+                unsigned int const chunk = entry.first;
+                ReplicaInfo::FileInfoCollection fileInfoCollection;
+                for (auto&& name : FileUtils::partitionedFiles(databaseInfo, chunk)) {
+                    fs::path const file = dataDir / name;
+                    fs::file_status const stat = fs::status(file, ec);
+                    errorContext =
+                            errorContext or
+                            reportErrorIf(stat.type() == fs::status_error, ProtocolStatusExt::FILE_STAT,
+                                          "failed to check the status of file: " + file.string());
+                    if (fs::exists(stat)) fileInfoCollection.push_back(fileInfo(file));
+                }
+                if (errorContext.failed) break;
+                if (fileInfoCollection.empty()) {
+                    chunk2fileInfoCollection.erase(chunk);
+                } else {
+                    chunk2fileInfoCollection[chunk] = fileInfoCollection;
+                }
+                inventory.update(database(), chunk, fileInfoCollection, sequence);
+            }
+        } else {
+            fs::file_status const stat = fs::status(dataDir, ec);
+            errorContext = errorContext or
+                           reportErrorIf(stat.type() == fs::status_error, ProtocolStatusExt::FOLDER_STAT,
+                                         "failed to check the status of directory: " + dataDir.string()) or
+                           reportErrorIf(not fs::exists(stat), ProtocolStatusExt::NO_FOLDER,
+                                         "the directory does not exists: " + dataDir.string());
+            try {
+                for (fs::directory_entry& entry : fs::directory_iterator(dataDir)) {
+                    tuple<string, unsigned int, string> parsed;
+                    if (FileUtils::parsePartitionedFile(parsed, entry.path().filename().string(),
+                                                        databaseInfo)) {
+                        LOGS(_log, LOG_LVL_DEBUG,
+                             context(__func__)
+                                     << "  database: " << database() << "  file: " << entry.path().filename()
+                                     << "  table: " << get<0>(parsed) << "  chunk: " << get<1>(parsed)
+                                     << "  ext: " << get<2>(parsed));
+
+                        unsigned const chunk = get<1>(parsed);
+                        chunk2fileInfoCollection[chunk].push_back(fileInfo(entry.path()));
+                    }
                 }
+            } catch (fs::filesystem_error const& ex) {
+                errorContext = errorContext or
+                               reportErrorIf(true, ProtocolStatusExt::FOLDER_READ,
+                                             "failed to read the directory: " + dataDir.string() +
+                                                     ", error: " + string(ex.what()));
             }
-        } catch (fs::filesystem_error const& ex) {
-            errorContext = errorContext or reportErrorIf(true, ProtocolStatusExt::FOLDER_READ,
-                                                         "failed to read the directory: " + dataDir.string() +
-                                                                 ", error: " + string(ex.what()));
+            if (!errorContext.failed) inventory.load(database(), chunk2fileInfoCollection, sequence);
         }
     }
     if (errorContext.failed) {
@@ -101,7 +101,9 @@ protected:
 /**
  * Class WorkerFindAllRequestPOSIX provides an actual implementation for
  * the replicas lookup based on the direct manipulation of files on
- * a POSIX file system.
+ * a POSIX file system. Results of the previous lookups are kept in
+ * the worker's replica inventory.
+ * @see class WorkerReplicaInventory
  */
 class WorkerFindAllRequestPOSIX : public WorkerFindAllRequest {
 public:
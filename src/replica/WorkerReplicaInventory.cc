@@ -0,0 +1,116 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "replica/WorkerReplicaInventory.h"
+
+// System headers
+#include <algorithm>
+
+// Qserv headers
+#include "replica/Performance.h"
+
+using namespace std;
+
+namespace lsst::qserv::replica {
+
+uint64_t WorkerReplicaInventory::sequence() const {
+    replica::Lock const lock(_mtx, "WorkerReplicaInventory::" + string(__func__));
+    return _sequence;
+}
+
+bool WorkerReplicaInventory::find(string const& database, unsigned int maxAgeSec, ChunkFiles& chunkFiles,
+                                  StaleChunks& staleChunks) const {
+    if (maxAgeSec == 0) return false;
+    replica::Lock const lock(_mtx, "WorkerReplicaInventory::" + string(__func__));
+    auto const itr = _databases.find(database);
+    if (itr == _databases.end()) return false;
+    DatabaseInventory const& inventory = itr->second;
+    if (!inventory.loaded) return false;
+    if (inventory.loadTimeMs + 1000ULL * maxAgeSec < PerformanceUtils::now()) return false;
+    chunkFiles = inventory.chunkFiles;
+    staleChunks = inventory.staleChunks;
+    return true;
+}
+
+void WorkerReplicaInventory::load(string const& database, ChunkFiles const& chunkFiles, uint64_t sequence) {
+    replica::Lock const lock(_mtx, "WorkerReplicaInventory::" + string(__func__));
+    DatabaseInventory& inventory = _databases[database];
+    if (max(inventory.invalidated, _invalidatedAll) > sequence) return;
+    inventory.loaded = true;
+    inventory.loadTimeMs = PerformanceUtils::now();
+    inventory.loadSequence = sequence;
+    inventory.chunkFiles = chunkFiles;
+
+    // Chunks invalidated during the scan may have been seen before the change.
+    for (auto itr = inventory.staleChunks.begin(); itr != inventory.staleChunks.end();) {
+        if (itr->second <= sequence) {
+            itr = inventory.staleChunks.erase(itr);
+        } else {
+            ++itr;
+        }
+    }
+}
+
+void WorkerReplicaInventory::update(string const& database, unsigned int chunk,
+                                    ReplicaInfo::FileInfoCollection const& files, uint64_t sequence) {
+    replica::Lock const lock(_mtx, "WorkerReplicaInventory::" + string(__func__));
+    auto const itr = _databases.find(database);
+    if (itr == _databases.end()) return;
+    DatabaseInventory& inventory = itr->second;
+
+    // The files may have been examined before the last scan of the directory.
+    if (!inventory.loaded || sequence < inventory.loadSequence) return;
+
+    if (files.empty()) {
+        inventory.chunkFiles.erase(chunk);
+    } else {
+        inventory.chunkFiles[chunk] = files;
+    }
+    auto const staleItr = inventory.staleChunks.find(chunk);
+    if (staleItr != inventory.staleChunks.end() && staleItr->second <= sequence) {
+        inventory.staleChunks.erase(staleItr);
+    }
+}
+
+void WorkerReplicaInventory::invalidate(string const& database, unsigned int chunk) {
+    replica::Lock const lock(_mtx, "WorkerReplicaInventory::" + string(__func__));
+    _databases[database].staleChunks[chunk] = ++_sequence;
+}
+
+void WorkerReplicaInventory::invalidate(string const& database) {
+    replica::Lock const lock(_mtx, "WorkerReplicaInventory::" + string(__func__));
+    DatabaseInventory& inventory = _databases[database];
+    inventory.loaded = false;
+    inventory.invalidated = ++_sequence;
+    inventory.chunkFiles.clear();
+}
+
+void WorkerReplicaInventory::invalidateAll() {
+    replica::Lock const lock(_mtx, "WorkerReplicaInventory::" + string(__func__));
+    _invalidatedAll = ++_sequence;
+    for (auto&& entry : _databases) {
+        entry.second.loaded = false;
+        entry.second.chunkFiles.clear();
+    }
+}
+
+}  // namespace lsst::qserv::replica
@@ -0,0 +1,151 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_REPLICA_WORKERREPLICAINVENTORY_H
+#define LSST_QSERV_REPLICA_WORKERREPLICAINVENTORY_H
+
+// System headers
+#include <cstdint>
+#include <map>
+#include <string>
+
+// Qserv headers
+#include "replica/Mutex.h"
+#include "replica/ReplicaInfo.h"
+
+// This header declarations
+namespace lsst::qserv::replica {
+
+/**
+ * Class WorkerReplicaInventory is the worker's in-memory inventory of the chunk
+ * files found in the data directories of databases. The inventory of a database is
+ * loaded by the replica lookup requests after scanning the directory. After that
+ * the requests only need to re-examine files of chunks which were reported
+ * (invalidated) by the worker's operations modifying the files since the previous
+ * lookup.
+ *
+ * Each invalidation is given the next number of a sequence. A lookup reads the current
+ * number of the sequence before it begins examining files, and passes the number along
+ * with the results to the inventory. The inventory uses the number to ignore results
+ * which may predate the latest changes made to the files.
+ *
+ * @note This class has thread-safe implementation. However, operations examining
+ *   files of the same database are expected to be serialized by the caller.
+ */
+class WorkerReplicaInventory {
+public:
+    /// Files of chunks
+    typedef std::map<unsigned int, ReplicaInfo::FileInfoCollection> ChunkFiles;
+
+    /// Chunks to be re-examined, and the numbers of the latest invalidations of the chunks
+    typedef std::map<unsigned int, uint64_t> StaleChunks;
+
+    WorkerReplicaInventory() = default;
+    WorkerReplicaInventory(WorkerReplicaInventory const&) = delete;
+    WorkerReplicaInventory& operator=(WorkerReplicaInventory const&) = delete;
+    ~WorkerReplicaInventory() = default;
+
+    /// @return The current number of the invalidation sequence.
+    uint64_t sequence() const;
+
+    /**
+     * Find the inventory of a database.
+     *
+     * @param database The name of a database.
+     * @param maxAgeSec The maximum age of the inventory. The value of 0 would result
+     *   in ignoring the inventory.
+     * @param chunkFiles Files of chunks are returned here.
+     * @param staleChunks Chunks which need to be re-examined are returned here.
+     * @return 'false' if the inventory of the database wasn't loaded, or if it's older
+     *   than the specified age, or if it was invalidated in its entirety.
+     */
+    bool find(std::string const& database, unsigned int maxAgeSec, ChunkFiles& chunkFiles,
+              StaleChunks& staleChunks) const;
+
+    /**
+     * Replace the inventory of a database with the results of a full scan of its directory.
+     * The results will be ignored if the database was invalidated in its entirety after
+     * the specified number of the sequence.
+     *
+     * @param database The name of a database.
+     * @param chunkFiles Files of chunks found by the scan.
+     * @param sequence The number of the sequence read before beginning the scan.
+     */
+    void load(std::string const& database, ChunkFiles const& chunkFiles, uint64_t sequence);
+
+    /**
+     * Update files of a chunk after re-examining them. The chunk will remain stale if
+     * it was invalidated after the specified number of the sequence.
+     *
+     * @param database The name of a database.
+     * @param chunk The chunk number.
+     * @param files Files of the chunk. The empty collection removes the chunk from
+     *   the inventory.
+     * @param sequence The number of the sequence read before examining the files.
+     */
+    void update(std::string const& database, unsigned int chunk, ReplicaInfo::FileInfoCollection const& files,
+                uint64_t sequence);
+
+    /**
+     * Report a change made to files of a chunk. The method must be called
+     * after making the change.
+     *
+     * @param database The name of a database.
+     * @param chunk The chunk number.
+     */
+    void invalidate(std::string const& database, unsigned int chunk);
+
+    /**
+     * Report a change which may affect any files of a database. The next lookup
+     * will scan the directory of the database.
+     *
+     * @param database The name of a database.
+     */
+    void invalidate(std::string const& database);
+
+    /// Report a change which may affect files of any database.
+    void invalidateAll();
+
+private:
+    /// The inventory of a database
+    struct DatabaseInventory {
+        bool loaded = false;
+        uint64_t loadTimeMs = 0;    ///< When the inventory was loaded.
+        uint64_t loadSequence = 0;  ///< The number of the sequence read before the scan.
+        uint64_t invalidated = 0;   ///< The number of the latest invalidation of the database.
+        ChunkFiles chunkFiles;
+        StaleChunks staleChunks;
+    };
+
+    /// The last number of the invalidation sequence
+    uint64_t _sequence = 0;
+
+    /// The number of the latest invalidation of all databases
+    uint64_t _invalidatedAll = 0;
+
+    std::map<std::string, DatabaseInventory> _databases;
+
+    /// The mutex for enforcing thread safety of the class's public API.
+    mutable replica::Mutex _mtx;
+};
+
+}  // namespace lsst::qserv::replica
+
+#endif  // LSST_QSERV_REPLICA_WORKERREPLICAINVENTORY_H
@@ -320,6 +320,7 @@ bool WorkerReplicationRequestPOSIX::execute() {
                            reportErrorIf(ec.value() != 0, ProtocolStatusExt::FILE_MTIME,
                                          "failed to set the mtime of output file: " + outFile.string());
         }
+        serviceProvider()->replicaInventory().invalidate(database(), chunk());
     }
     if (errorContext.failed) {
         setStatus(lock, ProtocolStatus::FAILED, errorContext.extendedStatus);
@@ -717,6 +718,7 @@ bool WorkerReplicationRequestFS::_finalize(replica::Lock const& lock) {
         errorContext = errorContext or reportErrorIf(ec.value() != 0, ProtocolStatusExt::FILE_MTIME,
                                                      "failed to change 'mtime' of file: " + tmpFile.string());
     }
+    serviceProvider()->replicaInventory().invalidate(database(), chunk());
 
     if (errorContext.failed) {
         setStatus(lock, ProtocolStatus::FAILED, errorContext.extendedStatus);
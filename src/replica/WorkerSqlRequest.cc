@@ -212,6 +212,7 @@ bool WorkerSqlRequest::execute() {
     } catch (exception const& ex) {
         _reportFailure(lock, ProtocolStatusExt::OTHER_EXCEPTION, ex.what());
     }
+    _invalidateReplicaInventory();
     return true;
 }
 
@@ -367,6 +368,27 @@ Query WorkerSqlRequest::_query(Connection::Ptr const& conn, string const& table)
                     g.from(DoNotProcess(databaseTable)) + g.groupBy("qserv_trans_id");
             return Query(query);
         }
+        case ProtocolRequestSql::TABLE_ZONE_MAP: {
+            // One row per column. The range of an empty table, or of a column
+            // which only has NULLs, is NULL. The values are converted to DOUBLE,
+            // which (unlike FLOAT) is printed with the digits needed to read
+            // back the same value.
+            string query;
+            for (int i = 0; i < _request.zone_map_columns_size(); ++i) {
+                string const& column = _request.zone_map_columns(i);
+                Sql const minValue(g.MIN(column).str + "+0E0");
+                Sql const maxValue(g.MAX(column).str + "+0E0");
+                if (!query.empty()) query += " UNION ALL ";
+                query += g.select(g.as(g.val(column), "column_name"), g.as(minValue, "min_value"),
+                                  g.as(maxValue, "max_value"), g.as(g.NUM_NULLS(column), "num_nulls")) +
+                         g.from(DoNotProcess(databaseTable));
+            }
+            if (query.empty()) {
+                throw invalid_argument("WorkerSqlRequest::" + string(__func__) +
+                                       "  no columns were provided for the zone map of table: " + table);
+            }
+            return Query(query);
+        }
         default:
             throw invalid_argument(
                     "WorkerSqlRequest::" + string(__func__) +
@@ -435,4 +457,25 @@ ProtocolResponseSqlResultSet* WorkerSqlRequest::_currentResultSet(replica::Lock
 
 bool WorkerSqlRequest::_batchMode() const { return _request.has_batch_mode() and _request.batch_mode(); }
 
+void WorkerSqlRequest::_invalidateReplicaInventory() {
+    switch (_request.type()) {
+        case ProtocolRequestSql::ENABLE_DATABASE:
+        case ProtocolRequestSql::DISABLE_DATABASE:
+        case ProtocolRequestSql::GRANT_ACCESS:
+        case ProtocolRequestSql::GET_TABLE_INDEX:
+        case ProtocolRequestSql::TABLE_ROW_STATS:
+        case ProtocolRequestSql::TABLE_ZONE_MAP:
+            return;
+        default:
+            break;
+    }
+    // Arbitrary queries aren't limited to the database of the request.
+    auto& inventory = serviceProvider()->replicaInventory();
+    if (_request.type() == ProtocolRequestSql::QUERY or _request.database().empty()) {
+        inventory.invalidateAll();
+    } else {
+        inventory.invalidate(_request.database());
+    }
+}
+
 }  // namespace lsst::qserv::replica
@@ -153,6 +153,10 @@ private:
     /// @return 'true' if the request issues multiple queries
     bool _batchMode() const;
 
+    /// Report tables which may have been created, dropped or modified by the request
+    /// to the worker's replica inventory.
+    void _invalidateReplicaInventory();
+
     // Input parameters
 
     ProtocolRequestSql const _request;
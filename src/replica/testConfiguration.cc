@@ -114,6 +114,7 @@ BOOST_AUTO_TEST_CASE(ConfigurationTestReadingGeneralParameters) {
     // Fetching values of general parameters.
     BOOST_CHECK(config->get<size_t>("common", "request-buf-size-bytes") == 8192);
     BOOST_CHECK(config->get<unsigned int>("common", "request-retry-interval-sec") == 1);
+    BOOST_CHECK(config->get<size_t>("common", "request-pipeline-window") == 4);
 
     BOOST_CHECK(config->get<string>("registry", "host") == "127.0.0.1");
     BOOST_CHECK(config->get<uint16_t>("registry", "port") == 8081);
@@ -175,6 +176,7 @@ BOOST_AUTO_TEST_CASE(ConfigurationTestReadingGeneralParameters) {
     BOOST_CHECK(config->get<unsigned int>("worker", "ingest-num-retries") == 1);
     BOOST_CHECK(config->get<unsigned int>("worker", "ingest-max-retries") == 10);
     BOOST_CHECK(config->get<size_t>("worker", "director-index-record-size") == 16 * 1024 * 1024);
+    BOOST_CHECK(config->get<unsigned int>("worker", "replica-inventory-ttl-sec") == 3600);
 }
 
 BOOST_AUTO_TEST_CASE(ConfigurationTestModifyingGeneralParameters) {
@@ -189,6 +191,10 @@ BOOST_AUTO_TEST_CASE(ConfigurationTestModifyingGeneralParameters) {
     BOOST_REQUIRE_NO_THROW(config->set<unsigned int>("common", "request-retry-interval-sec", 2));
     BOOST_CHECK(config->get<unsigned int>("common", "request-retry-interval-sec") == 2);
 
+    BOOST_CHECK_THROW(config->set<size_t>("common", "request-pipeline-window", 0), std::invalid_argument);
+    BOOST_REQUIRE_NO_THROW(config->set<size_t>("common", "request-pipeline-window", 1));
+    BOOST_CHECK(config->get<size_t>("common", "request-pipeline-window") == 1);
+
     BOOST_CHECK_THROW(config->set<string>("registry", "host", string()), std::invalid_argument);
     BOOST_REQUIRE_NO_THROW(config->set<string>("registry", "host", "localhost"));
     BOOST_CHECK(config->get<string>("registry", "host") == "localhost");
@@ -394,6 +400,11 @@ BOOST_AUTO_TEST_CASE(ConfigurationTestModifyingGeneralParameters) {
     BOOST_REQUIRE_NO_THROW(
             config->set<size_t>("worker", "director-index-record-size", ProtocolBuffer::HARD_LIMIT));
     BOOST_CHECK(config->get<size_t>("worker", "director-index-record-size") == ProtocolBuffer::HARD_LIMIT);
+
+    BOOST_REQUIRE_NO_THROW(config->set<unsigned int>("worker", "replica-inventory-ttl-sec", 0));
+    BOOST_CHECK(config->get<unsigned int>("worker", "replica-inventory-ttl-sec") == 0);
+    BOOST_REQUIRE_NO_THROW(config->set<unsigned int>("worker", "replica-inventory-ttl-sec", 60));
+    BOOST_CHECK(config->get<unsigned int>("worker", "replica-inventory-ttl-sec") == 60);
 }
 
 BOOST_AUTO_TEST_CASE(ConfigurationTestWorkerOperators) {
@@ -141,4 +141,57 @@ BOOST_AUTO_TEST_CASE(TestCsvParser) {
     LOGS_INFO("TestCsvParser test ends");
 }
 
+BOOST_AUTO_TEST_CASE(TestCsvRowsParser) {
+    LOGS_INFO("TestCsvRowsParser test begins");
+    BOOST_CHECK(csv::urlToFormat("file://host/data/chunk_1.rows") == csv::Format::ROWS);
+    BOOST_CHECK(csv::urlToFormat("http://host/chunk_1.rows?user=qserv") == csv::Format::ROWS);
+    BOOST_CHECK(csv::urlToFormat("file://host/data/chunk_1.txt") == csv::Format::CSV);
+    BOOST_CHECK(csv::urlToFormat("http://host/rows?file=chunk_1.rows") == csv::Format::CSV);
+    BOOST_CHECK(csv::urlToFormat(".rows") == csv::Format::CSV);
+
+    // Rows are prefixed with their lengths. They may contain the line
+    // terminator, and are reported without regard to escapes.
+    vector<string> const rows = {"Row 1", "", "Row 3 has a terminator \\\n in the middle", "Row 4\\"};
+    string stream;
+    for (auto const& row : rows) {
+        uint32_t const size = row.size();
+        for (int i = 0; i < 4; ++i) stream.push_back(static_cast<char>((size >> (8 * i)) & 0xff));
+        stream += row;
+    }
+    // Feed the stream in pieces of every size, to split rows and lengths
+    // in all possible ways.
+    csv::Dialect const dialect;
+    for (size_t pieceSize = 1; pieceSize <= stream.size(); ++pieceSize) {
+        csv::Parser parser(dialect, csv::Format::ROWS);
+        BOOST_CHECK(parser.format() == csv::Format::ROWS);
+        vector<string> lines;
+        for (size_t i = 0; i < stream.size(); i += pieceSize) {
+            size_t const size = min(pieceSize, stream.size() - i);
+            bool const flush = i + size == stream.size();
+            parser.parse(stream.data() + i, size, flush,
+                         [&lines](char const* out, size_t size) { lines.emplace_back(string(out, size)); });
+        }
+        BOOST_CHECK_EQUAL(parser.numLines(), rows.size());
+        BOOST_REQUIRE_EQUAL(lines.size(), rows.size());
+        for (size_t i = 0; i < rows.size(); ++i) {
+            BOOST_CHECK_EQUAL(lines[i], rows[i] + "\n");
+        }
+    }
+    // A truncated row is reported when flushing the input.
+    {
+        csv::Parser parser(dialect, csv::Format::ROWS);
+        auto const onRow = [](char const*, size_t) {};
+        BOOST_CHECK_NO_THROW(parser.parse(stream.data(), stream.size() - 1, false, onRow));
+        BOOST_CHECK_THROW(parser.parse(stream.data(), 0, true, onRow), std::runtime_error);
+    }
+    // Row lengths are limited.
+    {
+        csv::Parser parser(dialect, csv::Format::ROWS);
+        char const length[] = {'\0', '\0', '\0', '\1'};
+        BOOST_CHECK_THROW(parser.parse(length, sizeof(length), false, [](char const*, size_t) {}),
+                          std::runtime_error);
+    }
+    LOGS_INFO("TestCsvRowsParser test ends");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
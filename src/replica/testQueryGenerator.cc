@@ -134,6 +134,10 @@ BOOST_AUTO_TEST_CASE(QueryGeneratorTest) {
             {"TIMESTAMPDIFF(SECOND,`submitted`,NOW())", g.TIMESTAMPDIFF("SECOND", "submitted", Sql::NOW).str},
             {"TIMESTAMPDIFF(SECOND,`table`.`submitted`,`table`.`completed`)",
              g.TIMESTAMPDIFF("SECOND", g.id("table", "submitted"), g.id("table", "completed")).str},
+            {"MIN(`ra`)", Sql::MIN(g.id("ra")).str},
+            {"MAX(`ra`)", g.MAX("ra").str},
+            {"COUNT(*)-COUNT(`ra`)", g.NUM_NULLS("ra").str},
+            {"MIN(`ra`) AS `min_value`", g.as(g.MIN("ra"), "min_value").str},
 
             // Values
             {"1", g.val(true).str},
@@ -0,0 +1,146 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// System headers
+#include <string>
+
+// Qserv headers
+#include "replica/ReplicaInfo.h"
+#include "replica/WorkerReplicaInventory.h"
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE WorkerReplicaInventory
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace boost::unit_test;
+using namespace lsst::qserv::replica;
+
+namespace {
+ReplicaInfo::FileInfoCollection files(string const& name, uint64_t size) {
+    return ReplicaInfo::FileInfoCollection({ReplicaInfo::FileInfo({name, size, 0, "", 0, 0, size})});
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(WorkerReplicaInventoryTest) {
+    LOGS_INFO("WorkerReplicaInventoryTest BEGIN");
+
+    unsigned int const maxAgeSec = 3600;
+    WorkerReplicaInventory inventory;
+    WorkerReplicaInventory::ChunkFiles chunkFiles;
+    WorkerReplicaInventory::StaleChunks staleChunks;
+
+    // Nothing is known about the database before the first scan.
+    BOOST_CHECK(!inventory.find("db", maxAgeSec, chunkFiles, staleChunks));
+
+    uint64_t sequence = inventory.sequence();
+    inventory.load("db", {{1, files("T_1.MYD", 10)}, {2, files("T_2.MYD", 20)}}, sequence);
+    BOOST_CHECK(inventory.find("db", maxAgeSec, chunkFiles, staleChunks));
+    BOOST_CHECK_EQUAL(chunkFiles.size(), 2U);
+    BOOST_CHECK(staleChunks.empty());
+
+    // The inventory is ignored if its age isn't limited.
+    BOOST_CHECK(!inventory.find("db", 0, chunkFiles, staleChunks));
+
+    // Changed chunks are reported as stale until their files are examined again.
+    inventory.invalidate("db", 2);
+    inventory.invalidate("db", 3);
+    BOOST_CHECK(inventory.find("db", maxAgeSec, chunkFiles, staleChunks));
+    BOOST_CHECK_EQUAL(staleChunks.size(), 2U);
+    BOOST_CHECK_EQUAL(staleChunks.count(2), 1U);
+    BOOST_CHECK_EQUAL(staleChunks.count(3), 1U);
+
+    sequence = inventory.sequence();
+    inventory.update("db", 2, ReplicaInfo::FileInfoCollection(), sequence);
+    inventory.update("db", 3, files("T_3.MYD", 30), sequence);
+    BOOST_CHECK(inventory.find("db", maxAgeSec, chunkFiles, staleChunks));
+    BOOST_CHECK(staleChunks.empty());
+    BOOST_CHECK_EQUAL(chunkFiles.size(), 2U);
+    BOOST_CHECK_EQUAL(chunkFiles.count(1), 1U);
+    BOOST_CHECK_EQUAL(chunkFiles.count(3), 1U);
+    BOOST_CHECK_EQUAL(chunkFiles[3].front().size, 30U);
+
+    // A chunk changed while its files were being examined remains stale.
+    sequence = inventory.sequence();
+    inventory.invalidate("db", 1);
+    inventory.update("db", 1, files("T_1.MYD", 11), sequence);
+    BOOST_CHECK(inventory.find("db", maxAgeSec, chunkFiles, staleChunks));
+    BOOST_CHECK_EQUAL(staleChunks.count(1), 1U);
+
+    // Same for chunks changed during the full scan.
+    sequence = inventory.sequence();
+    inventory.invalidate("db", 4);
+    inventory.load("db", {{1, files("T_1.MYD", 11)}}, sequence);
+    BOOST_CHECK(inventory.find("db", maxAgeSec, chunkFiles, staleChunks));
+    BOOST_CHECK_EQUAL(chunkFiles.size(), 1U);
+    BOOST_CHECK_EQUAL(staleChunks.size(), 1U);
+    BOOST_CHECK_EQUAL(staleChunks.count(4), 1U);
+
+    // Files examined before the full scan don't replace the results of the scan.
+    inventory.update("db", 1, files("T_1.MYD", 10), sequence - 1);
+    BOOST_CHECK(inventory.find("db", maxAgeSec, chunkFiles, staleChunks));
+    BOOST_CHECK_EQUAL(chunkFiles[1].front().size, 11U);
+
+    LOGS_INFO("WorkerReplicaInventoryTest END");
+}
+
+BOOST_AUTO_TEST_CASE(WorkerReplicaInventoryInvalidateTest) {
+    LOGS_INFO("WorkerReplicaInventoryInvalidateTest BEGIN");
+
+    unsigned int const maxAgeSec = 3600;
+    WorkerReplicaInventory inventory;
+    WorkerReplicaInventory::ChunkFiles chunkFiles;
+    WorkerReplicaInventory::StaleChunks staleChunks;
+
+    inventory.load("db1", {{1, files("T_1.MYD", 10)}}, inventory.sequence());
+    inventory.load("db2", {{1, files("T_1.MYD", 10)}}, inventory.sequence());
+
+    // The database needs to be scanned again.
+    inventory.invalidate("db1");
+    BOOST_CHECK(!inventory.find("db1", maxAgeSec, chunkFiles, staleChunks));
+    BOOST_CHECK(inventory.find("db2", maxAgeSec, chunkFiles, staleChunks));
+
+    // The results of a scan which began before the invalidation are ignored.
+    uint64_t sequence = inventory.sequence();
+    inventory.invalidate("db1");
+    inventory.load("db1", {{1, files("T_1.MYD", 10)}}, sequence);
+    BOOST_CHECK(!inventory.find("db1", maxAgeSec, chunkFiles, staleChunks));
+
+    inventory.load("db1", {{1, files("T_1.MYD", 10)}}, inventory.sequence());
+    BOOST_CHECK(inventory.find("db1", maxAgeSec, chunkFiles, staleChunks));
+
+    // All databases need to be scanned again.
+    sequence = inventory.sequence();
+    inventory.invalidateAll();
+    BOOST_CHECK(!inventory.find("db1", maxAgeSec, chunkFiles, staleChunks));
+    BOOST_CHECK(!inventory.find("db2", maxAgeSec, chunkFiles, staleChunks));
+    inventory.load("db2", {{1, files("T_1.MYD", 10)}}, sequence);
+    BOOST_CHECK(!inventory.find("db2", maxAgeSec, chunkFiles, staleChunks));
+
+    LOGS_INFO("WorkerReplicaInventoryInvalidateTest END");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,101 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "rproc/ColumnarRowBuffer.h"
+
+// System headers
+#include <algorithm>
+#include <cstring>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "rproc/ProtoRowBuffer.h"
+
+using namespace std;
+
+namespace {
+LOG_LOGGER _log = LOG_GET("lsst.qserv.rproc.ColumnarRowBuffer");
+}
+
+namespace lsst::qserv::rproc {
+
+ColumnarRowBuffer::ColumnarRowBuffer(proto::Result const& res, int jobId)
+        : _jobIdStr("'" + to_string(jobId) + "'"), _rowTotal(res.rowcount()) {
+    for (auto const& block : res.columnblock()) {
+        _columns.emplace_back(block, _rowTotal);
+    }
+}
+
+unsigned ColumnarRowBuffer::fetch(char* buffer, unsigned bufLen) {
+    unsigned fetched = 0;
+    while (fetched < bufLen) {
+        if (_currentPos == _currentRow.size()) {
+            if (_rowIdx >= _rowTotal) break;
+            _formatRow(_rowIdx++);
+        }
+        size_t const sz = min<size_t>(bufLen - fetched, _currentRow.size() - _currentPos);
+        memcpy(buffer + fetched, _currentRow.data() + _currentPos, sz);
+        _currentPos += sz;
+        fetched += sz;
+    }
+    return fetched;
+}
+
+void ColumnarRowBuffer::_formatRow(unsigned int rowIdx) {
+    _currentRow.clear();
+    _currentPos = 0;
+    if (rowIdx > 0) {
+        _currentRow += '\n';
+    }
+    _currentRow += _jobIdStr;
+    for (auto const& col : _columns) {
+        _currentRow += '\t';
+        if (col.isNull(rowIdx)) {
+            _currentRow += "\\N";
+            continue;
+        }
+        size_t const pos = _currentRow.size();
+        if (col.getEncoding() == proto::ColumnBlock::BYTES) {
+            string_view const val = col.getBytes(rowIdx);
+            _currentRow.resize(pos + 2 + 2 * val.size());
+            _currentRow[pos] = '\'';
+            int const valSize =
+                    ProtoRowBuffer::escapeString(_currentRow.begin() + pos + 1, val.begin(), val.end());
+            _currentRow[pos + 1 + valSize] = '\'';
+            _currentRow.resize(pos + 2 + valSize);
+        } else {
+            _currentRow.resize(pos + proto::ColumnBlockReader::MAX_NUMERIC_CHARS);
+            _currentRow.resize(pos + col.toChars(rowIdx, _currentRow.data() + pos));
+        }
+    }
+    LOGS(_log, LOG_LVL_TRACE, "row " << rowIdx << " " << _currentRow);
+}
+
+string ColumnarRowBuffer::dump() const {
+    return "ColumnarRowBuffer columns=" + to_string(_columns.size()) + " row " + to_string(_rowIdx) + "/" +
+           to_string(_rowTotal) + " (" + _currentRow + ")";
+}
+
+}  // namespace lsst::qserv::rproc
@@ -0,0 +1,66 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_RPROC_COLUMNARROWBUFFER_H
+#define LSST_QSERV_RPROC_COLUMNARROWBUFFER_H
+
+// System headers
+#include <string>
+#include <vector>
+
+// Qserv headers
+#include "mysql/RowBuffer.h"
+#include "proto/ColumnarResult.h"
+
+namespace lsst::qserv::rproc {
+
+/// ColumnarRowBuffer is an implementation of RowBuffer that allows a
+/// LocalInfile object to use a column-based (protocol 3) Result message
+/// as a row source. Rows are produced in the same LOAD DATA text form as
+/// ProtoRowBuffer, with the jobId column first, but directly from the
+/// column blocks so there are no per-cell protobuf objects involved.
+/// Numeric values are written unquoted.
+class ColumnarRowBuffer : public mysql::RowBuffer {
+public:
+    /// @throws proto::ColumnarResultError if the blocks in 'res' are inconsistent.
+    ColumnarRowBuffer(proto::Result const& res, int jobId);
+
+    /// Fill 'buffer' with as many bytes of rows as will fit.
+    /// @return the number of bytes written, 0 when there are no more rows.
+    unsigned fetch(char* buffer, unsigned bufLen) override;
+
+    std::string dump() const override;
+
+private:
+    /// Write the text form of row 'rowIdx' into _currentRow.
+    void _formatRow(unsigned int rowIdx);
+
+    std::vector<proto::ColumnBlockReader> _columns;
+    std::string const _jobIdStr;  ///< Quoted jobId, the first column of every row.
+    unsigned int const _rowTotal;
+    unsigned int _rowIdx = 0;  ///< Next row to be formatted.
+    std::string _currentRow;   ///< Text of the current row
+    size_t _currentPos = 0;    ///< Bytes of _currentRow already fetched.
+};
+
+}  // namespace lsst::qserv::rproc
+
+#endif  // LSST_QSERV_RPROC_COLUMNARROWBUFFER_H
@@ -0,0 +1,462 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "rproc/HashAggregator.h"
+
+// System headers
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+// Third-party headers
+#include "boost/algorithm/string/case_conv.hpp"
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "proto/ColumnarResult.h"
+#include "query/ColumnRef.h"
+#include "query/FuncExpr.h"
+#include "query/GroupByClause.h"
+#include "query/OrderByClause.h"
+#include "query/SelectList.h"
+#include "query/SelectStmt.h"
+#include "query/ValueExpr.h"
+#include "query/ValueFactor.h"
+#include "rproc/ResultCells.h"
+#include "sql/Schema.h"
+
+using namespace std;
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.rproc.HashAggregator");
+
+using lsst::qserv::proto::ColumnBlockReader;
+using lsst::qserv::rproc::HashAggregator;
+namespace query = lsst::qserv::query;
+
+/// The merge table columns referenced by a merge statement.
+struct MergeColumnRefs {
+    /// Columns used as the argument of SUM, MIN, or MAX.
+    map<string, HashAggregator::Op> aggregates;
+    /// Columns used in any other way.
+    set<string> plain;
+
+    /// @return false if 'expr' can't be applied to reduced rows.
+    bool addExpr(query::ValueExpr const& expr) {
+        for (auto const& factorOp : expr.getFactorOps()) {
+            if (factorOp.factor == nullptr || !addFactor(*factorOp.factor)) return false;
+        }
+        return true;
+    }
+
+    bool addFactor(query::ValueFactor const& factor) {
+        switch (factor.getType()) {
+            case query::ValueFactor::AGGFUNC:
+                return factor.getFuncExpr() != nullptr && addAggregate(*factor.getFuncExpr());
+            case query::ValueFactor::FUNCTION:
+                if (factor.getFuncExpr() == nullptr) return false;
+                for (auto const& param : factor.getFuncExpr()->getParams()) {
+                    if (param == nullptr || !addExpr(*param)) return false;
+                }
+                return true;
+            case query::ValueFactor::EXPR:
+                return factor.getExpr() != nullptr && addExpr(*factor.getExpr());
+            case query::ValueFactor::STAR:
+                return false;
+            default: {
+                query::ColumnRef::Vector refs;
+                factor.findColumnRefs(refs);
+                for (auto const& ref : refs) {
+                    plain.insert(boost::algorithm::to_lower_copy(ref->getColumn()));
+                }
+                return true;
+            }
+        }
+    }
+
+    /// @return false unless 'func' is SUM, MIN, or MAX of a single column,
+    ///         and that column isn't also used with another function.
+    bool addAggregate(query::FuncExpr const& func) {
+        string const name = boost::algorithm::to_upper_copy(func.getName());
+        HashAggregator::Op op;
+        if (name == "SUM") {
+            op = HashAggregator::SUM;
+        } else if (name == "MIN") {
+            op = HashAggregator::MIN;
+        } else if (name == "MAX") {
+            op = HashAggregator::MAX;
+        } else {
+            return false;
+        }
+        auto const& params = func.getParams();
+        if (params.size() != 1 || params[0] == nullptr) return false;
+        auto const columnRef = params[0]->getColumnRef();
+        if (columnRef == nullptr) return false;
+        string const column = boost::algorithm::to_lower_copy(columnRef->getColumn());
+        auto const [iter, inserted] = aggregates.emplace(column, op);
+        return inserted || iter->second == op;
+    }
+};
+
+/// Write the text of an integer scaled by 10^scale.
+void formatExact(int64_t val, int scale, string& out) {
+    char buf[24];
+    uint64_t const magnitude = (val < 0) ? 0 - static_cast<uint64_t>(val) : val;
+    out.assign(buf, to_chars(buf, buf + sizeof(buf), magnitude).ptr);
+    if (scale > 0) {
+        size_t const scaleSz = scale;
+        if (out.size() <= scaleSz) out.insert(0, scaleSz + 1 - out.size(), '0');
+        out.insert(out.size() - scaleSz, 1, '.');
+    }
+    if (val < 0) out.insert(0, 1, '-');
+}
+
+/// Write the shortest text that parses back to 'val'.
+void formatApprox(double val, string& out) {
+    char buf[ColumnBlockReader::MAX_NUMERIC_CHARS];
+    out.assign(buf, to_chars(buf, buf + sizeof(buf), val).ptr);
+}
+
+}  // namespace
+
+namespace lsst::qserv::rproc {
+
+HashAggregator::Ptr HashAggregator::create(query::SelectStmt const& mergeStmt, sql::Schema const& schema,
+                                           size_t maxGroups) {
+    string const stmtStr = mergeStmt.getQueryTemplate().sqlFragment();
+    MergeColumnRefs refs;
+    bool supported = !mergeStmt.hasWhereClause() && !mergeStmt.hasHaving();
+    query::ValueExprPtrVector exprs = *mergeStmt.getSelectList().getValueExprList();
+    if (mergeStmt.hasGroupBy()) mergeStmt.getGroupBy().findValueExprs(exprs);
+    if (mergeStmt.hasOrderBy()) mergeStmt.getOrderBy().findValueExprs(exprs);
+    for (auto const& expr : exprs) {
+        supported = supported && expr != nullptr && refs.addExpr(*expr);
+    }
+    if (!supported) {
+        LOGS(_log, LOG_LVL_DEBUG, "merge statement can't be reduced in memory: " << stmtStr);
+        return nullptr;
+    }
+    // Without aggregates, GROUP BY, or DISTINCT, identical rows must all be kept.
+    if (refs.aggregates.empty() && !mergeStmt.getDistinct() && !mergeStmt.hasGroupBy()) {
+        LOGS(_log, LOG_LVL_DEBUG, "merge statement doesn't combine rows: " << stmtStr);
+        return nullptr;
+    }
+
+    vector<Column> columns;
+    size_t aggregatesFound = 0;
+    for (auto const& colSchema : schema.columns) {
+        string const name = boost::algorithm::to_lower_copy(colSchema.name);
+        Column col;
+        auto const iter = refs.aggregates.find(name);
+        if (iter != refs.aggregates.end()) {
+            col.num = NumericType::fromColType(colSchema.colType);
+            if (refs.plain.count(name) > 0 || col.num.kind == NumericType::NONE) {
+                LOGS(_log, LOG_LVL_DEBUG,
+                     "column " << colSchema << " can't be reduced in memory: " << stmtStr);
+                return nullptr;
+            }
+            col.op = iter->second;
+            ++aggregatesFound;
+        }
+        columns.push_back(col);
+    }
+    if (aggregatesFound != refs.aggregates.size()) {
+        LOGS(_log, LOG_LVL_DEBUG, "aggregated columns not found in " << schema << ": " << stmtStr);
+        return nullptr;
+    }
+    LOGS(_log, LOG_LVL_DEBUG,
+         "reducing " << aggregatesFound << " of " << columns.size() << " columns in memory for " << stmtStr);
+    return make_shared<HashAggregator>(columns, maxGroups);
+}
+
+HashAggregator::HashAggregator(vector<Column> const& columns, size_t maxGroups)
+        : _columns(columns), _maxGroups(maxGroups) {
+    for (auto const& col : _columns) {
+        if (col.op != KEY) _valueColumns.push_back(col);
+    }
+}
+
+bool HashAggregator::add(proto::Result const& result, int jobIdAttempt) {
+    if (isFull()) return false;
+    vector<string> keys;
+    Values values;
+    if (!_parse(result, keys, values)) {
+        LOGS(_log, LOG_LVL_DEBUG, "jobIdAttempt=" << jobIdAttempt << " values can't be reduced in memory");
+        return false;
+    }
+
+    lock_guard<mutex> lock(_mtx);
+    if (_full) return false;
+    Attempt& attempt = _attempts[jobIdAttempt];
+    attempt.jobId = result.jobid();
+    size_t const valueCount = _valueColumns.size();
+    for (size_t row = 0; row < keys.size(); ++row) {
+        _add(attempt.table, std::move(keys[row]), values.data() + row * valueCount);
+    }
+    _rowsIn += keys.size();
+    if (_groupCount() >= _maxGroups) {
+        _full = true;
+        LOGS(_log, LOG_LVL_INFO,
+             "reached " << _maxGroups << " groups, further results go to the merge table");
+    }
+    return true;
+}
+
+bool HashAggregator::_parse(proto::Result const& result, vector<string>& keys, Values& values) const {
+    ResultCells const cells(result);
+    unsigned int const rowCount = cells.getRowCount();
+    size_t const valueCount = _valueColumns.size();
+    keys.resize(rowCount);
+    values.resize(rowCount * valueCount);
+    string text;
+    for (unsigned int row = 0; row < rowCount; ++row) {
+        if (cells.getColumnCount(row) != _columns.size()) return false;
+        string& key = keys[row];
+        Value* val = values.data() + row * valueCount;
+        for (size_t col = 0; col < _columns.size(); ++col) {
+            Column const& column = _columns[col];
+            bool const isNull = cells.isNull(row, col);
+            if (column.op == KEY) {
+                // NULL, or the length and text of the value.
+                key += isNull ? '\0' : '\1';
+                if (isNull) continue;
+                cells.getText(row, col, text);
+                uint32_t const len = text.size();
+                key.append(reinterpret_cast<char const*>(&len), sizeof(len));
+                key += text;
+                continue;
+            }
+            Value& v = *val++;
+            if (isNull) continue;
+            v.isNull = false;
+            bool const ok = (column.num.kind == NumericType::EXACT)
+                                    ? cells.getExact(row, col, column.num.scale, v.exact)
+                                    : cells.getApprox(row, col, v.approx);
+            if (!ok) return false;
+        }
+    }
+    return true;
+}
+
+bool HashAggregator::_canCombine(Values const& group, Value const* vals) const {
+    for (size_t i = 0; i < _valueColumns.size(); ++i) {
+        Column const& col = _valueColumns[i];
+        if (col.op != SUM || col.num.kind != NumericType::EXACT) continue;
+        if (group[i].isNull || vals[i].isNull) continue;
+        int64_t sum;
+        if (__builtin_add_overflow(group[i].exact, vals[i].exact, &sum)) return false;
+    }
+    return true;
+}
+
+void HashAggregator::_add(Table& table, string&& key, Value const* vals) const {
+    size_t const valueCount = _valueColumns.size();
+    auto [iter, inserted] = table.groups.try_emplace(std::move(key));
+    Values& group = iter->second;
+    if (inserted) {
+        group.assign(vals, vals + valueCount);
+        return;
+    }
+    if (!_canCombine(group, vals)) {
+        // The merge statement adds up the parts.
+        table.splitGroups.emplace_back(iter->first, std::move(group));
+        group.assign(vals, vals + valueCount);
+        return;
+    }
+    for (size_t i = 0; i < valueCount; ++i) {
+        Value& g = group[i];
+        Value const& v = vals[i];
+        if (v.isNull) continue;  // Aggregates ignore NULL values.
+        if (g.isNull) {
+            g = v;
+            continue;
+        }
+        bool const exact = _valueColumns[i].num.kind == NumericType::EXACT;
+        switch (_valueColumns[i].op) {
+            case SUM:
+                if (exact) {
+                    g.exact += v.exact;
+                } else {
+                    g.approx += v.approx;
+                }
+                break;
+            case MIN:
+                if (exact) {
+                    g.exact = min(g.exact, v.exact);
+                } else {
+                    g.approx = min(g.approx, v.approx);
+                }
+                break;
+            case MAX:
+                if (exact) {
+                    g.exact = max(g.exact, v.exact);
+                } else {
+                    g.approx = max(g.approx, v.approx);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void HashAggregator::mergeCompleteFor(set<int> const& jobIds, IsInvalidFunc const& isInvalid) {
+    lock_guard<mutex> lock(_mtx);
+    for (auto iter = _attempts.begin(); iter != _attempts.end();) {
+        if (jobIds.count(iter->second.jobId) == 0) {
+            ++iter;
+            continue;
+        }
+        if (isInvalid(iter->first)) {
+            LOGS(_log, LOG_LVL_DEBUG, "dropping groups of invalid jobIdAttempt=" << iter->first);
+        } else {
+            _complete(iter->first, iter->second);
+        }
+        iter = _attempts.erase(iter);
+    }
+}
+
+void HashAggregator::_complete(int jobIdAttempt, Attempt& attempt) {
+    auto& groups = attempt.table.groups;
+    while (!groups.empty()) {
+        auto node = groups.extract(groups.begin());
+        _add(_completed, std::move(node.key()), node.mapped().data());
+    }
+    for (auto& splitGroup : attempt.table.splitGroups) {
+        _completed.splitGroups.push_back(std::move(splitGroup));
+    }
+    attempt.table.splitGroups.clear();
+    _completedAttempts.insert(jobIdAttempt);
+}
+
+bool HashAggregator::finish(IsInvalidFunc const& isInvalid, LoadFunc const& loadRows) {
+    lock_guard<mutex> lock(_mtx);
+    for (auto& [jobIdAttempt, attempt] : _attempts) {
+        if (!isInvalid(jobIdAttempt)) _complete(jobIdAttempt, attempt);
+    }
+    _attempts.clear();
+    for (int jobIdAttempt : _completedAttempts) {
+        if (isInvalid(jobIdAttempt)) {
+            _error = "groups of jobIdAttempt=" + to_string(jobIdAttempt) +
+                     " were combined before it became invalid";
+            LOGS(_log, LOG_LVL_ERROR, "HashAggregator " << _error);
+            return false;
+        }
+    }
+    LOGS(_log, LOG_LVL_DEBUG, "reduced " << _rowsIn << " rows to " << _completed.size());
+
+    size_t const columnCount = _columns.size();
+    vector<proto::ColumnBlock::Encoding> const encodings(columnCount, proto::ColumnBlock::BYTES);
+    vector<string> cells(columnCount);
+    vector<bool> nulls(columnCount);
+    vector<char const*> rowPtrs(columnCount);
+    vector<unsigned long> lengths(columnCount);
+    proto::Result result;
+    auto builder = make_unique<proto::ColumnBlockBuilder>(result, encodings);
+
+    auto loadBatch = [&]() -> bool {
+        if (builder->getRowCount() == 0) return true;
+        result.set_rowcount(builder->getRowCount());
+        bool const ok = loadRows(result);
+        result.Clear();
+        builder = make_unique<proto::ColumnBlockBuilder>(result, encodings);
+        if (!ok) _error = "failed to write reduced rows";
+        return ok;
+    };
+    auto addRow = [&](string const& key, Values const& vals) -> bool {
+        _formatRow(key, vals, cells, nulls);
+        for (size_t col = 0; col < columnCount; ++col) {
+            rowPtrs[col] = nulls[col] ? nullptr : cells[col].data();
+            lengths[col] = cells[col].size();
+        }
+        builder->addRow(rowPtrs.data(), lengths.data());
+        return builder->getRowCount() < ROWS_PER_RESULT || loadBatch();
+    };
+
+    for (auto const& [key, vals] : _completed.groups) {
+        if (!addRow(key, vals)) return false;
+    }
+    for (auto const& [key, vals] : _completed.splitGroups) {
+        if (!addRow(key, vals)) return false;
+    }
+    if (!loadBatch()) return false;
+    _completed = Table();
+    return true;
+}
+
+void HashAggregator::_formatRow(string const& key, Values const& vals, vector<string>& cells,
+                                vector<bool>& nulls) const {
+    size_t keyPos = 0;
+    Value const* val = vals.data();
+    for (size_t col = 0; col < _columns.size(); ++col) {
+        Column const& column = _columns[col];
+        string& cell = cells[col];
+        cell.clear();
+        if (column.op == KEY) {
+            nulls[col] = key[keyPos++] == '\0';
+            if (nulls[col]) continue;
+            uint32_t len;
+            memcpy(&len, key.data() + keyPos, sizeof(len));
+            keyPos += sizeof(len);
+            cell.assign(key, keyPos, len);
+            keyPos += len;
+            continue;
+        }
+        Value const& v = *val++;
+        nulls[col] = v.isNull;
+        if (v.isNull) continue;
+        if (column.num.kind == NumericType::EXACT) {
+            formatExact(v.exact, column.num.scale, cell);
+        } else {
+            formatApprox(v.approx, cell);
+        }
+    }
+}
+
+size_t HashAggregator::_groupCount() const {
+    size_t count = _completed.size();
+    for (auto const& [jobIdAttempt, attempt] : _attempts) {
+        count += attempt.table.size();
+    }
+    return count;
+}
+
+size_t HashAggregator::getRowsIn() const {
+    lock_guard<mutex> lock(_mtx);
+    return _rowsIn;
+}
+
+size_t HashAggregator::getGroupCount() const {
+    lock_guard<mutex> lock(_mtx);
+    return _groupCount();
+}
+
+bool HashAggregator::isFull() const {
+    lock_guard<mutex> lock(_mtx);
+    return _full;
+}
+
+}  // namespace lsst::qserv::rproc
@@ -0,0 +1,187 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_RPROC_HASHAGGREGATOR_H
+#define LSST_QSERV_RPROC_HASHAGGREGATOR_H
+
+// System headers
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Qserv headers
+#include "rproc/ResultCells.h"
+
+// Forward declarations
+namespace lsst::qserv {
+namespace query {
+class SelectStmt;
+}
+namespace sql {
+struct Schema;
+}
+}  // namespace lsst::qserv
+
+namespace lsst::qserv::rproc {
+
+/// HashAggregator reduces the partial rows of an aggregate query in memory,
+/// as they arrive from the workers, so that the merge table only receives
+/// one row per group instead of one row per group per chunk.
+///
+/// The rows it produces are still combined by the merge statement when the
+/// query is finalized. Only the columns the merge statement combines with
+/// SUM (which includes the partial counts of COUNT), MIN, or MAX are reduced,
+/// all other columns form the group key. Reducing with a key that is finer
+/// than the merge statement's GROUP BY does not change the final result, so
+/// HAVING-free statements with these aggregates, GROUP BY, and DISTINCT are
+/// supported. For everything else create() returns nullptr and the rows are
+/// written to the merge table as they are.
+///
+/// Rows of a job attempt are kept apart until the merge for the job is
+/// complete, so that the rows of an attempt that gets scrubbed can be
+/// dropped. If the number of groups reaches the limit, no further results
+/// are accepted and those go to the merge table, which the merge statement
+/// handles the same way.
+class HashAggregator {
+public:
+    using Ptr = std::shared_ptr<HashAggregator>;
+
+    /// How a merge table column is reduced.
+    enum Op { KEY, SUM, MIN, MAX };
+
+    struct Column {
+        Op op = KEY;
+        NumericType num;  ///< How the values are held, only for reduced columns.
+    };
+
+    /// @return true if the job attempt has been scrubbed.
+    using IsInvalidFunc = std::function<bool(int)>;
+    /// Writes the rows of a Result message to the merge table.
+    using LoadFunc = std::function<bool(proto::Result&)>;
+
+    /// @param mergeStmt the statement that will combine the rows of the merge table.
+    /// @param schema the columns of the worker results, not including the jobId column.
+    /// @return a HashAggregator for the results, or nullptr if mergeStmt can't be
+    ///         applied to rows reduced in memory.
+    static Ptr create(query::SelectStmt const& mergeStmt, sql::Schema const& schema, size_t maxGroups);
+
+    HashAggregator(std::vector<Column> const& columns, size_t maxGroups);
+    HashAggregator() = delete;
+    HashAggregator(HashAggregator const&) = delete;
+    HashAggregator& operator=(HashAggregator const&) = delete;
+
+    /// Reduce the rows of 'result' from job attempt 'jobIdAttempt'.
+    /// @return false if the rows were not taken, in which case they must be
+    ///         written to the merge table.
+    /// @throws proto::ColumnarResultError if the column blocks of 'result' are inconsistent.
+    bool add(proto::Result const& result, int jobIdAttempt);
+
+    /// Combine the rows of the valid attempts of 'jobIds' with the rows of
+    /// the other completed jobs, and drop the rows of scrubbed attempts.
+    void mergeCompleteFor(std::set<int> const& jobIds, IsInvalidFunc const& isInvalid);
+
+    /// Complete the outstanding jobs and pass the reduced rows to 'loadRows'
+    /// in Result messages of up to ROWS_PER_RESULT rows.
+    /// @return false if the rows could not be written, or if an attempt was
+    ///         scrubbed after its rows were combined. getError() has details.
+    bool finish(IsInvalidFunc const& isInvalid, LoadFunc const& loadRows);
+
+    /// @return the number of worker rows taken by add().
+    size_t getRowsIn() const;
+    /// @return the number of reduced rows.
+    size_t getGroupCount() const;
+    /// @return true if the group limit was reached and add() no longer takes rows.
+    bool isFull() const;
+
+    std::string const& getError() const { return _error; }
+
+    static constexpr unsigned int ROWS_PER_RESULT = 10000;
+
+private:
+    /// The current state of a SUM, MIN, or MAX column of a group.
+    struct Value {
+        bool isNull = true;
+        union {
+            int64_t exact = 0;
+            double approx;
+        };
+    };
+    using Values = std::vector<Value>;
+
+    /// The groups of one job attempt or of all completed jobs. Groups are
+    /// split, instead of combined, when an exact SUM would overflow.
+    struct Table {
+        std::unordered_map<std::string, Values> groups;
+        std::vector<std::pair<std::string, Values>> splitGroups;
+        size_t size() const { return groups.size() + splitGroups.size(); }
+    };
+
+    /// The rows of a job attempt that is not complete yet.
+    struct Attempt {
+        int jobId = 0;
+        Table table;
+    };
+
+    /// Read the key and values of every row of 'result'.
+    /// @return false if a value can't be held exactly.
+    bool _parse(proto::Result const& result, std::vector<std::string>& keys, Values& values) const;
+
+    /// Combine 'key' and 'vals' with the groups of 'table'.
+    void _add(Table& table, std::string&& key, Value const* vals) const;
+
+    /// @return false if combining 'vals' into 'group' would overflow.
+    bool _canCombine(Values const& group, Value const* vals) const;
+
+    /// Move the groups of 'attempt' into _completed.
+    /// Precondition: must hold _mtx.
+    void _complete(int jobIdAttempt, Attempt& attempt);
+
+    /// Write the text of one reduced row, in the column order of the results.
+    void _formatRow(std::string const& key, Values const& vals, std::vector<std::string>& cells,
+                    std::vector<bool>& nulls) const;
+
+    /// @return the number of groups held.
+    /// Precondition: must hold _mtx.
+    size_t _groupCount() const;
+
+    std::vector<Column> const _columns;
+    std::vector<Column> _valueColumns;  ///< The columns that are not keys.
+    size_t const _maxGroups;
+
+    mutable std::mutex _mtx;  ///< Protects all members below.
+    std::map<int, Attempt> _attempts;  ///< Attempts that are not complete, by jobIdAttempt.
+    Table _completed;                  ///< Groups of the valid attempts of completed jobs.
+    std::set<int> _completedAttempts;  ///< Attempts that have been combined into _completed.
+    size_t _rowsIn = 0;
+    bool _full = false;
+    std::string _error;
+};
+
+}  // namespace lsst::qserv::rproc
+
+#endif  // LSST_QSERV_RPROC_HASHAGGREGATOR_H
@@ -56,12 +56,15 @@
 // Qserv headers
 #include "czar/Czar.h"
 #include "global/intTypes.h"
+#include "proto/ColumnarResult.h"
 #include "proto/WorkerResponse.h"
 #include "proto/ProtoImporter.h"
 #include "qdisp/CzarStats.h"
 #include "qproc/DatabaseModels.h"
 #include "query/ColumnRef.h"
 #include "query/SelectStmt.h"
+#include "rproc/ColumnarRowBuffer.h"
+#include "rproc/PreparedRowInserter.h"
 #include "rproc/ProtoRowBuffer.h"
 #include "sql/Schema.h"
 #include "sql/SqlConnection.h"
@@ -100,6 +103,8 @@ std::string getTimeStampId() {
 }
 
 const char JOB_ID_BASE_NAME[] = "jobId";
+/// jobId column value of the rows held in memory, they combine rows of many jobs.
+int const IN_MEMORY_JOB_ID = -1;
 size_t const MB_SIZE_BYTES = 1024 * 1024;
 }  // anonymous namespace
 
@@ -109,16 +114,17 @@ namespace lsst::qserv::rproc {
 // InfileMerger public
 ////////////////////////////////////////////////////////////////////////
 InfileMerger::InfileMerger(InfileMergerConfig const& c, std::shared_ptr<qproc::DatabaseModels> const& dm,
-                           util::SemaMgr::Ptr const& semaMgrConn)
+                           MergeConnectionPool::Ptr const& mergeConnPool)
         : _config(c),
           _mysqlConn(_config.mySqlConfig),
           _databaseModels(dm),
           _jobIdColName(JOB_ID_BASE_NAME),
           _maxSqlConnectionAttempts(_config.czarConfig.getMaxSqlConnectionAttempts()),
           _maxResultTableSizeBytes(_config.czarConfig.getMaxTableSizeMB() * MB_SIZE_BYTES),
-          _semaMgrConn(semaMgrConn) {
+          _mergeConnPool(mergeConnPool) {
     _fixupTargetName();
     _setEngineFromStr(_config.czarConfig.getResultEngine());
+    _setMergeMethodFromStr(_config.czarConfig.getResultMergeMethod());
     if (_dbEngine == MYISAM) {
         LOGS(_log, LOG_LVL_INFO, "Engine is MYISAM, serial");
         if (!_setupConnectionMyIsam()) {
@@ -126,9 +132,11 @@ InfileMerger::InfileMerger(InfileMergerConfig const& c, std::shared_ptr<qproc::D
         }
     } else {
         if (_dbEngine == INNODB) {
-            LOGS(_log, LOG_LVL_INFO, "Engine is INNODB, parallel, semaMgrConn=" << *_semaMgrConn);
+            LOGS(_log, LOG_LVL_INFO,
+                 "Engine is INNODB, parallel, semaMgrConn=" << _mergeConnPool->getSemaMgr());
         } else if (_dbEngine == MEMORY) {
-            LOGS(_log, LOG_LVL_INFO, "Engine is MEMORY, parallel, semaMgrConn=" << *_semaMgrConn);
+            LOGS(_log, LOG_LVL_INFO,
+                 "Engine is MEMORY, parallel, semaMgrConn=" << _mergeConnPool->getSemaMgr());
         } else {
             throw InfileMergerError(util::ErrorCode::INTERNAL,
                                     "SQL engine is unknown" + std::to_string(_dbEngine));
@@ -168,6 +176,22 @@ void InfileMerger::_setEngineFromStr(std::string const& engineName) {
     LOGS(_log, LOG_LVL_INFO, "set engine to " << engineToStr(_dbEngine));
 }
 
+void InfileMerger::_setMergeMethodFromStr(std::string const& methodName) {
+    std::string mName;
+    for (auto&& c : methodName) {
+        mName += toupper(c);
+    }
+    if (mName == "PREPARED") {
+        _mergeMethod = PREPARED;
+    } else if (mName == "INFILE") {
+        _mergeMethod = INFILE;
+    } else {
+        LOGS(_log, LOG_LVL_ERROR, "unknown mergeMethod=" << methodName << " using default INFILE");
+        _mergeMethod = INFILE;
+    }
+    LOGS(_log, LOG_LVL_INFO, "set merge method to " << (_mergeMethod == PREPARED ? "PREPARED" : "INFILE"));
+}
+
 std::string InfileMerger::engineToStr(InfileMerger::DbEngine engine) {
     switch (engine) {
         case MYISAM:
@@ -193,9 +217,20 @@ void InfileMerger::_setQueryIdStr(std::string const& qIdStr) {
 }
 
 void InfileMerger::mergeCompleteFor(std::set<int> const& jobIds) {
-    std::lock_guard<std::mutex> resultSzLock(_mtxResultSizeMtx);
-    for (int jobId : jobIds) {
-        _totalResultSize += _perJobResultSize[jobId];
+    {
+        std::lock_guard<std::mutex> resultSzLock(_mtxResultSizeMtx);
+        for (int jobId : jobIds) {
+            _totalResultSize += _perJobResultSize[jobId];
+        }
+    }
+    auto isInvalid = [this](int jobIdAttempt) {
+        return _invalidJobAttemptMgr.isJobAttemptInvalid(jobIdAttempt);
+    };
+    if (_hashAggregator != nullptr) {
+        _hashAggregator->mergeCompleteFor(jobIds, isInvalid);
+    }
+    if (_topKMerger != nullptr) {
+        _topKMerger->mergeCompleteFor(jobIds, isInvalid);
     }
 }
 
@@ -223,11 +258,12 @@ bool InfileMerger::merge(std::shared_ptr<proto::WorkerResponse> const& response)
         _setQueryIdStr(QueryIdHelper::makeIdStr(response->result.queryid()));
     }
     size_t resultSize = response->result.transmitsize();
+    int const rowCount = proto::getResultRowCount(response->result);
     LOGS(_log, LOG_LVL_TRACE,
          "Executing InfileMerger::merge("
                  << " sizes=" << static_cast<short>(response->headerSize) << ", "
                  << response->protoHeader.size() << ", resultSize=" << resultSize << ", rowCount="
-                 << response->result.rowcount() << ", row_size=" << response->result.row_size()
+                 << response->result.rowcount() << ", row_size=" << rowCount
                  << ", attemptCount=" << response->result.attemptcount()
                  << ", errCode=" << response->result.has_errorcode()
                  << " hasErMsg=" << response->result.has_errormsg() << ")");
@@ -241,16 +277,10 @@ bool InfileMerger::merge(std::shared_ptr<proto::WorkerResponse> const& response)
     }
 
     // Nothing to do if size is zero.
-    if (response->result.row_size() == 0) {
+    if (rowCount == 0) {
         return true;
     }
 
-    std::unique_ptr<util::SemaLock> semaLock;
-    if (_dbEngine != MYISAM) {
-        // needed for parallel merging with INNODB and MEMORY
-        semaLock.reset(new util::SemaLock(*_semaMgrConn));
-    }
-
     TimeCountTracker<double>::CALLBACKFUNC cbf = [](TIMEPOINT start, TIMEPOINT end, double sum,
                                                     bool success) {
         qdisp::CzarStats::Ptr cStats = qdisp::CzarStats::get();
@@ -260,15 +290,7 @@ bool InfileMerger::merge(std::shared_ptr<proto::WorkerResponse> const& response)
     auto tct = make_shared<TimeCountTracker<double>>(cbf);
 
     bool ret = false;
-    // Add columns to rows in virtFile.
-    util::Timer virtFileT;
-    virtFileT.start();
     int resultJobId = makeJobIdAttempt(response->result.jobid(), response->result.attemptcount());
-    ProtoRowBuffer::Ptr pRowBuffer = std::make_shared<ProtoRowBuffer>(
-            response->result, resultJobId, _jobIdColName, _jobIdSqlType, _jobIdMysqlType);
-    std::string const virtFile = _infileMgr.prepareSrc(pRowBuffer);
-    std::string const infileStatement = sql::formLoadInfile(_mergeTable, virtFile);
-    virtFileT.stop();
 
     // If the job attempt is invalid, exit without adding rows.
     // It will wait here if rows need to be deleted.
@@ -301,6 +323,36 @@ bool InfileMerger::merge(std::shared_ptr<proto::WorkerResponse> const& response)
         return true;
     }
 
+    // Add columns to rows in virtFile, unless the rows can be reduced in memory.
+    util::Timer virtFileT;
+    virtFileT.start();
+    LoadFunc loadRows;
+    try {
+        if ((_hashAggregator != nullptr && _hashAggregator->add(response->result, resultJobId)) ||
+            (_topKMerger != nullptr && _topKMerger->add(response->result, resultJobId))) {
+            _invalidJobAttemptMgr.decrConcurrentMergeCount();
+            return true;
+        }
+        if (_mergeMethod == PREPARED) {
+            loadRows = _makePreparedLoad(response->result, resultJobId);
+        } else {
+            loadRows = _makeInfileLoad(response->result, resultJobId);
+        }
+    } catch (proto::ColumnarResultError const& e) {
+        _error = InfileMergerError(util::ErrorCode::RESULT_IMPORT,
+                                   queryIdJobStr + " Error decoding column blocks: " + e.what());
+        LOGS(_log, LOG_LVL_ERROR, _error.getMsg());
+        _invalidJobAttemptMgr.decrConcurrentMergeCount();
+        return false;
+    }
+    virtFileT.stop();
+
+    std::unique_ptr<MergeConnectionPool::Handle> pooledConn;
+    if (_dbEngine != MYISAM) {
+        // needed for parallel merging with INNODB and MEMORY, waits until a connection may be used.
+        pooledConn = _mergeConnPool->acquire();
+    }
+
     TimeCountTracker<double>::CALLBACKFUNC cbfMerge = [](TIMEPOINT start, TIMEPOINT end, double sum,
                                                          bool success) {
         qdisp::CzarStats::Ptr cStats = qdisp::CzarStats::get();
@@ -312,11 +364,11 @@ bool InfileMerger::merge(std::shared_ptr<proto::WorkerResponse> const& response)
     auto start = std::chrono::system_clock::now();
     switch (_dbEngine) {
         case MYISAM:
-            ret = _applyMysqlMyIsam(infileStatement);
+            ret = _applyMysqlMyIsam(loadRows);
             break;
         case INNODB:  // Fallthrough
         case MEMORY:
-            ret = _applyMysqlInnoDb(infileStatement);
+            ret = _applyMysqlInnoDb(loadRows, *pooledConn);
             break;
         default:
             throw std::invalid_argument("InfileMerger::_dbEngine is unknown =" + engineToStr(_dbEngine));
@@ -324,9 +376,10 @@ bool InfileMerger::merge(std::shared_ptr<proto::WorkerResponse> const& response)
     tctMerge.addToValue(resultSize);
     auto end = std::chrono::system_clock::now();
     auto mergeDur = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    util::SemaMgr& semaMgr = _mergeConnPool->getSemaMgr();
     LOGS(_log, LOG_LVL_DEBUG,
-         "mergeDur=" << mergeDur.count() << " sema(total=" << _semaMgrConn->getTotalCount()
-                     << " used=" << _semaMgrConn->getUsedCount() << ")");
+         "mergeDur=" << mergeDur.count() << " sema(total=" << semaMgr.getTotalCount()
+                     << " used=" << semaMgr.getUsedCount() << ")");
     if (not ret) {
         LOGS(_log, LOG_LVL_ERROR, "InfileMerger::merge mysql applyMysql failure");
     } else {
@@ -339,7 +392,33 @@ bool InfileMerger::merge(std::shared_ptr<proto::WorkerResponse> const& response)
     return ret;
 }
 
-bool InfileMerger::_applyMysqlMyIsam(std::string const& query) {
+InfileMerger::LoadFunc InfileMerger::_makeInfileLoad(proto::Result& result, int resultJobId) {
+    mysql::RowBuffer::Ptr pRowBuffer;
+    if (proto::isColumnar(result)) {
+        pRowBuffer = std::make_shared<ColumnarRowBuffer>(result, resultJobId);
+    } else {
+        pRowBuffer = std::make_shared<ProtoRowBuffer>(result, resultJobId, _jobIdColName, _jobIdSqlType,
+                                                      _jobIdMysqlType);
+    }
+    std::string const virtFile = _infileMgr.prepareSrc(pRowBuffer);
+    std::string const infileStatement = sql::formLoadInfile(_mergeTable, virtFile);
+    return [infileStatement](MYSQL* mysql) {
+        return mysql_real_query(mysql, infileStatement.data(), infileStatement.size()) == 0;
+    };
+}
+
+InfileMerger::LoadFunc InfileMerger::_makePreparedLoad(proto::Result const& result, int resultJobId) {
+    auto inserter = std::make_shared<PreparedRowInserter>(_mergeTable, result, resultJobId);
+    return [inserter](MYSQL* mysql) {
+        if (!inserter->insert(mysql)) {
+            LOGS(_log, LOG_LVL_ERROR, "InfileMerger prepared insert failed " << inserter->getError());
+            return false;
+        }
+        return true;
+    };
+}
+
+bool InfileMerger::_applyMysqlMyIsam(LoadFunc const& loadRows) {
     std::unique_lock<std::mutex> lock(_mysqlMutex);
     for (int j = 0; !_mysqlConn.connected(); ++j) {
         // should have connected during construction
@@ -356,38 +435,60 @@ bool InfileMerger::_applyMysqlMyIsam(std::string const& query) {
         }
     }
 
-    int rc = mysql_real_query(_mysqlConn.getMySql(), query.data(), query.size());
-    return rc == 0;
+    return loadRows(_mysqlConn.getMySql());
 }
 
-bool InfileMerger::_applyMysqlInnoDb(std::string const& query) {
-    mysql::MySqlConnection mySConn(_config.mySqlConfig);
-    if (!mySConn.connected()) {
-        if (!_setupConnectionInnoDb(mySConn)) {
-            LOGS(_log, LOG_LVL_ERROR, "InfileMerger::_applyMysql _setupConnection() failed!!!");
-            return false;  // Reconnection failed. This is an error.
-        }
+bool InfileMerger::_applyMysqlInnoDb(LoadFunc const& loadRows, MergeConnectionPool::Handle& pooledConn) {
+    mysql::MySqlConnection* mySConn = pooledConn.get();
+    if (mySConn == nullptr) {
+        LOGS(_log, LOG_LVL_ERROR, "InfileMerger::_applyMysql _setupConnection() failed!!!");
+        return false;  // Reconnection failed. This is an error.
     }
 
-    int rc = mysql_real_query(mySConn.getMySql(), query.data(), query.size());
-    return rc == 0;
+    // The connection is shared with other InfileMergers, so the handler
+    // must not be left pointing at this one.
+    _infileMgr.attach(mySConn->getMySql());
+    bool const ok = loadRows(mySConn->getMySql());
+    _infileMgr.detachReset(mySConn->getMySql());
+    if (!ok) {
+        LOGS(_log, LOG_LVL_ERROR, "InfileMerger::_applyMysqlInnoDb failed " << mySConn->getError());
+        pooledConn.discard();  // The state of the connection is unknown.
+        return false;
+    }
+    return true;
 }
 
-bool InfileMerger::_setupConnectionInnoDb(mysql::MySqlConnection& mySConn) {
-    // Make 10 attempts to open the connection. They can fail when the
-    // system is busy.
-    for (int j = 0; j < sqlConnectionAttempts(); ++j) {
-        if (mySConn.connect()) {
-            _infileMgr.attach(mySConn.getMySql());
-            return true;
-        } else {
-            LOGS(_log, LOG_LVL_ERROR, "_setupConnectionInnoDb failed connect attempt " << j);
-            sleep(1);
+bool InfileMerger::_loadInMemoryRows() {
+    if (_hashAggregator == nullptr && _topKMerger == nullptr) return true;
+    auto isInvalid = [this](int jobIdAttempt) {
+        return _invalidJobAttemptMgr.isJobAttemptInvalid(jobIdAttempt);
+    };
+    auto loadResult = [this](proto::Result& result) {
+        LoadFunc loadRows = (_mergeMethod == PREPARED) ? _makePreparedLoad(result, IN_MEMORY_JOB_ID)
+                                                       : _makeInfileLoad(result, IN_MEMORY_JOB_ID);
+        if (_dbEngine == MYISAM) {
+            return _applyMysqlMyIsam(loadRows);
         }
+        auto pooledConn = _mergeConnPool->acquire();
+        return _applyMysqlInnoDb(loadRows, *pooledConn);
+    };
+    std::string msg;
+    if (_hashAggregator != nullptr && not _hashAggregator->finish(isInvalid, loadResult)) {
+        msg = _getQueryIdStr() + " in memory aggregation " + _hashAggregator->getError();
+    } else if (_topKMerger != nullptr && not _topKMerger->finish(isInvalid, loadResult)) {
+        msg = _getQueryIdStr() + " in memory ORDER BY ... LIMIT " + _topKMerger->getError();
+    } else {
+        return true;
     }
+    _error = InfileMergerError(util::ErrorCode::RESULT_IMPORT, msg);
+    LOGS(_log, LOG_LVL_ERROR, _error.getMsg());
     return false;
 }
 
+bool InfileMerger::getTopKBound(std::string& bound) const {
+    return _topKMerger != nullptr && _topKMerger->getBound(bound);
+}
+
 size_t InfileMerger::getTotalResultSize() const { return _totalResultSize; }
 
 bool InfileMerger::finalize(size_t& collectedBytes, int64_t& rowCount) {
@@ -402,6 +503,9 @@ bool InfileMerger::finalize(size_t& collectedBytes, int64_t& rowCount) {
         LOGS(_log, LOG_LVL_ERROR, " failed to remove invalid rows.");
         return false;
     }
+    if (not _loadInMemoryRows()) {
+        return false;
+    }
     if (_mergeTable != _config.targetTable) {
         // Aggregation needed: Do the aggregation.
         std::string mergeSelect = _config.mergeStmt->getQueryTemplate().sqlFragment();
@@ -533,6 +637,14 @@ bool InfileMerger::makeResultsTableForQuery(query::SelectStmt const& stmt) {
     if (not getSchemaForQueryResults(stmt, schema)) {
         return false;
     }
+    int const maxAggregateGroups = _config.czarConfig.getMaxAggregateGroups();
+    if (_config.mergeStmt != nullptr && maxAggregateGroups > 0) {
+        _hashAggregator = HashAggregator::create(*_config.mergeStmt, schema, maxAggregateGroups);
+    }
+    int const maxTopKRows = _config.czarConfig.getMaxTopKRows();
+    if (_config.mergeStmt != nullptr && _hashAggregator == nullptr && maxTopKRows > 0) {
+        _topKMerger = TopKMerger::create(*_config.mergeStmt, schema, maxTopKRows);
+    }
     _addJobIdColumnToSchema(schema);
     std::string createStmt = sql::formCreateTable(_mergeTable, schema);
     switch (_dbEngine) {
@@ -30,6 +30,7 @@
 /// (see individual class documentation for more information)
 
 // System headers
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <set>
@@ -39,10 +40,12 @@
 #include "mysql/LocalInfile.h"
 #include "mysql/MySqlConfig.h"
 #include "mysql/MySqlConnection.h"
+#include "rproc/HashAggregator.h"
+#include "rproc/MergeConnectionPool.h"
+#include "rproc/TopKMerger.h"
 #include "sql/SqlConnection.h"
 #include "util/Error.h"
 #include "util/EventThread.h"
-#include "util/SemaMgr.h"
 
 // Forward declarations
 namespace lsst::qserv {
@@ -167,7 +170,7 @@ private:
 class InfileMerger {
 public:
     explicit InfileMerger(InfileMergerConfig const& c, std::shared_ptr<qproc::DatabaseModels> const& dm,
-                          std::shared_ptr<util::SemaMgr> const& semaMgrConn);
+                          MergeConnectionPool::Ptr const& mergeConnPool);
     InfileMerger() = delete;
     InfileMerger(InfileMerger const&) = delete;
     InfileMerger& operator=(InfileMerger const&) = delete;
@@ -175,6 +178,10 @@ public:
 
     enum DbEngine { MYISAM, INNODB, MEMORY };
 
+    /// How rows are written to the result table, LOAD DATA LOCAL INFILE
+    /// or batched INSERT prepared statements.
+    enum MergeMethod { INFILE, PREPARED };
+
     std::string engineToStr(InfileMerger::DbEngine engine);
 
     /// Create the shared thread pool and/or change its size.
@@ -212,6 +219,11 @@ public:
 
     void setMergeStmtFromList(std::shared_ptr<query::SelectStmt> const& mergeStmt) const;
 
+    /// Set 'bound' to the value of the first ORDER BY column that the rows of
+    /// jobs which haven't been dispatched yet must reach to be in the result.
+    /// @return false if there is no such bound, see TopKMerger::getBound().
+    bool getTopKBound(std::string& bound) const;
+
     /**
      * @brief Make a schema that matches the results of the given query.
      *
@@ -241,8 +253,18 @@ public:
     size_t getTotalResultSize() const;
 
 private:
-    bool _applyMysqlMyIsam(std::string const& query);
-    bool _applyMysqlInnoDb(std::string const& query);
+    /// Writes the rows of one result to the result table using the given connection.
+    using LoadFunc = std::function<bool(MYSQL*)>;
+
+    /// @return a LoadFunc that writes the rows of 'result' with LOAD DATA LOCAL INFILE.
+    LoadFunc _makeInfileLoad(proto::Result& result, int resultJobId);
+    /// @return a LoadFunc that writes the rows of 'result' with prepared INSERT statements.
+    LoadFunc _makePreparedLoad(proto::Result const& result, int resultJobId);
+
+    bool _applyMysqlMyIsam(LoadFunc const& loadRows);
+    bool _applyMysqlInnoDb(LoadFunc const& loadRows, MergeConnectionPool::Handle& pooledConn);
+    /// Write the rows held by _hashAggregator or _topKMerger to the merge table.
+    bool _loadInMemoryRows();
     bool _merge(std::shared_ptr<proto::WorkerResponse>& response);
     int _readHeader(proto::ProtoHeader& header, char const* buffer, int length);
     int _readResult(proto::Result& result, char const* buffer, int length);
@@ -261,6 +283,9 @@ private:
     /// Set the engine name from the string engineName. Default to MYISAM.
     void _setEngineFromStr(std::string const& engineName);
 
+    /// Set the merge method from the string methodName. Default to INFILE.
+    void _setMergeMethodFromStr(std::string const& methodName);
+
     bool _setupConnectionMyIsam() {
         if (_mysqlConn.connect()) {
             _infileMgr.attach(_mysqlConn.getMySql());
@@ -269,10 +294,9 @@ private:
         return false;
     }
 
-    bool _setupConnectionInnoDb(mysql::MySqlConnection& mySConn);
-
     InfileMergerConfig _config;                    ///< Configuration
     DbEngine _dbEngine = MYISAM;                   ///< ENGINE used for aggregating results.
+    MergeMethod _mergeMethod = INFILE;             ///< How rows are written to the result table.
     std::shared_ptr<sql::SqlConnection> _sqlConn;  ///< SQL connection
     std::string _mergeTable;                       ///< Table for result loading
     InfileMergerError _error;                      ///< Error state
@@ -321,7 +345,16 @@ private:
     std::map<int, size_t> _perJobResultSize;  ///< Result size for each job
     std::mutex _mtxResultSizeMtx;             ///< Protects _perJobResultSize and _totalResultSize.
 
-    std::shared_ptr<util::SemaMgr> _semaMgrConn;  ///< Used to limit the number of open mysql connections.
+    /// Connections for parallel merging, also limits the number of open mysql connections.
+    MergeConnectionPool::Ptr _mergeConnPool;
+
+    /// Reduces the rows of simple aggregate queries before they reach the merge table,
+    /// nullptr when the merge statement doesn't allow it.
+    HashAggregator::Ptr _hashAggregator;
+
+    /// Keeps only the rows of ORDER BY ... LIMIT queries that may be in the result,
+    /// nullptr when the merge statement doesn't allow it.
+    TopKMerger::Ptr _topKMerger;
 };
 
 }  // namespace lsst::qserv::rproc
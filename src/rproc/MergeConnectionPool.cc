@@ -0,0 +1,114 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "rproc/MergeConnectionPool.h"
+
+// System headers
+#include <unistd.h>
+
+// Third-party headers
+#include <mysql/mysql.h>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "global/clock_defs.h"
+#include "qdisp/CzarStats.h"
+
+using namespace std;
+
+namespace {
+LOG_LOGGER _log = LOG_GET("lsst.qserv.rproc.MergeConnectionPool");
+}
+
+namespace lsst::qserv::rproc {
+
+MergeConnectionPool::Handle::~Handle() {
+    if (_conn != nullptr) {
+        _pool._release(move(_conn));
+    }
+}
+
+MergeConnectionPool::MergeConnectionPool(mysql::MySqlConfig const& config, util::SemaMgr::Ptr const& semaMgr,
+                                         int maxConnectAttempts)
+        : _config(config), _semaMgr(semaMgr), _maxConnectAttempts(maxConnectAttempts) {}
+
+unique_ptr<MergeConnectionPool::Handle> MergeConnectionPool::acquire() {
+    auto cStats = qdisp::CzarStats::get();
+    auto waitStart = CLOCK::now();
+    unique_ptr<Handle> handle(new Handle(*this, make_unique<util::SemaLock>(*_semaMgr)));
+    cStats->addMergeConnWait(waitStart, CLOCK::now());
+
+    handle->_conn = _takeIdle();
+    if (handle->_conn != nullptr) {
+        cStats->addMergeConnPoolHit();
+    } else {
+        cStats->addMergeConnPoolMiss();
+        handle->_conn = _connect();
+    }
+    return handle;
+}
+
+size_t MergeConnectionPool::getIdleCount() const {
+    lock_guard<mutex> lg(_mtx);
+    return _idle.size();
+}
+
+unique_ptr<mysql::MySqlConnection> MergeConnectionPool::_takeIdle() {
+    while (true) {
+        unique_ptr<mysql::MySqlConnection> conn;
+        Clock::time_point returned;
+        {
+            lock_guard<mutex> lg(_mtx);
+            if (_idle.empty()) return nullptr;
+            conn = move(_idle.back().first);
+            returned = _idle.back().second;
+            _idle.pop_back();
+        }
+        // Recently used connections are very likely to be fine, a failure
+        // will be caught by the query anyway.
+        if (Clock::now() - returned < IDLE_CHECK_TIME || mysql_ping(conn->getMySql()) == 0) {
+            return conn;
+        }
+        LOGS(_log, LOG_LVL_INFO, "dropping stale merge connection " << conn->getError());
+    }
+}
+
+unique_ptr<mysql::MySqlConnection> MergeConnectionPool::_connect() {
+    auto conn = make_unique<mysql::MySqlConnection>(_config);
+    // Connecting can fail when the system is busy, so make several attempts.
+    for (int j = 0; j < _maxConnectAttempts; ++j) {
+        if (conn->connect()) return conn;
+        LOGS(_log, LOG_LVL_ERROR, "MergeConnectionPool failed connect attempt " << j);
+        sleep(1);
+    }
+    return nullptr;
+}
+
+void MergeConnectionPool::_release(unique_ptr<mysql::MySqlConnection> conn) {
+    lock_guard<mutex> lg(_mtx);
+    _idle.emplace_back(move(conn), Clock::now());
+}
+
+}  // namespace lsst::qserv::rproc
@@ -0,0 +1,127 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_RPROC_MERGECONNECTIONPOOL_H
+#define LSST_QSERV_RPROC_MERGECONNECTIONPOOL_H
+
+// System headers
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Qserv headers
+#include "mysql/MySqlConfig.h"
+#include "mysql/MySqlConnection.h"
+#include "util/SemaMgr.h"
+
+namespace lsst::qserv::rproc {
+
+/// MergeConnectionPool keeps connections to the result database open between
+/// merges so that parallel (INNODB and MEMORY) merging doesn't pay for a
+/// connect and authentication per result message. It is shared by all
+/// InfileMerger instances of the czar.
+///
+/// The number of connections in use is limited by the SemaMgr, so the pool
+/// never holds more connections than the semaphore allows to be in use.
+/// Hits, misses, and the time spent waiting for a connection are reported
+/// to CzarStats.
+class MergeConnectionPool {
+public:
+    using Ptr = std::shared_ptr<MergeConnectionPool>;
+    using Clock = std::chrono::steady_clock;
+
+    /// A connection checked out of the pool. The destructor returns the
+    /// connection to the pool and frees the semaphore slot.
+    class Handle {
+    public:
+        Handle() = delete;
+        Handle(Handle const&) = delete;
+        Handle& operator=(Handle const&) = delete;
+        ~Handle();
+
+        /// @return the connection, nullptr if it couldn't be established.
+        mysql::MySqlConnection* get() { return _conn.get(); }
+
+        /// Close the connection instead of returning it to the pool. This
+        /// should be called when the state of the connection is unknown,
+        /// such as after a failed query.
+        void discard() { _conn.reset(); }
+
+    private:
+        friend class MergeConnectionPool;
+        Handle(MergeConnectionPool& pool, std::unique_ptr<util::SemaLock> semaLock)
+                : _pool(pool), _semaLock(std::move(semaLock)) {}
+
+        MergeConnectionPool& _pool;
+        std::unique_ptr<util::SemaLock> _semaLock;  ///< Released after _conn is returned.
+        std::unique_ptr<mysql::MySqlConnection> _conn;
+    };
+
+    /// @param config - connection parameters for the result database.
+    /// @param semaMgr - limits the number of connections in use.
+    /// @param maxConnectAttempts - attempts to make, one second apart, when
+    ///             a new connection is needed.
+    MergeConnectionPool(mysql::MySqlConfig const& config, util::SemaMgr::Ptr const& semaMgr,
+                        int maxConnectAttempts);
+    MergeConnectionPool() = delete;
+    MergeConnectionPool(MergeConnectionPool const&) = delete;
+    MergeConnectionPool& operator=(MergeConnectionPool const&) = delete;
+    ~MergeConnectionPool() = default;
+
+    /// Wait until a connection may be used, then return an idle connection
+    /// from the pool or a newly connected one. The pool must outlive the
+    /// returned Handle.
+    std::unique_ptr<Handle> acquire();
+
+    util::SemaMgr& getSemaMgr() { return *_semaMgr; }
+
+    /// @return the number of idle connections in the pool.
+    size_t getIdleCount() const;
+
+    /// Connections idle for longer than this are checked with mysql_ping()
+    /// before being handed out, as the server may have closed them.
+    static constexpr std::chrono::seconds IDLE_CHECK_TIME{30};
+
+private:
+    /// @return an idle connection that is still usable, nullptr if there is none.
+    std::unique_ptr<mysql::MySqlConnection> _takeIdle();
+
+    /// @return a new connection, nullptr if all attempts to connect failed.
+    std::unique_ptr<mysql::MySqlConnection> _connect();
+
+    /// Put 'conn' back in the pool.
+    void _release(std::unique_ptr<mysql::MySqlConnection> conn);
+
+    mysql::MySqlConfig const _config;
+    util::SemaMgr::Ptr const _semaMgr;
+    int const _maxConnectAttempts;
+
+    mutable std::mutex _mtx;  ///< Protects _idle
+    /// Idle connections and the time they were returned, most recent last.
+    std::vector<std::pair<std::unique_ptr<mysql::MySqlConnection>, Clock::time_point>> _idle;
+};
+
+}  // namespace lsst::qserv::rproc
+
+#endif  // LSST_QSERV_RPROC_MERGECONNECTIONPOOL_H
@@ -0,0 +1,196 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "rproc/PreparedRowInserter.h"
+
+// System headers
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+using namespace std;
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.rproc.PreparedRowInserter");
+
+/// A statement may have at most this many placeholders.
+unsigned int const MAX_PLACEHOLDERS = 65535;
+
+struct StmtCloser {
+    void operator()(MYSQL_STMT* stmt) const { mysql_stmt_close(stmt); }
+};
+
+void bindNull(MYSQL_BIND& bind) { bind.buffer_type = MYSQL_TYPE_NULL; }
+
+void bindValue(MYSQL_BIND& bind, enum_field_types type, void const* buffer, unsigned long length,
+               bool isUnsigned = false) {
+    bind.buffer_type = type;
+    // The client library only reads input buffers.
+    bind.buffer = const_cast<void*>(buffer);
+    bind.buffer_length = length;  // Used as the value length when bind.length is null.
+    bind.is_unsigned = isUnsigned;
+}
+
+}  // namespace
+
+namespace lsst::qserv::rproc {
+
+PreparedRowInserter::PreparedRowInserter(string const& table, proto::Result const& result, int jobId)
+        : _table(table), _result(result), _jobId(jobId) {
+    size_t dataBytes = 0;
+    if (proto::isColumnar(_result)) {
+        _rowTotal = _result.rowcount();
+        _columnCount = _result.columnblock_size();
+        for (auto const& block : _result.columnblock()) {
+            _columns.emplace_back(block, _rowTotal);
+            dataBytes += block.data().size();
+        }
+    } else {
+        _rowTotal = _result.row_size();
+        _columnCount = (_rowTotal > 0) ? _result.row(0).column_size() : 0;
+        for (auto const& row : _result.row()) {
+            for (auto const& col : row.column()) {
+                dataBytes += col.size();
+            }
+        }
+    }
+    // Rows of the same batch size can reuse the prepared statement, so the
+    // batch size is based on the average row size rather than on each row.
+    size_t const rowBytes = max<size_t>(1, (_rowTotal > 0) ? dataBytes / _rowTotal : 0);
+    _batchRows = min<size_t>({MAX_BATCH_ROWS, MAX_PLACEHOLDERS / getValuesPerRow(),
+                              max<size_t>(1, MAX_BATCH_BYTES / rowBytes)});
+    LOGS(_log, LOG_LVL_TRACE,
+         "rows=" << _rowTotal << " columns=" << _columnCount << " batchRows=" << _batchRows);
+}
+
+string PreparedRowInserter::_makeInsert(unsigned int rowCount) const {
+    string row = "(?";
+    for (unsigned int j = 0; j < _columnCount; ++j) {
+        row += ",?";
+    }
+    row += ")";
+    string sql = "INSERT INTO " + _table + " VALUES ";
+    sql.reserve(sql.size() + rowCount * (row.size() + 1));
+    for (unsigned int j = 0; j < rowCount; ++j) {
+        if (j > 0) sql += ',';
+        sql += row;
+    }
+    return sql;
+}
+
+void PreparedRowInserter::bindRows(unsigned int firstRow, unsigned int rowCount, vector<MYSQL_BIND>& binds) {
+    unsigned int const valuesPerRow = getValuesPerRow();
+    binds.resize(rowCount * valuesPerRow);
+    memset(binds.data(), 0, binds.size() * sizeof(MYSQL_BIND));
+    MYSQL_BIND* bind = binds.data();
+    for (unsigned int row = firstRow; row < firstRow + rowCount; ++row) {
+        bindValue(*bind++, MYSQL_TYPE_LONG, &_jobId, sizeof(_jobId));
+        if (_columns.empty()) {
+            proto::RowBundle const& rowBundle = _result.row(row);
+            for (unsigned int col = 0; col < _columnCount; ++col, ++bind) {
+                if (col < static_cast<unsigned int>(rowBundle.isnull_size()) && rowBundle.isnull(col)) {
+                    bindNull(*bind);
+                } else {
+                    string const& val = rowBundle.column(col);
+                    bindValue(*bind, MYSQL_TYPE_STRING, val.data(), val.size());
+                }
+            }
+            continue;
+        }
+        for (auto const& col : _columns) {
+            if (col.isNull(row)) {
+                bindNull(*bind++);
+                continue;
+            }
+            switch (col.getEncoding()) {
+                case proto::ColumnBlock::INT64:
+                    bindValue(*bind, MYSQL_TYPE_LONGLONG, col.getFixedData(row), sizeof(int64_t));
+                    break;
+                case proto::ColumnBlock::UINT64:
+                    bindValue(*bind, MYSQL_TYPE_LONGLONG, col.getFixedData(row), sizeof(uint64_t), true);
+                    break;
+                case proto::ColumnBlock::DOUBLE:
+                    bindValue(*bind, MYSQL_TYPE_DOUBLE, col.getFixedData(row), sizeof(double));
+                    break;
+                case proto::ColumnBlock::FLOAT:
+                    bindValue(*bind, MYSQL_TYPE_FLOAT, col.getFixedData(row), sizeof(float));
+                    break;
+                default: {
+                    string_view const val = col.getBytes(row);
+                    bindValue(*bind, MYSQL_TYPE_STRING, val.data(), val.size());
+                }
+            }
+            ++bind;
+        }
+    }
+}
+
+bool PreparedRowInserter::insert(MYSQL* mysql) {
+    if (_rowTotal == 0) return true;
+    for (auto const& row : _result.row()) {
+        if (static_cast<unsigned int>(row.column_size()) != _columnCount) {
+            _error = "rows have different column counts " + to_string(row.column_size()) + " and " +
+                     to_string(_columnCount);
+            return false;
+        }
+    }
+    unique_ptr<MYSQL_STMT, StmtCloser> stmt(mysql_stmt_init(mysql));
+    if (stmt == nullptr) {
+        _error = string("mysql_stmt_init failed ") + mysql_error(mysql);
+        return false;
+    }
+    unsigned int preparedRows = 0;
+    for (unsigned int firstRow = 0; firstRow < _rowTotal; firstRow += _batchRows) {
+        unsigned int const rowCount = min(_batchRows, _rowTotal - firstRow);
+        if (rowCount != preparedRows) {
+            string const sql = _makeInsert(rowCount);
+            if (mysql_stmt_prepare(stmt.get(), sql.data(), sql.size()) != 0) {
+                _error = string("prepare failed ") + mysql_stmt_error(stmt.get());
+                return false;
+            }
+            preparedRows = rowCount;
+        }
+        if (!_insertBatch(stmt.get(), firstRow, rowCount)) return false;
+    }
+    return true;
+}
+
+bool PreparedRowInserter::_insertBatch(MYSQL_STMT* stmt, unsigned int firstRow, unsigned int rowCount) {
+    bindRows(firstRow, rowCount, _binds);
+    if (mysql_stmt_bind_param(stmt, _binds.data()) != 0) {
+        _error = string("bind failed ") + mysql_stmt_error(stmt);
+        return false;
+    }
+    if (mysql_stmt_execute(stmt) != 0) {
+        _error = "insert of rows " + to_string(firstRow) + "-" + to_string(firstRow + rowCount - 1) +
+                 " failed " + mysql_stmt_error(stmt);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace lsst::qserv::rproc
@@ -0,0 +1,99 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_RPROC_PREPAREDROWINSERTER_H
+#define LSST_QSERV_RPROC_PREPAREDROWINSERTER_H
+
+// System headers
+#include <string>
+#include <vector>
+
+// Third-party headers
+#include <mysql/mysql.h>
+
+// Qserv headers
+#include "proto/ColumnarResult.h"
+
+namespace lsst::qserv::rproc {
+
+/// PreparedRowInserter writes the rows of a Result message into a table with
+/// batched multi-row INSERT prepared statements. The values are bound with
+/// MYSQL_BIND directly from the message, so there is no escaped text for
+/// the client to produce and for the server to parse back, as there is
+/// with LOAD DATA.
+///
+/// Values of column-based (protocol 3) results are sent in their binary
+/// form. Values of row-based results are sent as strings and converted by
+/// the server, the same as LOAD DATA would.
+///
+/// As with the LOAD DATA path, the jobId column is inserted first,
+/// followed by the columns of the result.
+class PreparedRowInserter {
+public:
+    /// @throws proto::ColumnarResultError if the column blocks of 'result' are inconsistent.
+    PreparedRowInserter(std::string const& table, proto::Result const& result, int jobId);
+    PreparedRowInserter() = delete;
+    PreparedRowInserter(PreparedRowInserter const&) = delete;
+    PreparedRowInserter& operator=(PreparedRowInserter const&) = delete;
+
+    /// Insert all rows using 'mysql'.
+    /// @return true on success, otherwise getError() describes the failure.
+    bool insert(MYSQL* mysql);
+
+    std::string const& getError() const { return _error; }
+
+    /// @return the number of rows in each INSERT statement, the last may have fewer.
+    unsigned int getBatchRows() const { return _batchRows; }
+
+    /// @return the number of values in each row, including the jobId.
+    unsigned int getValuesPerRow() const { return _columnCount + 1; }
+
+    /// Fill 'binds' with the values of 'rowCount' rows starting at 'firstRow'.
+    /// The buffers point into the Result message, which must outlive 'binds'.
+    void bindRows(unsigned int firstRow, unsigned int rowCount, std::vector<MYSQL_BIND>& binds);
+
+    /// Upper limit of rows per INSERT.
+    static constexpr unsigned int MAX_BATCH_ROWS = 1000;
+    /// Approximate upper limit of bytes of data per INSERT, which keeps
+    /// statements well below the server's max_allowed_packet.
+    static constexpr size_t MAX_BATCH_BYTES = 4 * 1024 * 1024;
+
+private:
+    /// @return the INSERT statement for 'rowCount' rows.
+    std::string _makeInsert(unsigned int rowCount) const;
+
+    /// Bind and execute one batch of rows with the prepared statement.
+    bool _insertBatch(MYSQL_STMT* stmt, unsigned int firstRow, unsigned int rowCount);
+
+    std::string const _table;
+    proto::Result const& _result;
+    int _jobId;  ///< Not const, MYSQL_BIND needs a non-const buffer.
+    std::vector<proto::ColumnBlockReader> _columns;  ///< Only for column-based results.
+    unsigned int _rowTotal = 0;
+    unsigned int _columnCount = 0;
+    unsigned int _batchRows = 1;
+    std::vector<MYSQL_BIND> _binds;
+    std::string _error;
+};
+
+}  // namespace lsst::qserv::rproc
+
+#endif  // LSST_QSERV_RPROC_PREPAREDROWINSERTER_H
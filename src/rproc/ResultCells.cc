@@ -0,0 +1,190 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "rproc/ResultCells.h"
+
+// System headers
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <limits>
+
+// Third-party headers
+#include <mysql/mysql.h>
+
+// Qserv headers
+#include "sql/Schema.h"
+
+using namespace std;
+
+namespace {
+
+using lsst::qserv::proto::ColumnBlock;
+using lsst::qserv::proto::ColumnBlockReader;
+
+/// Multiply 'val' by 10^exp.
+/// @return false on overflow.
+bool scaleUp(int64_t& val, int exp) {
+    for (int i = 0; i < exp; ++i) {
+        if (__builtin_mul_overflow(val, 10, &val)) return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+namespace lsst::qserv::rproc {
+
+NumericType NumericType::fromColType(sql::ColType const& colType) {
+    NumericType num;
+    switch (colType.mysqlType) {
+        case MYSQL_TYPE_TINY:
+        case MYSQL_TYPE_SHORT:
+        case MYSQL_TYPE_LONG:
+        case MYSQL_TYPE_INT24:
+        case MYSQL_TYPE_LONGLONG:
+            num.kind = EXACT;
+            break;
+        case MYSQL_TYPE_FLOAT:
+        case MYSQL_TYPE_DOUBLE:
+            num.kind = APPROX;
+            break;
+        case MYSQL_TYPE_DECIMAL:
+        case MYSQL_TYPE_NEWDECIMAL: {
+            // The type is DECIMAL(precision,scale).
+            auto const pos = colType.sqlType.find(',');
+            if (pos == string::npos) break;
+            int const scale = atoi(colType.sqlType.c_str() + pos + 1);
+            if (scale < 0 || scale > 18) break;
+            num.kind = EXACT;
+            num.scale = scale;
+            break;
+        }
+        default:
+            break;
+    }
+    return num;
+}
+
+bool parseExact(string_view str, int scale, int64_t& out) {
+    size_t pos = 0;
+    bool negative = false;
+    if (pos < str.size() && (str[pos] == '-' || str[pos] == '+')) {
+        negative = str[pos] == '-';
+        ++pos;
+    }
+    // Accumulate the negative value so that the minimum int64 can be parsed.
+    int64_t val = 0;
+    int decimals = -1;
+    bool hasDigits = false;
+    for (; pos < str.size(); ++pos) {
+        char const c = str[pos];
+        if (c == '.' && decimals < 0) {
+            decimals = 0;
+            continue;
+        }
+        if (c < '0' || c > '9') return false;
+        if (decimals >= 0 && ++decimals > scale) return false;
+        if (__builtin_mul_overflow(val, 10, &val) || __builtin_sub_overflow(val, c - '0', &val)) return false;
+        hasDigits = true;
+    }
+    if (!hasDigits || !scaleUp(val, scale - max(decimals, 0))) return false;
+    if (!negative) {
+        if (val == numeric_limits<int64_t>::min()) return false;
+        val = -val;
+    }
+    out = val;
+    return true;
+}
+
+ResultCells::ResultCells(proto::Result const& result)
+        : _result(result), _rowCount(proto::getResultRowCount(result)) {
+    for (auto const& block : result.columnblock()) {
+        _columns.emplace_back(block, _rowCount);
+    }
+}
+
+void ResultCells::getText(unsigned int row, size_t col, string& out) const {
+    if (_columns.empty()) {
+        out = _result.row(row).column(col);
+        return;
+    }
+    ColumnBlockReader const& reader = _columns[col];
+    if (reader.getEncoding() == ColumnBlock::BYTES) {
+        string_view const val = reader.getBytes(row);
+        out.assign(val.data(), val.size());
+        return;
+    }
+    out.resize(ColumnBlockReader::MAX_NUMERIC_CHARS);
+    out.resize(reader.toChars(row, out.data()));
+}
+
+bool ResultCells::getExact(unsigned int row, size_t col, int scale, int64_t& out) const {
+    if (_columns.empty()) return parseExact(_result.row(row).column(col), scale, out);
+    ColumnBlockReader const& reader = _columns[col];
+    switch (reader.getEncoding()) {
+        case ColumnBlock::INT64:
+            out = reader.getInt64(row);
+            return scaleUp(out, scale);
+        case ColumnBlock::UINT64: {
+            uint64_t const val = reader.getUInt64(row);
+            if (val > static_cast<uint64_t>(numeric_limits<int64_t>::max())) return false;
+            out = val;
+            return scaleUp(out, scale);
+        }
+        case ColumnBlock::BYTES:
+            return parseExact(reader.getBytes(row), scale, out);
+        default:
+            return false;
+    }
+}
+
+bool ResultCells::getApprox(unsigned int row, size_t col, double& out) const {
+    string_view str;
+    if (_columns.empty()) {
+        str = _result.row(row).column(col);
+    } else {
+        ColumnBlockReader const& reader = _columns[col];
+        switch (reader.getEncoding()) {
+            case ColumnBlock::INT64:
+                out = reader.getInt64(row);
+                return true;
+            case ColumnBlock::UINT64:
+                out = reader.getUInt64(row);
+                return true;
+            case ColumnBlock::DOUBLE:
+                out = reader.getDouble(row);
+                return true;
+            case ColumnBlock::FLOAT:
+                out = reader.getFloat(row);
+                return true;
+            default:
+                str = reader.getBytes(row);
+        }
+    }
+    auto const end = str.data() + str.size();
+    auto const [ptr, ec] = from_chars(str.data(), end, out);
+    return ec == errc() && ptr == end;
+}
+
+}  // namespace lsst::qserv::rproc
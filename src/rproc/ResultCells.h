@@ -0,0 +1,96 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_RPROC_RESULTCELLS_H
+#define LSST_QSERV_RPROC_RESULTCELLS_H
+
+// System headers
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Qserv headers
+#include "proto/ColumnarResult.h"
+
+// Forward declarations
+namespace lsst::qserv::sql {
+struct ColType;
+}  // namespace lsst::qserv::sql
+
+namespace lsst::qserv::rproc {
+
+/// How the values of a numeric column are held in memory. EXACT values are
+/// integers scaled by 10^scale, which covers the integer and DECIMAL column
+/// types, APPROX values are doubles.
+struct NumericType {
+    enum Kind { NONE, EXACT, APPROX };
+    Kind kind = NONE;
+    int scale = 0;
+
+    /// @return the NumericType of a column of type 'colType', with kind NONE
+    ///         if the type isn't numeric.
+    static NumericType fromColType(sql::ColType const& colType);
+};
+
+/// Parse the text of an integer or DECIMAL value into an integer scaled by 10^scale.
+/// @return false if 'str' isn't a number, has more than 'scale' decimals, or overflows.
+bool parseExact(std::string_view str, int scale, int64_t& out);
+
+/// ResultCells gives the same access to the cells of row-based and
+/// column-based Result messages.
+class ResultCells {
+public:
+    /// @throws proto::ColumnarResultError if the column blocks of 'result' are inconsistent.
+    explicit ResultCells(proto::Result const& result);
+
+    unsigned int getRowCount() const { return _rowCount; }
+
+    size_t getColumnCount(unsigned int row) const {
+        return _columns.empty() ? _result.row(row).column_size() : _columns.size();
+    }
+
+    bool isNull(unsigned int row, size_t col) const {
+        if (!_columns.empty()) return _columns[col].isNull(row);
+        auto const& rowBundle = _result.row(row);
+        return static_cast<int>(col) < rowBundle.isnull_size() && rowBundle.isnull(col);
+    }
+
+    /// Set 'out' to the text of a non-NULL cell.
+    void getText(unsigned int row, size_t col, std::string& out) const;
+
+    /// Set 'out' to the value of a non-NULL cell scaled by 10^scale.
+    /// @return false if the value can't be held exactly.
+    bool getExact(unsigned int row, size_t col, int scale, int64_t& out) const;
+
+    /// Set 'out' to the value of a non-NULL cell.
+    /// @return false if the value isn't a number.
+    bool getApprox(unsigned int row, size_t col, double& out) const;
+
+private:
+    proto::Result const& _result;
+    unsigned int const _rowCount;
+    std::vector<proto::ColumnBlockReader> _columns;  ///< Only for column-based results.
+};
+
+}  // namespace lsst::qserv::rproc
+
+#endif  // LSST_QSERV_RPROC_RESULTCELLS_H
@@ -0,0 +1,304 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "rproc/TopKMerger.h"
+
+// System headers
+#include <algorithm>
+#include <cmath>
+
+// Third-party headers
+#include "boost/algorithm/string/predicate.hpp"
+#include <mysql/mysql.h>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "query/ColumnRef.h"
+#include "query/OrderByClause.h"
+#include "query/SelectList.h"
+#include "query/SelectStmt.h"
+#include "query/ValueExpr.h"
+#include "sql/Schema.h"
+
+using namespace std;
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.rproc.TopKMerger");
+
+/// @return true if 'text' can be used as a numeric literal in SQL as it is.
+bool isNumericLiteral(string const& text) {
+    if (text.empty()) return false;
+    return all_of(text.begin(), text.end(), [](char c) {
+        return (c >= '0' && c <= '9') || c == '.' || c == '-' || c == '+' || c == 'e' || c == 'E';
+    });
+}
+
+}  // namespace
+
+namespace lsst::qserv::rproc {
+
+TopKMerger::Ptr TopKMerger::create(query::SelectStmt const& mergeStmt, sql::Schema const& schema,
+                                   size_t maxLimit) {
+    string const stmtStr = mergeStmt.getQueryTemplate().sqlFragment();
+    if (!mergeStmt.hasOrderBy() || !mergeStmt.hasLimit() || mergeStmt.getLimit() <= 0 ||
+        mergeStmt.hasWhereClause() || mergeStmt.hasGroupBy() || mergeStmt.hasHaving() ||
+        mergeStmt.getDistinct()) {
+        LOGS(_log, LOG_LVL_DEBUG, "merge statement isn't a plain ORDER BY ... LIMIT: " << stmtStr);
+        return nullptr;
+    }
+    size_t const limit = mergeStmt.getLimit();
+    if (limit > maxLimit) {
+        LOGS(_log, LOG_LVL_DEBUG, "LIMIT is over " << maxLimit << " rows: " << stmtStr);
+        return nullptr;
+    }
+    // Aggregates combine rows, which must then all reach the merge table.
+    for (auto const& expr : *mergeStmt.getSelectList().getValueExprList()) {
+        if (expr == nullptr || expr->hasAggregation()) {
+            LOGS(_log, LOG_LVL_DEBUG, "merge statement aggregates rows: " << stmtStr);
+            return nullptr;
+        }
+    }
+
+    vector<SortColumn> sortColumns;
+    for (auto const& term : *mergeStmt.getOrderBy().getTerms()) {
+        auto const columnRef = (term.getExpr() == nullptr) ? nullptr : term.getExpr()->getColumnRef();
+        if (columnRef == nullptr) {
+            LOGS(_log, LOG_LVL_DEBUG, "ORDER BY term isn't a column: " << stmtStr);
+            return nullptr;
+        }
+        auto const iter = find_if(schema.columns.begin(), schema.columns.end(), [&](auto const& colSchema) {
+            return boost::algorithm::iequals(colSchema.name, columnRef->getColumn());
+        });
+        if (iter == schema.columns.end()) {
+            LOGS(_log, LOG_LVL_DEBUG,
+                 "ORDER BY column " << columnRef->getColumn() << " not found in " << schema << ": "
+                                    << stmtStr);
+            return nullptr;
+        }
+        SortColumn col;
+        col.column = iter - schema.columns.begin();
+        col.descending = term.getOrder() == query::OrderByTerm::DESC;
+        col.num = NumericType::fromColType(iter->colType);
+        col.exactText = iter->colType.mysqlType != MYSQL_TYPE_FLOAT;
+        if (col.num.kind == NumericType::NONE) {
+            LOGS(_log, LOG_LVL_DEBUG, "ORDER BY column " << *iter << " isn't numeric: " << stmtStr);
+            return nullptr;
+        }
+        sortColumns.push_back(col);
+    }
+    LOGS(_log, LOG_LVL_DEBUG, "keeping the first " << limit << " rows in memory for " << stmtStr);
+    return make_shared<TopKMerger>(sortColumns, schema.columns.size(), limit);
+}
+
+TopKMerger::TopKMerger(vector<SortColumn> const& sortColumns, size_t columnCount, size_t limit)
+        : _sortColumns(sortColumns), _columnCount(columnCount), _limit(limit) {}
+
+bool TopKMerger::add(proto::Result const& result, int jobIdAttempt) {
+    ResultCells const cells(result);
+    unsigned int const rowCount = cells.getRowCount();
+    // Rows that don't sort before the last of K completed rows can't be in the result.
+    vector<Value> completedLast;
+    {
+        lock_guard<mutex> lock(_mtx);
+        if (_completed.size() >= _limit) completedLast = _completed.front().key;
+    }
+
+    Heap heap;
+    vector<Value> key;
+    for (unsigned int row = 0; row < rowCount; ++row) {
+        if (cells.getColumnCount(row) != _columnCount || !_parseKey(cells, row, key)) {
+            LOGS(_log, LOG_LVL_DEBUG, "jobIdAttempt=" << jobIdAttempt << " values can't be sorted in memory");
+            return false;
+        }
+        if (!completedLast.empty() && !_before(key, completedLast)) continue;
+        if (heap.size() >= _limit && !_before(key, heap.front().key)) continue;
+        Row r;
+        r.key = key;
+        r.cells.resize(_columnCount);
+        r.nulls.resize(_columnCount);
+        for (size_t col = 0; col < _columnCount; ++col) {
+            r.nulls[col] = cells.isNull(row, col);
+            if (!r.nulls[col]) cells.getText(row, col, r.cells[col]);
+        }
+        _push(heap, std::move(r));
+    }
+
+    lock_guard<mutex> lock(_mtx);
+    Attempt& attempt = _attempts[jobIdAttempt];
+    attempt.jobId = result.jobid();
+    for (auto& row : heap) {
+        _push(attempt.heap, std::move(row));
+    }
+    _rowsIn += rowCount;
+    return true;
+}
+
+bool TopKMerger::_parseKey(ResultCells const& cells, unsigned int row, vector<Value>& key) const {
+    key.resize(_sortColumns.size());
+    for (size_t i = 0; i < _sortColumns.size(); ++i) {
+        SortColumn const& col = _sortColumns[i];
+        Value& v = key[i];
+        v.isNull = cells.isNull(row, col.column);
+        if (v.isNull) continue;
+        bool const ok = (col.num.kind == NumericType::EXACT)
+                                ? cells.getExact(row, col.column, col.num.scale, v.exact)
+                                : cells.getApprox(row, col.column, v.approx) && !isnan(v.approx);
+        if (!ok) return false;
+    }
+    return true;
+}
+
+bool TopKMerger::_before(vector<Value> const& a, vector<Value> const& b) const {
+    for (size_t i = 0; i < _sortColumns.size(); ++i) {
+        SortColumn const& col = _sortColumns[i];
+        Value const& x = a[i];
+        Value const& y = b[i];
+        int cmp = 0;
+        if (x.isNull != y.isNull) {
+            cmp = x.isNull ? -1 : 1;
+        } else if (!x.isNull) {
+            if (col.num.kind == NumericType::EXACT) {
+                cmp = (x.exact < y.exact) ? -1 : (x.exact > y.exact) ? 1 : 0;
+            } else {
+                cmp = (x.approx < y.approx) ? -1 : (x.approx > y.approx) ? 1 : 0;
+            }
+        }
+        if (cmp != 0) return col.descending ? cmp > 0 : cmp < 0;
+    }
+    return false;
+}
+
+void TopKMerger::_push(Heap& heap, Row&& row) const {
+    auto const sortsBefore = [this](Row const& a, Row const& b) { return _before(a.key, b.key); };
+    if (heap.size() >= _limit) {
+        if (!_before(row.key, heap.front().key)) return;
+        pop_heap(heap.begin(), heap.end(), sortsBefore);
+        heap.back() = std::move(row);
+    } else {
+        heap.push_back(std::move(row));
+    }
+    push_heap(heap.begin(), heap.end(), sortsBefore);
+}
+
+void TopKMerger::mergeCompleteFor(set<int> const& jobIds, IsInvalidFunc const& isInvalid) {
+    lock_guard<mutex> lock(_mtx);
+    for (auto iter = _attempts.begin(); iter != _attempts.end();) {
+        if (jobIds.count(iter->second.jobId) == 0) {
+            ++iter;
+            continue;
+        }
+        if (isInvalid(iter->first)) {
+            LOGS(_log, LOG_LVL_DEBUG, "dropping rows of invalid jobIdAttempt=" << iter->first);
+        } else {
+            _complete(iter->first, iter->second);
+        }
+        iter = _attempts.erase(iter);
+    }
+}
+
+void TopKMerger::_complete(int jobIdAttempt, Attempt& attempt) {
+    for (auto& row : attempt.heap) {
+        _push(_completed, std::move(row));
+    }
+    attempt.heap.clear();
+    _completedAttempts.insert(jobIdAttempt);
+
+    SortColumn const& first = _sortColumns.front();
+    if (_completed.size() < _limit || !first.exactText) return;
+    Row const& last = _completed.front();
+    string const& text = last.cells[first.column];
+    if (!last.nulls[first.column] && isNumericLiteral(text) && text != _bound) {
+        _bound = text;
+        LOGS(_log, LOG_LVL_DEBUG, "first sort column bound is now " << _bound);
+    }
+}
+
+bool TopKMerger::finish(IsInvalidFunc const& isInvalid, LoadFunc const& loadRows) {
+    lock_guard<mutex> lock(_mtx);
+    for (auto& [jobIdAttempt, attempt] : _attempts) {
+        if (!isInvalid(jobIdAttempt)) _complete(jobIdAttempt, attempt);
+    }
+    _attempts.clear();
+    for (int jobIdAttempt : _completedAttempts) {
+        if (isInvalid(jobIdAttempt)) {
+            _error = "rows of jobIdAttempt=" + to_string(jobIdAttempt) +
+                     " were combined before it became invalid";
+            LOGS(_log, LOG_LVL_ERROR, "TopKMerger " << _error);
+            return false;
+        }
+    }
+    LOGS(_log, LOG_LVL_DEBUG, "kept " << _completed.size() << " of " << _rowsIn << " rows");
+
+    vector<proto::ColumnBlock::Encoding> const encodings(_columnCount, proto::ColumnBlock::BYTES);
+    vector<char const*> rowPtrs(_columnCount);
+    vector<unsigned long> lengths(_columnCount);
+    proto::Result result;
+    auto builder = make_unique<proto::ColumnBlockBuilder>(result, encodings);
+
+    auto loadBatch = [&]() -> bool {
+        if (builder->getRowCount() == 0) return true;
+        result.set_rowcount(builder->getRowCount());
+        bool const ok = loadRows(result);
+        result.Clear();
+        builder = make_unique<proto::ColumnBlockBuilder>(result, encodings);
+        if (!ok) _error = "failed to write kept rows";
+        return ok;
+    };
+    for (auto const& row : _completed) {
+        for (size_t col = 0; col < _columnCount; ++col) {
+            rowPtrs[col] = row.nulls[col] ? nullptr : row.cells[col].data();
+            lengths[col] = row.cells[col].size();
+        }
+        builder->addRow(rowPtrs.data(), lengths.data());
+        if (builder->getRowCount() >= ROWS_PER_RESULT && !loadBatch()) return false;
+    }
+    if (!loadBatch()) return false;
+    _completed.clear();
+    return true;
+}
+
+bool TopKMerger::getBound(string& bound) const {
+    lock_guard<mutex> lock(_mtx);
+    if (_bound.empty()) return false;
+    bound = _bound;
+    return true;
+}
+
+size_t TopKMerger::getRowsIn() const {
+    lock_guard<mutex> lock(_mtx);
+    return _rowsIn;
+}
+
+size_t TopKMerger::getRowsKept() const {
+    lock_guard<mutex> lock(_mtx);
+    size_t count = _completed.size();
+    for (auto const& [jobIdAttempt, attempt] : _attempts) {
+        count += attempt.heap.size();
+    }
+    return count;
+}
+
+}  // namespace lsst::qserv::rproc
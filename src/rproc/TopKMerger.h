@@ -0,0 +1,182 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_RPROC_TOPKMERGER_H
+#define LSST_QSERV_RPROC_TOPKMERGER_H
+
+// System headers
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+// Qserv headers
+#include "rproc/ResultCells.h"
+
+// Forward declarations
+namespace lsst::qserv {
+namespace query {
+class SelectStmt;
+}
+namespace sql {
+struct Schema;
+}
+}  // namespace lsst::qserv
+
+namespace lsst::qserv::rproc {
+
+/// TopKMerger keeps, in memory, only the rows of an ORDER BY ... LIMIT K
+/// query that can still be among the first K rows of the result, as they
+/// arrive from the workers. Every chunk returns up to K rows, so without it
+/// the merge table receives K rows per chunk to sort for K rows of result.
+///
+/// The rows it keeps are still sorted and limited by the merge statement
+/// when the query is finalized. Only merge statements without aggregates,
+/// GROUP BY, DISTINCT, or HAVING, and whose ORDER BY terms are numeric merge
+/// table columns, are supported. For everything else create() returns
+/// nullptr and the rows are written to the merge table as they are.
+///
+/// Like HashAggregator, the rows of a job attempt are kept apart until the
+/// merge for the job is complete, so that the rows of an attempt that gets
+/// scrubbed can be dropped. Once the completed jobs have provided K rows,
+/// the first sort key of the K-th row bounds the rows that jobs which have
+/// not been dispatched yet need to return, see getBound().
+class TopKMerger {
+public:
+    using Ptr = std::shared_ptr<TopKMerger>;
+
+    /// A merge table column in the ORDER BY clause.
+    struct SortColumn {
+        size_t column = 0;        ///< Position in the merge table.
+        bool descending = false;  ///< MySQL sorts NULL before all values in ascending order.
+        NumericType num;
+        /// True if the text of the values compares exactly with the column in
+        /// SQL, which isn't the case for FLOAT columns.
+        bool exactText = false;
+    };
+
+    /// @return true if the job attempt has been scrubbed.
+    using IsInvalidFunc = std::function<bool(int)>;
+    /// Writes the rows of a Result message to the merge table.
+    using LoadFunc = std::function<bool(proto::Result&)>;
+
+    /// @param mergeStmt the statement that will sort and limit the rows of the merge table.
+    /// @param schema the columns of the worker results, not including the jobId column.
+    /// @param maxLimit the largest LIMIT to keep in memory.
+    /// @return a TopKMerger for the results, or nullptr if mergeStmt isn't supported.
+    static Ptr create(query::SelectStmt const& mergeStmt, sql::Schema const& schema, size_t maxLimit);
+
+    TopKMerger(std::vector<SortColumn> const& sortColumns, size_t columnCount, size_t limit);
+    TopKMerger() = delete;
+    TopKMerger(TopKMerger const&) = delete;
+    TopKMerger& operator=(TopKMerger const&) = delete;
+
+    /// Keep the rows of 'result' from job attempt 'jobIdAttempt' that may be
+    /// in the result.
+    /// @return false if the rows were not taken, in which case they must be
+    ///         written to the merge table.
+    /// @throws proto::ColumnarResultError if the column blocks of 'result' are inconsistent.
+    bool add(proto::Result const& result, int jobIdAttempt);
+
+    /// Combine the rows of the valid attempts of 'jobIds' with the rows of
+    /// the other completed jobs, and drop the rows of scrubbed attempts.
+    void mergeCompleteFor(std::set<int> const& jobIds, IsInvalidFunc const& isInvalid);
+
+    /// Complete the outstanding jobs and pass the rows kept to 'loadRows'
+    /// in Result messages of up to ROWS_PER_RESULT rows.
+    /// @return false if the rows could not be written, or if an attempt was
+    ///         scrubbed after its rows were combined. getError() has details.
+    bool finish(IsInvalidFunc const& isInvalid, LoadFunc const& loadRows);
+
+    /// Set 'bound' to the text of the first sort column of the K-th row of
+    /// the completed jobs. Rows that sort after it can't be in the result.
+    /// @return false if there is no such bound yet, because fewer than K rows
+    ///         are complete, the value is NULL, or the column isn't exactText.
+    bool getBound(std::string& bound) const;
+
+    /// @return the number of worker rows passed to add().
+    size_t getRowsIn() const;
+    /// @return the number of rows kept.
+    size_t getRowsKept() const;
+
+    std::string const& getError() const { return _error; }
+
+    static constexpr unsigned int ROWS_PER_RESULT = 10000;
+
+private:
+    /// The value of a sort column.
+    struct Value {
+        bool isNull = true;
+        union {
+            int64_t exact = 0;
+            double approx;
+        };
+    };
+
+    struct Row {
+        std::vector<Value> key;  ///< One value per sort column.
+        std::vector<std::string> cells;
+        std::vector<bool> nulls;
+    };
+
+    /// Up to K rows, kept as a heap with the row that sorts last on top.
+    using Heap = std::vector<Row>;
+
+    /// The rows of a job attempt that is not complete yet.
+    struct Attempt {
+        int jobId = 0;
+        Heap heap;
+    };
+
+    /// @return true if 'a' sorts before 'b'.
+    bool _before(std::vector<Value> const& a, std::vector<Value> const& b) const;
+
+    /// Add 'row' to 'heap' if it sorts before the last row of a full heap.
+    void _push(Heap& heap, Row&& row) const;
+
+    /// Read the sort key of 'row' of 'cells'.
+    /// @return false if a value can't be held exactly.
+    bool _parseKey(ResultCells const& cells, unsigned int row, std::vector<Value>& key) const;
+
+    /// Move the rows of 'attempt' into _completed.
+    /// Precondition: must hold _mtx.
+    void _complete(int jobIdAttempt, Attempt& attempt);
+
+    std::vector<SortColumn> const _sortColumns;
+    size_t const _columnCount;
+    size_t const _limit;
+
+    mutable std::mutex _mtx;  ///< Protects all members below.
+    std::map<int, Attempt> _attempts;  ///< Attempts that are not complete, by jobIdAttempt.
+    Heap _completed;                   ///< Rows of the valid attempts of completed jobs.
+    std::set<int> _completedAttempts;  ///< Attempts that have been combined into _completed.
+    std::string _bound;                ///< See getBound(), empty if there is none.
+    size_t _rowsIn = 0;
+    std::string _error;
+};
+
+}  // namespace lsst::qserv::rproc
+
+#endif  // LSST_QSERV_RPROC_TOPKMERGER_H
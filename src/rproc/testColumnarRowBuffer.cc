@@ -0,0 +1,137 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "rproc/ColumnarRowBuffer.h"
+
+// System headers
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Qserv headers
+#include "proto/ColumnarResult.h"
+#include "proto/worker.pb.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE ColumnarRowBuffer_1
+#include <boost/test/unit_test.hpp>
+
+namespace test = boost::test_tools;
+
+using lsst::qserv::proto::ColumnarResultError;
+using lsst::qserv::proto::ColumnBlock;
+using lsst::qserv::proto::ColumnBlockBuilder;
+using lsst::qserv::proto::ColumnBlockReader;
+using lsst::qserv::proto::Result;
+using lsst::qserv::rproc::ColumnarRowBuffer;
+
+namespace {
+
+/// Add a row given as strings, nullptr being NULL.
+void addRow(ColumnBlockBuilder& builder, std::vector<char const*> const& row) {
+    std::vector<unsigned long> lengths;
+    for (auto val : row) {
+        lengths.push_back(val == nullptr ? 0 : std::strlen(val));
+    }
+    builder.addRow(row.data(), lengths.data());
+}
+
+/// @return everything fetched from 'rowBuffer', using a buffer of 'bufLen' bytes.
+std::string fetchAll(ColumnarRowBuffer& rowBuffer, unsigned int bufLen) {
+    std::string out;
+    std::vector<char> buf(bufLen);
+    while (unsigned int sz = rowBuffer.fetch(buf.data(), bufLen)) {
+        out.append(buf.data(), sz);
+    }
+    return out;
+}
+
+}  // namespace
+
+struct Fixture {
+    Fixture(void) {
+        ColumnBlockBuilder builder(result, {ColumnBlock::INT64, ColumnBlock::DOUBLE, ColumnBlock::BYTES});
+        addRow(builder, {"42", "0.1", "a\tb"});
+        addRow(builder, {"-7", nullptr, "x\ny"});
+        addRow(builder, {nullptr, "1e+300", nullptr});
+        result.set_rowcount(builder.getRowCount());
+    }
+    ~Fixture(void) {}
+
+    Result result;
+    std::string const expected =
+            "'3'\t42\t0.1\t'a\\tb'\n"
+            "'3'\t-7\t\\N\t'x\\ny'\n"
+            "'3'\t\\N\t1e+300\t\\N";
+};
+
+BOOST_FIXTURE_TEST_SUITE(suite, Fixture)
+
+BOOST_AUTO_TEST_CASE(TestFetch) {
+    BOOST_CHECK_EQUAL(result.columnblock_size(), 3);
+    BOOST_CHECK_EQUAL(result.row_size(), 0);
+    ColumnarRowBuffer rowBuffer(result, 3);
+    BOOST_CHECK_EQUAL(fetchAll(rowBuffer, 1000), expected);
+}
+
+BOOST_AUTO_TEST_CASE(TestFetchSmallBuffer) {
+    // Rows must be split correctly across fetch() calls.
+    for (unsigned int bufLen = 1; bufLen < 8; ++bufLen) {
+        ColumnarRowBuffer rowBuffer(result, 3);
+        BOOST_CHECK_EQUAL(fetchAll(rowBuffer, bufLen), expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(TestConvertToBytes) {
+    Result res;
+    ColumnBlockBuilder builder(res, {ColumnBlock::INT64});
+    addRow(builder, {"1"});
+    addRow(builder, {nullptr});
+    addRow(builder, {"0x10"});
+    res.set_rowcount(builder.getRowCount());
+    BOOST_CHECK_EQUAL(res.columnblock(0).encoding(), ColumnBlock::BYTES);
+    ColumnarRowBuffer rowBuffer(res, 1);
+    BOOST_CHECK_EQUAL(fetchAll(rowBuffer, 100), "'1'\t'1'\n'1'\t\\N\n'1'\t'0x10'");
+}
+
+BOOST_AUTO_TEST_CASE(TestRoundTrip) {
+    Result res;
+    ColumnBlockBuilder builder(res, {ColumnBlock::DOUBLE, ColumnBlock::UINT64});
+    addRow(builder, {"0.30000000000000004", "18446744073709551615"});
+    res.set_rowcount(builder.getRowCount());
+    ColumnBlockReader reader(res.columnblock(0), 1);
+    BOOST_CHECK_EQUAL(reader.getDouble(0), 0.1 + 0.2);
+    ColumnarRowBuffer rowBuffer(res, 1);
+    BOOST_CHECK_EQUAL(fetchAll(rowBuffer, 100), "'1'\t0.30000000000000004\t18446744073709551615");
+}
+
+BOOST_AUTO_TEST_CASE(TestBadBlock) {
+    // rowcount not matching the blocks must be detected before reading.
+    result.set_rowcount(4);
+    BOOST_CHECK_THROW(ColumnarRowBuffer(result, 3), ColumnarResultError);
+    result.set_rowcount(3);
+    result.mutable_columnblock(2)->mutable_offsets()->resize(4);
+    BOOST_CHECK_THROW(ColumnarRowBuffer(result, 3), ColumnarResultError);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,261 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "rproc/HashAggregator.h"
+
+// System headers
+#include <cstring>
+#include <limits>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// Third-party headers
+#include <mysql/mysql.h>
+
+// Qserv headers
+#include "ccontrol/ParseRunner.h"
+#include "proto/ColumnarResult.h"
+#include "proto/worker.pb.h"
+#include "query/SelectStmt.h"
+#include "sql/Schema.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE HashAggregator_1
+#include <boost/test/unit_test.hpp>
+
+namespace test = boost::test_tools;
+
+using lsst::qserv::ccontrol::ParseRunner;
+using lsst::qserv::proto::ColumnBlock;
+using lsst::qserv::proto::ColumnBlockBuilder;
+using lsst::qserv::proto::ColumnBlockReader;
+using lsst::qserv::proto::Result;
+using lsst::qserv::rproc::HashAggregator;
+using lsst::qserv::rproc::NumericType;
+
+namespace {
+
+using Row = std::vector<char const*>;
+/// Reduced rows by their first column, NULL values as "NULL".
+using Rows = std::multimap<std::string, std::vector<std::string>>;
+
+/// @return a row-based Result of job 'jobId' with 'rows', nullptr being NULL.
+Result makeRowResult(int jobId, std::vector<Row> const& rows) {
+    Result result;
+    result.set_jobid(jobId);
+    for (auto const& row : rows) {
+        auto rowBundle = result.add_row();
+        for (auto val : row) {
+            rowBundle->add_column(val == nullptr ? "" : val);
+            rowBundle->add_isnull(val == nullptr);
+        }
+    }
+    result.set_rowcount(rows.size());
+    return result;
+}
+
+/// @return a column-based Result of job 'jobId' with 'rows', nullptr being NULL.
+Result makeColumnResult(int jobId, std::vector<ColumnBlock::Encoding> const& encodings,
+                        std::vector<Row> const& rows) {
+    Result result;
+    result.set_jobid(jobId);
+    ColumnBlockBuilder builder(result, encodings);
+    for (auto const& row : rows) {
+        std::vector<unsigned long> lengths;
+        for (auto val : row) {
+            lengths.push_back(val == nullptr ? 0 : std::strlen(val));
+        }
+        builder.addRow(row.data(), lengths.data());
+    }
+    result.set_rowcount(builder.getRowCount());
+    return result;
+}
+
+bool noneInvalid(int) { return false; }
+
+/// @return true and the reduced rows of 'aggregator' in 'rows' if finish() succeeds.
+bool finish(HashAggregator& aggregator, Rows& rows,
+            HashAggregator::IsInvalidFunc const& isInvalid = noneInvalid) {
+    return aggregator.finish(isInvalid, [&rows](Result& result) {
+        std::vector<ColumnBlockReader> readers;
+        for (auto const& block : result.columnblock()) {
+            readers.emplace_back(block, result.rowcount());
+        }
+        for (unsigned int row = 0; row < result.rowcount(); ++row) {
+            std::vector<std::string> vals;
+            for (auto const& reader : readers) {
+                vals.push_back(reader.isNull(row) ? "NULL" : std::string(reader.getBytes(row)));
+            }
+            rows.emplace(vals[0], vals);
+        }
+        return true;
+    });
+}
+
+HashAggregator::Column column(HashAggregator::Op op, NumericType::Kind kind, int scale = 0) {
+    HashAggregator::Column col;
+    col.op = op;
+    col.num.kind = kind;
+    col.num.scale = scale;
+    return col;
+}
+
+/// Columns of "SELECT key, SUM(count), MIN(x), MAX(x)".
+std::vector<HashAggregator::Column> const keySumMinMax = {
+        HashAggregator::Column(), column(HashAggregator::SUM, NumericType::EXACT),
+        column(HashAggregator::MIN, NumericType::APPROX), column(HashAggregator::MAX, NumericType::APPROX)};
+
+lsst::qserv::sql::ColSchema colSchema(std::string const& name, int mysqlType, std::string const& sqlType) {
+    lsst::qserv::sql::ColSchema col;
+    col.name = name;
+    col.colType.mysqlType = mysqlType;
+    col.colType.sqlType = sqlType;
+    return col;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(ReduceRows) {
+    HashAggregator aggregator(keySumMinMax, 100);
+    BOOST_CHECK(aggregator.add(makeRowResult(1, {{"g", "3", "1.5", "1.5"}, {"r", "1", "7", "7"}}), 10));
+    BOOST_CHECK(aggregator.add(makeColumnResult(2,
+                                                {ColumnBlock::BYTES, ColumnBlock::INT64, ColumnBlock::DOUBLE,
+                                                 ColumnBlock::DOUBLE},
+                                                {{"g", "4", "-2", "0.25"}, {"g", "5", nullptr, "9"}}),
+                               20));
+    BOOST_CHECK_EQUAL(aggregator.getRowsIn(), 4u);
+    aggregator.mergeCompleteFor({1, 2}, noneInvalid);
+    BOOST_CHECK_EQUAL(aggregator.getGroupCount(), 2u);
+
+    Rows rows;
+    BOOST_REQUIRE(finish(aggregator, rows));
+    BOOST_REQUIRE_EQUAL(rows.size(), 2u);
+    std::vector<std::string> const g = {"g", "12", "-2", "9"};
+    std::vector<std::string> const r = {"r", "1", "7", "7"};
+    BOOST_CHECK(rows.find("g")->second == g);
+    BOOST_CHECK(rows.find("r")->second == r);
+}
+
+BOOST_AUTO_TEST_CASE(NullsAndDecimals) {
+    std::vector<HashAggregator::Column> const columns = {
+            HashAggregator::Column(), column(HashAggregator::SUM, NumericType::EXACT, 2)};
+    HashAggregator aggregator(columns, 100);
+    BOOST_CHECK(aggregator.add(makeRowResult(1, {{nullptr, "1.25"}, {"", "-0.5"}, {nullptr, nullptr}}), 10));
+    BOOST_CHECK(aggregator.add(makeRowResult(2, {{nullptr, "-2"}, {"", nullptr}, {"x", nullptr}}), 20));
+    // More decimals than the column has can't be held exactly.
+    BOOST_CHECK(!aggregator.add(makeRowResult(3, {{"", "0.125"}}), 30));
+
+    Rows rows;
+    BOOST_REQUIRE(finish(aggregator, rows));
+    BOOST_REQUIRE_EQUAL(rows.size(), 3u);
+    // NULL and empty keys are different groups.
+    BOOST_CHECK_EQUAL(rows.find("NULL")->second[1], "-0.75");
+    BOOST_CHECK_EQUAL(rows.find("")->second[1], "-0.50");
+    BOOST_CHECK_EQUAL(rows.find("x")->second[1], "NULL");
+}
+
+BOOST_AUTO_TEST_CASE(SumOverflowSplitsGroup) {
+    std::vector<HashAggregator::Column> const columns = {HashAggregator::Column(),
+                                                         column(HashAggregator::SUM, NumericType::EXACT)};
+    HashAggregator aggregator(columns, 100);
+    std::string const big = std::to_string(std::numeric_limits<int64_t>::max() - 1);
+    BOOST_CHECK(aggregator.add(makeRowResult(1, {{"a", big.c_str()}, {"a", "1"}, {"a", "5"}}), 10));
+
+    Rows rows;
+    BOOST_REQUIRE(finish(aggregator, rows));
+    // The merge statement adds up the two parts.
+    BOOST_REQUIRE_EQUAL(rows.count("a"), 2u);
+    std::multiset<std::string> sums;
+    for (auto const& [key, vals] : rows) sums.insert(vals[1]);
+    std::string const max = std::to_string(std::numeric_limits<int64_t>::max());
+    BOOST_CHECK(sums == (std::multiset<std::string>{max, "5"}));
+}
+
+BOOST_AUTO_TEST_CASE(InvalidAttempts) {
+    HashAggregator aggregator(keySumMinMax, 100);
+    std::set<int> invalid = {11};
+    auto isInvalid = [&invalid](int jobIdAttempt) { return invalid.count(jobIdAttempt) > 0; };
+    BOOST_CHECK(aggregator.add(makeRowResult(1, {{"g", "3", "1", "1"}}), 11));
+    BOOST_CHECK(aggregator.add(makeRowResult(1, {{"g", "4", "2", "2"}}), 12));
+    BOOST_CHECK(aggregator.add(makeRowResult(2, {{"g", "5", "3", "3"}}), 20));
+    // The rows of the invalid attempt are dropped when the job completes.
+    aggregator.mergeCompleteFor({1}, isInvalid);
+
+    Rows rows;
+    BOOST_REQUIRE(finish(aggregator, rows, isInvalid));
+    std::vector<std::string> const g = {"g", "9", "2", "3"};
+    BOOST_CHECK(rows.find("g")->second == g);
+
+    // An attempt becoming invalid after its rows were combined can't be undone.
+    HashAggregator late(keySumMinMax, 100);
+    BOOST_CHECK(late.add(makeRowResult(1, {{"g", "3", "1", "1"}}), 12));
+    late.mergeCompleteFor({1}, isInvalid);
+    invalid.insert(12);
+    Rows lateRows;
+    BOOST_CHECK(!finish(late, lateRows, isInvalid));
+    BOOST_CHECK(!late.getError().empty());
+}
+
+BOOST_AUTO_TEST_CASE(GroupLimit) {
+    HashAggregator aggregator(keySumMinMax, 2);
+    BOOST_CHECK(aggregator.add(makeRowResult(1, {{"a", "1", "1", "1"}, {"b", "1", "1", "1"}}), 10));
+    BOOST_CHECK(aggregator.isFull());
+    // Further results go to the merge table, the groups held are still written.
+    BOOST_CHECK(!aggregator.add(makeRowResult(2, {{"a", "1", "1", "1"}}), 20));
+    Rows rows;
+    BOOST_REQUIRE(finish(aggregator, rows));
+    BOOST_CHECK_EQUAL(rows.size(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(Create) {
+    lsst::qserv::sql::Schema schema;
+    schema.columns.push_back(colSchema("filterId", MYSQL_TYPE_LONG, "INT"));
+    schema.columns.push_back(colSchema("QS1_COUNT", MYSQL_TYPE_LONGLONG, "BIGINT"));
+    schema.columns.push_back(colSchema("QS2_SUM", MYSQL_TYPE_NEWDECIMAL, "DECIMAL(20,3)"));
+    schema.columns.push_back(colSchema("QS3_MAX", MYSQL_TYPE_DOUBLE, "DOUBLE"));
+    auto create = [&schema](std::string const& stmt) {
+        return HashAggregator::create(*ParseRunner::makeSelectStmt(stmt), schema, 100);
+    };
+    BOOST_CHECK(create("SELECT filterId, SUM(QS1_COUNT), SUM(QS2_SUM), MAX(QS3_MAX) FROM m "
+                       "GROUP BY filterId ORDER BY filterId LIMIT 5") != nullptr);
+    BOOST_CHECK(create("SELECT SUM(QS2_SUM)/SUM(QS1_COUNT) AS a, MAX(QS3_MAX) FROM m") != nullptr);
+    BOOST_CHECK(create("SELECT DISTINCT filterId FROM m") != nullptr);
+    // Rows must all be kept.
+    BOOST_CHECK(create("SELECT filterId FROM m ORDER BY filterId LIMIT 5") == nullptr);
+    // HAVING may count the rows of the merge table.
+    BOOST_CHECK(create("SELECT filterId, SUM(QS1_COUNT) FROM m GROUP BY filterId HAVING COUNT(*) > 1") ==
+                nullptr);
+    // An aggregated column used in another way.
+    BOOST_CHECK(create("SELECT SUM(QS1_COUNT), QS1_COUNT FROM m") == nullptr);
+    BOOST_CHECK(create("SELECT SUM(QS3_MAX), MAX(QS3_MAX) FROM m") == nullptr);
+    BOOST_CHECK(create("SELECT AVG(QS3_MAX) FROM m") == nullptr);
+    // Only numeric columns are reduced.
+    schema.columns.push_back(colSchema("name", MYSQL_TYPE_VAR_STRING, "VARCHAR(10)"));
+    BOOST_CHECK(create("SELECT MAX(name) FROM m") == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
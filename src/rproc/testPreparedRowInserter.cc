@@ -0,0 +1,193 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "rproc/PreparedRowInserter.h"
+
+// System headers
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Qserv headers
+#include "proto/ColumnarResult.h"
+#include "proto/worker.pb.h"
+#include "rproc/ColumnarRowBuffer.h"
+#include "rproc/ProtoRowBuffer.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE PreparedRowInserter_1
+#include <boost/test/unit_test.hpp>
+
+namespace test = boost::test_tools;
+
+using lsst::qserv::proto::ColumnBlock;
+using lsst::qserv::proto::ColumnBlockBuilder;
+using lsst::qserv::proto::Result;
+using lsst::qserv::rproc::ColumnarRowBuffer;
+using lsst::qserv::rproc::PreparedRowInserter;
+using lsst::qserv::rproc::ProtoRowBuffer;
+
+namespace {
+
+void addRow(ColumnBlockBuilder& builder, std::vector<char const*> const& row) {
+    std::vector<unsigned long> lengths;
+    for (auto val : row) {
+        lengths.push_back(val == nullptr ? 0 : std::strlen(val));
+    }
+    builder.addRow(row.data(), lengths.data());
+}
+
+std::string bindStr(MYSQL_BIND const& bind) {
+    return std::string(static_cast<char const*>(bind.buffer), bind.buffer_length);
+}
+
+/// Build a result with 'rows' wide rows of 'doubles' DOUBLE and 'blobs' BYTES columns,
+/// in column blocks if 'columnar' is true.
+void makeWideResult(Result& result, unsigned int rows, int doubles, int blobs, bool columnar) {
+    std::string const blob(200, 'x');
+    std::vector<std::string> vals;
+    for (int j = 0; j < doubles; ++j) vals.push_back(std::to_string(1.0 / (j + 3)));
+    for (int j = 0; j < blobs; ++j) vals.push_back(blob);
+    std::vector<char const*> row;
+    std::vector<unsigned long> lengths;
+    for (auto const& val : vals) {
+        row.push_back(val.data());
+        lengths.push_back(val.size());
+    }
+    if (columnar) {
+        std::vector<ColumnBlock::Encoding> encodings(doubles, ColumnBlock::DOUBLE);
+        encodings.resize(doubles + blobs, ColumnBlock::BYTES);
+        ColumnBlockBuilder builder(result, encodings);
+        for (unsigned int j = 0; j < rows; ++j) builder.addRow(row.data(), lengths.data());
+        result.set_rowcount(rows);
+        return;
+    }
+    for (unsigned int j = 0; j < rows; ++j) {
+        auto rowBundle = result.add_row();
+        for (auto const& val : vals) {
+            rowBundle->add_column(val);
+            rowBundle->add_isnull(false);
+        }
+    }
+    result.set_rowcount(rows);
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(suite)
+
+BOOST_AUTO_TEST_CASE(BindColumnar) {
+    Result result;
+    ColumnBlockBuilder builder(result, {ColumnBlock::INT64, ColumnBlock::DOUBLE, ColumnBlock::BYTES});
+    addRow(builder, {"42", "0.5", "a\tb"});
+    addRow(builder, {nullptr, "-2", "x"});
+    result.set_rowcount(builder.getRowCount());
+
+    PreparedRowInserter inserter("r_1", result, 7);
+    BOOST_CHECK_EQUAL(inserter.getValuesPerRow(), 4U);
+    std::vector<MYSQL_BIND> binds;
+    inserter.bindRows(0, 2, binds);
+    BOOST_REQUIRE_EQUAL(binds.size(), 8U);
+    BOOST_CHECK_EQUAL(binds[0].buffer_type, MYSQL_TYPE_LONG);
+    BOOST_CHECK_EQUAL(*static_cast<int*>(binds[0].buffer), 7);
+    BOOST_CHECK_EQUAL(binds[1].buffer_type, MYSQL_TYPE_LONGLONG);
+    BOOST_CHECK_EQUAL(*static_cast<int64_t*>(binds[1].buffer), 42);
+    BOOST_CHECK_EQUAL(binds[2].buffer_type, MYSQL_TYPE_DOUBLE);
+    BOOST_CHECK_EQUAL(*static_cast<double*>(binds[2].buffer), 0.5);
+    BOOST_CHECK_EQUAL(binds[3].buffer_type, MYSQL_TYPE_STRING);
+    BOOST_CHECK_EQUAL(bindStr(binds[3]), "a\tb");  // No escaping.
+    BOOST_CHECK_EQUAL(binds[5].buffer_type, MYSQL_TYPE_NULL);
+    BOOST_CHECK_EQUAL(*static_cast<double*>(binds[6].buffer), -2.0);
+    BOOST_CHECK_EQUAL(bindStr(binds[7]), "x");
+}
+
+BOOST_AUTO_TEST_CASE(BindRows) {
+    Result result;
+    auto row = result.add_row();
+    row->add_column("1.5");
+    row->add_isnull(false);
+    row->add_column("");
+    row->add_isnull(true);
+    PreparedRowInserter inserter("r_1", result, 3);
+    std::vector<MYSQL_BIND> binds;
+    inserter.bindRows(0, 1, binds);
+    BOOST_REQUIRE_EQUAL(binds.size(), 3U);
+    BOOST_CHECK_EQUAL(binds[1].buffer_type, MYSQL_TYPE_STRING);
+    BOOST_CHECK_EQUAL(bindStr(binds[1]), "1.5");
+    BOOST_CHECK_EQUAL(binds[2].buffer_type, MYSQL_TYPE_NULL);
+}
+
+BOOST_AUTO_TEST_CASE(BatchSize) {
+    // Small rows are limited by MAX_BATCH_ROWS, wide rows by MAX_BATCH_BYTES.
+    Result narrow;
+    makeWideResult(narrow, 10, 1, 0, true);
+    BOOST_CHECK_EQUAL(PreparedRowInserter("r", narrow, 1).getBatchRows(),
+                      PreparedRowInserter::MAX_BATCH_ROWS);
+    Result wide;
+    makeWideResult(wide, 10, 0, 100, true);
+    unsigned int const wideRows = PreparedRowInserter("r", wide, 1).getBatchRows();
+    BOOST_CHECK_LT(wideRows, PreparedRowInserter::MAX_BATCH_ROWS);
+    BOOST_CHECK_GT(wideRows, 0U);
+}
+
+/// Compare the czar CPU time needed to turn results into LOAD DATA text with
+/// the time needed to bind them for prepared INSERTs, on wide rows with BLOB
+/// and double columns. The time spent in the server is not included. Disabled
+/// by default, run it with:
+///   testPreparedRowInserter --run_test=suite/MergeBenchmark
+BOOST_AUTO_TEST_CASE(MergeBenchmark, *boost::unit_test::disabled()) {
+    unsigned int const rows = 20000;
+    for (bool columnar : {false, true}) {
+        Result result;
+        makeWideResult(result, rows, 30, 5, columnar);
+        double const mb = result.ByteSizeLong() / 1e6;
+        std::vector<char> buf(1024 * 1024);
+
+        auto start = std::chrono::steady_clock::now();
+        std::shared_ptr<lsst::qserv::mysql::RowBuffer> rowBuffer;
+        if (columnar) {
+            rowBuffer = std::make_shared<ColumnarRowBuffer>(result, 1);
+        } else {
+            rowBuffer = std::make_shared<ProtoRowBuffer>(result, 1, "jobId", "INT(9)", MYSQL_TYPE_LONG);
+        }
+        size_t textBytes = 0;
+        while (unsigned int sz = rowBuffer->fetch(buf.data(), buf.size())) textBytes += sz;
+        std::chrono::duration<double> textSecs = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        PreparedRowInserter inserter("r", result, 1);
+        std::vector<MYSQL_BIND> binds;
+        for (unsigned int row = 0; row < rows; row += inserter.getBatchRows()) {
+            inserter.bindRows(row, std::min(inserter.getBatchRows(), rows - row), binds);
+        }
+        std::chrono::duration<double> bindSecs = std::chrono::steady_clock::now() - start;
+
+        std::cout << (columnar ? "columnar" : "rows    ") << " " << mb << "MB"
+                  << " infile text: " << mb / textSecs.count() << " MB/s (" << textBytes << " bytes)"
+                  << " prepared bind: " << mb / bindSecs.count() << " MB/s" << std::endl;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,234 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "rproc/TopKMerger.h"
+
+// System headers
+#include <cstring>
+#include <set>
+#include <string>
+#include <vector>
+
+// Third-party headers
+#include <mysql/mysql.h>
+
+// Qserv headers
+#include "ccontrol/ParseRunner.h"
+#include "proto/ColumnarResult.h"
+#include "proto/worker.pb.h"
+#include "query/SelectStmt.h"
+#include "sql/Schema.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE TopKMerger_1
+#include <boost/test/unit_test.hpp>
+
+namespace test = boost::test_tools;
+
+using lsst::qserv::ccontrol::ParseRunner;
+using lsst::qserv::proto::ColumnBlock;
+using lsst::qserv::proto::ColumnBlockBuilder;
+using lsst::qserv::proto::ColumnBlockReader;
+using lsst::qserv::proto::Result;
+using lsst::qserv::rproc::NumericType;
+using lsst::qserv::rproc::TopKMerger;
+
+namespace {
+
+using Row = std::vector<char const*>;
+/// The first column of the rows kept.
+using Ids = std::multiset<std::string>;
+
+/// @return a row-based Result of job 'jobId' with 'rows', nullptr being NULL.
+Result makeRowResult(int jobId, std::vector<Row> const& rows) {
+    Result result;
+    result.set_jobid(jobId);
+    for (auto const& row : rows) {
+        auto rowBundle = result.add_row();
+        for (auto val : row) {
+            rowBundle->add_column(val == nullptr ? "" : val);
+            rowBundle->add_isnull(val == nullptr);
+        }
+    }
+    result.set_rowcount(rows.size());
+    return result;
+}
+
+/// @return a column-based Result of job 'jobId' with 'rows', nullptr being NULL.
+Result makeColumnResult(int jobId, std::vector<ColumnBlock::Encoding> const& encodings,
+                        std::vector<Row> const& rows) {
+    Result result;
+    result.set_jobid(jobId);
+    ColumnBlockBuilder builder(result, encodings);
+    for (auto const& row : rows) {
+        std::vector<unsigned long> lengths;
+        for (auto val : row) {
+            lengths.push_back(val == nullptr ? 0 : std::strlen(val));
+        }
+        builder.addRow(row.data(), lengths.data());
+    }
+    result.set_rowcount(builder.getRowCount());
+    return result;
+}
+
+bool noneInvalid(int) { return false; }
+
+/// @return true and the first column of the rows kept by 'merger' in 'ids' if finish() succeeds.
+bool finish(TopKMerger& merger, Ids& ids, TopKMerger::IsInvalidFunc const& isInvalid = noneInvalid) {
+    return merger.finish(isInvalid, [&ids](Result& result) {
+        ColumnBlockReader const reader(result.columnblock(0), result.rowcount());
+        for (unsigned int row = 0; row < result.rowcount(); ++row) {
+            ids.insert(reader.isNull(row) ? "NULL" : std::string(reader.getBytes(row)));
+        }
+        return true;
+    });
+}
+
+TopKMerger::SortColumn sortColumn(size_t column, bool descending, NumericType::Kind kind, int scale = 0) {
+    TopKMerger::SortColumn col;
+    col.column = column;
+    col.descending = descending;
+    col.num.kind = kind;
+    col.num.scale = scale;
+    col.exactText = true;
+    return col;
+}
+
+/// Sort "SELECT id, mag" by mag.
+std::vector<TopKMerger::SortColumn> const byMag = {sortColumn(1, false, NumericType::APPROX)};
+
+lsst::qserv::sql::ColSchema colSchema(std::string const& name, int mysqlType, std::string const& sqlType) {
+    lsst::qserv::sql::ColSchema col;
+    col.name = name;
+    col.colType.mysqlType = mysqlType;
+    col.colType.sqlType = sqlType;
+    return col;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(KeepFirstRows) {
+    TopKMerger merger(byMag, 2, 3);
+    BOOST_CHECK(merger.add(makeRowResult(1, {{"a", "5"}, {"b", nullptr}, {"c", "2"}, {"d", "9"}}), 10));
+    BOOST_CHECK(merger.add(
+            makeColumnResult(2, {ColumnBlock::BYTES, ColumnBlock::DOUBLE}, {{"e", "1.5"}, {"f", "7"}}), 20));
+    BOOST_CHECK_EQUAL(merger.getRowsIn(), 6u);
+    merger.mergeCompleteFor({1, 2}, noneInvalid);
+    BOOST_CHECK_EQUAL(merger.getRowsKept(), 3u);
+
+    Ids ids;
+    BOOST_REQUIRE(finish(merger, ids));
+    // NULL sorts first in ascending order.
+    BOOST_CHECK(ids == (Ids{"b", "c", "e"}));
+}
+
+BOOST_AUTO_TEST_CASE(DescendingWithTies) {
+    // "SELECT id, flux ORDER BY flux DESC, id" with flux DECIMAL(10,2).
+    std::vector<TopKMerger::SortColumn> const columns = {sortColumn(1, true, NumericType::EXACT, 2),
+                                                         sortColumn(0, false, NumericType::EXACT)};
+    TopKMerger merger(columns, 2, 2);
+    BOOST_CHECK(merger.add(makeRowResult(1, {{"7", "1.50"}, {"3", "1.5"}, {"4", nullptr}}), 10));
+    BOOST_CHECK(merger.add(makeRowResult(2, {{"5", "1.50"}, {"9", "-2"}}), 20));
+    // More decimals than the column has can't be compared exactly.
+    BOOST_CHECK(!merger.add(makeRowResult(3, {{"6", "0.125"}}), 30));
+    merger.mergeCompleteFor({1, 2, 3}, noneInvalid);
+
+    Ids ids;
+    BOOST_REQUIRE(finish(merger, ids));
+    BOOST_CHECK(ids == (Ids{"3", "5"}));
+}
+
+BOOST_AUTO_TEST_CASE(Bound) {
+    TopKMerger merger(byMag, 2, 2);
+    std::string bound;
+    BOOST_CHECK(merger.add(makeRowResult(1, {{"a", "3"}, {"b", "1e-3"}, {"c", "8"}}), 10));
+    // The rows of incomplete jobs don't set the bound.
+    BOOST_CHECK(!merger.getBound(bound));
+    merger.mergeCompleteFor({1}, noneInvalid);
+    BOOST_REQUIRE(merger.getBound(bound));
+    BOOST_CHECK_EQUAL(bound, "3");
+
+    // Rows that sort after the bound are dropped as they arrive.
+    BOOST_CHECK(merger.add(makeRowResult(2, {{"d", "4"}, {"e", "2"}}), 20));
+    BOOST_CHECK_EQUAL(merger.getRowsKept(), 3u);
+    merger.mergeCompleteFor({2}, noneInvalid);
+    BOOST_REQUIRE(merger.getBound(bound));
+    BOOST_CHECK_EQUAL(bound, "2");
+
+    // No bound for a column whose text doesn't compare exactly.
+    std::vector<TopKMerger::SortColumn> columns = byMag;
+    columns[0].exactText = false;
+    TopKMerger inexact(columns, 2, 1);
+    BOOST_CHECK(inexact.add(makeRowResult(1, {{"a", "3"}}), 10));
+    inexact.mergeCompleteFor({1}, noneInvalid);
+    BOOST_CHECK(!inexact.getBound(bound));
+}
+
+BOOST_AUTO_TEST_CASE(InvalidAttempts) {
+    TopKMerger merger(byMag, 2, 2);
+    std::set<int> invalid = {11};
+    auto isInvalid = [&invalid](int jobIdAttempt) { return invalid.count(jobIdAttempt) > 0; };
+    BOOST_CHECK(merger.add(makeRowResult(1, {{"a", "1"}, {"b", "2"}}), 11));
+    BOOST_CHECK(merger.add(makeRowResult(1, {{"c", "3"}}), 12));
+    BOOST_CHECK(merger.add(makeRowResult(2, {{"d", "4"}, {"e", "5"}}), 20));
+    // The rows of the invalid attempt are dropped when the job completes.
+    merger.mergeCompleteFor({1}, isInvalid);
+
+    Ids ids;
+    BOOST_REQUIRE(finish(merger, ids, isInvalid));
+    BOOST_CHECK(ids == (Ids{"c", "d"}));
+
+    // An attempt becoming invalid after its rows were combined can't be undone.
+    TopKMerger late(byMag, 2, 2);
+    BOOST_CHECK(late.add(makeRowResult(1, {{"a", "1"}}), 12));
+    late.mergeCompleteFor({1}, isInvalid);
+    invalid.insert(12);
+    Ids lateIds;
+    BOOST_CHECK(!finish(late, lateIds, isInvalid));
+    BOOST_CHECK(!late.getError().empty());
+}
+
+BOOST_AUTO_TEST_CASE(Create) {
+    lsst::qserv::sql::Schema schema;
+    schema.columns.push_back(colSchema("objectId", MYSQL_TYPE_LONGLONG, "BIGINT"));
+    schema.columns.push_back(colSchema("gFlux", MYSQL_TYPE_DOUBLE, "DOUBLE"));
+    schema.columns.push_back(colSchema("rFlux", MYSQL_TYPE_FLOAT, "FLOAT"));
+    schema.columns.push_back(colSchema("name", MYSQL_TYPE_VAR_STRING, "VARCHAR(10)"));
+    auto create = [&schema](std::string const& stmt) {
+        return TopKMerger::create(*ParseRunner::makeSelectStmt(stmt), schema, 100);
+    };
+    BOOST_CHECK(create("SELECT objectId, gFlux FROM m ORDER BY gFlux DESC, objectId LIMIT 5") != nullptr);
+    BOOST_CHECK(create("SELECT objectId, rFlux*2 AS f FROM m ORDER BY rFlux LIMIT 5") != nullptr);
+    // The rows must all reach the merge table.
+    BOOST_CHECK(create("SELECT objectId FROM m ORDER BY objectId") == nullptr);
+    BOOST_CHECK(create("SELECT objectId FROM m ORDER BY objectId LIMIT 500") == nullptr);
+    BOOST_CHECK(create("SELECT DISTINCT objectId FROM m ORDER BY objectId LIMIT 5") == nullptr);
+    BOOST_CHECK(create("SELECT SUM(gFlux) FROM m ORDER BY objectId LIMIT 5") == nullptr);
+    // Only numeric columns are sorted in memory.
+    BOOST_CHECK(create("SELECT objectId FROM m ORDER BY name LIMIT 5") == nullptr);
+    BOOST_CHECK(create("SELECT objectId FROM m ORDER BY ABS(gFlux) LIMIT 5") == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -165,6 +165,7 @@ public:
     }
 
     Command* getCurrentCommand() const { return _currentCommand; }
+    CommandQueue::Ptr getQueue() const { return _q; }
 
 protected:
     virtual void startup() {}   ///< Things to do when the thread is starting up.
@@ -26,9 +26,15 @@
 #include "util/StringHash.h"
 
 // System headers
+#include <array>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
+
 // Third-party headers
 #ifdef __APPLE__
 #define COMMON_DIGEST_FOR_OPENSSL
@@ -82,6 +88,64 @@ inline std::string wrapHashHex(void const* buffer, int bufferSize) {
     return s.str();
 }
 
+/// Lookup tables for the slicing-by-8 software CRC-32C, using the
+/// reflected Castagnoli polynomial.
+std::array<std::array<uint32_t, 256>, 8> makeCrc32cTables() {
+    std::array<std::array<uint32_t, 256>, 8> tables;
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int j = 0; j < 8; ++j) {
+            crc = (crc >> 1) ^ (0x82f63b78 & (0 - (crc & 1)));
+        }
+        tables[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; ++i) {
+        for (int t = 1; t < 8; ++t) {
+            tables[t][i] = (tables[t - 1][i] >> 8) ^ tables[0][tables[t - 1][i] & 0xff];
+        }
+    }
+    return tables;
+}
+
+uint32_t crc32cSoftware(unsigned char const* buf, size_t len, uint32_t crc) {
+    static auto const tables = makeCrc32cTables();
+    for (; len >= 8; len -= 8, buf += 8) {
+        uint32_t lo;
+        uint32_t hi;
+        std::memcpy(&lo, buf, 4);
+        std::memcpy(&hi, buf + 4, 4);
+        lo ^= crc;  // Little-endian only, same as the hardware version.
+        crc = tables[7][lo & 0xff] ^ tables[6][(lo >> 8) & 0xff] ^ tables[5][(lo >> 16) & 0xff] ^
+              tables[4][lo >> 24] ^ tables[3][hi & 0xff] ^ tables[2][(hi >> 8) & 0xff] ^
+              tables[1][(hi >> 16) & 0xff] ^ tables[0][hi >> 24];
+    }
+    for (; len > 0; --len, ++buf) {
+        crc = (crc >> 8) ^ tables[0][(crc ^ *buf) & 0xff];
+    }
+    return crc;
+}
+
+#if defined(__x86_64__)
+
+__attribute__((target("sse4.2"))) uint32_t crc32cHardware(unsigned char const* buf, size_t len,
+                                                          uint32_t crc) {
+    uint64_t crc64 = crc;
+    for (; len >= 8; len -= 8, buf += 8) {
+        uint64_t val;
+        std::memcpy(&val, buf, 8);
+        crc64 = _mm_crc32_u64(crc64, val);
+    }
+    crc = static_cast<uint32_t>(crc64);
+    for (; len > 0; --len, ++buf) {
+        crc = _mm_crc32_u8(crc, *buf);
+    }
+    return crc;
+}
+
+bool const hasSse42 = __builtin_cpu_supports("sse4.2");
+
+#endif  // __x86_64__
+
 }  // anonymous namespace
 
 namespace lsst::qserv::util {
@@ -121,4 +185,13 @@ std::string StringHash::getSha256(char const* buffer, int bufferSize) {
     return wrapHash<SHA256, SHA256_DIGEST_LENGTH>(buffer, bufferSize);
 }
 
+/// @return the CRC-32C checksum of the input buffer, the value for "123456789" is 0xe3069283
+std::uint32_t StringHash::getCrc32c(char const* buffer, std::size_t bufferSize, std::uint32_t crc) {
+    auto buf = reinterpret_cast<unsigned char const*>(buffer);
+#if defined(__x86_64__)
+    if (hasSse42) return ~crc32cHardware(buf, bufferSize, ~crc);
+#endif
+    return ~crc32cSoftware(buf, bufferSize, ~crc);
+}
+
 }  // namespace lsst::qserv::util
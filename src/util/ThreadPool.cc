@@ -153,6 +153,15 @@ ThreadPool::Ptr ThreadPool::newThreadPool(unsigned int thrdCount, CommandQueue::
     return thp;
 }
 
+ThreadPool::Ptr ThreadPool::newWorkStealingPool(unsigned int thrdCount, unsigned int maxThreadCount,
+                                                CommandQueue::Ptr const& q, unsigned int maxBatch,
+                                                EventThreadJoiner::Ptr const& joiner) {
+    Ptr thp(new ThreadPool(thrdCount, maxThreadCount, q, joiner));  // private constructor
+    thp->_stealingQueue = WorkStealingQueue::create(thp->_q, maxBatch);
+    thp->_resize();
+    return thp;
+}
+
 ThreadPool::ThreadPool(unsigned int thrdCount, unsigned int maxPoolThreads, CommandQueue::Ptr const& q,
                        EventThreadJoiner::Ptr const& joiner)
         : _targetThrdCount(thrdCount), _q(q), _joinerThread(joiner), _maxThreadCount(maxPoolThreads) {
@@ -199,6 +208,10 @@ bool ThreadPool::release(PoolEventThread* thrd) {
             LOGS(_log, LOG_LVL_DEBUG, "ThreadPool::release erasing " << thrd);
             _pool.erase(iter);
         }
+        if (_stealingQueue != nullptr) {
+            // Let the other threads run anything left on the queue of this thread.
+            _stealingQueue->retire(thrdPtr->getQueue());
+        }
         _joinerThread->addThread(thrdPtr);  // Add to list of threads to join.
     }
     _resize();  // Check if more threads need to be released.
@@ -241,7 +254,8 @@ void ThreadPool::_resize() {
     auto target = getTargetThrdCount();
     while (target > _pool.size()) {
         LOGS(_log, LOG_LVL_TRACE, "ThreadPool::_resize creating new PoolEventThread");
-        auto t = PoolEventThread::newPoolEventThread(shared_from_this(), _q);
+        auto q = (_stealingQueue != nullptr) ? _stealingQueue->newThreadQueue() : _q;
+        auto t = PoolEventThread::newPoolEventThread(shared_from_this(), q);
         _pool.push_back(t);
         t->run();
     }
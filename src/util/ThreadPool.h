@@ -36,6 +36,7 @@
 
 // Qserv headers
 #include "util/EventThread.h"
+#include "util/WorkStealingQueue.h"
 
 namespace lsst::qserv::util {
 
@@ -112,6 +113,9 @@ private:
 ///  to wait for something to happen, like transferring data.
 ///  _poolThreadCount is a total of all threads in the pool and all threads that have
 ///  left the pool and this total should not exceed _maxThreadCount.
+/// Note: A pool made by newWorkStealingPool() gives each thread its own queue from a
+///  WorkStealingQueue in front of the CommandQueue, so that the threads don't all wait
+///  on the CommandQueue. Commands are still queued on the CommandQueue (getQueue()).
 class ThreadPool : public std::enable_shared_from_this<ThreadPool> {
 public:
     using Ptr = std::shared_ptr<ThreadPool>;
@@ -130,10 +134,20 @@ public:
                                          CommandQueue::Ptr const& q,
                                          EventThreadJoiner::Ptr const& joiner = nullptr);
 
+    /// Used to create a pool like the one above, where only one idle thread at a time
+    /// waits for the next Command of 'q'. That thread takes up to 'maxBatch' Commands
+    /// from 'q' at once, one for each idle thread, see WorkStealingQueue.
+    static ThreadPool::Ptr newWorkStealingPool(unsigned int thrdCount, unsigned int maxThreadCount,
+                                               CommandQueue::Ptr const& q, unsigned int maxBatch,
+                                               EventThreadJoiner::Ptr const& joiner = nullptr);
+
     virtual ~ThreadPool();
 
     void shutdownPool();
     CommandQueue::Ptr getQueue() { return _q; }
+
+    /// @return the WorkStealingQueue of the pool, nullptr if it wasn't made by newWorkStealingPool().
+    WorkStealingQueue::Ptr getWorkStealingQueue() { return _stealingQueue; }
     unsigned int getTargetThrdCount() {
         std::lock_guard<std::mutex> lock(_countMutex);
         return _targetThrdCount;
@@ -166,6 +180,9 @@ private:
     std::condition_variable _countCV;  ///< Notifies about changes to _pool size, uses _countMutex.
     CommandQueue::Ptr _q;              ///< The queue used by all threads in the _pool.
 
+    /// Gives each thread its own queue in front of _q, nullptr for a pool of threads sharing _q.
+    WorkStealingQueue::Ptr _stealingQueue;
+
     EventThreadJoiner::Ptr _joinerThread;  ///< Tracks and joins threads removed from the pool.
     std::atomic<bool> _shutdown{false};    ///< True after shutdownPool has been called.
 
@@ -0,0 +1,208 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "util/WorkStealingQueue.h"
+
+// System headers
+#include <stdexcept>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+namespace {
+LOG_LOGGER _log = LOG_GET("lsst.qserv.util.WorkStealingQueue");
+}
+
+using namespace std;
+
+namespace lsst::qserv::util {
+
+Command::Ptr WorkStealingQueue::ThreadQueue::getCmd(bool wait) {
+    while (true) {
+        auto cmd = _pop();
+        if (cmd == nullptr) cmd = _owner->_steal(this);
+        if (cmd != nullptr) return cmd;
+        {
+            unique_lock<mutex> lock(_owner->_mtx);
+            {
+                lock_guard<mutex> lockThis(_mx);
+                if (_retired) return nullptr;
+            }
+            // Something may have been left to steal since the last look.
+            if (_owner->_stealable > 0) continue;
+            if (_owner->_polling) {
+                if (!wait) return nullptr;
+                ++_owner->_idle;
+                _owner->_cv.wait(lock);
+                --_owner->_idle;
+                continue;
+            }
+            _owner->_polling = true;
+        }
+        return _poll(wait);
+    }
+}
+
+Command::Ptr WorkStealingQueue::ThreadQueue::_pop() {
+    lock_guard<mutex> lock(_mx);
+    if (_qu.empty()) return nullptr;
+    auto cmd = _qu.front();
+    _qu.pop_front();
+    --_owner->_stealable;
+    return cmd;
+}
+
+Command::Ptr WorkStealingQueue::ThreadQueue::_poll(bool wait) {
+    auto& owner = *_owner;
+    auto cmd = owner._source->getCmd(wait);
+    vector<Command::Ptr> batch;
+    if (cmd != nullptr) {
+        ++owner._polled;
+        unsigned int idle = 0;
+        {
+            lock_guard<mutex> lock(owner._mtx);
+            idle = owner._idle;
+        }
+        // Only take Commands that idle threads can start right away, the others
+        // are better left to the source, which may have higher priority
+        // Commands for the next free thread.
+        size_t const limit = min(idle, owner._maxBatch - 1);
+        while (batch.size() < limit) {
+            auto extra = owner._source->getCmd(false);
+            if (extra == nullptr) break;
+            batch.push_back(extra);
+        }
+    }
+    size_t const batchSize = batch.size();
+    if (batchSize > 0) {
+        owner._polled += batchSize;
+        owner._batched += batchSize;
+        lock_guard<mutex> lock(_mx);
+        if (!_retired) {
+            _qu.insert(_qu.end(), batch.begin(), batch.end());
+            batch.clear();
+        }
+    }
+    {
+        lock_guard<mutex> lock(owner._mtx);
+        // A retired queue's Commands must still run.
+        owner._orphans.insert(owner._orphans.end(), batch.begin(), batch.end());
+        owner._stealable += batchSize;
+        owner._polling = false;
+    }
+    // Wake a thread to take over polling, and the idle threads the batch was taken for.
+    if (batchSize == 0) {
+        owner._cv.notify_one();
+    } else {
+        owner._cv.notify_all();
+    }
+    return cmd;
+}
+
+WorkStealingQueue::Ptr WorkStealingQueue::create(CommandQueue::Ptr const& source, unsigned int maxBatch) {
+    return Ptr(new WorkStealingQueue(source, maxBatch));
+}
+
+WorkStealingQueue::WorkStealingQueue(CommandQueue::Ptr const& source, unsigned int maxBatch)
+        : _source(source), _maxBatch(max(maxBatch, 1U)) {
+    if (_source == nullptr) {
+        throw invalid_argument("WorkStealingQueue needs a source queue");
+    }
+    LOGS(_log, LOG_LVL_INFO, "WorkStealingQueue maxBatch=" << _maxBatch);
+}
+
+CommandQueue::Ptr WorkStealingQueue::newThreadQueue() {
+    auto threadQueue = make_shared<ThreadQueue>(shared_from_this());
+    lock_guard<mutex> lock(_mtx);
+    _threadQueues.push_back(threadQueue);
+    return threadQueue;
+}
+
+void WorkStealingQueue::retire(CommandQueue::Ptr const& threadQueue) {
+    size_t left = 0;
+    {
+        lock_guard<mutex> lock(_mtx);
+        auto iter = find(_threadQueues.begin(), _threadQueues.end(), threadQueue);
+        if (iter == _threadQueues.end()) {
+            LOGS(_log, LOG_LVL_WARN, "WorkStealingQueue::retire unknown queue");
+            return;
+        }
+        auto thrdQ = *iter;
+        _threadQueues.erase(iter);
+        lock_guard<mutex> lockThrdQ(thrdQ->_mx);
+        thrdQ->_retired = true;
+        left = thrdQ->_qu.size();
+        _orphans.insert(_orphans.end(), thrdQ->_qu.begin(), thrdQ->_qu.end());
+        thrdQ->_qu.clear();
+    }
+    LOGS(_log, LOG_LVL_DEBUG, "WorkStealingQueue::retire left=" << left);
+    // The retired thread may have been the poller, or may have left Commands behind.
+    _cv.notify_all();
+}
+
+Command::Ptr WorkStealingQueue::_steal(ThreadQueue* thief) {
+    if (_stealable <= 0) return nullptr;
+    lock_guard<mutex> lock(_mtx);
+    Command::Ptr cmd;
+    if (!_orphans.empty()) {
+        cmd = _orphans.front();
+        _orphans.pop_front();
+    } else {
+        // Start where the last search stopped so the same queue isn't always robbed first.
+        size_t const sz = _threadQueues.size();
+        for (size_t j = 0; j < sz && cmd == nullptr; ++j) {
+            auto const& victim = _threadQueues[(_nextVictim + j) % sz];
+            if (victim.get() == thief) continue;
+            lock_guard<mutex> lockVictim(victim->_mx);
+            if (!victim->_qu.empty()) {
+                // The front is the oldest Command, the source handed them out in order.
+                cmd = victim->_qu.front();
+                victim->_qu.pop_front();
+                _nextVictim = (_nextVictim + j + 1) % sz;
+            }
+        }
+    }
+    if (cmd != nullptr) {
+        --_stealable;
+        ++_stolen;
+    }
+    return cmd;
+}
+
+nlohmann::json WorkStealingQueue::statusToJson() const {
+    nlohmann::json status;
+    status["max_batch"] = _maxBatch;
+    status["stealable"] = max(_stealable.load(), 0);
+    status["polled"] = _polled.load();
+    status["batched"] = _batched.load();
+    status["stolen"] = _stolen.load();
+    {
+        lock_guard<mutex> lock(_mtx);
+        status["threads"] = _threadQueues.size();
+        status["idle"] = _idle;
+        status["orphans"] = _orphans.size();
+    }
+    return status;
+}
+
+}  // namespace lsst::qserv::util
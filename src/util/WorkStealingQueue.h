@@ -0,0 +1,151 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_UTIL_WORKSTEALINGQUEUE_H_
+#define LSST_QSERV_UTIL_WORKSTEALINGQUEUE_H_
+
+// System headers
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Third party headers
+#include "nlohmann/json.hpp"
+
+// Qserv headers
+#include "util/EventThread.h"
+
+namespace lsst::qserv::util {
+
+/// WorkStealingQueue stands between the threads of a ThreadPool and the
+/// CommandQueue feeding them (the source, usually a scheduler), so that the
+/// threads don't all wait on the mutex and condition variable of the source.
+///
+/// Each thread gets its own ThreadQueue. Only one idle thread at a time, the
+/// poller, waits on the source. When the source hands it a Command, the poller
+/// also takes up to one more Command for each other idle thread, at most
+/// 'maxBatch' in total, and puts the extra Commands on its ThreadQueue, where
+/// the idle threads steal them. As Commands only leave the source when there
+/// are threads free to run them, the source still decides their order and
+/// keeps an accurate count of the Commands in flight.
+///
+/// Commands queued on a ThreadQueue go to the source, and so do the
+/// commandStart() and commandFinish() calls of its thread.
+class WorkStealingQueue : public std::enable_shared_from_this<WorkStealingQueue> {
+public:
+    using Ptr = std::shared_ptr<WorkStealingQueue>;
+
+    /// The CommandQueue of one thread.
+    class ThreadQueue : public CommandQueue {
+    public:
+        using Ptr = std::shared_ptr<ThreadQueue>;
+
+        explicit ThreadQueue(WorkStealingQueue::Ptr const& owner) : _owner(owner) {}
+        ThreadQueue(ThreadQueue const&) = delete;
+        ThreadQueue& operator=(ThreadQueue const&) = delete;
+        ~ThreadQueue() override = default;
+
+        void queCmd(Command::Ptr const& cmd) override { _owner->_source->queCmd(cmd); }
+        void queCmd(std::vector<Command::Ptr> const& cmds) override { _owner->_source->queCmd(cmds); }
+
+        /// Get a Command from this queue, another ThreadQueue, or the source.
+        /// @return nullptr if 'wait' is false and no Command is available,
+        ///         or if this queue was retired.
+        Command::Ptr getCmd(bool wait = true) override;
+
+        size_t size() override { return _owner->size(); }
+        void notify(bool all = true) override { _owner->_source->notify(all); }
+        void commandStart(Command::Ptr const& cmd) override { _owner->_source->commandStart(cmd); }
+        void commandFinish(Command::Ptr const& cmd) override { _owner->_source->commandFinish(cmd); }
+
+        friend class WorkStealingQueue;
+
+    private:
+        /// @return the oldest Command on this queue, nullptr if there isn't one.
+        Command::Ptr _pop();
+
+        /// Wait for a Command from the source and take one for each idle thread.
+        Command::Ptr _poll(bool wait);
+
+        WorkStealingQueue::Ptr const _owner;
+        bool _retired = false;  ///< Set by WorkStealingQueue::retire(), protected by _mx.
+    };
+
+    /// @param source - the queue the Commands come from.
+    /// @param maxBatch - most Commands the poller takes from the source at once.
+    static Ptr create(CommandQueue::Ptr const& source, unsigned int maxBatch);
+
+    WorkStealingQueue(WorkStealingQueue const&) = delete;
+    WorkStealingQueue& operator=(WorkStealingQueue const&) = delete;
+    ~WorkStealingQueue() = default;
+
+    CommandQueue::Ptr getSource() const { return _source; }
+    unsigned int getMaxBatch() const { return _maxBatch; }
+
+    /// @return a new ThreadQueue, the thread using it must call retire() when it is done with it.
+    CommandQueue::Ptr newThreadQueue();
+
+    /// Stop handing Commands to 'threadQueue' and let the other threads take the
+    /// Commands left on it. Commands from the source that reach 'threadQueue'
+    /// later also go to the other threads.
+    void retire(CommandQueue::Ptr const& threadQueue);
+
+    /// @return the number of Commands in the source and on the ThreadQueues.
+    size_t size() { return _source->size() + std::max(_stealable.load(), 0); }
+
+    /// @return a JSON representation of the object's status for the monitoring
+    nlohmann::json statusToJson() const;
+
+private:
+    WorkStealingQueue(CommandQueue::Ptr const& source, unsigned int maxBatch);
+
+    /// @return a Command from a ThreadQueue other than 'thief', or left by a retired
+    ///         ThreadQueue. nullptr if there are none.
+    Command::Ptr _steal(ThreadQueue* thief);
+
+    CommandQueue::Ptr const _source;
+    unsigned int const _maxBatch;
+
+    /// Protects _threadQueues, _orphans, _polling and _idle. May be locked before
+    /// the _mx of a ThreadQueue, never after it.
+    mutable std::mutex _mtx;
+    std::condition_variable _cv;  ///< Idle threads wait on this, uses _mtx.
+    std::vector<ThreadQueue::Ptr> _threadQueues;
+    std::deque<Command::Ptr> _orphans;  ///< Commands left by retired ThreadQueues.
+    bool _polling = false;              ///< True while a thread waits on the source.
+    unsigned int _idle = 0;             ///< Threads waiting on _cv.
+    size_t _nextVictim = 0;             ///< Where the next search for a Command to steal starts.
+
+    std::atomic<int> _stealable{0};  ///< Commands on the ThreadQueues and in _orphans.
+
+    std::atomic<std::uint64_t> _polled{0};   ///< Commands the pollers got from the source.
+    std::atomic<std::uint64_t> _batched{0};  ///< Commands the pollers took for idle threads.
+    std::atomic<std::uint64_t> _stolen{0};   ///< Commands run by a thread that didn't take them.
+};
+
+}  // namespace lsst::qserv::util
+
+#endif  // LSST_QSERV_UTIL_WORKSTEALINGQUEUE_H_
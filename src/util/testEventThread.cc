@@ -256,6 +256,112 @@ BOOST_AUTO_TEST_CASE(EventThreadTest) {
     BOOST_CHECK(weak_que.use_count() == 0);
 }
 
+BOOST_AUTO_TEST_CASE(WorkStealingPoolTest) {
+    LOGS_DEBUG("WorkStealingPool test");
+
+    struct Sum {
+        std::atomic<int> total{0};
+        void add(int val) { total += val; }
+    };
+
+    std::weak_ptr<CommandQueue> weak_que;
+    std::weak_ptr<ThreadPool> weak_pool;
+    {
+        auto cmdQueue = std::make_shared<CommandQueue>();
+        weak_que = cmdQueue;
+        unsigned int sz = 20;
+        auto pool = ThreadPool::newWorkStealingPool(sz, 1000, cmdQueue, 8);
+        weak_pool = pool;
+        BOOST_REQUIRE(pool->getWorkStealingQueue() != nullptr);
+        BOOST_CHECK(pool->getQueue() == cmdQueue);
+        BOOST_CHECK(pool->size() == sz);
+
+        // Every Command queued before the threads are told to end must run.
+        Sum poolSum;
+        int total = 0;
+        for (int j = 1; j < 5000; j++) {
+            auto cmdSum = std::make_shared<Command>([&poolSum, j](CmdData*) { poolSum.add(j); });
+            total += j;
+            cmdQueue->queCmd(cmdSum);
+        }
+        sz = 5;
+        pool->resize(sz);
+        pool->waitForResize(10000);
+        BOOST_CHECK(pool->size() == sz);
+        pool->endAll();
+        pool->waitForResize(0);
+        BOOST_CHECK(total == poolSum.total);
+        LOGS_DEBUG("WorkStealingPool " << pool->getWorkStealingQueue()->statusToJson());
+
+        // Commands stay on the source queue until a thread is free to run them.
+        sz = 1;
+        pool->resize(sz);
+        pool->waitForResize(0);
+        bool go = false;
+        std::condition_variable goCV;
+        std::mutex goCVMtx;
+        auto waitForGo = [&go, &goCV, &goCVMtx]() {
+            std::unique_lock<std::mutex> goLock(goCVMtx);
+            goCV.wait(goLock, [&go]() { return go; });
+        };
+        auto cmdBlock = std::make_shared<CommandTracked>([&waitForGo](CmdData*) { waitForGo(); });
+        cmdQueue->queCmd(cmdBlock);
+        for (int j = 0; j < 50 && cmdQueue->size() > 0; ++j) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        Sum sum;
+        int const queued = 10;
+        for (int j = 0; j < queued; j++) {
+            cmdQueue->queCmd(std::make_shared<Command>([&sum](CmdData*) { sum.add(1); }));
+        }
+        BOOST_CHECK(cmdQueue->size() == static_cast<size_t>(queued));
+        {
+            std::lock_guard<std::mutex> lock(goCVMtx);
+            go = true;
+        }
+        goCV.notify_all();
+        cmdBlock->waitComplete();
+
+        // Threads that leave the pool are replaced, and leave nothing behind on their queues.
+        sz = 4;
+        pool->resize(sz);
+        pool->waitForResize(0);
+        go = false;
+        std::vector<Tracker::Ptr> trackedCmds;
+        int threadsRunning = sz * 2;
+        for (int j = 0; j < threadsRunning; j++) {
+            auto cmdLeave = std::make_shared<CommandForThreadPool>([&sum, &waitForGo](CmdData* eventThread) {
+                PoolEventThread* peThread = dynamic_cast<PoolEventThread*>(eventThread);
+                peThread->leavePool();
+                sum.add(1);
+                waitForGo();
+            });
+            trackedCmds.push_back(cmdLeave);
+            cmdQueue->queCmd(cmdLeave);
+        }
+        for (int j = 0; sum.total < queued + threadsRunning && j < 50; ++j) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        BOOST_CHECK(sum.total == queued + threadsRunning);
+        BOOST_CHECK(pool->size() == sz);
+        {
+            std::lock_guard<std::mutex> lock(goCVMtx);
+            go = true;
+        }
+        goCV.notify_all();
+        for (auto const& ptc : trackedCmds) {
+            ptc->waitComplete();
+        }
+        pool->shutdownPool();
+        BOOST_CHECK(pool->size() == 0);
+    }
+    for (int j = 0; weak_pool.use_count() > 0 && j < 50; ++j) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    BOOST_CHECK(weak_pool.use_count() == 0);
+    BOOST_CHECK(weak_que.use_count() == 0);
+}
+
 BOOST_AUTO_TEST_CASE(InstanceCountTest) {
     struct CA {
         InstanceCount instanceCount{"CA"};
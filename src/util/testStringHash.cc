@@ -0,0 +1,103 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// System headers
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+
+// Qserv headers
+#include "util/StringHash.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE StringHash
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace test = boost::test_tools;
+
+namespace util = lsst::qserv::util;
+
+namespace {
+
+/// @return 'size' bytes resembling a result message, mostly digits and separators.
+string makeMessage(size_t size) {
+    mt19937 gen(42);
+    uniform_int_distribution<int> dist(0, 15);
+    string const chars = "0123456789.-e\t\n'";
+    string msg(size, ' ');
+    for (auto& c : msg) {
+        c = chars[dist(gen)];
+    }
+    return msg;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(Crc32c) {
+    // Check values from RFC 3720, appendix B.4.
+    string const zeros(32, '\0');
+    string const ones(32, '\xff');
+    string incr;
+    for (int j = 0; j < 32; ++j) incr += static_cast<char>(j);
+    BOOST_CHECK_EQUAL(util::StringHash::getCrc32c(zeros.data(), zeros.size()), 0x8a9136aaU);
+    BOOST_CHECK_EQUAL(util::StringHash::getCrc32c(ones.data(), ones.size()), 0x62a8ab43U);
+    BOOST_CHECK_EQUAL(util::StringHash::getCrc32c(incr.data(), incr.size()), 0x46dd794eU);
+    BOOST_CHECK_EQUAL(util::StringHash::getCrc32c("123456789", 9), 0xe3069283U);
+    BOOST_CHECK_EQUAL(util::StringHash::getCrc32c("", 0), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(Crc32cIncremental) {
+    // Checksumming in pieces, at any alignment, must match a single call.
+    string const msg = makeMessage(1000);
+    uint32_t const expected = util::StringHash::getCrc32c(msg.data(), msg.size());
+    for (size_t split : {1, 7, 8, 9, 500, 999}) {
+        uint32_t crc = util::StringHash::getCrc32c(msg.data(), split);
+        crc = util::StringHash::getCrc32c(msg.data() + split, msg.size() - split, crc);
+        BOOST_CHECK_EQUAL(crc, expected);
+    }
+}
+
+/// Compare the throughput of the result message checksums on message sizes
+/// seen in practice. Disabled by default, run it with:
+///   testStringHash --run_test=Suite/ChecksumBenchmark
+BOOST_AUTO_TEST_CASE(ChecksumBenchmark, *boost::unit_test::disabled()) {
+    for (size_t mb : {2, 8, 16, 64}) {
+        string const msg = makeMessage(mb * 1000 * 1000);
+        auto bench = [&msg, mb](string const& name, auto func) {
+            int const reps = 5;
+            auto start = chrono::steady_clock::now();
+            for (int j = 0; j < reps; ++j) func();
+            chrono::duration<double> secs = chrono::steady_clock::now() - start;
+            cout << name << " " << mb << "MB: " << (mb * reps / secs.count()) << " MB/s" << endl;
+        };
+        bench("MD5   ", [&msg]() { util::StringHash::getMd5(msg.data(), msg.size()); });
+        bench("CRC32C", [&msg]() { util::StringHash::getCrc32c(msg.data(), msg.size()); });
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,172 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/// \file
+/// \brief Measures the throughput and the start latency of tiny Commands
+///        run by a ThreadPool whose threads all wait on the CommandQueue,
+///        and by work stealing pools with several batch sizes. This is not
+///        a unit test, run it as:
+///
+///     threadPoolBench [<threads> [<commands> [<work in microseconds>]]]
+///
+/// The CommandQueue behaves like the BlendScheduler: getCmd() looks through
+/// several sub-queues in priority order with the mutex held, and
+/// commandFinish() takes the mutex and wakes every waiting thread.
+
+// System headers
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Qserv headers
+#include "util/ThreadPool.h"
+
+using namespace std;
+using namespace lsst::qserv::util;
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+/// A CommandQueue that locks and notifies like the BlendScheduler.
+class BlendLikeQueue : public CommandQueue {
+public:
+    explicit BlendLikeQueue(unsigned int subQueues) : _subQueues(subQueues) {}
+
+    void queCmd(Command::Ptr const& cmd) override {
+        {
+            lock_guard<mutex> lock(_mx);
+            _subQueues[_next++ % _subQueues.size()].push_back(cmd);
+        }
+        notify(true);
+    }
+
+    Command::Ptr getCmd(bool wait) override {
+        unique_lock<mutex> lock(_mx);
+        while (true) {
+            for (auto& subQueue : _subQueues) {
+                if (!subQueue.empty()) {
+                    auto cmd = subQueue.front();
+                    subQueue.pop_front();
+                    ++_inFlight;
+                    return cmd;
+                }
+            }
+            if (!wait) return nullptr;
+            _cv.wait(lock);
+        }
+    }
+
+    size_t size() override {
+        lock_guard<mutex> lock(_mx);
+        size_t sz = 0;
+        for (auto const& subQueue : _subQueues) sz += subQueue.size();
+        return sz;
+    }
+
+    void commandFinish(Command::Ptr const&) override {
+        {
+            lock_guard<mutex> lock(_mx);
+            --_inFlight;
+        }
+        notify(true);
+    }
+
+private:
+    vector<deque<Command::Ptr>> _subQueues;
+    unsigned int _next = 0;
+    int _inFlight = 0;
+};
+
+struct Result {
+    double seconds = 0.0;
+    vector<double> latencies;  ///< Microseconds from queuing to start, sorted.
+};
+
+/// Queue 'commands' Commands in bursts and wait for all of them to run.
+Result run(ThreadPool::Ptr const& pool, unsigned int commands, unsigned int workUs) {
+    auto queue = pool->getQueue();
+    vector<double> latencies(commands);
+    atomic<unsigned int> done{0};
+    unsigned int const burst = 256;
+    auto const start = Clock::now();
+    for (unsigned int j = 0; j < commands; ++j) {
+        auto const queued = Clock::now();
+        queue->queCmd(make_shared<Command>([&latencies, &done, j, queued, workUs](CmdData*) {
+            auto const began = Clock::now();
+            latencies[j] = chrono::duration<double, micro>(began - queued).count();
+            while (chrono::duration<double, micro>(Clock::now() - began).count() < workUs) {
+            }
+            ++done;
+        }));
+        // Give the pool time to drain part of each burst, as interactive queries arrive.
+        if (j % burst == burst - 1) {
+            while (done + 2 * burst < j) this_thread::yield();
+        }
+    }
+    while (done < commands) this_thread::sleep_for(chrono::microseconds(100));
+    Result result;
+    result.seconds = chrono::duration<double>(Clock::now() - start).count();
+    sort(latencies.begin(), latencies.end());
+    result.latencies = move(latencies);
+    return result;
+}
+
+double percentile(vector<double> const& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t const j = min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()));
+    return sorted[j];
+}
+
+}  // namespace
+
+int main(int argc, char const* argv[]) {
+    unsigned int const threads = (argc > 1) ? atoi(argv[1]) : max(thread::hardware_concurrency(), 4U);
+    unsigned int const commands = (argc > 2) ? atoi(argv[2]) : 200000;
+    unsigned int const workUs = (argc > 3) ? atoi(argv[3]) : 5;
+    unsigned int const subQueues = 5;  // The group, fast, med, slow and snail schedulers.
+
+    cout << "threads=" << threads << " commands=" << commands << " work=" << workUs << "us" << endl;
+    cout << setw(16) << "pool" << setw(14) << "commands/s" << setw(10) << "p50 us" << setw(10) << "p99 us"
+         << setw(10) << "p99.9 us" << setw(12) << "max us" << endl;
+    for (unsigned int batch : {0U, 1U, 4U, 16U, 64U}) {
+        auto queue = make_shared<BlendLikeQueue>(subQueues);
+        auto pool = (batch == 0) ? ThreadPool::newThreadPool(threads, threads + 1, queue)
+                                 : ThreadPool::newWorkStealingPool(threads, threads + 1, queue, batch);
+        auto result = run(pool, commands, workUs);
+        pool->shutdownPool();
+        string const name = (batch == 0) ? "shared" : "stealing/" + to_string(batch);
+        cout << setw(16) << name << setw(14) << fixed << setprecision(0) << commands / result.seconds
+             << setprecision(1) << setw(10) << percentile(result.latencies, 0.5) << setw(10)
+             << percentile(result.latencies, 0.99) << setw(10) << percentile(result.latencies, 0.999)
+             << setw(12) << percentile(result.latencies, 1.0) << endl;
+    }
+    return 0;
+}
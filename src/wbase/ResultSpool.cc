@@ -0,0 +1,178 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "wbase/ResultSpool.h"
+
+// System headers
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <vector>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+using namespace std;
+
+namespace {
+LOG_LOGGER _log = LOG_GET("lsst.qserv.wbase.ResultSpool");
+}
+
+namespace lsst::qserv::wbase {
+
+mutex ResultSpool::_setupMtx;
+string ResultSpool::_dir;
+atomic<uint64_t> ResultSpool::_maxBytes{0};
+atomic<uint64_t> ResultSpool::_maxTotalBytes{0};
+atomic<uint64_t> ResultSpool::_totalBytes{0};
+atomic<uint64_t> ResultSpool::_filesCreated{0};
+atomic<uint64_t> ResultSpool::_bytesSpooled{0};
+atomic<uint64_t> ResultSpool::_appendsRefused{0};
+
+void ResultSpool::setup(string const& dir, uint64_t maxBytes, uint64_t maxTotalBytes) {
+    lock_guard<mutex> lock(_setupMtx);
+    _dir = dir;
+    _maxBytes = maxBytes;
+    _maxTotalBytes = maxTotalBytes;
+    LOGS(_log, LOG_LVL_INFO,
+         "ResultSpool dir=" << _dir << " maxBytes=" << _maxBytes << " maxTotalBytes=" << _maxTotalBytes);
+}
+
+bool ResultSpool::isEnabled() {
+    lock_guard<mutex> lock(_setupMtx);
+    return !_dir.empty();
+}
+
+ResultSpool::Ptr ResultSpool::create(string const& idStr) {
+    string path;
+    {
+        lock_guard<mutex> lock(_setupMtx);
+        if (_dir.empty()) return nullptr;
+        path = _dir + "/qserv-spool-XXXXXX";
+    }
+    vector<char> pathBuf(path.begin(), path.end());
+    pathBuf.push_back('\0');
+    int const fd = mkostemp(pathBuf.data(), O_CLOEXEC);
+    if (fd < 0) {
+        LOGS(_log, LOG_LVL_ERROR,
+             idStr << " failed to create spool file " << path << ": " << strerror(errno));
+        return nullptr;
+    }
+    // Nothing else needs the name, and the space is freed on close even if the worker dies.
+    if (unlink(pathBuf.data()) != 0) {
+        LOGS(_log, LOG_LVL_WARN, idStr << " failed to unlink spool file " << pathBuf.data() << ": "
+                                       << strerror(errno));
+    }
+    ++_filesCreated;
+    return Ptr(new ResultSpool(fd, idStr));
+}
+
+ResultSpool::ResultSpool(int fd, string const& idStr) : _fd(fd), _idStr(idStr) {}
+
+ResultSpool::~ResultSpool() {
+    close(_fd);
+    _totalBytes -= _size;
+    LOGS(_log, LOG_LVL_TRACE, _idStr << " ResultSpool closed size=" << _size);
+}
+
+bool ResultSpool::append(string const& data, uint64_t& offset) {
+    lock_guard<mutex> lock(_mtx);
+    uint64_t const length = data.size();
+    if (_size + length > _maxBytes) {
+        ++_appendsRefused;
+        LOGS(_log, LOG_LVL_DEBUG, _idStr << " spool file would be over maxBytes=" << _maxBytes);
+        return false;
+    }
+    // Reserve the space in the total before writing.
+    if (_totalBytes.fetch_add(length) + length > _maxTotalBytes) {
+        _totalBytes -= length;
+        ++_appendsRefused;
+        LOGS(_log, LOG_LVL_DEBUG, _idStr << " spool files would be over maxTotalBytes=" << _maxTotalBytes);
+        return false;
+    }
+    char const* buf = data.data();
+    size_t remaining = length;
+    off_t pos = _size;
+    while (remaining > 0) {
+        ssize_t const written = pwrite(_fd, buf, remaining, pos);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            LOGS(_log, LOG_LVL_ERROR, _idStr << " spool file write failed: " << strerror(errno));
+            _totalBytes -= length;
+            ++_appendsRefused;
+            return false;
+        }
+        buf += written;
+        pos += written;
+        remaining -= written;
+    }
+    offset = _size;
+    _size += length;
+    _bytesSpooled += length;
+    return true;
+}
+
+bool ResultSpool::read(uint64_t offset, size_t length, string& data) const {
+    data.resize(length);
+    char* buf = data.data();
+    size_t remaining = length;
+    off_t pos = offset;
+    while (remaining > 0) {
+        ssize_t const got = pread(_fd, buf, remaining, pos);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) {
+            LOGS(_log, LOG_LVL_ERROR,
+                 _idStr << " spool file read failed at " << pos << ": "
+                        << (got < 0 ? strerror(errno) : "unexpected end of file"));
+            data.clear();
+            return false;
+        }
+        buf += got;
+        pos += got;
+        remaining -= got;
+    }
+    return true;
+}
+
+uint64_t ResultSpool::getSize() const {
+    lock_guard<mutex> lock(_mtx);
+    return _size;
+}
+
+nlohmann::json ResultSpool::statusToJson() {
+    nlohmann::json status = nlohmann::json::object();
+    {
+        lock_guard<mutex> lock(_setupMtx);
+        status["dir"] = _dir;
+    }
+    status["maxBytes"] = _maxBytes.load();
+    status["maxTotalBytes"] = _maxTotalBytes.load();
+    status["totalBytes"] = _totalBytes.load();
+    status["filesCreated"] = _filesCreated.load();
+    status["bytesSpooled"] = _bytesSpooled.load();
+    status["appendsRefused"] = _appendsRefused.load();
+    return status;
+}
+
+}  // namespace lsst::qserv::wbase
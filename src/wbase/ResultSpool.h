@@ -0,0 +1,105 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_WBASE_RESULTSPOOL_H
+#define LSST_QSERV_WBASE_RESULTSPOOL_H
+
+// System headers
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Third party headers
+#include "nlohmann/json.hpp"
+
+namespace lsst::qserv::wbase {
+
+/// ResultSpool is a file on local disk that holds the serialized result
+/// messages of a task until they are transmitted to the czar. Spooling lets
+/// a task read all of its rows out of MySQL, and give back the result and
+/// the SQL connection, without waiting for the czar to read the messages.
+///
+/// The file is unlinked as soon as it is created, so that it goes away when
+/// the last message referring to it is sent, or when the worker dies.
+/// The sizes of each file and of all files together are limited, see setup().
+class ResultSpool {
+public:
+    using Ptr = std::shared_ptr<ResultSpool>;
+
+    ResultSpool() = delete;
+    ResultSpool(ResultSpool const&) = delete;
+    ResultSpool& operator=(ResultSpool const&) = delete;
+
+    ~ResultSpool();
+
+    /// Set the directory for spool files and the limits on their sizes.
+    /// An empty 'dir' disables spooling, which is the default.
+    /// @param maxBytes - the maximum number of bytes in one spool file.
+    /// @param maxTotalBytes - the maximum number of bytes in all spool files.
+    static void setup(std::string const& dir, uint64_t maxBytes, uint64_t maxTotalBytes);
+
+    /// @return true if setup() was given a directory for spool files.
+    static bool isEnabled();
+
+    /// @return a new, empty spool file for the task 'idStr', or nullptr if
+    ///         spooling is disabled or the file could not be created.
+    static Ptr create(std::string const& idStr);
+
+    /// Append 'data' to the file and set 'offset' to its position.
+    /// @return false, leaving the file unchanged, if the data would go over
+    ///         one of the limits or could not be written.
+    bool append(std::string const& data, uint64_t& offset);
+
+    /// Read 'length' bytes at 'offset' into 'data'.
+    /// @return false if the bytes could not be read.
+    bool read(uint64_t offset, size_t length, std::string& data) const;
+
+    /// @return the number of bytes in the file.
+    uint64_t getSize() const;
+
+    /// @return the number of bytes in all spool files.
+    static uint64_t getTotalBytes() { return _totalBytes; }
+
+    /// @return a JSON representation of the configuration and usage of spool files.
+    static nlohmann::json statusToJson();
+
+private:
+    ResultSpool(int fd, std::string const& idStr);
+
+    int const _fd;
+    std::string const _idStr;
+    mutable std::mutex _mtx;  ///< Protects _size.
+    uint64_t _size = 0;
+
+    static std::mutex _setupMtx;  ///< Protects _dir.
+    static std::string _dir;
+    static std::atomic<uint64_t> _maxBytes;
+    static std::atomic<uint64_t> _maxTotalBytes;
+    static std::atomic<uint64_t> _totalBytes;      ///< Bytes in all spool files now.
+    static std::atomic<uint64_t> _filesCreated;    ///< Spool files created since the worker started.
+    static std::atomic<uint64_t> _bytesSpooled;    ///< Bytes spooled since the worker started.
+    static std::atomic<uint64_t> _appendsRefused;  ///< Appends refused because of the limits or errors.
+};
+
+}  // namespace lsst::qserv::wbase
+
+#endif  // LSST_QSERV_WBASE_RESULTSPOOL_H
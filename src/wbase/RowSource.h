@@ -0,0 +1,68 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_WBASE_ROWSOURCE_H
+#define LSST_QSERV_WBASE_ROWSOURCE_H
+
+// 3rd party headers
+#include <mysql/mysql.h>
+
+namespace lsst::qserv::wbase {
+
+/// The rows of a query result, as they are read into TransmitData objects.
+/// Rows and their value lengths have the form returned by mysql_fetch_row()
+/// and mysql_fetch_lengths(), with NULL values represented by null pointers.
+class RowSource {
+public:
+    virtual ~RowSource() = default;
+
+    /// @return the number of values in each row.
+    virtual int getNumFields() = 0;
+
+    /// @return the descriptions of the fields. Only their 'name', 'type' and
+    ///         'flags' members need to be set.
+    virtual MYSQL_FIELD const* getFields() = 0;
+
+    /// @return the next row, or nullptr if there are no more rows. The row
+    ///         and 'lengths' remain valid until the next call.
+    virtual char const* const* nextRow(unsigned long const*& lengths) = 0;
+};
+
+/// The rows of a MySQL result.
+class MySqlRowSource : public RowSource {
+public:
+    explicit MySqlRowSource(MYSQL_RES* mResult) : _mResult(mResult) {}
+
+    int getNumFields() override { return mysql_num_fields(_mResult); }
+    MYSQL_FIELD const* getFields() override { return mysql_fetch_fields(_mResult); }
+
+    char const* const* nextRow(unsigned long const*& lengths) override {
+        MYSQL_ROW row = mysql_fetch_row(_mResult);
+        if (row != nullptr) lengths = mysql_fetch_lengths(_mResult);
+        return row;
+    }
+
+private:
+    MYSQL_RES* const _mResult;
+};
+
+}  // namespace lsst::qserv::wbase
+
+#endif  // LSST_QSERV_WBASE_ROWSOURCE_H
@@ -31,6 +31,8 @@
 #include "util/Error.h"
 #include "util/MultiError.h"
 #include "util/Timer.h"
+#include "wbase/ResultSpool.h"
+#include "wbase/RowSource.h"
 #include "wbase/Task.h"
 #include "wcontrol/TransmitMgr.h"
 #include "wpublish/QueriesAndChunks.h"
@@ -284,9 +286,28 @@ void SendChannelShared::setSchemaCols(Task& task, std::vector<SchemaCol>& schema
     }
 }
 
-bool SendChannelShared::buildAndTransmitResult(MYSQL_RES* mResult, int numFields, Task::Ptr const& task,
+bool SendChannelShared::buildAndTransmitResult(RowSource& rows, int numFields, Task::Ptr const& task,
                                                bool largeResult, util::MultiError& multiErr,
                                                std::atomic<bool>& cancelled, bool& readRowsOk) {
+    bool lastIn = false;
+    bool const spool = false;
+    return _buildResult(rows, numFields, task, largeResult, multiErr, cancelled, readRowsOk, spool,
+                        lastIn);
+}
+
+bool SendChannelShared::buildAndSpoolResult(RowSource& rows, int numFields, Task::Ptr const& task,
+                                            bool largeResult, util::MultiError& multiErr,
+                                            std::atomic<bool>& cancelled, bool& readRowsOk, bool& lastIn) {
+    lastIn = false;
+    bool const spool = true;
+    return _buildResult(rows, numFields, task, largeResult, multiErr, cancelled, readRowsOk, spool,
+                        lastIn);
+}
+
+bool SendChannelShared::_buildResult(RowSource& rows, int numFields, Task::Ptr const& task,
+                                     bool largeResult, util::MultiError& multiErr,
+                                     std::atomic<bool>& cancelled, bool& readRowsOk, bool spool,
+                                     bool& lastIn) {
     util::Timer transmitT;
     transmitT.start();
     double bufferFillSecs = 0.0;
@@ -294,30 +315,39 @@ bool SendChannelShared::buildAndTransmitResult(MYSQL_RES* mResult, int numFields
     // 'cancelled' is passed as a reference so that if its value is
     // changed externally, it will break the while loop below.
     // Wait until the transmit Manager says it is ok to send data to the czar.
+    // When spooling, nothing is sent until transmitSpooled() is called, or
+    // the spool can't take any more.
     auto qId = task->getQueryId();
     bool scanInteractive = task->getScanInteractive();
-    _waitTransmitLock(scanInteractive, qId);
+    if (!spool) _waitTransmitLock(scanInteractive, qId);
+    // The last message waits for transmitSpooled() even if spooling stops
+    // part way, as the spooled messages must be queued before it.
+    bool const deferLast = spool;
 
     // Lock the transmit mutex until this is done.
     lock_guard<mutex> lock(_tMtx);
     // Initialize _transmitData, if needed.
     _initTransmit(*task);
 
-    numFields = mysql_num_fields(mResult);
+    numFields = rows.getNumFields();
     bool erred = false;
     size_t tSize = 0;
 
     int bytesTransmitted = 0;
     int rowsTransmitted = 0;
 
+    // Created when the first message is spooled, so that results that fit
+    // in one message never touch the disk.
+    ResultSpool::Ptr resultSpool;
+
     // If fillRows returns false, _transmitData is full and needs to be transmitted
-    // fillRows returns true when there are no more rows in mResult to add.
+    // fillRows returns true when there are no more rows in 'rows' to add.
     // tSize is set by fillRows.
     bool more = true;
     while (more && !cancelled) {
         util::Timer bufferFillT;
         bufferFillT.start();
-        more = !_transmitData->fillRows(mResult, numFields, tSize);
+        more = !_transmitData->fillRows(rows, numFields, tSize);
         if (tSize > proto::ProtoHeaderWrap::PROTOBUFFER_HARD_LIMIT) {
             LOGS_ERROR("Message single row too large to send using protobuffer");
             erred = true;
@@ -337,8 +367,16 @@ bool SendChannelShared::buildAndTransmitResult(MYSQL_RES* mResult, int numFields
 
         // This will become true only if this is the last task sending its last transmit.
         // _prepTransmit will add the message to the queue and may try to transmit it now.
-        bool lastIn = false;
+        lastIn = false;
         if (more) {
+            if (spool) {
+                if (resultSpool == nullptr) resultSpool = ResultSpool::create(task->getIdStr());
+                if (resultSpool != nullptr && _spoolTransmit(resultSpool, *task)) continue;
+                // Send the rest of the rows as they are read.
+                LOGS(_log, LOG_LVL_INFO, task->getIdStr() << " could not spool, transmitting instead");
+                spool = false;
+                _waitTransmitLock(scanInteractive, qId);
+            }
             if (readRowsOk && !_prepTransmit(task, cancelled, lastIn)) {
                 LOGS(_log, LOG_LVL_ERROR, "Could not transmit intermediate results.");
                 readRowsOk = false;  // Empty the fillRows data and then return false.
@@ -349,8 +387,8 @@ bool SendChannelShared::buildAndTransmitResult(MYSQL_RES* mResult, int numFields
             lastIn = transmitTaskLast(true);
             // If 'lastIn', this is the last transmit and it needs to be added.
             // Otherwise, just append the next query result rows to the existing _transmitData
-            // and send it later.
-            if (lastIn && readRowsOk && !_prepTransmit(task, cancelled, lastIn)) {
+            // and send it later. When spooling, transmitSpooled() adds it.
+            if (!deferLast && lastIn && readRowsOk && !_prepTransmit(task, cancelled, lastIn)) {
                 LOGS(_log, LOG_LVL_ERROR, "Could not transmit intermediate results.");
                 readRowsOk = false;  // Empty the fillRows data and then return false.
                 erred = true;
@@ -369,7 +407,65 @@ bool SendChannelShared::buildAndTransmitResult(MYSQL_RES* mResult, int numFields
         LOGS(_log, LOG_LVL_TRACE,
              "TaskTransmit time=" << timeSeconds << " bufferFillSecs=" << bufferFillSecs);
     }
+    if (resultSpool != nullptr) {
+        LOGS(_log, LOG_LVL_DEBUG,
+             task->getIdStr() << " spooled " << resultSpool->getSize() << " bytes in " << timeSeconds
+                              << " secs, all spool files " << ResultSpool::getTotalBytes() << " bytes");
+    }
+
+    return erred;
+}
+
+bool SendChannelShared::_spoolTransmit(ResultSpool::Ptr const& resultSpool, Task& task) {
+    if (!_transmitData->spool(resultSpool)) return false;
+    {
+        lock_guard<mutex> sLock(_spooledMtx);
+        _spooled.push_back(_transmitData);
+    }
+    // Now that _transmitData is spooled, reset and initialize a new one.
+    _transmitData.reset();
+    _initTransmit(task);
+    return true;
+}
 
+bool SendChannelShared::transmitSpooled(Task::Ptr const& task, bool cancelled, bool lastIn) {
+    auto qId = task->getQueryId();
+    int jId = task->getJobId();
+    QSERV_LOGCONTEXT_QUERY_JOB(qId, jId);
+    _waitTransmitLock(task->getScanInteractive(), qId);
+
+    util::Timer transmitT;
+    transmitT.start();
+    vector<TransmitData::Ptr> spooled;
+    {
+        lock_guard<mutex> sLock(_spooledMtx);
+        spooled.swap(_spooled);
+    }
+    bool erred = false;
+    {
+        unique_lock<mutex> qLock(_queueMtx);
+        for (auto const& tData : spooled) {
+            _transmitQueue.push(tData);
+        }
+        // If another task already queued the spooled messages, there's nothing to send
+        // until the last message is added.
+        if (!lastIn && !spooled.empty()) {
+            if (_lastRecvd || isDead()) {
+                LOGS(_log, LOG_LVL_WARN, "transmitSpooled after isDead or lastRecvd");
+                erred = true;
+            } else {
+                erred = !_transmit(false, task);
+            }
+        }
+    }
+    if (lastIn && !erred) {
+        lock_guard<mutex> lock(_tMtx);
+        erred = !_prepTransmit(task, cancelled, lastIn);
+    }
+    transmitT.stop();
+    LOGS(_log, LOG_LVL_DEBUG,
+         "transmitSpooled lastIn=" << lastIn << " messages=" << spooled.size() << " erred=" << erred
+                                   << " secs=" << transmitT.getElapsed());
     return erred;
 }
 
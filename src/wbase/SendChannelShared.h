@@ -29,6 +29,7 @@
 #include <string>
 #include <stdexcept>
 #include <thread>
+#include <vector>
 
 // Third-party headers
 #include <mysql/mysql.h>
@@ -47,6 +48,8 @@ class TransmitLock;
 
 namespace wbase {
 
+class ResultSpool;
+class RowSource;
 class Task;
 
 /// A class that provides a SendChannel object with synchronization so it can be
@@ -57,12 +60,13 @@ class Task;
 /// When building messages for result rows, multiple tasks may add to the
 /// the TransmitData object before it is transmitted to the czar. All the
 /// tasks adding rows to the TransmitData object must be operating on
-/// the same chunk. This only happens for near-neighbor queries, which
-/// have one task per subchunk.
+/// the same job. This happens for near-neighbor queries, which
+/// have one task per subchunk, and for batched jobs, which have tasks
+/// for several chunks (see TaskMsg.batchchunk).
 ///
 /// Error messages cause the existing TransmitData object to be thrown away
 /// as the contents cannot be used. This is one of many reasons TransmitData
-/// objects can only be shared among a single chunk.
+/// objects can only be shared among a single job.
 ///
 /// An important concept for this class is '_lastRecvd'. This means that
 /// the last TransmitData object needed is on the queue.
@@ -167,10 +171,28 @@ public:
     /// Put the SQL results in a TransmitData object and transmit it to the czar
     /// if appropriate.
     /// @ return true if there was an error.
-    bool buildAndTransmitResult(MYSQL_RES* mResult, int numFields, std::shared_ptr<Task> const& task,
+    bool buildAndTransmitResult(RowSource& rows, int numFields, std::shared_ptr<Task> const& task,
                                 bool largeResult, util::MultiError& multiErr, std::atomic<bool>& cancelled,
                                 bool& readRowsOk);
 
+    /// Read all of the SQL results into TransmitData objects without waiting
+    /// for the czar. The full objects are spooled to local disk (see ResultSpool)
+    /// so that 'rows' and its SQL connection can be released before
+    /// transmitSpooled() sends them. If spooling fails or reaches a limit, the
+    /// remaining rows are transmitted as they are read, as buildAndTransmitResult()
+    /// would do.
+    /// @param lastIn - set to true if this was the last task to read its rows, in
+    ///                 which case transmitSpooled() sends the last message.
+    /// @return true if there was an error.
+    bool buildAndSpoolResult(RowSource& rows, int numFields, std::shared_ptr<Task> const& task,
+                             bool largeResult, util::MultiError& multiErr, std::atomic<bool>& cancelled,
+                             bool& readRowsOk, bool& lastIn);
+
+    /// Transmit the messages spooled by buildAndSpoolResult().
+    /// @param lastIn - as set by buildAndSpoolResult().
+    /// @return true if there was an error.
+    bool transmitSpooled(std::shared_ptr<Task> const& task, bool cancelled, bool lastIn);
+
     /// @return a log worthy string describing _transmitData.
     std::string dumpTr() const;
 
@@ -248,6 +270,18 @@ private:
     /// Prepare the transmit data and then call _addTransmit.
     bool _prepTransmit(std::shared_ptr<Task> const& task, bool cancelled, bool lastIn);
 
+    /// @see buildAndTransmitResult and buildAndSpoolResult, 'spool' selects
+    /// the latter. 'lastIn' is only set when spooling.
+    bool _buildResult(RowSource& rows, int numFields, std::shared_ptr<Task> const& task,
+                      bool largeResult, util::MultiError& multiErr, std::atomic<bool>& cancelled,
+                      bool& readRowsOk, bool spool, bool& lastIn);
+
+    /// Spool _transmitData to 'resultSpool' and hold it in _spooled until
+    /// transmitSpooled() is called.
+    /// Note: _tMtx must be held before calling.
+    /// @return false if _transmitData could not be spooled.
+    bool _spoolTransmit(std::shared_ptr<ResultSpool> const& resultSpool, Task& task);
+
     /// @see dumpTr()
     std::string _dumpTr() const;
 
@@ -291,6 +325,11 @@ private:
     std::shared_ptr<TransmitData> _transmitData;  ///< TransmitData object
     mutable std::mutex _tMtx;                     ///< protects _transmitData
 
+    /// Spooled TransmitData objects that are not on _transmitQueue yet. They are
+    /// kept apart since _queueMtx may be held for a long time by a transmit.
+    std::vector<TransmitData::Ptr> _spooled;
+    std::mutex _spooledMtx;  ///< protects _spooled
+
     std::shared_ptr<util::InstanceCount> _icPtr;  ///< temporary for LockupDB
 };
 
@@ -170,6 +170,46 @@ std::vector<Task::Ptr> Task::createTasks(std::shared_ptr<proto::TaskMsg> const&
     QSERV_LOGCONTEXT_QUERY_JOB(taskMsg->queryid(), taskMsg->jobid());
     std::vector<Task::Ptr> vect;
 
+    if (taskMsg->batchchunk_size() == 0) {
+        _addTasks(vect, taskMsg, sendChannel);
+    } else {
+        // Each chunk of a batch gets its own copy of the message, so that the tasks
+        // are scheduled and tracked by chunk as if the chunks had been sent one by one.
+        auto chunkMsg = std::make_shared<proto::TaskMsg>(*taskMsg);
+        chunkMsg->clear_batchchunk();
+        _addTasks(vect, chunkMsg, sendChannel);
+        for (auto const& batchChunk : taskMsg->batchchunk()) {
+            auto msg = std::make_shared<proto::TaskMsg>(*chunkMsg);
+            msg->set_chunkid(batchChunk.chunkid());
+            if (batchChunk.fragment_size() > 0) {
+                msg->clear_fragment();
+                for (int fragNum = 0; fragNum < batchChunk.fragment_size(); ++fragNum) {
+                    proto::TaskMsg_Fragment* fragment = msg->add_fragment();
+                    *fragment = batchChunk.fragment(fragNum);
+                    if (fragment->query_size() > 0) continue;
+                    if (fragNum >= chunkMsg->fragment_size()) {
+                        throw util::Bug(ERR_LOC, "Task::createTasks no template for fragment " +
+                                                         to_string(fragNum) + " of chunk " +
+                                                         to_string(batchChunk.chunkid()));
+                    }
+                    proto::TaskMsg_Fragment const& tmpl = chunkMsg->fragment(fragNum);
+                    *fragment->mutable_query() = tmpl.query();
+                    if (!fragment->has_resulttable()) fragment->set_resulttable(tmpl.resulttable());
+                    if (fragment->subchunks().dbtbl_size() == 0 && tmpl.has_subchunks()) {
+                        *fragment->mutable_subchunks()->mutable_dbtbl() = tmpl.subchunks().dbtbl();
+                    }
+                }
+            }
+            _addTasks(vect, msg, sendChannel);
+        }
+    }
+    sendChannel->setTaskCount(vect.size());
+
+    return vect;
+}
+
+void Task::_addTasks(std::vector<Task::Ptr>& vect, std::shared_ptr<proto::TaskMsg> const& taskMsg,
+                     std::shared_ptr<wbase::SendChannelShared> const& sendChannel) {
     /// Make one task for each fragment.
     int fragmentCount = taskMsg->fragment_size();
     if (fragmentCount < 1) {
@@ -201,9 +241,6 @@ std::vector<Task::Ptr> Task::createTasks(std::shared_ptr<proto::TaskMsg> const&
             }
         }
     }
-    sendChannel->setTaskCount(vect.size());
-
-    return vect;
 }
 
 void Task::setQueryStatistics(wpublish::QueryStatistics::Ptr const& qStats) { _queryStats = qStats; }
@@ -280,6 +317,11 @@ void Task::queued(std::chrono::system_clock::time_point const& now) {
     _queueTime = now;
 }
 
+std::chrono::system_clock::time_point Task::getQueueTime() const {
+    std::lock_guard<std::mutex> guard(_stateMtx);
+    return _queueTime;
+}
+
 bool Task::isRunning() const {
     std::lock_guard<std::mutex> lock(_stateMtx);
     switch (_state) {
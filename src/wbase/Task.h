@@ -84,6 +84,10 @@ public:
     virtual void taskCancelled(Task*) = 0;  ///< Repeated calls must be harmless.
     virtual bool removeTask(std::shared_ptr<Task> const& task, bool removeRunning) = 0;
 
+    /// @return the number of Tasks on the chunk that are queued or running,
+    ///         0 if the scheduler doesn't keep Tasks by chunk.
+    virtual std::size_t getChunkTaskCount(int chunkId) const { return 0; }
+
     util::HistogramRolling::Ptr histTimeOfRunningTasks;       ///< Store information about running tasks
     util::HistogramRolling::Ptr histTimeOfTransmittingTasks;  ///< Store information about transmitting tasks.
 };
@@ -136,6 +140,7 @@ public:
     virtual ~Task();
 
     /// Read 'taskMsg' to generate a vector of one or more task objects all using the same 'sendChannel'
+    /// If 'taskMsg' has batchchunk entries, tasks are made for each of its chunks.
     static std::vector<Ptr> createTasks(std::shared_ptr<proto::TaskMsg> const& taskMsg,
                                         std::shared_ptr<SendChannelShared> const& sendChannel);
 
@@ -202,6 +207,8 @@ public:
     std::chrono::milliseconds getRunTime() const;
 
     void queued(std::chrono::system_clock::time_point const& now);
+    /// @return when queued() was called, the epoch if it wasn't.
+    std::chrono::system_clock::time_point getQueueTime() const;
     void started(std::chrono::system_clock::time_point const& now);
 
     /// MySQL finished executing queries.
@@ -221,6 +228,10 @@ public:
     nlohmann::json getJson() const;
 
 private:
+    /// Add the tasks for the fragments of the single chunk of 'taskMsg' to 'vect'.
+    static void _addTasks(std::vector<Ptr>& vect, std::shared_ptr<proto::TaskMsg> const& taskMsg,
+                          std::shared_ptr<SendChannelShared> const& sendChannel);
+
     std::shared_ptr<SendChannelShared> _sendChannel;
     uint64_t const _tSeq = 0;     ///< identifier for the specific task
     QueryId const _qId = 0;       ///< queryId from czar
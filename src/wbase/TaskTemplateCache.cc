@@ -0,0 +1,105 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "wbase/TaskTemplateCache.h"
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "proto/TaskMsgTemplate.h"
+#include "proto/worker.pb.h"
+
+using namespace std;
+
+namespace {
+LOG_LOGGER _log = LOG_GET("lsst.qserv.wbase.TaskTemplateCache");
+}
+
+namespace lsst::qserv::wbase {
+
+void TaskTemplateCache::add(proto::TaskMsg const& taskMsg) {
+    if (_maxEntries == 0) return;
+    Key const key(taskMsg.czarid(), taskMsg.queryid(), taskMsg.templateid());
+    {
+        // Retried jobs send the template again.
+        lock_guard<mutex> lock(_mtx);
+        auto iter = _templates.find(key);
+        if (iter != _templates.end()) {
+            _lru.splice(_lru.begin(), _lru, iter->second.lruIter);
+            return;
+        }
+    }
+    auto tmpl = make_shared<proto::TaskMsg>();
+    proto::makeTaskMsgTemplate(taskMsg, *tmpl);
+
+    lock_guard<mutex> lock(_mtx);
+    if (_templates.count(key) != 0) return;
+    _lru.push_front(key);
+    _templates[key] = Entry{tmpl, _lru.begin()};
+    while (_templates.size() > _maxEntries) {
+        _templates.erase(_lru.back());
+        _lru.pop_back();
+        ++_evictions;
+    }
+}
+
+bool TaskTemplateCache::expand(proto::TaskMsg& taskMsg) {
+    Key const key(taskMsg.czarid(), taskMsg.queryid(), taskMsg.templateid());
+    shared_ptr<proto::TaskMsg const> tmpl;
+    {
+        lock_guard<mutex> lock(_mtx);
+        auto iter = _templates.find(key);
+        if (iter == _templates.end()) {
+            ++_misses;
+            return false;
+        }
+        ++_hits;
+        _lru.splice(_lru.begin(), _lru, iter->second.lruIter);
+        tmpl = iter->second.tmpl;
+    }
+    try {
+        proto::expandTaskMsg(*tmpl, taskMsg);
+    } catch (proto::TaskMsgTemplateError const& ex) {
+        LOGS(_log, LOG_LVL_ERROR, "TaskMsg doesn't fit its template: " << ex.what());
+        return false;
+    }
+    return true;
+}
+
+size_t TaskTemplateCache::size() const {
+    lock_guard<mutex> lock(_mtx);
+    return _templates.size();
+}
+
+nlohmann::json TaskTemplateCache::statusToJson() const {
+    nlohmann::json status = nlohmann::json::object();
+    lock_guard<mutex> lock(_mtx);
+    status["maxEntries"] = _maxEntries;
+    status["entries"] = _templates.size();
+    status["hits"] = _hits;
+    status["misses"] = _misses;
+    status["evictions"] = _evictions;
+    return status;
+}
+
+}  // namespace lsst::qserv::wbase
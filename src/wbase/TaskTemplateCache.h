@@ -0,0 +1,92 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_WBASE_TASKTEMPLATECACHE_H
+#define LSST_QSERV_WBASE_TASKTEMPLATECACHE_H
+
+// System headers
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+// Third party headers
+#include "nlohmann/json.hpp"
+
+namespace lsst::qserv::proto {
+class TaskMsg;
+}  // namespace lsst::qserv::proto
+
+namespace lsst::qserv::wbase {
+
+/// TaskTemplateCache keeps the templates of the TaskMsgs sent by the czars
+/// (see TaskMsg.templateid), so that messages that only carry what differs
+/// between the jobs of a query can be completed. The least recently used
+/// templates are dropped first, the czar sends the complete message again
+/// when a worker refuses a message because its template is gone.
+class TaskTemplateCache {
+public:
+    using Ptr = std::shared_ptr<TaskTemplateCache>;
+
+    /// @param maxEntries - the most templates kept, 0 to keep none.
+    explicit TaskTemplateCache(size_t maxEntries) : _maxEntries(maxEntries) {}
+
+    TaskTemplateCache() = delete;
+    TaskTemplateCache(TaskTemplateCache const&) = delete;
+    TaskTemplateCache& operator=(TaskTemplateCache const&) = delete;
+
+    /// Keep the template of the complete message 'taskMsg', which must have a templateid.
+    void add(proto::TaskMsg const& taskMsg);
+
+    /// Complete 'taskMsg', a message without a db, from its template.
+    /// @return false if the template isn't known or doesn't fit the message.
+    bool expand(proto::TaskMsg& taskMsg);
+
+    /// @return the number of templates kept.
+    size_t size() const;
+
+    /// @return a JSON object with the counters of the cache.
+    nlohmann::json statusToJson() const;
+
+private:
+    /// czarid, queryid and templateid of a message.
+    using Key = std::tuple<uint32_t, uint64_t, uint64_t>;
+    using Lru = std::list<Key>;
+
+    struct Entry {
+        std::shared_ptr<proto::TaskMsg const> tmpl;
+        Lru::iterator lruIter;
+    };
+
+    size_t const _maxEntries;
+
+    mutable std::mutex _mtx;          ///< Protects all members below.
+    std::map<Key, Entry> _templates;  ///< Templates by key.
+    Lru _lru;                         ///< Keys, most recently used first.
+    uint64_t _hits = 0;
+    uint64_t _misses = 0;
+    uint64_t _evictions = 0;
+};
+
+}  // namespace lsst::qserv::wbase
+
+#endif  // LSST_QSERV_WBASE_TASKTEMPLATECACHE_H
@@ -34,10 +34,12 @@
 #include "global/debugUtil.h"
 #include "global/intTypes.h"
 #include "global/LogContext.h"
+#include "proto/ColumnarResult.h"
 #include "proto/ProtoHeaderWrap.h"
 #include "util/Bug.h"
 #include "util/MultiError.h"
-#include "util/StringHash.h"
+#include "wbase/ResultSpool.h"
+#include "wbase/RowSource.h"
 #include "wbase/Task.h"
 #include "xrdsvc/StreamBuffer.h"
 
@@ -45,12 +47,41 @@ using namespace std;
 
 namespace {
 LOG_LOGGER _log = LOG_GET("lsst.qserv.wbase.TransmitData");
+
+using lsst::qserv::proto::ColumnBlock;
+
+/// @return the column block encoding for values of the MySQL 'field'.
+/// Only numeric types whose text form can be restored exactly are stored
+/// in binary, everything else (DECIMAL, dates, strings, ...) is sent as-is.
+ColumnBlock::Encoding encodingFor(MYSQL_FIELD const& field) {
+    // ZEROFILL padding would be lost by the binary form.
+    if (field.flags & ZEROFILL_FLAG) return ColumnBlock::BYTES;
+    bool const isUnsigned = field.flags & UNSIGNED_FLAG;
+    switch (field.type) {
+        case MYSQL_TYPE_TINY:
+        case MYSQL_TYPE_SHORT:
+        case MYSQL_TYPE_LONG:
+        case MYSQL_TYPE_INT24:
+        case MYSQL_TYPE_LONGLONG:
+        case MYSQL_TYPE_YEAR:
+            return isUnsigned ? ColumnBlock::UINT64 : ColumnBlock::INT64;
+        case MYSQL_TYPE_DOUBLE:
+            return ColumnBlock::DOUBLE;
+        case MYSQL_TYPE_FLOAT:
+            return ColumnBlock::FLOAT;
+        default:
+            return ColumnBlock::BYTES;
+    }
 }
 
+}  // namespace
+
 namespace lsst::qserv::wbase {
 
 std::atomic<int> seqSource{0};
 
+string TransmitData::_workerId;
+
 TransmitData::TransmitData(qmeta::CzarId const& czarId_, shared_ptr<google::protobuf::Arena> const& arena,
                            std::string const& idStr)
         : _czarId(czarId_), _arena(arena), _idStr(idStr), _trSeq(seqSource++) {
@@ -58,6 +89,8 @@ TransmitData::TransmitData(qmeta::CzarId const& czarId_, shared_ptr<google::prot
     _result = _createResult();
 }
 
+TransmitData::~TransmitData() = default;
+
 TransmitData::Ptr TransmitData::createTransmitData(qmeta::CzarId const& czarId_, string const& idStr) {
     shared_ptr<google::protobuf::Arena> arena = make_shared<google::protobuf::Arena>();
     auto ptr = shared_ptr<TransmitData>(new TransmitData(czarId_, arena, idStr));
@@ -67,10 +100,12 @@ TransmitData::Ptr TransmitData::createTransmitData(qmeta::CzarId const& czarId_,
 /// Note: _trMtx must be held before calling this.
 proto::ProtoHeader* TransmitData::_createHeader() {
     proto::ProtoHeader* hdr = google::protobuf::Arena::CreateMessage<proto::ProtoHeader>(_arena.get());
-    hdr->set_protocol(2);  // protocol 2: row-by-row message
+    hdr->set_protocol(_protocol);  // protocol 2: row-by-row message, 3: column blocks
     hdr->set_size(0);
-    hdr->set_md5(util::StringHash::getMd5("", 0));
+    hdr->set_checksumtype(_checksumType);
+    hdr->set_md5(proto::ProtoHeaderWrap::getChecksum(_checksumType, "", 0));
     hdr->set_wname(getHostname());
+    if (!_workerId.empty()) hdr->set_wid(_workerId);
     hdr->set_largeresult(false);
     hdr->set_endnodata(true);
     return hdr;
@@ -140,6 +175,38 @@ string TransmitData::getHeaderString(uint32_t seq, int scsSeq) {
     return thisHeaderString;
 }
 
+bool TransmitData::spool(ResultSpool::Ptr const& spool) {
+    lock_guard<mutex> lock(_trMtx);
+    uint64_t offset = 0;
+    if (!spool->append(_dataMsg, offset)) return false;
+    _spool = spool;
+    _spoolOffset = offset;
+    _spoolSize = _dataMsg.size();
+    string().swap(_dataMsg);
+
+    // The rows of _result are in the spool now. Only the header is needed
+    // until the message is sent, so move it to a new arena to free the rows.
+    auto arena = make_shared<google::protobuf::Arena>();
+    auto header = google::protobuf::Arena::CreateMessage<proto::ProtoHeader>(arena.get());
+    header->CopyFrom(*_header);
+    auto result = google::protobuf::Arena::CreateMessage<proto::Result>(arena.get());
+    if (_result->has_errormsg()) result->set_errormsg(_result->errormsg());
+    _columnBuilder.reset();
+    _header = header;
+    _result = result;
+    _arena = arena;
+    return true;
+}
+
+bool TransmitData::unspool() {
+    lock_guard<mutex> lock(_trMtx);
+    if (_spool == nullptr) return true;
+    if (!_spool->read(_spoolOffset, _spoolSize, _dataMsg)) return false;
+    // Release the spool file once all of its messages have been read back.
+    _spool.reset();
+    return true;
+}
+
 xrdsvc::StreamBuffer::Ptr TransmitData::getStreamBuffer(Task::Ptr const& task) {
     lock_guard<mutex> lock(_trMtx);
     // createWithMove invalidates _dataMsg
@@ -151,8 +218,8 @@ void TransmitData::_buildHeader(bool largeResult) {
 
     // The size of the dataMsg must include space for the header for the next dataMsg.
     _header->set_size(_dataMsg.size() + proto::ProtoHeaderWrap::getProtoHeaderSize());
-    // The md5 hash must not include the header for the next dataMsg.
-    _header->set_md5(util::StringHash::getMd5(_dataMsg.data(), _dataMsg.size()));
+    // The checksum must not include the header for the next dataMsg.
+    _header->set_md5(proto::ProtoHeaderWrap::getChecksum(_checksumType, _dataMsg.data(), _dataMsg.size()));
     _header->set_largeresult(largeResult);
     _header->set_endnodata(false);
 }
@@ -179,12 +246,31 @@ void TransmitData::_buildDataMsg(Task const& task, bool largeResult, util::Multi
         LOGS(_log, LOG_LVL_ERROR, _idStr << "buildDataMsg adding " << msg);
     }
     _result->SerializeToString(&_dataMsg);
+    _compressDataMsg();
     // Build the header for this message, but this message can't be transmitted until the
     // next header has been built and appended to _transmitData->dataMsg. That happens
     // later in SendChannelShared.
     _buildHeader(largeResult);
 }
 
+void TransmitData::_compressDataMsg() {
+    _header->clear_codec();
+    _header->clear_rawsize();
+    if (_codec == proto::ProtoHeader::NONE || _dataMsg.size() < _compressMin) return;
+    string compressed;
+    if (!proto::ProtoHeaderWrap::compress(_codec, _dataMsg, compressed)) return;
+    // Incompressible data is sent as it is, the czar doesn't need to do anything.
+    if (compressed.size() >= _dataMsg.size()) {
+        LOGS(_log, LOG_LVL_TRACE,
+             _idStr << "not compressed size=" << _dataMsg.size() << " compressed=" << compressed.size());
+        return;
+    }
+    LOGS(_log, LOG_LVL_TRACE, _idStr << "compressed size=" << _dataMsg.size() << " to " << compressed.size());
+    _header->set_codec(_codec);
+    _header->set_rawsize(_dataMsg.size());
+    _dataMsg.swap(compressed);
+}
+
 void TransmitData::initResult(Task& task, std::vector<SchemaCol>& schemaCols) {
     lock_guard<mutex> lock(_trMtx);
     _result->set_queryid(task.getQueryId());
@@ -193,6 +279,17 @@ void TransmitData::initResult(Task& task, std::vector<SchemaCol>& schemaCols) {
     if (task.msg->has_session()) {
         _result->set_session(task.msg->session());
     }
+    if (task.msg->maxprotocol() >= proto::RESULT_PROTOCOL_COLUMNS) {
+        _protocol = proto::RESULT_PROTOCOL_COLUMNS;
+        _header->set_protocol(_protocol);
+    }
+    if (task.msg->resultchecksum() != _checksumType) {
+        _checksumType = task.msg->resultchecksum();
+        _header->set_checksumtype(_checksumType);
+        _header->set_md5(proto::ProtoHeaderWrap::getChecksum(_checksumType, "", 0));
+    }
+    _codec = task.msg->resultcodec();
+    _compressMin = task.msg->resultcompressmin();
     // If no queries have been run, schemaCols will be empty at this point.
     if (!schemaCols.empty()) {
         _addSchemaCols(schemaCols);
@@ -221,15 +318,18 @@ void TransmitData::_addSchemaCols(std::vector<SchemaCol>& schemaCols) {
     }
 }
 
-bool TransmitData::fillRows(MYSQL_RES* mResult, int numFields, size_t& sz) {
+bool TransmitData::fillRows(RowSource& rows, int numFields, size_t& sz) {
     lock_guard<mutex> lock(_trMtx);
-    MYSQL_ROW row;
+    if (_protocol == proto::RESULT_PROTOCOL_COLUMNS) {
+        return _fillColumns(rows, numFields, sz);
+    }
+    char const* const* row;
+    unsigned long const* lengths;
 
     unsigned int szLimit = std::min(proto::ProtoHeaderWrap::PROTOBUFFER_DESIRED_LIMIT,
                                     proto::ProtoHeaderWrap::PROTOBUFFER_HARD_LIMIT);
 
-    while ((row = mysql_fetch_row(mResult))) {
-        auto lengths = mysql_fetch_lengths(mResult);
+    while ((row = rows.nextRow(lengths))) {
         proto::RowBundle* rawRow = _result->add_row();
         for (int i = 0; i < numFields; ++i) {
             if (row[i]) {
@@ -253,9 +353,44 @@ bool TransmitData::fillRows(MYSQL_RES* mResult, int numFields, size_t& sz) {
     return true;
 }
 
+bool TransmitData::_fillColumns(RowSource& rows, int numFields, size_t& sz) {
+    if (_columnBuilder == nullptr) {
+        // All tasks sharing this object have the same schema, so the encodings
+        // from the first result apply to all of them.
+        MYSQL_FIELD const* fields = rows.getFields();
+        vector<ColumnBlock::Encoding> encodings;
+        for (int i = 0; i < numFields; ++i) {
+            encodings.push_back(encodingFor(fields[i]));
+        }
+        _columnBuilder = make_unique<proto::ColumnBlockBuilder>(*_result, encodings);
+    }
+    if (_columnBuilder->getColumnCount() != numFields) {
+        throw util::Bug(ERR_LOC, _idStr + " fillRows numFields=" + to_string(numFields) +
+                                         " does not match columns=" +
+                                         to_string(_columnBuilder->getColumnCount()));
+    }
+
+    unsigned int szLimit = std::min(proto::ProtoHeaderWrap::PROTOBUFFER_DESIRED_LIMIT,
+                                    proto::ProtoHeaderWrap::PROTOBUFFER_HARD_LIMIT);
+
+    char const* const* row;
+    unsigned long const* lengths;
+    while ((row = rows.nextRow(lengths))) {
+        _tSize += _columnBuilder->addRow(row, lengths);
+        sz = _tSize;
+        ++_rowCount;
+
+        // Break the loop if the result is too big so this part can be transmitted.
+        if (_tSize > szLimit) {
+            return false;
+        }
+    }
+    return true;
+}
+
 int TransmitData::getResultSize() const {
     lock_guard<mutex> lock(_trMtx);
-    return _dataMsg.size();
+    return (_spool != nullptr) ? _spoolSize : _dataMsg.size();
 }
 
 int TransmitData::getResultRowCount() const {
@@ -271,6 +406,9 @@ string TransmitData::_dump() const {
         str += "nullptr";
     }
     str += " res=" + to_string(_dataMsg.size());
+    if (_spool != nullptr) {
+        str += " spooled=" + to_string(_spoolSize);
+    }
     return str;
 }
 
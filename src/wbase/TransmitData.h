@@ -37,6 +37,10 @@ namespace google::protobuf {
 class Arena;
 }  // namespace google::protobuf
 
+namespace lsst::qserv::proto {
+class ColumnBlockBuilder;
+}  // namespace lsst::qserv::proto
+
 // This header declarations
 namespace lsst::qserv {
 
@@ -50,6 +54,8 @@ class StreamBuffer;
 
 namespace wbase {
 
+class ResultSpool;
+class RowSource;
 class Task;
 
 /// This class stores properties for one column in the schema.
@@ -74,11 +80,20 @@ public:
     TransmitData() = delete;
     TransmitData(TransmitData const&) = delete;
     TransmitData& operator=(TransmitData const&) = delete;
+    ~TransmitData();
 
     /// Create a transmitData object
     static Ptr createTransmitData(qmeta::CzarId const& czarId_, std::string const& idStr);
 
-    /// Initialize the result.
+    /// Set the id of this worker, which is put in every header so the czar
+    /// learns where chunks are. This must be called before any TransmitData
+    /// object is created.
+    static void setWorkerId(std::string const& workerId) { _workerId = workerId; }
+
+    /// Initialize the result. If the czar accepts column-based results
+    /// (TaskMsg.maxprotocol >= 3), rows will be stored in column blocks.
+    /// If the czar requested a codec (TaskMsg.resultcodec), messages of at
+    /// least TaskMsg.resultcompressmin bytes will be compressed.
     void initResult(Task& task, std::vector<SchemaCol>& schemaCols);
 
     /// @return a string representation of this transmit object's header
@@ -94,6 +109,17 @@ public:
     ///    origin of messages on the czar.
     void attachNextHeader(TransmitData::Ptr const& nextTr, bool reallyLast, uint32_t seq, int scsSeq);
 
+    /// Move the message built by buildDataMsg() to 'spool', and free the
+    /// memory holding its rows until unspool() reads it back.
+    /// @return false if the message could not be spooled, in which case it
+    ///         remains in memory.
+    bool spool(std::shared_ptr<ResultSpool> const& spool);
+
+    /// Read a spooled message back into memory, this must be done before
+    /// attachNextHeader() is called. Nothing is done if the message wasn't spooled.
+    /// @return false if the message could not be read.
+    bool unspool();
+
     /// @return a StreamBuffer object containing what was in _dataMsg.
     /// Note: this function invalidates _dataMsg.
     std::shared_ptr<xrdsvc::StreamBuffer> getStreamBuffer(std::shared_ptr<Task> const& task);
@@ -103,19 +129,20 @@ public:
 
     qmeta::CzarId getCzarId() const { return _czarId; }
 
-    /// Fill one row in the _result msg from one row in MYSQL_RES* 'mResult'
+    /// Fill one row in the _result msg from one row in 'rows'
     /// If the message has gotten larger than the desired message size,
     /// return false.
-    /// @return false if there ARE MORE ROWS left in mResult.
-    ///         true if there are no more rows remaining in mResult.
-    bool fillRows(MYSQL_RES* mResult, int numFields, size_t& sz);
+    /// @return false if there ARE MORE ROWS left in 'rows'.
+    ///         true if there are no more rows remaining in 'rows'.
+    bool fillRows(RowSource& rows, int numFields, size_t& sz);
 
     /// Add the schema to this TransmitData object.
     /// The schema is always the same for a query, so it will only be added the
     /// first time this function is called for the instance.
     void addSchemaCols(std::vector<SchemaCol>& schemaCols);
 
-    /// Use the information collected in _result and multiErr to build _dataMsg.
+    /// Use the information collected in _result and multiErr to build _dataMsg,
+    /// which is compressed if the czar asked for it and it's worth it.
     void buildDataMsg(Task const& task, bool largeResult, util::MultiError& multiErr);
 
     /// @return true if tData has an error message in _result.
@@ -154,10 +181,19 @@ private:
     /// Note: _trMtx must be held before calling this.
     void _buildDataMsg(Task const& task, bool largeResult, util::MultiError& multiErr);
 
+    /// Replace _dataMsg with its compressed form and record the codec in _header,
+    /// if the czar asked for a codec, _dataMsg is large enough, and it shrinks.
+    /// Note: _trMtx must be held before calling this.
+    void _compressDataMsg();
+
     ////////////////////////////////////////////////////
     // Methods used by QueryRunner to build dataMsg
     void _buildHeader(bool largeResult);
 
+    /// @see fillRows, this version adds the rows to column blocks (protocol 3).
+    /// Note: _trMtx must be held before calling this.
+    bool _fillColumns(RowSource& rows, int numFields, size_t& sz);
+
     /// @see addSchemaCols
     /// Note: _trMtx must be held before calling this.
     void _addSchemaCols(std::vector<SchemaCol>& schemaCols);
@@ -173,6 +209,11 @@ private:
     /// Serialized string for result that is appended with wrapped string for headerNext.
     std::string _dataMsg;
 
+    /// The spool holding _dataMsg, if it was spooled, see spool().
+    std::shared_ptr<ResultSpool> _spool;
+    uint64_t _spoolOffset = 0;  ///< Position of _dataMsg in _spool.
+    size_t _spoolSize = 0;      ///< Size of _dataMsg in _spool.
+
     qmeta::CzarId const _czarId;
 
     mutable std::mutex _trMtx;                ///< Protects all private member variables.
@@ -180,6 +221,14 @@ private:
 
     unsigned int _rowCount = 0;  ///< Number of rows in the _result so far.
     size_t _tSize = 0;           ///< Approximate number of bytes in the _result so far.
+    int _protocol = 2;           ///< Result protocol, 3 if rows are stored in column blocks.
+    proto::ProtoHeader::ChecksumType _checksumType = proto::ProtoHeader::MD5;  ///< As requested by czar.
+    proto::ProtoHeader::Codec _codec = proto::ProtoHeader::NONE;  ///< As requested by czar.
+    size_t _compressMin = 0;  ///< Messages smaller than this are not compressed.
+
+    /// Builds the column blocks of _result for protocol 3, created by the first
+    /// call to fillRows().
+    std::unique_ptr<proto::ColumnBlockBuilder> _columnBuilder;
 
     /// Create a result using our arena.
     /// This does not set the 'result' member of this object for consistency.
@@ -192,6 +241,8 @@ private:
     int const _trSeq;  ///< Identifier for this object, used for debugging.
 
     std::shared_ptr<util::InstanceCount> _icPtr;  // LockupDB
+
+    static std::string _workerId;  ///< @see setWorkerId()
 };
 
 }  // namespace wbase
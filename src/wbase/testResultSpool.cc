@@ -0,0 +1,118 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// System headers
+#include <cstdlib>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Qserv headers
+#include "wbase/ResultSpool.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE ResultSpool_1
+#include <boost/test/unit_test.hpp>
+
+namespace test = boost::test_tools;
+
+using lsst::qserv::wbase::ResultSpool;
+
+struct Fixture {
+    Fixture() {
+        char tmpl[] = "/tmp/testResultSpool-XXXXXX";
+        BOOST_REQUIRE(mkdtemp(tmpl) != nullptr);
+        dir = tmpl;
+    }
+    ~Fixture() {
+        ResultSpool::setup("", 0, 0);
+        rmdir(dir.c_str());
+    }
+
+    std::string dir;
+};
+
+BOOST_FIXTURE_TEST_SUITE(Suite, Fixture)
+
+BOOST_AUTO_TEST_CASE(Disabled) {
+    ResultSpool::setup("", 1000, 1000);
+    BOOST_CHECK(!ResultSpool::isEnabled());
+    BOOST_CHECK(ResultSpool::create("QID1#1") == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(AppendRead) {
+    ResultSpool::setup(dir, 1000, 1000);
+    BOOST_REQUIRE(ResultSpool::isEnabled());
+    auto spool = ResultSpool::create("QID1#1");
+    BOOST_REQUIRE(spool != nullptr);
+    // The file is unlinked as soon as it's created.
+    BOOST_CHECK(rmdir(dir.c_str()) == 0);
+    BOOST_REQUIRE(mkdir(dir.c_str(), 0700) == 0);
+
+    std::string const first("first message");
+    std::string const second(std::string("second\0message", 14));
+    uint64_t firstOffset = 1;
+    uint64_t secondOffset = 0;
+    BOOST_REQUIRE(spool->append(first, firstOffset));
+    BOOST_REQUIRE(spool->append(second, secondOffset));
+    BOOST_CHECK_EQUAL(firstOffset, 0u);
+    BOOST_CHECK_EQUAL(secondOffset, first.size());
+    BOOST_CHECK_EQUAL(spool->getSize(), first.size() + second.size());
+    BOOST_CHECK_EQUAL(ResultSpool::getTotalBytes(), spool->getSize());
+
+    std::string data;
+    BOOST_REQUIRE(spool->read(secondOffset, second.size(), data));
+    BOOST_CHECK_EQUAL(data, second);
+    BOOST_REQUIRE(spool->read(firstOffset, first.size(), data));
+    BOOST_CHECK_EQUAL(data, first);
+    // Nothing was written past the end.
+    BOOST_CHECK(!spool->read(secondOffset, second.size() + 1, data));
+
+    spool.reset();
+    BOOST_CHECK_EQUAL(ResultSpool::getTotalBytes(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(Limits) {
+    ResultSpool::setup(dir, 10, 15);
+    auto a = ResultSpool::create("QID1#1");
+    auto b = ResultSpool::create("QID1#2");
+    BOOST_REQUIRE(a != nullptr && b != nullptr);
+    uint64_t offset = 0;
+    BOOST_CHECK(a->append("12345678", offset));
+    // Over the limit for one file.
+    BOOST_CHECK(!a->append("123", offset));
+    BOOST_CHECK_EQUAL(a->getSize(), 8u);
+    // Over the limit for all files.
+    BOOST_CHECK(!b->append("12345678", offset));
+    BOOST_CHECK(b->append("1234567", offset));
+    BOOST_CHECK_EQUAL(ResultSpool::getTotalBytes(), 15u);
+
+    // Closing a file makes room for the others.
+    a.reset();
+    BOOST_CHECK(b->append("123", offset));
+    BOOST_CHECK_EQUAL(offset, 7u);
+    auto const status = ResultSpool::statusToJson();
+    BOOST_CHECK_EQUAL(status["totalBytes"].get<uint64_t>(), 10u);
+    BOOST_CHECK_EQUAL(status["appendsRefused"].get<uint64_t>(), 2u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
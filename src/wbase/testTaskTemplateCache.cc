@@ -0,0 +1,124 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// System headers
+#include <cstdint>
+#include <string>
+
+// Qserv headers
+#include "proto/TaskMsgTemplate.h"
+#include "proto/worker.pb.h"
+#include "wbase/TaskTemplateCache.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE TaskTemplateCache_1
+#include <boost/test/unit_test.hpp>
+
+namespace test = boost::test_tools;
+
+using namespace lsst::qserv;
+
+namespace {
+
+/// @return a complete message for 'chunkId' of query 'queryId'.
+proto::TaskMsg makeMsg(uint64_t queryId, int chunkId, uint64_t templateId = 99) {
+    proto::TaskMsg taskMsg;
+    taskMsg.set_db("LSST");
+    taskMsg.set_queryid(queryId);
+    taskMsg.set_czarid(1);
+    taskMsg.set_jobid(chunkId);
+    taskMsg.set_attemptcount(0);
+    taskMsg.set_chunkid(chunkId);
+    taskMsg.set_scaninteractive(false);
+    taskMsg.set_templateid(templateId);
+    auto fragment = taskMsg.add_fragment();
+    fragment->add_query("SELECT COUNT(*) FROM LSST.Object_%C\007C%");
+    fragment->set_resulttable("r_1");
+    return taskMsg;
+}
+
+/// @return the compact form of the message for 'chunkId' of query 'queryId'.
+proto::TaskMsg makeCompactMsg(uint64_t queryId, int chunkId, uint64_t templateId = 99) {
+    proto::TaskMsg taskMsg;
+    taskMsg.set_queryid(queryId);
+    taskMsg.set_czarid(1);
+    taskMsg.set_jobid(chunkId);
+    taskMsg.set_attemptcount(0);
+    taskMsg.set_chunkid(chunkId);
+    taskMsg.set_templateid(templateId);
+    return taskMsg;
+}
+
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(Expand) {
+    wbase::TaskTemplateCache cache(10);
+    auto compact = makeCompactMsg(1, 12);
+    BOOST_REQUIRE(proto::isCompactTaskMsg(compact));
+    BOOST_CHECK(!cache.expand(compact));
+
+    cache.add(makeMsg(1, 11));
+    cache.add(makeMsg(1, 11));
+    BOOST_CHECK_EQUAL(cache.size(), 1u);
+    BOOST_REQUIRE(cache.expand(compact));
+    BOOST_CHECK(!proto::isCompactTaskMsg(compact));
+    BOOST_CHECK_EQUAL(compact.SerializeAsString(), makeMsg(1, 12).SerializeAsString());
+
+    // The template belongs to one query, with one id.
+    auto otherQuery = makeCompactMsg(2, 12);
+    BOOST_CHECK(!cache.expand(otherQuery));
+    auto otherTemplate = makeCompactMsg(1, 12, 98);
+    BOOST_CHECK(!cache.expand(otherTemplate));
+
+    // The fragments must fit the template.
+    auto wrongFragments = makeCompactMsg(1, 13);
+    wrongFragments.add_fragment();
+    wrongFragments.add_fragment();
+    BOOST_CHECK(!cache.expand(wrongFragments));
+
+    auto const status = cache.statusToJson();
+    BOOST_CHECK_EQUAL(status["hits"].get<uint64_t>(), 2u);
+    BOOST_CHECK_EQUAL(status["misses"].get<uint64_t>(), 3u);
+}
+
+BOOST_AUTO_TEST_CASE(Eviction) {
+    wbase::TaskTemplateCache cache(2);
+    cache.add(makeMsg(1, 11));
+    cache.add(makeMsg(2, 11));
+    auto compact = makeCompactMsg(1, 12);
+    BOOST_CHECK(cache.expand(compact));  // query 2 is now the least recently used
+    cache.add(makeMsg(3, 11));
+    BOOST_CHECK_EQUAL(cache.size(), 2u);
+    auto query1 = makeCompactMsg(1, 13);
+    BOOST_CHECK(cache.expand(query1));
+    auto query2 = makeCompactMsg(2, 13);
+    BOOST_CHECK(!cache.expand(query2));
+    BOOST_CHECK_EQUAL(cache.statusToJson()["evictions"].get<uint64_t>(), 1u);
+
+    wbase::TaskTemplateCache disabled(0);
+    disabled.add(makeMsg(1, 11));
+    BOOST_CHECK_EQUAL(disabled.size(), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -47,9 +47,12 @@ WorkerConfig::WorkerConfig(const util::ConfigStore& configStore)
         : _memManClass(configStore.get("memman.class", "MemManReal")),
           _memManSizeMb(configStore.getInt("memman.memory", 1000)),
           _memManLocation(configStore.getRequired("memman.location")),
+          _memManPrefetchChunks(configStore.getInt("memman.prefetch_chunks", 2)),
+          _memManHugePages(configStore.getInt("memman.huge_pages", 0) != 0),
           _threadPoolSize(
                   configStore.getInt("scheduler.thread_pool_size", wsched::BlendScheduler::getMinPoolSize())),
           _maxPoolThreads(configStore.getInt("scheduler.max_pool_threads", 5000)),
+          _workStealingBatch(configStore.getInt("scheduler.work_stealing_batch", 0)),
           _maxGroupSize(configStore.getInt("scheduler.group_size", 1)),
           _requiredTasksCompleted(configStore.getInt("scheduler.required_tasks_completed", 25)),
           _prioritySlow(configStore.getInt("scheduler.priority_slow", 2)),
@@ -64,6 +67,11 @@ WorkerConfig::WorkerConfig(const util::ConfigStore& configStore)
           _maxActiveChunksSnail(configStore.getInt("scheduler.maxactivechunks_snail", 1)),
           _maxActiveChunksMed(configStore.getInt("scheduler.maxactivechunks_med", 4)),
           _maxActiveChunksFast(configStore.getInt("scheduler.maxactivechunks_fast", 4)),
+          _chunkOrderSlow(configStore.get("scheduler.chunkorder_slow", "CHUNK_ID")),
+          _chunkOrderSnail(configStore.get("scheduler.chunkorder_snail", "CHUNK_ID")),
+          _chunkOrderMed(configStore.get("scheduler.chunkorder_med", "CHUNK_ID")),
+          _chunkOrderFast(configStore.get("scheduler.chunkorder_fast", "CHUNK_ID")),
+          _chunkOrderMaxPassedOver(configStore.getInt("scheduler.chunkorder_maxpassedover", 50)),
           _scanMaxMinutesFast(configStore.getInt("scheduler.scanmaxminutes_fast", 60)),
           _scanMaxMinutesMed(configStore.getInt("scheduler.scanmaxminutes_med", 60 * 8)),
           _scanMaxMinutesSlow(configStore.getInt("scheduler.scanmaxminutes_slow", 60 * 12)),
@@ -74,7 +82,15 @@ WorkerConfig::WorkerConfig(const util::ConfigStore& configStore)
                   configStore.getInt("sqlconnections.reservedinteractivesqlconn", 50)),
           _bufferMaxTotalGB(configStore.getInt("transmit.buffermaxtotalgb", 41)),
           _maxTransmits(configStore.getInt("transmit.maxtransmits", 40)),
-          _maxPerQid(configStore.getInt("transmit.maxperqid", 3)) {
+          _maxPerQid(configStore.getInt("transmit.maxperqid", 3)),
+          _resultSpoolDir(configStore.get("resultspool.dir", "")),
+          _resultSpoolMaxMB(configStore.getInt("resultspool.maxmb", 2000)),
+          _resultSpoolMaxTotalGB(configStore.getInt("resultspool.maxtotalgb", 100)),
+          _sharedScanWindowMs(configStore.getInt("sharedscan.windowms", 0)),
+          _sharedScanMaxQueries(configStore.getInt("sharedscan.maxqueries", 16)),
+          _sharedScanMaxMB(configStore.getInt("sharedscan.maxmb", 200)),
+          _subChunkCacheMaxMB(configStore.getInt("subchunkcache.maxmb", 0)),
+          _templateCacheMaxEntries(configStore.getInt("templatecache.maxentries", 1000)) {
     int mysqlPort = configStore.getInt("mysql.port");
     std::string mysqlSocket = configStore.get("mysql.socket");
     if (mysqlPort == 0 && mysqlSocket.empty()) {
@@ -91,8 +107,11 @@ std::ostream& operator<<(std::ostream& out, WorkerConfig const& workerConfig) {
     out << "MemManClass=" << workerConfig._memManClass;
     if (workerConfig._memManClass == "MemManReal") {
         out << "MemManSizeMb=" << workerConfig._memManSizeMb;
+        out << " MemManPrefetchChunks=" << workerConfig._memManPrefetchChunks;
+        out << " MemManHugePages=" << workerConfig._memManHugePages;
     }
     out << " poolSize=" << workerConfig._threadPoolSize << ", maxGroupSize=" << workerConfig._maxGroupSize;
+    out << " workStealingBatch=" << workerConfig._workStealingBatch;
     out << " requiredTasksCompleted=" << workerConfig._requiredTasksCompleted;
 
     out << " priority fast=" << workerConfig._priorityFast << " med=" << workerConfig._priorityMed
@@ -101,6 +120,9 @@ std::ostream& operator<<(std::ostream& out, WorkerConfig const& workerConfig) {
     out << " Reserved threads fast=" << workerConfig._maxReserveFast << " med=" << workerConfig._maxReserveMed
         << " slow=" << workerConfig._maxReserveSlow;
 
+    out << " chunk order fast=" << workerConfig._chunkOrderFast << " med=" << workerConfig._chunkOrderMed
+        << " slow=" << workerConfig._chunkOrderSlow << " snail=" << workerConfig._chunkOrderSnail;
+
     return out;
 }
 
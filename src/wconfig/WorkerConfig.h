@@ -68,6 +68,13 @@ public:
      */
     unsigned int getMaxPoolThreads() const { return _maxPoolThreads; }
 
+    /* Get the most Tasks a thread of the pool takes from the scheduler at once,
+     * to share with the idle threads of the pool.
+     *
+     * @return the batch size, 0 if the threads of the pool all wait on the scheduler.
+     */
+    unsigned int getWorkStealingBatch() const { return _workStealingBatch; }
+
     /* Get required number of completed tasks for table in a chunk for the average to be valid.
      *
      * @return required tasks completed before average time is valid.
@@ -152,6 +159,18 @@ public:
      */
     uint64_t getMemManSizeMb() const { return _memManSizeMb; }
 
+    /* Get the number of chunks to read ahead of the chunk being scanned
+     *
+     * @return number of chunks to prefetch, 0 if disabled
+     */
+    int getMemManPrefetchChunks() const { return _memManPrefetchChunks; }
+
+    /* Get whether the Memory Manager should ask for huge pages
+     *
+     * @return true if mapped tables should be backed by transparent huge pages
+     */
+    bool getMemManHugePages() const { return _memManHugePages; }
+
     /* Get MySQL configuration for worker MySQL instance
      *
      * @return a structure containing MySQL parameters
@@ -206,6 +225,17 @@ public:
      */
     unsigned int getMaxActiveChunksSnail() const { return _maxActiveChunksSnail; }
 
+    /// @return the wsched::ChunkOrder policy of the fast shared scan.
+    std::string const& getChunkOrderFast() const { return _chunkOrderFast; }
+    /// @return the wsched::ChunkOrder policy of the medium shared scan.
+    std::string const& getChunkOrderMed() const { return _chunkOrderMed; }
+    /// @return the wsched::ChunkOrder policy of the slow shared scan.
+    std::string const& getChunkOrderSlow() const { return _chunkOrderSlow; }
+    /// @return the wsched::ChunkOrder policy of the snail shared scan.
+    std::string const& getChunkOrderSnail() const { return _chunkOrderSnail; }
+    /// @return how many times a chunk may be passed over before it is scanned, 0 for no limit.
+    unsigned int getChunkOrderMaxPassedOver() const { return _chunkOrderMaxPassedOver; }
+
     /// @return the maximum number of SQL connections for tasks.
     unsigned int getMaxSqlConnections() const { return _maxSqlConnections; }
     /// @return the number of SQL connections reserved for interactive tasks.
@@ -219,6 +249,29 @@ public:
 
     int getMaxPerQid() const { return _maxPerQid; }
 
+    /// @return the directory for result spool files, empty if results are not spooled.
+    std::string const& getResultSpoolDir() const { return _resultSpoolDir; }
+    /// @return the maximum number of megabytes in one result spool file.
+    unsigned int getResultSpoolMaxMB() const { return _resultSpoolMaxMB; }
+    /// @return the maximum number of gigabytes in all result spool files.
+    unsigned int getResultSpoolMaxTotalGB() const { return _resultSpoolMaxTotalGB; }
+
+    /// @return how long, in milliseconds, a shared scan waits for queries to join,
+    ///         0 if table scans are not shared.
+    unsigned int getSharedScanWindowMs() const { return _sharedScanWindowMs; }
+    /// @return the maximum number of queries reading their rows in one shared scan.
+    unsigned int getSharedScanMaxQueries() const { return _sharedScanMaxQueries; }
+    /// @return the maximum number of megabytes of rows buffered for one query of a shared scan.
+    unsigned int getSharedScanMaxMB() const { return _sharedScanMaxMB; }
+
+    /// @return the maximum number of megabytes of unused subchunk tables to keep,
+    ///         0 if they are dropped as soon as they are not needed.
+    unsigned int getSubChunkCacheMaxMB() const { return _subChunkCacheMaxMB; }
+
+    /// @return the most TaskMsg templates kept for messages that only carry
+    ///         what differs between the jobs of a query, 0 to keep none.
+    unsigned int getTemplateCacheMaxEntries() const { return _templateCacheMaxEntries; }
+
     /** Overload output operator for current class
      *
      * @param out
@@ -235,9 +288,12 @@ private:
     std::string const _memManClass;
     uint64_t const _memManSizeMb;
     std::string const _memManLocation;
+    int const _memManPrefetchChunks;
+    bool const _memManHugePages;
 
     unsigned int const _threadPoolSize;
     unsigned int const _maxPoolThreads;
+    unsigned int const _workStealingBatch;
     unsigned int const _maxGroupSize;
     unsigned int const _requiredTasksCompleted;
 
@@ -256,6 +312,12 @@ private:
     unsigned int const _maxActiveChunksMed;
     unsigned int const _maxActiveChunksFast;
 
+    std::string const _chunkOrderSlow;
+    std::string const _chunkOrderSnail;
+    std::string const _chunkOrderMed;
+    std::string const _chunkOrderFast;
+    unsigned int const _chunkOrderMaxPassedOver;
+
     unsigned int const _scanMaxMinutesFast;
     unsigned int const _scanMaxMinutesMed;
     unsigned int const _scanMaxMinutesSlow;
@@ -267,6 +329,14 @@ private:
     unsigned int const _bufferMaxTotalGB;
     unsigned int const _maxTransmits;
     int const _maxPerQid;
+    std::string const _resultSpoolDir;
+    unsigned int const _resultSpoolMaxMB;
+    unsigned int const _resultSpoolMaxTotalGB;
+    unsigned int const _sharedScanWindowMs;
+    unsigned int const _sharedScanMaxQueries;
+    unsigned int const _sharedScanMaxMB;
+    unsigned int const _subChunkCacheMaxMB;
+    unsigned int const _templateCacheMaxEntries;
 };
 
 }  // namespace lsst::qserv::wconfig
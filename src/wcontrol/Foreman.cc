@@ -38,6 +38,7 @@
 
 // Qserv headers
 #include "global/UnsupportedError.h"
+#include "memman/MemMan.h"
 #include "mysql/MySqlConfig.h"
 #include "proto/worker.pb.h"
 #include "wbase/Base.h"
@@ -48,6 +49,7 @@
 #include "wcontrol/WorkerStats.h"
 #include "wdb/ChunkResource.h"
 #include "wdb/QueryRunner.h"
+#include "wdb/SharedScan.h"
 
 namespace {
 LOG_LOGGER _log = LOG_GET("lsst.qserv.wcontrol.Foreman");
@@ -59,21 +61,33 @@ namespace lsst::qserv::wcontrol {
 
 Foreman::Foreman(Scheduler::Ptr const& scheduler, unsigned int poolSize, unsigned int maxPoolThreads,
                  mysql::MySqlConfig const& mySqlConfig, wpublish::QueriesAndChunks::Ptr const& queries,
-                 wcontrol::SqlConnMgr::Ptr const& sqlConnMgr)
-
-        : _scheduler(scheduler), _mySqlConfig(mySqlConfig), _queries(queries), _sqlConnMgr(sqlConnMgr) {
+                 wcontrol::SqlConnMgr::Ptr const& sqlConnMgr, shared_ptr<memman::MemMan> const& memMan,
+                 uint64_t subChunkCacheMaxBytes, unsigned int workStealingBatch)
+
+        : _scheduler(scheduler),
+          _mySqlConfig(mySqlConfig),
+          _queries(queries),
+          _sqlConnMgr(sqlConnMgr),
+          _memMan(memMan) {
     // Make the chunk resource mgr
     // Creating backend makes a connection to the database for making temporary tables.
     // It will delete temporary tables that it can identify as being created by a worker.
     // Previous instances of the worker will terminate when they try to use or create temporary tables.
     // Previous instances of the worker should be terminated before a new worker is started.
     _backend = make_shared<wdb::SQLBackend>(_mySqlConfig);
-    _chunkResourceMgr = wdb::ChunkResourceMgr::newMgr(_backend);
+    _chunkResourceMgr = wdb::ChunkResourceMgr::newMgr(_backend, subChunkCacheMaxBytes, _memMan);
 
     assert(_scheduler);  // Cannot operate without scheduler.
 
-    LOGS(_log, LOG_LVL_DEBUG, "poolSize=" << poolSize << " maxPoolThreads=" << maxPoolThreads);
-    _pool = util::ThreadPool::newThreadPool(poolSize, maxPoolThreads, _scheduler);
+    LOGS(_log, LOG_LVL_DEBUG,
+         "poolSize=" << poolSize << " maxPoolThreads=" << maxPoolThreads
+                     << " workStealingBatch=" << workStealingBatch);
+    if (workStealingBatch > 0) {
+        _pool = util::ThreadPool::newWorkStealingPool(poolSize, maxPoolThreads, _scheduler,
+                                                      workStealingBatch);
+    } else {
+        _pool = util::ThreadPool::newThreadPool(poolSize, maxPoolThreads, _scheduler);
+    }
 
     _workerCommandQueue = make_shared<util::CommandQueue>();
     _workerCommandPool = util::ThreadPool::newThreadPool(poolSize, _workerCommandQueue);
@@ -144,6 +158,14 @@ nlohmann::json Foreman::statusToJson() {
     nlohmann::json status;
     status["queries"] = _queries->statusToJson();
     status["sql_conn_mgr"] = _sqlConnMgr->statusToJson();
+    status["subchunk_cache"] = _chunkResourceMgr->statusToJson();
+    status["shared_scan"] = wdb::SharedScan::statusToJson();
+    if (_memMan != nullptr) {
+        status["memman"] = _memMan->statusToJson();
+    }
+    if (auto stealingQueue = _pool->getWorkStealingQueue()) {
+        status["work_stealing"] = stealingQueue->statusToJson();
+    }
     return status;
 }
 
@@ -36,6 +36,10 @@
 #include "wpublish/QueriesAndChunks.h"
 
 // Forward declarations
+namespace lsst::qserv::memman {
+class MemMan;
+}  // namespace lsst::qserv::memman
+
 namespace lsst::qserv::wdb {
 class SQLBackend;
 class ChunkResourceMgr;
@@ -74,10 +78,17 @@ public:
      * @param poolSize    - size of the thread pool
      * @param mySqlConfig - configuration object for the MySQL service
      * @param queries     - query statistics collector
+     * @param sqlConnMgr  - limits the number of MySQL connections used for tasks
+     * @param memMan      - memory manager, reports its status and accounts for cached subchunk tables
+     * @param subChunkCacheMaxBytes - memory unused subchunk tables may keep, 0 to drop them
+     * @param workStealingBatch - most Tasks a pool thread takes from the scheduler at once,
+     *                            0 for a pool of threads all waiting on the scheduler
      */
     Foreman(Scheduler::Ptr const& scheduler, unsigned int poolSize, unsigned int maxPoolThreads,
             mysql::MySqlConfig const& mySqlConfig, wpublish::QueriesAndChunks::Ptr const& queries,
-            std::shared_ptr<wcontrol::SqlConnMgr> const& sqlConnMgr);
+            std::shared_ptr<wcontrol::SqlConnMgr> const& sqlConnMgr,
+            std::shared_ptr<memman::MemMan> const& memMan = nullptr, uint64_t subChunkCacheMaxBytes = 0,
+            unsigned int workStealingBatch = 0);
 
     virtual ~Foreman();
 
@@ -114,6 +125,9 @@ private:
 
     /// For limiting the number of MySQL connections used for tasks.
     std::shared_ptr<wcontrol::SqlConnMgr> _sqlConnMgr;
+
+    /// The memory manager used by the schedulers, may be nullptr.
+    std::shared_ptr<memman::MemMan> _memMan;
 };
 
 }  // namespace lsst::qserv::wcontrol
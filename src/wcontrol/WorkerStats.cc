@@ -30,6 +30,7 @@
 // qserv headers
 #include "util/Bug.h"
 #include "util/Histogram.h"
+#include "wbase/ResultSpool.h"
 
 // LSST headers
 #include "lsst/log/Log.h"
@@ -110,6 +111,7 @@ nlohmann::json WorkerStats::getSendStatsJson() const {
     js["XrootdOwnedBuffers"] = _histXrootdOwnedBuffers->getJson();
     js["SendQueueWaitTime"] = _histSendQueueWaitTime->getJson();
     js["SendXrootdTime"] = _histSendXrootdTime->getJson();
+    js["ResultSpool"] = wbase::ResultSpool::statusToJson();
     return js;
 }
 
@@ -33,8 +33,11 @@
 #include "wdb/ChunkResource.h"
 
 // System headers
+#include <algorithm>
 #include <cstddef>
+#include <list>
 #include <mutex>
+#include <tuple>
 
 // Third-party headers
 #include "boost/format.hpp"
@@ -44,6 +47,7 @@
 
 // Qserv headers
 #include "global/constants.h"
+#include "memman/MemMan.h"
 #include "sql/SqlResults.h"
 #include "util/Bug.h"
 #include "util/IterableFormatter.h"
@@ -149,6 +153,201 @@ std::ostream& operator<<(std::ostream& os, const SQLBackend::LockStatus& ls) {
     return os;
 }
 
+/// SubChunkCache keeps subchunk tables that are no longer used by anyone, so
+/// that queries arriving later on the same subchunks don't have to build them
+/// again. The least recently used tables are dropped first when the memory
+/// used by the cached tables goes over the limit, or when memman can't reserve
+/// the memory for them.
+/// Each table is kept with the version of the chunk tables it was built from,
+/// see SQLBackend::getVersions(). A cached table is only used again if the
+/// chunk tables still have the same version, so that tables built before the
+/// chunk was ingested into, or removed and replicated again, aren't used.
+/// ChunkResourceMgr::_mapMutex must be held when calling any of its methods.
+class SubChunkCache {
+public:
+    /// chunkId, db, table, subChunkId
+    using Key = std::tuple<int, std::string, std::string, int>;
+
+    /// Every table is assumed to use at least this much, so that tables of
+    /// unknown size can't fill the cache.
+    static constexpr uint64_t minTableBytes = 16 * 1024;
+
+    SubChunkCache(uint64_t maxBytes, std::shared_ptr<memman::MemMan> const& memMan)
+            : _maxBytes(maxBytes), _memMan(memMan) {}
+
+    ~SubChunkCache() { _releaseBytes(_bytesCached); }
+
+    /// @return true if tables are kept after they are released.
+    bool isEnabled() const { return _maxBytes != 0; }
+
+    /// Find the tables in 'needed' that are cached, they are in use again.
+    /// @param versions - the current versions of the chunk tables for each
+    ///                   element of 'needed'.
+    /// @param stale - set to the cached tables that were built from an older
+    ///                version of the chunk tables, they must be dropped.
+    /// @param missingVersions - set to the versions for the returned tables.
+    /// @return the tables that are not cached, or are stale, and must be built.
+    ScTableVector take(ScTableVector const& needed, std::vector<std::string> const& versions,
+                       ScTableVector& stale, std::vector<std::string>& missingVersions) {
+        if (_maxBytes == 0) return needed;
+        ScTableVector missing;
+        for (size_t j = 0; j < needed.size(); ++j) {
+            auto const& scTbl = needed[j];
+            std::string const version = j < versions.size() ? versions[j] : std::string();
+            auto it = _cached.find(_key(scTbl));
+            if (it != _cached.end()) {
+                uint64_t const bytes = it->second.info.bytes;
+                _bytesCached -= bytes;
+                _releaseBytes(bytes);
+                _lru.erase(it->second.lruIter);
+                bool const isStale = version.empty() || it->second.info.version != version;
+                if (!isStale) {
+                    ++_hits;
+                    _bytesInUse += bytes;
+                    _inUse[it->first] = it->second.info;
+                    _cached.erase(it);
+                    continue;
+                }
+                ++_invalidations;
+                stale.push_back(scTbl);
+                _cached.erase(it);
+            }
+            ++_misses;
+            missing.push_back(scTbl);
+            missingVersions.push_back(version);
+        }
+        return missing;
+    }
+
+    /// Record the sizes and the versions of tables that were just built.
+    void loaded(ScTableVector const& v, std::vector<uint64_t> const& bytes,
+                std::vector<std::string> const& versions) {
+        if (_maxBytes == 0) return;
+        for (size_t j = 0; j < v.size(); ++j) {
+            uint64_t const sz = std::max(j < bytes.size() ? bytes[j] : 0, minTableBytes);
+            _inUse[_key(v[j])] = Info{sz, j < versions.size() ? versions[j] : std::string()};
+            _bytesInUse += sz;
+        }
+    }
+
+    /// Keep the tables in 'released', which no one is using anymore, dropping
+    /// the least recently used tables to make room for them.
+    /// @return the tables that must be dropped.
+    ScTableVector release(ScTableVector const& released) {
+        if (_maxBytes == 0) return released;
+        ScTableVector discard;
+        for (auto const& scTbl : released) {
+            Key key = _key(scTbl);
+            auto it = _inUse.find(key);
+            if (it == _inUse.end()) {
+                // It was never built, likely because the build failed.
+                discard.push_back(scTbl);
+                continue;
+            }
+            Info const info = it->second;
+            _bytesInUse -= info.bytes;
+            _inUse.erase(it);
+            // Tables of unknown version could never be used again.
+            if (info.bytes > _maxBytes || info.version.empty()) {
+                discard.push_back(scTbl);
+                continue;
+            }
+            // Make room for the table, both in the cache and in memman.
+            bool reserved = _tryReserve(info.bytes);
+            while (!reserved && !_lru.empty()) {
+                _evictOldest(discard);
+                reserved = _tryReserve(info.bytes);
+            }
+            if (!reserved) {
+                ++_rejections;
+                discard.push_back(scTbl);
+                continue;
+            }
+            _lru.push_front(scTbl);
+            _cached.emplace(key, Entry{info, _lru.begin()});
+            _bytesCached += info.bytes;
+        }
+        return discard;
+    }
+
+    /// Forget all cached tables.
+    /// @return the tables that must be dropped.
+    ScTableVector releaseAll() {
+        ScTableVector discard(_lru.begin(), _lru.end());
+        _releaseBytes(_bytesCached);
+        _lru.clear();
+        _cached.clear();
+        _bytesCached = 0;
+        return discard;
+    }
+
+    nlohmann::json statusToJson() const {
+        nlohmann::json status;
+        status["maxBytes"] = _maxBytes;
+        status["bytesCached"] = _bytesCached;
+        status["tablesCached"] = _cached.size();
+        status["bytesInUse"] = _bytesInUse;
+        status["tablesInUse"] = _inUse.size();
+        status["hits"] = _hits;
+        status["misses"] = _misses;
+        status["evictions"] = _evictions;
+        status["invalidations"] = _invalidations;
+        status["rejections"] = _rejections;
+        return status;
+    }
+
+private:
+    struct Info {
+        uint64_t bytes;
+        std::string version;  ///< Of the chunk tables the table was built from.
+    };
+
+    struct Entry {
+        Info info;
+        std::list<ScTable>::iterator lruIter;
+    };
+
+    static Key _key(ScTable const& scTbl) {
+        return Key(scTbl.chunkId, scTbl.dbTable.db, scTbl.dbTable.table, scTbl.subChunkId);
+    }
+
+    /// Drop the least recently used table, adding it to 'discard'.
+    void _evictOldest(ScTableVector& discard) {
+        ScTable const& oldest = _lru.back();
+        auto it = _cached.find(_key(oldest));
+        uint64_t const bytes = it->second.info.bytes;
+        _bytesCached -= bytes;
+        _releaseBytes(bytes);
+        _cached.erase(it);
+        discard.push_back(oldest);
+        _lru.pop_back();
+        ++_evictions;
+    }
+
+    /// @return true if 'bytes' fit in the cache and were reserved in memman.
+    bool _tryReserve(uint64_t bytes) {
+        if (_bytesCached + bytes > _maxBytes) return false;
+        return _memMan == nullptr || _memMan->reserveBytes(bytes);
+    }
+
+    void _releaseBytes(uint64_t bytes) {
+        if (_memMan != nullptr && bytes > 0) _memMan->releaseBytes(bytes);
+    }
+
+    uint64_t const _maxBytes;
+    std::shared_ptr<memman::MemMan> const _memMan;  ///< Memory of the cached tables is reserved here.
+    std::list<ScTable> _lru;                        ///< Cached tables, most recently used first.
+    std::map<Key, Entry> _cached;                   ///< Cached tables that no one is using.
+    std::map<Key, Info> _inUse;                     ///< Sizes of the tables in use.
+    uint64_t _bytesCached = 0;
+    uint64_t _bytesInUse = 0;
+    uint64_t _hits = 0;
+    uint64_t _misses = 0;
+    uint64_t _evictions = 0;
+    uint64_t _invalidations = 0;  ///< Cached tables dropped as their chunk tables changed.
+    uint64_t _rejections = 0;     ///< Released tables dropped for lack of memory.
+};
+
 /// ChunkEntry is an entry that represents table subchunks for a given
 /// database and chunkid.
 class ChunkEntry {
@@ -173,7 +372,7 @@ public:
 
     /// Acquire a resource, loading if needed
     void acquire(std::string const& db, DbTableSet const& dbTableSet, IntVector const& sc,
-                 SQLBackend::Ptr backend) {
+                 SQLBackend::Ptr backend, SubChunkCache& cache) {
         ScTableVector needed;
         std::lock_guard<std::mutex> lock(_mutex);
         backend->memLockRequireOwnership();
@@ -197,21 +396,39 @@ public:
             }                        // All subchunks
         }                            // All tables
         // For now, every other user of this chunk must wait while
-        // we fetch the resource.
-        if (needed.size() > 0) {
+        // we fetch the resource. Only the tables that aren't cached, or were
+        // built from chunk tables that changed since, are built.
+        std::vector<std::string> versions;
+        if (cache.isEnabled() && !needed.empty()) {
+            backend->getVersions(needed, versions);
+        }
+        ScTableVector stale;
+        std::vector<std::string> missingVersions;
+        ScTableVector missing = cache.take(needed, versions, stale, missingVersions);
+        if (!stale.empty()) {
+            backend->discard(stale);
+        }
+        if (missing.size() > 0) {
             sql::SqlErrorObject err;
-            bool loadOk = backend->load(needed, err);
+            bool loadOk = backend->load(missing, err);
             if (!loadOk) {
-                // Release
-                _release(needed);
+                // Release, the tables taken from the cache are kept again.
+                _release(dbTableSet, sc);
+                ScTableVector dropped = cache.release(needed);
+                if (dropped.size() > 0) {
+                    backend->discard(dropped);
+                }
                 throw err;
             }
+            std::vector<uint64_t> bytes;
+            backend->getBytes(missing, bytes);
+            cache.loaded(missing, bytes, missingVersions);
         }
     }
 
     /// Release a resource, flushing if no more users need it.
     void release(std::string const& db, DbTableSet const& dbTableSet, IntVector const& sc,
-                 SQLBackend::Ptr backend) {
+                 SQLBackend::Ptr backend, SubChunkCache& cache) {
         std::lock_guard<std::mutex> lock(_mutex);
         backend->memLockRequireOwnership();
         StringVector::const_iterator ti, te;
@@ -233,14 +450,15 @@ public:
             }                              // All subchunks
         }                                  // All tables
         --_refCount;
-        _flush(db, backend);  // Discard resources no longer needed by anyone.
+        _flush(db, backend, cache);  // Discard resources no longer needed by anyone.
         // flush could be detached from the release function, to be called at a
         // high-water mark and/or on periodic intervals
     }
 
 private:
-    /// Flush resources no longer needed by anybody
-    void _flush(std::string const& db, SQLBackend::Ptr backend) {
+    /// Flush resources no longer needed by anybody, they are kept in 'cache'
+    /// if there is room.
+    void _flush(std::string const& db, SQLBackend::Ptr backend, SubChunkCache& cache) {
         ScTableVector discardable;
         for (auto& elem : _tableMap) {
             IntVector mapDiscardable;
@@ -265,17 +483,26 @@ private:
         }  // All tables
         // Delegate actual table dropping to the backend.
         if (discardable.size() > 0) {
-            backend->discard(discardable);
+            ScTableVector dropped = cache.release(discardable);
+            if (dropped.size() > 0) {
+                backend->discard(dropped);
+            }
         }
     }
 
-    void _release(ScTableVector const& needed) {
+    /// Undo acquire() of the subchunks 'sc' of the tables in 'dbTableSet'.
+    /// Subchunks no one uses are forgotten, so that they are built again.
+    void _release(DbTableSet const& dbTableSet, IntVector const& sc) {
         // _mutex should be held.
-        // Release subChunkId for the right table
-        for (auto const& elem : needed) {
-            SubChunkMap& scm = _tableMap[elem.dbTable];
-            --scm[elem.subChunkId];
+        for (auto const& dbTbl : dbTableSet) {
+            SubChunkMap& scm = _tableMap[dbTbl];
+            for (int subChunkId : sc) {
+                if (--scm[subChunkId] == 0) {
+                    scm.erase(subChunkId);
+                }
+            }
         }
+        --_refCount;
     }
 
     std::shared_ptr<SQLBackend> _backend;  ///< Delegate stage/unstage
@@ -289,9 +516,27 @@ private:
 // ChunkResourceMgr
 ////////////////////////////////////////////////////////////////////////
 
-ChunkResourceMgr::Ptr ChunkResourceMgr::newMgr(SQLBackend::Ptr const& backend) {
+ChunkResourceMgr::Ptr ChunkResourceMgr::newMgr(SQLBackend::Ptr const& backend, uint64_t cacheMaxBytes,
+                                               std::shared_ptr<memman::MemMan> const& memMan) {
     // return std::shared_ptr<ChunkResourceMgr>(new Impl(backend));
-    return std::make_shared<ChunkResourceMgr>(backend);
+    return std::make_shared<ChunkResourceMgr>(backend, cacheMaxBytes, memMan);
+}
+
+ChunkResourceMgr::ChunkResourceMgr(SQLBackend::Ptr const& backend, uint64_t cacheMaxBytes,
+                                   std::shared_ptr<memman::MemMan> const& memMan)
+        : _backend(backend), _cache(new SubChunkCache(cacheMaxBytes, memMan)) {
+    LOGS(_log, LOG_LVL_INFO, "ChunkResourceMgr cacheMaxBytes=" << cacheMaxBytes);
+}
+
+ChunkResourceMgr::~ChunkResourceMgr() {
+    std::lock_guard<std::mutex> lock(_mapMutex);
+    ScTableVector dropped = _cache->releaseAll();
+    if (dropped.empty()) return;
+    try {
+        _backend->discard(dropped);
+    } catch (sql::SqlErrorObject const& err) {
+        LOGS(_log, LOG_LVL_WARN, "~ChunkResourceMgr failed to drop cached subchunks " << err.printErrMsg());
+    }
 }
 
 ChunkResource ChunkResourceMgr::acquire(std::string const& db, int chunkId, DbTableSet const& tables) {
@@ -312,7 +557,7 @@ void ChunkResourceMgr::release(ChunkResource::Info const& i) {
     std::lock_guard<std::mutex> lock(_mapMutex);
     Map& map = _getMap(i.db);
     ChunkEntry& ce = _getChunkEntry(map, i.chunkId);
-    ce.release(i.db, i.tables, i.subChunkIds, _backend);
+    ce.release(i.db, i.tables, i.subChunkIds, _backend, *_cache);
 }
 
 void ChunkResourceMgr::acquireUnit(ChunkResource::Info const& i) {
@@ -321,7 +566,7 @@ void ChunkResourceMgr::acquireUnit(ChunkResource::Info const& i) {
     ChunkEntry& ce = _getChunkEntry(map, i.chunkId);
     // Actually acquire
     LOGS(_log, LOG_LVL_DEBUG, "acquireUnit info=" << i);
-    ce.acquire(i.db, i.tables, i.subChunkIds, _backend);
+    ce.acquire(i.db, i.tables, i.subChunkIds, _backend, *_cache);
 }
 
 int ChunkResourceMgr::getRefCount(std::string const& db, int chunkId) {
@@ -335,6 +580,11 @@ int ChunkResourceMgr::getRefCount(std::string const& db, int chunkId) {
     return ce.getRefCount();
 }
 
+nlohmann::json ChunkResourceMgr::statusToJson() {
+    std::lock_guard<std::mutex> lock(_mapMutex);
+    return _cache->statusToJson();
+}
+
 ChunkResourceMgr::Map& ChunkResourceMgr::_getMap(std::string const& db) {
     DbMap::iterator it = _dbMap.find(db);
     if (it == _dbMap.end()) {
@@ -42,6 +42,7 @@
 
 // Third-party headers
 #include "boost/utility.hpp"
+#include "nlohmann/json.hpp"
 
 // Qserv headers
 #include "global/DbTable.h"
@@ -51,6 +52,9 @@
 
 // Forward declarations
 namespace lsst::qserv {
+namespace memman {
+class MemMan;
+}
 namespace proto {
 class TaskMsg_Fragment;
 }
@@ -63,6 +67,7 @@ namespace lsst::qserv::wdb {
 
 class ChunkEntry;
 class ChunkResourceMgr;
+class SubChunkCache;
 
 /// ChunkResources are reservations on data resources. Releases its resource
 /// when it dies. If you make a copy, the copy holds its own reservation on the
@@ -92,6 +97,8 @@ private:
 };
 
 /// ChunkResourceMgr is a lightweight manager for holding reservations on subchunks.
+/// Subchunk tables that are no longer reserved are kept, up to 'cacheMaxBytes',
+/// for other queries on the same subchunks.
 class ChunkResourceMgr {
 public:
     using Ptr = std::shared_ptr<ChunkResourceMgr>;
@@ -99,9 +106,14 @@ public:
     typedef std::map<std::string, Map> DbMap;
 
     /// Factory
-    static Ptr newMgr(SQLBackend::Ptr const& backend);
-    ChunkResourceMgr(SQLBackend::Ptr const& backend) : _backend(backend) {}
-    virtual ~ChunkResourceMgr() {}
+    /// @param cacheMaxBytes - memory that unused subchunk tables may use, 0 to drop
+    ///                        them as soon as they are not needed.
+    /// @param memMan - the memory of unused subchunk tables is reserved there, may be nullptr.
+    static Ptr newMgr(SQLBackend::Ptr const& backend, uint64_t cacheMaxBytes = 0,
+                      std::shared_ptr<memman::MemMan> const& memMan = nullptr);
+    ChunkResourceMgr(SQLBackend::Ptr const& backend, uint64_t cacheMaxBytes = 0,
+                     std::shared_ptr<memman::MemMan> const& memMan = nullptr);
+    virtual ~ChunkResourceMgr();
 
     /// Reserve a chunk. Currently, this does not result in any explicit chunk
     /// loading.
@@ -130,6 +142,9 @@ public:
     /// @return the reference count for the database and chunkId.
     int getRefCount(std::string const& db, int chunkId);
 
+    /// @return statistics for the subchunk table cache.
+    nlohmann::json statusToJson();
+
 private:
     /// precondition: _mapMutex is held (locked by the caller)
     /// Get the ChunkEntry map for a db, creating if necessary
@@ -143,7 +158,8 @@ private:
     // Consider having separate mutexes for each db's map if contention becomes
     // a problem.
     std::shared_ptr<SQLBackend> _backend;
-    std::mutex _mapMutex;  // Do not alter map without this mutex
+    std::unique_ptr<SubChunkCache> _cache;  ///< Protected by _mapMutex.
+    std::mutex _mapMutex;                   // Do not alter map without this mutex
 };
 
 }  // namespace lsst::qserv::wdb
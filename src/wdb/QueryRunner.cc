@@ -63,13 +63,40 @@
 #include "util/Timer.h"
 #include "util/threadSafe.h"
 #include "wbase/Base.h"
+#include "wbase/ResultSpool.h"
+#include "wbase/RowSource.h"
 #include "wbase/SendChannelShared.h"
 #include "wdb/ChunkResource.h"
+#include "wdb/SharedScan.h"
 #include "wpublish/QueriesAndChunks.h"
 
 namespace {
 LOG_LOGGER _log = LOG_GET("lsst.qserv.wdb.QueryRunner");
-}
+
+/// The rows of a MySQL result, throwing SqlErrorObject if reading stops because
+/// of an error rather than at the end of the result. The tasks reading the rows
+/// of a shared pass couldn't tell a failed read from the end of their rows.
+class CheckedRowSource : public lsst::qserv::wbase::MySqlRowSource {
+public:
+    CheckedRowSource(MYSQL_RES* mResult, lsst::qserv::mysql::MySqlConnection& conn)
+            : MySqlRowSource(mResult), _conn(conn) {}
+
+    char const* const* nextRow(unsigned long const*& lengths) override {
+        char const* const* row = MySqlRowSource::nextRow(lengths);
+        if (row == nullptr && _conn.getErrno() != 0) {
+            lsst::qserv::sql::SqlErrorObject errObj;
+            errObj.setErrNo(_conn.getErrno());
+            errObj.addErrMsg("fetchRow error " + _conn.getError());
+            throw errObj;
+        }
+        return row;
+    }
+
+private:
+    lsst::qserv::mysql::MySqlConnection& _conn;
+};
+
+}  // namespace
 
 using namespace std;
 
@@ -193,7 +220,8 @@ bool QueryRunner::runQuery() {
     LOGS(_log, LOG_LVL_INFO, "Exec in flight for Db=" << _dbName << " sqlConnMgr " << _sqlConnMgr->dump());
     // Queries that span multiple tasks should not be high priority for the SqlConMgr as it risks deadlock.
     bool interactive = _task->getScanInteractive() && !(_task->getSendChannel()->getTaskCount() > 1);
-    wcontrol::SqlConnLock sqlConnLock(*_sqlConnMgr, not interactive, _task->getSendChannel());
+    auto sqlConnLock =
+            make_unique<wcontrol::SqlConnLock>(*_sqlConnMgr, not interactive, _task->getSendChannel());
     bool connOk = _initConnection();
     if (!connOk) {
         // Since there's an error, this will be the last transmit from this QueryRunner.
@@ -207,7 +235,7 @@ bool QueryRunner::runQuery() {
         switch (_task->msg->protocol()) {
             case 2:
                 // Run the query and send the results back.
-                if (!_dispatchChannel()) {
+                if (!_dispatchChannel(sqlConnLock)) {
                     LOGS(_log, LOG_LVL_WARN, "_dispatchChannel failed.");
                     return false;
                 }
@@ -234,6 +262,26 @@ MYSQL_RES* QueryRunner::_primeResult(string const& query) {
     return _mysqlConn->getResult();
 }
 
+unique_ptr<wbase::RowSource> QueryRunner::_primeRows(string const& query, bool subchunks) {
+    // Scans may read their rows in a pass over the chunk table shared with other
+    // queries. Interactive queries don't wait for other queries to join.
+    if (SharedScan::isEnabled() && !_task->getScanInteractive() && !subchunks) {
+        proto::TaskMsg const& tMsg = *_task->msg;
+        string const key = tMsg.db() + ":" + to_string(tMsg.chunkid()) + ":" + _task->user;
+        // Other Tasks of the chunk, queued or running, may join the pass.
+        auto const scheduler = _task->getTaskScheduler();
+        bool const othersPending = scheduler != nullptr && scheduler->getChunkTaskCount(tMsg.chunkid()) > 1;
+        auto runFunc = [this](string const& sharedQuery) -> unique_ptr<wbase::RowSource> {
+            return make_unique<CheckedRowSource>(_primeResult(sharedQuery), *_mysqlConn);
+        };
+        auto rows = SharedScan::run(key, query, othersPending, runFunc, _cancelled);
+        if (rows != nullptr || _cancelled) return rows;
+        // If this task led a pass that failed, the connection may still have its result.
+        _mysqlConn->freeResult();
+    }
+    return make_unique<wbase::MySqlRowSource>(_primeResult(query));
+}
+
 class ChunkResourceRequest {
 public:
     using Ptr = std::shared_ptr<ChunkResourceRequest>;
@@ -281,7 +329,7 @@ private:
     proto::TaskMsg const& _msg;
 };
 
-bool QueryRunner::_dispatchChannel() {
+bool QueryRunner::_dispatchChannel(unique_ptr<wcontrol::SqlConnLock>& sqlConnLock) {
     int const fragNum = _task->getQueryFragmentNum();
     proto::TaskMsg& tMsg = *_task->msg;
     bool erred = false;
@@ -309,13 +357,17 @@ bool QueryRunner::_dispatchChannel() {
         //       Ideally, hold it until moving on to the next chunk. Try to clean up ChunkResource code.
 
         auto taskSched = _task->getTaskScheduler();
+        util::Timer primeT;
+        unique_ptr<wbase::RowSource> rows;
         if (!_cancelled && !_task->getSendChannel()->isDead()) {
             string const& query = _task->getQueryString();
-            util::Timer primeT;
+            bool const subchunks = tMsg.fragment(fragNum).has_subchunks();
             primeT.start();
-            MYSQL_RES* res = _primeResult(query);  // This runs the SQL query, throws SqlErrorObj on failure.
+            rows = _primeRows(query, subchunks);  // This runs the SQL query, throws SqlErrorObj on failure.
             primeT.stop();
             needToFreeRes = true;
+        }
+        if (rows != nullptr) {
             if (taskSched != nullptr) {
                 taskSched->histTimeOfRunningTasks->addEntry(primeT.getElapsed());
                 LOGS(_log, LOG_LVL_DEBUG, "QR " << taskSched->histTimeOfRunningTasks->getString("run"));
@@ -350,9 +402,31 @@ bool QueryRunner::_dispatchChannel() {
             // Pass all information on to the shared object to add on to
             // an existing message or build a new one as needed.
             util::InstanceCount ica(to_string(_task->getQueryId()) + "_rqa_LDB");  // LockupDB
-            if (_task->getSendChannel()->buildAndTransmitResult(res, numFields, _task, _largeResult,
-                                                                _multiError, _cancelled, readRowsOk)) {
-                erred = true;
+            auto sendChannel = _task->getSendChannel();
+            if (!wbase::ResultSpool::isEnabled()) {
+                if (sendChannel->buildAndTransmitResult(*rows, numFields, _task, _largeResult, _multiError,
+                                                        _cancelled, readRowsOk)) {
+                    erred = true;
+                }
+            } else {
+                bool lastIn = false;
+                if (sendChannel->buildAndSpoolResult(*rows, numFields, _task, _largeResult, _multiError,
+                                                     _cancelled, readRowsOk, lastIn)) {
+                    erred = true;
+                }
+                // All rows have been read, so the result, the SQL connection, and the
+                // subchunk tables aren't needed while the czar reads the spooled messages.
+                needToFreeRes = false;
+                _mysqlConn->freeResult();
+                _mysqlConn->closeMySqlConn();
+                sqlConnLock.reset();
+                cr.reset();
+                if (!erred && readRowsOk && !_cancelled &&
+                    sendChannel->transmitSpooled(_task, _cancelled, lastIn)) {
+                    LOGS(_log, LOG_LVL_ERROR, "Could not transmit spooled results.");
+                    readRowsOk = false;
+                    erred = true;
+                }
             }
 
             // ATTENTION: This call is needed to record the _actual_ completion time of the task.
@@ -41,6 +41,7 @@
 #include "mysql/MySqlConfig.h"
 #include "mysql/MySqlConnection.h"
 #include "util/MultiError.h"
+#include "wbase/RowSource.h"
 #include "wbase/Task.h"
 #include "wbase/TransmitData.h"
 #include "wcontrol/SqlConnMgr.h"
@@ -101,9 +102,15 @@ private:
     void _setDb();
 
     /// Dispatch with output sent through a SendChannel
-    bool _dispatchChannel();
+    /// 'sqlConnLock' is released early if the result is spooled, see wbase::ResultSpool.
+    bool _dispatchChannel(std::unique_ptr<wcontrol::SqlConnLock>& sqlConnLock);
     MYSQL_RES* _primeResult(std::string const& query);  ///< Obtain a result handle for a query.
 
+    /// @return the rows of 'query', read by this task or in a pass shared with other
+    ///         tasks (see SharedScan), or nullptr if the task was cancelled while
+    ///         waiting for a shared pass. Throws SqlErrorObject on failure.
+    std::unique_ptr<wbase::RowSource> _primeRows(std::string const& query, bool subchunks);
+
     static size_t _getDesiredLimit();
 
     wbase::Task::Ptr const _task;  ///< Actual task
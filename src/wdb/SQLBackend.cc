@@ -26,6 +26,9 @@
 
 // System headers
 #include <iostream>
+#include <map>
+#include <set>
+#include <utility>
 
 // Third-party headers
 #include "boost/uuid/uuid.hpp"
@@ -75,26 +78,128 @@ bool SQLBackend::load(ScTableVector const& v, sql::SqlErrorObject& err) {
     using namespace lsst::qserv::wbase;
     std::lock_guard<std::mutex> lock(_mtx);
     _memLockRequireOwnership();
-    for (ScTableVector::const_iterator i = v.begin(), e = v.end(); i != e; ++i) {
+    // Send all of the scripts at once to avoid a round trip per subchunk.
+    std::string create;
+    for (auto const& scTbl : v) {
         std::string const* createScript = nullptr;
-        if (i->chunkId == DUMMY_CHUNK) {
+        if (scTbl.chunkId == DUMMY_CHUNK) {
             createScript = &CREATE_DUMMY_SUBCHUNK_SCRIPT;
         } else {
             createScript = &CREATE_SUBCHUNK_SCRIPT;
         }
-        std::string create = (boost::format(*createScript) % i->dbTable.db % i->dbTable.table %
-                              SUB_CHUNK_COLUMN % i->chunkId % i->subChunkId)
-                                     .str();
-
-        if (!_sqlConn->runQuery(create, err)) {
-            LOGS(_log, LOG_LVL_ERROR, "sql query err=" << err.errMsg() << " with '" << create << "'");
-            _discard(v.begin(), i);
-            return false;
-        }
+        create += (boost::format(*createScript) % scTbl.dbTable.db % scTbl.dbTable.table % SUB_CHUNK_COLUMN %
+                   scTbl.chunkId % scTbl.subChunkId)
+                          .str();
+    }
+    if (create.empty()) return true;
+    if (!_sqlConn->runQuery(create, err)) {
+        LOGS(_log, LOG_LVL_ERROR,
+             "sql query err=" << err.errMsg() << " building " << v.size() << " subchunks with '" << create
+                              << "'");
+        // Some of the tables may have been built before the failure.
+        _discard(v.begin(), v.end());
+        return false;
     }
     return true;
 }
 
+void SQLBackend::getBytes(ScTableVector const& v, std::vector<uint64_t>& bytes) {
+    bytes.assign(v.size(), 0);
+    if (v.empty()) return;
+    // Map the schema and name of each table, and its overlap table, to its position in 'v'.
+    std::map<std::pair<std::string, std::string>, size_t> positions;
+    std::string where;
+    for (size_t j = 0; j < v.size(); ++j) {
+        auto const& scTbl = v[j];
+        std::string const chunk = std::to_string(scTbl.chunkId);
+        std::string const schema = SUBCHUNKDB_PREFIX + scTbl.dbTable.db + "_" + chunk;
+        std::string const suffix = "_" + chunk + "_" + std::to_string(scTbl.subChunkId);
+        std::string const& table = scTbl.dbTable.table;
+        for (auto const& name : {table + suffix, table + "FullOverlap" + suffix}) {
+            positions[std::make_pair(schema, name)] = j;
+            where += std::string(where.empty() ? "" : ",") + "('" + schema + "','" + name + "')";
+        }
+    }
+    std::string const sql =
+            "SELECT TABLE_SCHEMA, TABLE_NAME, DATA_LENGTH + INDEX_LENGTH FROM information_schema.TABLES "
+            "WHERE (TABLE_SCHEMA, TABLE_NAME) IN (" +
+            where + ")";
+    std::vector<std::string> schemas;
+    std::vector<std::string> names;
+    std::vector<std::string> sizes;
+    sql::SqlResults results;
+    sql::SqlErrorObject err;
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        if (!_sqlConn->runQuery(sql, results, err) ||
+            !results.extractFirst3Columns(schemas, names, sizes, err)) {
+            LOGS(_log, LOG_LVL_WARN, "getBytes query failed " << sql << " err=" << err.printErrMsg());
+            return;
+        }
+    }
+    for (size_t j = 0; j < schemas.size(); ++j) {
+        auto it = positions.find(std::make_pair(schemas[j], names[j]));
+        if (it == positions.end()) continue;
+        try {
+            bytes[it->second] += std::stoull(sizes[j]);
+        } catch (std::exception const& ex) {
+            LOGS(_log, LOG_LVL_WARN, "getBytes bad size '" << sizes[j] << "' for " << names[j]);
+        }
+    }
+}
+
+void SQLBackend::getVersions(ScTableVector const& v, std::vector<std::string>& versions) {
+    versions.assign(v.size(), std::string());
+    if (v.empty()) return;
+    // The chunk table and the overlap table of each element of 'v'.
+    std::vector<std::pair<std::string, std::string>> sources;
+    std::set<std::pair<std::string, std::string>> uniqueSources;
+    for (auto const& scTbl : v) {
+        std::string const suffix = "_" + std::to_string(scTbl.chunkId);
+        std::string const& table = scTbl.dbTable.table;
+        for (auto const& name : {table + suffix, table + "FullOverlap" + suffix}) {
+            sources.emplace_back(scTbl.dbTable.db, name);
+            uniqueSources.insert(sources.back());
+        }
+    }
+    std::string where;
+    for (auto const& source : uniqueSources) {
+        where += std::string(where.empty() ? "" : ",") + "('" + source.first + "','" + source.second + "')";
+    }
+    // MyISAM updates UPDATE_TIME and the sizes on every write, CREATE_TIME changes
+    // when the table is created again.
+    std::string const sql =
+            "SELECT TABLE_SCHEMA, TABLE_NAME, "
+            "CONCAT_WS(',', CREATE_TIME, UPDATE_TIME, TABLE_ROWS, DATA_LENGTH, INDEX_LENGTH) "
+            "FROM information_schema.TABLES WHERE (TABLE_SCHEMA, TABLE_NAME) IN (" +
+            where + ")";
+    std::vector<std::string> schemas;
+    std::vector<std::string> names;
+    std::vector<std::string> signatures;
+    sql::SqlResults results;
+    sql::SqlErrorObject err;
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        if (!_sqlConn->runQuery(sql, results, err) ||
+            !results.extractFirst3Columns(schemas, names, signatures, err)) {
+            LOGS(_log, LOG_LVL_WARN, "getVersions query failed " << sql << " err=" << err.printErrMsg());
+            return;
+        }
+    }
+    std::map<std::pair<std::string, std::string>, std::string> signatureOf;
+    for (size_t j = 0; j < schemas.size(); ++j) {
+        signatureOf[std::make_pair(schemas[j], names[j])] = signatures[j];
+    }
+    for (size_t j = 0; j < v.size(); ++j) {
+        auto const chunkTable = signatureOf.find(sources[2 * j]);
+        auto const overlapTable = signatureOf.find(sources[2 * j + 1]);
+        // Without the chunk table there is nothing to build the table from.
+        if (chunkTable == signatureOf.end()) continue;
+        versions[j] = chunkTable->second + ";" +
+                      (overlapTable == signatureOf.end() ? std::string() : overlapTable->second);
+    }
+}
+
 void SQLBackend::discard(ScTableVector const& v) {
     std::lock_guard<std::mutex> lock(_mtx);
     _discard(v.begin(), v.end());
@@ -250,6 +355,11 @@ void SQLBackend::_exitDueToConflict(const std::string& msg) {
 
 bool FakeBackend::load(ScTableVector const& v, sql::SqlErrorObject& err) {
     using namespace lsst::qserv::wbase;
+    ++loadCount;
+    if (fakeLoadFails) {
+        err.addErrMsg("FakeBackend load failure");
+        return false;
+    }
     std::ostringstream os;
     os << "Pretending to load:";
     std::copy(v.begin(), v.end(), std::ostream_iterator<ScTable>(os, ","));
@@ -269,6 +379,14 @@ void FakeBackend::discard(ScTableVector const& v) {
     _discard(v.begin(), v.end());
 }
 
+void FakeBackend::getBytes(ScTableVector const& v, std::vector<uint64_t>& bytes) {
+    bytes.assign(v.size(), fakeBytes);
+}
+
+void FakeBackend::getVersions(ScTableVector const& v, std::vector<std::string>& versions) {
+    versions.assign(v.size(), fakeVersion);
+}
+
 void FakeBackend::_discard(ScTableVector::const_iterator begin, ScTableVector::const_iterator end) {
     std::ostringstream os;
     os << "Pretending to discard:";
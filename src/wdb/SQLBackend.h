@@ -31,6 +31,7 @@
 #include <string>
 #include <sys/types.h>
 #include <unistd.h>
+#include <vector>
 
 // Qserv headers
 #include "global/DbTable.h"
@@ -71,10 +72,23 @@ public:
 
     virtual ~SQLBackend();
 
+    /// Build the subchunk tables in 'v', with their overlap tables, in one statement.
+    /// @return false if the tables could not be built, in which case none of them exist.
     virtual bool load(ScTableVector const& v, sql::SqlErrorObject& err);
 
     virtual void discard(ScTableVector const& v);
 
+    /// Find how much memory the tables in 'v', with their overlap tables, use.
+    /// @param bytes - set to the number of bytes for each element of 'v',
+    ///                0 if it could not be determined.
+    virtual void getBytes(ScTableVector const& v, std::vector<uint64_t>& bytes);
+
+    /// Find the versions of the chunk tables the tables in 'v' are built from.
+    /// A version changes when a chunk table is created again or modified.
+    /// @param versions - set to the version for each element of 'v', empty
+    ///                   if it could not be determined.
+    virtual void getVersions(ScTableVector const& v, std::vector<std::string>& versions);
+
     enum LockStatus { UNLOCKED, LOCKED_OTHER, LOCKED_OURS };
 
     virtual void memLockRequireOwnership();
@@ -128,6 +142,12 @@ public:
 
     void discard(ScTableVector const& v) override;
 
+    /// Every table uses 'fakeBytes'.
+    void getBytes(ScTableVector const& v, std::vector<uint64_t>& bytes) override;
+
+    /// Every table has the version 'fakeVersion'.
+    void getVersions(ScTableVector const& v, std::vector<std::string>& versions) override;
+
     void memLockRequireOwnership() override{};  ///< Do nothing for fake version.
 
     /// For unit tests only.
@@ -137,6 +157,10 @@ public:
         return str;
     }
     std::set<std::string> fakeSet;  // set of strings for tracking unique tables.
+    uint64_t fakeBytes = 1000;      // size reported by getBytes() for every table.
+    std::string fakeVersion = "1";  // version reported by getVersions() for every table.
+    int loadCount = 0;              // number of times load() was called.
+    bool fakeLoadFails = false;     // load() fails without building any table.
 
 private:
     void _discard(ScTableVector::const_iterator begin, ScTableVector::const_iterator end) override;
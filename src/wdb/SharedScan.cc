@@ -0,0 +1,533 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "wdb/SharedScan.h"
+
+// System headers
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <set>
+
+// Third party headers
+#include <mysql/mysql.h>
+
+// Qserv headers
+#include "memman/MemMan.h"
+#include "sql/SqlErrorObject.h"
+#include "wbase/RowSource.h"
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+using namespace std;
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.wdb.SharedScan");
+
+/// How often tasks waiting for a pass look at their 'cancelled' flag.
+chrono::milliseconds const CANCEL_CHECK_INTERVAL(100);
+
+/// Words that make a fragment unsuitable for sharing when found outside of
+/// parentheses.
+set<string> const TOP_LEVEL_STOP_WORDS = {"EXCEPT", "FOR", "GROUP", "HAVING", "INTERSECT", "INTO", "LIMIT",
+                                          "ORDER", "UNION", "PROCEDURE", "WINDOW"};
+
+/// Functions that make a fragment unsuitable for sharing, as their values
+/// depend on the rows selected by the query.
+set<string> const AGGREGATES = {"AVG", "BIT_AND", "BIT_OR", "BIT_XOR", "COUNT", "GROUP_CONCAT",
+                                "JSON_ARRAYAGG", "JSON_OBJECTAGG", "MAX", "MIN", "STD", "STDDEV",
+                                "STDDEV_POP", "STDDEV_SAMP", "SUM", "VARIANCE", "VAR_POP", "VAR_SAMP"};
+
+/// A word of a query, outside of quotes.
+struct Word {
+    string upper;  ///< The word in upper case.
+    size_t begin;
+    size_t end;
+    int depth;  ///< The number of parentheses around the word.
+};
+
+bool isWordChar(char c) { return isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$'; }
+
+string trim(string const& str) {
+    size_t const begin = str.find_first_not_of(" \t\r\n");
+    if (begin == string::npos) return string();
+    size_t const end = str.find_last_not_of(" \t\r\n");
+    return str.substr(begin, end + 1 - begin);
+}
+
+/// Find the words of 'query' outside of quotes, and the commas outside of
+/// quotes and parentheses.
+/// @return false if the quotes or parentheses aren't balanced, or if there
+///         is a comment, a ';' or a user variable.
+bool scan(string const& query, vector<Word>& words, vector<size_t>& commas) {
+    int depth = 0;
+    size_t const n = query.size();
+    size_t i = 0;
+    while (i < n) {
+        char const c = query[i];
+        if (c == '\'' || c == '"' || c == '`') {
+            size_t j = i + 1;
+            for (; j < n; ++j) {
+                if (query[j] == '\\' && c != '`') {
+                    ++j;
+                } else if (query[j] == c) {
+                    if (j + 1 < n && query[j + 1] == c) {
+                        ++j;  // A doubled quote stands for itself.
+                    } else {
+                        break;
+                    }
+                }
+            }
+            if (j >= n) return false;
+            i = j + 1;
+        } else if (c == ';' || c == '@' || c == '#' || (c == '-' && query.compare(i, 2, "--") == 0) ||
+                   (c == '/' && query.compare(i, 2, "/*") == 0)) {
+            return false;
+        } else if (c == '(') {
+            ++depth;
+            ++i;
+        } else if (c == ')') {
+            if (--depth < 0) return false;
+            ++i;
+        } else if (c == ',') {
+            if (depth == 0) commas.push_back(i);
+            ++i;
+        } else if (isWordChar(c)) {
+            size_t j = i;
+            while (j < n && isWordChar(query[j])) ++j;
+            string upper = query.substr(i, j - i);
+            transform(upper.begin(), upper.end(), upper.begin(), [](unsigned char u) { return toupper(u); });
+            words.push_back(Word{upper, i, j, depth});
+            i = j;
+        } else {
+            ++i;
+        }
+    }
+    return depth == 0;
+}
+
+/// @return true if the first character after 'pos' other than a space is '('.
+bool isCall(string const& query, size_t pos) {
+    size_t const next = query.find_first_not_of(" \t\r\n", pos);
+    return next != string::npos && query[next] == '(';
+}
+
+/// Split a table reference into its table name and optional alias.
+/// @return false if it's anything else, such as a join or a subquery.
+bool splitTableRef(string const& from, vector<string>& items) {
+    if (from.find_first_of("(),") != string::npos) return false;
+    string item;
+    bool quoted = false;
+    for (char c : from) {
+        if (c == '`') quoted = !quoted;
+        if (!quoted && isspace(static_cast<unsigned char>(c))) {
+            if (!item.empty()) items.push_back(item);
+            item.clear();
+        } else {
+            item += c;
+        }
+    }
+    if (!item.empty()) items.push_back(item);
+    if (items.size() == 3) {
+        string as = items[1];
+        transform(as.begin(), as.end(), as.begin(), [](unsigned char u) { return toupper(u); });
+        if (as != "AS") return false;
+    }
+    return !items.empty() && items.size() <= 3;
+}
+
+/// Memory reserved in memman until the object is destroyed.
+class Reservation {
+public:
+    Reservation(shared_ptr<lsst::qserv::memman::MemMan> const& memMan, uint64_t bytes)
+            : _memMan(memMan), _bytes(bytes) {}
+    Reservation(Reservation const&) = delete;
+    Reservation& operator=(Reservation const&) = delete;
+    ~Reservation() { _memMan->releaseBytes(_bytes); }
+
+private:
+    shared_ptr<lsst::qserv::memman::MemMan> const _memMan;
+    uint64_t const _bytes;
+};
+
+/// The rows of one member of a pass, copied out of the result of the merged query.
+class BufferedRows : public lsst::qserv::wbase::RowSource {
+public:
+    /// @param reservation - the memory reserved for the rows, may be nullptr.
+    BufferedRows(MYSQL_FIELD const* fields, int numFields, unique_ptr<Reservation> reservation)
+            : _fields(numFields), _row(numFields), _reservation(move(reservation)) {
+        _names.reserve(numFields);
+        for (int i = 0; i < numFields; ++i) {
+            _names.emplace_back(fields[i].name != nullptr ? fields[i].name : "");
+            // The other members point into the result of the merged query, which
+            // is freed before these rows are read.
+            MYSQL_FIELD& field = _fields[i];
+            field.name = const_cast<char*>(_names[i].c_str());
+            field.name_length = _names[i].size();
+            field.type = fields[i].type;
+            field.flags = fields[i].flags;
+            field.length = fields[i].length;
+            field.decimals = fields[i].decimals;
+            field.charsetnr = fields[i].charsetnr;
+        }
+    }
+
+    /// Copy a row.
+    /// @return the number of bytes in all of the rows.
+    uint64_t add(char const* const* row, unsigned long const* lengths) {
+        for (size_t i = 0; i < _fields.size(); ++i) {
+            if (row[i] == nullptr) {
+                _offsets.push_back(NULL_VALUE);
+                _lengths.push_back(0);
+            } else {
+                // Keep the terminating null character, as MySQL does.
+                _offsets.push_back(_data.size());
+                _data.append(row[i], lengths[i]);
+                _data.push_back('\0');
+                _lengths.push_back(lengths[i]);
+            }
+        }
+        return _data.size() + _offsets.size() * (sizeof(size_t) + sizeof(unsigned long));
+    }
+
+    int getNumFields() override { return _fields.size(); }
+    MYSQL_FIELD const* getFields() override { return _fields.data(); }
+
+    char const* const* nextRow(unsigned long const*& lengths) override {
+        size_t const first = _next * _fields.size();
+        if (_fields.empty() || first >= _offsets.size()) return nullptr;
+        for (size_t i = 0; i < _fields.size(); ++i) {
+            size_t const offset = _offsets[first + i];
+            _row[i] = offset == NULL_VALUE ? nullptr : _data.data() + offset;
+        }
+        lengths = _lengths.data() + first;
+        ++_next;
+        return _row.data();
+    }
+
+private:
+    static constexpr size_t NULL_VALUE = ~size_t(0);
+
+    vector<string> _names;
+    vector<MYSQL_FIELD> _fields;
+    string _data;              ///< The values of all rows.
+    vector<size_t> _offsets;   ///< The offset of each value in _data, or NULL_VALUE.
+    vector<unsigned long> _lengths;
+    vector<char const*> _row;  ///< The row returned by nextRow().
+    size_t _next = 0;          ///< The index of the next row to return.
+    unique_ptr<Reservation> _reservation;
+};
+
+}  // namespace
+
+namespace lsst::qserv::wdb {
+
+/// The tasks reading their rows with one merged query. The first member leads the pass.
+class SharedScan::Pass {
+public:
+    struct Member {
+        Fragment fragment;
+        unique_ptr<BufferedRows> rows;  ///< Set by the leader if the member got its rows.
+        atomic<bool> abandoned{false};  ///< Set if the member stopped waiting for its rows.
+    };
+
+    vector<shared_ptr<Member>> members;
+    bool closed = false;  ///< No more members may join.
+    bool done = false;    ///< The leader has filled the buffers of the members.
+    condition_variable cv;
+};
+
+mutex SharedScan::_mtx;
+map<string, shared_ptr<SharedScan::Pass>> SharedScan::_passes;
+shared_ptr<memman::MemMan> SharedScan::_memMan;
+atomic<unsigned int> SharedScan::_windowMs{0};
+atomic<unsigned int> SharedScan::_maxQueries{0};
+atomic<uint64_t> SharedScan::_maxBytesPerQuery{0};
+atomic<uint64_t> SharedScan::_passesRun{0};
+atomic<uint64_t> SharedScan::_queriesShared{0};
+atomic<uint64_t> SharedScan::_fallbacks{0};
+atomic<uint64_t> SharedScan::_memoryRefusals{0};
+
+void SharedScan::setup(unsigned int windowMs, unsigned int maxQueries, uint64_t maxBytesPerQuery,
+                       shared_ptr<memman::MemMan> const& memMan) {
+    {
+        lock_guard<mutex> lock(_mtx);
+        _memMan = memMan;
+    }
+    _windowMs = windowMs;
+    _maxQueries = maxQueries;
+    _maxBytesPerQuery = maxBytesPerQuery;
+    LOGS(_log, LOG_LVL_INFO,
+         "SharedScan windowMs=" << windowMs << " maxQueries=" << maxQueries
+                                << " maxBytesPerQuery=" << maxBytesPerQuery);
+}
+
+bool SharedScan::isEnabled() { return _windowMs != 0 && _maxQueries > 1; }
+
+string SharedScan::flagName(int i) { return "QSERV_SHARED_SCAN_FLAG_" + to_string(i); }
+
+bool SharedScan::parse(string const& query, Fragment& fragment) {
+    string str = trim(query);
+    if (!str.empty() && str.back() == ';') str = trim(str.substr(0, str.size() - 1));
+    vector<Word> words;
+    vector<size_t> commas;
+    if (!scan(str, words, commas) || words.empty()) return false;
+    if (words[0].upper != "SELECT" || words[0].begin != 0) return false;
+    size_t from = 0;
+    size_t where = 0;
+    for (size_t w = 1; w < words.size(); ++w) {
+        Word const& word = words[w];
+        if (word.upper == "SELECT" || word.upper == "OVER") return false;
+        if (AGGREGATES.count(word.upper) != 0 && isCall(str, word.end)) return false;
+        if (word.depth > 0) continue;
+        if (word.upper == "FROM") {
+            if (from != 0) return false;
+            from = w;
+        } else if (word.upper == "WHERE") {
+            if (from == 0 || where != 0) return false;
+            where = w;
+        } else if (TOP_LEVEL_STOP_WORDS.count(word.upper) != 0) {
+            return false;
+        }
+    }
+    if (from == 0) return false;
+    string const& modifier = words[1].upper;
+    if (modifier == "ALL" || modifier == "DISTINCT" || modifier == "DISTINCTROW" ||
+        modifier == "HIGH_PRIORITY" || modifier == "STRAIGHT_JOIN" || modifier.compare(0, 4, "SQL_") == 0) {
+        return false;
+    }
+
+    size_t const fromEnd = where == 0 ? str.size() : words[where].begin;
+    vector<string> tableRef;
+    if (!splitTableRef(trim(str.substr(words[from].end, fromEnd - words[from].end)), tableRef)) return false;
+    if (where != 0) {
+        fragment.where = trim(str.substr(words[where].end));
+        if (fragment.where.empty()) return false;
+    } else {
+        fragment.where.clear();
+    }
+    fragment.from = tableRef[0];
+    for (size_t i = 1; i < tableRef.size(); ++i) fragment.from += " " + tableRef[i];
+
+    // An unqualified '*' may only come first in a select list, so it's
+    // qualified to be able to follow the columns of other fragments.
+    fragment.select.clear();
+    size_t begin = words[0].end;
+    commas.push_back(words[from].begin);
+    for (size_t comma : commas) {
+        if (comma > words[from].begin) break;
+        string item = trim(str.substr(begin, comma - begin));
+        if (item.empty()) return false;
+        if (item == "*") item = tableRef.back() + ".*";
+        if (!fragment.select.empty()) fragment.select += ", ";
+        fragment.select += item;
+        begin = comma + 1;
+    }
+    return true;
+}
+
+string SharedScan::mergeQueries(vector<Fragment> const& fragments) {
+    bool const filtered = none_of(fragments.begin(), fragments.end(),
+                                  [](Fragment const& fragment) { return fragment.where.empty(); });
+    string sql = "SELECT ";
+    string where;
+    for (size_t i = 0; i < fragments.size(); ++i) {
+        Fragment const& fragment = fragments[i];
+        if (i > 0) sql += ", ";
+        sql += fragment.where.empty() ? string("1") : "(" + fragment.where + ") IS TRUE";
+        sql += " AS `" + flagName(i) + "`, " + fragment.select;
+        if (filtered) where += (i > 0 ? " OR (" : "(") + fragment.where + ")";
+    }
+    sql += " FROM " + fragments.front().from;
+    if (filtered) sql += " WHERE " + where;
+    return sql;
+}
+
+unique_ptr<wbase::RowSource> SharedScan::run(string const& key, string const& query, bool othersPending,
+                                             RunFunc const& runFunc, atomic<bool> const& cancelled) {
+    if (!isEnabled()) return nullptr;
+    auto member = make_shared<Pass::Member>();
+    if (!parse(query, member->fragment)) return nullptr;
+    string const passKey = key + "\n" + member->fragment.from;
+
+    unique_lock<mutex> lock(_mtx);
+    auto iter = _passes.find(passKey);
+    if (iter != _passes.end()) {
+        // Join the pass and wait for its leader to fill the buffers.
+        shared_ptr<Pass> pass = iter->second;
+        pass->members.push_back(member);
+        if (pass->members.size() >= _maxQueries) {
+            pass->closed = true;
+            _passes.erase(iter);
+            pass->cv.notify_all();
+        }
+        while (!pass->done) {
+            if (cancelled) {
+                member->abandoned = true;
+                return nullptr;
+            }
+            pass->cv.wait_for(lock, CANCEL_CHECK_INTERVAL);
+        }
+        if (member->rows == nullptr) {
+            ++_fallbacks;
+            return nullptr;
+        }
+        ++_queriesShared;
+        return move(member->rows);
+    }
+
+    // Lead a new pass, and give other tasks the window to join it. Without
+    // other tasks on the chunk, nobody would join.
+    if (!othersPending) return nullptr;
+    auto pass = make_shared<Pass>();
+    pass->members.push_back(member);
+    _passes[passKey] = pass;
+    auto const deadline = chrono::steady_clock::now() + chrono::milliseconds(_windowMs);
+    while (!pass->closed && !cancelled) {
+        auto const now = chrono::steady_clock::now();
+        if (now >= deadline) break;
+        pass->cv.wait_until(lock, min(deadline, now + CANCEL_CHECK_INTERVAL));
+    }
+    if (!pass->closed) {
+        pass->closed = true;
+        _passes.erase(passKey);
+    }
+    size_t const numMembers = pass->members.size();
+    lock.unlock();
+
+    bool const ok = numMembers > 1 && !cancelled && _runPass(*pass, runFunc, cancelled);
+
+    lock.lock();
+    pass->done = true;
+    pass->cv.notify_all();
+    if (ok) ++_passesRun;
+    if (member->rows == nullptr) {
+        if (numMembers > 1) ++_fallbacks;
+        return nullptr;
+    }
+    ++_queriesShared;
+    return move(member->rows);
+}
+
+bool SharedScan::_runPass(Pass& pass, RunFunc const& runFunc, atomic<bool> const& cancelled) {
+    // No members join a closed pass, so its members can be read without the lock.
+    size_t const numMembers = pass.members.size();
+    vector<Fragment> fragments;
+    for (auto const& member : pass.members) fragments.push_back(member->fragment);
+    string const sql = mergeQueries(fragments);
+    LOGS(_log, LOG_LVL_DEBUG, "SharedScan running " << numMembers << " queries as " << sql);
+
+    // The buffers may grow up to maxBytes each, which is reserved before
+    // running the query, and released as they are freed.
+    uint64_t const maxBytes = _maxBytesPerQuery;
+    shared_ptr<memman::MemMan> memMan;
+    {
+        lock_guard<mutex> lock(_mtx);
+        memMan = _memMan;
+    }
+    vector<unique_ptr<Reservation>> reservations(numMembers);
+    if (memMan != nullptr) {
+        if (!memMan->reserveBytes(numMembers * maxBytes)) {
+            ++_memoryRefusals;
+            LOGS(_log, LOG_LVL_WARN,
+                 "SharedScan not enough memory for the buffers of " << numMembers << " queries");
+            return false;
+        }
+        for (auto& reservation : reservations) reservation = make_unique<Reservation>(memMan, maxBytes);
+    }
+
+    vector<unique_ptr<BufferedRows>> buffers(numMembers);
+    uint64_t numRows = 0;
+    try {
+        unique_ptr<wbase::RowSource> source = runFunc(sql);
+        int const numFields = source->getNumFields();
+        MYSQL_FIELD const* fields = source->getFields();
+
+        // The columns of each member follow its flag column.
+        vector<int> flags;
+        for (size_t i = 0; i < numMembers; ++i) {
+            string const name = flagName(i);
+            int f = flags.empty() ? 0 : flags.back() + 1;
+            while (f < numFields && (fields[f].name == nullptr || name != fields[f].name)) ++f;
+            if (f == numFields || (i == 0 && f != 0)) {
+                LOGS(_log, LOG_LVL_ERROR, "SharedScan result has no column " << name << " in place");
+                return false;
+            }
+            flags.push_back(f);
+        }
+        flags.push_back(numFields);
+        for (size_t i = 0; i < numMembers; ++i) {
+            buffers[i] = make_unique<BufferedRows>(fields + flags[i] + 1, flags[i + 1] - flags[i] - 1,
+                                                   move(reservations[i]));
+        }
+
+        unsigned long const* lengths;
+        while (char const* const* row = source->nextRow(lengths)) {
+            if (cancelled) return false;
+            ++numRows;
+            for (size_t i = 0; i < numMembers; ++i) {
+                char const* flag = row[flags[i]];
+                if (buffers[i] == nullptr || flag == nullptr || flag[0] != '1') continue;
+                if (buffers[i]->add(row + flags[i] + 1, lengths + flags[i] + 1) > maxBytes ||
+                    pass.members[i]->abandoned) {
+                    LOGS(_log, LOG_LVL_DEBUG, "SharedScan dropping the rows of member " << i);
+                    buffers[i].reset();
+                }
+            }
+        }
+    } catch (sql::SqlErrorObject const& e) {
+        LOGS(_log, LOG_LVL_WARN, "SharedScan query failed " << e.errMsg());
+        return false;
+    } catch (exception const& e) {
+        LOGS(_log, LOG_LVL_WARN, "SharedScan query failed " << e.what());
+        return false;
+    }
+    if (cancelled) return false;
+
+    int numShared = 0;
+    for (size_t i = 0; i < numMembers; ++i) {
+        if (buffers[i] == nullptr) continue;
+        pass.members[i]->rows = move(buffers[i]);
+        ++numShared;
+    }
+    LOGS(_log, LOG_LVL_INFO,
+         "SharedScan read " << numRows << " rows for " << numShared << " of " << numMembers << " queries");
+    return numShared > 0;
+}
+
+nlohmann::json SharedScan::statusToJson() {
+    nlohmann::json status = nlohmann::json::object();
+    status["windowMs"] = _windowMs.load();
+    status["maxQueries"] = _maxQueries.load();
+    status["maxBytesPerQuery"] = _maxBytesPerQuery.load();
+    status["passesRun"] = _passesRun.load();
+    status["queriesShared"] = _queriesShared.load();
+    status["fallbacks"] = _fallbacks.load();
+    status["memoryRefusals"] = _memoryRefusals.load();
+    return status;
+}
+
+}  // namespace lsst::qserv::wdb
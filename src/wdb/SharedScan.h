@@ -0,0 +1,144 @@
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsstcorp.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_WDB_SHAREDSCAN_H
+#define LSST_QSERV_WDB_SHAREDSCAN_H
+
+// System headers
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Third party headers
+#include "nlohmann/json.hpp"
+
+namespace lsst::qserv::memman {
+class MemMan;
+}
+
+namespace lsst::qserv::wbase {
+class RowSource;
+}
+
+namespace lsst::qserv::wdb {
+
+/// SharedScan lets the tasks of different queries that scan the same chunk
+/// table at about the same time read the table once. The scan scheduler runs
+/// the tasks on a chunk together, so their fragments reach the worker within
+/// a short time of each other.
+///
+/// The first task to arrive leads a pass and waits up to the window given to
+/// setup() for other tasks with the same table to join, unless the scheduler
+/// has no other tasks on the chunk that could join. The leader then runs
+/// a single query selecting the columns of every member, with a flag column
+/// per member telling whether the row matches that member's WHERE clause,
+/// and copies each row into the buffers of the members it matches. Members
+/// read their rows from the buffers as if they had run their own query. The
+/// most bytes the buffers may take are reserved in memman for as long as
+/// they exist.
+///
+/// Only simple fragments are shared: a select list, one table and an optional
+/// WHERE clause, without aggregates, grouping, ordering, limits or subqueries.
+/// When a fragment can't be shared, a pass has a single member, a buffer goes
+/// over its limit, or the merged query fails, the tasks concerned run their
+/// own query instead.
+class SharedScan {
+public:
+    /// The parts of a fragment query that can share a pass.
+    struct Fragment {
+        std::string select;  ///< The select list, with '*' qualified by the table name or alias.
+        std::string from;    ///< The table reference.
+        std::string where;   ///< The WHERE condition, empty if there is none.
+    };
+
+    /// Runs a query and returns its rows, which must all be read before the
+    /// next call. Throws if the query fails.
+    using RunFunc = std::function<std::unique_ptr<wbase::RowSource>(std::string const& query)>;
+
+    SharedScan() = delete;
+
+    /// Set the limits on passes. A 'windowMs' of 0 disables sharing, which is
+    /// the default.
+    /// @param windowMs - how long the leader of a pass waits for other tasks to join.
+    /// @param maxQueries - the most tasks in one pass, the pass starts when it is full.
+    /// @param maxBytesPerQuery - the most bytes of rows buffered for one task.
+    /// @param memMan - the memory of the buffers is reserved there, may be nullptr.
+    static void setup(unsigned int windowMs, unsigned int maxQueries, uint64_t maxBytesPerQuery,
+                      std::shared_ptr<memman::MemMan> const& memMan = nullptr);
+
+    /// @return true if setup() was given a window.
+    static bool isEnabled();
+
+    /// Read the rows of 'query' in a pass shared with the other tasks that
+    /// have the same 'key' and table. 'key' should identify the chunk, the
+    /// database and the user, as only their tasks may share a pass.
+    /// @param othersPending - false if no other task may join a pass led by
+    ///        this task, which then runs 'query' itself without waiting.
+    /// @param runFunc - runs the merged query if this task leads the pass.
+    /// @param cancelled - stops waiting for the pass when set.
+    /// @return the rows of 'query', or nullptr if the task needs to run 'query'
+    ///         itself. The rows don't depend on the connection or result of
+    ///         the leader, which may be freed.
+    static std::unique_ptr<wbase::RowSource> run(std::string const& key, std::string const& query,
+                                                 bool othersPending, RunFunc const& runFunc,
+                                                 std::atomic<bool> const& cancelled);
+
+    /// @return a JSON representation of the configuration and usage of passes.
+    static nlohmann::json statusToJson();
+
+    /// Split 'query' into 'fragment'.
+    /// @return false if 'query' can't share a pass.
+    static bool parse(std::string const& query, Fragment& fragment);
+
+    /// @return the query reading the rows of all 'fragments', which must have
+    ///         the same table, in a single pass.
+    static std::string mergeQueries(std::vector<Fragment> const& fragments);
+
+    /// @return the name of the flag column of the i-th fragment of a merged query.
+    static std::string flagName(int i);
+
+private:
+    class Pass;
+
+    /// Run the merged query of 'pass' and fill the buffers of its members.
+    /// @return false if no member got its rows.
+    static bool _runPass(Pass& pass, RunFunc const& runFunc, std::atomic<bool> const& cancelled);
+
+    static std::mutex _mtx;  ///< Protects _passes, _memMan and the members of passes.
+    static std::map<std::string, std::shared_ptr<Pass>> _passes;  ///< Passes that can be joined.
+    static std::shared_ptr<memman::MemMan> _memMan;
+
+    static std::atomic<unsigned int> _windowMs;
+    static std::atomic<unsigned int> _maxQueries;
+    static std::atomic<uint64_t> _maxBytesPerQuery;
+    static std::atomic<uint64_t> _passesRun;      ///< Merged queries run since the worker started.
+    static std::atomic<uint64_t> _queriesShared;  ///< Tasks given their rows by a merged query.
+    static std::atomic<uint64_t> _fallbacks;      ///< Tasks that joined a pass but ran their own query.
+    static std::atomic<uint64_t> _memoryRefusals;  ///< Passes not run as memman had no room for the buffers.
+};
+
+}  // namespace lsst::qserv::wdb
+
+#endif  // LSST_QSERV_WDB_SHAREDSCAN_H
@@ -31,6 +31,8 @@
 #include <memory>
 
 // Qserv headers
+#include "memman/MemManNone.h"
+#include "sql/SqlErrorObject.h"
 #include "wdb/ChunkResource.h"
 
 // Boost unit test header
@@ -43,6 +45,29 @@ using lsst::qserv::wdb::ChunkResource;
 using lsst::qserv::wdb::ChunkResourceMgr;
 using lsst::qserv::wdb::FakeBackend;
 
+namespace {
+
+/// Reserves at most 'maxBytes' with reserveBytes().
+class LimitedMemMan : public lsst::qserv::memman::MemManNone {
+public:
+    explicit LimitedMemMan(uint64_t maxBytes) : MemManNone(maxBytes, true), _maxBytes(maxBytes) {}
+
+    bool reserveBytes(uint64_t bytes) override {
+        if (reserved + bytes > _maxBytes) return false;
+        reserved += bytes;
+        return true;
+    }
+
+    void releaseBytes(uint64_t bytes) override { reserved -= bytes; }
+
+    uint64_t reserved = 0;
+
+private:
+    uint64_t const _maxBytes;
+};
+
+}  // namespace
+
 struct Fixture {
     Fixture() {
         for (int i = 11; i < 16; ++i) {
@@ -139,4 +164,125 @@ BOOST_AUTO_TEST_CASE(TwoChunk) {
     BOOST_CHECK(backend->fakeSet.size() == 0);
 }
 
+BOOST_AUTO_TEST_CASE(Cache) {
+    auto backend = std::make_shared<FakeBackend>();
+    backend->fakeBytes = 100000;
+    // Room for 4 tables.
+    std::shared_ptr<ChunkResourceMgr> crm = ChunkResourceMgr::newMgr(backend, 450000);
+    subchunks = {11, 12};
+    {
+        ChunkResource cr(crm->acquire(thedb, 1, tables, subchunks));
+        BOOST_CHECK_EQUAL(backend->fakeSet.size(), 4u);  // 2 tables * 2 subchunks
+        BOOST_CHECK_EQUAL(backend->loadCount, 1);
+    }
+    // The tables are kept after they are released, and aren't built again.
+    BOOST_CHECK_EQUAL(crm->getRefCount(thedb, 1), 0);
+    BOOST_CHECK_EQUAL(backend->fakeSet.size(), 4u);
+    {
+        ChunkResource cr(crm->acquire(thedb, 1, tables, subchunks));
+        BOOST_CHECK_EQUAL(backend->loadCount, 1);
+    }
+    // Building 2 more tables drops the 2 least recently used.
+    std::vector<int> other = {11};
+    {
+        ChunkResource cr(crm->acquire(thedb, 2, tables, other));
+        BOOST_CHECK_EQUAL(backend->loadCount, 2);
+        BOOST_CHECK_EQUAL(backend->fakeSet.size(), 6u);
+    }
+    BOOST_CHECK_EQUAL(backend->fakeSet.size(), 4u);
+    {
+        ChunkResource cr(crm->acquire(thedb, 2, tables, other));
+        BOOST_CHECK_EQUAL(backend->loadCount, 2);
+    }
+    auto status = crm->statusToJson();
+    BOOST_CHECK_EQUAL(status["hits"].get<uint64_t>(), 6u);
+    BOOST_CHECK_EQUAL(status["misses"].get<uint64_t>(), 6u);
+    BOOST_CHECK_EQUAL(status["evictions"].get<uint64_t>(), 2u);
+    BOOST_CHECK_EQUAL(status["tablesCached"].get<uint64_t>(), 4u);
+    BOOST_CHECK_EQUAL(status["bytesCached"].get<uint64_t>(), 400000u);
+    BOOST_CHECK_EQUAL(status["tablesInUse"].get<uint64_t>(), 0u);
+
+    // Cached tables are dropped with the manager.
+    crm.reset();
+    BOOST_CHECK(backend->fakeSet.empty());
+}
+
+BOOST_AUTO_TEST_CASE(CacheInvalidation) {
+    auto backend = std::make_shared<FakeBackend>();
+    std::shared_ptr<ChunkResourceMgr> crm = ChunkResourceMgr::newMgr(backend, 1000000);
+    subchunks = {11, 12};
+    { ChunkResource cr(crm->acquire(thedb, 1, tables, subchunks)); }
+    BOOST_CHECK_EQUAL(backend->loadCount, 1);
+    BOOST_CHECK_EQUAL(backend->fakeSet.size(), 4u);
+
+    // The chunk tables changed, the cached tables are dropped and built again.
+    backend->fakeVersion = "2";
+    {
+        ChunkResource cr(crm->acquire(thedb, 1, tables, subchunks));
+        BOOST_CHECK_EQUAL(backend->loadCount, 2);
+        BOOST_CHECK_EQUAL(backend->fakeSet.size(), 4u);
+    }
+    { ChunkResource cr(crm->acquire(thedb, 1, tables, subchunks)); }
+    BOOST_CHECK_EQUAL(backend->loadCount, 2);
+
+    // Tables whose chunk tables can't be found aren't kept.
+    backend->fakeVersion = "";
+    { ChunkResource cr(crm->acquire(thedb, 1, tables, subchunks)); }
+    BOOST_CHECK_EQUAL(backend->loadCount, 3);
+    BOOST_CHECK(backend->fakeSet.empty());
+
+    auto status = crm->statusToJson();
+    BOOST_CHECK_EQUAL(status["invalidations"].get<uint64_t>(), 8u);
+    BOOST_CHECK_EQUAL(status["tablesCached"].get<uint64_t>(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(CacheLoadFailure) {
+    auto backend = std::make_shared<FakeBackend>();
+    std::shared_ptr<ChunkResourceMgr> crm = ChunkResourceMgr::newMgr(backend, 1000000);
+    subchunks = {11};
+    { ChunkResource cr(crm->acquire(thedb, 1, tables, subchunks)); }
+    BOOST_CHECK_EQUAL(backend->fakeSet.size(), 2u);
+
+    // The tables taken from the cache are kept again when building the others fails.
+    backend->fakeLoadFails = true;
+    std::vector<int> more = {11, 12};
+    BOOST_CHECK_THROW(crm->acquire(thedb, 1, tables, more), lsst::qserv::sql::SqlErrorObject);
+    BOOST_CHECK_EQUAL(crm->getRefCount(thedb, 1), 0);
+    auto status = crm->statusToJson();
+    BOOST_CHECK_EQUAL(status["tablesInUse"].get<uint64_t>(), 0u);
+    BOOST_CHECK_EQUAL(status["bytesInUse"].get<uint64_t>(), 0u);
+    BOOST_CHECK_EQUAL(status["tablesCached"].get<uint64_t>(), 2u);
+
+    backend->fakeLoadFails = false;
+    { ChunkResource cr(crm->acquire(thedb, 1, tables, subchunks)); }
+    BOOST_CHECK_EQUAL(backend->loadCount, 2);
+    crm.reset();
+    BOOST_CHECK(backend->fakeSet.empty());
+}
+
+BOOST_AUTO_TEST_CASE(CacheMemMan) {
+    auto backend = std::make_shared<FakeBackend>();
+    backend->fakeBytes = 100000;
+    // memman only has room for 3 tables.
+    auto memMan = std::make_shared<LimitedMemMan>(350000);
+    std::shared_ptr<ChunkResourceMgr> crm = ChunkResourceMgr::newMgr(backend, 1000000, memMan);
+    subchunks = {11, 12};
+    { ChunkResource cr(crm->acquire(thedb, 1, tables, subchunks)); }
+    BOOST_CHECK_EQUAL(backend->fakeSet.size(), 3u);
+    BOOST_CHECK_EQUAL(memMan->reserved, 300000u);
+
+    // Tables taken from the cache aren't counted in memman while they are used.
+    {
+        ChunkResource cr(crm->acquire(thedb, 1, tables, subchunks));
+        BOOST_CHECK_EQUAL(backend->loadCount, 2);
+        BOOST_CHECK_EQUAL(memMan->reserved, 0u);
+    }
+    auto status = crm->statusToJson();
+    BOOST_CHECK_EQUAL(status["tablesCached"].get<uint64_t>(), 3u);
+    BOOST_CHECK_EQUAL(status["evictions"].get<uint64_t>(), 2u);
+
+    crm.reset();
+    BOOST_CHECK_EQUAL(memMan->reserved, 0u);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
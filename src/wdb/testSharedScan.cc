@@ -0,0 +1,424 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// System headers
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Third-party headers
+#include <mysql/mysql.h>
+
+// Qserv headers
+#include "memman/MemManNone.h"
+#include "wbase/RowSource.h"
+#include "wdb/SharedScan.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE SharedScan_1
+#include <boost/test/unit_test.hpp>
+
+namespace test = boost::test_tools;
+
+using namespace std;
+using lsst::qserv::wbase::RowSource;
+using lsst::qserv::wdb::SharedScan;
+
+namespace {
+
+/// A query on the fake table T_1, which has the columns 'id' and 'val'.
+struct Spec {
+    string query;
+    string where;
+    vector<string> columns;
+    function<bool(int)> match;
+};
+
+vector<Spec> const testSpecs = {
+        {"SELECT id FROM db.T_1 AS t WHERE id % 2 = 0", "id % 2 = 0", {"id"},
+         [](int r) { return r % 2 == 0; }},
+        {"SELECT id, val FROM db.T_1 AS t WHERE id < 10", "id < 10", {"id", "val"},
+         [](int r) { return r < 10; }},
+        {"SELECT val FROM db.T_1 AS t WHERE id >= 990", "id >= 990", {"val"},
+         [](int r) { return r >= 990; }}};
+
+/// The value of a column of the fake table, NULL is "NULL".
+string value(string const& column, int r) {
+    if (column == "id") return to_string(r);
+    return r % 10 == 7 ? "NULL" : to_string(3 * r);
+}
+
+/// Used by the benchmark to make the readers of the fake table take turns,
+/// as if they were reading the same disk.
+mutex diskMtx;
+
+/// The rows of the fake table for one of 'specs', or for a query merging them.
+class FakeTable : public RowSource {
+public:
+    FakeTable(string const& sql, vector<Spec> const& specs, int numRows,
+              chrono::microseconds diskTime = chrono::microseconds(0))
+            : _specs(specs), _numRows(numRows), _diskTime(diskTime) {
+        for (size_t s = 0; s < specs.size(); ++s) {
+            if (sql == specs[s].query) _add(s, false);
+        }
+        // The flag columns of a merged query are in the order of its members.
+        for (bool found = _columns.empty(); found;) {
+            string const flag = ") IS TRUE AS `" + SharedScan::flagName(_numMembers) + "`";
+            found = false;
+            for (size_t s = 0; s < specs.size() && !found; ++s) {
+                found = sql.find("(" + specs[s].where + flag) != string::npos;
+                if (found) _add(s, true);
+            }
+        }
+        if (_columns.empty()) throw runtime_error("unknown query " + sql);
+        for (auto const& column : _columns) {
+            MYSQL_FIELD field = MYSQL_FIELD();
+            field.name = const_cast<char*>(column.second.c_str());
+            field.type = MYSQL_TYPE_LONG;
+            _fields.push_back(field);
+        }
+        _row.resize(_columns.size());
+        _lengths.resize(_columns.size());
+    }
+
+    int getNumFields() override { return _columns.size(); }
+    MYSQL_FIELD const* getFields() override { return _fields.data(); }
+
+    char const* const* nextRow(unsigned long const*& lengths) override {
+        if (_next == _numRows) return nullptr;
+        if (_diskTime.count() > 0 && _next % 4096 == 0) {
+            lock_guard<mutex> lock(diskMtx);
+            this_thread::sleep_for(_diskTime);
+        }
+        int const r = _next++;
+        _id = value("id", r);
+        _val = value("val", r);
+        for (size_t c = 0; c < _columns.size(); ++c) {
+            string const& name = _columns[c].second;
+            if (name == "id") {
+                _row[c] = _id.c_str();
+                _lengths[c] = _id.size();
+            } else if (name == "val") {
+                _row[c] = _val == "NULL" ? nullptr : _val.c_str();
+                _lengths[c] = _val.size();
+            } else {
+                _row[c] = _specs[_columns[c].first].match(r) ? "1" : "0";
+                _lengths[c] = 1;
+            }
+        }
+        lengths = _lengths.data();
+        return _row.data();
+    }
+
+private:
+    void _add(int s, bool flag) {
+        if (flag) _columns.emplace_back(s, SharedScan::flagName(_numMembers++));
+        for (auto const& column : _specs[s].columns) _columns.emplace_back(s, column);
+    }
+
+    vector<Spec> const& _specs;
+    int const _numRows;
+    chrono::microseconds const _diskTime;
+    int _next = 0;
+    int _numMembers = 0;
+    vector<pair<int, string>> _columns;  ///< The spec and name of each column.
+    vector<MYSQL_FIELD> _fields;
+    string _id;
+    string _val;
+    vector<char const*> _row;
+    vector<unsigned long> _lengths;
+};
+
+/// @return all rows of 'rows', with NULL values as "NULL".
+vector<vector<string>> readAll(RowSource& rows) {
+    vector<vector<string>> result;
+    unsigned long const* lengths;
+    while (char const* const* row = rows.nextRow(lengths)) {
+        vector<string> values;
+        for (int c = 0; c < rows.getNumFields(); ++c) {
+            values.push_back(row[c] == nullptr ? "NULL" : string(row[c], lengths[c]));
+        }
+        result.push_back(values);
+    }
+    return result;
+}
+
+/// @return the rows 'testSpecs[s]' should have.
+vector<vector<string>> expected(int s, int numRows) {
+    vector<vector<string>> result;
+    for (int r = 0; r < numRows; ++r) {
+        if (!testSpecs[s].match(r)) continue;
+        vector<string> values;
+        for (auto const& column : testSpecs[s].columns) values.push_back(value(column, r));
+        result.push_back(values);
+    }
+    return result;
+}
+
+/// Reserves at most 'maxBytes' with reserveBytes().
+class LimitedMemMan : public lsst::qserv::memman::MemManNone {
+public:
+    explicit LimitedMemMan(uint64_t maxBytes) : MemManNone(maxBytes, true), _maxBytes(maxBytes) {}
+
+    bool reserveBytes(uint64_t bytes) override {
+        if (reserved + bytes > _maxBytes) return false;
+        reserved += bytes;
+        return true;
+    }
+
+    void releaseBytes(uint64_t bytes) override { reserved -= bytes; }
+
+    atomic<uint64_t> reserved{0};
+
+private:
+    uint64_t const _maxBytes;
+};
+
+struct Fixture {
+    ~Fixture() { SharedScan::setup(0, 0, 0); }
+
+    /// Run the first 'numQueries' test specs together, and return the rows each got.
+    vector<unique_ptr<RowSource>> runTogether(int numQueries, SharedScan::RunFunc const& runFunc,
+                                              string const& otherKey = string()) {
+        vector<unique_ptr<RowSource>> rows(numQueries);
+        vector<thread> threads;
+        for (int s = 0; s < numQueries; ++s) {
+            threads.emplace_back([&, s]() {
+                string const key = s == 1 && !otherKey.empty() ? otherKey : "db:1:user";
+                rows[s] = SharedScan::run(key, testSpecs[s].query, true, runFunc, cancelled);
+            });
+        }
+        for (auto& t : threads) t.join();
+        return rows;
+    }
+
+    atomic<bool> cancelled{false};
+    atomic<int> numRuns{0};
+    int const numRows = 1000;
+    SharedScan::RunFunc const runFunc = [this](string const& sql) -> unique_ptr<RowSource> {
+        ++numRuns;
+        return make_unique<FakeTable>(sql, testSpecs, numRows);
+    };
+};
+
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE(Suite, Fixture)
+
+BOOST_AUTO_TEST_CASE(Parse) {
+    SharedScan::Fragment f;
+    BOOST_CHECK(SharedScan::parse("SELECT o.ra, o.decl FROM LSST.Object_100 AS o WHERE o.ra > 10", f));
+    BOOST_CHECK_EQUAL(f.select, "o.ra, o.decl");
+    BOOST_CHECK_EQUAL(f.from, "LSST.Object_100 AS o");
+    BOOST_CHECK_EQUAL(f.where, "o.ra > 10");
+
+    BOOST_CHECK(SharedScan::parse(
+            "SELECT *, scisql_s2PtInBox(ra, decl, 1, 2, 3, 4) AS `in` FROM `LSST`.`Object_100` `QST_1_` "
+            "WHERE name = 'a;b, GROUP BY' ;",
+            f));
+    BOOST_CHECK_EQUAL(f.select, "`QST_1_`.*, scisql_s2PtInBox(ra, decl, 1, 2, 3, 4) AS `in`");
+    BOOST_CHECK_EQUAL(f.from, "`LSST`.`Object_100` `QST_1_`");
+    BOOST_CHECK_EQUAL(f.where, "name = 'a;b, GROUP BY'");
+
+    BOOST_CHECK(SharedScan::parse("select * from LSST.Object_100", f));
+    BOOST_CHECK_EQUAL(f.select, "LSST.Object_100.*");
+    BOOST_CHECK_EQUAL(f.where, "");
+
+    for (string const query :
+         {"SELECT COUNT(*) FROM LSST.Object_100", "SELECT ra FROM LSST.Object_100 ORDER BY ra",
+          "SELECT ra FROM LSST.Object_100 LIMIT 10", "SELECT ra FROM LSST.Object_100 GROUP BY ra",
+          "SELECT DISTINCT ra FROM LSST.Object_100", "SELECT o.ra FROM LSST.Object_100 o, LSST.Source_100 s",
+          "SELECT o.ra FROM LSST.Object_100 o JOIN LSST.Source_100 s ON o.id = s.id",
+          "SELECT ra FROM LSST.Object_100 WHERE id IN (SELECT id FROM LSST.Source_100)",
+          "SELECT ra FROM LSST.Object_100; DROP TABLE x", "SELECT ra FROM LSST.Object_100 WHERE",
+          "SELECT ra FROM LSST.Object_100 WHERE name = 'a", "SELECT @a := ra FROM LSST.Object_100",
+          "SELECT ra FROM LSST.Object_100 UNION SELECT ra FROM LSST.Object_101",
+          "SELECT ra, SUM (decl) FROM LSST.Object_100", "SELECT ra FROM (LSST.Object_100)",
+          "SELECT ra FROM LSST.Object_100 WHERE ra > 1 -- comment", "SELECT FROM LSST.Object_100",
+          "DELETE FROM LSST.Object_100"}) {
+        BOOST_CHECK_MESSAGE(!SharedScan::parse(query, f), query);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(MergeQueries) {
+    vector<SharedScan::Fragment> fragments(2);
+    BOOST_REQUIRE(SharedScan::parse("SELECT a FROM db.T_1 t WHERE a > 1", fragments[0]));
+    BOOST_REQUIRE(SharedScan::parse("SELECT * FROM db.T_1 t WHERE b = 2 OR c = 3", fragments[1]));
+    BOOST_CHECK_EQUAL(SharedScan::mergeQueries(fragments),
+                      "SELECT (a > 1) IS TRUE AS `QSERV_SHARED_SCAN_FLAG_0`, a, "
+                      "(b = 2 OR c = 3) IS TRUE AS `QSERV_SHARED_SCAN_FLAG_1`, t.* "
+                      "FROM db.T_1 t WHERE (a > 1) OR (b = 2 OR c = 3)");
+    // A query without a WHERE clause needs all rows.
+    BOOST_REQUIRE(SharedScan::parse("SELECT b FROM db.T_1 t", fragments[1]));
+    BOOST_CHECK_EQUAL(SharedScan::mergeQueries(fragments),
+                      "SELECT (a > 1) IS TRUE AS `QSERV_SHARED_SCAN_FLAG_0`, a, "
+                      "1 AS `QSERV_SHARED_SCAN_FLAG_1`, b FROM db.T_1 t");
+}
+
+BOOST_AUTO_TEST_CASE(Disabled) {
+    SharedScan::setup(0, 16, 1'000'000);
+    BOOST_CHECK(!SharedScan::isEnabled());
+    BOOST_CHECK(SharedScan::run("db:1:user", testSpecs[0].query, true, runFunc, cancelled) == nullptr);
+    BOOST_CHECK_EQUAL(numRuns, 0);
+}
+
+BOOST_AUTO_TEST_CASE(Shared) {
+    // The pass starts as soon as it is full, well before the end of the window.
+    SharedScan::setup(60'000, 3, 1'000'000);
+    BOOST_CHECK(SharedScan::isEnabled());
+    auto start = chrono::steady_clock::now();
+    auto rows = runTogether(3, runFunc);
+    BOOST_CHECK(chrono::steady_clock::now() - start < chrono::seconds(30));
+    BOOST_CHECK_EQUAL(numRuns, 1);
+    for (int s = 0; s < 3; ++s) {
+        BOOST_REQUIRE(rows[s] != nullptr);
+        vector<string> const& columns = testSpecs[s].columns;
+        BOOST_REQUIRE_EQUAL(rows[s]->getNumFields(), static_cast<int>(columns.size()));
+        for (size_t c = 0; c < columns.size(); ++c) {
+            BOOST_CHECK_EQUAL(rows[s]->getFields()[c].name, columns[c]);
+            BOOST_CHECK_EQUAL(rows[s]->getFields()[c].type, MYSQL_TYPE_LONG);
+        }
+        BOOST_CHECK(readAll(*rows[s]) == expected(s, numRows));
+    }
+    auto const status = SharedScan::statusToJson();
+    BOOST_CHECK_EQUAL(status["passesRun"].get<uint64_t>(), 1u);
+    BOOST_CHECK_EQUAL(status["queriesShared"].get<uint64_t>(), 3u);
+}
+
+BOOST_AUTO_TEST_CASE(Alone) {
+    // Tasks with different keys don't share a pass, and run their own query
+    // at the end of the window.
+    SharedScan::setup(200, 3, 1'000'000);
+    auto rows = runTogether(2, runFunc, "db:2:user");
+    BOOST_CHECK(rows[0] == nullptr);
+    BOOST_CHECK(rows[1] == nullptr);
+    BOOST_CHECK_EQUAL(numRuns, 0);
+}
+
+BOOST_AUTO_TEST_CASE(NothingPending) {
+    // The leader doesn't wait if the scheduler has no other tasks on the chunk.
+    SharedScan::setup(60'000, 3, 1'000'000);
+    auto start = chrono::steady_clock::now();
+    BOOST_CHECK(SharedScan::run("db:1:user", testSpecs[0].query, false, runFunc, cancelled) == nullptr);
+    BOOST_CHECK(chrono::steady_clock::now() - start < chrono::seconds(30));
+    BOOST_CHECK_EQUAL(numRuns, 0);
+}
+
+BOOST_AUTO_TEST_CASE(Memory) {
+    // The buffers of 3 queries need 3 MB, which doesn't fit.
+    auto memMan = make_shared<LimitedMemMan>(2'000'000);
+    SharedScan::setup(60'000, 3, 1'000'000, memMan);
+    auto rows = runTogether(3, runFunc);
+    BOOST_CHECK_EQUAL(numRuns, 0);
+    for (auto const& r : rows) BOOST_CHECK(r == nullptr);
+    BOOST_CHECK_EQUAL(SharedScan::statusToJson()["memoryRefusals"].get<uint64_t>(), 1u);
+
+    // The memory is reserved while the buffers exist.
+    memMan = make_shared<LimitedMemMan>(3'000'000);
+    SharedScan::setup(60'000, 3, 1'000'000, memMan);
+    rows = runTogether(3, runFunc);
+    BOOST_CHECK_EQUAL(numRuns, 1);
+    BOOST_CHECK_EQUAL(memMan->reserved, 3'000'000u);
+    rows.clear();
+    BOOST_CHECK_EQUAL(memMan->reserved, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(Overflow) {
+    // The 500 rows of the first query don't fit, the others do.
+    SharedScan::setup(60'000, 3, 5000);
+    auto rows = runTogether(3, runFunc);
+    BOOST_CHECK_EQUAL(numRuns, 1);
+    BOOST_CHECK(rows[0] == nullptr);
+    BOOST_REQUIRE(rows[1] != nullptr && rows[2] != nullptr);
+    BOOST_CHECK(readAll(*rows[1]) == expected(1, numRows));
+    BOOST_CHECK(readAll(*rows[2]) == expected(2, numRows));
+}
+
+BOOST_AUTO_TEST_CASE(Failed) {
+    // All tasks run their own query if the merged query fails.
+    SharedScan::setup(60'000, 3, 1'000'000);
+    auto rows = runTogether(3, [this](string const&) -> unique_ptr<RowSource> {
+        ++numRuns;
+        throw runtime_error("failed");
+    });
+    BOOST_CHECK_EQUAL(numRuns, 1);
+    for (auto const& r : rows) BOOST_CHECK(r == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(Cancelled) {
+    // A cancelled leader stops waiting for others to join.
+    SharedScan::setup(60'000, 3, 1'000'000);
+    cancelled = true;
+    auto start = chrono::steady_clock::now();
+    BOOST_CHECK(SharedScan::run("db:1:user", testSpecs[0].query, true, runFunc, cancelled) == nullptr);
+    BOOST_CHECK(chrono::steady_clock::now() - start < chrono::seconds(30));
+    BOOST_CHECK_EQUAL(numRuns, 0);
+}
+
+/// Compare the throughput of table scans run by each query and shared by all
+/// queries, for different numbers of queries on the same chunk. Reading the
+/// table takes turns on a simulated disk. Disabled by default, run it with:
+///   testSharedScan --run_test=Suite/ScanBenchmark
+BOOST_AUTO_TEST_CASE(ScanBenchmark, *boost::unit_test::disabled()) {
+    int const tableRows = 1'000'000;
+    chrono::microseconds const diskTime(2000);
+    // Each query selects a sixteenth of the rows.
+    vector<Spec> specs;
+    for (int i = 0; i < 16; ++i) {
+        string const where = "id % 16 = " + to_string(i);
+        specs.push_back(Spec{"SELECT id, val FROM db.T_1 AS t WHERE " + where, where, {"id", "val"},
+                             [i](int r) { return r % 16 == i; }});
+    }
+    SharedScan::RunFunc const scan = [&](string const& sql) -> unique_ptr<RowSource> {
+        return make_unique<FakeTable>(sql, specs, tableRows, diskTime);
+    };
+    for (int numQueries : {1, 2, 4, 8, 16}) {
+        for (bool shared : {false, true}) {
+            SharedScan::setup(shared ? 60'000 : 0, numQueries, 1'000'000'000);
+            auto start = chrono::steady_clock::now();
+            vector<thread> threads;
+            for (int s = 0; s < numQueries; ++s) {
+                threads.emplace_back([&, s]() {
+                    auto rows = SharedScan::run("db:1:user", specs[s].query, numQueries > 1, scan, cancelled);
+                    if (rows == nullptr) rows = scan(specs[s].query);
+                    unsigned long const* lengths;
+                    while (rows->nextRow(lengths) != nullptr) {
+                    }
+                });
+            }
+            for (auto& t : threads) t.join();
+            chrono::duration<double> secs = chrono::steady_clock::now() - start;
+            cout << (shared ? "shared   " : "unshared ") << numQueries << " queries: " << secs.count()
+                 << " s, " << (numQueries / secs.count()) << " queries/s, "
+                 << (numQueries * tableRows / secs.count() / 1e6) << " M rows/s" << endl;
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
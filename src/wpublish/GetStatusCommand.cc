@@ -28,6 +28,7 @@
 #include "proto/worker.pb.h"
 #include "wbase/MsgProcessor.h"
 #include "wbase/SendChannel.h"
+#include "wbase/TaskTemplateCache.h"
 #include "wpublish/ResourceMonitor.h"
 
 // LSST headers
@@ -45,8 +46,12 @@ namespace lsst::qserv::wpublish {
 
 GetStatusCommand::GetStatusCommand(shared_ptr<wbase::SendChannel> const& sendChannel,
                                    shared_ptr<wbase::MsgProcessor> const& processor,
-                                   shared_ptr<ResourceMonitor> const& resourceMonitor)
-        : wbase::WorkerCommand(sendChannel), _processor(processor), _resourceMonitor(resourceMonitor) {}
+                                   shared_ptr<ResourceMonitor> const& resourceMonitor,
+                                   shared_ptr<wbase::TaskTemplateCache> const& templateCache)
+        : wbase::WorkerCommand(sendChannel),
+          _processor(processor),
+          _resourceMonitor(resourceMonitor),
+          _templateCache(templateCache) {}
 
 void GetStatusCommand::run() {
     LOGS(_log, LOG_LVL_DEBUG, "GetStatusCommand::" << __func__);
@@ -54,6 +59,7 @@ void GetStatusCommand::run() {
     nlohmann::json result;
     result["processor"] = _processor->statusToJson();
     result["resources"] = _resourceMonitor->statusToJson();
+    result["task_templates"] = _templateCache->statusToJson();
 
     proto::WorkerCommandGetStatusR reply;
     reply.set_info(result.dump());
@@ -34,6 +34,7 @@ namespace lsst::qserv {
 namespace wbase {
 class MsgProcessor;
 class SendChannel;
+class TaskTemplateCache;
 }  // namespace wbase
 namespace wpublish {
 class ResourceMonitor;
@@ -58,10 +59,12 @@ public:
      * @param sendChannel      communication channel for reporting results
      * @param processor        message processor for extracting status info
      * @param resourceMonitor  XRootD resource monitor for finding which chunks are in use
+     * @param templateCache    templates of the messages sent by czars
      */
     explicit GetStatusCommand(std::shared_ptr<wbase::SendChannel> const& sendChannel,
                               std::shared_ptr<wbase::MsgProcessor> const& processor,
-                              std::shared_ptr<ResourceMonitor> const& resourceMonitor);
+                              std::shared_ptr<ResourceMonitor> const& resourceMonitor,
+                              std::shared_ptr<wbase::TaskTemplateCache> const& templateCache);
 
     ~GetStatusCommand() override = default;
 
@@ -72,6 +75,7 @@ private:
 
     std::shared_ptr<wbase::MsgProcessor> const _processor;
     std::shared_ptr<ResourceMonitor> _resourceMonitor;
+    std::shared_ptr<wbase::TaskTemplateCache> _templateCache;
 };
 
 }  // namespace lsst::qserv::wpublish
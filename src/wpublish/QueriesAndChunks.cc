@@ -236,6 +236,19 @@ void QueriesAndChunks::_finishedTaskForChunk(wbase::Task::Ptr const& task, doubl
     ChunkTableStats::Ptr tableStats = iter->add(tblName, minutes);
 }
 
+ChunkTableStats::Data QueriesAndChunks::getChunkTableData(int chunkId, string const& scanTableName) const {
+    ChunkStatistics::Ptr chunkStats;
+    {
+        lock_guard<mutex> g(_chunkMtx);
+        auto iter = _chunkStats.find(chunkId);
+        if (iter == _chunkStats.end()) return ChunkTableStats::Data();
+        chunkStats = iter->second;
+    }
+    auto tableStats = chunkStats->getStats(scanTableName);
+    if (tableStats == nullptr) return ChunkTableStats::Data();
+    return tableStats->getData();
+}
+
 /// Go through the list of possibly dead queries and remove those that are too old.
 void QueriesAndChunks::removeDead() {
     vector<QueryStatistics::Ptr> dList;
@@ -217,6 +217,10 @@ public:
     void startedTask(wbase::Task::Ptr const& task);
     void finishedTask(wbase::Task::Ptr const& task);
 
+    /// @return the statistics of 'scanTableName' in 'chunkId', with no tasks
+    ///         completed if there are none.
+    ChunkTableStats::Data getChunkTableData(int chunkId, std::string const& scanTableName) const;
+
     void examineAll();
 
     /// @return a JSON representation of the object's status for the monitoring
@@ -0,0 +1,102 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "wsched/ChunkOrder.h"
+
+// System headers
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+using namespace std;
+
+namespace lsst::qserv::wsched {
+
+ChunkOrder::Policy ChunkOrder::policyFromString(string const& str) {
+    if (str == "CHUNK_ID") return Policy::CHUNK_ID;
+    if (str == "SHORTEST_FIRST") return Policy::SHORTEST_FIRST;
+    if (str == "TASKS_PER_BYTE") return Policy::TASKS_PER_BYTE;
+    throw invalid_argument("ChunkOrder unknown policy '" + str +
+                           "', expected CHUNK_ID, SHORTEST_FIRST or TASKS_PER_BYTE");
+}
+
+string ChunkOrder::toString(Policy policy) {
+    switch (policy) {
+        case Policy::CHUNK_ID:
+            return "CHUNK_ID";
+        case Policy::SHORTEST_FIRST:
+            return "SHORTEST_FIRST";
+        case Policy::TASKS_PER_BYTE:
+            return "TASKS_PER_BYTE";
+        default:
+            return "UNKNOWN";
+    }
+}
+
+vector<size_t> ChunkOrder::rank(vector<Candidate> const& candidates) const {
+    vector<size_t> order(candidates.size());
+    iota(order.begin(), order.end(), 0);
+    if (_policy == Policy::CHUNK_ID) return order;
+
+    // Chunks without statistics are expected to cost as much as the average
+    // of the chunks with statistics.
+    double timedSeconds = 0.0;
+    unsigned int timedTasks = 0;
+    double knownBytes = 0.0;
+    unsigned int knownChunks = 0;
+    for (auto const& cand : candidates) {
+        timedSeconds += cand.expectedSeconds;
+        timedTasks += cand.timedTasks;
+        if (cand.bytes > 0) {
+            knownBytes += cand.bytes;
+            ++knownChunks;
+        }
+    }
+    double const secondsPerTask = (timedTasks > 0) ? timedSeconds / timedTasks : 1.0;
+    double const bytesPerChunk = (knownChunks > 0) ? knownBytes / knownChunks : 1.0;
+
+    // Lower costs are made active first.
+    vector<double> cost(candidates.size());
+    for (size_t j = 0; j < candidates.size(); ++j) {
+        auto const& cand = candidates[j];
+        if (_policy == Policy::SHORTEST_FIRST) {
+            cost[j] = cand.expectedSeconds + (cand.numTasks - cand.timedTasks) * secondsPerTask;
+        } else {
+            double const bytes = (cand.bytes > 0) ? cand.bytes : bytesPerChunk;
+            cost[j] = -(cand.numTasks / bytes);
+        }
+    }
+    auto starved = [this, &candidates](size_t j) {
+        return _maxPassedOver > 0 && candidates[j].passedOver >= _maxPassedOver;
+    };
+    stable_sort(order.begin(), order.end(), [&cost, &starved](size_t a, size_t b) {
+        bool const starvedA = starved(a);
+        bool const starvedB = starved(b);
+        if (starvedA != starvedB) return starvedA;
+        if (starvedA) return false;  // Starved chunks keep the scan order.
+        return cost[a] < cost[b];
+    });
+    return order;
+}
+
+}  // namespace lsst::qserv::wsched
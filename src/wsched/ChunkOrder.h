@@ -0,0 +1,87 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_WSCHED_CHUNKORDER_H
+#define LSST_QSERV_WSCHED_CHUNKORDER_H
+
+// System headers
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace lsst::qserv::wsched {
+
+/// ChunkOrder decides which chunk a ChunkTasksQueue makes active once the
+/// Tasks of the active chunk are done.
+///
+/// - CHUNK_ID takes the chunk with the next higher chunk id, wrapping around
+///   to the lowest. This is the original scan order.
+/// - SHORTEST_FIRST takes the chunk whose queued Tasks are expected to take
+///   the least time, so the most queries finish their work on a chunk soon.
+/// - TASKS_PER_BYTE takes the chunk serving the most Tasks for each byte its
+///   tables lock in memory.
+///
+/// A chunk that had Tasks but was passed over 'maxPassedOver' times is taken
+/// before the others, so no chunk waits for ever. Ties keep the scan order.
+class ChunkOrder {
+public:
+    enum class Policy { CHUNK_ID, SHORTEST_FIRST, TASKS_PER_BYTE };
+
+    /// @return the expected run time, in seconds, of a Task on 'scanTable' in
+    ///         'chunkId', or a negative value if it isn't known. 'scanTable'
+    ///         is named as in wpublish::ChunkTableStats.
+    using ExpectedTimeFunc = std::function<double(int chunkId, std::string const& scanTable)>;
+
+    /// What is known about a chunk that could become the active chunk.
+    struct Candidate {
+        int chunkId = 0;
+        unsigned int numTasks = 0;     ///< Tasks queued on the chunk.
+        unsigned int timedTasks = 0;   ///< Queued Tasks with an expected run time.
+        double expectedSeconds = 0.0;  ///< Sum of the expected run times of the 'timedTasks'.
+        std::uint64_t bytes = 0;       ///< Bytes the chunk locked the last time it ran, 0 if unknown.
+        unsigned int passedOver = 0;   ///< Times another chunk was made active while this one waited.
+    };
+
+    /// @throws std::invalid_argument if 'str' isn't the name of a policy.
+    static Policy policyFromString(std::string const& str);
+    static std::string toString(Policy policy);
+
+    /// @param maxPassedOver - 0 lets a chunk be passed over any number of times.
+    explicit ChunkOrder(Policy policy = Policy::CHUNK_ID, unsigned int maxPassedOver = 0)
+            : _policy(policy), _maxPassedOver(maxPassedOver) {}
+
+    Policy getPolicy() const { return _policy; }
+    unsigned int getMaxPassedOver() const { return _maxPassedOver; }
+
+    /// @param candidates - the chunks in scan order, starting after the active chunk.
+    /// @return the indices of 'candidates', the chunk to make active first.
+    std::vector<std::size_t> rank(std::vector<Candidate> const& candidates) const;
+
+private:
+    Policy _policy;
+    unsigned int _maxPassedOver;
+};
+
+}  // namespace lsst::qserv::wsched
+
+#endif  // LSST_QSERV_WSCHED_CHUNKORDER_H
@@ -64,6 +64,9 @@ public:
     /// @return a pointer to the removed task or nullptr if the task was not found.
     virtual wbase::Task::Ptr removeTask(wbase::Task::Ptr const& task) = 0;
 
+    /// @return the number of Tasks on the chunk that are queued or running.
+    virtual std::size_t getChunkTaskCount(int chunkId) const = 0;
+
     virtual std::string queueInfo() const = 0;
 };
 
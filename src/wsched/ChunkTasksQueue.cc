@@ -30,9 +30,12 @@
 #include "lsst/log/Log.h"
 
 // Qserv headers
+#include "wpublish/QueriesAndChunks.h"
+#include "wsched/SchedulerTrace.h"
 
 namespace {
 LOG_LOGGER _log = LOG_GET("lsst.qserv.wsched.ChunkTasksQueue");
+LOG_LOGGER _traceLog = LOG_GET("lsst.qserv.wsched.SchedulerTrace");
 }
 
 namespace lsst::qserv::wsched {
@@ -96,27 +99,24 @@ bool ChunkTasksQueue::_ready(bool useFlexibleLock) {
         return false;
     }
 
-    // If the _activeChunk is invalid, start at the beginning.
+    // If the _activeChunk is invalid, start over.
     if (_activeChunk == _chunkMap.end()) {
         LOGS(_log, LOG_LVL_INFO, "ChunkTasksQueue::_ready _activeChunk invalid, reset");
-        _activeChunk = _chunkMap.begin();
+        _activeChunk = _nextActive(_chunkMap.end());
         _activeChunk->second->setActive();  // Flag tasks on active so new Tasks added wont be run.
     }
 
     // Check the active chunk for valid Tasks
     if (_activeChunk->second->ready(useFlexibleLock) == ChunkTasks::ReadyState::READY) {
         _readyChunk = _activeChunk->second;
+        _prefetchAfter(_activeChunk);
         return true;
     }
 
     // Should the active chunk be advanced?
     if (_activeChunk->second->readyToAdvance()) {
         LOGS(_log, LOG_LVL_DEBUG, "ChunkTasksQueue::_ready advancing chunk");
-        auto newActive = _activeChunk;
-        ++newActive;
-        if (newActive == _chunkMap.end()) {
-            newActive = _chunkMap.begin();
-        }
+        auto newActive = _nextActive(_activeChunk);
 
         // Clean up the old _active chunk before moving on.
         _activeChunk->second->setActive(false);  // This should move pending Tasks to _activeTasks
@@ -171,9 +171,82 @@ bool ChunkTasksQueue::_ready(bool useFlexibleLock) {
         return false;
     }
     _readyChunk = iter->second;
+    _prefetchAfter(iter);
     return true;
 }
 
+ChunkTasksQueue::ChunkMap::iterator ChunkTasksQueue::_nextActive(ChunkMap::iterator current) {
+    auto first = current;
+    if (first == _chunkMap.end() || ++first == _chunkMap.end()) {
+        first = _chunkMap.begin();
+    }
+    if (_chunkOrder.getPolicy() == ChunkOrder::Policy::CHUNK_ID) {
+        return first;
+    }
+
+    // Rank every other chunk, in scan order from 'current'.
+    std::vector<ChunkMap::iterator> iters;
+    std::vector<ChunkOrder::Candidate> candidates;
+    for (auto iter = first; iter != current;) {
+        candidates.push_back(iter->second->makeCandidate(_expectedTime));
+        auto bytes = _chunkBytes.find(iter->first);
+        if (bytes != _chunkBytes.end()) {
+            candidates.back().bytes = bytes->second;
+        }
+        iters.push_back(iter);
+        if (++iter == _chunkMap.end()) {
+            iter = _chunkMap.begin();
+            if (current == _chunkMap.end()) break;
+        }
+    }
+    if (candidates.empty()) {
+        return current;  // 'current' is the only chunk.
+    }
+    auto order = _chunkOrder.rank(candidates);
+    auto const& chosen = candidates[order[0]];
+    LOGS(_log, LOG_LVL_DEBUG,
+         "ChunkTasksQueue::_nextActive " << ChunkOrder::toString(_chunkOrder.getPolicy())
+                                         << " chunk=" << chosen.chunkId << " tasks=" << chosen.numTasks
+                                         << " expectedSeconds=" << chosen.expectedSeconds
+                                         << " bytes=" << chosen.bytes << " passedOver=" << chosen.passedOver
+                                         << " of " << candidates.size());
+    _nextChunkIds.clear();
+    for (size_t j = 1; j < order.size(); ++j) {
+        auto const& cand = candidates[order[j]];
+        if (cand.numTasks > 0) {
+            iters[order[j]]->second->passOver();
+            _nextChunkIds.push_back(cand.chunkId);
+        }
+    }
+    return iters[order[0]];
+}
+
+void ChunkTasksQueue::_prefetchAfter(ChunkMap::iterator iter) {
+    int depth = _memMan->getPrefetchDepth();
+    if (_chunkOrder.getPolicy() != ChunkOrder::Policy::CHUNK_ID) {
+        // Prefetch the chunks expected to be made active next.
+        for (auto chunkId : _nextChunkIds) {
+            if (depth <= 0) break;
+            auto next = _chunkMap.find(chunkId);
+            if (next == _chunkMap.end() || next == iter) continue;
+            next->second->prefetch();
+            --depth;
+        }
+        return;
+    }
+    auto next = iter;
+    for (int j = 0; j < depth; ++j) {
+        ++next;
+        if (next == _chunkMap.end()) {
+            next = _chunkMap.begin();
+        }
+        if (next == iter) {
+            break;  // Every chunk has been prefetched.
+        }
+        next->second->prefetch();
+    }
+}
+
 wbase::Task::Ptr ChunkTasksQueue::getTask(bool useFlexibleLock) {
     std::lock_guard<std::mutex> lock(_mapMx);
     // Attempt to set _readyChunk.
@@ -195,6 +268,40 @@ void ChunkTasksQueue::taskComplete(wbase::Task::Ptr const& task) {
     if (iter != _chunkMap.end()) {
         iter->second->taskComplete(task);
     }
+    bool const trace = LOG_CHECK_LVL(_traceLog, LOG_LVL_DEBUG);
+    bool const perByte = _chunkOrder.getPolicy() == ChunkOrder::Policy::TASKS_PER_BYTE;
+    if (!trace && !perByte) return;
+
+    // The tables are still locked, as the scheduler unlocks them after this.
+    uint64_t bytes = 0;
+    if (task->hasMemHandle()) {
+        bytes = _memMan->getStatus(task->getMemHandle()).bytesLock;
+    }
+    if (perByte) {
+        auto& chunkBytes = _chunkBytes[task->getChunkId()];
+        chunkBytes = std::max(chunkBytes, bytes);
+    }
+    if (trace) {
+        TraceTask traceTask;
+        auto queueTime = task->getQueueTime();
+        if (queueTime.time_since_epoch().count() != 0) {
+            traceTask.arrival = std::chrono::duration<double>(queueTime.time_since_epoch()).count();
+        } else {
+            // Only the second is known for Tasks that didn't go through BlendScheduler.
+            traceTask.arrival = task->entryTime;
+        }
+        traceTask.queryId = task->getQueryId();
+        traceTask.chunkId = task->getChunkId();
+        traceTask.db = task->msg->db();
+        auto const& infoTables = task->getScanInfo().infoTables;
+        if (!infoTables.empty()) {
+            traceTask.db = infoTables[0].db;
+            traceTask.table = infoTables[0].table;
+        }
+        traceTask.seconds = task->getRunTime().count() / 1000.0;
+        traceTask.bytes = bytes;
+        LOGS(_traceLog, LOG_LVL_DEBUG, SchedulerTrace::line(traceTask));
+    }
 }
 
 bool ChunkTasksQueue::setResourceStarved(bool starved) {
@@ -227,6 +334,12 @@ wbase::Task::Ptr ChunkTasksQueue::removeTask(wbase::Task::Ptr const& task) {
     return ret;
 }
 
+std::size_t ChunkTasksQueue::getChunkTaskCount(int chunkId) const {
+    std::lock_guard<std::mutex> lock(_mapMx);
+    auto iter = _chunkMap.find(chunkId);
+    return iter == _chunkMap.end() ? 0 : iter->second->numUnfinished();
+}
+
 bool ChunkTasksQueue::empty() const {
     std::lock_guard<std::mutex> lock(_mapMx);
     return _empty();
@@ -284,12 +397,16 @@ wbase::Task::Ptr ChunkTasks::removeTask(wbase::Task::Ptr const& task) {
     result = eraseFunc(_activeTasks._tasks);
     if (result != nullptr) {
         _activeTasks.heapify();
+        _countScanTable(result, -1);
         LOGS(_log, LOG_LVL_DEBUG, "removeTask act " << cInfo());
         return result;
     }
 
     // Is it in _pendingTasks?
     result = eraseFunc(_pendingTasks);
+    if (result != nullptr) {
+        _countScanTable(result, -1);
+    }
     LOGS(_log, LOG_LVL_DEBUG, "removeTask pend " << cInfo());
     return result;
 }
@@ -316,6 +433,7 @@ void ChunkTasks::queTask(wbase::Task::Ptr const& a) {
     /// Compute entry time to reduce spurious valgrind errors
     ::ctime_r(&a->entryTime, a->timestr);
 
+    _countScanTable(a, 1);
     const char* state = "";
     // If this is the active chunk, put new Tasks on the pending list, as
     // we could easily get stuck on this chunk as new Tasks come in.
@@ -343,8 +461,13 @@ void ChunkTasks::setActive(bool active) {
         LOGS(_log, LOG_LVL_DEBUG, "ChunkTasks " << _chunkId << " active changed to " << active);
         if (_active && !active) {
             movePendingToActive();
+            // Tasks left for the next lap need their tables read again.
+            _prefetched = false;
         }
     }
+    if (active) {
+        _passedOver = 0;
+    }
     _active = active;
 }
 
@@ -452,6 +575,7 @@ ChunkTasks::ReadyState ChunkTasks::ready(bool useFlexibleLock) {
 
     // There is a Task to run at this point, pull it off the heap to avoid confusion.
     _activeTasks.pop();
+    _countScanTable(task, -1);
     _readyTask = task;
     LOGS(_log, LOG_LVL_TRACE,
          "ready pop t=" << task->getIdStr() << " top="
@@ -460,6 +584,54 @@ ChunkTasks::ReadyState ChunkTasks::ready(bool useFlexibleLock) {
     return ChunkTasks::ReadyState::READY;
 }
 
+/// Tell memman which tables the top Task will want, so they can be read
+/// while earlier chunks are being scanned.
+/// ChunkTasks relies on its owner for thread safety.
+void ChunkTasks::prefetch() {
+    if (_prefetched) return;
+    auto task = _activeTasks.top();
+    if (task == nullptr) return;
+    _prefetched = true;
+    std::vector<memman::TableInfo> tblVect;
+    for (auto const& tbl : task->getScanInfo().infoTables) {
+        tblVect.emplace_back(tbl.db + "/" + tbl.table);
+    }
+    LOGS(_log, LOG_LVL_DEBUG, "ChunkTasks::prefetch chunk=" << _chunkId << " tables=" << tblVect.size());
+    _memMan->prefetch(tblVect, _chunkId);
+}
+
+ChunkOrder::Candidate ChunkTasks::makeCandidate(ChunkOrder::ExpectedTimeFunc const& expectedTime) const {
+    ChunkOrder::Candidate cand;
+    cand.chunkId = _chunkId;
+    cand.numTasks = size();
+    cand.passedOver = _passedOver;
+    if (expectedTime != nullptr) {
+        for (auto const& [scanTable, count] : _scanTableCounts) {
+            double seconds = expectedTime(_chunkId, scanTable);
+            if (seconds >= 0.0) {
+                cand.timedTasks += count;
+                cand.expectedSeconds += seconds * count;
+            }
+        }
+    }
+    return cand;
+}
+
+/// Tasks are counted by the slowest scan table in their query, like
+/// wpublish::QueriesAndChunks keeps their statistics.
+void ChunkTasks::_countScanTable(wbase::Task::Ptr const& task, int delta) {
+    std::string scanTable;
+    auto const& infoTables = task->getScanInfo().infoTables;
+    if (!infoTables.empty()) {
+        scanTable = wpublish::ChunkTableStats::makeTableName(infoTables[0].db, infoTables[0].table);
+    }
+    auto iter = _scanTableCounts.emplace(scanTable, 0).first;
+    iter->second += delta;
+    if (iter->second == 0) {
+        _scanTableCounts.erase(iter);
+    }
+}
+
 /// @return old value of _resourceStarved.
 bool ChunkTasks::setResourceStarved(bool starved) {
     auto val = _resourceStarved;
@@ -28,11 +28,13 @@
 #include <list>
 #include <map>
 #include <mutex>
+#include <string>
 #include <vector>
 
 // Qserv headers
 #include "memman/MemMan.h"
 #include "wbase/Task.h"
+#include "wsched/ChunkOrder.h"
 #include "wsched/ChunkTaskCollection.h"
 #include "wsched/SchedulerBase.h"
 
@@ -61,6 +63,10 @@ public:
     ReadyState ready(bool useFlexibleLock);
     void taskComplete(wbase::Task::Ptr const& task);
 
+    /// Ask memman to read the tables of the next Task into memory ahead of
+    /// time. This is only done once for this chunk.
+    void prefetch();
+
     void movePendingToActive();             ///< Move all pending Tasks to _activeTasks.
     bool readyToAdvance();                  ///< @return true if active Tasks for this chunk are done.
     void setActive(bool active = true);     ///< Flag current requests so new requests will be pending.
@@ -68,6 +74,15 @@ public:
     std::size_t size() const { return _activeTasks.size() + _pendingTasks.size(); }
     int getChunkId() { return _chunkId; }
 
+    /// @return the number of Tasks that are queued, ready to run or in flight.
+    std::size_t numUnfinished() const {
+        return size() + (_readyTask != nullptr ? 1 : 0) + _inFlightTasks.size();
+    }
+
+    /// @return what ChunkOrder needs to know about this chunk, except the bytes it locks.
+    ChunkOrder::Candidate makeCandidate(ChunkOrder::ExpectedTimeFunc const& expectedTime) const;
+    void passOver() { ++_passedOver; }  ///< Another chunk was made active while this one had Tasks.
+
     // Remove 'task' from this instance.
     // @return a pointer to the removed Task.
     wbase::Task::Ptr removeTask(wbase::Task::Ptr const& task);
@@ -108,6 +123,12 @@ private:
     SlowTableHeap _activeTasks;                   ///< All Tasks must be put on this before they can run.
     std::vector<wbase::Task::Ptr> _pendingTasks;  ///< Task that should not be run until later.
     std::set<wbase::Task*> _inFlightTasks;        ///< Set of Tasks that this chunk has in flight.
+    bool _prefetched{false};                      ///< True when prefetch() was called in this lap.
+    unsigned int _passedOver{0};                  ///< Times passed over since this was last active.
+
+    /// Number of queued Tasks for each scan table, named as in wpublish::ChunkTableStats.
+    std::map<std::string, unsigned int> _scanTableCounts;
+    void _countScanTable(wbase::Task::Ptr const& task, int delta);
 
     memman::MemMan::Ptr _memMan;
 };
@@ -117,7 +138,8 @@ private:
 /// scan tables used.
 /// - Tasks are provided starting with the _activeChunk, which remains the
 ///   _activeChunk until all of its Tasks are completed. At which time, the
-///   _activeChunk advances to the chunk with the next higher chunkId. While
+///   _activeChunk advances to the chunk picked by _chunkOrder, by default the
+///   chunk with the next higher chunkId. While
 ///   a chunk is the _activeChunk, all new Tasks for that chunk are put in
 ///   in a pending list so that the active chunk does not get stalled.
 /// - While all the Tasks on the _active chunk have been started, but not completed,
@@ -135,8 +157,13 @@ public:
 
     enum { READY, NOT_READY, NO_RESOURCES };
 
-    ChunkTasksQueue(SchedulerBase* scheduler, memman::MemMan::Ptr const& memMan)
-            : _memMan{memMan}, _scheduler{scheduler} {}
+    /// @param chunkOrder - picks the next active chunk.
+    /// @param expectedTime - the run times of Tasks, used by chunkOrder. It may be
+    ///                       nullptr, in which case no run times are known.
+    ChunkTasksQueue(SchedulerBase* scheduler, memman::MemMan::Ptr const& memMan,
+                    ChunkOrder const& chunkOrder = ChunkOrder(),
+                    ChunkOrder::ExpectedTimeFunc const& expectedTime = nullptr)
+            : _memMan{memMan}, _scheduler{scheduler}, _chunkOrder{chunkOrder}, _expectedTime{expectedTime} {}
     ChunkTasksQueue(ChunkTasksQueue const&) = delete;
     ChunkTasksQueue& operator=(ChunkTasksQueue const&) = delete;
 
@@ -152,6 +179,7 @@ public:
     int getActiveChunkId();  ///< return the active chunk id, or -1 if there isn't one.
 
     wbase::Task::Ptr removeTask(wbase::Task::Ptr const& task) override;
+    std::size_t getChunkTaskCount(int chunkId) const override;
 
     std::string queueInfo() const override {
         std::lock_guard<std::mutex> lck(_mapMx);
@@ -160,6 +188,14 @@ public:
 
 private:
     bool _ready(bool useFlexibleLock);
+
+    /// @return the chunk to make active after 'current', which is end() if
+    ///         there is no active chunk. _mapMx must be locked before calling.
+    ChunkMap::iterator _nextActive(ChunkMap::iterator current);
+
+    /// Prefetch the chunks that follow 'iter', up to the prefetch depth of _memMan.
+    /// _mapMx must be locked before calling.
+    void _prefetchAfter(ChunkMap::iterator iter);
     bool _empty() const { return _chunkMap.empty(); }
     std::string _queueInfo() const;  ///< _mapMx must be locked before calling
 
@@ -172,6 +208,11 @@ private:
     std::atomic<int> _taskCount{0};  ///< Count of all tasks currently in _chunkMap.
     bool _resourceStarved{false};
     SchedulerBase* _scheduler;  ///< Pointer to scheduler that owns this. This can be nullptr.
+
+    ChunkOrder const _chunkOrder;
+    ChunkOrder::ExpectedTimeFunc const _expectedTime;
+    std::map<int, std::uint64_t> _chunkBytes;  ///< Most bytes a Task locked on each chunk, by chunk id.
+    std::vector<int> _nextChunkIds;            ///< Chunks to follow the active chunk, when not by chunk id.
 };
 
 }  // namespace lsst::qserv::wsched
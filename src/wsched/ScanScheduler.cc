@@ -47,6 +47,7 @@
 #include "util/Bug.h"
 #include "util/Timer.h"
 #include "wcontrol/Foreman.h"
+#include "wpublish/QueriesAndChunks.h"
 #include "wsched/BlendScheduler.h"
 #include "wsched/ChunkTasksQueue.h"
 
@@ -60,13 +61,20 @@ namespace lsst::qserv::wsched {
 
 ScanScheduler::ScanScheduler(string const& name, int maxThreads, int maxReserve, int priority,
                              int maxActiveChunks, memman::MemMan::Ptr const& memMan, int minRating,
-                             int maxRating, double maxTimeMinutes)
+                             int maxRating, double maxTimeMinutes, ChunkOrder const& chunkOrder)
         : SchedulerBase{name, maxThreads, maxReserve, maxActiveChunks, priority},
           _memMan{memMan},
           _minRating{minRating},
           _maxRating{maxRating},
           _maxTimeMinutes{maxTimeMinutes} {
-    _taskQueue = make_shared<ChunkTasksQueue>(this, _memMan);
+    auto expectedTime = [](int chunkId, string const& scanTable) -> double {
+        auto queries = wpublish::QueriesAndChunks::get(true);
+        if (queries == nullptr) return -1.0;
+        auto data = queries->getChunkTableData(chunkId, scanTable);
+        if (data.tasksCompleted == 0) return -1.0;
+        return data.avgCompletionTime * 60.0;
+    };
+    _taskQueue = make_shared<ChunkTasksQueue>(this, _memMan, chunkOrder, expectedTime);
     assert(_minRating <= _maxRating);
 }
 
@@ -29,6 +29,7 @@
 
 // Qserv headers
 #include "memman/MemMan.h"
+#include "wsched/ChunkOrder.h"
 #include "wsched/ChunkTaskCollection.h"
 #include "wsched/SchedulerBase.h"
 
@@ -45,15 +46,19 @@ namespace lsst::qserv::wsched {
 ///
 /// It groups Tasks by chunk id and loops through chunks in
 /// ascending order running all Tasks for each chunk as it goes and
-//  wrapping back to the lowest chunk at the end.
+//  wrapping back to the lowest chunk at the end, unless a ChunkOrder
+/// with another policy is given.
 ///
 /// It only advances to the next chunk if system resources are available.
 class ScanScheduler : public SchedulerBase {
 public:
     typedef std::shared_ptr<ScanScheduler> Ptr;
 
+    /// @param chunkOrder - picks the next chunk to scan, using the run times of
+    ///                     Tasks kept by wpublish::QueriesAndChunks.
     ScanScheduler(std::string const& name, int maxThreads, int maxReserve, int priority, int maxActiveChunks,
-                  memman::MemMan::Ptr const& memman, int minRating, int maxRating, double maxTimeMinutes);
+                  memman::MemMan::Ptr const& memman, int minRating, int maxRating, double maxTimeMinutes,
+                  ChunkOrder const& chunkOrder = ChunkOrder());
     virtual ~ScanScheduler() {}
 
     // util::CommandQueue overrides
@@ -80,6 +85,11 @@ public:
     double getMaxTimeMinutes() const { return _maxTimeMinutes; }
     bool removeTask(wbase::Task::Ptr const& task, bool removeRunning) override;
 
+    // wbase::TaskScheduler overrides
+    std::size_t getChunkTaskCount(int chunkId) const override {
+        return _taskQueue->getChunkTaskCount(chunkId);
+    }
+
 private:
     bool _ready();
     std::shared_ptr<ChunkTaskCollection> _taskQueue;  ///< Constrains access to files.
@@ -0,0 +1,291 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "wsched/SchedulerSimulator.h"
+
+// System headers
+#include <algorithm>
+#include <cerrno>
+#include <functional>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <queue>
+
+// Qserv headers
+#include "memman/MemMan.h"
+#include "proto/worker.pb.h"
+#include "util/Bug.h"
+#include "wbase/SendChannel.h"
+#include "wbase/SendChannelShared.h"
+#include "wbase/Task.h"
+#include "wcontrol/TransmitMgr.h"
+#include "wpublish/QueriesAndChunks.h"
+#include "wsched/ChunkTasksQueue.h"
+
+using namespace std;
+
+namespace lsst::qserv::wsched {
+
+namespace {
+
+/// A memory manager that locks the tables of a trace without touching any
+/// file. Tables stay locked while any handle uses them.
+class SimMemMan : public memman::MemMan {
+public:
+    explicit SimMemMan(uint64_t maxBytes) : _maxBytes(maxBytes) {}
+
+    /// Set the size of 'table' in 'chunk', the largest size given is kept.
+    void addTable(int chunk, string const& table, uint64_t bytes) {
+        auto& lck = _locks[_key(chunk, table)];
+        lck.bytes = max(lck.bytes, bytes);
+    }
+
+    int lock(Handle handle, bool strict = false) override { return 0; }
+
+    Handle prepare(vector<memman::TableInfo> const& tables, int chunk) override {
+        if (tables.empty()) return HandleType::ISEMPTY;
+        uint64_t needed = 0;
+        bool flexible = false;
+        vector<string> keys;
+        for (auto const& tbl : tables) {
+            keys.push_back(_key(chunk, tbl.tableName));
+            auto const& lck = _locks[keys.back()];
+            if (lck.users == 0) needed += lck.bytes;
+            flexible = flexible || tbl.theData == memman::TableInfo::LockType::FLEXIBLE;
+        }
+        if (!flexible && _maxBytes > 0 && _bytesLocked + needed > _maxBytes) {
+            errno = ENOMEM;
+            return HandleType::INVALID;
+        }
+        uint64_t handleBytes = 0;
+        for (auto const& key : keys) {
+            auto& lck = _locks[key];
+            if (lck.users++ == 0) {
+                _bytesLocked += lck.bytes;
+                ++tableLoads;
+                bytesLoaded += lck.bytes;
+            }
+            handleBytes += lck.bytes;
+        }
+        Handle handle = _nextHandle++;
+        _handles[handle] = {keys, Status(handleBytes, 0.0, keys.size(), chunk)};
+        return handle;
+    }
+
+    void prefetch(vector<memman::TableInfo> const& tables, int chunk) override {}
+
+    bool unlock(Handle handle) override {
+        auto iter = _handles.find(handle);
+        if (iter == _handles.end()) return false;
+        for (auto const& key : iter->second.keys) {
+            auto& lck = _locks[key];
+            if (--lck.users == 0) _bytesLocked -= lck.bytes;
+        }
+        _handles.erase(iter);
+        return true;
+    }
+
+    void unlockAll() override {
+        while (!_handles.empty()) unlock(_handles.begin()->first);
+    }
+
+    Statistics getStatistics() override {
+        Statistics stats{};
+        stats.bytesLockMax = _maxBytes;
+        stats.bytesLocked = _bytesLocked;
+        return stats;
+    }
+
+    Status getStatus(Handle handle) override {
+        auto iter = _handles.find(handle);
+        if (iter == _handles.end()) return Status();
+        return iter->second.status;
+    }
+
+    uint64_t tableLoads = 0;
+    uint64_t bytesLoaded = 0;
+
+private:
+    static string _key(int chunk, string const& table) { return to_string(chunk) + ":" + table; }
+
+    struct Lock {
+        uint64_t bytes = 0;
+        unsigned int users = 0;
+    };
+    struct HandleInfo {
+        vector<string> keys;
+        Status status;
+    };
+
+    uint64_t const _maxBytes;
+    uint64_t _bytesLocked = 0;
+    Handle _nextHandle = HandleType::ISEMPTY + 1;
+    map<string, Lock> _locks;
+    map<Handle, HandleInfo> _handles;
+};
+
+/// @return a scan Task for 'traceTask', with the index of 'traceTask' as its job id.
+wbase::Task::Ptr makeTask(TraceTask const& traceTask, int index,
+                          shared_ptr<wbase::SendChannelShared> const& sendChannel) {
+    auto taskMsg = make_shared<proto::TaskMsg>();
+    taskMsg->set_queryid(traceTask.queryId);
+    taskMsg->set_jobid(index);
+    taskMsg->set_chunkid(traceTask.chunkId);
+    taskMsg->set_czarid(1);
+    taskMsg->set_db(traceTask.db);
+    taskMsg->set_scaninteractive(false);
+    taskMsg->set_attemptcount(0);
+    if (!traceTask.table.empty()) {
+        auto scanTable = taskMsg->add_scantable();
+        scanTable->set_db(traceTask.db);
+        scanTable->set_table(traceTask.table);
+        scanTable->set_lockinmemory(true);
+        scanTable->set_scanrating(0);
+    }
+    return make_shared<wbase::Task>(taskMsg, "", 0, sendChannel);
+}
+
+}  // namespace
+
+nlohmann::json SchedulerSimulator::Result::toJson() const {
+    nlohmann::json js;
+    js["tasks"] = tasks;
+    js["makespan"] = makespan;
+    js["meanWaitSeconds"] = meanWaitSeconds;
+    js["maxWaitSeconds"] = maxWaitSeconds;
+    js["meanQuerySeconds"] = meanQuerySeconds;
+    js["maxQuerySeconds"] = maxQuerySeconds;
+    js["tableLoads"] = tableLoads;
+    js["bytesLoaded"] = bytesLoaded;
+    return js;
+}
+
+SchedulerSimulator::Result SchedulerSimulator::run(vector<TraceTask> const& trace, Config const& config) {
+    Result result;
+    result.tasks = trace.size();
+    if (trace.empty()) return result;
+
+    vector<size_t> arrivals(trace.size());
+    iota(arrivals.begin(), arrivals.end(), 0);
+    stable_sort(arrivals.begin(), arrivals.end(),
+                [&trace](size_t a, size_t b) { return trace[a].arrival < trace[b].arrival; });
+
+    auto memMan = make_shared<SimMemMan>(config.memoryBytes);
+    for (auto const& task : trace) {
+        if (!task.table.empty()) memMan->addTable(task.chunkId, task.db + "/" + task.table, task.bytes);
+    }
+
+    // Run times are learned as the simulation goes, like the worker keeps them
+    // in wpublish::QueriesAndChunks.
+    map<int, wpublish::ChunkStatistics::Ptr> chunkStats;
+    auto expectedTime = [&chunkStats](int chunkId, string const& scanTable) -> double {
+        auto iter = chunkStats.find(chunkId);
+        if (iter == chunkStats.end()) return -1.0;
+        auto tableStats = iter->second->getStats(scanTable);
+        if (tableStats == nullptr) return -1.0;
+        return tableStats->getData().avgCompletionTime * 60.0;
+    };
+    ChunkTasksQueue queue(nullptr, memMan, config.chunkOrder, expectedTime);
+
+    auto transmitMgr = make_shared<wcontrol::TransmitMgr>(1, 1);
+    auto sendChannel = wbase::SendChannelShared::create(make_shared<wbase::SendChannel>(), transmitMgr, 1);
+    vector<wbase::Task::Ptr> tasks(trace.size());
+
+    using Running = pair<double, size_t>;  // completion time and trace index
+    priority_queue<Running, vector<Running>, greater<Running>> running;
+    vector<memman::MemMan::Handle> toUnlock;
+    map<QueryId, pair<double, double>> queries;  // first arrival and last completion
+    double const inf = numeric_limits<double>::infinity();
+    double const start = trace[arrivals[0]].arrival;
+    double now = start;
+    double waitSum = 0.0;
+    size_t next = 0;
+    size_t done = 0;
+    while (done < trace.size()) {
+        // Start Tasks while threads are free. As in ScanScheduler, the tables of
+        // completed Tasks are only unlocked once the queue had a chance to give
+        // out a Task that uses them.
+        while (true) {
+            while (running.size() < config.threads) {
+                auto task = queue.getTask(running.empty());
+                if (task == nullptr) break;
+                size_t j = task->getJobId();
+                double wait = now - trace[j].arrival;
+                waitSum += wait;
+                result.maxWaitSeconds = max(result.maxWaitSeconds, wait);
+                running.emplace(now + trace[j].seconds, j);
+            }
+            if (toUnlock.empty()) break;
+            for (auto handle : toUnlock) memMan->unlock(handle);
+            toUnlock.clear();
+        }
+
+        double nextArrival = (next < arrivals.size()) ? trace[arrivals[next]].arrival : inf;
+        double nextCompletion = running.empty() ? inf : running.top().first;
+        if (nextArrival == inf && nextCompletion == inf) {
+            throw util::Bug(ERR_LOC, "SchedulerSimulator::run queued Tasks can't be run");
+        }
+        if (nextCompletion <= nextArrival) {
+            now = nextCompletion;
+            while (!running.empty() && running.top().first <= now) {
+                size_t j = running.top().second;
+                running.pop();
+                auto const& traceTask = trace[j];
+                queue.taskComplete(tasks[j]);
+                if (tasks[j]->hasMemHandle()) toUnlock.push_back(tasks[j]->getMemHandle());
+                tasks[j].reset();
+                auto& stats = chunkStats[traceTask.chunkId];
+                if (stats == nullptr) stats = make_shared<wpublish::ChunkStatistics>(traceTask.chunkId);
+                stats->add(wpublish::ChunkTableStats::makeTableName(traceTask.db, traceTask.table),
+                           traceTask.seconds / 60.0);
+                queries[traceTask.queryId].second = now;
+                ++done;
+            }
+        } else {
+            now = nextArrival;
+            while (next < arrivals.size() && trace[arrivals[next]].arrival <= now) {
+                size_t j = arrivals[next++];
+                tasks[j] = makeTask(trace[j], j, sendChannel);
+                queue.queueTask(tasks[j]);
+                queries.emplace(trace[j].queryId, make_pair(now, now));
+            }
+        }
+    }
+    for (auto handle : toUnlock) memMan->unlock(handle);
+
+    result.makespan = now - start;
+    result.meanWaitSeconds = waitSum / trace.size();
+    double querySum = 0.0;
+    for (auto const& [queryId, times] : queries) {
+        double seconds = times.second - times.first;
+        querySum += seconds;
+        result.maxQuerySeconds = max(result.maxQuerySeconds, seconds);
+    }
+    result.meanQuerySeconds = querySum / queries.size();
+    result.tableLoads = memMan->tableLoads;
+    result.bytesLoaded = memMan->bytesLoaded;
+    return result;
+}
+
+}  // namespace lsst::qserv::wsched
@@ -0,0 +1,76 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_WSCHED_SCHEDULERSIMULATOR_H
+#define LSST_QSERV_WSCHED_SCHEDULERSIMULATOR_H
+
+// System headers
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Third party headers
+#include "nlohmann/json.hpp"
+
+// Qserv headers
+#include "global/intTypes.h"
+#include "wsched/ChunkOrder.h"
+#include "wsched/SchedulerTrace.h"
+
+namespace lsst::qserv::wsched {
+
+/// SchedulerSimulator replays a trace of scan Tasks through a ChunkTasksQueue
+/// on a simulated clock, so that ChunkOrder policies can be compared offline.
+/// Each Task of the trace is queued at its arrival time and runs for the time
+/// it took on the worker, once the queue hands it out. The tables of a chunk
+/// stay locked in a simulated memman while Tasks on them run, and reading
+/// them in again is counted as a table load.
+///
+/// Traces are read with SchedulerTrace::read().
+class SchedulerSimulator {
+public:
+    struct Config {
+        unsigned int threads = 4;       ///< Tasks that can run at the same time.
+        std::uint64_t memoryBytes = 0;  ///< Bytes that can be locked, 0 for no limit.
+        ChunkOrder chunkOrder;          ///< The policy to simulate.
+    };
+
+    struct Result {
+        std::size_t tasks = 0;
+        double makespan = 0.0;          ///< Seconds from the first arrival to the last completion.
+        double meanWaitSeconds = 0.0;   ///< Mean time Tasks spent queued.
+        double maxWaitSeconds = 0.0;
+        double meanQuerySeconds = 0.0;  ///< Mean time from first arrival to last completion per query.
+        double maxQuerySeconds = 0.0;
+        std::uint64_t tableLoads = 0;   ///< Times the tables of a chunk were read into memory.
+        std::uint64_t bytesLoaded = 0;  ///< Bytes read by the 'tableLoads'.
+
+        nlohmann::json toJson() const;
+    };
+
+    /// Run 'trace' with 'config'. The same arguments always give the same result.
+    /// @throws util::Bug if queued Tasks can no longer be run.
+    static Result run(std::vector<TraceTask> const& trace, Config const& config);
+};
+
+}  // namespace lsst::qserv::wsched
+
+#endif  // LSST_QSERV_WSCHED_SCHEDULERSIMULATOR_H
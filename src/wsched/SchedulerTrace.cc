@@ -0,0 +1,78 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "wsched/SchedulerTrace.h"
+
+// System headers
+#include <iomanip>
+#include <istream>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace lsst::qserv::wsched {
+
+string const SchedulerTrace::MARKER = "schedTrace=";
+
+string SchedulerTrace::line(TraceTask const& task) {
+    ostringstream os;
+    os << MARKER << fixed << setprecision(3) << task.arrival << "," << task.queryId << "," << task.chunkId
+       << "," << task.db << "," << task.table << "," << task.seconds << "," << task.bytes;
+    return os.str();
+}
+
+vector<TraceTask> SchedulerTrace::read(istream& is) {
+    vector<TraceTask> trace;
+    string line;
+    for (int lineNum = 1; getline(is, line); ++lineNum) {
+        auto pos = line.find(MARKER);
+        if (pos != string::npos) {
+            line = line.substr(pos + MARKER.size());
+        }
+        if (line.empty() || line[0] == '#') continue;
+        vector<string> fields;
+        istringstream ls(line);
+        for (string field; getline(ls, field, ',');) {
+            fields.push_back(field);
+        }
+        try {
+            if (fields.size() != 7) throw invalid_argument("expected 7 fields");
+            TraceTask task;
+            task.arrival = stod(fields[0]);
+            task.queryId = stoull(fields[1]);
+            task.chunkId = stoi(fields[2]);
+            task.db = fields[3];
+            task.table = fields[4];
+            task.seconds = stod(fields[5]);
+            task.bytes = stoull(fields[6]);
+            trace.push_back(task);
+        } catch (logic_error const& e) {
+            throw invalid_argument("SchedulerTrace::read line " + to_string(lineNum) + " '" + line +
+                                   "': " + e.what());
+        }
+    }
+    return trace;
+}
+
+}  // namespace lsst::qserv::wsched
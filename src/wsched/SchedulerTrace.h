@@ -0,0 +1,69 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_WSCHED_SCHEDULERTRACE_H
+#define LSST_QSERV_WSCHED_SCHEDULERTRACE_H
+
+// System headers
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// Qserv headers
+#include "global/intTypes.h"
+
+namespace lsst::qserv::wsched {
+
+/// A scan Task of a scheduler trace.
+struct TraceTask {
+    double arrival = 0.0;     ///< When the Task was queued, in seconds since the epoch.
+    QueryId queryId = 0;
+    int chunkId = 0;
+    std::string db;
+    std::string table;        ///< The slowest scan table of the query, empty if there is none.
+    double seconds = 0.0;     ///< How long the Task ran.
+    std::uint64_t bytes = 0;  ///< Bytes of the chunk's tables locked in memory, 0 if unknown.
+};
+
+/// SchedulerTrace writes and reads the lines of scheduler traces. Workers write
+/// a trace line for every scan Task that completes, to the
+/// "lsst.qserv.wsched.SchedulerTrace" logger at DEBUG level, and
+/// SchedulerSimulator replays them.
+class SchedulerTrace {
+public:
+    /// Written in front of the fields of a trace line.
+    static std::string const MARKER;
+
+    /// @return the trace line of 'task': MARKER followed by its fields,
+    ///         arrival,queryId,chunkId,db,table,seconds,bytes, separated by commas.
+    static std::string line(TraceTask const& task);
+
+    /// Read a trace. Each line is read from MARKER on, if the marker is
+    /// found, so a trace can be cut from a worker log with grep. Empty lines
+    /// and lines starting with '#' are skipped.
+    /// @throws std::invalid_argument if a line isn't a trace line.
+    static std::vector<TraceTask> read(std::istream& is);
+};
+
+}  // namespace lsst::qserv::wsched
+
+#endif  // LSST_QSERV_WSCHED_SCHEDULERTRACE_H
@@ -27,10 +27,17 @@
  * @author Daniel L. Wang, SLAC
  */
 
+// System headers
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
 // LSST headers
 #include "lsst/log/Log.h"
 
 // Qserv headers
+#include "global/constants.h"
 #include "memman/MemManNone.h"
 #include "proto/ScanTableInfo.h"
 #include "proto/worker.pb.h"
@@ -45,6 +52,8 @@
 #include "wsched/FifoScheduler.h"
 #include "wsched/GroupScheduler.h"
 #include "wsched/ScanScheduler.h"
+#include "wsched/SchedulerSimulator.h"
+#include "wsched/SchedulerTrace.h"
 
 // Boost unit test header
 #define BOOST_TEST_MODULE WorkerScheduler
@@ -1003,4 +1012,313 @@ BOOST_AUTO_TEST_CASE(ChunkTasksQueueTest) {
     LOGS(_log, LOG_LVL_DEBUG, "ChunkTasksQueueTest done");
 }
 
+/// MemManNone that records the chunks it was asked to prefetch.
+class MemManPrefetchRecorder : public lsst::qserv::memman::MemManNone {
+public:
+    MemManPrefetchRecorder(int depth) : MemManNone(1, true), _depth(depth) {}
+    void prefetch(std::vector<lsst::qserv::memman::TableInfo> const& tables, int chunk) override {
+        chunks.push_back(chunk);
+        tableCount += tables.size();
+    }
+    int getPrefetchDepth() const override { return _depth; }
+
+    std::vector<int> chunks;
+    size_t tableCount = 0;
+
+private:
+    int _depth;
+};
+
+BOOST_AUTO_TEST_CASE(ChunkTasksQueuePrefetchTest) {
+    LOGS(_log, LOG_LVL_DEBUG, "ChunkTasksQueuePrefetchTest start");
+    auto memMan = std::make_shared<MemManPrefetchRecorder>(2);
+    wsched::ChunkTasksQueue ctl{nullptr, memMan};
+    lsst::qserv::QueryId qIdInc = 1;
+
+    Task::Ptr a1 = makeTask(newTaskMsgScan(100, 3, qIdInc++, 0, "alpha"));
+    Task::Ptr b1 = makeTask(newTaskMsgScan(150, 3, qIdInc++, 0, "alpha"));
+    Task::Ptr c1 = makeTask(newTaskMsgScan(200, 3, qIdInc++, 0, "alpha"));
+    Task::Ptr d1 = makeTask(newTaskMsgScan(250, 3, qIdInc++, 0, "alpha"));
+    ctl.queueTask(a1);
+    ctl.queueTask(b1);
+    ctl.queueTask(c1);
+    ctl.queueTask(d1);
+
+    // Finding a task on the first chunk prefetches the next two.
+    BOOST_CHECK(ctl.ready(true) == true);
+    BOOST_REQUIRE_EQUAL(memMan->chunks.size(), 2u);
+    BOOST_CHECK_EQUAL(memMan->chunks[0], 150);
+    BOOST_CHECK_EQUAL(memMan->chunks[1], 200);
+    BOOST_CHECK_EQUAL(memMan->tableCount, 2u);
+
+    // Chunks are only prefetched once, and the search wraps around.
+    BOOST_CHECK(ctl.getTask(true).get() == a1.get());
+    BOOST_CHECK(ctl.getTask(true).get() == b1.get());
+    BOOST_REQUIRE_EQUAL(memMan->chunks.size(), 3u);
+    BOOST_CHECK_EQUAL(memMan->chunks[2], 250);
+    BOOST_CHECK(ctl.getTask(true).get() == c1.get());
+    BOOST_CHECK(ctl.getTask(true).get() == d1.get());
+    BOOST_CHECK_EQUAL(memMan->chunks.size(), 3u);
+    LOGS(_log, LOG_LVL_DEBUG, "ChunkTasksQueuePrefetchTest done");
+}
+
+BOOST_AUTO_TEST_CASE(ChunkTasksQueuePrefetchLapsTest) {
+    LOGS(_log, LOG_LVL_DEBUG, "ChunkTasksQueuePrefetchLapsTest start");
+    auto memMan = std::make_shared<MemManPrefetchRecorder>(1);
+    wsched::ChunkTasksQueue ctl{nullptr, memMan};
+    lsst::qserv::QueryId qIdInc = 1;
+
+    Task::Ptr a1 = makeTask(newTaskMsgScan(100, 3, qIdInc++, 0, "alpha"));
+    Task::Ptr b1 = makeTask(newTaskMsgScan(150, 3, qIdInc++, 0, "alpha"));
+    ctl.queueTask(a1);
+    ctl.queueTask(b1);
+    BOOST_CHECK(ctl.getTask(true).get() == a1.get());
+    BOOST_REQUIRE_EQUAL(memMan->chunks.size(), 1u);
+    BOOST_CHECK_EQUAL(memMan->chunks[0], 150);
+
+    // Tasks that arrive for the active chunk wait for the next lap.
+    Task::Ptr a2 = makeTask(newTaskMsgScan(100, 3, qIdInc++, 0, "alpha"));
+    ctl.queueTask(a2);
+    ctl.taskComplete(a1);
+    BOOST_CHECK(ctl.getTask(true).get() == b1.get());
+    BOOST_REQUIRE_EQUAL(memMan->chunks.size(), 2u);
+    BOOST_CHECK_EQUAL(memMan->chunks[1], 100);
+
+    // Chunk 150 still has Tasks after its lap, it's prefetched again for the next one.
+    Task::Ptr b2 = makeTask(newTaskMsgScan(150, 3, qIdInc++, 0, "alpha"));
+    ctl.queueTask(b2);
+    ctl.taskComplete(b1);
+    BOOST_CHECK(ctl.getTask(true).get() == a2.get());
+    BOOST_REQUIRE_EQUAL(memMan->chunks.size(), 3u);
+    BOOST_CHECK_EQUAL(memMan->chunks[2], 150);
+    ctl.taskComplete(a2);
+    BOOST_CHECK(ctl.getTask(true).get() == b2.get());
+    ctl.taskComplete(b2);
+    LOGS(_log, LOG_LVL_DEBUG, "ChunkTasksQueuePrefetchLapsTest done");
+}
+
+BOOST_AUTO_TEST_CASE(ChunkOrderTest) {
+    LOGS(_log, LOG_LVL_DEBUG, "ChunkOrderTest start");
+    using Policy = wsched::ChunkOrder::Policy;
+    for (auto policy : {Policy::CHUNK_ID, Policy::SHORTEST_FIRST, Policy::TASKS_PER_BYTE}) {
+        auto str = wsched::ChunkOrder::toString(policy);
+        BOOST_CHECK(wsched::ChunkOrder::policyFromString(str) == policy);
+    }
+    BOOST_CHECK_THROW(wsched::ChunkOrder::policyFromString("FASTEST"), std::invalid_argument);
+
+    // Chunk 3 has no run times, its tasks are expected to take the 70/6
+    // seconds of the average task. Chunk 3 locks the average of 250 bytes.
+    std::vector<wsched::ChunkOrder::Candidate> cands(3);
+    cands[0].chunkId = 1;
+    cands[0].numTasks = 4;
+    cands[0].timedTasks = 4;
+    cands[0].expectedSeconds = 40.0;
+    cands[0].bytes = 400;
+    cands[1].chunkId = 2;
+    cands[1].numTasks = 2;
+    cands[1].timedTasks = 2;
+    cands[1].expectedSeconds = 30.0;
+    cands[1].bytes = 100;
+    cands[2].chunkId = 3;
+    cands[2].numTasks = 3;
+
+    std::vector<size_t> scanOrder{0, 1, 2};
+    std::vector<size_t> cheapFirst{1, 2, 0};
+    BOOST_CHECK(wsched::ChunkOrder(Policy::CHUNK_ID).rank(cands) == scanOrder);
+    BOOST_CHECK(wsched::ChunkOrder(Policy::SHORTEST_FIRST).rank(cands) == cheapFirst);
+    BOOST_CHECK(wsched::ChunkOrder(Policy::TASKS_PER_BYTE).rank(cands) == cheapFirst);
+
+    // A chunk passed over too often goes first.
+    cands[0].passedOver = 3;
+    std::vector<size_t> starvedFirst{0, 1, 2};
+    BOOST_CHECK(wsched::ChunkOrder(Policy::SHORTEST_FIRST, 3).rank(cands) == starvedFirst);
+    BOOST_CHECK(wsched::ChunkOrder(Policy::SHORTEST_FIRST, 4).rank(cands) == cheapFirst);
+    BOOST_CHECK(wsched::ChunkOrder(Policy::SHORTEST_FIRST, 0).rank(cands) == cheapFirst);
+    LOGS(_log, LOG_LVL_DEBUG, "ChunkOrderTest done");
+}
+
+BOOST_AUTO_TEST_CASE(ChunkTasksQueueOrderTest) {
+    LOGS(_log, LOG_LVL_DEBUG, "ChunkTasksQueueOrderTest start");
+    auto memMan = std::make_shared<lsst::qserv::memman::MemManNone>(1, true);
+    std::map<int, double> seconds{{100, 50.0}, {150, 5.0}, {200, 20.0}};
+    auto expectedTime = [&seconds](int chunkId, std::string const& scanTable) -> double {
+        BOOST_CHECK_EQUAL(scanTable, "elephant:alpha");
+        return seconds[chunkId];
+    };
+    wsched::ChunkTasksQueue ctl{nullptr, memMan,
+                                wsched::ChunkOrder(wsched::ChunkOrder::Policy::SHORTEST_FIRST, 10),
+                                expectedTime};
+    lsst::qserv::QueryId qIdInc = 1;
+
+    Task::Ptr a1 = makeTask(newTaskMsgScan(100, 3, qIdInc++, 0, "alpha"));
+    ctl.queueTask(a1);
+    std::vector<Task::Ptr> bTasks;
+    for (int i = 0; i < 5; ++i) {
+        bTasks.push_back(makeTask(newTaskMsgScan(150, 3, qIdInc++, 0, "alpha")));
+        ctl.queueTask(bTasks.back());
+    }
+    Task::Ptr c1 = makeTask(newTaskMsgScan(200, 3, qIdInc++, 0, "alpha"));
+    ctl.queueTask(c1);
+
+    // Chunks are taken from the least expected work to the most, the five
+    // tasks on chunk 150 being expected to take 25 seconds.
+    BOOST_CHECK(ctl.getTask(true).get() == c1.get());
+    BOOST_CHECK_EQUAL(ctl.getActiveChunkId(), 200);
+    ctl.taskComplete(c1);
+    std::set<Task*> bRun;
+    for (int i = 0; i < 5; ++i) {
+        bRun.insert(ctl.getTask(true).get());
+        BOOST_CHECK_EQUAL(ctl.getActiveChunkId(), 150);
+    }
+    for (auto const& b : bTasks) {
+        BOOST_CHECK(bRun.count(b.get()) == 1);
+        ctl.taskComplete(b);
+    }
+    BOOST_CHECK(ctl.getTask(true).get() == a1.get());
+    BOOST_CHECK_EQUAL(ctl.getActiveChunkId(), 100);
+    LOGS(_log, LOG_LVL_DEBUG, "ChunkTasksQueueOrderTest done");
+}
+
+BOOST_AUTO_TEST_CASE(SchedulerTraceTest) {
+    LOGS(_log, LOG_LVL_DEBUG, "SchedulerTraceTest start");
+    wsched::TraceTask task;
+    task.arrival = 1700000000.25;
+    task.queryId = 42;
+    task.chunkId = 6630;
+    task.db = "dp02";
+    task.table = "Source";
+    task.seconds = 12.5;
+    task.bytes = 123456789;
+    auto line = wsched::SchedulerTrace::line(task);
+    std::istringstream is("# comment\n\n2024-01-01T00:00:00Z DEBUG ChunkTasksQueue.cc:99 " + line + "\n" +
+                          line.substr(wsched::SchedulerTrace::MARKER.size()) + "\n");
+    auto trace = wsched::SchedulerTrace::read(is);
+    BOOST_REQUIRE_EQUAL(trace.size(), 2u);
+    for (auto const& t : trace) {
+        BOOST_CHECK_EQUAL(t.arrival, task.arrival);
+        BOOST_CHECK_EQUAL(t.queryId, task.queryId);
+        BOOST_CHECK_EQUAL(t.chunkId, task.chunkId);
+        BOOST_CHECK_EQUAL(t.db, task.db);
+        BOOST_CHECK_EQUAL(t.table, task.table);
+        BOOST_CHECK_EQUAL(t.seconds, task.seconds);
+        BOOST_CHECK_EQUAL(t.bytes, task.bytes);
+    }
+    std::istringstream bad("1.0,2,3,db,table,4.0\n");
+    BOOST_CHECK_THROW(wsched::SchedulerTrace::read(bad), std::invalid_argument);
+    std::istringstream badNumber("1.0,2,three,db,table,4.0,5\n");
+    BOOST_CHECK_THROW(wsched::SchedulerTrace::read(badNumber), std::invalid_argument);
+    LOGS(_log, LOG_LVL_DEBUG, "SchedulerTraceTest done");
+}
+
+BOOST_AUTO_TEST_CASE(SchedulerSimulatorRunTest) {
+    LOGS(_log, LOG_LVL_DEBUG, "SchedulerSimulatorRunTest start");
+    // Two waves of five queries, each on its own chunk. The query on chunk 1 is
+    // slow. The second wave comes after the worker learned how long chunks take.
+    std::vector<wsched::TraceTask> trace;
+    lsst::qserv::QueryId queryId = 1;
+    for (double arrival : {0.0, 1000.0}) {
+        for (int chunkId = 1; chunkId <= 5; ++chunkId) {
+            wsched::TraceTask task;
+            task.arrival = arrival;
+            task.queryId = queryId++;
+            task.chunkId = chunkId;
+            task.db = "db";
+            task.table = "Object";
+            task.seconds = (chunkId == 1) ? 100.0 : 1.0;
+            task.bytes = 1000;
+            trace.push_back(task);
+        }
+    }
+    wsched::SchedulerSimulator::Config config;
+    config.threads = 1;
+    auto byChunkId = wsched::SchedulerSimulator::run(trace, config);
+    BOOST_CHECK_EQUAL(byChunkId.tasks, 10u);
+    BOOST_CHECK_EQUAL(byChunkId.makespan, 1104.0);
+    BOOST_CHECK_EQUAL(byChunkId.meanQuerySeconds, 102.0);
+    BOOST_CHECK_EQUAL(byChunkId.maxWaitSeconds, 103.0);
+    BOOST_CHECK_EQUAL(byChunkId.tableLoads, 10u);
+    BOOST_CHECK_EQUAL(byChunkId.bytesLoaded, 10000u);
+
+    // The second wave runs the fast chunks first.
+    config.chunkOrder = wsched::ChunkOrder(wsched::ChunkOrder::Policy::SHORTEST_FIRST, 10);
+    auto shortestFirst = wsched::SchedulerSimulator::run(trace, config);
+    BOOST_CHECK_EQUAL(shortestFirst.makespan, 1104.0);
+    BOOST_CHECK_EQUAL(shortestFirst.meanQuerySeconds, (510.0 + 114.0) / 10);
+    BOOST_CHECK(shortestFirst.toJson() == wsched::SchedulerSimulator::run(trace, config).toJson());
+
+    // Memory for one chunk at a time still runs every task.
+    config.memoryBytes = 1000;
+    config.threads = 4;
+    auto limited = wsched::SchedulerSimulator::run(trace, config);
+    BOOST_CHECK_EQUAL(limited.tasks, 10u);
+    BOOST_CHECK_EQUAL(limited.tableLoads, 10u);
+    LOGS(_log, LOG_LVL_DEBUG, "SchedulerSimulatorRunTest done");
+}
+
+/// Compare the chunk orders on a trace cut from the log of a worker, see
+/// SchedulerSimulator. Disabled by default, run it with:
+///   testSchedulers --run_test=SchedulerSuite/SchedulerSimulatorReplay -- <trace> [threads] [memory MB]
+BOOST_AUTO_TEST_CASE(SchedulerSimulatorReplay, *boost::unit_test::disabled()) {
+    auto& suite = boost::unit_test::framework::master_test_suite();
+    BOOST_REQUIRE_MESSAGE(suite.argc > 1, "the trace file must be given after --");
+    std::ifstream is(suite.argv[1]);
+    BOOST_REQUIRE_MESSAGE(is, "can't open " << suite.argv[1]);
+    auto trace = wsched::SchedulerTrace::read(is);
+    wsched::SchedulerSimulator::Config config;
+    if (suite.argc > 2) config.threads = std::stoi(suite.argv[2]);
+    if (suite.argc > 3) config.memoryBytes = std::stoull(suite.argv[3]) * 1'000'000;
+    using Policy = wsched::ChunkOrder::Policy;
+    for (auto policy : {Policy::CHUNK_ID, Policy::SHORTEST_FIRST, Policy::TASKS_PER_BYTE}) {
+        config.chunkOrder = wsched::ChunkOrder(policy, 50);
+        auto result = wsched::SchedulerSimulator::run(trace, config);
+        std::cout << wsched::ChunkOrder::toString(policy) << " " << result.toJson() << std::endl;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(CreateTasksBatchTest) {
+    LOGS(_log, LOG_LVL_DEBUG, "CreateTasksBatchTest start");
+    SchedulerFixture f;
+    std::string const query =
+            std::string("SELECT * FROM Object_") + lsst::qserv::CHUNK_TAG + "_" + lsst::qserv::SUBCHUNK_TAG;
+    auto taskMsg = f.newTaskMsg(10, 7, 3);
+    for (auto& fragment : *taskMsg->mutable_fragment()) {
+        fragment.set_query(0, query);
+        fragment.mutable_subchunks()->add_dbtbl()->set_db("elephant");
+        fragment.mutable_subchunks()->mutable_dbtbl(0)->set_tbl("Object");
+    }
+    // Same fragments as the template.
+    taskMsg->add_batchchunk()->set_chunkid(11);
+    // Only the subchunks differ.
+    auto batchChunk = taskMsg->add_batchchunk();
+    batchChunk->set_chunkid(12);
+    for (int i = 0; i < 3; ++i) {
+        batchChunk->add_fragment()->mutable_subchunks()->add_id(200 + i);
+    }
+    // A fragment of its own.
+    batchChunk = taskMsg->add_batchchunk();
+    batchChunk->set_chunkid(13);
+    batchChunk->add_fragment()->add_query("SELECT 1 FROM Object_" + std::string(lsst::qserv::CHUNK_TAG));
+
+    auto sendC = std::make_shared<SendChannel>();
+    auto sc = SendChannelShared::create(sendC, locTransmitMgr, 1);
+    auto tasks = Task::createTasks(taskMsg, sc);
+    BOOST_REQUIRE_EQUAL(tasks.size(), 10u);
+    BOOST_CHECK_EQUAL(sc->getTaskCount(), 10);
+    for (auto const& task : tasks) {
+        BOOST_CHECK_EQUAL(task->getJobId(), 3);
+        BOOST_CHECK_EQUAL(task->msg->batchchunk_size(), 0);
+    }
+    BOOST_CHECK_EQUAL(tasks[0]->getChunkId(), 10);
+    BOOST_CHECK_EQUAL(tasks[0]->getQueryString(), "SELECT * FROM Object_10_100");
+    BOOST_CHECK_EQUAL(tasks[5]->getChunkId(), 11);
+    BOOST_CHECK_EQUAL(tasks[5]->getQueryString(), "SELECT * FROM Object_11_102");
+    BOOST_CHECK_EQUAL(tasks[7]->getChunkId(), 12);
+    BOOST_CHECK_EQUAL(tasks[7]->getQueryString(), "SELECT * FROM Object_12_201");
+    BOOST_CHECK_EQUAL(tasks[7]->msg->fragment(1).subchunks().dbtbl(0).tbl(), "Object");
+    BOOST_CHECK_EQUAL(tasks[7]->msg->fragment(1).resulttable(), "r_341");
+    BOOST_CHECK_EQUAL(tasks[9]->getChunkId(), 13);
+    BOOST_CHECK_EQUAL(tasks[9]->getQueryString(), "SELECT 1 FROM Object_13");
+    LOGS(_log, LOG_LVL_DEBUG, "CreateTasksBatchTest done");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
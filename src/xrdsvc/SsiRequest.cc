@@ -27,6 +27,7 @@
 #include <cstddef>
 #include <iostream>
 #include <string>
+#include <vector>
 
 // Third-party headers
 #include "XrdSsi/XrdSsiRequest.hh"
@@ -38,11 +39,13 @@
 #include "global/LogContext.h"
 #include "global/ResourceUnit.h"
 #include "proto/FrameBuffer.h"
+#include "proto/TaskMsgTemplate.h"
 #include "proto/worker.pb.h"
 #include "util/InstanceCount.h"
 #include "util/Timer.h"
 #include "wbase/MsgProcessor.h"
 #include "wbase/SendChannelShared.h"
+#include "wbase/TaskTemplateCache.h"
 #include "wpublish/AddChunkGroupCommand.h"
 #include "wpublish/ChunkListCommand.h"
 #include "wpublish/GetChunkListCommand.h"
@@ -123,40 +126,30 @@ void SsiRequest::execute(XrdSsiRequest& req) {
 
             QSERV_LOGCONTEXT_QUERY_JOB(taskMsg->queryid(), taskMsg->jobid());
 
+            // Messages without a db only carry what differs between the jobs of
+            // the query, the czar sends them again in full if this fails.
+            if (proto::isCompactTaskMsg(*taskMsg)) {
+                if (!_templateCache->expand(*taskMsg)) {
+                    reportError("Unknown TaskMsg template on resource db=" + ru.db() +
+                                " chunkId=" + std::to_string(ru.chunk()));
+                    return;
+                }
+            } else if (taskMsg->has_templateid()) {
+                _templateCache->add(*taskMsg);
+            }
+
             if (!taskMsg->has_db() || !taskMsg->has_chunkid() || (ru.db() != taskMsg->db()) ||
                 (ru.chunk() != taskMsg->chunkid())) {
                 reportError("Mismatched db/chunk in TaskMsg on resource db=" + ru.db() +
                             " chunkId=" + std::to_string(ru.chunk()));
                 return;
             }
-
-            if (not(taskMsg->has_queryid() && taskMsg->has_jobid() && taskMsg->has_scaninteractive() &&
-                    taskMsg->has_attemptcount() && taskMsg->has_czarid())) {
-                reportError(std::string("taskMsg missing required field ") +
-                            " queryid:" + std::to_string(taskMsg->has_queryid()) +
-                            " jobid:" + std::to_string(taskMsg->has_jobid()) +
-                            " scaninteractive:" + std::to_string(taskMsg->has_scaninteractive()) +
-                            " attemptcount:" + std::to_string(taskMsg->has_attemptcount()) +
-                            " czarid:" + std::to_string(taskMsg->has_czarid()));
+            if (taskMsg->batchchunk_size() > 0) {
+                reportError("Batch of chunks sent to the resource of a single chunk " + _resourceName);
                 return;
             }
 
-            // Now that the request is decoded (successfully or not), release the
-            // xrootd request buffer. To avoid data races, this must happen before
-            // the task is handed off to another thread for processing, as there is a
-            // reference to this SsiRequest inside the reply channel for the task,
-            // and after the call to BindRequest.
-            auto sendChannelBase = std::make_shared<wbase::SendChannel>(shared_from_this());
-            auto sendChannel =
-                    wbase::SendChannelShared::create(sendChannelBase, _transmitMgr, taskMsg->czarid());
-            auto tasks = wbase::Task::createTasks(taskMsg, sendChannel);
-
-            ReleaseRequestBuffer();
-            t.start();
-            _processor->processTasks(tasks);  // Queues tasks to be run later.
-            t.stop();
-            LOGS(_log, LOG_LVL_DEBUG,
-                 "Enqueued TaskMsg for " << ru << " in " << t.getElapsed() << " seconds");
+            _processTaskMsg(taskMsg, ru);
             break;
         }
         case ResourceUnit::WORKER: {
@@ -188,6 +181,37 @@ void SsiRequest::execute(XrdSsiRequest& req) {
     // to actually do something once everything is actually setup.
 }
 
+void SsiRequest::_processTaskMsg(std::shared_ptr<proto::TaskMsg> const& taskMsg, ResourceUnit const& ru) {
+    util::Timer t;
+    if (not(taskMsg->has_queryid() && taskMsg->has_jobid() && taskMsg->has_scaninteractive() &&
+            taskMsg->has_attemptcount() && taskMsg->has_czarid())) {
+        reportError(std::string("taskMsg missing required field ") +
+                    " queryid:" + std::to_string(taskMsg->has_queryid()) +
+                    " jobid:" + std::to_string(taskMsg->has_jobid()) +
+                    " scaninteractive:" + std::to_string(taskMsg->has_scaninteractive()) +
+                    " attemptcount:" + std::to_string(taskMsg->has_attemptcount()) +
+                    " czarid:" + std::to_string(taskMsg->has_czarid()));
+        return;
+    }
+
+    // Now that the request is decoded (successfully or not), release the
+    // xrootd request buffer. To avoid data races, this must happen before
+    // the task is handed off to another thread for processing, as there is a
+    // reference to this SsiRequest inside the reply channel for the task,
+    // and after the call to BindRequest.
+    auto sendChannelBase = std::make_shared<wbase::SendChannel>(shared_from_this());
+    auto sendChannel = wbase::SendChannelShared::create(sendChannelBase, _transmitMgr, taskMsg->czarid());
+    auto tasks = wbase::Task::createTasks(taskMsg, sendChannel);
+
+    ReleaseRequestBuffer();
+    t.start();
+    _processor->processTasks(tasks);  // Queues tasks to be run later.
+    t.stop();
+    LOGS(_log, LOG_LVL_DEBUG,
+         "Enqueued TaskMsg for " << ru << " chunks=" << (taskMsg->batchchunk_size() + 1) << " in "
+                                 << t.getElapsed() << " seconds");
+}
+
 wbase::WorkerCommand::Ptr SsiRequest::parseWorkerCommand(char const* reqData, int reqSize) {
     wbase::SendChannel::Ptr const sendChannel = std::make_shared<wbase::SendChannel>(shared_from_this());
 
@@ -271,7 +295,42 @@ wbase::WorkerCommand::Ptr SsiRequest::parseWorkerCommand(char const* reqData, in
             }
             case proto::WorkerCommandH::GET_STATUS: {
                 command = std::make_shared<wpublish::GetStatusCommand>(sendChannel, _processor,
-                                                                       _resourceMonitor);
+                                                                       _resourceMonitor, _templateCache);
+                break;
+            }
+            case proto::WorkerCommandH::RUN_TASK_BATCH: {
+                // Not a command, the tasks are queued here and no command is returned.
+                auto taskMsg = std::make_shared<proto::TaskMsg>();
+                view.parse(*taskMsg);
+                QSERV_LOGCONTEXT_QUERY_JOB(taskMsg->queryid(), taskMsg->jobid());
+
+                // The czar only learns where chunks are from earlier results, so
+                // they may have moved since.
+                std::vector<int> chunks{taskMsg->chunkid()};
+                for (auto const& batchChunk : taskMsg->batchchunk()) chunks.push_back(batchChunk.chunkid());
+                for (int chunk : chunks) {
+                    std::string const chunkResource = ResourceUnit::makePath(chunk, taskMsg->db());
+                    if (!taskMsg->has_db() || !(*_validator)(ResourceUnit(chunkResource))) {
+                        reportError("WARNING: batch has the unowned resource:" + chunkResource);
+                        return command;
+                    }
+                }
+                // Fragments without queries take them from the fragments of the message.
+                for (auto const& batchChunk : taskMsg->batchchunk()) {
+                    for (int fragNum = 0; fragNum < batchChunk.fragment_size(); ++fragNum) {
+                        if (batchChunk.fragment(fragNum).query_size() == 0 &&
+                            fragNum >= taskMsg->fragment_size()) {
+                            reportError("batch has no template for fragment " + std::to_string(fragNum) +
+                                        " of chunk " + std::to_string(batchChunk.chunkid()));
+                            return command;
+                        }
+                    }
+                }
+                for (int chunk : chunks) {
+                    _batchResources.push_back(ResourceUnit::makePath(chunk, taskMsg->db()));
+                    _resourceMonitor->increment(_batchResources.back());
+                }
+                _processTaskMsg(taskMsg, ResourceUnit(_batchResources.front()));
                 break;
             }
             default:
@@ -341,6 +400,9 @@ void SsiRequest::Finished(XrdSsiRequest& req, XrdSsiRespInfo const& rinfo, bool
     if (ru.unitType() == ResourceUnit::DBCHUNK) {
         _resourceMonitor->decrement(_resourceName);
     }
+    for (auto const& batchResource : _batchResources) {
+        _resourceMonitor->decrement(batchResource);
+    }
 
     // We can't do much other than close the file.
     // It should work (on linux) to unlink the file after we open it, though.
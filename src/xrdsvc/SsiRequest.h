@@ -47,6 +47,7 @@ namespace lsst::qserv {
 namespace wbase {
 struct MsgProcessor;
 class Task;
+class TaskTemplateCache;
 }  // namespace wbase
 namespace wcontrol {
 class TransmitMgr;
@@ -77,9 +78,10 @@ public:
                                          std::shared_ptr<wpublish::ChunkInventory> const& chunkInventory,
                                          std::shared_ptr<wbase::MsgProcessor> const& processor,
                                          mysql::MySqlConfig const& mySqlConfig,
-                                         std::shared_ptr<wcontrol::TransmitMgr> const& transmitMgr) {
-        auto req =
-                SsiRequest::Ptr(new SsiRequest(rname, chunkInventory, processor, mySqlConfig, transmitMgr));
+                                         std::shared_ptr<wcontrol::TransmitMgr> const& transmitMgr,
+                                         std::shared_ptr<wbase::TaskTemplateCache> const& templateCache) {
+        auto req = SsiRequest::Ptr(new SsiRequest(rname, chunkInventory, processor, mySqlConfig, transmitMgr,
+                                                  templateCache));
         req->_selfKeepAlive = req;
         return req;
     }
@@ -118,13 +120,15 @@ private:
     /// Constructor (called by SsiService)
     SsiRequest(std::string const& rname, std::shared_ptr<wpublish::ChunkInventory> const& chunkInventory,
                std::shared_ptr<wbase::MsgProcessor> const& processor, mysql::MySqlConfig const& mySqlConfig,
-               std::shared_ptr<wcontrol::TransmitMgr> const& transmitMgr)
+               std::shared_ptr<wcontrol::TransmitMgr> const& transmitMgr,
+               std::shared_ptr<wbase::TaskTemplateCache> const& templateCache)
             : _chunkInventory(chunkInventory),
               _validator(_chunkInventory->newValidator()),
               _processor(processor),
               _resourceName(rname),
               _mySqlConfig(mySqlConfig),
-              _transmitMgr(transmitMgr) {}
+              _transmitMgr(transmitMgr),
+              _templateCache(templateCache) {}
 
     /// For internal error reporting
     void reportError(std::string const& errStr);
@@ -139,6 +143,9 @@ private:
      */
     wbase::WorkerCommand::Ptr parseWorkerCommand(char const* reqData, int reqSize);
 
+    /// Create the tasks for 'taskMsg', requested through resource 'ru', and queue them.
+    void _processTaskMsg(std::shared_ptr<proto::TaskMsg> const& taskMsg, ResourceUnit const& ru);
+
 private:
     /// Counters of the database/chunk requests which are being used
     static std::shared_ptr<wpublish::ResourceMonitor> _resourceMonitor;
@@ -152,12 +159,16 @@ private:
     std::atomic<bool> _reqFinished{false};  ///< set to true when Finished called
     std::string _resourceName;              ///< chunk identifier
 
+    /// Resources of the chunks of a batch, which are in use until Finished() is called.
+    std::vector<std::string> _batchResources;
+
     std::shared_ptr<ChannelStream> _stream;
 
     std::weak_ptr<wbase::Task> _task;
 
     mysql::MySqlConfig const _mySqlConfig;
-    std::shared_ptr<wcontrol::TransmitMgr> _transmitMgr;  ///< limits transmits to czars.
+    std::shared_ptr<wcontrol::TransmitMgr> _transmitMgr;       ///< limits transmits to czars.
+    std::shared_ptr<wbase::TaskTemplateCache> _templateCache;  ///< see TaskMsg.templateid
 
     /// Make sure this object exists until Finish() is called.
     /// Make a local copy before calling reset() within and non-static member function.
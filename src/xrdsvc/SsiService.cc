@@ -27,6 +27,7 @@
 // System headers
 #include <cassert>
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <stdlib.h>
 #include <unistd.h>
@@ -46,11 +47,15 @@
 #include "sql/SqlConnectionFactory.h"
 #include "util/FileMonitor.h"
 #include "wbase/Base.h"
+#include "wbase/ResultSpool.h"
+#include "wbase/TaskTemplateCache.h"
+#include "wbase/TransmitData.h"
 #include "wconfig/WorkerConfig.h"
 #include "wconfig/WorkerConfigError.h"
 #include "wcontrol/Foreman.h"
 #include "wcontrol/SqlConnMgr.h"
 #include "wcontrol/TransmitMgr.h"
+#include "wdb/SharedScan.h"
 #include "wpublish/ChunkInventory.h"
 #include "wsched/BlendScheduler.h"
 #include "wsched/FifoScheduler.h"
@@ -89,10 +94,14 @@ SsiService::SsiService(XrdSsiLogger* log, wconfig::WorkerConfig const& workerCon
         // Default to 1 gigabyte
         uint64_t memManSize = workerConfig.getMemManSizeMb() * 1000000;
         LOGS(_log, LOG_LVL_DEBUG,
-             "Using MemManReal with memManSizeMb=" << workerConfig.getMemManSizeMb()
-                                                   << " location=" << workerConfig.getMemManLocation());
+             "Using MemManReal with memManSizeMb="
+                     << workerConfig.getMemManSizeMb() << " location=" << workerConfig.getMemManLocation()
+                     << " prefetchChunks=" << workerConfig.getMemManPrefetchChunks()
+                     << " hugePages=" << workerConfig.getMemManHugePages());
         memMan = shared_ptr<memman::MemMan>(
-                memman::MemMan::create(memManSize, workerConfig.getMemManLocation()));
+                memman::MemMan::create(memManSize, workerConfig.getMemManLocation(),
+                                       workerConfig.getMemManPrefetchChunks(),
+                                       workerConfig.getMemManHugePages()));
     } else if (cfgMemMan == "MemManNone") {
         memMan = make_shared<memman::MemManNone>(1, false);
     } else {
@@ -103,6 +112,13 @@ SsiService::SsiService(XrdSsiLogger* log, wconfig::WorkerConfig const& workerCon
     int64_t bufferMaxTotalBytes = workerConfig.getBufferMaxTotalGB() * 1'000'000'000LL;
     StreamBuffer::setMaxTotalBytes(bufferMaxTotalBytes);
 
+    uint64_t const spoolMaxBytes = workerConfig.getResultSpoolMaxMB() * 1'000'000ULL;
+    uint64_t const spoolMaxTotalBytes = workerConfig.getResultSpoolMaxTotalGB() * 1'000'000'000ULL;
+    wbase::ResultSpool::setup(workerConfig.getResultSpoolDir(), spoolMaxBytes, spoolMaxTotalBytes);
+
+    wdb::SharedScan::setup(workerConfig.getSharedScanWindowMs(), workerConfig.getSharedScanMaxQueries(),
+                           workerConfig.getSharedScanMaxMB() * 1'000'000ULL, memMan);
+
     // Set thread pool size.
     unsigned int poolSize = max(workerConfig.getThreadPoolSize(), thread::hardware_concurrency());
     unsigned int maxPoolThreads = max(workerConfig.getMaxPoolThreads(), poolSize);
@@ -124,21 +140,33 @@ SsiService::SsiService(XrdSsiLogger* log, wconfig::WorkerConfig const& workerCon
     double slowScanMaxMinutes = (double)workerConfig.getScanMaxMinutesSlow();
     double snailScanMaxMinutes = (double)workerConfig.getScanMaxMinutesSnail();
     int maxTasksBootedPerUserQuery = workerConfig.getMaxTasksBootedPerUserQuery();
+    auto chunkOrder = [&workerConfig](string const& policy) {
+        try {
+            return wsched::ChunkOrder(wsched::ChunkOrder::policyFromString(policy),
+                                      workerConfig.getChunkOrderMaxPassedOver());
+        } catch (invalid_argument const& e) {
+            throw wconfig::WorkerConfigError(e.what());
+        }
+    };
     vector<wsched::ScanScheduler::Ptr> scanSchedulers{
             make_shared<wsched::ScanScheduler>(
                     "SchedSlow", maxThread, workerConfig.getMaxReserveSlow(), workerConfig.getPrioritySlow(),
-                    workerConfig.getMaxActiveChunksSlow(), memMan, medium + 1, slow, slowScanMaxMinutes),
+                    workerConfig.getMaxActiveChunksSlow(), memMan, medium + 1, slow, slowScanMaxMinutes,
+                    chunkOrder(workerConfig.getChunkOrderSlow())),
             make_shared<wsched::ScanScheduler>(
                     "SchedFast", maxThread, workerConfig.getMaxReserveFast(), workerConfig.getPriorityFast(),
-                    workerConfig.getMaxActiveChunksFast(), memMan, fastest, fast, fastScanMaxMinutes),
+                    workerConfig.getMaxActiveChunksFast(), memMan, fastest, fast, fastScanMaxMinutes,
+                    chunkOrder(workerConfig.getChunkOrderFast())),
             make_shared<wsched::ScanScheduler>(
                     "SchedMed", maxThread, workerConfig.getMaxReserveMed(), workerConfig.getPriorityMed(),
-                    workerConfig.getMaxActiveChunksMed(), memMan, fast + 1, medium, medScanMaxMinutes),
+                    workerConfig.getMaxActiveChunksMed(), memMan, fast + 1, medium, medScanMaxMinutes,
+                    chunkOrder(workerConfig.getChunkOrderMed())),
     };
 
     auto snail = make_shared<wsched::ScanScheduler>(
             "SchedSnail", maxThread, workerConfig.getMaxReserveSnail(), workerConfig.getPrioritySnail(),
-            workerConfig.getMaxActiveChunksSnail(), memMan, slow + 1, slowest, snailScanMaxMinutes);
+            workerConfig.getMaxActiveChunksSnail(), memMan, slow + 1, slowest, snailScanMaxMinutes,
+            chunkOrder(workerConfig.getChunkOrderSnail()));
 
     wpublish::QueriesAndChunks::Ptr queries = wpublish::QueriesAndChunks::setupGlobal(
             chrono::minutes(5), chrono::minutes(5), maxTasksBootedPerUserQuery);
@@ -161,8 +189,12 @@ SsiService::SsiService(XrdSsiLogger* log, wconfig::WorkerConfig const& workerCon
     LOGS(_log, LOG_LVL_WARN, "config transmitMgr" << *_transmitMgr);
     LOGS(_log, LOG_LVL_WARN, "maxPoolThreads=" << maxPoolThreads);
 
+    _templateCache = make_shared<wbase::TaskTemplateCache>(workerConfig.getTemplateCacheMaxEntries());
+
+    uint64_t const subChunkCacheMaxBytes = workerConfig.getSubChunkCacheMaxMB() * 1'000'000ULL;
     _foreman = make_shared<wcontrol::Foreman>(blendSched, poolSize, maxPoolThreads,
-                                              workerConfig.getMySqlConfig(), queries, sqlConnMgr);
+                                              workerConfig.getMySqlConfig(), queries, sqlConnMgr, memMan,
+                                              subChunkCacheMaxBytes, workerConfig.getWorkStealingBatch());
 
     // Watch to see if the log configuration is changed.
     // If LSST_LOG_CONFIG is not defined, there's no good way to know what log
@@ -181,8 +213,8 @@ SsiService::~SsiService() { LOGS(_log, LOG_LVL_DEBUG, "SsiService dying."); }
 
 void SsiService::ProcessRequest(XrdSsiRequest& reqRef, XrdSsiResource& resRef) {
     LOGS(_log, LOG_LVL_DEBUG, "Got request call where rName is: " << resRef.rName);
-    auto request =
-            SsiRequest::newSsiRequest(resRef.rName, _chunkInventory, _foreman, _mySqlConfig, _transmitMgr);
+    auto request = SsiRequest::newSsiRequest(resRef.rName, _chunkInventory, _foreman, _mySqlConfig,
+                                             _transmitMgr, _templateCache);
 
     // Continue execution in the session object as SSI gave us a new thread.
     // Object deletes itself when finished is called.
@@ -203,6 +235,9 @@ void SsiService::_initInventory() {
     os << "Paths exported: ";
     _chunkInventory->dbgPrint(os);
     LOGS(_log, LOG_LVL_DEBUG, os.str());
+
+    // Let czars know where to send batches of chunks (see proto::WorkerCommandH::RUN_TASK_BATCH).
+    wbase::TransmitData::setWorkerId(_chunkInventory->id());
 }
 
 }  // namespace lsst::qserv::xrdsvc
@@ -42,6 +42,9 @@ namespace lsst::qserv {
 namespace util {
 class FileMonitor;
 }
+namespace wbase {
+class TaskTemplateCache;
+}
 namespace wcontrol {
 class Foreman;
 class TransmitMgr;
@@ -83,6 +86,9 @@ private:
     /// Used to throttle outgoing massages to prevent czars from being overloaded.
     std::shared_ptr<wcontrol::TransmitMgr> _transmitMgr;
 
+    /// Templates of the messages that only carry what differs between the jobs of a query.
+    std::shared_ptr<wbase::TaskTemplateCache> _templateCache;
+
     mysql::MySqlConfig const _mySqlConfig;
 
     /// Reloads the log configuration file on log config file change.